@@ -33,6 +33,7 @@ HEADERS += \
     ../../../src/libtsduck/tsAbstractLongTable.h \
     ../../../src/libtsduck/tsAbstractSignalization.h \
     ../../../src/libtsduck/tsAbstractTable.h \
+    ../../../src/libtsduck/tsAbstractTableView.h \
     ../../../src/libtsduck/tsAbstractTransportListTable.h \
     ../../../src/libtsduck/tsAlgorithm.h \
     ../../../src/libtsduck/tsAlgorithmTemplate.h \
@@ -48,6 +49,8 @@ HEADERS += \
     ../../../src/libtsduck/tsBinaryTable.h \
     ../../../src/libtsduck/tsBitStream.h \
     ../../../src/libtsduck/tsBlockCipher.h \
+    ../../../src/libtsduck/tsBoundedMessageQueue.h \
+    ../../../src/libtsduck/tsBoundedMessageQueueTemplate.h \
     ../../../src/libtsduck/tsBouquetNameDescriptor.h \
     ../../../src/libtsduck/tsByteBlock.h \
     ../../../src/libtsduck/tsCADescriptor.h \
@@ -96,13 +99,17 @@ HEADERS += \
     ../../../src/libtsduck/tsDescriptor.h \
     ../../../src/libtsduck/tsDescriptorList.h \
     ../../../src/libtsduck/tsDescriptorListTemplate.h \
+    ../../../src/libtsduck/tsDescriptorLoopView.h \
     ../../../src/libtsduck/tsDoubleCheckLock.h \
     ../../../src/libtsduck/tsECB.h \
     ../../../src/libtsduck/tsECBTemplate.h \
     ../../../src/libtsduck/tsECMGClient.h \
     ../../../src/libtsduck/tsECMGClientHandlerInterface.h \
+    ../../../src/libtsduck/tsECMGMultiClient.h \
     ../../../src/libtsduck/tsECMGSCS.h \
     ../../../src/libtsduck/tsEIT.h \
+    ../../../src/libtsduck/tsEITDatabase.h \
+    ../../../src/libtsduck/tsEITView.h \
     ../../../src/libtsduck/tsEMMGMUX.h \
     ../../../src/libtsduck/tsETID.h \
     ../../../src/libtsduck/tsEacemPreferredNameIdentifierDescriptor.h \
@@ -137,6 +144,7 @@ HEADERS += \
     ../../../src/libtsduck/tsMJD.h \
     ../../../src/libtsduck/tsMPEG.h \
     ../../../src/libtsduck/tsMediaGuardDate.h \
+    ../../../src/libtsduck/tsMemoryMappedFile.h \
     ../../../src/libtsduck/tsMemoryUtils.h \
     ../../../src/libtsduck/tsMessageDescriptor.h \
     ../../../src/libtsduck/tsMessageQueue.h \
@@ -146,6 +154,7 @@ HEADERS += \
     ../../../src/libtsduck/tsMutex.h \
     ../../../src/libtsduck/tsMutexInterface.h \
     ../../../src/libtsduck/tsNIT.h \
+    ../../../src/libtsduck/tsNITView.h \
     ../../../src/libtsduck/tsNames.h \
     ../../../src/libtsduck/tsNetworkNameDescriptor.h \
     ../../../src/libtsduck/tsNullMutex.h \
@@ -154,6 +163,7 @@ HEADERS += \
     ../../../src/libtsduck/tsOneShotPacketizer.h \
     ../../../src/libtsduck/tsOutputRedirector.h \
     ../../../src/libtsduck/tsPAT.h \
+    ../../../src/libtsduck/tsPATView.h \
     ../../../src/libtsduck/tsPCR.h \
     ../../../src/libtsduck/tsPCRAnalyzer.h \
     ../../../src/libtsduck/tsPCSC.h \
@@ -162,6 +172,7 @@ HEADERS += \
     ../../../src/libtsduck/tsPESPacket.h \
     ../../../src/libtsduck/tsPIDOperator.h \
     ../../../src/libtsduck/tsPMT.h \
+    ../../../src/libtsduck/tsPMTView.h \
     ../../../src/libtsduck/tsPSILogger.h \
     ../../../src/libtsduck/tsPSILoggerArgs.h \
     ../../../src/libtsduck/tsPacketizer.h \
@@ -185,6 +196,7 @@ HEADERS += \
     ../../../src/libtsduck/tsRST.h \
     ../../../src/libtsduck/tsS2SatelliteDeliverySystemDescriptor.h \
     ../../../src/libtsduck/tsSDT.h \
+    ../../../src/libtsduck/tsSDTView.h \
     ../../../src/libtsduck/tsSHA1.h \
     ../../../src/libtsduck/tsSHA256.h \
     ../../../src/libtsduck/tsSHA512.h \
@@ -228,6 +240,8 @@ HEADERS += \
     ../../../src/libtsduck/tsT2MIHandlerInterface.h \
     ../../../src/libtsduck/tsT2MIPacket.h \
     ../../../src/libtsduck/tsTCPConnection.h \
+    ../../../src/libtsduck/tsTCPReactor.h \
+    ../../../src/libtsduck/tsTCPReactorHandlerInterface.h \
     ../../../src/libtsduck/tsTCPServer.h \
     ../../../src/libtsduck/tsTCPSocket.h \
     ../../../src/libtsduck/tsTDES.h \
@@ -244,10 +258,12 @@ HEADERS += \
     ../../../src/libtsduck/tsTSFileOutputResync.h \
     ../../../src/libtsduck/tsTSPacket.h \
     ../../../src/libtsduck/tsTSScanner.h \
+    ../../../src/libtsduck/tsTSSynchronizer.h \
     ../../../src/libtsduck/tsTableHandlerInterface.h \
     ../../../src/libtsduck/tsTables.h \
     ../../../src/libtsduck/tsTablesDisplay.h \
     ../../../src/libtsduck/tsTablesDisplayArgs.h \
+    ../../../src/libtsduck/tsTablesDisplayCache.h \
     ../../../src/libtsduck/tsTablesFactory.h \
     ../../../src/libtsduck/tsTablesLogger.h \
     ../../../src/libtsduck/tsTablesLoggerArgs.h \
@@ -258,6 +274,8 @@ HEADERS += \
     ../../../src/libtsduck/tsThread.h \
     ../../../src/libtsduck/tsThreadAttributes.h \
     ../../../src/libtsduck/tsTime.h \
+    ../../../src/libtsduck/tsTimerHandlerInterface.h \
+    ../../../src/libtsduck/tsTimerWheel.h \
     ../../../src/libtsduck/tsToInteger.h \
     ../../../src/libtsduck/tsToIntegerTemplate.h \
     ../../../src/libtsduck/tsTransportStreamId.h \
@@ -291,6 +309,7 @@ HEADERS += \
     ../../../src/libtsduck/tstlvMessageFactory.h \
     ../../../src/libtsduck/tstlvMessageFactoryTemplate.h \
     ../../../src/libtsduck/tstlvProtocol.h \
+    ../../../src/libtsduck/tstlvReactorHandler.h \
     ../../../src/libtsduck/tstlvSerializer.h \
     ../../../src/libtsduck/tstlvStreamMessage.h \
     ../../../src/libtsduck/tinyxml/tinyxml2.h
@@ -316,6 +335,7 @@ SOURCES += \
     ../../../src/libtsduck/tsAbstractDescriptorsTable.cpp \
     ../../../src/libtsduck/tsAbstractSignalization.cpp \
     ../../../src/libtsduck/tsAbstractTable.cpp \
+    ../../../src/libtsduck/tsAbstractTableView.cpp \
     ../../../src/libtsduck/tsAbstractTransportListTable.cpp \
     ../../../src/libtsduck/tsApplicationSharedLibrary.cpp \
     ../../../src/libtsduck/tsApplicationSignallingDescriptor.cpp \
@@ -359,9 +379,13 @@ SOURCES += \
     ../../../src/libtsduck/tsDektecUtils.cpp \
     ../../../src/libtsduck/tsDescriptor.cpp \
     ../../../src/libtsduck/tsDescriptorList.cpp \
+    ../../../src/libtsduck/tsDescriptorLoopView.cpp \
     ../../../src/libtsduck/tsECMGClient.cpp \
+    ../../../src/libtsduck/tsECMGMultiClient.cpp \
     ../../../src/libtsduck/tsECMGSCS.cpp \
     ../../../src/libtsduck/tsEIT.cpp \
+    ../../../src/libtsduck/tsEITDatabase.cpp \
+    ../../../src/libtsduck/tsEITView.cpp \
     ../../../src/libtsduck/tsEMMGMUX.cpp \
     ../../../src/libtsduck/tsEacemPreferredNameIdentifierDescriptor.cpp \
     ../../../src/libtsduck/tsEacemPreferredNameListDescriptor.cpp \
@@ -389,6 +413,7 @@ SOURCES += \
     ../../../src/libtsduck/tsLocalTimeOffsetDescriptor.cpp \
     ../../../src/libtsduck/tsLogicalChannelNumberDescriptor.cpp \
     ../../../src/libtsduck/tsMD5.cpp \
+    ../../../src/libtsduck/tsMemoryMappedFile.cpp \
     ../../../src/libtsduck/tsMJD.cpp \
     ../../../src/libtsduck/tsMPEG.cpp \
     ../../../src/libtsduck/tsMemoryUtils.cpp \
@@ -397,6 +422,7 @@ SOURCES += \
     ../../../src/libtsduck/tsMonotonic.cpp \
     ../../../src/libtsduck/tsMutex.cpp \
     ../../../src/libtsduck/tsNIT.cpp \
+    ../../../src/libtsduck/tsNITView.cpp \
     ../../../src/libtsduck/tsNames.cpp \
     ../../../src/libtsduck/tsNetworkNameDescriptor.cpp \
     ../../../src/libtsduck/tsNullReport.cpp \
@@ -404,6 +430,7 @@ SOURCES += \
     ../../../src/libtsduck/tsOneShotPacketizer.cpp \
     ../../../src/libtsduck/tsOutputRedirector.cpp \
     ../../../src/libtsduck/tsPAT.cpp \
+    ../../../src/libtsduck/tsPATView.cpp \
     ../../../src/libtsduck/tsPCR.cpp \
     ../../../src/libtsduck/tsPCRAnalyzer.cpp \
     ../../../src/libtsduck/tsPCSC.cpp \
@@ -411,6 +438,7 @@ SOURCES += \
     ../../../src/libtsduck/tsPESPacket.cpp \
     ../../../src/libtsduck/tsPIDOperator.cpp \
     ../../../src/libtsduck/tsPMT.cpp \
+    ../../../src/libtsduck/tsPMTView.cpp \
     ../../../src/libtsduck/tsPSILogger.cpp \
     ../../../src/libtsduck/tsPSILoggerArgs.cpp \
     ../../../src/libtsduck/tsPacketizer.cpp \
@@ -424,6 +452,7 @@ SOURCES += \
     ../../../src/libtsduck/tsRST.cpp \
     ../../../src/libtsduck/tsS2SatelliteDeliverySystemDescriptor.cpp \
     ../../../src/libtsduck/tsSDT.cpp \
+    ../../../src/libtsduck/tsSDTView.cpp \
     ../../../src/libtsduck/tsSHA1.cpp \
     ../../../src/libtsduck/tsSHA256.cpp \
     ../../../src/libtsduck/tsSHA512.cpp \
@@ -456,6 +485,7 @@ SOURCES += \
     ../../../src/libtsduck/tsT2MIDescriptor.cpp \
     ../../../src/libtsduck/tsT2MIPacket.cpp \
     ../../../src/libtsduck/tsTCPConnection.cpp \
+    ../../../src/libtsduck/tsTCPReactor.cpp \
     ../../../src/libtsduck/tsTCPServer.cpp \
     ../../../src/libtsduck/tsTCPSocket.cpp \
     ../../../src/libtsduck/tsTDES.cpp \
@@ -472,8 +502,10 @@ SOURCES += \
     ../../../src/libtsduck/tsTSFileOutputResync.cpp \
     ../../../src/libtsduck/tsTSPacket.cpp \
     ../../../src/libtsduck/tsTSScanner.cpp \
+    ../../../src/libtsduck/tsTSSynchronizer.cpp \
     ../../../src/libtsduck/tsTablesDisplay.cpp \
     ../../../src/libtsduck/tsTablesDisplayArgs.cpp \
+    ../../../src/libtsduck/tsTablesDisplayCache.cpp \
     ../../../src/libtsduck/tsTablesFactory.cpp \
     ../../../src/libtsduck/tsTablesLogger.cpp \
     ../../../src/libtsduck/tsTablesLoggerArgs.cpp \
@@ -483,6 +515,7 @@ SOURCES += \
     ../../../src/libtsduck/tsThread.cpp \
     ../../../src/libtsduck/tsThreadAttributes.cpp \
     ../../../src/libtsduck/tsTime.cpp \
+    ../../../src/libtsduck/tsTimerWheel.cpp \
     ../../../src/libtsduck/tsToInteger.cpp \
     ../../../src/libtsduck/tsTunerArgs.cpp \
     ../../../src/libtsduck/tsTunerParameters.cpp \
@@ -504,6 +537,7 @@ SOURCES += \
     ../../../src/libtsduck/tstlvAnalyzer.cpp \
     ../../../src/libtsduck/tstlvMessage.cpp \
     ../../../src/libtsduck/tstlvMessageFactory.cpp \
+    ../../../src/libtsduck/tstlvReactorHandler.cpp \
     ../../../src/libtsduck/tstlvSerializer.cpp \
     ../../../src/libtsduck/tinyxml/tinyxml2.cpp
     
@@ -98,6 +98,7 @@ SUBDIRS += \
     tsdump \
     tsfixcc \
     tsftrunc \
+    tsnames \
     tslsdvb \
     tsp \
     tspacketize \
@@ -0,0 +1,3 @@
+CONFIG += tstool
+TARGET = tsnames
+include(../tsduck.pri)
@@ -3,18 +3,28 @@ TARGET = tsp
 include(../tsduck.pri)
 
 SOURCES += \
+    ../../../src/tstools/tspBranchExecutor.cpp \
+    ../../../src/tstools/tspFanOut.cpp \
     ../../../src/tstools/tspInputExecutor.cpp \
+    ../../../src/tstools/tspInputMerger.cpp \
     ../../../src/tstools/tspJointTermination.cpp \
+    ../../../src/tstools/tspLatencyMeter.cpp \
     ../../../src/tstools/tspListProcessors.cpp \
+    ../../../src/tstools/tspMetricsMonitor.cpp \
     ../../../src/tstools/tspOptions.cpp \
     ../../../src/tstools/tspOutputExecutor.cpp \
     ../../../src/tstools/tspPluginExecutor.cpp \
     ../../../src/tstools/tspProcessorExecutor.cpp
 
 HEADERS += \
+    ../../../src/tstools/tspBranchExecutor.h \
+    ../../../src/tstools/tspFanOut.h \
     ../../../src/tstools/tspInputExecutor.h \
+    ../../../src/tstools/tspInputMerger.h \
     ../../../src/tstools/tspJointTermination.h \
+    ../../../src/tstools/tspLatencyMeter.h \
     ../../../src/tstools/tspListProcessors.h \
+    ../../../src/tstools/tspMetricsMonitor.h \
     ../../../src/tstools/tspOptions.h \
     ../../../src/tstools/tspOutputExecutor.h \
     ../../../src/tstools/tspPluginExecutor.h \
@@ -16,6 +16,7 @@ SOURCES += \
     ../../../src/utest/utestAlgorithm.cpp \
     ../../../src/utest/utestArgs.cpp \
     ../../../src/utest/utestBitStream.cpp \
+    ../../../src/utest/utestBoundedMessageQueue.cpp \
     ../../../src/utest/utestByteBlock.cpp \
     ../../../src/utest/utestCppUnitMain.cpp \
     ../../../src/utest/utestCppUnitTest.cpp \
@@ -25,16 +26,20 @@ SOURCES += \
     ../../../src/utest/utestDoubleCheckLock.cpp \
     ../../../src/utest/utestDVB.cpp \
     ../../../src/utest/utestDVBCharset.cpp \
+    ../../../src/utest/utestECMGMultiClient.cpp \
+    ../../../src/utest/utestEITDatabase.cpp \
     ../../../src/utest/utestEnumeration.cpp \
     ../../../src/utest/utestFatal.cpp \
     ../../../src/utest/utestGuard.cpp \
     ../../../src/utest/utestInterrupt.cpp \
+    ../../../src/utest/utestMemoryMappedFile.cpp \
     ../../../src/utest/utestMessageQueue.cpp \
     ../../../src/utest/utestMonotonic.cpp \
     ../../../src/utest/utestMutex.cpp \
     ../../../src/utest/utestNames.cpp \
     ../../../src/utest/utestNetworking.cpp \
     ../../../src/utest/utestPacketizer.cpp \
+    ../../../src/utest/utestPCRAnalyzer.cpp \
     ../../../src/utest/utestPlatform.cpp \
     ../../../src/utest/utestPlugin.cpp \
     ../../../src/utest/utestReport.cpp \
@@ -48,11 +53,18 @@ SOURCES += \
     ../../../src/utest/utestStringUtils.cpp \
     ../../../src/utest/utestSystemRandomGenerator.cpp \
     ../../../src/utest/utestSysUtils.cpp \
+    ../../../src/utest/utestTablesDisplayCache.cpp \
     ../../../src/utest/utestTablesFactory.cpp \
+    ../../../src/utest/utestTablesLogger.cpp \
+    ../../../src/utest/utestTableView.cpp \
+    ../../../src/utest/utestTCPReactor.cpp \
     ../../../src/utest/utestThread.cpp \
     ../../../src/utest/utestThreadAttributes.cpp \
     ../../../src/utest/utestTime.cpp \
+    ../../../src/utest/utestTimerWheel.cpp \
+    ../../../src/utest/utestTLV.cpp \
     ../../../src/utest/utestTSPacket.cpp \
+    ../../../src/utest/utestTSSynchronizer.cpp \
     ../../../src/utest/utestUString.cpp \
     ../../../src/utest/utestVariable.cpp \
     ../../../src/utest/utestXML.cpp \
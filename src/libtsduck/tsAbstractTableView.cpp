@@ -0,0 +1,163 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Abstract base class for read-only views of binary tables
+//
+//----------------------------------------------------------------------------
+
+#include "tsAbstractTableView.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+const size_t ts::AbstractTableView::NO_LENGTH;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructor.
+//----------------------------------------------------------------------------
+
+ts::AbstractTableView::AbstractTableView(const BinaryTable& table, size_t header_size, size_t length_offset) :
+    _table(table),
+    _header_size(header_size),
+    _length_offset(length_offset),
+    _is_valid(false)
+{
+}
+
+ts::AbstractTableView::~AbstractTableView()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Validate the view.
+//----------------------------------------------------------------------------
+
+void ts::AbstractTableView::validate(bool tid_ok)
+{
+    _is_valid = _table.isValid() && tid_ok;
+
+    // Check that the list of entries can be located in all sections.
+    const uint8_t* data = 0;
+    size_t size = 0;
+    for (size_t si = 0; _is_valid && si < _table.sectionCount(); ++si) {
+        const Section& sect(*_table.sectionAt(si));
+        _is_valid = sect.tableId() == _table.tableId() && locateEntries(sect, data, size);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get the payload of the first section.
+//----------------------------------------------------------------------------
+
+const uint8_t* ts::AbstractTableView::firstPayload(size_t& size) const
+{
+    if (_is_valid && _table.sectionCount() > 0) {
+        size = _table.sectionAt(0)->payloadSize();
+        return _table.sectionAt(0)->payload();
+    }
+    else {
+        size = 0;
+        return 0;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Count the number of entries in the table.
+//----------------------------------------------------------------------------
+
+size_t ts::AbstractTableView::entryCount() const
+{
+    size_t count = 0;
+    for (Cursor cur(this); cur.data() != 0; cur.next()) {
+        ++count;
+    }
+    return count;
+}
+
+
+//----------------------------------------------------------------------------
+// Position of an entry in the table.
+//----------------------------------------------------------------------------
+
+ts::AbstractTableView::Cursor::Cursor(const AbstractTableView* view) :
+    _view(view != 0 && view->_is_valid ? view : 0),
+    _section(0),
+    _data(0),
+    _size(0),
+    _remain(0)
+{
+    if (_view != 0) {
+        loadSection();
+        settle();
+    }
+}
+
+void ts::AbstractTableView::Cursor::loadSection()
+{
+    _data = 0;
+    _remain = 0;
+    if (_section < _view->_table.sectionCount() && !_view->locateEntries(*_view->_table.sectionAt(_section), _data, _remain)) {
+        _data = 0;
+        _remain = 0;
+    }
+}
+
+void ts::AbstractTableView::Cursor::settle()
+{
+    // Same rules as the deserialization of tables: the descriptor loop of
+    // an entry is truncated to the end of the list of entries.
+    while (_section < _view->_table.sectionCount()) {
+        if (_data != 0 && _remain >= _view->_header_size) {
+            _size = _view->_header_size;
+            if (_view->_length_offset != NO_LENGTH) {
+                _size += std::min<size_t>(GetUInt16(_data + _view->_length_offset) & 0x0FFF, _remain - _view->_header_size);
+            }
+            return;
+        }
+        ++_section;
+        loadSection();
+    }
+    _view = 0;
+    _data = 0;
+    _size = 0;
+    _remain = 0;
+}
+
+void ts::AbstractTableView::Cursor::next()
+{
+    if (_view != 0) {
+        _data += _size;
+        _remain -= _size;
+        settle();
+    }
+}
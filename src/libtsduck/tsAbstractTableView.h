@@ -0,0 +1,234 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Abstract base class for read-only views of binary tables
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsBinaryTable.h"
+#include "tsSection.h"
+
+namespace ts {
+    //!
+    //! Abstract base class for read-only views of binary tables.
+    //!
+    //! A view gives access to the fields of a table in place, directly in the
+    //! section data, without deserializing the table into an AbstractTable
+    //! subclass. The binary table must remain valid and unmodified as long as
+    //! the view is used.
+    //!
+    //! The main part of most tables is a list of entries (services, streams,
+    //! transports, events) spread over all sections. Each entry starts with a
+    //! fixed-size header which may end with a 12-bit descriptor loop length.
+    //! Subclasses locate the list of entries in each section and define
+    //! the entry class. Unlike the deserialized tables, which are indexed by
+    //! some identifier, the entries are returned in their order of appearance.
+    //!
+    class TSDUCKDLL AbstractTableView
+    {
+    public:
+        //!
+        //! Destructor.
+        //!
+        virtual ~AbstractTableView();
+
+        //!
+        //! Check if the view is valid.
+        //! @return True if the binary table is valid and has the expected type.
+        //!
+        bool isValid() const {return _is_valid;}
+
+        //!
+        //! Get the viewed binary table.
+        //! @return A constant reference to the binary table.
+        //!
+        const BinaryTable& table() const {return _table;}
+
+        //!
+        //! Get the table id.
+        //! @return The table id.
+        //!
+        TID tableId() const {return _table.tableId();}
+
+        //!
+        //! Get the table id extension.
+        //! @return The table id extension.
+        //!
+        uint16_t tableIdExtension() const {return _table.tableIdExtension();}
+
+        //!
+        //! Get the table version.
+        //! @return The table version.
+        //!
+        uint8_t version() const {return _table.version();}
+
+        //!
+        //! Count the number of entries in the table.
+        //! @return The number of entries in all sections.
+        //!
+        size_t entryCount() const;
+
+    protected:
+        //!
+        //! Value for the offset of the descriptor loop length when entries have no descriptor loop.
+        //!
+        static const size_t NO_LENGTH = ~size_t(0);
+
+        //!
+        //! Constructor for subclasses.
+        //! Subclasses shall call validate() at the end of their constructor.
+        //! @param [in] table The binary table to view.
+        //! @param [in] header_size Size of the fixed part of each entry.
+        //! @param [in] length_offset Offset in the fixed part of each entry of the
+        //! 12-bit descriptor loop length. Use NO_LENGTH if entries have no descriptor loop.
+        //!
+        AbstractTableView(const BinaryTable& table, size_t header_size, size_t length_offset);
+
+        //!
+        //! Validate the view. To be called at the end of the constructors of subclasses.
+        //! @param [in] tid_ok True if the table id is valid for the subclass.
+        //!
+        void validate(bool tid_ok);
+
+        //!
+        //! Locate the list of entries in a section.
+        //! @param [in] section The section.
+        //! @param [out] data Address of the list of entries.
+        //! @param [out] size Size in bytes of the list of entries.
+        //! @return True on success, false if the section is invalid.
+        //!
+        virtual bool locateEntries(const Section& section, const uint8_t*& data, size_t& size) const = 0;
+
+        //!
+        //! Get the payload of the first section.
+        //! @param [out] size Size in bytes of the payload.
+        //! @return Address of the payload or zero if the view is invalid.
+        //!
+        const uint8_t* firstPayload(size_t& size) const;
+
+        //!
+        //! Position of an entry in the table.
+        //!
+        class TSDUCKDLL Cursor
+        {
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] view The table view or zero for an end position.
+            //!
+            Cursor(const AbstractTableView* view = 0);
+
+            //!
+            //! Get the address of the current entry.
+            //! @return The address of the current entry or zero at end of table.
+            //!
+            const uint8_t* data() const {return _data;}
+
+            //!
+            //! Get the size of the current entry, including its descriptor loop.
+            //! @return The size in bytes of the current entry.
+            //!
+            size_t size() const {return _size;}
+
+            //!
+            //! Move to the next entry.
+            //!
+            void next();
+
+        private:
+            const AbstractTableView* _view;
+            size_t                   _section;  // Index of current section.
+            const uint8_t*           _data;     // Current entry, zero at end of table.
+            size_t                   _size;     // Size of current entry.
+            size_t                   _remain;   // Remaining size in section, from current entry.
+
+            // Settle on a complete entry, starting at _data, moving to next sections if necessary.
+            void settle();
+            // Load the entries of the current section.
+            void loadSection();
+        };
+
+        //!
+        //! Forward iterator over the entries of a table view.
+        //! @tparam ENTRY Entry class, constructible from the address and size of the entry.
+        //!
+        template <class ENTRY>
+        class EntryIterator
+        {
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] view The table view or zero for an end iterator.
+            //!
+            EntryIterator(const AbstractTableView* view = 0) : _cursor(view) {}
+
+            //!
+            //! Get the current entry.
+            //! @return The current entry.
+            //!
+            ENTRY operator*() const {return ENTRY(_cursor.data(), _cursor.size());}
+
+            //!
+            //! Move to the next entry.
+            //! @return A reference to this iterator.
+            //!
+            EntryIterator& operator++() {_cursor.next(); return *this;}
+
+            //!
+            //! Equality operator.
+            //! @param [in] other Another iterator to compare.
+            //! @return True if both iterators point to the same entry.
+            //!
+            bool operator==(const EntryIterator& other) const {return _cursor.data() == other._cursor.data();}
+
+            //!
+            //! Unequality operator.
+            //! @param [in] other Another iterator to compare.
+            //! @return True if both iterators do not point to the same entry.
+            //!
+            bool operator!=(const EntryIterator& other) const {return _cursor.data() != other._cursor.data();}
+
+        private:
+            Cursor _cursor;
+        };
+
+    private:
+        const BinaryTable& _table;
+        const size_t       _header_size;
+        const size_t       _length_offset;
+        bool               _is_valid;
+
+        // Inaccessible operations.
+        AbstractTableView() = delete;
+        AbstractTableView(const AbstractTableView&) = delete;
+        AbstractTableView& operator=(const AbstractTableView&) = delete;
+    };
+}
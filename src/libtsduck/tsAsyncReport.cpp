@@ -32,9 +32,19 @@
 //----------------------------------------------------------------------------
 
 #include "tsAsyncReport.h"
+#include "tsGuard.h"
+#include "tsGuardCondition.h"
+#include "tsDecimal.h"
 #include "tsFormat.h"
 TSDUCK_SOURCE;
 
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+const size_t ts::AsyncReport::MAX_LOG_MESSAGES;
+const size_t ts::AsyncReport::LOG_RECORD_SIZE;
+const size_t ts::AsyncReport::RATE_SITES;
+const ts::MilliSecond ts::AsyncReport::IDLE_TIMEOUT;
+#endif
+
 
 //----------------------------------------------------------------------------
 // Default constructor
@@ -43,12 +53,31 @@ TSDUCK_SOURCE;
 ts::AsyncReport::AsyncReport (bool verbose, int debug_level, bool time_stamp) :
     ReportInterface(verbose, debug_level),
     Thread(ThreadAttributes().setPriority(ThreadAttributes::GetMinimumPriority())),
-    _log_queue(MAX_LOG_MESSAGES),
+    _ring(),
+    _sites(),
+    _enqueue_pos(0),
+    _dequeue_pos(0),
+    _sleeping(false),
+    _terminate(false),
+    _dropped(0),
+    _limited(0),
+    _dropped_reported(0),
+    _limited_reported(0),
+    _mutex(),
+    _wake(),
+    _message_time(),
     _default_handler(*this),
     _handler(&_default_handler),
     _time_stamp(time_stamp),
+    _rate_limit(0),
     _terminated(false)
 {
+    // Preallocate all log records. A free record has the sequence number of its position.
+    for (size_t i = 0; i < MAX_LOG_MESSAGES; ++i) {
+        _ring[i].sequence = i;
+        _ring[i].message.reserve(LOG_RECORD_SIZE);
+    }
+
     // Start the logging thread
     start ();
 }
@@ -71,9 +100,12 @@ ts::AsyncReport::~AsyncReport ()
 void ts::AsyncReport::terminate()
 {
     if (!_terminated) {
-        // Insert an "end of report" message in the queue.
-        // This message will tell the logging thread to terminate.
-        _log_queue.forceEnqueue(new LogMessage(true, 0, ""));
+        // Tell the logging thread to terminate after logging all pending messages.
+        _terminate = true;
+        {
+            Guard lock(_mutex);
+            _wake.signal();
+        }
 
         // Wait for termination of the logging thread
         waitForTermination();
@@ -82,15 +114,89 @@ void ts::AsyncReport::terminate()
 }
 
 
+//----------------------------------------------------------------------------
+// Check if a message is allowed by the rate limit.
+//----------------------------------------------------------------------------
+
+bool ts::AsyncReport::allowedByRate(int severity, const std::string& msg, const Time& now)
+{
+    const size_t limit = _rate_limit;
+    if (limit == 0 || severity <= Severity::Fatal || severity >= Severity::Debug) {
+        return true;
+    }
+
+    // Identify the message site using a FNV-1a hash of the severity and the non-digit characters.
+    uint32_t hash = 2166136261UL ^ uint32_t(severity);
+    for (std::string::const_iterator it = msg.begin(); it != msg.end(); ++it) {
+        if (*it < '0' || *it > '9') {
+            hash = (hash ^ uint8_t(*it)) * 16777619UL;
+        }
+    }
+    RateSite& site(_sites[hash & (RATE_SITES - 1)]);
+
+    // Restart the count at the beginning of each second. Concurrent threads may
+    // lose a few counts when the period changes, this is harmless.
+    const int64_t second = (now - Time::Epoch) / MilliSecPerSec;
+    int64_t previous = site.second.load(std::memory_order_relaxed);
+    if (previous != second && site.second.compare_exchange_strong(previous, second)) {
+        site.count = 0;
+    }
+    return site.count++ < limit;
+}
+
+
 //----------------------------------------------------------------------------
 // Message logging method.
 //----------------------------------------------------------------------------
 
 void ts::AsyncReport::writeLog (int severity, const std::string &msg)
 {
-    if (!_terminated && severity <= _max_severity) {
-        // Enqueue the message immediately (timeout = 0), drop message on overflow.
-        _log_queue.enqueue(new LogMessage(false, severity, msg), 0);
+    if (_terminated || _terminate || severity > _max_severity) {
+        return;
+    }
+
+    // Get the current time only when needed.
+    const bool need_time = _time_stamp || _rate_limit > 0;
+    const Time now(need_time ? Time::CurrentUTC() : Time::Epoch);
+
+    if (!allowedByRate(severity, msg, now)) {
+        ++_limited;
+        return;
+    }
+
+    // Reserve a free record in the ring. Drop the message if the ring is full.
+    size_t pos = _enqueue_pos.load(std::memory_order_relaxed);
+    LogRecord* rec = 0;
+    for (;;) {
+        rec = &_ring[pos & (MAX_LOG_MESSAGES - 1)];
+        const size_t seq = rec->sequence.load(std::memory_order_acquire);
+        if (seq == pos) {
+            if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (seq < pos + 1) {
+            // Record not yet consumed by the logging thread, the ring is full.
+            ++_dropped;
+            return;
+        }
+        else {
+            // Another thread got this record, try the next one.
+            pos = _enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Fill the record and publish it to the logging thread.
+    rec->severity = severity;
+    rec->time = now;
+    rec->message.assign(msg);
+    rec->sequence.store(pos + 1, std::memory_order_release);
+
+    // Wake up the logging thread only if it waits for messages.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_sleeping.load()) {
+        Guard lock(_mutex);
+        _wake.signal();
     }
 }
 
@@ -101,25 +207,84 @@ void ts::AsyncReport::writeLog (int severity, const std::string &msg)
 
 void ts::AsyncReport::main ()
 {
-    LogMessagePtr msg;
+    size_t count = 0;
+
+    for (;;) {
+        LogRecord& rec(_ring[_dequeue_pos & (MAX_LOG_MESSAGES - 1)]);
 
-    while (_log_queue.dequeue(msg) && !msg->terminate) {
+        if (rec.sequence.load(std::memory_order_acquire) == _dequeue_pos + 1) {
 
-        // Invoke the report handler
-        _handler->handleMessage(msg->severity, msg->message);
+            // Invoke the report handler
+            _message_time = rec.time;
+            _handler->handleMessage(rec.severity, rec.message);
 
-        // Abort application on fatal error
-        if (msg->severity == Severity::Fatal) {
-            ::exit (EXIT_FAILURE);
+            // Abort application on fatal error
+            if (rec.severity == Severity::Fatal) {
+                ::exit (EXIT_FAILURE);
+            }
+
+            // Release the record for the next round in the ring.
+            rec.sequence.store(_dequeue_pos + MAX_LOG_MESSAGES, std::memory_order_release);
+            _dequeue_pos++;
+
+            // Report losses periodically during long bursts.
+            if (++count % MAX_LOG_MESSAGES == 0) {
+                reportLosses();
+            }
+        }
+        else if (_terminate) {
+            // No more pending message.
+            break;
+        }
+        else {
+            // Queue empty, wait for a new message.
+            reportLosses();
+            GuardCondition lock(_mutex, _wake);
+            _sleeping = true;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (rec.sequence.load(std::memory_order_acquire) != _dequeue_pos + 1 && !_terminate) {
+                lock.waitCondition(IDLE_TIMEOUT);
+            }
+            _sleeping = false;
         }
     }
 
+    reportLosses();
+
     if (_max_severity >= Severity::Debug) {
         _handler->handleMessage(Severity::Debug, "Report logging thread terminated");
     }
 }
 
 
+//----------------------------------------------------------------------------
+// Report dropped messages, in the context of the logging thread.
+//----------------------------------------------------------------------------
+
+void ts::AsyncReport::reportLosses()
+{
+    const uint64_t dropped = _dropped;
+    const uint64_t limited = _limited;
+
+    if ((dropped > _dropped_reported || limited > _limited_reported) && _max_severity >= Severity::Warning) {
+        std::string msg;
+        if (dropped > _dropped_reported) {
+            msg = Decimal(dropped - _dropped_reported) + " messages dropped, log queue full";
+        }
+        if (limited > _limited_reported) {
+            if (!msg.empty()) {
+                msg.append(", ");
+            }
+            msg.append(Decimal(limited - _limited_reported) + " messages dropped, rate limit reached");
+        }
+        _message_time = Time::CurrentUTC();
+        _handler->handleMessage(Severity::Warning, msg);
+    }
+    _dropped_reported = dropped;
+    _limited_reported = limited;
+}
+
+
 //----------------------------------------------------------------------------
 // Set a new ReportHandler
 //----------------------------------------------------------------------------
@@ -138,7 +303,9 @@ void ts::AsyncReport::DefaultHandler::handleMessage(int severity, const std::str
 {
     std::cerr << "* ";
     if (_report._time_stamp) {
-        std::cerr << ts::Time::CurrentLocalTime().format(ts::Time::DATE | ts::Time::TIME) << " - ";
+        // The time of the message is recorded in UTC by the application thread.
+        const Time time(_report._message_time == Time::Epoch ? Time::CurrentUTC() : _report._message_time);
+        std::cerr << time.UTCToLocal().format(ts::Time::DATE | ts::Time::TIME) << " - ";
     }
     std::cerr << Severity::Header(severity) << msg << std::endl;
 }
@@ -35,9 +35,11 @@
 #pragma once
 #include "tsReportInterface.h"
 #include "tsReportHandler.h"
-#include "tsMessageQueue.h"
-#include "tsNullMutex.h"
 #include "tsThread.h"
+#include "tsMutex.h"
+#include "tsCondition.h"
+#include "tsTime.h"
+#include <atomic>
 
 namespace ts {
     //!
@@ -48,11 +50,22 @@ namespace ts {
     //! to the caller without waiting. The messages are logged later in one single
     //! low-priority thread.
     //!
-    //! In case of a huge amount of errors, there is no avalanche effect. If a caller
-    //! cannot immediately enqueue a message or if the internal queue of messages is
-    //! full, the message is dropped. In other words, reporting messages is guaranteed
-    //! to never block, slow down or crash the application. Messages are dropped when
-    //! necessary to avoid that kind of problem.
+    //! In case of a huge amount of errors, there is no avalanche effect. If the internal
+    //! queue of messages is full, the message is dropped. In other words, reporting
+    //! messages is guaranteed to never block, slow down or crash the application.
+    //! Messages are dropped when necessary to avoid that kind of problem.
+    //!
+    //! The internal queue is a fixed ring of preallocated log records. Application
+    //! threads enqueue messages without locking any mutex and, unless a message is
+    //! unusually long, without memory allocation. The severity header and the time
+    //! stamp are formatted later, in the logging thread.
+    //!
+    //! Optionally, the number of messages per second from the same "message site"
+    //! can be limited. Two messages come from the same site when they have the same
+    //! severity and differ only by their digits (typically the same format with
+    //! distinct values). Debug messages and fatal errors are never limited.
+    //!
+    //! The number of dropped and limited messages is periodically reported.
     //!
     //! Messages are displayed on the standard error device by default.
     //!
@@ -92,8 +105,34 @@ namespace ts {
         //!
         bool getTimeStamp() const { return _time_stamp; }
 
+        //!
+        //! Set the maximum number of messages per second from the same message site.
+        //! @param [in] max_messages Maximum number of messages per second from the
+        //! same site. Zero means no limit (the default).
+        //!
+        void setRateLimit(size_t max_messages) { _rate_limit = max_messages; }
+
+        //!
+        //! Get the maximum number of messages per second from the same message site.
+        //! @return The maximum number of messages per second from the same site, zero if unlimited.
+        //!
+        size_t getRateLimit() const { return _rate_limit; }
+
+        //!
+        //! Get the number of messages which were dropped because the queue was full.
+        //! @return The number of dropped messages since the creation of the object.
+        //!
+        uint64_t droppedMessages() const { return _dropped; }
+
+        //!
+        //! Get the number of messages which were dropped because of the rate limit.
+        //! @return The number of rate-limited messages since the creation of the object.
+        //!
+        uint64_t limitedMessages() const { return _limited; }
+
         //!
         //! Synchronously terminate the report thread.
+        //! All pending messages are logged before returning.
         //! Automatically performed in destructor.
         //!
         void terminate();
@@ -109,24 +148,40 @@ namespace ts {
         // This hook is invoked in the context of the logging thread.
         virtual void main() override;
 
-        // The application threads send that type of message to the logging thread
-        struct LogMessage
+        // Maximum number of messages in the queue, must be a power of 2.
+        // Must be limited since the logging thread has a low priority.
+        // If a high priority thread loops on report, it would exhaust the memory.
+        static const size_t MAX_LOG_MESSAGES = 512;
+
+        // Preallocated size of the text in each log record.
+        // Longer messages are still logged but allocate memory.
+        static const size_t LOG_RECORD_SIZE = 256;
+
+        // Number of entries in the rate limiting table, must be a power of 2.
+        // Distinct message sites with the same hash share the same entry.
+        static const size_t RATE_SITES = 256;
+
+        // Maximum time to wait for messages in the logging thread.
+        static const MilliSecond IDLE_TIMEOUT = 200;
+
+        // A log record in the ring. The sequence number indicates the state of the record:
+        // equal to its position when free, position + 1 when containing a message to log.
+        struct LogRecord
         {
-            // Members
-            bool terminate;  // ask the logging thread to terminate
-            int severity;
+            std::atomic<size_t> sequence;
+            int         severity;
+            Time        time;      // UTC time of the message, when time stamps are active.
             std::string message;
-
-            // Constructor:
-            LogMessage (bool t, int s, const std::string& m) : terminate (t), severity (s), message (m) {}
+            LogRecord() : sequence(0), severity(0), time(), message() {}
         };
-        typedef SafePtr <LogMessage, NullMutex> LogMessagePtr;
-        typedef MessageQueue <LogMessage, NullMutex> LogMessageQueue;
 
-        // Maximum number of messages in the queue.
-        // Must be limited since the logging thread has a low priority.
-        // If a high priority thread loops on report, it would exhaust the memory.
-        static const size_t MAX_LOG_MESSAGES = 512;
+        // An entry in the rate limiting table.
+        struct RateSite
+        {
+            std::atomic<int64_t>  second;  // Current one-second period.
+            std::atomic<uint32_t> count;   // Number of messages in this period.
+            RateSite() : second(0), count(0) {}
+        };
 
         // Default report handler:
         class DefaultHandler : public ReportHandler
@@ -138,11 +193,30 @@ namespace ts {
             virtual void handleMessage(int, const std::string&);
         };
 
+        // Check if a message is allowed by the rate limit.
+        bool allowedByRate(int severity, const std::string& msg, const Time& now);
+
+        // Report dropped messages, in the context of the logging thread.
+        void reportLosses();
+
         // Private members:
-        LogMessageQueue _log_queue;
-        DefaultHandler _default_handler;
+        LogRecord           _ring[MAX_LOG_MESSAGES];
+        RateSite            _sites[RATE_SITES];
+        std::atomic<size_t> _enqueue_pos;     // Next position to write, shared by all application threads.
+        size_t              _dequeue_pos;     // Next position to read, in the logging thread only.
+        std::atomic<bool>   _sleeping;        // The logging thread waits for messages.
+        std::atomic<bool>   _terminate;       // Ask the logging thread to terminate.
+        std::atomic<uint64_t> _dropped;       // Dropped messages, queue full.
+        std::atomic<uint64_t> _limited;       // Dropped messages, rate limit.
+        uint64_t            _dropped_reported;
+        uint64_t            _limited_reported;
+        Mutex               _mutex;           // Used to wake up the logging thread only.
+        Condition           _wake;            // Signaled when a message is available.
+        Time                _message_time;    // Time of the message being logged, in the logging thread.
+        DefaultHandler      _default_handler;
         ReportHandler* volatile _handler;
-        volatile bool _time_stamp;
-        volatile bool _terminated;
+        volatile bool       _time_stamp;
+        volatile size_t     _rate_limit;
+        volatile bool       _terminated;
     };
 }
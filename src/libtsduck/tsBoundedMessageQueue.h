@@ -0,0 +1,173 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Template bounded message queue for inter-thread communication
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+#include "tsSafePtr.h"
+#include "tsMutex.h"
+#include "tsCondition.h"
+#include <atomic>
+
+namespace ts {
+
+    //!
+    //! Template bounded message queue for inter-thread communication.
+    //!
+    //! This class is a variant of ts::MessageQueue with a fixed capacity. It has the
+    //! same enqueue and dequeue semantics, including timeouts, but the messages are
+    //! stored in a preallocated array instead of a list. There is no memory allocation
+    //! per message in the queue itself.
+    //!
+    //! Any number of producer and consumer threads can simultaneously use the queue.
+    //! When the queue is neither full nor empty, enqueue() and dequeue() do not lock
+    //! any mutex. A mutex and conditions are used only to make a thread wait when the
+    //! queue is full (producer) or empty (consumer), and to wake up waiting threads.
+    //! The producer and consumer indexes are in distinct cache lines to avoid false
+    //! sharing between producer and consumer threads.
+    //!
+    //! Since the capacity is fixed, there is no equivalent to MessageQueue::forceEnqueue().
+    //!
+    //! @tparam MSG The type of the messages to exchange.
+    //! @tparam MUTEX The type of mutex for the safe pointers to messages (ts::Mutex by default).
+    //!
+    template <typename MSG, class MUTEX = Mutex>
+    class BoundedMessageQueue
+    {
+    public:
+        //!
+        //! Safe pointer to messages.
+        //! Same as MessageQueue::MessagePtr.
+        //!
+        typedef SafePtr<MSG, MUTEX> MessagePtr;
+
+        //!
+        //! Constructor.
+        //!
+        //! @param [in] maxMessages Maximum number of messages in the queue.
+        //! The actual capacity is rounded up to the next power of 2.
+        //! When a thread attempts to enqueue a message and the queue is full,
+        //! the thread waits until at least one message is dequeued.
+        //!
+        explicit BoundedMessageQueue(size_t maxMessages);
+
+        //!
+        //! Destructor
+        //!
+        ~BoundedMessageQueue();
+
+        //!
+        //! Get the maximum allowed messages in the queue.
+        //!
+        //! @return The maximum allowed messages in the queue.
+        //!
+        size_t getMaxMessages() const
+        {
+            return _mask + 1;
+        }
+
+        //!
+        //! Insert a message in the queue.
+        //!
+        //! If the queue is full, the calling thread waits until some space becomes
+        //! available in the queue or the timeout expires.
+        //!
+        //! @param [in] msg The message to enqueue.
+        //! @param [in] timeout Maximum time to wait in milliseconds.
+        //! If @a timeout is zero and the queue is full, return immediately.
+        //! @return True on success, false on error (queue still full after timeout).
+        //!
+        bool enqueue(const MessagePtr& msg, MilliSecond timeout = Infinite);
+
+        //!
+        //! Remove a message from the queue.
+        //!
+        //! Wait until a message is received or the timeout expires.
+        //!
+        //! @param [out] msg Received message.
+        //! @param [in] timeout Maximum time to wait in milliseconds.
+        //! If @a timeout is zero and the queue is empty, return immediately.
+        //! @return True on success, false on error (queue still empty after timeout).
+        //!
+        bool dequeue(MessagePtr& msg, MilliSecond timeout = Infinite);
+
+    private:
+        BoundedMessageQueue() = delete;
+        BoundedMessageQueue(const BoundedMessageQueue&) = delete;
+        BoundedMessageQueue& operator=(const BoundedMessageQueue&) = delete;
+
+        // Assumed size of a cache line, for padding.
+        static const size_t CACHE_LINE_SIZE = 64;
+
+        // A cell in the array. The sequence number indicates the state of the cell:
+        // equal to its position when free, position + 1 when containing a message.
+        struct Cell
+        {
+            std::atomic<size_t> sequence;
+            MessagePtr          message;
+            Cell() : sequence(0), message() {}
+        };
+
+        // An atomic counter alone in its cache line.
+        struct PaddedCounter
+        {
+            std::atomic<size_t> value;
+            char pad[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+            PaddedCounter() : value(0), pad() {}
+        };
+
+        // Compute the mask of indexes from a required capacity.
+        static size_t CapacityMask(size_t maxMessages);
+
+        // Try to enqueue or dequeue without waiting.
+        bool tryEnqueue(const MessagePtr& msg);
+        bool tryDequeue(MessagePtr& msg);
+
+        // Wake up one thread which waits on a condition, if there is any.
+        // The mutex must not be held by the caller.
+        void notify(PaddedCounter& waiters, Condition& condition);
+
+        // Private members.
+        const size_t  _mask;         // Capacity - 1, the capacity is a power of 2.
+        Cell*         _cells;        // Array of cells.
+        PaddedCounter _enqueue_pos;  // Next position to write.
+        PaddedCounter _dequeue_pos;  // Next position to read.
+        PaddedCounter _producers;    // Number of producers waiting for space.
+        PaddedCounter _consumers;    // Number of consumers waiting for messages.
+        Mutex         _mutex;        // Protect the waiting operations only.
+        Condition     _enqueued;     // Signaled when some message is inserted and a consumer waits.
+        Condition     _dequeued;     // Signaled when some message is removed and a producer waits.
+    };
+}
+
+#include "tsBoundedMessageQueueTemplate.h"
@@ -0,0 +1,257 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Template bounded message queue for inter-thread communication
+//
+//----------------------------------------------------------------------------
+
+#include "tsGuard.h"
+#include "tsGuardCondition.h"
+#include "tsTime.h"
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+template <typename MSG, class MUTEX>
+const size_t ts::BoundedMessageQueue<MSG, MUTEX>::CACHE_LINE_SIZE;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+ts::BoundedMessageQueue<MSG, MUTEX>::BoundedMessageQueue(size_t maxMessages) :
+    _mask(CapacityMask(maxMessages)),
+    _cells(new Cell[_mask + 1]),
+    _enqueue_pos(),
+    _dequeue_pos(),
+    _producers(),
+    _consumers(),
+    _mutex(),
+    _enqueued(),
+    _dequeued()
+{
+    // A free cell has the sequence number of its position.
+    for (size_t i = 0; i <= _mask; ++i) {
+        _cells[i].sequence = i;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+ts::BoundedMessageQueue<MSG, MUTEX>::~BoundedMessageQueue()
+{
+    delete[] _cells;
+}
+
+
+//----------------------------------------------------------------------------
+// Compute the mask of indexes: the capacity is rounded up to a power of 2.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+size_t ts::BoundedMessageQueue<MSG, MUTEX>::CapacityMask(size_t maxMessages)
+{
+    size_t capacity = 1;
+    while (capacity < maxMessages) {
+        capacity <<= 1;
+    }
+    return capacity - 1;
+}
+
+
+//----------------------------------------------------------------------------
+// Try to insert a message in the queue without waiting.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+bool ts::BoundedMessageQueue<MSG, MUTEX>::tryEnqueue(const MessagePtr& msg)
+{
+    size_t pos = _enqueue_pos.value.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell& cell(_cells[pos & _mask]);
+        const size_t seq = cell.sequence.load(std::memory_order_acquire);
+        if (seq == pos) {
+            // Free cell, try to reserve it.
+            if (_enqueue_pos.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                cell.message = msg;
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (seq < pos) {
+            // Cell not yet dequeued from the previous round, the queue is full.
+            return false;
+        }
+        else {
+            // Another producer got this cell.
+            pos = _enqueue_pos.value.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Try to remove a message from the queue without waiting.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+bool ts::BoundedMessageQueue<MSG, MUTEX>::tryDequeue(MessagePtr& msg)
+{
+    size_t pos = _dequeue_pos.value.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell& cell(_cells[pos & _mask]);
+        const size_t seq = cell.sequence.load(std::memory_order_acquire);
+        if (seq == pos + 1) {
+            // Cell containing a message, try to reserve it.
+            if (_dequeue_pos.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                msg = cell.message;
+                cell.message.clear();
+                cell.sequence.store(pos + _mask + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (seq < pos + 1) {
+            // Cell not yet written, the queue is empty.
+            return false;
+        }
+        else {
+            // Another consumer got this cell.
+            pos = _dequeue_pos.value.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Wake up one thread which waits on a condition, if there is any.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+void ts::BoundedMessageQueue<MSG, MUTEX>::notify(PaddedCounter& waiters, Condition& condition)
+{
+    // The fence orders the update of the cell before the check of the waiters.
+    // A waiting thread increments the counter before checking the cells, under
+    // the protection of the mutex, so that no notification is lost.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters.value.load(std::memory_order_relaxed) > 0) {
+        Guard lock(_mutex);
+        condition.signal();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Insert a message in the queue with a timeout.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+bool ts::BoundedMessageQueue<MSG, MUTEX>::enqueue(const MessagePtr& msg, MilliSecond timeout)
+{
+    // Fast path, without lock.
+    bool done = tryEnqueue(msg);
+
+    // If the queue is full, wait for the queue not being full
+    if (!done && timeout > 0) {
+        GuardCondition lock(_mutex, _dequeued);
+        ++_producers.value;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        Time start(Time::CurrentUTC());
+        while (!(done = tryEnqueue(msg))) {
+
+            // Reduce timeout
+            if (timeout != Infinite) {
+                const Time now(Time::CurrentUTC());
+                timeout -= now - start;
+                start = now;
+                if (timeout <= 0) {
+                    break; // timeout
+                }
+            }
+
+            // Wait for a message to be dequeued
+            // => temporarily release mutex and wait for dequeued condition.
+            lock.waitCondition(timeout);
+        }
+        --_producers.value;
+    }
+
+    // Signal that a message has been enqueued
+    if (done) {
+        notify(_consumers, _enqueued);
+    }
+    return done;
+}
+
+
+//----------------------------------------------------------------------------
+// Remove a message from the queue.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+bool ts::BoundedMessageQueue<MSG, MUTEX>::dequeue(MessagePtr& msg, MilliSecond timeout)
+{
+    // Fast path, without lock.
+    bool done = tryDequeue(msg);
+
+    // If the queue is empty, wait for the queue not being empty
+    if (!done && timeout > 0) {
+        GuardCondition lock(_mutex, _enqueued);
+        ++_consumers.value;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        Time start(Time::CurrentUTC());
+        while (!(done = tryDequeue(msg))) {
+
+            // Reduce timeout
+            if (timeout != Infinite) {
+                const Time now(Time::CurrentUTC());
+                timeout -= now - start;
+                start = now;
+                if (timeout <= 0) {
+                    break; // timeout
+                }
+            }
+
+            // Wait for a message to be enqueued
+            // => temporarily release mutex and wait for enqueued condition.
+            lock.waitCondition(timeout);
+        }
+        --_consumers.value;
+    }
+
+    // Signal that a message has been dequeued
+    if (done) {
+        notify(_producers, _dequeued);
+    }
+    return done;
+}
@@ -31,6 +31,9 @@
 #include "tsByteBlock.h"
 #include "tsUString.h"
 #include "tsDecimal.h"
+#if defined(__x86_64)
+#include <emmintrin.h>
+#endif
 TSDUCK_SOURCE;
 
 
@@ -41,6 +44,7 @@ TSDUCK_SOURCE;
 ts::DVBCharsetSingleByte::DVBCharsetSingleByte(const UString& name, uint32_t tableCode, std::initializer_list<uint16_t> init) :
     DVBCharset(name, tableCode),
     _upperCodePoints(init),
+    _codePoints(),
     _bytesMap()
 {
     // Check the size of the upper code point table.
@@ -51,14 +55,17 @@ ts::DVBCharsetSingleByte::DVBCharsetSingleByte(const UString& name, uint32_t tab
 
     // Code point to byte mapping for ASCII range
     for (size_t i = 0x20; i <= 0x7E; i++) {
+        _codePoints[i] = UChar(i);
         _bytesMap.insert(std::make_pair(UChar(i), uint8_t(i)));
     }
 
     // Control codes
+    _codePoints[DVB_SINGLE_BYTE_CRLF] = LINE_FEED;
     _bytesMap.insert(std::make_pair(LINE_FEED, DVB_SINGLE_BYTE_CRLF));
 
     // Code point to byte mapping for 0xA0-0xFF range
     for (size_t i = 0; i < _upperCodePoints.size(); i++) {
+        _codePoints[0xA0 + i] = UChar(_upperCodePoints[i]);
         if (_upperCodePoints[i] != 0) {
             _bytesMap.insert(std::make_pair(UChar(_upperCodePoints[i]), uint8_t(0xA0 + i)));
         }
@@ -66,6 +73,68 @@ ts::DVBCharsetSingleByte::DVBCharsetSingleByte(const UString& name, uint32_t tab
 }
 
 
+//----------------------------------------------------------------------------
+// Fast conversion of runs of printable ASCII characters (0x20-0x7E), which
+// are identical in all single-byte character sets. On x86_64, SSE2 is always
+// available and 16 bytes or 8 characters are checked and converted at a time.
+//----------------------------------------------------------------------------
+
+namespace {
+    inline bool IsPrintableASCII(uint16_t c)
+    {
+        return c >= 0x20 && c <= 0x7E;
+    }
+
+    inline void DecodePrintableASCII(const uint8_t*& in, const uint8_t* inEnd, ts::UChar*& out)
+    {
+#if defined(__x86_64)
+        const __m128i low = _mm_set1_epi8(0x1F);
+        const __m128i high = _mm_set1_epi8(0x7F);
+        const __m128i zero = _mm_setzero_si128();
+        while (inEnd - in >= 16) {
+            // Bytes 0x80-0xFF are negative in signed comparisons.
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+            const __m128i printable = _mm_and_si128(_mm_cmpgt_epi8(bytes, low), _mm_cmplt_epi8(bytes, high));
+            if (_mm_movemask_epi8(printable) != 0xFFFF) {
+                break;
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(bytes, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpackhi_epi8(bytes, zero));
+            in += 16;
+            out += 16;
+        }
+#endif
+        while (in < inEnd && IsPrintableASCII(*in)) {
+            *out++ = ts::UChar(*in++);
+        }
+    }
+
+    inline void EncodePrintableASCII(const ts::UChar*& in, const ts::UChar* inEnd, uint8_t*& out, size_t& size)
+    {
+#if defined(__x86_64)
+        const __m128i low = _mm_set1_epi16(0x1F);
+        const __m128i high = _mm_set1_epi16(0x7F);
+        while (inEnd - in >= 8 && size >= 8) {
+            // Characters 0x8000-0xFFFF are negative in signed comparisons.
+            const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+            const __m128i printable = _mm_and_si128(_mm_cmpgt_epi16(chars, low), _mm_cmplt_epi16(chars, high));
+            if (_mm_movemask_epi8(printable) != 0xFFFF) {
+                break;
+            }
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(chars, chars));
+            in += 8;
+            out += 8;
+            size -= 8;
+        }
+#endif
+        while (in < inEnd && size > 0 && IsPrintableASCII(*in)) {
+            *out++ = uint8_t(*in++);
+            size--;
+        }
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Decode a DVB string from the specified byte buffer.
 //----------------------------------------------------------------------------
@@ -73,32 +142,35 @@ ts::DVBCharsetSingleByte::DVBCharsetSingleByte(const UString& name, uint32_t tab
 bool ts::DVBCharsetSingleByte::decode(UString& str, const uint8_t* dvb, size_t dvbSize) const
 {
     str.clear();
-    str.reserve(dvbSize);
+    if (dvb == 0 || dvbSize == 0) {
+        return true;
+    }
+
+    // There is at most one character per byte. Decode directly into the string.
+    str.resize(dvbSize);
+    UChar* const base = const_cast<UChar*>(str.data());
+    UChar* out = base;
+    const uint8_t* const end = dvb + dvbSize;
     bool status = true;
 
-    for (; dvb != 0 && dvbSize > 0; --dvbSize) {
-        // Get next byte
+    while (dvb < end) {
+        // Convert next byte to a code point.
         const uint8_t b = *dvb++;
-        // Convert it to a code point
-        uint16_t cp = 0;
-        if (b >= 0x20 && b <= 0x7E) {
-            cp = b; // ASCII range = identity
-        }
-        else if (b >= 0xA0) {
-            cp = _upperCodePoints[b - 0xA0];
-        }
-        else if (b == DVB_SINGLE_BYTE_CRLF) {
-            cp = LINE_FEED;
-        }
-        // Add in result if no error.
-        if (cp != 0) {
-            str.push_back(UChar(cp));
-        }
-        else {
+        const UChar cp = _codePoints[b];
+        if (cp == 0) {
             // Untranslatable character.
             status = false;
         }
+        else {
+            *out++ = cp;
+            if (b < 0x80) {
+                // Printable ASCII character, convert the rest of the ASCII run at once.
+                DecodePrintableASCII(dvb, end, out);
+            }
+        }
     }
+
+    str.resize(out - base);
     return status;
 }
 
@@ -109,9 +181,10 @@ bool ts::DVBCharsetSingleByte::decode(UString& str, const uint8_t* dvb, size_t d
 
 bool ts::DVBCharsetSingleByte::canEncode(const UString& str, size_t start, size_t count) const
 {
-    for (size_t i = 0; i < str.length(); ++i) {
+    const size_t end = start + std::min(count, str.length() - std::min(start, str.length()));
+    for (size_t i = start; i < end; ++i) {
         const UChar cp = str[i];
-        if (_bytesMap.find(cp) == _bytesMap.end() && cp != CARRIAGE_RETURN) {
+        if (!IsPrintableASCII(cp) && cp != CARRIAGE_RETURN && _bytesMap.find(cp) == _bytesMap.end()) {
             // Untranslatable character.
             return false;
         }
@@ -126,19 +199,34 @@ bool ts::DVBCharsetSingleByte::canEncode(const UString& str, size_t start, size_
 
 size_t ts::DVBCharsetSingleByte::encode(uint8_t*& buffer, size_t& size, const UString& str, size_t start, size_t count) const
 {
+    if (buffer == 0 || start >= str.length()) {
+        return 0;
+    }
+
+    const UChar* in = str.data() + start;
+    const UChar* const end = in + std::min(count, str.length() - start);
     size_t result = 0;
+
     // Serialize characters as long as there is free space.
-    while (buffer != 0 && size > 0 && start < str.length() && count > 0) {
-        const UChar cp = str[start];
-        const std::map<UChar, uint8_t>::const_iterator it = _bytesMap.find(cp);
-        if (cp != ts::CARRIAGE_RETURN && it != _bytesMap.end()) {
-            // Encode character.
-            *buffer++ = it->second;
+    while (size > 0 && in < end) {
+        const UChar cp = *in++;
+        if (IsPrintableASCII(cp)) {
+            // Encode this character and the rest of the ASCII run at once.
+            const UChar* const first = in - 1;
+            *buffer++ = uint8_t(cp);
             size--;
-            result++;
+            EncodePrintableASCII(in, end, buffer, size);
+            result += in - first;
+        }
+        else if (cp != CARRIAGE_RETURN) {
+            const std::map<UChar, uint8_t>::const_iterator it = _bytesMap.find(cp);
+            if (it != _bytesMap.end()) {
+                // Encode character.
+                *buffer++ = it->second;
+                size--;
+                result++;
+            }
         }
-        start++;
-        count--;
     }
     return result;
 }
@@ -29,6 +29,9 @@
 
 #include "tsDVBCharsetUTF16.h"
 #include "tsUString.h"
+#if defined(__x86_64)
+#include <emmintrin.h>
+#endif
 TSDUCK_SOURCE;
 
 // UNICODE character set singleton 
@@ -43,10 +46,27 @@ bool ts::DVBCharsetUTF16::decode(UString& str, const uint8_t* dvb, size_t dvbSiz
 {
     // We simply copy 2 bytes per character.
     str.clear();
-    str.reserve(dvbSize / 2);
-    for (size_t i = 0; dvb != 0 && i + 1 < dvbSize; i += 2) {
-        const uint16_t cp = GetUInt16(dvb + i);
-        str.push_back(cp == DVB_CODEPOINT_CRLF ? ts::LINE_FEED : UChar(cp));
+    const size_t count = dvb == 0 ? 0 : dvbSize / 2;
+    str.resize(count);
+    UChar* const out = const_cast<UChar*>(str.data());
+    size_t i = 0;
+
+#if defined(__x86_64)
+    // With SSE2, swap bytes and translate new lines, 8 characters at a time.
+    const __m128i crlf = _mm_set1_epi16(short(DVB_CODEPOINT_CRLF));
+    const __m128i lf = _mm_set1_epi16(short(ts::LINE_FEED));
+    for (; i + 8 <= count; i += 8) {
+        __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dvb + 2 * i));
+        chars = _mm_or_si128(_mm_slli_epi16(chars, 8), _mm_srli_epi16(chars, 8));
+        const __m128i isCRLF = _mm_cmpeq_epi16(chars, crlf);
+        chars = _mm_or_si128(_mm_andnot_si128(isCRLF, chars), _mm_and_si128(isCRLF, lf));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), chars);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        const uint16_t cp = GetUInt16(dvb + 2 * i);
+        out[i] = cp == DVB_CODEPOINT_CRLF ? ts::LINE_FEED : UChar(cp);
     }
 
     // Truncated string if odd number of bytes.
@@ -71,10 +91,43 @@ bool ts::DVBCharsetUTF16::canEncode(const UString& str, size_t start, size_t cou
 
 size_t ts::DVBCharsetUTF16::encode(uint8_t*& buffer, size_t& size, const UString& str, size_t start, size_t count) const
 {
+    if (buffer == 0 || start >= str.length()) {
+        return 0;
+    }
+
+    const UChar* in = str.data() + start;
+    const UChar* const end = in + std::min(count, str.length() - start);
     size_t result = 0;
+
     // Serialize characters as long as there is free space.
-    while (buffer != 0 && size > 1 && start < str.length() && count > 0) {
-        const UChar cp = str[start];
+    while (size > 1 && in < end) {
+
+#if defined(__x86_64)
+        // With SSE2, translate new lines and swap bytes, 8 characters at a time,
+        // as long as there is no carriage return to skip.
+        const __m128i cr = _mm_set1_epi16(short(ts::CARRIAGE_RETURN));
+        const __m128i lf = _mm_set1_epi16(short(ts::LINE_FEED));
+        const __m128i crlf = _mm_set1_epi16(short(DVB_CODEPOINT_CRLF));
+        while (end - in >= 8 && size >= 16) {
+            __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(chars, cr)) != 0) {
+                break;
+            }
+            const __m128i isLF = _mm_cmpeq_epi16(chars, lf);
+            chars = _mm_or_si128(_mm_andnot_si128(isLF, chars), _mm_and_si128(isLF, crlf));
+            chars = _mm_or_si128(_mm_slli_epi16(chars, 8), _mm_srli_epi16(chars, 8));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), chars);
+            in += 8;
+            buffer += 16;
+            size -= 16;
+            result += 8;
+        }
+        if (size < 2 || in >= end) {
+            break;
+        }
+#endif
+
+        const UChar cp = *in++;
         if (cp != ts::CARRIAGE_RETURN) {
             // Encode character.
             PutUInt16(buffer, cp == ts::LINE_FEED ? DVB_CODEPOINT_CRLF : uint16_t(cp));
@@ -82,8 +135,6 @@ size_t ts::DVBCharsetUTF16::encode(uint8_t*& buffer, size_t& size, const UString
             size -= 2;
             result++;
         }
-        start++;
-        count--;
     }
     return result;
 }
@@ -63,33 +63,34 @@ bool ts::DVBCharsetUTF8::canEncode(const UString& str, size_t start, size_t coun
 
 size_t ts::DVBCharsetUTF8::encode(uint8_t*& buffer, size_t& size, const UString& str, size_t start, size_t count) const
 {
-    size_t result = 0;
-
-    // Serialize characters as long as there is free space.
-    while (buffer != 0 && size > 0 && start < str.length() && count > 0) {
-        if (str[start] != ts::CARRIAGE_RETURN) {
+    if (buffer == 0 || start >= str.length()) {
+        return 0;
+    }
 
-            // Convert a 1-character string to UTF-8.
-            const std::string utf8(str.substr(start, 1).toUTF8());
-            const size_t len = utf8.length();
-            if (len > size) {
-                // Won't fit in the buffer, stop now.
-                break;
-            }
+    const UChar* in = str.data() + start;
+    const UChar* const end = in + std::min(count, str.length() - start);
+    char* out = reinterpret_cast<char*>(buffer);
+    char* const outEnd = out + size;
+    size_t result = 0;
 
-            // Small optimization.
-            if (len == 1) {
-                *buffer = uint8_t(utf8[0]);
-            }
-            else {
-                ::memcpy(buffer, utf8.data(), len);
-            }
-            buffer += len;
-            size -= len;
-            result++;
+    // Convert segments of the string between carriage returns, which are skipped.
+    // Stop when the next character does not fit in the buffer.
+    while (in < end && out < outEnd) {
+        const UChar* const segEnd = std::find(in, end, ts::CARRIAGE_RETURN);
+        const UChar* const segStart = in;
+        UString::ConvertUTF16ToUTF8(in, segEnd, out, outEnd);
+        result += in - segStart;
+        if (in < segEnd) {
+            // Buffer full.
+            break;
+        }
+        else if (in < end) {
+            // Skip carriage return.
+            in++;
         }
-        start++;
-        count--;
     }
+
+    buffer = reinterpret_cast<uint8_t*>(out);
+    size = outEnd - out;
     return result;
 }
@@ -0,0 +1,105 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Read-only view of a descriptor loop in binary data
+//
+//----------------------------------------------------------------------------
+
+#include "tsDescriptorLoopView.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Build a ts::Descriptor object from an entry.
+//----------------------------------------------------------------------------
+
+ts::DescriptorPtr ts::DescriptorLoopView::Entry::toDescriptor() const
+{
+    return _data == 0 ? DescriptorPtr() : DescriptorPtr(new Descriptor(_data, size()));
+}
+
+
+//----------------------------------------------------------------------------
+// Iterator over the descriptors of the loop.
+//----------------------------------------------------------------------------
+
+ts::DescriptorLoopView::const_iterator::const_iterator(const uint8_t* data, size_t size) :
+    _data(data),
+    _size(size)
+{
+    check();
+}
+
+ts::DescriptorLoopView::const_iterator& ts::DescriptorLoopView::const_iterator::operator++()
+{
+    if (_data != 0) {
+        const size_t length = 2 + size_t(_data[1]);
+        _data += length;
+        _size -= length;
+        check();
+    }
+    return *this;
+}
+
+void ts::DescriptorLoopView::const_iterator::check()
+{
+    if (_data != 0 && (_size < 2 || 2 + size_t(_data[1]) > _size)) {
+        _data = 0;
+        _size = 0;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Count the number of descriptors in the loop.
+//----------------------------------------------------------------------------
+
+size_t ts::DescriptorLoopView::count() const
+{
+    size_t count = 0;
+    for (const_iterator it = begin(); it != end(); ++it) {
+        ++count;
+    }
+    return count;
+}
+
+
+//----------------------------------------------------------------------------
+// Search the first descriptor with a given tag.
+//----------------------------------------------------------------------------
+
+ts::DescriptorLoopView::Entry ts::DescriptorLoopView::search(DID tag) const
+{
+    for (const_iterator it = begin(); it != end(); ++it) {
+        if ((*it).tag() == tag) {
+            return *it;
+        }
+    }
+    return Entry();
+}
@@ -0,0 +1,223 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only view of a descriptor loop in binary data
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsDescriptor.h"
+#include "tsDescriptorList.h"
+
+namespace ts {
+    //!
+    //! Read-only view of a descriptor loop in binary data.
+    //!
+    //! The descriptors are not copied. They are accessed in place in the binary
+    //! data, typically a section payload, which must remain valid and unmodified
+    //! as long as the view is used. A descriptor is decoded only when explicitly
+    //! requested, using Entry::toDescriptor().
+    //!
+    //! As with DescriptorList::add(), the loop ends at the first truncated descriptor.
+    //!
+    class TSDUCKDLL DescriptorLoopView
+    {
+    public:
+        //!
+        //! One descriptor in the loop.
+        //!
+        class TSDUCKDLL Entry
+        {
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] data Address of the complete descriptor (tag, length and payload).
+            //! A null pointer means an invalid entry.
+            //!
+            Entry(const uint8_t* data = 0) : _data(data) {}
+
+            //!
+            //! Check if this entry is valid.
+            //! @return True if this entry is valid.
+            //!
+            bool isValid() const {return _data != 0;}
+
+            //!
+            //! Get the descriptor tag.
+            //! @return The descriptor tag.
+            //!
+            DID tag() const {return _data == 0 ? DID(0) : _data[0];}
+
+            //!
+            //! Get the address of the complete descriptor (tag, length and payload).
+            //! @return The address of the complete descriptor.
+            //!
+            const uint8_t* content() const {return _data;}
+
+            //!
+            //! Get the size of the complete descriptor (tag, length and payload).
+            //! @return The size in bytes of the complete descriptor.
+            //!
+            size_t size() const {return _data == 0 ? 0 : 2 + size_t(_data[1]);}
+
+            //!
+            //! Get the address of the descriptor payload.
+            //! @return The address of the descriptor payload.
+            //!
+            const uint8_t* payload() const {return _data == 0 ? 0 : _data + 2;}
+
+            //!
+            //! Get the size of the descriptor payload.
+            //! @return The size in bytes of the descriptor payload.
+            //!
+            size_t payloadSize() const {return _data == 0 ? 0 : size_t(_data[1]);}
+
+            //!
+            //! Build a ts::Descriptor object from this entry.
+            //! The descriptor content is copied.
+            //! @return A safe pointer to the new descriptor or a null pointer if this entry is invalid.
+            //!
+            DescriptorPtr toDescriptor() const;
+
+        private:
+            const uint8_t* _data;
+        };
+
+        //!
+        //! Forward iterator over the descriptors of the loop.
+        //!
+        class TSDUCKDLL const_iterator
+        {
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] data Address of the remaining part of the descriptor loop.
+            //! @param [in] size Size in bytes of the remaining part of the descriptor loop.
+            //!
+            const_iterator(const uint8_t* data = 0, size_t size = 0);
+
+            //!
+            //! Get the current descriptor.
+            //! @return The current descriptor.
+            //!
+            Entry operator*() const {return Entry(_data);}
+
+            //!
+            //! Move to the next descriptor.
+            //! @return A reference to this iterator.
+            //!
+            const_iterator& operator++();
+
+            //!
+            //! Equality operator.
+            //! @param [in] other Another iterator to compare.
+            //! @return True if both iterators point to the same descriptor.
+            //!
+            bool operator==(const const_iterator& other) const {return _data == other._data;}
+
+            //!
+            //! Unequality operator.
+            //! @param [in] other Another iterator to compare.
+            //! @return True if both iterators do not point to the same descriptor.
+            //!
+            bool operator!=(const const_iterator& other) const {return _data != other._data;}
+
+        private:
+            const uint8_t* _data;  // Current descriptor, zero at end of loop.
+            size_t         _size;  // Remaining size from current descriptor.
+
+            // Check that the current descriptor is complete, move to end otherwise.
+            void check();
+        };
+
+        //!
+        //! Constructor.
+        //! @param [in] data Address of the descriptor loop.
+        //! @param [in] size Size in bytes of the descriptor loop.
+        //!
+        DescriptorLoopView(const uint8_t* data = 0, size_t size = 0) : _data(data), _size(data == 0 ? 0 : size) {}
+
+        //!
+        //! Get the address of the descriptor loop.
+        //! @return The address of the descriptor loop.
+        //!
+        const uint8_t* data() const {return _data;}
+
+        //!
+        //! Get the size of the descriptor loop.
+        //! @return The size in bytes of the descriptor loop.
+        //!
+        size_t size() const {return _size;}
+
+        //!
+        //! Check if the descriptor loop is empty.
+        //! @return True if the descriptor loop contains no valid descriptor.
+        //!
+        bool empty() const {return begin() == end();}
+
+        //!
+        //! Get an iterator to the first descriptor.
+        //! @return An iterator to the first descriptor.
+        //!
+        const_iterator begin() const {return const_iterator(_data, _size);}
+
+        //!
+        //! Get an iterator after the last descriptor.
+        //! @return An iterator after the last descriptor.
+        //!
+        const_iterator end() const {return const_iterator();}
+
+        //!
+        //! Count the number of descriptors in the loop.
+        //! @return The number of descriptors in the loop.
+        //!
+        size_t count() const;
+
+        //!
+        //! Search the first descriptor with a given tag.
+        //! @param [in] tag Tag to search.
+        //! @return The first descriptor with the specified tag or an invalid entry if not found.
+        //!
+        Entry search(DID tag) const;
+
+        //!
+        //! Decode all descriptors of the loop and append them in a descriptor list.
+        //! @param [in,out] list The descriptor list to update.
+        //!
+        void toDescriptorList(DescriptorList& list) const
+        {
+            list.add(_data, _size);
+        }
+
+    private:
+        const uint8_t* _data;
+        size_t         _size;
+    };
+}
@@ -0,0 +1,716 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Multiplexed ECM generator client. Use ECMG <=> SCS protocol to request
+//  ECM's for several ECM streams over one channel.
+//
+//----------------------------------------------------------------------------
+
+#include "tsECMGMultiClient.h"
+#include "tsGuardCondition.h"
+#include "tsTime.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+const size_t ts::ECMGMultiClient::RECEIVER_STACK_SIZE;
+const size_t ts::ECMGMultiClient::RESPONSE_QUEUE_SIZE;
+const ts::MilliSecond ts::ECMGMultiClient::RESPONSE_TIMEOUT;
+const ts::MilliSecond ts::ECMGMultiClient::COMPLETION_RETRY;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------
+
+ts::ECMGMultiClient::ECMGMultiClient(size_t max_completions) :
+    Thread(ThreadAttributes().setStackSize(RECEIVER_STACK_SIZE)),
+    _state(INITIAL),
+    _abort(0),
+    _report(NullReport::Instance()),
+    _connection(ecmgscs::Protocol::Instance(), true, 3),
+    _channel_status(),
+    _mutex(),
+    _work_to_do(),
+    _control_mutex(),
+    _flush_mutex(),
+    _streams(),
+    _pending_count(0),
+    _control_pending(false),
+    _control_stream(0),
+    _requests(new ByteBlock),
+    _sending(new ByteBlock),
+    _response_queue(RESPONSE_QUEUE_SIZE),
+    _completions(max_completions)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------------
+
+ts::ECMGMultiClient::~ECMGMultiClient()
+{
+    {
+        GuardCondition lock(_mutex, _work_to_do);
+
+        // Break connection, if not already done
+        _abort = 0;
+        _report = NullReport::Instance();
+        _connection.disconnect(NULLREP);
+        _connection.close(NULLREP);
+
+        // Notify receiver thread to terminate
+        _state = DESTRUCTING;
+        lock.signal();
+    }
+    waitForTermination();
+}
+
+
+//----------------------------------------------------------------------------
+// Report specified error message if not empty, abort connection and return false
+//----------------------------------------------------------------------------
+
+bool ts::ECMGMultiClient::abortConnection(const std::string& message)
+{
+    if (!message.empty()) {
+        _report->error(message);
+    }
+
+    GuardCondition lock(_mutex, _work_to_do);
+    _state = DISCONNECTED;
+    _connection.disconnect(*_report);
+    _connection.close(*_report);
+    lock.signal();
+
+    return false;
+}
+
+
+//----------------------------------------------------------------------------
+// Connect to a remote ECMG and open the ECM channel.
+//----------------------------------------------------------------------------
+
+bool ts::ECMGMultiClient::connect(const SocketAddress& ecmg_address,
+                                  uint32_t super_cas_id,
+                                  uint16_t ecm_channel_id,
+                                  ecmgscs::ChannelStatus& channel_status,
+                                  const AbortInterface* abort,
+                                  ReportInterface* report)
+{
+    Guard control(_control_mutex);
+
+    // Initial state check
+    {
+        Guard lock(_mutex);
+        // Start receiver thread if first time
+        if (_state == INITIAL) {
+            _state = DISCONNECTED;
+            Thread::start();
+        }
+        if (_state != DISCONNECTED) {
+            if (report != 0) {
+                report->error("ECMG client already connected");
+            }
+            return false;
+        }
+        _abort = abort;
+        _report = report ? report : NullReport::Instance();
+        _streams.clear();
+        _pending_count = 0;
+        _requests->clear();
+    }
+
+    // Perform TCP connection to ECMG server
+    // Flawfinder: ignore: this is our open(), not ::open().
+    if (!_connection.open(*_report)) {
+        return false;
+    }
+    if (!_connection.connect(ecmg_address, *_report)) {
+        _connection.close(*_report);
+        return false;
+    }
+
+    // Send a channel_setup message to ECMG
+    ecmgscs::ChannelSetup channel_setup;
+    channel_setup.channel_id = ecm_channel_id;
+    channel_setup.Super_CAS_id = super_cas_id;
+    if (!_connection.send(channel_setup, *_report)) {
+        return abortConnection("");
+    }
+
+    // Tell the receiver thread to start listening for incoming messages
+    {
+        GuardCondition lock(_mutex, _work_to_do);
+        _state = CONNECTING;
+        lock.signal();
+    }
+
+    // Wait for a channel_status from the ECMG
+    tlv::MessagePtr msg;
+    if (!waitResponse(msg, ecmgscs::Tags::channel_status, 0)) {
+        return abortConnection("ECMG channel_setup failed");
+    }
+    ecmgscs::ChannelStatus* const csp = dynamic_cast<ecmgscs::ChannelStatus*>(msg.pointer());
+    assert(csp != 0);
+
+    // ECM channel now established
+    {
+        Guard lock(_mutex);
+        channel_status = _channel_status = *csp;
+        _state = CONNECTED;
+    }
+
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Wait for a response to a control operation.
+//----------------------------------------------------------------------------
+
+bool ts::ECMGMultiClient::waitResponse(tlv::MessagePtr& msg, tlv::TAG expected, uint16_t stream_id)
+{
+    const Time deadline = Time::CurrentLocalTime() + RESPONSE_TIMEOUT;
+
+    for (;;) {
+        const Time now = Time::CurrentLocalTime();
+        if (now >= deadline || !_response_queue.dequeue(msg, deadline - now)) {
+            _report->error("ECMG response timeout");
+            return false;
+        }
+
+        // Channel messages apply to all streams.
+        const tlv::StreamMessage* const smsg = dynamic_cast<const tlv::StreamMessage*>(msg.pointer());
+        const bool same_stream = smsg == 0 || smsg->stream_id == stream_id;
+
+        if (msg->tag() == expected && same_stream) {
+            return true;
+        }
+        else if (msg->tag() == ecmgscs::Tags::channel_error || (msg->tag() == ecmgscs::Tags::stream_error && same_stream)) {
+            _report->error("ECMG error:\n" + msg->dump(4));
+            return false;
+        }
+        // Ignore other messages, most likely late responses to previous operations.
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Mark a control operation on a stream as pending.
+//----------------------------------------------------------------------------
+
+ts::ECMGMultiClient::ControlOperation::ControlOperation(ECMGMultiClient& client, uint16_t stream_id) :
+    _client(client)
+{
+    Guard lock(_client._mutex);
+    _client._control_pending = true;
+    _client._control_stream = stream_id;
+}
+
+ts::ECMGMultiClient::ControlOperation::~ControlOperation()
+{
+    Guard lock(_client._mutex);
+    _client._control_pending = false;
+}
+
+
+//----------------------------------------------------------------------------
+// Open an ECM stream in the channel.
+//----------------------------------------------------------------------------
+
+bool ts::ECMGMultiClient::openStream(uint16_t ecm_stream_id,
+                                     uint16_t ecm_id,
+                                     uint16_t nominal_cp_duration,
+                                     ecmgscs::StreamStatus& stream_status)
+{
+    Guard control(_control_mutex);
+
+    ecmgscs::StreamSetup stream_setup;
+    {
+        Guard lock(_mutex);
+        if (_state != CONNECTED) {
+            _report->error("ECMG client not connected");
+            return false;
+        }
+        if (_streams.find(ecm_stream_id) != _streams.end()) {
+            _report->error("ECM stream %d already open", int(ecm_stream_id));
+            return false;
+        }
+        stream_setup.channel_id = _channel_status.channel_id;
+    }
+
+    // Send a stream_setup message to ECMG
+    stream_setup.stream_id = ecm_stream_id;
+    stream_setup.ECM_id = ecm_id;
+    stream_setup.nominal_CP_duration = nominal_cp_duration;
+    ControlOperation operation(*this, ecm_stream_id);
+    if (!_connection.send(stream_setup, *_report)) {
+        return abortConnection("");
+    }
+
+    // Wait for a stream_status from the ECMG
+    tlv::MessagePtr msg;
+    if (!waitResponse(msg, ecmgscs::Tags::stream_status, ecm_stream_id)) {
+        return false;
+    }
+    ecmgscs::StreamStatus* const ssp = dynamic_cast<ecmgscs::StreamStatus*>(msg.pointer());
+    assert(ssp != 0);
+
+    // ECM stream now established
+    Guard lock(_mutex);
+    stream_status = _streams[ecm_stream_id].status = *ssp;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Close an ECM stream in the channel.
+//----------------------------------------------------------------------------
+
+bool ts::ECMGMultiClient::closeStream(uint16_t ecm_stream_id)
+{
+    Guard control(_control_mutex);
+
+    // Send pending requests first.
+    bool ok = flush();
+
+    ecmgscs::StreamCloseRequest req;
+    {
+        Guard lock(_mutex);
+        if (_state != CONNECTED || _streams.find(ecm_stream_id) == _streams.end()) {
+            _report->error("ECM stream %d not open", int(ecm_stream_id));
+            return false;
+        }
+        req.channel_id = _channel_status.channel_id;
+    }
+
+    // Send a stream_close_request and wait for a stream_close_response
+    req.stream_id = ecm_stream_id;
+    {
+        ControlOperation operation(*this, ecm_stream_id);
+        tlv::MessagePtr resp;
+        ok = ok && _connection.send(req, *_report) && waitResponse(resp, ecmgscs::Tags::stream_close_response, ecm_stream_id);
+    }
+
+    // Forget the stream, even on error. Its pending requests will never complete.
+    Guard lock(_mutex);
+    const StreamMap::iterator it = _streams.find(ecm_stream_id);
+    if (it != _streams.end()) {
+        abortRequests(it->second, ecm_stream_id);
+        _streams.erase(it);
+    }
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Disconnect from remote ECMG. Close all streams and channel.
+//----------------------------------------------------------------------------
+
+bool ts::ECMGMultiClient::disconnect()
+{
+    Guard control(_control_mutex);
+
+    // Send pending requests first.
+    flush();
+
+    // Mark disconnection in progress
+    State previous_state;
+    std::vector<uint16_t> streams;
+    {
+        Guard lock(_mutex);
+        previous_state = _state;
+        if (_state == CONNECTING || _state == CONNECTED) {
+            _state = DISCONNECTING;
+        }
+        for (StreamMap::const_iterator it = _streams.begin(); it != _streams.end(); ++it) {
+            streams.push_back(it->first);
+        }
+    }
+
+    // Disconnection sequence
+    bool ok = previous_state == CONNECTED;
+    if (ok) {
+        // Politely send a stream_close_request for each stream
+        // and wait for a stream_close_response
+        for (size_t i = 0; ok && i < streams.size(); ++i) {
+            ecmgscs::StreamCloseRequest req;
+            req.channel_id = _channel_status.channel_id;
+            req.stream_id = streams[i];
+            ControlOperation operation(*this, streams[i]);
+            tlv::MessagePtr resp;
+            ok = _connection.send(req, *_report) && waitResponse(resp, ecmgscs::Tags::stream_close_response, streams[i]);
+        }
+        // If we get polite replies, send a channel_close
+        if (ok) {
+            ecmgscs::ChannelClose cc;
+            cc.channel_id = _channel_status.channel_id;
+            ok = _connection.send(cc, *_report);
+        }
+    }
+
+    // TCP disconnection
+    GuardCondition lock(_mutex, _work_to_do);
+    if (previous_state == CONNECTING || previous_state == CONNECTED) {
+        _state = DISCONNECTED;
+        ok = _connection.disconnect(*_report) && ok;
+        ok = _connection.close(*_report) && ok;
+        lock.signal();
+    }
+    abortAllRequests();
+    _streams.clear();
+
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Submit an ECM request.
+//----------------------------------------------------------------------------
+
+bool ts::ECMGMultiClient::submitECM(uint16_t ecm_stream_id,
+                                    uint16_t cp_number,
+                                    const void* current_cw,
+                                    const void* next_cw,
+                                    const void* ac,
+                                    size_t ac_size,
+                                    uint16_t cp_duration,
+                                    bool flush)
+{
+    // Build a CW_provision message
+    ecmgscs::CWProvision msg;
+    msg.stream_id = ecm_stream_id;
+    msg.CP_number = cp_number;
+    msg.has_CW_encryption = false;
+    msg.CP_CW_combination.push_back(ecmgscs::CPCWCombination(cp_number, current_cw));
+    msg.CP_CW_combination.push_back(ecmgscs::CPCWCombination(cp_number + 1, next_cw));
+    msg.has_CP_duration = cp_duration != 0;
+    msg.CP_duration = cp_duration;
+    msg.has_access_criteria = ac != 0;
+    if (ac != 0) {
+        msg.access_criteria.copy(ac, ac_size);
+    }
+
+    // Register the request and serialize it with previous unsent requests.
+    {
+        Guard lock(_mutex);
+        if (_state != CONNECTED) {
+            _report->error("ECMG client not connected");
+            return false;
+        }
+        const StreamMap::iterator it = _streams.find(ecm_stream_id);
+        if (it == _streams.end()) {
+            _report->error("ECM stream %d not open", int(ecm_stream_id));
+            return false;
+        }
+        msg.channel_id = _channel_status.channel_id;
+        tlv::Serializer zer(_requests);
+        msg.serialize(zer);
+        it->second.pending.push_back(cp_number);
+        _pending_count++;
+    }
+
+    return !flush || this->flush();
+}
+
+
+//----------------------------------------------------------------------------
+// Send all submitted requests which were not yet sent to the ECMG.
+//----------------------------------------------------------------------------
+
+bool ts::ECMGMultiClient::flush()
+{
+    // The flush mutex ensures that requests are sent in submission order.
+    Guard flush_lock(_flush_mutex);
+
+    // Get the unsent requests. The two buffers are swapped, keeping their allocated size.
+    {
+        Guard lock(_mutex);
+        if (_requests->empty()) {
+            return true;
+        }
+        const ByteBlockPtr requests(_requests);
+        _requests = _sending;
+        _sending = requests;
+    }
+
+    // Send all requests in one operation, without holding the main mutex.
+    // The receiver thread must be able to process the responses in the meantime.
+    const bool ok = _connection.sendSerialized(_sending->data(), _sending->size(), *_report);
+    _sending->clear();
+    return ok || abortConnection("");
+}
+
+
+//----------------------------------------------------------------------------
+// Get the next completion of an ECM request.
+//----------------------------------------------------------------------------
+
+bool ts::ECMGMultiClient::getCompletion(CompletionPtr& completion, MilliSecond timeout)
+{
+    return _completions.dequeue(completion, timeout);
+}
+
+
+//----------------------------------------------------------------------------
+// Get the number of ECM requests which are not yet completed.
+//----------------------------------------------------------------------------
+
+size_t ts::ECMGMultiClient::pendingCount() const
+{
+    Guard lock(_mutex);
+    return _pending_count;
+}
+
+
+//----------------------------------------------------------------------------
+// Process an ECM_response or a stream_error for a pending request.
+//----------------------------------------------------------------------------
+
+bool ts::ECMGMultiClient::completeRequest(const ecmgscs::ECMResponse* response, const ecmgscs::StreamError* error)
+{
+    assert(response != 0 || error != 0);
+    const uint16_t stream_id = response != 0 ? response->stream_id : error->stream_id;
+    CompletionPtr completion;
+
+    {
+        Guard lock(_mutex);
+
+        const StreamMap::iterator it = _streams.find(stream_id);
+        if (it == _streams.end() || it->second.pending.empty()) {
+            return false;
+        }
+        std::deque<uint16_t>& pending(it->second.pending);
+
+        if (response != 0) {
+            // Locate the request. The ECMG normally responds in order, the request is the first one.
+            std::deque<uint16_t>::iterator req = std::find(pending.begin(), pending.end(), response->CP_number);
+            if (req == pending.end()) {
+                return false;
+            }
+            pending.erase(req);
+            completion = new Completion(stream_id, response->CP_number);
+            completion->success = true;
+            completion->ECM_datagram = response->ECM_datagram;
+        }
+        else {
+            // A stream_error does not contain the CP number. The ECMG processes
+            // the requests of a stream in order, the error applies to the oldest one.
+            // The caller has already excluded errors on control operations.
+            completion = new Completion(stream_id, pending.front());
+            completion->error_status = error->error_status.empty() ? 0 : error->error_status.front();
+            pending.pop_front();
+        }
+        assert(_pending_count > 0);
+        _pending_count--;
+    }
+
+    // Enqueue the completion without holding the mutex, the queue may be full.
+    // In that case, wait for the application to read completions, unless the
+    // object is being destroyed.
+    while (!_completions.enqueue(completion, COMPLETION_RETRY)) {
+        Guard lock(_mutex);
+        if (_state == DESTRUCTING) {
+            break;
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Check if a stream_error applies to a control operation instead of an ECM request.
+//----------------------------------------------------------------------------
+
+bool ts::ECMGMultiClient::isControlError(const ecmgscs::StreamError& error) const
+{
+    // The error_information may contain the message type or the parameter tag
+    // which caused the error. The stream message types do not overlap the
+    // parameter tags.
+    for (size_t i = 0; i < error.error_information.size(); ++i) {
+        switch (error.error_information[i]) {
+            case ecmgscs::Tags::CW_provision:
+            case ecmgscs::Tags::CP_number:
+            case ecmgscs::Tags::CP_duration:
+            case ecmgscs::Tags::CP_CW_combination:
+            case ecmgscs::Tags::access_criteria:
+            case ecmgscs::Tags::CW_encryption:
+                return false;
+            case ecmgscs::Tags::stream_setup:
+            case ecmgscs::Tags::stream_close_request:
+            case ecmgscs::Tags::stream_status:
+            case ecmgscs::Tags::ECM_id:
+            case ecmgscs::Tags::nominal_CP_duration:
+                return true;
+            default:
+                break;
+        }
+    }
+
+    // Unidentified operation: while a control operation is waiting for its
+    // response on the stream, the error is for it, not for an ECM request.
+    Guard lock(_mutex);
+    return _control_pending && _control_stream == error.stream_id;
+}
+
+
+//----------------------------------------------------------------------------
+// Complete all pending requests with an error. Must be called with mutex held.
+//----------------------------------------------------------------------------
+
+void ts::ECMGMultiClient::abortRequests(Stream& stream, uint16_t stream_id)
+{
+    while (!stream.pending.empty()) {
+        // Force the completion, the receiver thread is not there to block.
+        _completions.forceEnqueue(new Completion(stream_id, stream.pending.front()));
+        stream.pending.pop_front();
+        assert(_pending_count > 0);
+        _pending_count--;
+    }
+}
+
+void ts::ECMGMultiClient::abortAllRequests()
+{
+    for (StreamMap::iterator it = _streams.begin(); it != _streams.end(); ++it) {
+        abortRequests(it->second, it->first);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Receiver thread main code
+//----------------------------------------------------------------------------
+
+void ts::ECMGMultiClient::main()
+{
+    // Main loop
+    for (;;) {
+
+        const AbortInterface* abort = 0;
+        ReportInterface* report = 0;
+
+        // Wait for a connection to be managed
+        {
+            // Lock the mutex, get object state
+            GuardCondition lock(_mutex, _work_to_do);
+            while (_state == DISCONNECTED) {
+                // Release the mutex and wait for something to do.
+                // Automatically reacquire the mutex when condition is signaled.
+                lock.waitCondition();
+            }
+            // Mutex still held, check if thread must terminate
+            if (_state == DESTRUCTING) {
+                return;
+            }
+            // Get abort and report handler
+            abort = _abort;
+            report = _report;
+            // Automatically release mutex
+        }
+
+        // Loop on message reception
+        tlv::MessagePtr msg;
+        bool ok = true;
+        while (ok && _connection.receive(msg, abort, *report)) {
+            switch (msg->tag()) {
+                case ecmgscs::Tags::channel_test: {
+                    // Automatic reply to channel_test
+                    ok = _connection.send(_channel_status, *report);
+                    break;
+                }
+                case ecmgscs::Tags::stream_test: {
+                    // Automatic reply to stream_test
+                    ecmgscs::StreamTest* const test = dynamic_cast<ecmgscs::StreamTest*>(msg.pointer());
+                    assert(test != 0);
+                    ecmgscs::StreamStatus status;
+                    bool found = false;
+                    {
+                        Guard lock(_mutex);
+                        const StreamMap::const_iterator it = _streams.find(test->stream_id);
+                        if ((found = it != _streams.end())) {
+                            status = it->second.status;
+                        }
+                    }
+                    if (found) {
+                        ok = _connection.send(status, *report);
+                    }
+                    else {
+                        ecmgscs::StreamError error;
+                        error.channel_id = test->channel_id;
+                        error.stream_id = test->stream_id;
+                        error.error_status.push_back(ecmgscs::Errors::inv_stream_id);
+                        ok = _connection.send(error, *report);
+                    }
+                    break;
+                }
+                case ecmgscs::Tags::ECM_response: {
+                    // Complete a pending request, ignore unexpected responses.
+                    if (!completeRequest(dynamic_cast<ecmgscs::ECMResponse*>(msg.pointer()), 0)) {
+                        report->debug("ignored unexpected ECM_response:\n" + msg->dump(4));
+                    }
+                    break;
+                }
+                case ecmgscs::Tags::stream_error: {
+                    // Error on a pending request or on a control operation.
+                    const ecmgscs::StreamError* const error = dynamic_cast<ecmgscs::StreamError*>(msg.pointer());
+                    assert(error != 0);
+                    if (isControlError(*error) || !completeRequest(0, error)) {
+                        _response_queue.enqueue(msg, 0);
+                    }
+                    break;
+                }
+                default: {
+                    // Enqueue the message for application thread.
+                    // Do not wait if the queue is full: nobody is waiting for
+                    // unsolicited messages and the ECM responses must go on.
+                    _response_queue.enqueue(msg, 0);
+                    break;
+                }
+            }
+        }
+
+        // Error while receiving messages, most likely a disconnection.
+        // All pending requests will never complete.
+        {
+            Guard lock(_mutex);
+            abortAllRequests();
+            if (_state == DESTRUCTING) {
+                return;
+            }
+            if (_state != DISCONNECTED) {
+                _state = DISCONNECTED;
+                _connection.disconnect(NULLREP);
+                _connection.close(NULLREP);
+            }
+        }
+    }
+}
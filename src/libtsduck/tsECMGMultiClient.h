@@ -0,0 +1,292 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Multiplexed ECM generator client.
+//!
+//!  Use ECMG <=> SCS protocol to request ECM's for several ECM streams
+//!  over one channel. An ECMGMultiClient object acts as an SCS.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsECMGSCS.h"
+#include "tstlvConnection.h"
+#include "tsMessageQueue.h"
+#include "tsCondition.h"
+#include "tsMutex.h"
+#include "tsThread.h"
+
+namespace ts {
+    //!
+    //! A multiplexed DVB-ECMG client which acts as a DVB-SCS.
+    //!
+    //! Unlike ECMGClient, which uses one TCP connection, one channel and one stream,
+    //! an ECMGMultiClient carries many ECM streams over one channel and one TCP connection.
+    //!
+    //! ECM requests (CW_provision) are pipelined: they are sent without waiting for the
+    //! ECM_response of the previous requests. Several requests can be grouped and sent
+    //! in one operation. The ECM responses and errors are delivered through a completion
+    //! queue which is read by the application using getCompletion().
+    //!
+    //! Restriction: The target ECMG shall support only current/next control words in ECM,
+    //! meaning CW_per_msg = 2 and lead_CW = 1.
+    //! @see DVB standard ETSI TS 103.197 V1.4.1 for ECMG <=> SCS protocol.
+    //!
+    class TSDUCKDLL ECMGMultiClient: private Thread
+    {
+    public:
+        //!
+        //! Completion of an ECM request.
+        //!
+        struct TSDUCKDLL Completion
+        {
+            uint16_t  stream_id;     //!< ECM_stream_id of the request.
+            uint16_t  cp_number;     //!< CP_number of the request.
+            bool      success;       //!< True if the ECM was generated, false on error.
+            uint16_t  error_status;  //!< Error status from stream_error, zero on disconnection.
+            ByteBlock ECM_datagram;  //!< ECM packets or section, when successful.
+
+            //!
+            //! Constructor.
+            //! @param [in] stream ECM_stream_id of the request.
+            //! @param [in] cp CP_number of the request.
+            //!
+            Completion(uint16_t stream = 0, uint16_t cp = 0) :
+                stream_id(stream),
+                cp_number(cp),
+                success(false),
+                error_status(0),
+                ECM_datagram()
+            {
+            }
+        };
+
+        //!
+        //! Safe pointer to a Completion (thread-safe).
+        //!
+        typedef SafePtr<Completion, Mutex> CompletionPtr;
+
+        //!
+        //! Constructor.
+        //! @param [in] max_completions Maximum number of completions in the completion queue.
+        //! When the queue is full, the reception of ECMG responses is suspended until the
+        //! application reads completions. Zero means unlimited.
+        //!
+        ECMGMultiClient(size_t max_completions = 0);
+
+        //!
+        //! Destructor.
+        //!
+        ~ECMGMultiClient();
+
+        //!
+        //! Connect to a remote ECMG and open the ECM channel.
+        //! @param [in] ecmg IP address and TCP port of the ECMG.
+        //! @param [in] super_cas_id Super_CAS_id, see ECMG <=> SCS protocol.
+        //! @param [in] ecm_channel_id ECM_channel_id, see ECMG <=> SCS protocol.
+        //! @param [out] channel_status Initial response to channel_setup
+        //! @param [in] abort An interface to check if the application is interrupted.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool connect(const SocketAddress& ecmg,
+                     uint32_t super_cas_id,
+                     uint16_t ecm_channel_id,
+                     ecmgscs::ChannelStatus& channel_status,
+                     const AbortInterface* abort,
+                     ReportInterface* report);
+
+        //!
+        //! Open an ECM stream in the channel.
+        //! @param [in] ecm_stream_id ECM_stream_id, see ECMG <=> SCS protocol.
+        //! @param [in] ecm_id ECM_id, see ECMG <=> SCS protocol.
+        //! @param [in] nominal_cp_duration Nominal crypto-period in 100 ms units.
+        //! @param [out] stream_status Response to stream_setup
+        //! @return True on success, false on error.
+        //!
+        bool openStream(uint16_t ecm_stream_id,
+                        uint16_t ecm_id,
+                        uint16_t nominal_cp_duration,
+                        ecmgscs::StreamStatus& stream_status);
+
+        //!
+        //! Close an ECM stream in the channel.
+        //! Pending ECM requests on this stream are completed with an error.
+        //! @param [in] ecm_stream_id ECM_stream_id of the stream to close.
+        //! @return True on success, false on error.
+        //!
+        bool closeStream(uint16_t ecm_stream_id);
+
+        //!
+        //! Submit an ECM request.
+        //! Return immediately. The ECM is later returned through the completion queue.
+        //! @param [in] ecm_stream_id ECM_stream_id of an open stream.
+        //! @param [in] cp_number Current crypto-period number.
+        //! @param [in] current_cw 8-byte control word for current crypto-period.
+        //! @param [in] next_cw 8-byte control word for next crypto-period.
+        //! @param [in] ac Access criteria, unspecified if zero.
+        //! @param [in] ac_size Access criteria size in bytes.
+        //! @param [in] cp_duration Crypto-period in 100 ms units, unspecified if zero.
+        //! @param [in] flush If true, the request and all previously submitted requests
+        //! are immediately sent to the ECMG. If false, the request is kept until the next
+        //! call to flush() or to submitECM() with @a flush set to true. This is useful to
+        //! group the requests for many streams at the beginning of crypto-periods.
+        //! @return True on success, false on error.
+        //!
+        bool submitECM(uint16_t ecm_stream_id,
+                       uint16_t cp_number,
+                       const void* current_cw,
+                       const void* next_cw,
+                       const void* ac,
+                       size_t ac_size,
+                       uint16_t cp_duration,
+                       bool flush = true);
+
+        //!
+        //! Send all submitted requests which were not yet sent to the ECMG.
+        //! @return True on success, false on error.
+        //!
+        bool flush();
+
+        //!
+        //! Get the next completion of an ECM request.
+        //! @param [out] completion Returned completion.
+        //! @param [in] timeout Maximum time to wait in milliseconds.
+        //! @return True on success, false on timeout.
+        //!
+        bool getCompletion(CompletionPtr& completion, MilliSecond timeout = Infinite);
+
+        //!
+        //! Get the number of ECM requests which are not yet completed.
+        //! @return The number of ECM requests which are not yet completed.
+        //!
+        size_t pendingCount() const;
+
+        //!
+        //! Disconnect from remote ECMG.
+        //! Close all streams and channel.
+        //! @return True on success, false on error.
+        //!
+        bool disconnect();
+
+        //!
+        //! Check if the ECMG is connected.
+        //! @return True if the ECMG is connected.
+        //!
+        bool isConnected() const {return _state == CONNECTED;}
+
+    private:
+        // State of the client connection
+        enum State {
+            INITIAL,         // initial state, receiver thread not started
+            DISCONNECTED,    // no TCP connection
+            CONNECTING,      // opening channel
+            CONNECTED,       // channel established
+            DISCONNECTING,   // closing streams and channel
+            DESTRUCTING,     // object destruction in progress
+        };
+
+        // Stack size for execution of the receiver thread
+        static const size_t RECEIVER_STACK_SIZE = 128 * 1024;
+
+        // Maximum number of messages in response queue
+        static const size_t RESPONSE_QUEUE_SIZE = 10;
+
+        // Timeout for responses from ECMG (except ECM generation)
+        static const MilliSecond RESPONSE_TIMEOUT = 5000;
+
+        // Retry interval when the completion queue is full
+        static const MilliSecond COMPLETION_RETRY = 100;
+
+        // Description of an open stream.
+        struct Stream
+        {
+            ecmgscs::StreamStatus status;   // response to stream_setup
+            std::deque<uint16_t>  pending;  // CP numbers of pending ECM requests, in submission order
+            Stream() : status(), pending() {}
+        };
+        typedef std::map<uint16_t, Stream> StreamMap;
+
+        // Private members
+        State                   _state;
+        const AbortInterface*   _abort;
+        ReportInterface*        _report;
+        tlv::Connection <Mutex> _connection;      // connection with ECMG server
+        ecmgscs::ChannelStatus  _channel_status;  // initial response to channel_setup
+        mutable Mutex           _mutex;           // exclusive access to protected fields
+        Condition               _work_to_do;      // notify receiver thread to do some work
+        Mutex                   _control_mutex;   // serialize control operations (stream setup, close)
+        Mutex                   _flush_mutex;     // keep order of sent requests
+        StreamMap               _streams;         // open streams, protected by _mutex
+        size_t                  _pending_count;   // total number of pending requests, protected by _mutex
+        bool                    _control_pending; // a control operation is waiting for its response, protected by _mutex
+        uint16_t                _control_stream;  // stream of the pending control operation, protected by _mutex
+        ByteBlockPtr            _requests;        // serialized requests not yet sent, protected by _mutex
+        ByteBlockPtr            _sending;         // serialized requests being sent, protected by _flush_mutex
+        MessageQueue <tlv::Message, NullMutex> _response_queue;
+        MessageQueue <Completion, Mutex>       _completions;
+
+        // Receiver thread main code
+        virtual void main();
+
+        // Mark a control operation on a stream as pending during the lifetime of the object.
+        class ControlOperation
+        {
+        public:
+            ControlOperation(ECMGMultiClient& client, uint16_t stream_id);
+            ~ControlOperation();
+        private:
+            ECMGMultiClient& _client;
+            ControlOperation(const ControlOperation&) = delete;
+            ControlOperation& operator=(const ControlOperation&) = delete;
+        };
+
+        // Process an ECM_response or a stream_error for a pending request.
+        // Return false if the message does not match a pending request.
+        bool completeRequest(const ecmgscs::ECMResponse* response, const ecmgscs::StreamError* error);
+
+        // Check if a stream_error applies to a control operation instead of an ECM request.
+        bool isControlError(const ecmgscs::StreamError& error) const;
+
+        // Complete all pending requests with an error, on one stream or all.
+        void abortRequests(Stream& stream, uint16_t stream_id);
+        void abortAllRequests();
+
+        // Wait for a response to a control operation.
+        bool waitResponse(tlv::MessagePtr& msg, tlv::TAG expected, uint16_t stream_id);
+
+        // Report specified error message if not empty, abort connection and return false
+        bool abortConnection(const std::string&);
+
+        // Unreachable operations
+        ECMGMultiClient(const ECMGMultiClient&) = delete;
+        ECMGMultiClient& operator=(const ECMGMultiClient&) = delete;
+    };
+}
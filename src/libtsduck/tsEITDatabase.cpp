@@ -0,0 +1,301 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Incremental database of EIT events
+//
+//----------------------------------------------------------------------------
+
+#include "tsEITDatabase.h"
+#include "tsMJD.h"
+#include "tsBCD.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::EITDatabase::EITDatabase() :
+    _services(),
+    _changed()
+{
+}
+
+ts::EITDatabase::~EITDatabase()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Clear the content of the database.
+//----------------------------------------------------------------------------
+
+void ts::EITDatabase::clear()
+{
+    _services.clear();
+    _changed.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Get and reset the list of changed segments.
+//----------------------------------------------------------------------------
+
+void ts::EITDatabase::takeChangedSegments(SegmentSet& segments)
+{
+    segments.clear();
+    segments.swap(_changed);
+}
+
+
+//----------------------------------------------------------------------------
+// Parse an event at the beginning of an EIT section payload area.
+//----------------------------------------------------------------------------
+
+size_t ts::EITDatabase::ParseEvent(Event& event, const uint8_t* data, size_t size, uint16_t slot)
+{
+    if (size < 12) {
+        return 0;
+    }
+
+    // Same leniency as EIT deserialization: truncate descriptor loop to available data.
+    const size_t event_size = std::min<size_t>(12 + (GetUInt16(data + 10) & 0x0FFF), size);
+
+    DecodeMJD(data + 2, 5, event._start);
+    const Second duration = (DecodeBCD(data[7]) * 3600) + (DecodeBCD(data[8]) * 60) + DecodeBCD(data[9]);
+    event._end = event._start + duration * MilliSecPerSec;
+    event._data = data;
+    event._size = event_size;
+    event._slot = slot;
+    return event_size;
+}
+
+
+//----------------------------------------------------------------------------
+// Remove a section slot and its events from a service.
+//----------------------------------------------------------------------------
+
+void ts::EITDatabase::removeSlot(const ServiceKey& key, ServiceContext& srv, SectionMap::iterator it)
+{
+    const uint16_t slot = it->first;
+    EventVector& events(srv.events);
+
+    // Remove all events from this slot, preserving the order of the others.
+    size_t next = 0;
+    for (size_t i = 0; i < events.size(); ++i) {
+        if (events[i]._slot != slot) {
+            if (next != i) {
+                events[next] = events[i];
+            }
+            next++;
+        }
+    }
+    events.resize(next);
+
+    _changed.insert(Segment(key, TID(slot >> 8), uint8_t((slot & 0xFF) / 8)));
+    srv.sections.erase(it);
+}
+
+
+//----------------------------------------------------------------------------
+// Add an EIT section in the database.
+//----------------------------------------------------------------------------
+
+bool ts::EITDatabase::addSection(const Section& section)
+{
+    const TID tid = section.tableId();
+    if (!section.isValid() || !section.isLongSection() || tid < TID_EIT_MIN || tid > TID_EIT_MAX || section.payloadSize() < 6) {
+        return false;
+    }
+
+    const uint8_t* const payload = section.payload();
+    const ServiceKey key(GetUInt16(payload + 2), GetUInt16(payload), section.tableIdExtension());
+    const uint8_t version = section.version();
+    const uint16_t slot = uint16_t(tid << 8) | section.sectionNumber();
+
+    ServiceContext& srv(_services[key]);
+
+    // Fast path: the section is a repetition of a previous one.
+    SectionMap::iterator it = srv.sections.find(slot);
+    if (it != srv.sections.end() &&
+        it->second->version() == version &&
+        it->second->size() == section.size() &&
+        ::memcmp(it->second->content() + it->second->size() - 4, section.content() + section.size() - 4, 4) == 0)
+    {
+        return false;
+    }
+
+    // Remove sections of the same sub-table with another version or beyond the last section.
+    const uint16_t last_slot = uint16_t(tid << 8) | section.lastSectionNumber();
+    it = srv.sections.lower_bound(uint16_t(tid << 8));
+    while (it != srv.sections.end() && (it->first >> 8) == tid) {
+        SectionMap::iterator current(it++);
+        if (current->first == slot || current->first > last_slot || current->second->version() != version) {
+            removeSlot(key, srv, current);
+        }
+    }
+
+    // Store the new section. Share the section data, do not copy them.
+    const SectionPtr sp(new Section(section, SHARE));
+    srv.sections[slot] = sp;
+    _changed.insert(Segment(key, tid, uint8_t(section.sectionNumber() / 8)));
+
+    // Index the events from EIT schedule. Events from EIT p/f are looked up on demand.
+    if (tid >= TID_EIT_S_ACT_MIN) {
+        const size_t first = srv.events.size();
+        const uint8_t* data = sp->payload() + 6;
+        size_t remain = sp->payloadSize() - 6;
+        Event event;
+        size_t size = 0;
+        while ((size = ParseEvent(event, data, remain, slot)) > 0) {
+            srv.events.push_back(event);
+            data += size;
+            remain -= size;
+        }
+        // Events are normally sorted in a section. Merge them with the existing ones.
+        EventVector::iterator middle(srv.events.begin() + first);
+        if (!std::is_sorted(middle, srv.events.end(), EventLess)) {
+            std::stable_sort(middle, srv.events.end(), EventLess);
+        }
+        std::inplace_merge(srv.events.begin(), middle, srv.events.end(), EventLess);
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the list of services in the database.
+//----------------------------------------------------------------------------
+
+void ts::EITDatabase::getServices(std::vector<ServiceKey>& services) const
+{
+    services.clear();
+    services.reserve(_services.size());
+    for (ServiceMap::const_iterator it = _services.begin(); it != _services.end(); ++it) {
+        services.push_back(it->first);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get the number of events in the EIT schedule of a service.
+//----------------------------------------------------------------------------
+
+size_t ts::EITDatabase::eventCount(const ServiceKey& service) const
+{
+    const ServiceMap::const_iterator srv(_services.find(service));
+    return srv == _services.end() ? 0 : srv->second.events.size();
+}
+
+
+//----------------------------------------------------------------------------
+// Get the present and following events at a given time.
+//----------------------------------------------------------------------------
+
+bool ts::EITDatabase::getPresentFollowing(const ServiceKey& service, const Time& now, Event& present, Event& following) const
+{
+    present = following = Event();
+
+    const ServiceMap::const_iterator srv(_services.find(service));
+    if (srv == _services.end()) {
+        return false;
+    }
+    const EventVector& events(srv->second.events);
+
+    // Locate the first event starting after now.
+    Event ref;
+    ref._start = now;
+    const EventVector::const_iterator next(std::upper_bound(events.begin(), events.end(), ref, EventLess));
+
+    if (next != events.end()) {
+        following = *next;
+    }
+    if (next != events.begin() && (next - 1)->_end > now) {
+        present = *(next - 1);
+    }
+    return present.isValid();
+}
+
+
+//----------------------------------------------------------------------------
+// Get the present and following events as signalled in the EIT p/f.
+//----------------------------------------------------------------------------
+
+bool ts::EITDatabase::getSignalledPresentFollowing(const ServiceKey& service, Event& present, Event& following) const
+{
+    present = following = Event();
+
+    const ServiceMap::const_iterator srv(_services.find(service));
+    if (srv == _services.end()) {
+        return false;
+    }
+    const SectionMap& sections(srv->second.sections);
+
+    // A service is either in EIT p/f actual or other, look for both.
+    for (TID tid = TID_EIT_PF_ACT; tid <= TID_EIT_PF_OTH; ++tid) {
+        for (uint8_t num = 0; num < 2; ++num) {
+            const uint16_t slot = uint16_t(tid << 8) | num;
+            const SectionMap::const_iterator it(sections.find(slot));
+            if (it != sections.end()) {
+                ParseEvent(num == 0 ? present : following, it->second->payload() + 6, it->second->payloadSize() - 6, slot);
+            }
+        }
+    }
+    return present.isValid();
+}
+
+
+//----------------------------------------------------------------------------
+// Get the events in a time range.
+//----------------------------------------------------------------------------
+
+size_t ts::EITDatabase::getEvents(const ServiceKey& service, const Time& start, const Time& end, EventVector& events) const
+{
+    events.clear();
+
+    const ServiceMap::const_iterator srv(_services.find(service));
+    if (srv == _services.end() || !(start < end)) {
+        return 0;
+    }
+    const EventVector& all(srv->second.events);
+
+    // Locate the first event starting at or after the start time.
+    // Since events do not overlap, only the previous one may overlap the start time.
+    Event ref;
+    ref._start = start;
+    EventVector::const_iterator it(std::lower_bound(all.begin(), all.end(), ref, EventLess));
+    if (it != all.begin() && (it - 1)->_end > start) {
+        --it;
+    }
+    while (it != all.end() && it->_start < end) {
+        events.push_back(*it);
+        ++it;
+    }
+    return events.size();
+}
@@ -0,0 +1,350 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Incremental database of EIT events
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsSection.h"
+#include "tsTablesPtr.h"
+#include "tsDescriptorLoopView.h"
+#include "tsTime.h"
+
+namespace ts {
+    //!
+    //! Incremental database of EIT events.
+    //!
+    //! EIT sections are added one by one, typically from a SectionDemux section
+    //! handler. Since EIT's are continuously repeated, most received sections are
+    //! identical to a previous one. Such sections are detected using their version
+    //! and CRC32 and ignored at minimal cost. Only new or modified sections are
+    //! analyzed and the corresponding EIT segments are recorded as changed.
+    //!
+    //! For each service, the events from the EIT schedule are kept in a
+    //! time-sorted array, allowing fast "present/following" and "time range"
+    //! queries using binary searches. The events are not deserialized: they
+    //! reference the section data which are shared with the database. DVB
+    //! requires that events do not overlap in a service; this is assumed by the
+    //! time range queries.
+    //!
+    //! This class is not thread-safe.
+    //!
+    class TSDUCKDLL EITDatabase
+    {
+    public:
+        //!
+        //! Identification of a service (DVB triplet).
+        //!
+        struct TSDUCKDLL ServiceKey
+        {
+            // Public members:
+            uint16_t original_network_id;  //!< Original network id.
+            uint16_t transport_stream_id;  //!< Transport stream id.
+            uint16_t service_id;           //!< Service id.
+
+            //!
+            //! Constructor.
+            //! @param [in] onid Original network id.
+            //! @param [in] tsid Transport stream id.
+            //! @param [in] sid Service id.
+            //!
+            ServiceKey(uint16_t onid = 0, uint16_t tsid = 0, uint16_t sid = 0) :
+                original_network_id(onid),
+                transport_stream_id(tsid),
+                service_id(sid)
+            {
+            }
+
+            //!
+            //! Get a "normalized" 64-bit identifier, usable as sort key.
+            //! @return The "normalized" 64-bit identifier of the service.
+            //!
+            uint64_t normalized() const
+            {
+                return (uint64_t(original_network_id) << 32) | (uint64_t(transport_stream_id) << 16) | uint64_t(service_id);
+            }
+
+            //!
+            //! Comparison operator.
+            //! @param [in] other Another instance to compare.
+            //! @return True if this object == @a other.
+            //!
+            bool operator==(const ServiceKey& other) const {return normalized() == other.normalized();}
+
+            //!
+            //! Comparison operator.
+            //! @param [in] other Another instance to compare.
+            //! @return True if this object != @a other.
+            //!
+            bool operator!=(const ServiceKey& other) const {return normalized() != other.normalized();}
+
+            //!
+            //! Comparison operator.
+            //! @param [in] other Another instance to compare.
+            //! @return True if this object < @a other.
+            //!
+            bool operator<(const ServiceKey& other) const {return normalized() < other.normalized();}
+        };
+
+        //!
+        //! Identification of an EIT segment, a group of 8 sections in a sub-table.
+        //!
+        struct TSDUCKDLL Segment
+        {
+            // Public members:
+            ServiceKey service;   //!< Service.
+            TID        table_id;  //!< EIT table id.
+            uint8_t    segment;   //!< Segment index in the sub-table (section number / 8).
+
+            //!
+            //! Constructor.
+            //! @param [in] srv Service.
+            //! @param [in] tid EIT table id.
+            //! @param [in] seg Segment index in the sub-table.
+            //!
+            Segment(const ServiceKey& srv = ServiceKey(), TID tid = 0, uint8_t seg = 0) :
+                service(srv),
+                table_id(tid),
+                segment(seg)
+            {
+            }
+
+            //!
+            //! Comparison operator.
+            //! @param [in] other Another instance to compare.
+            //! @return True if this object == @a other.
+            //!
+            bool operator==(const Segment& other) const
+            {
+                return service == other.service && table_id == other.table_id && segment == other.segment;
+            }
+
+            //!
+            //! Comparison operator.
+            //! @param [in] other Another instance to compare.
+            //! @return True if this object < @a other.
+            //!
+            bool operator<(const Segment& other) const
+            {
+                return service < other.service || (service == other.service && (table_id < other.table_id || (table_id == other.table_id && segment < other.segment)));
+            }
+        };
+
+        //!
+        //! A set of segments.
+        //!
+        typedef std::set<Segment> SegmentSet;
+
+        //!
+        //! Description of one event in the database.
+        //! The event references section data from the database. It remains valid as
+        //! long as the section which contains the event is not replaced or removed.
+        //!
+        class TSDUCKDLL Event
+        {
+        public:
+            //!
+            //! Default constructor, an invalid event.
+            //!
+            Event() : _start(), _end(), _data(0), _size(0), _slot(0) {}
+
+            //!
+            //! Check if the event is valid.
+            //! @return True if the event is valid.
+            //!
+            bool isValid() const {return _data != 0;}
+
+            //!
+            //! Get the event id.
+            //! @return The event id.
+            //!
+            uint16_t eventId() const {return _data == 0 ? 0 : GetUInt16(_data);}
+
+            //!
+            //! Get the event start time.
+            //! @return The event start time (UTC).
+            //!
+            const Time& startTime() const {return _start;}
+
+            //!
+            //! Get the event end time.
+            //! @return The event end time (UTC).
+            //!
+            const Time& endTime() const {return _end;}
+
+            //!
+            //! Get the event duration.
+            //! @return The event duration in seconds.
+            //!
+            Second duration() const {return (_end - _start) / MilliSecPerSec;}
+
+            //!
+            //! Get the running status.
+            //! @return The running status code.
+            //!
+            uint8_t runningStatus() const {return _data == 0 ? 0 : (_data[10] >> 5) & 0x07;}
+
+            //!
+            //! Check if the event is controlled by a CA_system.
+            //! @return True if the event is controlled by a CA_system.
+            //!
+            bool CAControlled() const {return _data != 0 && (_data[10] & 0x10) != 0;}
+
+            //!
+            //! Get the descriptor loop of the event.
+            //! @return A view of the descriptor loop.
+            //!
+            DescriptorLoopView descriptors() const {return _data == 0 ? DescriptorLoopView() : DescriptorLoopView(_data + 12, _size - 12);}
+
+        private:
+            friend class EITDatabase;
+            Time           _start;  // Start time.
+            Time           _end;    // End time.
+            const uint8_t* _data;   // Event description in section.
+            size_t         _size;   // Size of event description, including descriptors.
+            uint16_t       _slot;   // Section slot containing the event.
+        };
+
+        //!
+        //! A vector of events.
+        //!
+        typedef std::vector<Event> EventVector;
+
+        //!
+        //! Constructor.
+        //!
+        EITDatabase();
+
+        //!
+        //! Destructor.
+        //!
+        virtual ~EITDatabase();
+
+        //!
+        //! Clear the content of the database.
+        //!
+        void clear();
+
+        //!
+        //! Add an EIT section in the database.
+        //! Non-EIT sections are ignored.
+        //! @param [in] section The section to add. The section data are shared, not copied.
+        //! The section shall not be modified later.
+        //! @return True if the database was modified, false if the section is a repetition
+        //! of a previous one or is invalid.
+        //!
+        bool addSection(const Section& section);
+
+        //!
+        //! Get and reset the list of segments which changed since the last call.
+        //! @param [out] segments Receives the list of changed segments.
+        //!
+        void takeChangedSegments(SegmentSet& segments);
+
+        //!
+        //! Get the number of services in the database.
+        //! @return The number of services in the database.
+        //!
+        size_t serviceCount() const {return _services.size();}
+
+        //!
+        //! Get the list of services in the database.
+        //! @param [out] services Receives the list of services.
+        //!
+        void getServices(std::vector<ServiceKey>& services) const;
+
+        //!
+        //! Get the number of events in the EIT schedule of a service.
+        //! @param [in] service The service.
+        //! @return The number of events in the EIT schedule of the service.
+        //!
+        size_t eventCount(const ServiceKey& service) const;
+
+        //!
+        //! Get the present and following events at a given time, from the EIT schedule.
+        //! @param [in] service The service.
+        //! @param [in] now The reference time (UTC).
+        //! @param [out] present Receives the event at @a now. Invalid if there is none.
+        //! @param [out] following Receives the first event after @a now. Invalid if there is none.
+        //! @return True if a present event was found.
+        //!
+        bool getPresentFollowing(const ServiceKey& service, const Time& now, Event& present, Event& following) const;
+
+        //!
+        //! Get the present and following events as signalled in the EIT present/following.
+        //! @param [in] service The service.
+        //! @param [out] present Receives the present event. Invalid if there is none.
+        //! @param [out] following Receives the following event. Invalid if there is none.
+        //! @return True if a present event was found.
+        //!
+        bool getSignalledPresentFollowing(const ServiceKey& service, Event& present, Event& following) const;
+
+        //!
+        //! Get the events from the EIT schedule in a time range.
+        //! @param [in] service The service.
+        //! @param [in] start Start of the time range (UTC).
+        //! @param [in] end End of the time range (UTC), excluded.
+        //! @param [out] events Receives the events which overlap the time range, sorted by start time.
+        //! @return The number of events in @a events.
+        //!
+        size_t getEvents(const ServiceKey& service, const Time& start, const Time& end, EventVector& events) const;
+
+    private:
+        // Sections are stored in "slots", the key of which is table_id << 8 | section_number.
+        typedef std::map<uint16_t, SectionPtr> SectionMap;
+
+        // Description of one service.
+        struct ServiceContext
+        {
+            SectionMap  sections;  // All sections, EIT p/f and schedule.
+            EventVector events;    // Events from EIT schedule, sorted by start time.
+            ServiceContext() : sections(), events() {}
+        };
+        typedef std::map<ServiceKey, ServiceContext> ServiceMap;
+
+        ServiceMap _services;  // All services.
+        SegmentSet _changed;   // Segments which changed since last call to takeChangedSegments().
+
+        // Remove a section slot and its events from a service.
+        void removeSlot(const ServiceKey& key, ServiceContext& srv, SectionMap::iterator it);
+
+        // Parse an event at the beginning of an EIT section payload area.
+        // Return the size of the event description or zero on error.
+        static size_t ParseEvent(Event& event, const uint8_t* data, size_t size, uint16_t slot);
+
+        // Comparison of events, by start time.
+        static bool EventLess(const Event& e1, const Event& e2) {return e1._start < e2._start;}
+
+        // Inaccessible operations.
+        EITDatabase(const EITDatabase&) = delete;
+        EITDatabase& operator=(const EITDatabase&) = delete;
+    };
+}
@@ -0,0 +1,101 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Read-only view of an Event Information Table (EIT)
+//
+//----------------------------------------------------------------------------
+
+#include "tsEITView.h"
+#include "tsMJD.h"
+#include "tsBCD.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::EITView::EITView(const BinaryTable& table) :
+    AbstractTableView(table, 12, 10)
+{
+    validate(table.tableId() >= TID_EIT_MIN && table.tableId() <= TID_EIT_MAX);
+}
+
+
+//----------------------------------------------------------------------------
+// Locate the list of entries in a section.
+//----------------------------------------------------------------------------
+
+bool ts::EITView::locateEntries(const Section& section, const uint8_t*& data, size_t& size) const
+{
+    // Skip transport_stream_id, original_network_id, segment_last_section_number, last_table_id.
+    data = section.payload() + 6;
+    size = section.payloadSize();
+    if (size < 6) {
+        return false;
+    }
+    size -= 6;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Access to the fixed part.
+//----------------------------------------------------------------------------
+
+uint16_t ts::EITView::tsId() const
+{
+    size_t size = 0;
+    const uint8_t* data = firstPayload(size);
+    return data == 0 ? 0 : GetUInt16(data);
+}
+
+uint16_t ts::EITView::originalNetworkId() const
+{
+    size_t size = 0;
+    const uint8_t* data = firstPayload(size);
+    return data == 0 ? 0 : GetUInt16(data + 2);
+}
+
+
+//----------------------------------------------------------------------------
+// Event start time and duration.
+//----------------------------------------------------------------------------
+
+ts::Time ts::EITView::Event::startTime() const
+{
+    Time start;
+    DecodeMJD(_data + 2, 5, start);
+    return start;
+}
+
+ts::Second ts::EITView::Event::duration() const
+{
+    return (DecodeBCD(_data[7]) * 3600) + (DecodeBCD(_data[8]) * 60) + DecodeBCD(_data[9]);
+}
@@ -0,0 +1,159 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only view of an Event Information Table (EIT)
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsAbstractTableView.h"
+#include "tsDescriptorLoopView.h"
+#include "tsTime.h"
+
+namespace ts {
+    //!
+    //! Read-only view of an Event Information Table (EIT).
+    //! @see AbstractTableView, EIT
+    //!
+    class TSDUCKDLL EITView : public AbstractTableView
+    {
+    public:
+        //!
+        //! One event in the EIT.
+        //!
+        class TSDUCKDLL Event
+        {
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] data Address of the entry.
+            //! @param [in] size Size in bytes of the entry, including the descriptor loop.
+            //!
+            Event(const uint8_t* data, size_t size) : _data(data), _size(size) {}
+
+            //!
+            //! Get the event id.
+            //! @return The event id.
+            //!
+            uint16_t eventId() const {return GetUInt16(_data);}
+
+            //!
+            //! Get the event start time.
+            //! @return The event start time.
+            //!
+            Time startTime() const;
+
+            //!
+            //! Get the event duration.
+            //! @return The event duration in seconds.
+            //!
+            Second duration() const;
+
+            //!
+            //! Get the running status.
+            //! @return The running status code.
+            //!
+            uint8_t runningStatus() const {return (_data[10] >> 5) & 0x07;}
+
+            //!
+            //! Check if the event is controlled by a CA_system.
+            //! @return True if the event is controlled by a CA_system.
+            //!
+            bool CAControlled() const {return (_data[10] & 0x10) != 0;}
+
+            //!
+            //! Get the descriptor loop of the event.
+            //! @return A view of the descriptor loop.
+            //!
+            DescriptorLoopView descriptors() const {return DescriptorLoopView(_data + 12, _size - 12);}
+
+        private:
+            const uint8_t* _data;
+            size_t         _size;
+        };
+
+        //!
+        //! Iterator over the events of the EIT.
+        //!
+        typedef EntryIterator<Event> const_iterator;
+
+        //!
+        //! Constructor.
+        //! @param [in] table The binary table to view. Must remain valid as long as the view is used.
+        //!
+        EITView(const BinaryTable& table);
+
+        //!
+        //! Check if this is an "actual" EIT.
+        //! @return True for EIT Actual TS, false for EIT Other TS.
+        //!
+        bool isActual() const {return tableId() == TID_EIT_PF_ACT || (tableId() >= TID_EIT_S_ACT_MIN && tableId() <= TID_EIT_S_ACT_MAX);}
+
+        //!
+        //! Check if this is an EIT present/following.
+        //! @return True for EIT present/following, false for EIT schedule.
+        //!
+        bool isPresentFollowing() const {return tableId() == TID_EIT_PF_ACT || tableId() == TID_EIT_PF_OTH;}
+
+        //!
+        //! Get the service id.
+        //! @return The service id.
+        //!
+        uint16_t serviceId() const {return tableIdExtension();}
+
+        //!
+        //! Get the transport stream id.
+        //! @return The transport stream id or zero if the view is invalid.
+        //!
+        uint16_t tsId() const;
+
+        //!
+        //! Get the original network id.
+        //! @return The original network id or zero if the view is invalid.
+        //!
+        uint16_t originalNetworkId() const;
+
+        //!
+        //! Get an iterator to the first event.
+        //! @return An iterator to the first event.
+        //!
+        const_iterator begin() const {return const_iterator(this);}
+
+        //!
+        //! Get an iterator after the last event.
+        //! @return An iterator after the last event.
+        //!
+        const_iterator end() const {return const_iterator();}
+
+    protected:
+        // Inherited methods
+        virtual bool locateEntries(const Section&, const uint8_t*&, size_t&) const override;
+    };
+}
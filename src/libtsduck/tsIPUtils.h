@@ -298,6 +298,11 @@ namespace ts {
     //!
     #define TS_SOCKET_ERR_NOTCONN platform_specific
 
+    //!
+    //! System error code value meaning "operation would block" on a non-blocking socket.
+    //!
+    #define TS_SOCKET_ERR_WOULDBLOCK platform_specific
+
 #elif defined (__windows)
 
     #define TS_SOCKET_T             ::SOCKET
@@ -318,6 +323,7 @@ namespace ts {
     #define TS_SOCKET_SHUT_WR       SD_SEND
     #define TS_SOCKET_ERR_RESET     WSAECONNRESET
     #define TS_SOCKET_ERR_NOTCONN   WSAENOTCONN
+    #define TS_SOCKET_ERR_WOULDBLOCK WSAEWOULDBLOCK
 
 #elif defined(__unix)
 
@@ -339,6 +345,7 @@ namespace ts {
     #define TS_SOCKET_SHUT_WR       SHUT_WR
     #define TS_SOCKET_ERR_RESET     EPIPE
     #define TS_SOCKET_ERR_NOTCONN   ENOTCONN
+    #define TS_SOCKET_ERR_WOULDBLOCK EAGAIN
 
 #else
     #error "check socket compatibility macros on this platform"
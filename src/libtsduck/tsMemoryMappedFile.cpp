@@ -0,0 +1,263 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Memory-mapped file
+//
+//----------------------------------------------------------------------------
+
+#include "tsMemoryMappedFile.h"
+#include "tsNullReport.h"
+#include "tsSysUtils.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructor and destructor.
+//----------------------------------------------------------------------------
+
+ts::MemoryMappedFile::MemoryMappedFile() :
+    _filename(),
+    _is_open(false),
+    _read_write(false),
+    _base(0),
+    _map_size(0),
+    _data(0),
+    _size(0),
+#if defined(__windows)
+    _handle(INVALID_HANDLE_VALUE),
+    _mapping(0)
+#else
+    _fd(-1)
+#endif
+{
+}
+
+ts::MemoryMappedFile::~MemoryMappedFile()
+{
+    if (_is_open) {
+        close(NULLREP);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Open and map a file.
+//----------------------------------------------------------------------------
+
+bool ts::MemoryMappedFile::open(const std::string& filename, uint64_t start_offset, bool read_write, ReportInterface& report)
+{
+    if (_is_open) {
+        report.error("already open");
+        return false;
+    }
+
+    _filename = filename;
+    _read_write = read_write;
+    uint64_t file_size = 0;
+
+#if defined(__windows)
+
+    // Windows implementation
+
+    _handle = ::CreateFile(_filename.c_str(),
+                           read_write ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+                           read_write ? 0 : FILE_SHARE_READ,
+                           NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (_handle == INVALID_HANDLE_VALUE) {
+        const ErrorCode error_code = LastErrorCode();
+        report.error("cannot open file " + _filename + ": " + ErrorCodeMessage(error_code));
+        return false;
+    }
+    ::LARGE_INTEGER fsize;
+    if (::GetFileType(_handle) != FILE_TYPE_DISK || ::GetFileSizeEx(_handle, &fsize) == 0) {
+        report.error("file " + _filename + " is not a regular file, cannot map it");
+        cleanup();
+        return false;
+    }
+    file_size = uint64_t(fsize.QuadPart);
+
+#else
+
+    // UNIX implementation
+
+    if ((_fd = ::open(_filename.c_str(), (read_write ? O_RDWR : O_RDONLY) | O_LARGEFILE)) < 0) {
+        const ErrorCode error_code = LastErrorCode();
+        report.error("cannot open file " + _filename + ": " + ErrorCodeMessage(error_code));
+        return false;
+    }
+    struct stat st;
+    if (::fstat(_fd, &st) < 0) {
+        const ErrorCode error_code = LastErrorCode();
+        report.error("cannot stat file " + _filename + ": " + ErrorCodeMessage(error_code));
+        cleanup();
+        return false;
+    }
+    if (!S_ISREG(st.st_mode)) {
+        report.error("file " + _filename + " is not a regular file, cannot map it");
+        cleanup();
+        return false;
+    }
+    file_size = uint64_t(st.st_size);
+
+#endif
+
+    // The complete file must fit in the address space.
+    if (file_size > uint64_t(std::numeric_limits<size_t>::max())) {
+        report.error("file " + _filename + " is too large to be mapped in memory");
+        cleanup();
+        return false;
+    }
+    _map_size = size_t(file_size);
+
+    // Empty files cannot be mapped but this is not an error, there is simply no content.
+    if (_map_size > 0) {
+#if defined(__windows)
+        _mapping = ::CreateFileMapping(_handle, NULL, read_write ? PAGE_READWRITE : PAGE_READONLY, 0, 0, NULL);
+        if (_mapping != 0) {
+            _base = reinterpret_cast<uint8_t*>(::MapViewOfFile(_mapping, read_write ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0));
+        }
+        if (_base == 0) {
+#else
+        void* addr = ::mmap(0, _map_size, read_write ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, _fd, 0);
+        _base = addr == MAP_FAILED ? 0 : reinterpret_cast<uint8_t*>(addr);
+        if (_base == 0) {
+#endif
+            const ErrorCode error_code = LastErrorCode();
+            report.error("cannot map file " + _filename + ": " + ErrorCodeMessage(error_code));
+            cleanup();
+            return false;
+        }
+    }
+
+    // Start offset beyond end of file means nothing to read.
+    if (start_offset < file_size) {
+        _data = _base + size_t(start_offset);
+        _size = _map_size - size_t(start_offset);
+    }
+
+    _is_open = true;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Hint the system that the mapped area will be accessed sequentially.
+//----------------------------------------------------------------------------
+
+void ts::MemoryMappedFile::adviseSequential()
+{
+#if !defined(__windows)
+    if (_base != 0) {
+        ::posix_madvise(_base, _map_size, POSIX_MADV_SEQUENTIAL);
+    }
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Flush modified data in a range of the mapped area.
+//----------------------------------------------------------------------------
+
+bool ts::MemoryMappedFile::sync(size_t offset, size_t length, ReportInterface& report)
+{
+    if (!_is_open) {
+        report.error("not open");
+        return false;
+    }
+    if (!_read_write || offset >= _size || length == 0) {
+        return true;
+    }
+    length = std::min(length, _size - offset);
+
+    // The flushed area must start on a page boundary.
+    const size_t start = size_t(_data - _base) + offset;
+    const size_t aligned = start - start % MemoryPageSize();
+
+#if defined(__windows)
+    if (::FlushViewOfFile(_base + aligned, start + length - aligned) == 0) {
+#else
+    if (::msync(_base + aligned, start + length - aligned, MS_SYNC) != 0) {
+#endif
+        const ErrorCode error_code = LastErrorCode();
+        report.error("error flushing file " + _filename + ": " + ErrorCodeMessage(error_code));
+        return false;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Unmap and close the file.
+//----------------------------------------------------------------------------
+
+bool ts::MemoryMappedFile::close(ReportInterface& report)
+{
+    if (!_is_open) {
+        report.error("not open");
+        return false;
+    }
+    const bool ok = sync(0, _size, report);
+    cleanup();
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Release all system resources.
+//----------------------------------------------------------------------------
+
+void ts::MemoryMappedFile::cleanup()
+{
+#if defined(__windows)
+    if (_base != 0) {
+        ::UnmapViewOfFile(_base);
+    }
+    if (_mapping != 0) {
+        ::CloseHandle(_mapping);
+    }
+    if (_handle != INVALID_HANDLE_VALUE) {
+        ::CloseHandle(_handle);
+    }
+    _handle = INVALID_HANDLE_VALUE;
+    _mapping = 0;
+#else
+    if (_base != 0) {
+        ::munmap(_base, _map_size);
+    }
+    if (_fd >= 0) {
+        ::close(_fd);
+    }
+    _fd = -1;
+#endif
+
+    _is_open = false;
+    _base = _data = 0;
+    _map_size = _size = 0;
+    _filename.clear();
+}
@@ -0,0 +1,160 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Memory-mapped file
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsReportInterface.h"
+
+namespace ts {
+    //!
+    //! Memory-mapped file.
+    //!
+    //! The complete content of a regular file is mapped into the virtual memory
+    //! of the process. This is typically used to process very large files without
+    //! going through intermediate read or write buffers.
+    //!
+    //! The file is mapped in one single view. On 32-bit systems, the size of
+    //! the file is consequently limited by the available address space.
+    //!
+    class TSDUCKDLL MemoryMappedFile
+    {
+    public:
+        //!
+        //! Default constructor.
+        //!
+        MemoryMappedFile();
+
+        //!
+        //! Destructor.
+        //!
+        virtual ~MemoryMappedFile();
+
+        //!
+        //! Open and map a file.
+        //! @param [in] filename File name. Must be a regular file.
+        //! @param [in] start_offset Offset in bytes from the beginning of the file.
+        //! The mapped area, as returned by data(), starts at this offset.
+        //! @param [in] read_write If true, the mapping is writeable and all
+        //! modifications in memory are propagated to the file. If false, the file
+        //! is opened in read-only mode.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool open(const std::string& filename, uint64_t start_offset, bool read_write, ReportInterface& report);
+
+        //!
+        //! Check if the file is open.
+        //! @return True if the file is open.
+        //!
+        bool isOpen() const
+        {
+            return _is_open;
+        }
+
+        //!
+        //! Get the file name.
+        //! @return The file name.
+        //!
+        std::string getFileName() const
+        {
+            return _filename;
+        }
+
+        //!
+        //! Get the address of the mapped area.
+        //! @return The address of the file content, starting at the @a start_offset
+        //! which was specified in open(). Zero when the file is not open or when
+        //! there is nothing to map.
+        //!
+        uint8_t* data() const
+        {
+            return _data;
+        }
+
+        //!
+        //! Get the size of the mapped area.
+        //! @return The size in bytes of the file content, starting at the @a start_offset
+        //! which was specified in open().
+        //!
+        size_t size() const
+        {
+            return _size;
+        }
+
+        //!
+        //! Hint the system that the mapped area will be accessed sequentially.
+        //! This is only a hint. Errors are ignored and this is a no-op when
+        //! not supported by the operating system.
+        //!
+        void adviseSequential();
+
+        //!
+        //! Synchronously flush modified data in a range of the mapped area to the file.
+        //! @param [in] offset Offset of the range in the mapped area, relative to data().
+        //! @param [in] length Size in bytes of the range to flush.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool sync(size_t offset, size_t length, ReportInterface& report);
+
+        //!
+        //! Unmap and close the file.
+        //! Modified data are flushed to the file.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool close(ReportInterface& report);
+
+    private:
+        std::string _filename;    //!< File name.
+        bool        _is_open;     //!< Check if file is actually open.
+        bool        _read_write;  //!< File is open in read-write mode.
+        uint8_t*    _base;        //!< Base address of the mapping (file offset zero).
+        size_t      _map_size;    //!< Size of the complete mapping.
+        uint8_t*    _data;        //!< Address of the content at start offset.
+        size_t      _size;        //!< Size of the content at start offset.
+#if defined(__windows)
+        ::HANDLE    _handle;      //!< File handle.
+        ::HANDLE    _mapping;     //!< File mapping handle.
+#else
+        int         _fd;          //!< File descriptor.
+#endif
+
+        // Inaccessible operations
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+        MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+        // Release all system resources.
+        void cleanup();
+    };
+}
@@ -0,0 +1,89 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Read-only view of a Network Information Table (NIT)
+//
+//----------------------------------------------------------------------------
+
+#include "tsNITView.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::NITView::NITView(const BinaryTable& table) :
+    AbstractTableView(table, 6, 4)
+{
+    validate(table.tableId() == TID_NIT_ACT || table.tableId() == TID_NIT_OTH);
+}
+
+
+//----------------------------------------------------------------------------
+// Locate the list of entries in a section.
+//----------------------------------------------------------------------------
+
+bool ts::NITView::locateEntries(const Section& section, const uint8_t*& data, size_t& size) const
+{
+    data = section.payload();
+    size = section.payloadSize();
+
+    // Skip network-level descriptor loop.
+    if (size < 2) {
+        return false;
+    }
+    const size_t info_length = std::min<size_t>(GetUInt16(data) & 0x0FFF, size - 2);
+    data += 2 + info_length;
+    size -= 2 + info_length;
+
+    // Get transport stream loop length.
+    if (size < 2) {
+        return false;
+    }
+    const size_t ts_length = GetUInt16(data) & 0x0FFF;
+    data += 2;
+    size = std::min(ts_length, size - 2);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the network-level descriptor loop in one section.
+//----------------------------------------------------------------------------
+
+ts::DescriptorLoopView ts::NITView::descriptors(size_t section) const
+{
+    if (!isValid() || section >= table().sectionCount()) {
+        return DescriptorLoopView();
+    }
+    const uint8_t* data = table().sectionAt(section)->payload();
+    const size_t size = table().sectionAt(section)->payloadSize();
+    return DescriptorLoopView(data + 2, std::min<size_t>(GetUInt16(data) & 0x0FFF, size - 2));
+}
@@ -0,0 +1,130 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only view of a Network Information Table (NIT)
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsAbstractTableView.h"
+#include "tsDescriptorLoopView.h"
+
+namespace ts {
+    //!
+    //! Read-only view of a Network Information Table (NIT).
+    //! @see AbstractTableView, NIT
+    //!
+    class TSDUCKDLL NITView : public AbstractTableView
+    {
+    public:
+        //!
+        //! One transport stream in the NIT.
+        //!
+        class TSDUCKDLL Transport
+        {
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] data Address of the entry.
+            //! @param [in] size Size in bytes of the entry, including the descriptor loop.
+            //!
+            Transport(const uint8_t* data, size_t size) : _data(data), _size(size) {}
+
+            //!
+            //! Get the transport stream id.
+            //! @return The transport stream id.
+            //!
+            uint16_t tsId() const {return GetUInt16(_data);}
+
+            //!
+            //! Get the original network id.
+            //! @return The original network id.
+            //!
+            uint16_t originalNetworkId() const {return GetUInt16(_data + 2);}
+
+            //!
+            //! Get the descriptor loop of the transport stream.
+            //! @return A view of the descriptor loop.
+            //!
+            DescriptorLoopView descriptors() const {return DescriptorLoopView(_data + 6, _size - 6);}
+
+        private:
+            const uint8_t* _data;
+            size_t         _size;
+        };
+
+        //!
+        //! Iterator over the transport streams of the NIT.
+        //!
+        typedef EntryIterator<Transport> const_iterator;
+
+        //!
+        //! Constructor.
+        //! @param [in] table The binary table to view. Must remain valid as long as the view is used.
+        //!
+        NITView(const BinaryTable& table);
+
+        //!
+        //! Check if this is an "actual" NIT.
+        //! @return True for NIT Actual Network, false for NIT Other Network.
+        //!
+        bool isActual() const {return tableId() == TID_NIT_ACT;}
+
+        //!
+        //! Get the network id.
+        //! @return The network id.
+        //!
+        uint16_t networkId() const {return tableIdExtension();}
+
+        //!
+        //! Get the network-level descriptor loop in one section.
+        //! Unlike PMT, the network-level descriptor loop may be split across several sections.
+        //! @param [in] section Index of the section.
+        //! @return A view of the network-level descriptor loop in the section.
+        //!
+        DescriptorLoopView descriptors(size_t section = 0) const;
+
+        //!
+        //! Get an iterator to the first transport stream.
+        //! @return An iterator to the first transport stream.
+        //!
+        const_iterator begin() const {return const_iterator(this);}
+
+        //!
+        //! Get an iterator after the last transport stream.
+        //! @return An iterator after the last transport stream.
+        //!
+        const_iterator end() const {return const_iterator();}
+
+    protected:
+        // Inherited methods
+        virtual bool locateEntries(const Section&, const uint8_t*&, size_t&) const override;
+    };
+}
@@ -33,8 +33,11 @@
 #include "tsSysUtils.h"
 #include "tsFatal.h"
 #include "tsCerrReport.h"
+#include "tsNullReport.h"
 TSDUCK_SOURCE;
 
+const char* const ts::Names::COMPILED_SUFFIX = ".bin";
+
 
 //----------------------------------------------------------------------------
 // Configuration instances.
@@ -263,6 +266,39 @@ ts::UString ts::names::AC3ComponentType(uint8_t type, Flags flags)
 }
 
 
+//----------------------------------------------------------------------------
+// Layout of the compiled form of a configuration file.
+// All integers are big endian. All offsets are from the beginning of the image.
+//
+//   Header (16 bytes):
+//     0: magic "TSNC"
+//     4: uint16 format version
+//     6: uint16 reserved
+//     8: uint32 number of sections
+//    12: uint32 total size of the image
+//   Section table, sorted by name (16 bytes per section):
+//     0: uint32 offset of lowercase section name (UTF-8)
+//     4: uint16 size of section name
+//     6: uint16 number of significant bits in values
+//     8: uint32 offset of first entry
+//    12: uint32 number of entries
+//   Entries of each section, sorted by first value (24 bytes per entry):
+//     0: uint64 first value
+//     8: uint64 last value
+//    16: uint32 offset of name (UTF-8)
+//    20: uint32 size of name
+//   Strings.
+//----------------------------------------------------------------------------
+
+namespace {
+    const uint8_t  COMPILED_MAGIC[4] = {'T', 'S', 'N', 'C'};
+    const uint16_t COMPILED_VERSION = 1;
+    const size_t   HEADER_SIZE = 16;
+    const size_t   SECTION_SIZE = 16;
+    const size_t   ENTRY_SIZE = 24;
+}
+
+
 //----------------------------------------------------------------------------
 // Constructor (load the configuration file).
 //----------------------------------------------------------------------------
@@ -272,23 +308,118 @@ ts::Names::Names(const std::string& fileName) :
     _configFile(SearchConfigurationFile(fileName)),
     _configLines(0),
     _configErrors(0),
-    _sections()
-{
+    _image(),
+    _mapped(),
+    _data(0),
+    _size(0)
+{
+    // Use the compiled file if there is one which is not older than the text file.
+    const std::string compiledFile(SearchConfigurationFile(fileName + COMPILED_SUFFIX));
+    if (!compiledFile.empty() &&
+        (_configFile.empty() || GetFileModificationTimeUTC(_configFile) <= GetFileModificationTimeUTC(compiledFile)) &&
+        loadCompiledFile(compiledFile))
+    {
+        _configFile = compiledFile;
+        return;
+    }
+
     // Locate the configuration file.
     if (_configFile.empty()) {
         // Cannot load configuration, names will not be available.
-        _log.error("configuration file 'tsduck.names' not found");
-        return;
+        _log.error("configuration file '%s' not found", fileName.c_str());
+    }
+    else if (!loadCompiledFile(_configFile)) {
+        // Not a compiled file, parse the text file.
+        loadTextFile(_configFile);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Destructor.
+//----------------------------------------------------------------------------
+
+ts::Names::~Names()
+{
+    _mapped.close(NULLREP);
+}
+
+
+//----------------------------------------------------------------------------
+// Map a compiled file.
+//----------------------------------------------------------------------------
+
+bool ts::Names::loadCompiledFile(const std::string& fileName)
+{
+    // Errors are silently ignored, the text file is used instead.
+    if (!_mapped.open(fileName, 0, false, NULLREP)) {
+        return false;
     }
+    else if (!ValidImage(_mapped.data(), _mapped.size())) {
+        _mapped.close(NULLREP);
+        return false;
+    }
+    else {
+        _data = _mapped.data();
+        _size = _mapped.size();
+        return true;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Check the header and section table of a compiled image.
+//----------------------------------------------------------------------------
+
+bool ts::Names::ValidImage(const uint8_t* data, size_t size)
+{
+    if (data == 0 ||
+        size < HEADER_SIZE ||
+        ::memcmp(data, COMPILED_MAGIC, sizeof(COMPILED_MAGIC)) != 0 ||
+        GetUInt16(data + 4) != COMPILED_VERSION ||
+        GetUInt32(data + 12) != size)
+    {
+        return false;
+    }
+
+    const size_t count = GetUInt32(data + 8);
+    if (count > (size - HEADER_SIZE) / SECTION_SIZE) {
+        return false;
+    }
+
+    // Check that all section names and entry arrays are inside the image.
+    // Entry names are checked when used.
+    for (const uint8_t* sec = data + HEADER_SIZE; sec < data + HEADER_SIZE + count * SECTION_SIZE; sec += SECTION_SIZE) {
+        const size_t name_offset = GetUInt32(sec);
+        const size_t entries_offset = GetUInt32(sec + 8);
+        const size_t entries_count = GetUInt32(sec + 12);
+        if (name_offset > size ||
+            GetUInt16(sec + 4) > size - name_offset ||
+            entries_offset > size ||
+            entries_count > (size - entries_offset) / ENTRY_SIZE)
+        {
+            return false;
+        }
+    }
+    return true;
+}
 
+
+//----------------------------------------------------------------------------
+// Parse a text configuration file and compile it.
+//----------------------------------------------------------------------------
+
+void ts::Names::loadTextFile(const std::string& fileName)
+{
     // Open configuration file.
-    std::ifstream strm(_configFile.c_str());
+    std::ifstream strm(fileName.c_str());
     if (!strm) {
-        _log.error("error opening file " + _configFile);
+        _log.error("error opening file " + fileName);
         return;
     }
 
     // Read configuration file line by line.
+    ConfigSectionMap sections;
     ConfigSection* section = 0;
     UString line;
     while (line.getLine(strm)) {
@@ -306,28 +437,34 @@ ts::Names::Names(const std::string& fileName) :
             line.convertToLower();
 
             // Get or create associated section.
-            ConfigSectionMap::iterator it = _sections.find(line);
-            if (it != _sections.end()) {
+            ConfigSectionMap::iterator it = sections.find(line);
+            if (it != sections.end()) {
                 section = it->second;
             }
             else {
                 // Create new section.
                 section = new ConfigSection;
                 CheckNonNull(section);
-                _sections.insert(std::make_pair(line, section));
+                sections.insert(std::make_pair(line, section));
             }
         }
         else if (!decodeDefinition(line, section)) {
             // Invalid line.
-            _log.error(_configFile + Format(": invalid line %" FMT_SIZE_T "d: ", _configLines) + line.toUTF8());
+            _log.error(fileName + Format(": invalid line %" FMT_SIZE_T "d: ", _configLines) + line.toUTF8());
             if (++_configErrors >= 20) {
                 // Give up after that number of errors
-                _log.error(_configFile + ": too many errors, giving up");
+                _log.error(fileName + ": too many errors, giving up");
                 break;
             }
         }
     }
     strm.close();
+
+    // Build the compiled image and deallocate all configuration sections.
+    compile(sections);
+    for (ConfigSectionMap::iterator it = sections.begin(); it != sections.end(); ++it) {
+        delete it->second;
+    }
 }
 
 
@@ -384,16 +521,78 @@ bool ts::Names::decodeDefinition(const UString& line, ConfigSection* section)
 
 
 //----------------------------------------------------------------------------
-// Destructor: free all resources.
+// Build the compiled image from parsed sections.
 //----------------------------------------------------------------------------
 
-ts::Names::~Names()
+void ts::Names::compile(const ConfigSectionMap& sections)
 {
-    // Deallocate all configuration sections.
-    for (ConfigSectionMap::iterator it = _sections.begin(); it != _sections.end(); ++it) {
-        delete it->second;
+    // Sections are sorted by UTF-8 names, the order of the binary search.
+    std::map<std::string, const ConfigSection*> sorted;
+    size_t entries_count = 0;
+    for (ConfigSectionMap::const_iterator it = sections.begin(); it != sections.end(); ++it) {
+        sorted[it->first.toUTF8()] = it->second;
+        entries_count += it->second->entries.size();
+    }
+
+    // Fixed-size parts first, strings are appended after them.
+    size_t entries_offset = HEADER_SIZE + sorted.size() * SECTION_SIZE;
+    _image.resize(entries_offset + entries_count * ENTRY_SIZE);
+    ::memcpy(_image.data(), COMPILED_MAGIC, sizeof(COMPILED_MAGIC));
+    PutUInt16(_image.data() + 4, COMPILED_VERSION);
+    PutUInt16(_image.data() + 6, 0);
+    PutUInt32(_image.data() + 8, uint32_t(sorted.size()));
+
+    size_t sec_offset = HEADER_SIZE;
+    for (std::map<std::string, const ConfigSection*>::const_iterator sit = sorted.begin(); sit != sorted.end(); ++sit) {
+        const ConfigEntryMap& entries(sit->second->entries);
+        PutUInt32(_image.data() + sec_offset, uint32_t(_image.size()));
+        PutUInt16(_image.data() + sec_offset + 4, uint16_t(sit->first.size()));
+        PutUInt16(_image.data() + sec_offset + 6, uint16_t(sit->second->bits));
+        PutUInt32(_image.data() + sec_offset + 8, uint32_t(entries_offset));
+        PutUInt32(_image.data() + sec_offset + 12, uint32_t(entries.size()));
+        _image.append(sit->first.data(), sit->first.size());
+        sec_offset += SECTION_SIZE;
+
+        for (ConfigEntryMap::const_iterator eit = entries.begin(); eit != entries.end(); ++eit) {
+            const std::string name(eit->second->name.toUTF8());
+            PutUInt64(_image.data() + entries_offset, eit->first);
+            PutUInt64(_image.data() + entries_offset + 8, eit->second->last);
+            PutUInt32(_image.data() + entries_offset + 16, uint32_t(_image.size()));
+            PutUInt32(_image.data() + entries_offset + 20, uint32_t(name.size()));
+            _image.append(name.data(), name.size());
+            entries_offset += ENTRY_SIZE;
+        }
+    }
+
+    PutUInt32(_image.data() + 12, uint32_t(_image.size()));
+    _data = _image.data();
+    _size = _image.size();
+}
+
+
+//----------------------------------------------------------------------------
+// Save the names in compiled form.
+//----------------------------------------------------------------------------
+
+bool ts::Names::saveCompiledFile(const std::string& fileName, ReportInterface& report) const
+{
+    if (_data == 0) {
+        report.error("no names loaded, cannot create " + fileName);
+        return false;
+    }
+
+    std::ofstream strm(fileName.c_str(), std::ios::out | std::ios::binary);
+    if (!strm) {
+        report.error("cannot create " + fileName);
+        return false;
+    }
+    strm.write(reinterpret_cast<const char*>(_data), std::streamsize(_size));
+    const bool success = !strm.fail();
+    strm.close();
+    if (!success) {
+        report.error("error writing " + fileName);
     }
-    _sections.clear();
+    return success;
 }
 
 
@@ -467,30 +666,71 @@ void ts::Names::ConfigSection::addEntry(Value first, Value last, const UString&
 
 
 //----------------------------------------------------------------------------
-// Get a name from a value, empty if not found.
+// Locate a section in the compiled image.
 //----------------------------------------------------------------------------
 
-ts::UString ts::Names::ConfigSection::getName(Value val) const
+const uint8_t* ts::Names::findSection(const UString& sectionName) const
 {
-    // Eliminate trivial cases which would cause issues with code below.
-    if (entries.empty()) {
-        return UString();
+    if (_data == 0) {
+        return 0;
     }
 
-    // The key in the 'entries' map is the _first_ value of a range.
-    // Get an iterator pointing to the first element that is "not less" than 'val'.
-    ConfigEntryMap::const_iterator it = entries.lower_bound(val);
-
-    if (it == entries.end() || (it != entries.begin() && it->first != val)) {
-        // There is no entry with a value range starting at 'val'.
-        // Maybe 'val' is in the range of the previous entry.
-        --it;
+    // Normalize the section name.
+    const std::string name(sectionName.toTrimmed().toLower().toUTF8());
+
+    // Binary search in the section table. The image was validated when loaded.
+    size_t low = 0;
+    size_t high = GetUInt32(_data + 8);
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        const uint8_t* sec = _data + HEADER_SIZE + mid * SECTION_SIZE;
+        const int cmp = name.compare(0, std::string::npos, reinterpret_cast<const char*>(_data + GetUInt32(sec)), GetUInt16(sec + 4));
+        if (cmp == 0) {
+            return sec;
+        }
+        else if (cmp < 0) {
+            high = mid;
+        }
+        else {
+            low = mid + 1;
+        }
     }
+    return 0;
+}
 
-    assert(it != entries.end());
-    assert(it->second != 0);
 
-    return val >= it->first && val <= it->second->last ? it->second->name : UString();
+//----------------------------------------------------------------------------
+// Get a name from a value in a section, empty if not found.
+//----------------------------------------------------------------------------
+
+ts::UString ts::Names::getName(const uint8_t* section, Value val) const
+{
+    const uint8_t* const entries = _data + GetUInt32(section + 8);
+
+    // Locate the first entry with a first value greater than 'val'.
+    size_t low = 0;
+    size_t high = GetUInt32(section + 12);
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        if (GetUInt64(entries + mid * ENTRY_SIZE) <= val) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+
+    // The previous entry, if any, is the only one which may contain 'val'.
+    if (low == 0) {
+        return UString();
+    }
+    const uint8_t* const entry = entries + (low - 1) * ENTRY_SIZE;
+    const size_t name_offset = GetUInt32(entry + 16);
+    const size_t name_size = GetUInt32(entry + 20);
+    if (val > GetUInt64(entry + 8) || name_offset > _size || name_size > _size - name_offset) {
+        return UString();
+    }
+    return UString::FromUTF8(reinterpret_cast<const char*>(_data + name_offset), name_size);
 }
 
 
@@ -563,16 +803,15 @@ ts::UString ts::Names::Formatted(Value value, const UString& name, names::Flags
 
 ts::UString ts::Names::nameFromSection(const UString& sectionName, Value value, names::Flags flags, size_t bits) const
 {
-    // Get the section, normalize the section name.
-    ConfigSectionMap::const_iterator it = _sections.find(sectionName.toTrimmed().toLower());
-    const ConfigSection* section = it == _sections.end() ? 0 : it->second;
+    // Get the section.
+    const uint8_t* section = findSection(sectionName);
 
     if (section == 0) {
         // Non-existent section, no name.
         return Formatted(value, UString(), flags, bits);
     }
     else {
-        return Formatted(value, section->getName(value), flags, bits != 0 ? bits : section->bits);
+        return Formatted(value, getName(section, value), flags, bits != 0 ? bits : GetUInt16(section + 6));
     }
 }
 
@@ -583,23 +822,23 @@ ts::UString ts::Names::nameFromSection(const UString& sectionName, Value value,
 
 ts::UString ts::Names::nameFromSectionWithFallback(const UString& sectionName, Value value1, Value value2, names::Flags flags, size_t bits) const
 {
-    // Get the section, normalize the section name.
-    ConfigSectionMap::const_iterator it = _sections.find(sectionName.toTrimmed().toLower());
-    const ConfigSection* section = it == _sections.end() ? 0 : it->second;
+    // Get the section.
+    const uint8_t* section = findSection(sectionName);
 
     if (section == 0) {
         // Non-existent section, no name.
         return Formatted(value1, UString(), flags, bits);
     }
     else {
-        const UString name(section->getName(value1));
+        const size_t section_bits = bits != 0 ? bits : GetUInt16(section + 6);
+        const UString name(getName(section, value1));
         if (!name.empty()) {
             // value1 has a name
-            return Formatted(value1, name, flags, bits != 0 ? bits : section->bits);
+            return Formatted(value1, name, flags, section_bits);
         }
         else {
             // value1 has no name, use value2.
-            return Formatted(value2, section->getName(value2), flags, bits != 0 ? bits : section->bits);
+            return Formatted(value2, getName(section, value2), flags, section_bits);
         }
     }
 }
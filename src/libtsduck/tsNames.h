@@ -38,6 +38,8 @@
 #include "tsCASFamily.h"
 #include "tsReportInterface.h"
 #include "tsStaticInstance.h"
+#include "tsMemoryMappedFile.h"
+#include "tsByteBlock.h"
 
 namespace ts {
     //!
@@ -329,7 +331,14 @@ namespace ts {
 
     //!
     //! A repository of names for MPEG/DVB entities.
+    //!
     //! All names are loaded from configuration files @em tsduck.*.names.
+    //! These text files can be compiled into a binary form, the file
+    //! @em tsduck.*.names.bin, using the utility @em tsnames. When a compiled
+    //! file is found and is not older than the text file, it is directly mapped
+    //! in memory and the text file is not parsed. Without compiled file, the
+    //! text file is parsed and compiled in memory. In all cases, the names are
+    //! searched using binary searches in the compiled form.
     //!
     class TSDUCKDLL Names
     {
@@ -337,9 +346,15 @@ namespace ts {
         //!
         //! Constructor.
         //! @param [in] fileName Configuration file name. Typically without directory name.
+        //! This can be either a text file or a compiled file.
         //!
         Names(const std::string& fileName);
 
+        //!
+        //! File name suffix of compiled configuration files.
+        //!
+        static const char* const COMPILED_SUFFIX;
+
         //!
         //! Virtual destructor.
         //!
@@ -352,7 +367,7 @@ namespace ts {
 
         //!
         //! Get the complete path of the configuration file from which the names were loaded.
-        //! @return The complete path of the configuration file. Empty if does not exist.
+        //! @return The complete path of the configuration file, text or compiled. Empty if does not exist.
         //!
         std::string configurationFile() const
         {
@@ -368,6 +383,23 @@ namespace ts {
             return _configErrors;
         }
 
+        //!
+        //! Check if the names were loaded from a compiled file.
+        //! @return True if the names were loaded from a compiled file.
+        //!
+        bool isCompiledFile() const
+        {
+            return _mapped.isOpen();
+        }
+
+        //!
+        //! Save the names in compiled form.
+        //! @param [in] fileName Name of the compiled file to create.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool saveCompiledFile(const std::string& fileName, ReportInterface& report) const;
+
         //!
         //! Get a name from a specified section.
         //! @param [in] sectionName Name of section to search. Not case-sensitive.
@@ -400,7 +432,7 @@ namespace ts {
         static UString Formatted(Value value, const UString& name, names::Flags flags, size_t bits);
 
     private:
-        // Description of a configuration entry.
+        // Description of a configuration entry, used while parsing a text file.
         // The first value of the range is the key in a map.
         class ConfigEntry
         {
@@ -414,7 +446,7 @@ namespace ts {
         // Map of configuration entries, indexed by first value of the range.
         typedef std::map<Value, ConfigEntry*> ConfigEntryMap;
 
-        // Description of a configuration section.
+        // Description of a configuration section, used while parsing a text file.
         // The name of the section is the key in a map.
         class ConfigSection
         {
@@ -430,17 +462,32 @@ namespace ts {
 
             // Add a new entry.
             void addEntry(Value first, Value last, const UString& name);
-
-            // Get a name from a value, empty if not found.
-            UString getName(Value val) const;
         };
 
         // Map of configuration sections, indexed by name.
         typedef std::map<UString, ConfigSection*> ConfigSectionMap;
 
+        // Parse a text configuration file and compile it in _image.
+        void loadTextFile(const std::string& fileName);
+
         // Decode a line as "first[-last] = name". Return true on success, false on error.
         bool decodeDefinition(const UString& line, ConfigSection* section);
 
+        // Build the compiled image from parsed sections.
+        void compile(const ConfigSectionMap& sections);
+
+        // Map a compiled file. Return false if this is not a valid compiled file.
+        bool loadCompiledFile(const std::string& fileName);
+
+        // Check the header and section table of a compiled image.
+        static bool ValidImage(const uint8_t* data, size_t size);
+
+        // Locate a section in the compiled image, return its descriptor or zero if not found.
+        const uint8_t* findSection(const UString& sectionName) const;
+
+        // Get a name from a value in a section, empty if not found.
+        UString getName(const uint8_t* section, Value val) const;
+
         // Compute a number of hexa digits.
         static int HexaDigits(size_t bits);
 
@@ -448,11 +495,14 @@ namespace ts {
         static Value DisplayMask(size_t bits);
 
         // Names private fields.
-        ReportInterface&  _log;           // Error logger.
-        const std::string _configFile;    // Configuration file path.
-        size_t            _configLines;   // Number of lines in configuration file.
-        size_t            _configErrors;  // Number of errors in configuration file.
-        ConfigSectionMap  _sections;      // Configuration sections.
+        ReportInterface& _log;           // Error logger.
+        std::string      _configFile;    // Configuration file path.
+        size_t           _configLines;   // Number of lines in configuration file.
+        size_t           _configErrors;  // Number of errors in configuration file.
+        ByteBlock        _image;         // Compiled image, when compiled from a text file.
+        MemoryMappedFile _mapped;        // Mapped compiled file.
+        const uint8_t*   _data;          // Address of compiled image, in _image or _mapped.
+        size_t           _size;          // Size of compiled image.
 
         // Inaccessible operations.
         Names() = delete;
@@ -0,0 +1,86 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Read-only view of a Program Association Table (PAT)
+//
+//----------------------------------------------------------------------------
+
+#include "tsPATView.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::PATView::PATView(const BinaryTable& table) :
+    AbstractTableView(table, 4, NO_LENGTH)
+{
+    validate(table.tableId() == TID_PAT);
+}
+
+
+//----------------------------------------------------------------------------
+// Locate the list of entries in a section.
+//----------------------------------------------------------------------------
+
+bool ts::PATView::locateEntries(const Section& section, const uint8_t*& data, size_t& size) const
+{
+    data = section.payload();
+    size = section.payloadSize();
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Search programs.
+//----------------------------------------------------------------------------
+
+bool ts::PATView::findPMT(uint16_t service_id, PID& pid) const
+{
+    for (const_iterator it = begin(); it != end(); ++it) {
+        if (service_id != 0 && (*it).programNumber() == service_id) {
+            pid = (*it).pid();
+            return true;
+        }
+    }
+    return false;
+}
+
+ts::PID ts::PATView::nitPID() const
+{
+    // Same as PAT deserialization: the last occurrence of program zero is used.
+    PID pid = PID_NULL;
+    for (const_iterator it = begin(); it != end(); ++it) {
+        if ((*it).programNumber() == 0) {
+            pid = (*it).pid();
+        }
+    }
+    return pid;
+}
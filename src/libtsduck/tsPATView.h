@@ -0,0 +1,122 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only view of a Program Association Table (PAT)
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsAbstractTableView.h"
+
+namespace ts {
+    //!
+    //! Read-only view of a Program Association Table (PAT).
+    //! @see AbstractTableView, PAT
+    //!
+    class TSDUCKDLL PATView : public AbstractTableView
+    {
+    public:
+        //!
+        //! One program in the PAT (service_id / PMT PID association).
+        //!
+        class TSDUCKDLL Program
+        {
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] data Address of the entry.
+            //! @param [in] size Size in bytes of the entry.
+            //!
+            Program(const uint8_t* data, size_t size) : _data(data) {}
+
+            //!
+            //! Get the program number (service id).
+            //! @return The program number. Zero means that pid() is the NIT PID.
+            //!
+            uint16_t programNumber() const {return GetUInt16(_data);}
+
+            //!
+            //! Get the PMT PID, or NIT PID for program number zero.
+            //! @return The PID.
+            //!
+            PID pid() const {return GetUInt16(_data + 2) & 0x1FFF;}
+
+        private:
+            const uint8_t* _data;
+        };
+
+        //!
+        //! Iterator over the programs of the PAT.
+        //!
+        typedef EntryIterator<Program> const_iterator;
+
+        //!
+        //! Constructor.
+        //! @param [in] table The binary table to view. Must remain valid as long as the view is used.
+        //!
+        PATView(const BinaryTable& table);
+
+        //!
+        //! Get the transport stream id.
+        //! @return The transport stream id.
+        //!
+        uint16_t tsId() const {return tableIdExtension();}
+
+        //!
+        //! Get an iterator to the first program.
+        //! @return An iterator to the first program.
+        //!
+        const_iterator begin() const {return const_iterator(this);}
+
+        //!
+        //! Get an iterator after the last program.
+        //! @return An iterator after the last program.
+        //!
+        const_iterator end() const {return const_iterator();}
+
+        //!
+        //! Search the PMT PID of a service.
+        //! @param [in] service_id The service id to search.
+        //! @param [out] pid The PMT PID of the service.
+        //! @return True if found, false otherwise.
+        //!
+        bool findPMT(uint16_t service_id, PID& pid) const;
+
+        //!
+        //! Get the NIT PID.
+        //! @return The NIT PID as found in the PAT or PID_NULL if not specified.
+        //!
+        PID nitPID() const;
+
+    protected:
+        // Inherited methods
+        virtual bool locateEntries(const Section&, const uint8_t*&, size_t&) const override;
+    };
+}
@@ -340,3 +340,103 @@ bool ts::PCRAnalyzer::feedPacket(const TSPacket& pkt)
 
     return _bitrate_valid;
 }
+
+
+//----------------------------------------------------------------------------
+// Feed the PCR analyzer with a contiguous array of transport packets.
+// Return true if we have collected enough packet to evaluate TS bitrate.
+//----------------------------------------------------------------------------
+
+bool ts::PCRAnalyzer::feedPackets(const TSPacket* pkt, size_t count)
+{
+    // A packet with a valid sync byte, a payload and no adaptation field cannot
+    // contain a PCR or a discontinuity indicator. In DTS mode, the DTS is in the
+    // PES header and the packet must also not start a PES packet (PUSI clear).
+    // For these packets, only the packet counters and the continuity are updated.
+    // The test is one mask over the 4-byte packet header.
+    const uint32_t mask = _use_dts ? 0xFF400030 : 0xFF000030;
+    const uint32_t value = 0x47000010;
+
+    const TSPacket* const end = pkt + count;
+    while (pkt < end) {
+
+        // Pre-filter the block: find the end of the run of packets which
+        // cannot contain a PCR (or DTS) or a discontinuity indicator.
+        const TSPacket* run = pkt;
+        while (run < end && (GetUInt32(run->b) & mask) == value) {
+            ++run;
+        }
+
+        // Process the run, only checking the continuity.
+        for (; pkt < run; ++pkt) {
+            const uint8_t* const b = pkt->b;
+            PIDAnalysis* const ps = _pid[GetUInt16(b + 1) & 0x1FFF];
+            if (ps == 0) {
+                // First packet in this PID, creates the PID context.
+                feedPacket(*pkt);
+            }
+            else {
+                _ts_pkt_cnt++;
+                ps->ts_pkt_cnt++;
+                const uint8_t continuity_cnt = b[3] & 0x0F;
+                if (continuity_cnt != ps->cur_continuity && continuity_cnt != ((ps->cur_continuity + 1) & 0x0F)) {
+                    processDiscountinuity();
+                }
+                ps->cur_continuity = continuity_cnt;
+            }
+        }
+
+        // The packet after the run uses the standard path.
+        if (pkt < end) {
+            feedPacket(*pkt++);
+        }
+    }
+    return _bitrate_valid;
+}
+
+
+//----------------------------------------------------------------------------
+// Merge the results of another analyzer.
+//----------------------------------------------------------------------------
+
+void ts::PCRAnalyzer::merge(const PCRAnalyzer& other)
+{
+    _ts_pkt_cnt += other._ts_pkt_cnt;
+    _ts_bitrate_188 += other._ts_bitrate_188;
+    _ts_bitrate_204 += other._ts_bitrate_204;
+    _ts_bitrate_cnt += other._ts_bitrate_cnt;
+
+    for (size_t i = 0; i < PID_MAX; ++i) {
+        const PIDAnalysis* const po = other._pid[i];
+        if (po != 0) {
+            PIDAnalysis* ps = _pid[i];
+            if (ps == 0) {
+                ps = _pid[i] = new PIDAnalysis;
+            }
+            const uint64_t previous_cnt = ps->ts_bitrate_cnt;
+
+            ps->ts_pkt_cnt += po->ts_pkt_cnt;
+            ps->cur_continuity = po->cur_continuity;
+            ps->ts_bitrate_188 += po->ts_bitrate_188;
+            ps->ts_bitrate_204 += po->ts_bitrate_204;
+            ps->ts_bitrate_cnt += po->ts_bitrate_cnt;
+
+            // The PCR of the other analyzer are relative to its own packet counter.
+            ps->last_pcr_value = po->last_pcr_value;
+            ps->last_pcr_packet = po->last_pcr_packet + _ts_pkt_cnt - other._ts_pkt_cnt;
+
+            if (previous_cnt == 0 && ps->ts_bitrate_cnt > 0) {
+                _pcr_pids++;
+            }
+            if (previous_cnt < _min_pcr && ps->ts_bitrate_cnt >= _min_pcr) {
+                _completed_pids++;
+            }
+        }
+        else if (_pid[i] != 0) {
+            // Cannot compute a rate between a PCR before and after the other part.
+            _pid[i]->last_pcr_value = 0;
+        }
+    }
+
+    _bitrate_valid = _completed_pids >= _min_pid;
+}
@@ -93,6 +93,27 @@ namespace ts {
         //!
         bool feedPacket(const TSPacket& pkt);
 
+        //!
+        //! The following method feeds the analyzer with a contiguous array of TS packets.
+        //! The result is the same as calling feedPacket() on each packet but the packets
+        //! without adaptation field, which cannot contain a PCR, are processed faster.
+        //! When using DTS, this applies to packets without adaptation field which do
+        //! not start a PES packet.
+        //! All packets are processed, even after the bitrate becomes valid.
+        //! @param [in] pkt Address of the first packet.
+        //! @param [in] count Number of packets.
+        //! @return True if we have collected enough packet to evaluate TS bitrate.
+        //!
+        bool feedPackets(const TSPacket* pkt, size_t count);
+
+        //!
+        //! Merge the results of another analyzer which processed the next part of the stream.
+        //! This is typically used to analyze a large file in parallel, one chunk per analyzer.
+        //! The PCR intervals which span the two parts of the stream are not taken into account.
+        //! @param [in] other Another analyzer, using the same criteria.
+        //!
+        void merge(const PCRAnalyzer& other);
+
         //!
         //! Check if we have collected enough packet to evaluate TS bitrate.
         //! @return True if we have collected enough packet to evaluate TS bitrate.
@@ -0,0 +1,88 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Read-only view of a Program Map Table (PMT)
+//
+//----------------------------------------------------------------------------
+
+#include "tsPMTView.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::PMTView::PMTView(const BinaryTable& table) :
+    AbstractTableView(table, 5, 3)
+{
+    validate(table.tableId() == TID_PMT);
+}
+
+
+//----------------------------------------------------------------------------
+// Locate the list of entries in a section.
+//----------------------------------------------------------------------------
+
+bool ts::PMTView::locateEntries(const Section& section, const uint8_t*& data, size_t& size) const
+{
+    data = section.payload();
+    size = section.payloadSize();
+
+    // Skip PCR PID and program-level descriptor loop.
+    if (size < 4) {
+        return false;
+    }
+    const size_t info_length = std::min<size_t>(GetUInt16(data + 2) & 0x0FFF, size - 4);
+    data += 4 + info_length;
+    size -= 4 + info_length;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Access to the fixed part.
+//----------------------------------------------------------------------------
+
+ts::PID ts::PMTView::pcrPID() const
+{
+    size_t size = 0;
+    const uint8_t* data = firstPayload(size);
+    return data == 0 ? PID(PID_NULL) : PID(GetUInt16(data) & 0x1FFF);
+}
+
+ts::DescriptorLoopView ts::PMTView::descriptors(size_t section) const
+{
+    if (!isValid() || section >= table().sectionCount()) {
+        return DescriptorLoopView();
+    }
+    const uint8_t* data = table().sectionAt(section)->payload();
+    const size_t size = table().sectionAt(section)->payloadSize();
+    return DescriptorLoopView(data + 4, std::min<size_t>(GetUInt16(data + 2) & 0x0FFF, size - 4));
+}
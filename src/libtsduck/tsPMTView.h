@@ -0,0 +1,129 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only view of a Program Map Table (PMT)
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsAbstractTableView.h"
+#include "tsDescriptorLoopView.h"
+
+namespace ts {
+    //!
+    //! Read-only view of a Program Map Table (PMT).
+    //! @see AbstractTableView, PMT
+    //!
+    class TSDUCKDLL PMTView : public AbstractTableView
+    {
+    public:
+        //!
+        //! One elementary stream in the PMT.
+        //!
+        class TSDUCKDLL Stream
+        {
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] data Address of the entry.
+            //! @param [in] size Size in bytes of the entry, including the descriptor loop.
+            //!
+            Stream(const uint8_t* data, size_t size) : _data(data), _size(size) {}
+
+            //!
+            //! Get the stream type.
+            //! @return The stream type.
+            //!
+            uint8_t streamType() const {return _data[0];}
+
+            //!
+            //! Get the elementary stream PID.
+            //! @return The elementary stream PID.
+            //!
+            PID pid() const {return GetUInt16(_data + 1) & 0x1FFF;}
+
+            //!
+            //! Get the descriptor loop of the elementary stream.
+            //! @return A view of the descriptor loop.
+            //!
+            DescriptorLoopView descriptors() const {return DescriptorLoopView(_data + 5, _size - 5);}
+
+        private:
+            const uint8_t* _data;
+            size_t         _size;
+        };
+
+        //!
+        //! Iterator over the elementary streams of the PMT.
+        //!
+        typedef EntryIterator<Stream> const_iterator;
+
+        //!
+        //! Constructor.
+        //! @param [in] table The binary table to view. Must remain valid as long as the view is used.
+        //!
+        PMTView(const BinaryTable& table);
+
+        //!
+        //! Get the service id.
+        //! @return The service id.
+        //!
+        uint16_t serviceId() const {return tableIdExtension();}
+
+        //!
+        //! Get the PCR PID.
+        //! @return The PCR PID or PID_NULL if the view is invalid.
+        //!
+        PID pcrPID() const;
+
+        //!
+        //! Get the program-level descriptor loop.
+        //! @param [in] section Index of the section. A PMT normally has only one section.
+        //! @return A view of the program-level descriptor loop.
+        //!
+        DescriptorLoopView descriptors(size_t section = 0) const;
+
+        //!
+        //! Get an iterator to the first elementary stream.
+        //! @return An iterator to the first elementary stream.
+        //!
+        const_iterator begin() const {return const_iterator(this);}
+
+        //!
+        //! Get an iterator after the last elementary stream.
+        //! @return An iterator after the last elementary stream.
+        //!
+        const_iterator end() const {return const_iterator();}
+
+    protected:
+        // Inherited methods
+        virtual bool locateEntries(const Section&, const uint8_t*&, size_t&) const override;
+    };
+}
@@ -89,6 +89,9 @@ ts::PSILogger::PSILogger (PSILoggerArgs& opt, TablesDisplay& display, ReportInte
 
 ts::PSILogger::~PSILogger()
 {
+    if (_display.options().cache_size > 0) {
+        _report.verbose("display cache: %s", _display.cacheStatistics().toString().c_str());
+    }
     // Files are automatically closed by their destructors.
 }
 
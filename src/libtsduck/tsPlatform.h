@@ -451,6 +451,7 @@
 #include <sys/time.h>
 #include <sys/wait.h>
 #include <sys/socket.h>
+#include <poll.h>
 #include <netdb.h>
 #include <net/if.h>
 #include <netinet/in.h>
@@ -470,6 +471,8 @@
 #if defined(__linux)
 #include <limits.h>
 #include <sys/mman.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <byteswap.h>
 #include <linux/dvb/version.h>
 #include <linux/dvb/frontend.h>
@@ -2535,7 +2538,7 @@ namespace ts {
         char *buf2__ = new char[size1__ + 1];                             \
         va_start(ap__, format_arg);                                       \
         /* Flawfinder: ignore */                                          \
-        int size2__ = ::vsnprintf(buf1__, size1__ + 1, format_arg, ap__); \
+        int size2__ = ::vsnprintf(buf2__, size1__ + 1, format_arg, ap__); \
         va_end(ap__);                                                     \
         if (size2__ < 0) {                                                \
             string_var = "(vsnprintf error)";                             \
@@ -37,6 +37,7 @@
 #include "tsAbortInterface.h"
 #include "tsReportInterface.h"
 #include "tsTSPacket.h"
+#include "tsTimerWheel.h"
 
 namespace ts {
 
@@ -73,6 +74,16 @@ namespace ts {
     //! When the plugin has completed its work, it reports this using
     //! jointTerminate().
     //!
+    //! Timers
+    //! ------
+    //!
+    //! A plugin which needs to perform some action at regular intervals or at
+    //! a given time shall not read the system time for each packet. Instead, it
+    //! schedules timers in the TimerWheel which is returned by timers(). The
+    //! clock is read once per batch of packets by tsp and the expired timers
+    //! are notified in the thread of the plugin, between two packets. The
+    //! timers are checked only when the plugin receives packets.
+    //!
     class TSDUCKDLL TSP: public ReportInterface, public AbortInterface
     {
     public:
@@ -84,7 +95,7 @@ namespace ts {
         //! @c int data named @c tspInterfaceVersion which contains the current
         //! interface version at the time the library is built.
         //!
-        static const int API_VERSION = 5;
+        static const int API_VERSION = 6;
 
         //!
         //! Get the current input bitrate in bits/seconds.
@@ -132,9 +143,18 @@ namespace ts {
         //!
         virtual bool thisJointTerminated() const = 0;
 
+        //!
+        //! Get the timer service of the plugin.
+        //! The timers are notified in the thread of the plugin.
+        //! The time unit is the millisecond on a monotonic clock.
+        //! @return A reference to the timer wheel of the plugin.
+        //!
+        TimerWheel& timers() {return _tsp_timers;}
+
     protected:
         BitRate       _tsp_bitrate;   //!< TSP input bitrate.
         volatile bool _tsp_aborting;  //!< TSP is currently aborting.
+        TimerWheel    _tsp_timers;    //!< Timers of the plugin, advanced once per packet batch.
 
         //!
         //! Constructor for subclasses.
@@ -144,7 +164,8 @@ namespace ts {
         TSP(bool verbose, int debug_level) :
             ReportInterface(verbose, debug_level),
             _tsp_bitrate(0),
-            _tsp_aborting(false)
+            _tsp_aborting(false),
+            _tsp_timers()
         {
         }
 
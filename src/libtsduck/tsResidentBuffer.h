@@ -38,19 +38,42 @@
 namespace ts {
     //!
     //! Implementation of memory buffer locked in physical memory.
+    //!
+    //! The buffer always starts on a memory page boundary and is consequently
+    //! aligned on cache lines and on any @a T element. On Linux, large buffers
+    //! can be allocated in huge pages to reduce TLB misses. When huge pages
+    //! cannot be allocated, the next smaller page size is used, down to the
+    //! standard memory pages. The actual page mode is returned by pageMode().
+    //!
     //! @tparam T Type of the buffer element.
     //!
     template <typename T = uint8_t>
     class ResidentBuffer
     {
     public:
+        //!
+        //! Type of memory pages for the buffer.
+        //! Huge pages are supported on Linux only.
+        //!
+        enum PageMode {
+            STANDARD_PAGES,          //!< Standard memory pages.
+            TRANSPARENT_HUGE_PAGES,  //!< Standard pages with advice to use transparent huge pages.
+            HUGE_PAGES_2MB,          //!< Explicit 2 MB huge pages (requires reserved huge pages).
+            HUGE_PAGES_1GB           //!< Explicit 1 GB huge pages (requires reserved huge pages).
+        };
+
         //!
         //! Constructor, based on required amount of elements.
         //! Abort application if memory allocation fails.
         //! Do not abort if memory locking fails.
         //! @param [in] elem_count Number of @a T elements.
+        //! @param [in] page_mode Preferred type of memory pages. When the allocation fails
+        //! with this mode, fallback to the next smaller page size.
+        //! @param [in] prefault If true, touch all memory pages during the construction
+        //! so that no page fault occurs later, even if locking failed. On NUMA systems,
+        //! the pages are physically allocated on the node of the current thread.
         //!
-        ResidentBuffer(size_t elem_count);
+        ResidentBuffer(size_t elem_count, PageMode page_mode = STANDARD_PAGES, bool prefault = false);
 
         //!
         //! Destructor.
@@ -75,6 +98,31 @@ namespace ts {
             return _error_code;
         }
 
+        //!
+        //! Get the type of memory pages which were actually allocated.
+        //! @return The actual page mode, after fallback.
+        //!
+        PageMode pageMode() const
+        {
+            return _page_mode;
+        }
+
+        //!
+        //! Check if the memory pages were pre-faulted.
+        //! @return True if all memory pages were touched during the construction.
+        //!
+        bool isPrefaulted() const
+        {
+            return _is_prefaulted;
+        }
+
+        //!
+        //! Get a displayable name for a page mode.
+        //! @param [in] page_mode Page mode.
+        //! @return A displayable name for @a page_mode.
+        //!
+        static std::string PageModeName(PageMode page_mode);
+
         //!
         //! Return base address of the buffer.
         //! @return The address of the first @a T element in the buffer.
@@ -99,13 +147,19 @@ namespace ts {
         ResidentBuffer(const ResidentBuffer&) = delete;
         ResidentBuffer& operator=(const ResidentBuffer&) = delete;
 
+        // Try to allocate the buffer in huge pages, return false if not possible.
+        bool allocateHugePages(PageMode page_mode, size_t requested_size);
+
         // Private members:
         char*     _allocated_base;   // First allocated address
         char*     _locked_base;      // First locked address (mlock, page boundary)
         T*        _base;             // Same as _locked_base with type T*
-        size_t    _allocated_size;   // Allocated size (ts_malloc)
+        size_t    _allocated_size;   // Allocated size (new or mmap)
         size_t    _locked_size;      // Locked size (mlock, multiple of page size)
         size_t    _elem_count;       // Element count in locked region
+        PageMode  _page_mode;        // Actual page mode
+        bool      _is_mapped;        // Allocated using mmap instead of new
+        bool      _is_prefaulted;    // All pages were touched
         bool      _is_locked;        // False if mlock failed.
         ErrorCode _error_code;       // Lock error code
     };
@@ -38,6 +38,12 @@
 #include "tsFatal.h"
 
 
+// Huge pages flags, not always defined in system headers.
+#if defined (__linux) && defined (MAP_HUGETLB) && !defined (MAP_HUGE_SHIFT)
+#define MAP_HUGE_SHIFT 26
+#endif
+
+
 //----------------------------------------------------------------------------
 // Constructor, based on required amount of T elements.
 // Abort application is memory allocation fails.
@@ -45,36 +51,57 @@
 //----------------------------------------------------------------------------
 
 template <typename T>
-ts::ResidentBuffer<T>::ResidentBuffer (size_t elem_count) :
+ts::ResidentBuffer<T>::ResidentBuffer (size_t elem_count, PageMode page_mode, bool prefault) :
     _allocated_base (0),
     _locked_base (0),
     _base (0),
     _allocated_size (0),
     _locked_size (0),
     _elem_count (elem_count),
+    _page_mode (STANDARD_PAGES),
+    _is_mapped (false),
+    _is_prefaulted (false),
     _is_locked (false),
     _error_code (SYS_SUCCESS)
 {
     const size_t requested_size (elem_count * sizeof(T));
     const size_t page_size (MemoryPageSize ());
 
-    // Allocate enough space to include memory pages around the requested size
+    // Try huge pages first, fallback to the next smaller page size.
+
+    for (PageMode mode = page_mode; mode != STANDARD_PAGES && !allocateHugePages (mode, requested_size); mode = PageMode (mode - 1)) {
+    }
+
+    if (!_is_mapped) {
 
-    _allocated_size = requested_size + 2 * page_size;
-    _allocated_base = new char [_allocated_size];
+        // Allocate enough space to include memory pages around the requested size
 
-    // Locked space starts at next page boundary after allocated base:
-    // Its size is the next multiple of page size after requested_size:
+        _allocated_size = requested_size + 2 * page_size;
+        _allocated_base = new char [_allocated_size];
 
-    _locked_base = (char*) (RoundUp (uint64_t (_allocated_base), uint64_t (page_size)));
-    _locked_size = RoundUp (requested_size, page_size);
+        // Locked space starts at next page boundary after allocated base:
+        // Its size is the next multiple of page size after requested_size:
+
+        _locked_base = (char*) (RoundUp (uint64_t (_allocated_base), uint64_t (page_size)));
+        _locked_size = RoundUp (requested_size, page_size);
+    }
+
+    // Touch all memory pages to force their physical allocation now.
+
+    if (prefault) {
+        volatile char* const base = _locked_base;
+        for (size_t offset = 0; offset < _locked_size; offset += page_size) {
+            base[offset] = 0;
+        }
+        _is_prefaulted = true;
+    }
 
     _base = new (_locked_base) T [elem_count];
 
     // Integrity checks
 
     assert (_allocated_base <= _locked_base);
-    assert (_locked_base < _allocated_base + page_size);
+    assert (_is_mapped || _locked_base < _allocated_base + page_size);
     assert (_locked_base + _locked_size <= _allocated_base + _allocated_size);
     assert (requested_size <= _locked_size);
     assert (_locked_size <= _allocated_size);
@@ -136,7 +163,16 @@ ts::ResidentBuffer<T>::~ResidentBuffer ()
 
     // Free memory
     if (_allocated_base != 0) {
+#if defined (__linux)
+        if (_is_mapped) {
+            ::munmap (_allocated_base, _allocated_size);
+        }
+        else {
+            delete [] _allocated_base;
+        }
+#else
         delete [] _allocated_base;
+#endif
     }
 
     // Reset state (it explicit call of destructor)
@@ -146,5 +182,82 @@ ts::ResidentBuffer<T>::~ResidentBuffer ()
     _allocated_size = 0;
     _locked_size = 0;
     _elem_count = 0;
+    _is_mapped = false;
     _is_locked = false;
 }
+
+
+//----------------------------------------------------------------------------
+// Try to allocate the buffer in huge pages, return false if not possible.
+//----------------------------------------------------------------------------
+
+template <typename T>
+bool ts::ResidentBuffer<T>::allocateHugePages (PageMode page_mode, size_t requested_size)
+{
+#if defined (__linux) && defined (MAP_HUGETLB) && defined (MADV_HUGEPAGE)
+
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    size_t huge_size = 2 * 1024 * 1024;
+
+    switch (page_mode) {
+        case HUGE_PAGES_1GB:
+            flags |= MAP_HUGETLB | (30 << MAP_HUGE_SHIFT);
+            huge_size = 1024 * 1024 * 1024;
+            break;
+        case HUGE_PAGES_2MB:
+            flags |= MAP_HUGETLB | (21 << MAP_HUGE_SHIFT);
+            break;
+        case TRANSPARENT_HUGE_PAGES:
+            break;
+        default:
+            return false;
+    }
+
+    // Explicit huge pages are always aligned. With transparent huge pages,
+    // map one more huge page to align the buffer on a huge page boundary.
+
+    const size_t size = RoundUp (requested_size, huge_size) + (page_mode == TRANSPARENT_HUGE_PAGES ? huge_size : 0);
+    void* const addr = size == 0 ? MAP_FAILED : ::mmap (0, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+    if (page_mode == TRANSPARENT_HUGE_PAGES && ::madvise (addr, size, MADV_HUGEPAGE) != 0) {
+        ::munmap (addr, size);
+        return false;
+    }
+
+    _allocated_base = reinterpret_cast<char*> (addr);
+    _allocated_size = size;
+    _locked_base = (char*) (RoundUp (uint64_t (_allocated_base), uint64_t (huge_size)));
+    _locked_size = RoundUp (requested_size, huge_size);
+    _page_mode = page_mode;
+    _is_mapped = true;
+    return true;
+
+#else
+    return false;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Get a displayable name for a page mode.
+//----------------------------------------------------------------------------
+
+template <typename T>
+std::string ts::ResidentBuffer<T>::PageModeName (PageMode page_mode)
+{
+    switch (page_mode) {
+        case STANDARD_PAGES:
+            return "standard pages";
+        case TRANSPARENT_HUGE_PAGES:
+            return "transparent huge pages";
+        case HUGE_PAGES_2MB:
+            return "2 MB huge pages";
+        case HUGE_PAGES_1GB:
+            return "1 GB huge pages";
+        default:
+            return "unknown pages";
+    }
+}
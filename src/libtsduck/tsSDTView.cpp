@@ -0,0 +1,123 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Read-only view of a Service Description Table (SDT)
+//
+//----------------------------------------------------------------------------
+
+#include "tsSDTView.h"
+#include "tsServiceDescriptor.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::SDTView::SDTView(const BinaryTable& table) :
+    AbstractTableView(table, 5, 3)
+{
+    validate(table.tableId() == TID_SDT_ACT || table.tableId() == TID_SDT_OTH);
+}
+
+
+//----------------------------------------------------------------------------
+// Locate the list of entries in a section.
+//----------------------------------------------------------------------------
+
+bool ts::SDTView::locateEntries(const Section& section, const uint8_t*& data, size_t& size) const
+{
+    // Skip original_network_id and one reserved byte.
+    data = section.payload() + 3;
+    size = section.payloadSize();
+    if (size < 3) {
+        return false;
+    }
+    size -= 3;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Access to the fixed part and services.
+//----------------------------------------------------------------------------
+
+uint16_t ts::SDTView::originalNetworkId() const
+{
+    size_t size = 0;
+    const uint8_t* data = firstPayload(size);
+    return data == 0 ? 0 : GetUInt16(data);
+}
+
+ts::SDTView::Service ts::SDTView::findService(uint16_t service_id) const
+{
+    for (const_iterator it = begin(); it != end(); ++it) {
+        if ((*it).serviceId() == service_id) {
+            return *it;
+        }
+    }
+    return Service();
+}
+
+
+//----------------------------------------------------------------------------
+// Service information, from the first service descriptor.
+// The other descriptors of the service are not decoded.
+//----------------------------------------------------------------------------
+
+bool ts::SDTView::Service::locateServiceDescriptor(ServiceDescriptor& sd, const DVBCharset* charset) const
+{
+    const DescriptorLoopView::Entry desc(descriptors().search(DID_SERVICE));
+    if (desc.isValid()) {
+        sd.deserialize(Descriptor(desc.content(), desc.size()), charset);
+        return sd.isValid();
+    }
+    else {
+        sd.invalidate();
+        return false;
+    }
+}
+
+uint8_t ts::SDTView::Service::serviceType() const
+{
+    ServiceDescriptor sd;
+    return locateServiceDescriptor(sd) ? sd.service_type : 0; // 0 is a "reserved" service_type value
+}
+
+ts::UString ts::SDTView::Service::providerName(const DVBCharset* charset) const
+{
+    ServiceDescriptor sd;
+    return locateServiceDescriptor(sd, charset) ? sd.provider_name : UString();
+}
+
+ts::UString ts::SDTView::Service::serviceName(const DVBCharset* charset) const
+{
+    ServiceDescriptor sd;
+    return locateServiceDescriptor(sd, charset) ? sd.service_name : UString();
+}
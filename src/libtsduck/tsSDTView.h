@@ -0,0 +1,197 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only view of a Service Description Table (SDT)
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsAbstractTableView.h"
+#include "tsDescriptorLoopView.h"
+#include "tsUString.h"
+
+namespace ts {
+
+    class DVBCharset;
+    class ServiceDescriptor;
+
+    //!
+    //! Read-only view of a Service Description Table (SDT).
+    //! @see AbstractTableView, SDT
+    //!
+    class TSDUCKDLL SDTView : public AbstractTableView
+    {
+    public:
+        //!
+        //! One service in the SDT.
+        //!
+        class TSDUCKDLL Service
+        {
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] data Address of the entry.
+            //! @param [in] size Size in bytes of the entry, including the descriptor loop.
+            //!
+            Service(const uint8_t* data = 0, size_t size = 0) : _data(data), _size(size) {}
+
+            //!
+            //! Check if this entry is valid.
+            //! @return True if this entry is valid.
+            //!
+            bool isValid() const {return _data != 0;}
+
+            //!
+            //! Get the service id.
+            //! @return The service id.
+            //!
+            uint16_t serviceId() const {return GetUInt16(_data);}
+
+            //!
+            //! Check if there are EIT schedule on current TS.
+            //! @return True if there are EIT schedule on current TS.
+            //!
+            bool EITsPresent() const {return (_data[2] & 0x02) != 0;}
+
+            //!
+            //! Check if there are EIT present/following on current TS.
+            //! @return True if there are EIT present/following on current TS.
+            //!
+            bool EITpfPresent() const {return (_data[2] & 0x01) != 0;}
+
+            //!
+            //! Get the running status.
+            //! @return The running status code.
+            //!
+            uint8_t runningStatus() const {return _data[3] >> 5;}
+
+            //!
+            //! Check if the service is controlled by a CA_system.
+            //! @return True if the service is controlled by a CA_system.
+            //!
+            bool CAControlled() const {return (_data[3] & 0x10) != 0;}
+
+            //!
+            //! Get the descriptor loop of the service.
+            //! @return A view of the descriptor loop.
+            //!
+            DescriptorLoopView descriptors() const {return DescriptorLoopView(_data + 5, _size - 5);}
+
+            //!
+            //! Get the service type.
+            //! Only the first DVB "service descriptor" is decoded.
+            //! @return The service type or zero if there is no service descriptor.
+            //!
+            uint8_t serviceType() const;
+
+            //!
+            //! Get the service name.
+            //! Only the first DVB "service descriptor" is decoded.
+            //! @param [in] charset If not zero, character set to use without explicit table code.
+            //! @return The service name or an empty string if there is no service descriptor.
+            //!
+            UString serviceName(const DVBCharset* charset = 0) const;
+
+            //!
+            //! Get the provider name.
+            //! Only the first DVB "service descriptor" is decoded.
+            //! @param [in] charset If not zero, character set to use without explicit table code.
+            //! @return The provider name or an empty string if there is no service descriptor.
+            //!
+            UString providerName(const DVBCharset* charset = 0) const;
+
+            //!
+            //! Decode the first DVB "service descriptor" of the service.
+            //! Use this method instead of serviceType(), serviceName() and providerName()
+            //! when several fields are needed, the descriptor is then decoded only once.
+            //! @param [out] desc The decoded service descriptor, invalidated if there is none.
+            //! @param [in] charset If not zero, character set to use without explicit table code.
+            //! @return True if a valid service descriptor was found, false otherwise.
+            //!
+            bool locateServiceDescriptor(ServiceDescriptor& desc, const DVBCharset* charset = 0) const;
+
+        private:
+            const uint8_t* _data;
+            size_t         _size;
+        };
+
+        //!
+        //! Iterator over the services of the SDT.
+        //!
+        typedef EntryIterator<Service> const_iterator;
+
+        //!
+        //! Constructor.
+        //! @param [in] table The binary table to view. Must remain valid as long as the view is used.
+        //!
+        SDTView(const BinaryTable& table);
+
+        //!
+        //! Check if this is an "actual" SDT.
+        //! @return True for SDT Actual TS, false for SDT Other TS.
+        //!
+        bool isActual() const {return tableId() == TID_SDT_ACT;}
+
+        //!
+        //! Get the transport stream id.
+        //! @return The transport stream id.
+        //!
+        uint16_t tsId() const {return tableIdExtension();}
+
+        //!
+        //! Get the original network id.
+        //! @return The original network id or zero if the view is invalid.
+        //!
+        uint16_t originalNetworkId() const;
+
+        //!
+        //! Get an iterator to the first service.
+        //! @return An iterator to the first service.
+        //!
+        const_iterator begin() const {return const_iterator(this);}
+
+        //!
+        //! Get an iterator after the last service.
+        //! @return An iterator after the last service.
+        //!
+        const_iterator end() const {return const_iterator();}
+
+        //!
+        //! Search a service by id.
+        //! @param [in] service_id The service id to search.
+        //! @return The first description of the service or an invalid entry if not found.
+        //!
+        Service findService(uint16_t service_id) const;
+
+    protected:
+        // Inherited methods
+        virtual bool locateEntries(const Section&, const uint8_t*&, size_t&) const override;
+    };
+}
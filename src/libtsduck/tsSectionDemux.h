@@ -90,6 +90,19 @@ namespace ts {
             _section_handler = h;
         }
 
+        //!
+        //! Set the index of the next packet to feed in the demux.
+        //! By default, the packets are counted by the demux. When the demux receives
+        //! only a subset of a transport stream, use this method before feeding each
+        //! packet to get packet indexes in the sections which are relative to the
+        //! complete stream.
+        //! @param [in] index Index of the next packet.
+        //!
+        void setPacketIndex(PacketCounter index)
+        {
+            _packet_count = index;
+        }
+
         //!
         //! Demux status information.
         //! It contains error counters.
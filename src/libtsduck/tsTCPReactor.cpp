@@ -0,0 +1,727 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Event-driven management of TCP servers and connections.
+//
+//----------------------------------------------------------------------------
+
+#include "tsTCPReactor.h"
+#include "tsSysUtils.h"
+#include "tsMemoryUtils.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+const size_t ts::TCPReactor::MAX_INPUT_SIZE;
+const ts::MilliSecond ts::TCPReactor::ACCEPT_RETRY_DELAY;
+const size_t ts::TCPReactor::RECEIVE_CHUNK_SIZE;
+const size_t ts::TCPReactor::RECEIVE_CHUNKS_PER_EVENT;
+const size_t ts::TCPReactor::MAX_EVENTS;
+#endif
+
+// Flags for sending data, avoid SIGPIPE when the peer has disconnected.
+#if defined(MSG_NOSIGNAL)
+#define TS_REACTOR_SEND_FLAGS MSG_NOSIGNAL
+#else
+#define TS_REACTOR_SEND_FLAGS 0
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructor and destructor.
+//----------------------------------------------------------------------------
+
+ts::TCPReactor::TCPReactor() :
+    _is_open(false),
+    _stopping(false),
+    _wake_read(-1),
+    _wake_write(-1),
+    _servers(),
+    _clients(),
+    _disconnected(),
+    _queued(),
+    _accept_failed(),
+    _accept_retry(Time::Epoch),
+#if defined(__linux)
+    _epoll(-1),
+#endif
+#if !defined(__windows)
+    _events()
+#endif
+{
+}
+
+ts::TCPReactor::~TCPReactor()
+{
+    close(NULLREP);
+}
+
+
+//----------------------------------------------------------------------------
+// Open the reactor.
+//----------------------------------------------------------------------------
+
+bool ts::TCPReactor::open(ReportInterface& report)
+{
+    if (_is_open) {
+        report.error("TCP reactor already open");
+        return false;
+    }
+
+#if defined(__windows)
+
+    report.error("TCP reactors are not supported on Windows");
+    return false;
+
+#else
+
+#if defined(__linux)
+    // Use an eventfd for wake-up and an epoll instance for events.
+    _epoll = ::epoll_create1(EPOLL_CLOEXEC);
+    if (_epoll < 0) {
+        report.error("error creating epoll instance: " + ErrorCodeMessage());
+        return false;
+    }
+    _wake_read = _wake_write = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (_wake_read < 0) {
+        report.error("error creating eventfd: " + ErrorCodeMessage());
+        ::close(_epoll);
+        _epoll = _wake_read = _wake_write = -1;
+        return false;
+    }
+    ::epoll_event ev;
+    TS_ZERO(ev);
+    ev.events = EPOLLIN;
+    ev.data.fd = _wake_read;
+    if (::epoll_ctl(_epoll, EPOLL_CTL_ADD, _wake_read, &ev) != 0) {
+        report.error("error adding eventfd in epoll: " + ErrorCodeMessage());
+        ::close(_wake_read);
+        ::close(_epoll);
+        _epoll = _wake_read = _wake_write = -1;
+        return false;
+    }
+    _events.resize(MAX_EVENTS);
+#else
+    // Use a pipe for wake-up.
+    int fds[2];
+    if (::pipe(fds) != 0) {
+        report.error("error creating pipe: " + ErrorCodeMessage());
+        return false;
+    }
+    _wake_read = fds[0];
+    _wake_write = fds[1];
+    ::fcntl(_wake_read, F_SETFL, ::fcntl(_wake_read, F_GETFL) | O_NONBLOCK);
+    ::fcntl(_wake_write, F_SETFL, ::fcntl(_wake_write, F_GETFL) | O_NONBLOCK);
+    _events.clear();
+#endif
+
+    _is_open = true;
+    _stopping = false;
+    return true;
+
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Close the reactor.
+//----------------------------------------------------------------------------
+
+bool ts::TCPReactor::close(ReportInterface& report)
+{
+    if (!_is_open) {
+        return true;
+    }
+
+    // Disconnect all clients.
+    for (ClientMap::iterator it = _clients.begin(); it != _clients.end(); ++it) {
+        markDisconnected(*it->second);
+    }
+    removeDisconnected(report);
+    _servers.clear();
+    _accept_failed.clear();
+
+#if !defined(__windows)
+    if (_wake_write >= 0 && _wake_write != _wake_read) {
+        ::close(_wake_write);
+    }
+    if (_wake_read >= 0) {
+        ::close(_wake_read);
+    }
+#endif
+#if defined(__linux)
+    if (_epoll >= 0) {
+        ::close(_epoll);
+    }
+    _epoll = -1;
+#endif
+
+    _wake_read = _wake_write = -1;
+    _is_open = false;
+    return true;
+}
+
+bool ts::TCPReactor::isOpen() const
+{
+    return _is_open;
+}
+
+
+//----------------------------------------------------------------------------
+// Start and stop monitoring a socket.
+//----------------------------------------------------------------------------
+
+bool ts::TCPReactor::addSocket(TS_SOCKET_T sock, bool server, ReportInterface& report)
+{
+#if defined(__linux)
+    // Edge-triggered notification. Input and output are always monitored,
+    // we are notified only when the state changes.
+    ::epoll_event ev;
+    TS_ZERO(ev);
+    ev.data.fd = sock;
+    if (server) {
+        ev.events = EPOLLIN | EPOLLET;
+#if defined(EPOLLEXCLUSIVE)
+        // When several reactors share a server, wake up only one of them.
+        ev.events |= EPOLLEXCLUSIVE;
+#endif
+    }
+    else {
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    }
+    if (::epoll_ctl(_epoll, EPOLL_CTL_ADD, sock, &ev) != 0) {
+        report.error("error adding socket in epoll: " + ErrorCodeMessage());
+        return false;
+    }
+#endif
+    // With poll(), the list of sockets is rebuilt before each wait.
+    return true;
+}
+
+void ts::TCPReactor::removeSocket(TS_SOCKET_T sock)
+{
+#if defined(__linux)
+    ::epoll_event ev;
+    TS_ZERO(ev);
+    ::epoll_ctl(_epoll, EPOLL_CTL_DEL, sock, &ev);
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Add a TCP server in the reactor.
+//----------------------------------------------------------------------------
+
+bool ts::TCPReactor::addServer(TCPServer& server, TCPReactorHandlerInterface* handler, ReportInterface& report)
+{
+    if (!_is_open) {
+        report.error("TCP reactor not open");
+        return false;
+    }
+    if (!server.isOpen()) {
+        report.error("TCP server not open");
+        return false;
+    }
+
+    const TS_SOCKET_T sock = server.getSocket();
+    if (_servers.find(sock) != _servers.end()) {
+        report.error("TCP server already in reactor");
+        return false;
+    }
+    if (!server.setNonBlocking(true, report) || !addSocket(sock, true, report)) {
+        return false;
+    }
+
+    Server& srv(_servers[sock]);
+    srv.server = &server;
+    srv.handler = handler;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Add a connected TCP connection in the reactor.
+//----------------------------------------------------------------------------
+
+bool ts::TCPReactor::addConnection(const TCPConnectionPtrMT& connection, TCPReactorHandlerInterface* handler, ReportInterface& report)
+{
+    if (!_is_open) {
+        report.error("TCP reactor not open");
+        return false;
+    }
+    if (connection.isNull() || !connection->isConnected()) {
+        report.error("TCP connection not connected");
+        return false;
+    }
+
+    const TS_SOCKET_T sock = connection->getSocket();
+    if (_clients.find(sock) != _clients.end()) {
+        report.error("TCP connection already in reactor");
+        return false;
+    }
+    if (!connection->setNonBlocking(true, report) || !addSocket(sock, false, report)) {
+        return false;
+    }
+
+    const ClientPtr client(new Client(connection, handler));
+    _clients[sock] = client;
+    if (handler != 0) {
+        handler->handleConnected(*this, *connection);
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Accept all pending clients on a server.
+//----------------------------------------------------------------------------
+
+void ts::TCPReactor::acceptClients(TS_SOCKET_T sock, const Server& server, ReportInterface& report)
+{
+    // With edge-triggered notification, we must accept until there is no more pending client.
+    // Without pending client, the non-blocking accept() fails with "would block".
+    for (;;) {
+        TCPConnectionPtrMT conn;
+        SocketAddress addr;
+        SocketErrorCode err_code = 0;
+        if (server.server->acceptPending(conn, addr, err_code, report)) {
+            if (!addConnection(conn, server.handler, report)) {
+                conn->disconnect(NULLREP);
+                conn->close(NULLREP);
+            }
+        }
+        else if (err_code == TS_SOCKET_ERR_WOULDBLOCK) {
+            // No more pending client.
+            break;
+        }
+        else if (err_code == EINTR || err_code == ECONNABORTED) {
+            // Interrupted or a client which aborted before being accepted, other clients may be pending.
+            continue;
+        }
+        else {
+            // Typically too many open files. Other clients may remain pending in the backlog
+            // but no new notification will come for them. Poll the server again later.
+            if (server.server->isOpen()) {
+                report.error("error accepting TCP client: " + SocketErrorCodeMessage(err_code));
+            }
+            if (std::find(_accept_failed.begin(), _accept_failed.end(), sock) == _accept_failed.end()) {
+                _accept_failed.push_back(sock);
+            }
+            _accept_retry = Time::CurrentUTC() + ACCEPT_RETRY_DELAY;
+            break;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Receive available data on a connection.
+//----------------------------------------------------------------------------
+
+void ts::TCPReactor::receiveData(Client& client, ReportInterface& report)
+{
+    // With edge-triggered notification, we are notified only once and we must read
+    // until the socket would block. To keep fairness between connections, we read a
+    // limited number of chunks and the connection is requeued if more data may be pending.
+    // The received data are delivered to the handler after each chunk. Thus, all data
+    // which were received before the peer closed the connection are delivered.
+    bool peer_closed = false;
+    bool would_block = false;
+    size_t chunks = 0;
+
+    while (!peer_closed && !would_block && !client.disconnecting && chunks < RECEIVE_CHUNKS_PER_EVENT) {
+        if (client.input_size >= MAX_INPUT_SIZE) {
+            report.error("TCP connection input buffer overflow, received data are not consumed");
+            markDisconnected(client);
+            break;
+        }
+        const size_t max_size = std::min(RECEIVE_CHUNK_SIZE, MAX_INPUT_SIZE - client.input_size);
+        if (client.input.size() < client.input_size + max_size) {
+            client.input.resize(client.input_size + max_size);
+        }
+        const TS_SOCKET_SSIZE_T got = ::recv(client.sock, TS_RECVBUF_T(&client.input[client.input_size]), int(max_size), 0);
+        const SocketErrorCode err_code = LastSocketErrorCode();
+        if (got > 0) {
+            client.input_size += size_t(got);
+            chunks++;
+            deliverData(client);
+        }
+        else if (got == 0 || err_code == TS_SOCKET_ERR_RESET) {
+            // End of connection (graceful or aborted). Not an error.
+            peer_closed = true;
+        }
+        else if (err_code == TS_SOCKET_ERR_WOULDBLOCK) {
+            would_block = true;
+        }
+#if !defined(__windows)
+        else if (err_code == EINTR) {
+            report.debug("recv() interrupted by signal, retrying");
+        }
+#endif
+        else {
+            report.error("error receiving data from socket: " + SocketErrorCodeMessage(err_code));
+            peer_closed = true;
+        }
+    }
+
+    if (peer_closed) {
+        markDisconnected(client);
+    }
+    else if (!would_block && !client.disconnecting && !client.queued) {
+        // Read budget exhausted, process this connection again after the others.
+        client.queued = true;
+        _queued.push_back(client.sock);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Pass received data to the handler until it consumes nothing.
+//----------------------------------------------------------------------------
+
+void ts::TCPReactor::deliverData(Client& client)
+{
+    if (client.handler == 0) {
+        // Without handler, received data are dropped.
+        client.input_size = 0;
+        return;
+    }
+
+    size_t start = 0;
+    while (start < client.input_size && !client.disconnecting) {
+        const size_t size = client.input_size - start;
+        const size_t consumed = client.handler->handleReceived(*this, *client.connection, &client.input[start], size);
+        if (consumed == 0) {
+            break;
+        }
+        start += std::min(consumed, size);
+    }
+    if (start > 0) {
+        // Move unconsumed data at beginning of buffer.
+        client.input_size -= start;
+        if (client.input_size > 0) {
+            ::memmove(&client.input[0], &client.input[start], client.input_size);
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Send as much buffered output data as possible on a connection.
+//----------------------------------------------------------------------------
+
+bool ts::TCPReactor::sendData(Client& client, ReportInterface& report)
+{
+    while (client.output_start < client.output.size()) {
+        const TS_SOCKET_SSIZE_T gone = ::send(client.sock, TS_SENDBUF_T(&client.output[client.output_start]), int(client.output.size() - client.output_start), TS_REACTOR_SEND_FLAGS);
+        const SocketErrorCode err_code = LastSocketErrorCode();
+        if (gone > 0) {
+            client.output_start += size_t(gone);
+        }
+        else if (gone < 0 && err_code == TS_SOCKET_ERR_WOULDBLOCK) {
+            // Socket buffer full, will resume on next output notification.
+            return true;
+        }
+#if !defined(__windows)
+        else if (gone < 0 && err_code == EINTR) {
+            report.debug("send() interrupted by signal, retrying");
+        }
+#endif
+        else {
+            report.error("error sending data to socket: " + SocketErrorCodeMessage(err_code));
+            markDisconnected(client);
+            return false;
+        }
+    }
+
+    // Everything was sent.
+    client.output.clear();
+    client.output_start = 0;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Send data on a connection of the reactor.
+//----------------------------------------------------------------------------
+
+bool ts::TCPReactor::send(TCPConnection& connection, const void* data, size_t size, ReportInterface& report)
+{
+    const ClientMap::iterator it = _clients.find(connection.getSocket());
+    if (it == _clients.end() || it->second->disconnecting) {
+        report.error("TCP connection not active in reactor");
+        return false;
+    }
+    Client& client(*it->second);
+
+    // Drop already sent data at beginning of output buffer.
+    if (client.output_start > 0) {
+        client.output.erase(0, client.output_start);
+        client.output_start = 0;
+    }
+
+    // Queue the data and send as much as possible.
+    client.output.append(data, size);
+    return sendData(client, report);
+}
+
+
+//----------------------------------------------------------------------------
+// Disconnect and close a connection of the reactor.
+//----------------------------------------------------------------------------
+
+void ts::TCPReactor::disconnect(TCPConnection& connection)
+{
+    const ClientMap::iterator it = _clients.find(connection.getSocket());
+    if (it != _clients.end()) {
+        markDisconnected(*it->second);
+    }
+}
+
+void ts::TCPReactor::markDisconnected(Client& client)
+{
+    if (!client.disconnecting) {
+        client.disconnecting = true;
+        _disconnected.push_back(client.sock);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Remove connections which were marked as disconnected.
+//----------------------------------------------------------------------------
+
+void ts::TCPReactor::removeDisconnected(ReportInterface& report)
+{
+    // The sockets are closed after processing all events of a wait. Thus, a
+    // socket descriptor cannot be reused by a new connection in the meantime.
+    for (size_t i = 0; i < _disconnected.size(); ++i) {
+        const ClientMap::iterator it = _clients.find(_disconnected[i]);
+        if (it != _clients.end()) {
+            if (it->second->queued) {
+                _queued.erase(std::remove(_queued.begin(), _queued.end(), it->first), _queued.end());
+            }
+            const ClientPtr client(it->second);
+            _clients.erase(it);
+            removeSocket(client->sock);
+            if (client->handler != 0) {
+                client->handler->handleDisconnected(*this, *client->connection);
+            }
+            client->connection->disconnect(NULLREP);
+            client->connection->close(report);
+        }
+    }
+    _disconnected.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Wait for events and process them, once.
+//----------------------------------------------------------------------------
+
+bool ts::TCPReactor::processEvents(MilliSecond timeout, ReportInterface& report)
+{
+    if (!_is_open) {
+        report.error("TCP reactor not open");
+        return false;
+    }
+
+    // Connections which were disconnected outside event processing.
+    removeDisconnected(report);
+
+#if defined(__windows)
+
+    return false;
+
+#else
+
+    // Do not wait when some connections have pending input. These connections are processed
+    // after the events of this wait. Connections which are requeued during this call are
+    // processed in the next call, after the events of the next wait.
+    // When servers failed to accept clients, do not wait after the time to poll them again.
+    if (!_accept_failed.empty()) {
+        const MilliSecond retry = std::max<MilliSecond>(0, _accept_retry - Time::CurrentUTC());
+        timeout = timeout == Infinite ? retry : std::min(timeout, retry);
+    }
+    const int wait_ms = !_queued.empty() ? 0 : (timeout == Infinite ? -1 : int(std::min<MilliSecond>(timeout, std::numeric_limits<int>::max())));
+    std::vector<TS_SOCKET_T> queued;
+    queued.swap(_queued);
+
+#if defined(__linux)
+
+    const int count = ::epoll_wait(_epoll, &_events[0], int(_events.size()), wait_ms);
+    if (count < 0) {
+        if (errno == EINTR) {
+            return true;
+        }
+        report.error("error waiting for epoll events: " + ErrorCodeMessage());
+        return false;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        const int fd = _events[i].data.fd;
+        const uint32_t ev = _events[i].events;
+
+#else
+
+    // Rebuild the list of monitored sockets. Output is monitored only when data are pending.
+    _events.resize(1 + _servers.size() + _clients.size());
+    size_t index = 0;
+    _events[index].fd = _wake_read;
+    _events[index].events = POLLIN;
+    _events[index++].revents = 0;
+    for (ServerMap::const_iterator it = _servers.begin(); it != _servers.end(); ++it) {
+        // Servers which failed to accept clients are polled again later, avoid looping on the error.
+        _events[index].fd = it->first;
+        _events[index].events = std::find(_accept_failed.begin(), _accept_failed.end(), it->first) == _accept_failed.end() ? POLLIN : 0;
+        _events[index++].revents = 0;
+    }
+    for (ClientMap::const_iterator it = _clients.begin(); it != _clients.end(); ++it) {
+        _events[index].fd = it->first;
+        _events[index].events = it->second->output_start < it->second->output.size() ? (POLLIN | POLLOUT) : POLLIN;
+        _events[index++].revents = 0;
+    }
+
+    const int count = ::poll(&_events[0], ::nfds_t(_events.size()), wait_ms);
+    if (count < 0) {
+        if (errno == EINTR) {
+            return true;
+        }
+        report.error("error polling sockets: " + ErrorCodeMessage());
+        return false;
+    }
+
+    for (size_t i = 0; count > 0 && i < _events.size(); ++i) {
+        const int fd = _events[i].fd;
+        const short ev = _events[i].revents;
+        if (ev == 0) {
+            continue;
+        }
+
+#endif
+
+        if (fd == _wake_read) {
+            // Drain the wake-up descriptor.
+            uint8_t buf[64];
+            while (::read(_wake_read, buf, sizeof(buf)) > 0) {
+            }
+            continue;
+        }
+
+        // Pending clients on a server.
+        const ServerMap::const_iterator srv = _servers.find(fd);
+        if (srv != _servers.end()) {
+            acceptClients(fd, srv->second, report);
+            continue;
+        }
+
+        // Events on a connection.
+        const ClientMap::iterator cli = _clients.find(fd);
+        if (cli == _clients.end() || cli->second->disconnecting) {
+            continue;
+        }
+        const ClientPtr client(cli->second);
+
+#if defined(__linux)
+        const bool input = (ev & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0;
+        const bool output = (ev & EPOLLOUT) != 0;
+#else
+        const bool input = (ev & (POLLIN | POLLHUP | POLLERR)) != 0;
+        const bool output = (ev & POLLOUT) != 0;
+#endif
+        // Errors and hang-up are detected when reading.
+        if (output && !client->disconnecting) {
+            sendData(*client, report);
+        }
+        if (input && !client->disconnecting && !client->queued) {
+            receiveData(*client, report);
+        }
+    }
+
+    // Continue reading on connections which were requeued in a previous call.
+    for (size_t i = 0; i < queued.size(); ++i) {
+        const ClientMap::iterator cli = _clients.find(queued[i]);
+        if (cli != _clients.end()) {
+            const ClientPtr client(cli->second);
+            client->queued = false;
+            if (!client->disconnecting) {
+                receiveData(*client, report);
+            }
+        }
+    }
+
+    // Poll again the servers which failed to accept clients.
+    if (!_accept_failed.empty() && Time::CurrentUTC() >= _accept_retry) {
+        std::vector<TS_SOCKET_T> failed;
+        failed.swap(_accept_failed);
+        for (size_t i = 0; i < failed.size(); ++i) {
+            const ServerMap::const_iterator srv = _servers.find(failed[i]);
+            if (srv != _servers.end()) {
+                acceptClients(srv->first, srv->second, report);
+            }
+        }
+    }
+
+    // Close disconnected sockets after processing all events.
+    removeDisconnected(report);
+    return true;
+
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Process events until stop() is invoked.
+//----------------------------------------------------------------------------
+
+bool ts::TCPReactor::run(ReportInterface& report)
+{
+    while (!_stopping) {
+        if (!processEvents(Infinite, report)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Stop the execution of run(), from any thread.
+//----------------------------------------------------------------------------
+
+void ts::TCPReactor::stop()
+{
+    _stopping = true;
+#if !defined(__windows)
+    if (_wake_write >= 0) {
+        // An eventfd requires 8 bytes, a pipe accepts anything.
+        const uint64_t one = 1;
+        TS_UNUSED const ::ssize_t ret = ::write(_wake_write, &one, sizeof(one));
+    }
+#endif
+}
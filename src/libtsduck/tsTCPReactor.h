@@ -0,0 +1,257 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Event-driven management of TCP servers and connections.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTCPReactorHandlerInterface.h"
+#include "tsTCPServer.h"
+#include "tsByteBlock.h"
+#include "tsTime.h"
+
+namespace ts {
+    //!
+    //! Event-driven management of TCP servers and connections.
+    //!
+    //! A reactor monitors many TCP servers and connections from one single thread.
+    //! All sockets are switched to non-blocking mode. When a server has pending
+    //! clients, the reactor accepts them. When data are received on a connection,
+    //! they are accumulated in a buffer of the connection and passed to a handler
+    //! (see TCPReactorHandlerInterface). Outgoing data are sent immediately as much
+    //! as possible, the rest is buffered and sent when the socket is ready again.
+    //!
+    //! To keep fairness between connections, a limited amount of data is read on a
+    //! connection at a time. When more data are pending, the connection is processed
+    //! again after the other connections. The input buffer of a connection is limited
+    //! to MAX_INPUT_SIZE bytes. A connection is disconnected when its buffer is full
+    //! and the handler does not consume any data. When a server fails to accept
+    //! clients for a reason other than the absence of pending client (typically
+    //! too many open files), the error is reported and the server is polled again
+    //! after ACCEPT_RETRY_DELAY milliseconds.
+    //!
+    //! On Linux, the reactor uses epoll() in edge-triggered mode. On other UNIX
+    //! systems, it uses poll(). Reactors are not available on Windows.
+    //!
+    //! Except stop(), the methods of a reactor shall be called from the thread
+    //! which runs the reactor, either from the handlers or before running the
+    //! reactor. To use several threads, run several reactors in distinct threads.
+    //! Several reactors can share the same TCP server, the clients are accepted
+    //! by the first available reactor.
+    //!
+    class TSDUCKDLL TCPReactor
+    {
+    public:
+        //!
+        //! Maximum size in bytes of received data which are not yet consumed by the handler of a connection.
+        //!
+        static const size_t MAX_INPUT_SIZE = 1024 * 1024;
+
+        //! Delay in milliseconds before accepting clients again on a server after an accept error.
+        static const MilliSecond ACCEPT_RETRY_DELAY = 100;
+
+        //!
+        //! Constructor.
+        //!
+        TCPReactor();
+
+        //!
+        //! Destructor.
+        //! All connections are closed.
+        //!
+        ~TCPReactor();
+
+        //!
+        //! Open the reactor.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool open(ReportInterface& report = CERR);
+
+        //!
+        //! Close the reactor.
+        //! All connections are closed. The servers are removed from the reactor but not closed.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool close(ReportInterface& report = CERR);
+
+        //!
+        //! Check if the reactor is open.
+        //! @return True if the reactor is open.
+        //!
+        bool isOpen() const;
+
+        //!
+        //! Add a TCP server in the reactor.
+        //! The server shall be listening. It is switched to non-blocking mode.
+        //! @param [in,out] server The server. It must remain valid while the reactor is open.
+        //! @param [in] handler Handler of all connections from this server.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool addServer(TCPServer& server, TCPReactorHandlerInterface* handler, ReportInterface& report = CERR);
+
+        //!
+        //! Add a connected TCP connection in the reactor.
+        //! It is switched to non-blocking mode.
+        //! @param [in] connection The connection. The reactor keeps a reference to it
+        //! until it is disconnected.
+        //! @param [in] handler Handler of this connection.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool addConnection(const TCPConnectionPtrMT& connection, TCPReactorHandlerInterface* handler, ReportInterface& report = CERR);
+
+        //!
+        //! Send data on a connection of the reactor.
+        //! The data are sent immediately as much as possible. The rest is buffered
+        //! and later sent by the reactor. This method never blocks.
+        //! @param [in,out] connection The connection.
+        //! @param [in] data Address of data to send.
+        //! @param [in] size Size in bytes of data to send.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error. In case of error, the
+        //! connection will be disconnected.
+        //!
+        bool send(TCPConnection& connection, const void* data, size_t size, ReportInterface& report = CERR);
+
+        //!
+        //! Disconnect and close a connection of the reactor.
+        //! The handler is notified and the connection is removed from the reactor.
+        //! When invoked from a handler, the connection is removed after the handler returns.
+        //! @param [in,out] connection The connection.
+        //!
+        void disconnect(TCPConnection& connection);
+
+        //!
+        //! Get the number of connections in the reactor.
+        //! @return The number of connections in the reactor.
+        //!
+        size_t connectionCount() const {return _clients.size();}
+
+        //!
+        //! Wait for events and process them, once.
+        //! @param [in] timeout Maximum number of milliseconds to wait for events.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool processEvents(MilliSecond timeout, ReportInterface& report = CERR);
+
+        //!
+        //! Process events until stop() is invoked.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool run(ReportInterface& report = CERR);
+
+        //!
+        //! Stop the execution of run().
+        //! This method may be invoked from any thread.
+        //!
+        void stop();
+
+    private:
+        // Size of reception chunks.
+        static const size_t RECEIVE_CHUNK_SIZE = 16 * 1024;
+
+        // Maximum number of reception chunks on a connection before processing other connections.
+        static const size_t RECEIVE_CHUNKS_PER_EVENT = 4;
+
+        // Maximum number of events per wait.
+        static const size_t MAX_EVENTS = 256;
+
+        // Description of a server.
+        struct Server
+        {
+            TCPServer*                  server;
+            TCPReactorHandlerInterface* handler;
+        };
+        typedef std::map<TS_SOCKET_T, Server> ServerMap;
+
+        // Description of a connection.
+        struct Client
+        {
+            TCPConnectionPtrMT          connection;
+            TS_SOCKET_T                 sock;
+            TCPReactorHandlerInterface* handler;
+            ByteBlock                   input;         // received data, first input_size bytes are valid
+            size_t                      input_size;
+            ByteBlock                   output;        // data to send, starting at output_start
+            size_t                      output_start;
+            bool                        disconnecting; // disconnection pending
+            bool                        queued;        // in the list of connections with pending input
+            Client(const TCPConnectionPtrMT& conn, TCPReactorHandlerInterface* hdl) :
+                connection(conn), sock(conn->getSocket()), handler(hdl), input(), input_size(0), output(), output_start(0), disconnecting(false), queued(false) {}
+        private:
+            Client(const Client&) = delete;
+            Client& operator=(const Client&) = delete;
+        };
+        typedef SafePtr<Client, NullMutex> ClientPtr;
+        typedef std::map<TS_SOCKET_T, ClientPtr> ClientMap;
+
+        // Private members.
+        bool          _is_open;        // the reactor is open
+        volatile bool _stopping;       // stop() was invoked
+        int           _wake_read;      // descriptor to wait for wake-up
+        int           _wake_write;     // descriptor to send wake-up
+        ServerMap     _servers;        // all servers
+        ClientMap     _clients;        // all connections
+        std::vector<TS_SOCKET_T> _disconnected; // connections to remove
+        std::vector<TS_SOCKET_T> _queued;       // connections with pending input, to process again
+        std::vector<TS_SOCKET_T> _accept_failed; // servers to poll again after an accept error
+        Time          _accept_retry;   // when to poll again the servers after an accept error
+#if defined(__linux)
+        int           _epoll;          // epoll file descriptor
+        std::vector<::epoll_event> _events;
+#elif !defined(__windows)
+        std::vector<::pollfd> _events;
+#endif
+
+        // Start and stop monitoring a socket.
+        bool addSocket(TS_SOCKET_T sock, bool server, ReportInterface& report);
+        void removeSocket(TS_SOCKET_T sock);
+
+        // Process events on sockets.
+        void acceptClients(TS_SOCKET_T sock, const Server& server, ReportInterface& report);
+        void receiveData(Client& client, ReportInterface& report);
+        void deliverData(Client& client);
+        bool sendData(Client& client, ReportInterface& report);
+        void markDisconnected(Client& client);
+
+        // Remove connections which were marked as disconnected.
+        void removeDisconnected(ReportInterface& report);
+
+        // Unreachable operations
+        TCPReactor(const TCPReactor&) = delete;
+        TCPReactor& operator=(const TCPReactor&) = delete;
+    };
+}
@@ -0,0 +1,86 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Interface to be notified of events on connections managed by a TCPReactor.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTCPConnection.h"
+
+namespace ts {
+
+    class TCPReactor;
+
+    //!
+    //! Interface for classes which handle the TCP connections of a TCPReactor.
+    //!
+    //! All methods are invoked in the context of the thread which runs the reactor.
+    //! They shall not block. They may use the reactor to send data or close connections.
+    //!
+    class TSDUCKDLL TCPReactorHandlerInterface
+    {
+    public:
+        //!
+        //! This hook is invoked when a connection is added in the reactor.
+        //! This is either a client connection which was accepted on a server or
+        //! a connection which was explicitly added in the reactor.
+        //! @param [in,out] reactor The reactor which manages the connection.
+        //! @param [in,out] connection The new connection.
+        //!
+        virtual void handleConnected(TCPReactor& reactor, TCPConnection& connection) = 0;
+
+        //!
+        //! This hook is invoked when data are received on a connection.
+        //! @param [in,out] reactor The reactor which manages the connection.
+        //! @param [in,out] connection The connection.
+        //! @param [in] data Address of all received data which were not yet consumed.
+        //! @param [in] size Size in bytes of received data.
+        //! @return Number of bytes which were consumed by the handler, at the beginning
+        //! of @a data. The unconsumed bytes are presented again, followed by the next
+        //! received data. Typically, a handler consumes complete messages only.
+        //!
+        virtual size_t handleReceived(TCPReactor& reactor, TCPConnection& connection, const uint8_t* data, size_t size) = 0;
+
+        //!
+        //! This hook is invoked when a connection is about to be removed from the reactor.
+        //! This is either a disconnection from the peer, an error or an explicit call
+        //! to TCPReactor::disconnect().
+        //! @param [in,out] reactor The reactor which manages the connection.
+        //! @param [in,out] connection The connection. It is closed after this hook.
+        //!
+        virtual void handleDisconnected(TCPReactor& reactor, TCPConnection& connection) = 0;
+
+        //!
+        //! Virtual destructor.
+        //!
+        virtual ~TCPReactorHandlerInterface() {}
+    };
+}
@@ -76,9 +76,14 @@ bool ts::TCPServer::accept (TCPConnection& client, SocketAddress& client_address
     TS_SOCKET_T client_sock = ::accept (getSocket(), &sock_addr, &len);
 
     if (client_sock == TS_SOCKET_T_INVALID) {
+        const SocketErrorCode err_code = LastSocketErrorCode();
         Guard lock (_mutex);
-        if (isOpen()) {
-            report.error ("error accepting TCP client: " + SocketErrorCodeMessage ());
+        if (err_code == TS_SOCKET_ERR_WOULDBLOCK) {
+            // Non-blocking server without pending client, not an error.
+            report.debug ("no pending client on server");
+        }
+        else if (isOpen()) {
+            report.error ("error accepting TCP client: " + SocketErrorCodeMessage (err_code));
         }
         return false;
     }
@@ -92,6 +97,35 @@ bool ts::TCPServer::accept (TCPConnection& client, SocketAddress& client_address
 }
 
 
+//----------------------------------------------------------------------------
+// Accept a pending client on a non-blocking server
+//----------------------------------------------------------------------------
+
+bool ts::TCPServer::acceptPending(TCPConnectionPtrMT& client, SocketAddress& client_address, SocketErrorCode& error, ReportInterface& report)
+{
+    client.clear();
+    error = 0;
+
+    ::sockaddr sock_addr;
+    TS_SOCKET_SOCKLEN_T len = sizeof(sock_addr);
+    TS_ZERO(sock_addr);
+    const TS_SOCKET_T client_sock = ::accept(getSocket(), &sock_addr, &len);
+
+    if (client_sock == TS_SOCKET_T_INVALID) {
+        error = LastSocketErrorCode();
+        return false;
+    }
+
+    client_address = SocketAddress(sock_addr);
+    report.debug("received connection from " + std::string(client_address));
+
+    client = new TCPConnection;
+    client->declareOpened(client_sock, report);
+    client->declareConnected(report);
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Inherited and overridden
 //----------------------------------------------------------------------------
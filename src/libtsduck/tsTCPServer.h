@@ -106,12 +106,30 @@ namespace ts {
         //! @param [out] addr This object receives the socket address of the client.
         //! If the server wants to filter client connections based on their IP address,
         //! it may use @a addr for that.
-        //! @param [in,out] report Where to report error.
-        //! @return True on success, false on error.
+        //! @param [in,out] report Where to report error. In non-blocking mode, the absence
+        //! of pending client is not reported as an error.
+        //! @return True on success, false on error or, in non-blocking mode, when there
+        //! is no pending client.
         //! @see listen()
         //!
         bool accept(TCPConnection& client, SocketAddress& addr, ReportInterface& report = CERR);
 
+        //!
+        //! Accept a pending client connection on a non-blocking server.
+        //!
+        //! Unlike accept(), the connection object is allocated only when a client is
+        //! accepted and the socket error is not reported but returned to the caller,
+        //! which decides how to handle it.
+        //!
+        //! @param [out] client Receives a new connected TCP session. Null when no client is accepted.
+        //! @param [out] addr This object receives the socket address of the client.
+        //! @param [out] error Receives the system error code when no client is accepted.
+        //! It is TS_SOCKET_ERR_WOULDBLOCK when there is no pending client.
+        //! @param [in,out] report Where to report debug messages.
+        //! @return True when a client is accepted, false otherwise.
+        //!
+        bool acceptPending(TCPConnectionPtrMT& client, SocketAddress& addr, SocketErrorCode& error, ReportInterface& report = CERR);
+
         // Inherited and overridden
         virtual bool close(ReportInterface& report = CERR);
 
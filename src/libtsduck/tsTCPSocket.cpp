@@ -226,6 +226,22 @@ bool ts::TCPSocket::setNoDelay (bool active, ReportInterface& report)
 }
 
 
+bool ts::TCPSocket::setNonBlocking (bool active, ReportInterface& report)
+{
+#if defined(__windows)
+    ::u_long mode = ::u_long (active); // Actual ioctl parameter is an u_long.
+#else
+    int mode = int (active); // Actual ioctl parameter is an int.
+#endif
+    report.debug ("setting socket non-blocking mode to " + Decimal (int (active)));
+    if (TS_SOCKET_IOCTL (_sock, FIONBIO, &mode) != 0) {
+        report.error ("error setting socket non-blocking mode: " + SocketErrorCodeMessage ());
+        return false;
+    }
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Bind to a local address and port.
 //----------------------------------------------------------------------------
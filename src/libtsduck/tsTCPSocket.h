@@ -157,6 +157,17 @@ namespace ts {
         //!
         bool setNoDelay(bool active, ReportInterface& report = CERR);
 
+        //!
+        //! Set the "non-blocking" mode.
+        //! @param [in] active If true, the I/O operations on the socket never block.
+        //! When an operation cannot be immediately performed, it fails with the error
+        //! code TS_SOCKET_ERR_WOULDBLOCK. This mode is used with event-driven I/O.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //! @see TCPReactor
+        //!
+        bool setNonBlocking(bool active, ReportInterface& report = CERR);
+
         //!
         //! Bind to a local address and port.
         //!
@@ -33,6 +33,7 @@
 
 #include "tsTSAnalyzer.h"
 #include "tsT2MIPacket.h"
+#include "tsServiceDescriptor.h"
 #include "tsNames.h"
 #include "tsStringUtils.h"
 #include "tsFormat.h"
@@ -553,7 +554,7 @@ void ts::TSAnalyzer::handleTable(SectionDemux&, const BinaryTable& table)
     // Process specific tables
     switch (tid) {
         case TID_PAT: {
-            PAT pat(table);
+            const PATView pat(table);
             if (pid == PID_PAT && pat.isValid()) {
                 analyzePAT(pat);
             }
@@ -574,7 +575,7 @@ void ts::TSAnalyzer::handleTable(SectionDemux&, const BinaryTable& table)
             break;
         }
         case TID_SDT_ACT: {
-            SDT sdt(table);
+            const SDTView sdt(table);
             if (sdt.isValid()) {
                 analyzeSDT(sdt);
             }
@@ -605,16 +606,19 @@ void ts::TSAnalyzer::handleTable(SectionDemux&, const BinaryTable& table)
 // Analyze a PAT
 //----------------------------------------------------------------------------
 
-void ts::TSAnalyzer::analyzePAT(const PAT& pat)
+void ts::TSAnalyzer::analyzePAT(const PATView& pat)
 {
     // Get the transport stream id
-    _ts_id = pat.ts_id;
+    _ts_id = pat.tsId();
     _ts_id_valid = true;
 
     // Get all PMT PID's for all services
-    for (PAT::ServiceMap::const_iterator it = pat.pmts.begin(); it != pat.pmts.end(); ++it) {
-        uint16_t service_id(it->first);
-        PID pmt_pid(it->second);
+    for (PATView::const_iterator it = pat.begin(); it != pat.end(); ++it) {
+        const uint16_t service_id((*it).programNumber());
+        const PID pmt_pid((*it).pid());
+        if (service_id == 0) {
+            continue; // NIT PID
+        }
         // Register the PMT PID
         PIDContextPtr ps(getPID(pmt_pid));
         ps->description = u"PMT";
@@ -699,23 +703,31 @@ void ts::TSAnalyzer::analyzePMT(PID pid, const PMT& pmt)
 // Analyze an SDT
 //----------------------------------------------------------------------------
 
-void ts::TSAnalyzer::analyzeSDT(const SDT& sdt)
+void ts::TSAnalyzer::analyzeSDT(const SDTView& sdt)
 {
-    // Register characteristics of all services
-    for (SDT::ServiceMap::const_iterator it = sdt.services.begin(); it != sdt.services.end(); ++it) {
-
-        ServiceContextPtr svp(getService(it->first)); // it->first = map key = service id
-        svp->orig_netw_id = sdt.onetw_id;
-        svp->service_type = it->second.serviceType();
-
-        // Replace names only if they are not empty.
-        const UString provider(it->second.providerName());
-        const UString name(it->second.serviceName());
-        if (!provider.empty()) {
-            svp->provider = provider;
+    // Register characteristics of all services.
+    // Only the service descriptors are decoded, directly in the section data.
+    const uint16_t onetw_id = sdt.originalNetworkId();
+    for (SDTView::const_iterator it = sdt.begin(); it != sdt.end(); ++it) {
+
+        const SDTView::Service srv(*it);
+        ServiceContextPtr svp(getService(srv.serviceId()));
+        svp->orig_netw_id = onetw_id;
+
+        // Decode the service descriptor only once per service.
+        ServiceDescriptor sd;
+        if (srv.locateServiceDescriptor(sd)) {
+            svp->service_type = sd.service_type;
+            // Replace names only if they are not empty.
+            if (!sd.provider_name.empty()) {
+                svp->provider = sd.provider_name;
+            }
+            if (!sd.service_name.empty()) {
+                svp->name = sd.service_name;
+            }
         }
-        if (!name.empty()) {
-            svp->name = name;
+        else {
+            svp->service_type = 0; // 0 is a "reserved" service_type value
         }
     }
 }
@@ -42,6 +42,8 @@
 #include "tsCAT.h"
 #include "tsPMT.h"
 #include "tsSDT.h"
+#include "tsPATView.h"
+#include "tsSDTView.h"
 #include "tsTDT.h"
 #include "tsTOT.h"
 #include "tsTime.h"
@@ -445,10 +447,10 @@ namespace ts {
         ServiceContextPtr getService(uint16_t service_id);
 
         // Analyze the various PSI tables
-        void analyzePAT(const PAT&);
+        void analyzePAT(const PATView&);
         void analyzeCAT(const CAT&);
         void analyzePMT(PID pid, const PMT&);
-        void analyzeSDT(const SDT&);
+        void analyzeSDT(const SDTView&);
         void analyzeTDT(const TDT&);
         void analyzeTOT(const TOT&);
 
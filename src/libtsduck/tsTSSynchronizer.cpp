@@ -0,0 +1,214 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Transport stream synchronizer on a byte stream.
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSSynchronizer.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+const size_t ts::TSSynchronizer::DEFAULT_MIN_CONTIGUOUS;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::TSSynchronizer::TSSynchronizer(size_t min_contiguous) :
+    _min_contiguous(min_contiguous),
+    _formats(),
+    _next(),
+    _packet_size(0),
+    _header_size(0),
+    _buffer(),
+    _buffer_start(0),
+    _synchronized(false),
+    _dropped_bytes(0),
+    _sync_loss(0)
+{
+    setStandardPacketFormats();
+}
+
+
+//----------------------------------------------------------------------------
+// Set the searched packet formats.
+//----------------------------------------------------------------------------
+
+bool ts::TSSynchronizer::setPacketFormat(size_t packet_size, size_t header_size)
+{
+    if (header_size + PKT_SIZE > packet_size) {
+        return false;
+    }
+    _formats.clear();
+    _formats.push_back(Format(packet_size, header_size));
+    return true;
+}
+
+void ts::TSSynchronizer::setStandardPacketFormats()
+{
+    _formats.clear();
+    _formats.push_back(Format(PKT_SIZE, 0));
+    _formats.push_back(Format(PKT_RS_SIZE, 0));
+    _formats.push_back(Format(PKT_M2TS_SIZE, M2TS_HEADER_SIZE));
+}
+
+
+//----------------------------------------------------------------------------
+// Check if a packet format matches all along a window.
+//----------------------------------------------------------------------------
+
+bool ts::TSSynchronizer::CheckFormat(const uint8_t* data, size_t window, const Format& format)
+{
+    // All complete packets in the window must start with a sync byte.
+    // A window which is too short for one packet is considered as valid.
+    for (size_t offset = format.header_size; offset + format.packet_size <= window + format.header_size; offset += format.packet_size) {
+        if (data[offset] != SYNC_BYTE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Locate the first synchronized packet in a memory area.
+//----------------------------------------------------------------------------
+
+bool ts::TSSynchronizer::findSync(const uint8_t* data, size_t size, size_t& start)
+{
+    const size_t window = std::min(_min_contiguous, size);
+    const size_t last = size - window;   // Last possible start offset.
+    const size_t none = std::numeric_limits<size_t>::max();
+
+    // The offsets are explored in increasing order. For each format, we only
+    // consider the offsets where a sync byte is present at the header size.
+    // _next[f] is the next candidate start offset for format f.
+    _next.assign(_formats.size(), 0);
+
+    for (size_t offset = 0; offset <= last; ++offset) {
+
+        // Update the next candidate for each format and find the smallest one.
+        size_t candidate = none;
+        for (size_t f = 0; f < _formats.size(); ++f) {
+            if (_next[f] < offset) {
+                _next[f] = offset;
+            }
+            if (_next[f] == offset && window >= _formats[f].packet_size) {
+                const uint8_t* const base = data + _formats[f].header_size;
+                const void* sync = ::memchr(base + offset, SYNC_BYTE, last - offset + 1);
+                _next[f] = sync == 0 ? none : size_t(reinterpret_cast<const uint8_t*>(sync) - base);
+            }
+            candidate = std::min(candidate, _next[f]);
+        }
+        if (candidate == none) {
+            break;
+        }
+
+        // Validate the candidate against all formats, in order of preference.
+        offset = candidate;
+        for (size_t f = 0; f < _formats.size(); ++f) {
+            if (_next[f] == offset && CheckFormat(data + offset, window, _formats[f])) {
+                start = offset;
+                _packet_size = _formats[f].packet_size;
+                _header_size = _formats[f].header_size;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+
+//----------------------------------------------------------------------------
+// Streaming interface.
+//----------------------------------------------------------------------------
+
+void ts::TSSynchronizer::reset()
+{
+    _buffer.clear();
+    _buffer_start = 0;
+    _synchronized = false;
+}
+
+void ts::TSSynchronizer::feed(const void* data, size_t size)
+{
+    // Compact the buffer before appending.
+    if (_buffer_start > 0) {
+        _buffer.erase(0, _buffer_start);
+        _buffer_start = 0;
+    }
+    _buffer.append(data, size);
+}
+
+size_t ts::TSSynchronizer::getPackets(TSPacket* packets, size_t max_packets)
+{
+    size_t count = 0;
+
+    while (count < max_packets) {
+        const uint8_t* const data = _buffer.data() + _buffer_start;
+        const size_t size = _buffer.size() - _buffer_start;
+
+        if (!_synchronized) {
+            // Wait for a complete search window.
+            if (size < _min_contiguous) {
+                break;
+            }
+            size_t start = 0;
+            if (findSync(data, size, start)) {
+                _synchronized = true;
+                _dropped_bytes += start;
+                _buffer_start += start;
+            }
+            else {
+                // All possible start offsets were explored, keep only the last window.
+                const size_t drop = size - _min_contiguous + 1;
+                _dropped_bytes += drop;
+                _buffer_start += drop;
+                break;
+            }
+        }
+        else if (size < _packet_size) {
+            // Wait for a complete packet.
+            break;
+        }
+        else if (data[_header_size] != SYNC_BYTE) {
+            // Synchronization lost, search again from here.
+            _synchronized = false;
+            _sync_loss++;
+        }
+        else {
+            ::memcpy(packets[count++].b, data + _header_size, PKT_SIZE);
+            _buffer_start += _packet_size;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,215 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Transport stream synchronizer on a byte stream.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTSPacket.h"
+#include "tsByteBlock.h"
+
+namespace ts {
+    //!
+    //! Transport stream synchronizer on a byte stream.
+    //!
+    //! This class locates the start of TS packets in a byte stream where the
+    //! packets are not necessarily aligned, for instance a corrupted capture file
+    //! or a network stream without packet boundaries. The packets may be encapsulated
+    //! in larger structures: 204-byte packets with trailing Reed-Solomon outer FEC or
+    //! 192-byte M2TS packets with a leading 4-byte timestamp, for instance.
+    //!
+    //! The search is based on the periodicity of the sync byte (0x47). The candidate
+    //! sync bytes are first located using the system's @c memchr() (which is typically
+    //! vectorized). Each candidate is then validated against all possible packet formats.
+    //!
+    //! This class can be used in two ways:
+    //! - The low-level method findSync() locates the first packet in a memory area.
+    //! - The streaming methods feed() and getPackets() receive an arbitrary
+    //!   byte stream and return synchronized 188-byte TS packets.
+    //!
+    class TSDUCKDLL TSSynchronizer
+    {
+    public:
+        //!
+        //! Default minimum size in bytes of contiguous packets to declare synchronization.
+        //!
+        static const size_t DEFAULT_MIN_CONTIGUOUS = 8 * PKT_SIZE;
+
+        //!
+        //! Constructor.
+        //! By default, the standard packet formats are searched (188, 204 and 192-byte M2TS).
+        //! @param [in] min_contiguous Minimum size in bytes containing contiguous valid
+        //! packets to declare a synchronization.
+        //!
+        explicit TSSynchronizer(size_t min_contiguous = DEFAULT_MIN_CONTIGUOUS);
+
+        //!
+        //! Set the minimum size containing contiguous valid packets to declare synchronization.
+        //! @param [in] min_contiguous Minimum size in bytes.
+        //!
+        void setMinContiguous(size_t min_contiguous)
+        {
+            _min_contiguous = min_contiguous;
+        }
+
+        //!
+        //! Get the minimum size containing contiguous valid packets to declare synchronization.
+        //! @return Minimum size in bytes.
+        //!
+        size_t minContiguous() const
+        {
+            return _min_contiguous;
+        }
+
+        //!
+        //! Search only one specific packet encapsulation.
+        //! @param [in] packet_size Size in bytes of each packet in the stream.
+        //! Must be at least 188 bytes.
+        //! @param [in] header_size Size in bytes of the header which precedes each
+        //! TS packet inside the @a packet_size bytes.
+        //! @return True on success, false if the sizes are inconsistent.
+        //!
+        bool setPacketFormat(size_t packet_size, size_t header_size = 0);
+
+        //!
+        //! Search the standard packet formats, in this order of preference:
+        //! 188-byte packets, 204-byte packets with trailing Reed-Solomon outer FEC,
+        //! 192-byte M2TS packets with a leading 4-byte timestamp.
+        //! This is the default.
+        //!
+        void setStandardPacketFormats();
+
+        //!
+        //! Locate the first synchronized packet in a memory area.
+        //!
+        //! The search window is the minimum contiguous size (or @a size if smaller).
+        //! A synchronization is found at a given offset when the sync bytes are present
+        //! all along the window starting at this offset, for one of the packet formats.
+        //! On success, packetSize() and headerSize() return the found format.
+        //!
+        //! @param [in] data Address of the memory area.
+        //! @param [in] size Size in bytes of the memory area.
+        //! @param [out] start Offset in @a data of the first packet, including its header.
+        //! @return True if a synchronization was found, false otherwise.
+        //!
+        bool findSync(const uint8_t* data, size_t size, size_t& start);
+
+        //!
+        //! Reset the streaming state.
+        //! All buffered data are dropped and the next packet must be resynchronized.
+        //!
+        void reset();
+
+        //!
+        //! Feed the synchronizer with data from a byte stream.
+        //! @param [in] data Address of the data.
+        //! @param [in] size Size in bytes of the data.
+        //!
+        void feed(const void* data, size_t size);
+
+        //!
+        //! Extract synchronized TS packets from the data which were previously fed.
+        //! Any encapsulation header or trailer is removed.
+        //! @param [out] packets Address of a buffer of TS packets.
+        //! @param [in] max_packets Maximum number of packets to return.
+        //! @return The number of returned packets.
+        //!
+        size_t getPackets(TSPacket* packets, size_t max_packets);
+
+        //!
+        //! Check if the stream is currently synchronized.
+        //! @return True if the stream is synchronized.
+        //!
+        bool isSynchronized() const
+        {
+            return _synchronized;
+        }
+
+        //!
+        //! Get the packet size of the last found synchronization.
+        //! @return The packet size in bytes, including encapsulation, or zero if not found.
+        //!
+        size_t packetSize() const
+        {
+            return _packet_size;
+        }
+
+        //!
+        //! Get the header size of the last found synchronization.
+        //! @return The size in bytes of the header which precedes the TS packet.
+        //!
+        size_t headerSize() const
+        {
+            return _header_size;
+        }
+
+        //!
+        //! Get the number of bytes which were dropped in the stream while searching synchronization.
+        //! @return The number of dropped bytes.
+        //!
+        uint64_t droppedBytes() const
+        {
+            return _dropped_bytes;
+        }
+
+        //!
+        //! Get the number of synchronization losses in the stream.
+        //! @return The number of synchronization losses.
+        //!
+        uint64_t syncLossCount() const
+        {
+            return _sync_loss;
+        }
+
+    private:
+        // Description of a packet format.
+        struct Format
+        {
+            size_t packet_size;
+            size_t header_size;
+            Format(size_t p, size_t h) : packet_size(p), header_size(h) {}
+        };
+
+        size_t              _min_contiguous;  // Search window size.
+        std::vector<Format> _formats;         // Searched formats, in order of preference.
+        std::vector<size_t> _next;            // Next candidate start, per format, during findSync().
+        size_t              _packet_size;     // Found packet size.
+        size_t              _header_size;     // Found header size.
+        ByteBlock           _buffer;          // Buffered stream data.
+        size_t              _buffer_start;    // Start of unprocessed data in _buffer.
+        bool                _synchronized;    // The stream is currently synchronized.
+        uint64_t            _dropped_bytes;   // Dropped bytes during synchronization.
+        uint64_t            _sync_loss;       // Number of synchronization losses.
+
+        // Check if a packet format matches all along a window.
+        static bool CheckFormat(const uint8_t* data, size_t window, const Format& format);
+    };
+}
@@ -39,6 +39,7 @@
 #include "tsNames.h"
 #include "tsStringUtils.h"
 #include "tsIntegerUtils.h"
+#include <sstream>
 TSDUCK_SOURCE;
 
 
@@ -50,7 +51,9 @@ ts::TablesDisplay::TablesDisplay(const TablesDisplayArgs& options, ReportInterfa
     _opt(options),
     _report(report),
     _outfile(),
-    _use_outfile(false)
+    _use_outfile(false),
+    _user_stream(0),
+    _cache()
 {
 }
 
@@ -83,7 +86,7 @@ ts::PDS ts::TablesDisplay::actualPDS(PDS pds) const
 
 std::ostream& ts::TablesDisplay::out()
 {
-    return _use_outfile ? _outfile : std::cout;
+    return _user_stream != 0 ? *_user_stream : (_use_outfile ? _outfile : std::cout);
 }
 
 
@@ -98,7 +101,7 @@ void ts::TablesDisplay::flush()
 
     // On Windows, we must force the lower-level standard output.
 #if !defined(__windows)
-    if (!_use_outfile) {
+    if (!_use_outfile && _user_stream == 0) {
         ::fflush(stdout);
         ::fsync(STDOUT_FILENO);
     }
@@ -113,6 +116,7 @@ void ts::TablesDisplay::flush()
 bool ts::TablesDisplay::redirect(const std::string& file_name)
 {
     // Close previous file, if any.
+    _user_stream = 0;
     if (_use_outfile) {
         _outfile.close();
         _use_outfile = false;
@@ -132,6 +136,23 @@ bool ts::TablesDisplay::redirect(const std::string& file_name)
     return true;
 }
 
+void ts::TablesDisplay::redirect(std::ostream& strm)
+{
+    redirect();
+    _user_stream = &strm;
+}
+
+
+//----------------------------------------------------------------------------
+// Build the formatting context of a cache key.
+//----------------------------------------------------------------------------
+
+uint32_t ts::TablesDisplay::cacheContext(int indent, CASFamily cas, bool table, bool no_header) const
+{
+    // The formatted text depends on the indentation, the actual CAS family and the type of display.
+    return (uint32_t(indent & 0xFFFF) << 16) | (uint32_t(casFamily(cas) & 0xFF) << 8) | (table ? 0x02 : 0x00) | (no_header ? 0x01 : 0x00);
+}
+
 
 //----------------------------------------------------------------------------
 // A utility method to dump extraneous bytes after expected data.
@@ -153,6 +174,40 @@ std::ostream& ts::TablesDisplay::displayExtraData(const void* data, size_t size,
 //----------------------------------------------------------------------------
 
 std::ostream& ts::TablesDisplay::displayTable(const BinaryTable& table, int indent, CASFamily cas)
+{
+    // The cache size may have been changed in the options since the last display.
+    _cache.setMaxMemory(_opt.cache_size);
+
+    // Use the cache of formatted tables when possible.
+    TablesDisplayCache::Key key;
+    if (!_cache.enabled() || !TablesDisplayCache::MakeKey(key, table, cacheContext(indent, cas, true, false))) {
+        return formatTable(table, indent, cas);
+    }
+
+    // Display the previously formatted text.
+    std::ostream& strm(out());
+    const std::string* text = _cache.lookup(key);
+    if (text != 0) {
+        return strm << *text;
+    }
+
+    // Format the table into a string, keep it in the cache and display it.
+    std::ostringstream fmt;
+    std::ostream* const previous = _user_stream;
+    _user_stream = &fmt;
+    formatTable(table, indent, cas);
+    _user_stream = previous;
+    const std::string formatted(fmt.str());
+    _cache.store(key, formatted);
+    return strm << formatted;
+}
+
+
+//----------------------------------------------------------------------------
+// Format a table on the output stream, without using the cache.
+//----------------------------------------------------------------------------
+
+std::ostream& ts::TablesDisplay::formatTable(const BinaryTable& table, int indent, CASFamily cas)
 {
     std::ostream& strm(out());
 
@@ -200,7 +255,7 @@ std::ostream& ts::TablesDisplay::displayTable(const BinaryTable& table, int inde
     // Loop across all sections.
     for (size_t i = 0; i < table.sectionCount(); ++i) {
         strm << margin << "  - Section " << i << ":" << std::endl;
-        displaySection(*table.sectionAt(i), indent + 4, cas, true);
+        formatSection(*table.sectionAt(i), indent + 4, cas, true);
     }
 
     return strm;
@@ -212,6 +267,37 @@ std::ostream& ts::TablesDisplay::displayTable(const BinaryTable& table, int inde
 //----------------------------------------------------------------------------
 
 std::ostream& ts::TablesDisplay::displaySection(const Section& section, int indent, CASFamily cas, bool no_header)
+{
+    // Same principle as displayTable().
+    _cache.setMaxMemory(_opt.cache_size);
+
+    TablesDisplayCache::Key key;
+    if (!_cache.enabled() || !TablesDisplayCache::MakeKey(key, section, cacheContext(indent, cas, false, no_header))) {
+        return formatSection(section, indent, cas, no_header);
+    }
+
+    std::ostream& strm(out());
+    const std::string* text = _cache.lookup(key);
+    if (text != 0) {
+        return strm << *text;
+    }
+
+    std::ostringstream fmt;
+    std::ostream* const previous = _user_stream;
+    _user_stream = &fmt;
+    formatSection(section, indent, cas, no_header);
+    _user_stream = previous;
+    const std::string formatted(fmt.str());
+    _cache.store(key, formatted);
+    return strm << formatted;
+}
+
+
+//----------------------------------------------------------------------------
+// Format a section on the output stream, without using the cache.
+//----------------------------------------------------------------------------
+
+std::ostream& ts::TablesDisplay::formatSection(const Section& section, int indent, CASFamily cas, bool no_header)
 {
     std::ostream& strm(out());
 
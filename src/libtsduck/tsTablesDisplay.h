@@ -34,6 +34,7 @@
 
 #pragma once
 #include "tsTablesDisplayArgs.h"
+#include "tsTablesDisplayCache.h"
 #include "tsBinaryTable.h"
 #include "tsSection.h"
 #include "tsDescriptor.h"
@@ -195,6 +196,13 @@ namespace ts {
         //!
         virtual bool redirect(const std::string& file_name = std::string());
 
+        //!
+        //! Redirect the output stream to an application-provided stream.
+        //! The previous file is closed. Typically used to format into a string stream.
+        //! @param [in,out] strm The output stream. It must remain valid while it is used by this object.
+        //!
+        void redirect(std::ostream& strm);
+
         //!
         //! Get the current output stream.
         //! @return A reference to the output stream.
@@ -210,6 +218,15 @@ namespace ts {
             return _opt.default_charset;
         }
 
+        //!
+        //! Get the display options.
+        //! @return A reference to the display options.
+        //!
+        const TablesDisplayArgs& options() const
+        {
+            return _opt;
+        }
+
         //!
         //! Get the current output report.
         //! @return A reference to the current output report.
@@ -219,6 +236,16 @@ namespace ts {
             return _report;
         }
 
+        //!
+        //! Get the usage statistics of the cache of formatted tables.
+        //! The cache is used only when a cache size is specified in the display options.
+        //! @return A constant reference to the cache statistics.
+        //!
+        const TablesDisplayCache::Statistics& cacheStatistics() const
+        {
+            return _cache.statistics();
+        }
+
         //!
         //! Flush the text output.
         //!
@@ -286,6 +313,15 @@ namespace ts {
         ReportInterface&         _report;
         std::ofstream            _outfile;
         bool                     _use_outfile;
+        std::ostream*            _user_stream;
+        TablesDisplayCache       _cache;
+
+        // Format a table or section on the output stream, without using the cache.
+        std::ostream& formatTable(const BinaryTable& table, int indent, CASFamily cas);
+        std::ostream& formatSection(const Section& section, int indent, CASFamily cas, bool no_header);
+
+        // Build the formatting context of a cache key.
+        uint32_t cacheContext(int indent, CASFamily cas, bool table, bool no_header) const;
 
         // Inaccessible operations.
         TablesDisplay() = delete;
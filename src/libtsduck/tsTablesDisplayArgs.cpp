@@ -47,7 +47,8 @@ ts::TablesDisplayArgs::TablesDisplayArgs() :
     tlv_syntax(),
     min_nested_tlv(0),
     default_pds(0),
-    default_charset(0)
+    default_charset(0),
+    cache_size(0)
 {
 }
 
@@ -57,7 +58,8 @@ ts::TablesDisplayArgs::TablesDisplayArgs(const TablesDisplayArgs& other) :
     tlv_syntax(other.tlv_syntax),
     min_nested_tlv(other.min_nested_tlv),
     default_pds(other.default_pds),
-    default_charset(other.default_charset)  // point to same DVBCharset object
+    default_charset(other.default_charset),  // point to same DVBCharset object
+    cache_size(other.cache_size)
 {
 }
 
@@ -70,6 +72,7 @@ ts::TablesDisplayArgs& ts::TablesDisplayArgs::operator=(const TablesDisplayArgs&
         min_nested_tlv = other.min_nested_tlv;
         default_pds = other.default_pds;
         default_charset = other.default_charset;
+        cache_size = other.cache_size;
     }
     return *this;
 }
@@ -107,6 +110,13 @@ void ts::TablesDisplayArgs::addHelp(Args& args) const
         "      The PDS value can be an integer or one of (not case-sensitive):\n"
         "      " + PrivateDataSpecifierEnum.nameList() + ".\n"
         "\n"
+        "  --display-cache-size kilobytes\n"
+        "      Keep the formatted text of recently displayed tables in a cache of the\n"
+        "      specified maximum size. When the same table (same PID, table id, table\n"
+        "      id extension, version and CRC32) is displayed again, the formatted text\n"
+        "      is directly reused. This is useful when all versions or all sections of\n"
+        "      a stream are logged. The default is zero, meaning no cache.\n"
+        "\n"
         "  --europe\n"
         "      A synonym for '--default-charset ISO-8859-15'. This is a handy shortcut\n"
         "      for commonly incorrect signalization on some European satellites. In that\n"
@@ -156,6 +166,7 @@ void ts::TablesDisplayArgs::defineOptions(Args& args) const
     args.option("c-style",        'c');
     args.option("default-charset", 0, Args::STRING);
     args.option("default-pds",     0, PrivateDataSpecifierEnum);
+    args.option("display-cache-size", 0, Args::UNSIGNED);
     args.option("europe",          0);
     args.option("nested-tlv",      0, Args::POSITIVE, 0, 1, 0, 0, true);
     args.option("raw-dump",       'r');
@@ -171,6 +182,7 @@ void ts::TablesDisplayArgs::defineOptions(Args& args) const
 void ts::TablesDisplayArgs::load(Args& args)
 {
     args.getIntValue(default_pds, "default-pds");
+    cache_size = args.intValue<size_t>("display-cache-size", 0) * 1024;
     raw_dump = args.present("raw-dump");
     raw_flags = hexa::HEXA;
     if (args.present("c-style")) {
@@ -52,6 +52,7 @@ namespace ts {
         size_t            min_nested_tlv;   //!< Minimum size of a TLV record after which it is interpreted as a nested TLV (0=disabled).
         PDS               default_pds;      //!< Default private data specifier when none is specified.
         const DVBCharset* default_charset;  //!< Default DVB character set to interpret strings.
+        size_t            cache_size;       //!< Maximum memory size in bytes of the cache of formatted tables (0=disabled).
 
         //!
         //! Default constructor.
@@ -0,0 +1,267 @@
+//----------------------------------------------------------------------------
+//
+//  TSDuck - The MPEG Transport Stream Toolkit
+//  Copyright (c) 2005-2017, Thierry Lelegard
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//
+//  1. Redistributions of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+//  THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+//  Cache of formatted PSI/SI tables and sections.
+//
+//----------------------------------------------------------------------------
+
+#include "tsTablesDisplayCache.h"
+#include "tsFormat.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+const size_t ts::TablesDisplayCache::ENTRY_OVERHEAD;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Cache keys.
+//----------------------------------------------------------------------------
+
+ts::TablesDisplayCache::Key::Key() :
+    pid(PID_NULL),
+    tid(TID_NULL),
+    tid_ext(0),
+    version(0),
+    crc32(0),
+    size(0),
+    context(0)
+{
+}
+
+bool ts::TablesDisplayCache::Key::operator<(const Key& other) const
+{
+    // Compare the most discriminating fields first.
+    if (crc32 != other.crc32) {
+        return crc32 < other.crc32;
+    }
+    else if (size != other.size) {
+        return size < other.size;
+    }
+    else if (pid != other.pid) {
+        return pid < other.pid;
+    }
+    else if (tid != other.tid) {
+        return tid < other.tid;
+    }
+    else if (tid_ext != other.tid_ext) {
+        return tid_ext < other.tid_ext;
+    }
+    else if (version != other.version) {
+        return version < other.version;
+    }
+    else {
+        return context < other.context;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Build the cache key of a section.
+//----------------------------------------------------------------------------
+
+bool ts::TablesDisplayCache::MakeKey(Key& key, const Section& section, uint32_t context)
+{
+    if (!section.isValid() || !section.isLongSection()) {
+        return false;
+    }
+    else {
+        // The CRC32 of a long section is stored in its last 4 bytes.
+        key.pid = section.sourcePID();
+        key.tid = section.tableId();
+        key.tid_ext = section.tableIdExtension();
+        key.version = section.version();
+        key.crc32 = GetUInt32(section.content() + section.size() - 4);
+        key.size = section.size();
+        key.context = context;
+        return true;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Build the cache key of a table.
+//----------------------------------------------------------------------------
+
+bool ts::TablesDisplayCache::MakeKey(Key& key, const BinaryTable& table, uint32_t context)
+{
+    if (!table.isValid() || table.sectionCount() == 0) {
+        return false;
+    }
+
+    // A one-section table uses the CRC32 of its section.
+    // Otherwise, compute a CRC32 of the CRC32 fields of all sections.
+    CRC32 crc;
+    size_t size = 0;
+    for (size_t i = 0; i < table.sectionCount(); ++i) {
+        const Section& section(*table.sectionAt(i));
+        if (!section.isLongSection()) {
+            return false;
+        }
+        crc.add(section.content() + section.size() - 4, 4);
+        size += section.size();
+    }
+
+    key.pid = table.sourcePID();
+    key.tid = table.tableId();
+    key.tid_ext = table.tableIdExtension();
+    key.version = table.version();
+    key.crc32 = table.sectionCount() == 1 ? GetUInt32(table.sectionAt(0)->content() + size - 4) : crc.value();
+    key.size = size;
+    key.context = context;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Statistics.
+//----------------------------------------------------------------------------
+
+ts::TablesDisplayCache::Statistics::Statistics() :
+    hits(0),
+    misses(0),
+    evictions(0),
+    entries(0),
+    memory(0)
+{
+}
+
+ts::TablesDisplayCache::Statistics& ts::TablesDisplayCache::Statistics::operator+=(const Statistics& other)
+{
+    hits += other.hits;
+    misses += other.misses;
+    evictions += other.evictions;
+    entries += other.entries;
+    memory += other.memory;
+    return *this;
+}
+
+std::string ts::TablesDisplayCache::Statistics::toString() const
+{
+    const uint64_t lookups = hits + misses;
+    return Format("%" FMT_INT64 "u hits, %" FMT_INT64 "u misses (%d%% hits), %" FMT_INT64 "u evictions, %" FMT_SIZE_T "u entries, %" FMT_SIZE_T "u bytes",
+                  hits, misses, lookups == 0 ? 0 : int((100 * hits) / lookups), evictions, entries, memory);
+}
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::TablesDisplayCache::TablesDisplayCache(size_t max_memory) :
+    _max_memory(max_memory),
+    _entries(),
+    _index(),
+    _stats()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Set the maximum memory size of the cache.
+//----------------------------------------------------------------------------
+
+void ts::TablesDisplayCache::setMaxMemory(size_t max_memory)
+{
+    if (max_memory != _max_memory) {
+        _max_memory = max_memory;
+        evict(_max_memory);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Remove all entries from the cache.
+//----------------------------------------------------------------------------
+
+void ts::TablesDisplayCache::clear()
+{
+    _entries.clear();
+    _index.clear();
+    _stats.entries = 0;
+    _stats.memory = 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Remove least recently used entries until the memory size fits.
+//----------------------------------------------------------------------------
+
+void ts::TablesDisplayCache::evict(size_t max_memory)
+{
+    while (!_entries.empty() && _stats.memory > max_memory) {
+        const Entry& last(_entries.back());
+        _stats.memory -= last.text.size() + ENTRY_OVERHEAD;
+        _stats.entries--;
+        _stats.evictions++;
+        _index.erase(last.key);
+        _entries.pop_back();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Look for a formatted text in the cache.
+//----------------------------------------------------------------------------
+
+const std::string* ts::TablesDisplayCache::lookup(const Key& key)
+{
+    const EntryIndex::const_iterator it(_index.find(key));
+    if (it == _index.end()) {
+        _stats.misses++;
+        return 0;
+    }
+    else {
+        // Move the entry in front of the LRU list. The list iterator remains valid.
+        _stats.hits++;
+        _entries.splice(_entries.begin(), _entries, it->second);
+        return &it->second->text;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Store a formatted text in the cache.
+//----------------------------------------------------------------------------
+
+void ts::TablesDisplayCache::store(const Key& key, const std::string& text)
+{
+    const size_t cost = text.size() + ENTRY_OVERHEAD;
+    if (cost > _max_memory || _index.find(key) != _index.end()) {
+        return;
+    }
+
+    // Make room for the new entry, then insert it as most recently used.
+    evict(_max_memory - cost);
+    _entries.push_front(Entry());
+    _entries.front().key = key;
+    _entries.front().text = text;
+    _index[key] = _entries.begin();
+    _stats.entries++;
+    _stats.memory += cost;
+}
@@ -0,0 +1,218 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//!
+//!  @file
+//!  Cache of formatted PSI/SI tables and sections.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsBinaryTable.h"
+#include "tsSection.h"
+
+namespace ts {
+    //!
+    //! Cache of formatted PSI/SI tables and sections.
+    //!
+    //! When the same tables are repeatedly displayed, typically when logging all
+    //! versions or all sections of a stream, the same PMT or SDT is deserialized
+    //! and formatted thousands of times. This cache keeps the formatted text of
+    //! recently displayed tables, indexed by PID, table id, table id extension,
+    //! version and CRC32 of the sections. A repeated table is directly output
+    //! from the cache.
+    //!
+    //! Only tables made of long sections are cached since short sections have no
+    //! version and no CRC32 (a TDT or TOT is usually different each time anyway).
+    //!
+    //! The memory size of the cache is bounded. The least recently used entries
+    //! are evicted first. This class is not thread-safe.
+    //!
+    class TSDUCKDLL TablesDisplayCache
+    {
+    public:
+        //!
+        //! Key of a formatted table or section in the cache.
+        //!
+        struct TSDUCKDLL Key
+        {
+            PID      pid;      //!< Source PID.
+            TID      tid;      //!< Table id.
+            uint16_t tid_ext;  //!< Table id extension.
+            uint8_t  version;  //!< Table version.
+            uint32_t crc32;    //!< CRC32 of the section or combined CRC32 of all sections of the table.
+            size_t   size;     //!< Total size in bytes of the table or section.
+            uint32_t context;  //!< Formatting context (indentation, CAS, etc.), opaque to the cache.
+
+            //!
+            //! Default constructor.
+            //!
+            Key();
+
+            //!
+            //! Comparison operator, used to sort keys in the cache index.
+            //! @param [in] other Other key to compare.
+            //! @return True if this key is lower than @a other.
+            //!
+            bool operator<(const Key& other) const;
+        };
+
+        //!
+        //! Cache usage statistics.
+        //!
+        struct TSDUCKDLL Statistics
+        {
+            uint64_t hits;       //!< Number of lookups which found an entry.
+            uint64_t misses;     //!< Number of lookups which found no entry.
+            uint64_t evictions;  //!< Number of entries which were removed to make room.
+            size_t   entries;    //!< Current number of entries.
+            size_t   memory;     //!< Current estimated memory size in bytes.
+
+            //!
+            //! Default constructor.
+            //!
+            Statistics();
+
+            //!
+            //! Accumulate statistics of another cache.
+            //! @param [in] other Other statistics to add.
+            //! @return A reference to this object.
+            //!
+            Statistics& operator+=(const Statistics& other);
+
+            //!
+            //! Format the statistics as a one-line string.
+            //! @return A string describing the statistics.
+            //!
+            std::string toString() const;
+        };
+
+        //!
+        //! Constructor.
+        //! @param [in] max_memory Maximum memory size in bytes. Zero means that the cache is disabled.
+        //!
+        explicit TablesDisplayCache(size_t max_memory = 0);
+
+        //!
+        //! Set the maximum memory size of the cache.
+        //! If the cache currently uses more, the least recently used entries are evicted.
+        //! @param [in] max_memory Maximum memory size in bytes. Zero means that the cache is disabled.
+        //!
+        void setMaxMemory(size_t max_memory);
+
+        //!
+        //! Get the maximum memory size of the cache.
+        //! @return The maximum memory size in bytes.
+        //!
+        size_t maxMemory() const
+        {
+            return _max_memory;
+        }
+
+        //!
+        //! Check if the cache is enabled.
+        //! @return True if the cache is enabled.
+        //!
+        bool enabled() const
+        {
+            return _max_memory > 0;
+        }
+
+        //!
+        //! Build the cache key of a table.
+        //! @param [out] key Returned cache key.
+        //! @param [in] table The table to display.
+        //! @param [in] context Formatting context, opaque to the cache.
+        //! @return True if the table can be cached, false otherwise (invalid table, short sections).
+        //!
+        static bool MakeKey(Key& key, const BinaryTable& table, uint32_t context);
+
+        //!
+        //! Build the cache key of a section.
+        //! @param [out] key Returned cache key.
+        //! @param [in] section The section to display.
+        //! @param [in] context Formatting context, opaque to the cache.
+        //! @return True if the section can be cached, false otherwise (invalid or short section).
+        //!
+        static bool MakeKey(Key& key, const Section& section, uint32_t context);
+
+        //!
+        //! Look for a formatted text in the cache.
+        //! The found entry becomes the most recently used one.
+        //! @param [in] key Cache key.
+        //! @return Address of the formatted text or zero if not found.
+        //! The returned address remains valid until the next call to store(), setMaxMemory() or clear().
+        //!
+        const std::string* lookup(const Key& key);
+
+        //!
+        //! Store a formatted text in the cache.
+        //! Texts which are larger than the maximum cache size are not stored.
+        //! @param [in] key Cache key.
+        //! @param [in] text Formatted text.
+        //!
+        void store(const Key& key, const std::string& text);
+
+        //!
+        //! Remove all entries from the cache.
+        //! The statistics counters are preserved.
+        //!
+        void clear();
+
+        //!
+        //! Get the cache usage statistics.
+        //! @return A constant reference to the statistics.
+        //!
+        const Statistics& statistics() const
+        {
+            return _stats;
+        }
+
+        //!
+        //! Estimated memory overhead of a cache entry, in addition to the text size.
+        //!
+        static const size_t ENTRY_OVERHEAD = 128;
+
+    private:
+        // Cache entries in LRU order, most recently used first.
+        struct Entry
+        {
+            Key         key;
+            std::string text;
+        };
+        typedef std::list<Entry> EntryList;
+        typedef std::map<Key, EntryList::iterator> EntryIndex;
+
+        size_t     _max_memory;
+        EntryList  _entries;
+        EntryIndex _index;
+        Statistics _stats;
+
+        // Remove least recently used entries until the memory size fits.
+        void evict(size_t max_memory);
+    };
+}
@@ -48,11 +48,33 @@ ts::TablesFactory::TablesFactory() :
     _tableNames(),
     _descriptorNames(),
     _sectionDisplays(),
-    _descriptorDisplays()
+    _descriptorDisplays(),
+    _tableKeys(),
+    _descriptorKeys()
 {
 }
 
 
+//----------------------------------------------------------------------------
+// Normalize a node name for indexed lookup.
+// XML node names are looked up case-insensitive and ignoring blanks, like
+// SimilarStrings(), but using a map instead of a linear search.
+//----------------------------------------------------------------------------
+
+std::string ts::TablesFactory::NormalizedName(const std::string& name)
+{
+    std::string key;
+    key.reserve(name.size());
+    for (std::string::const_iterator it = name.begin(); it != name.end(); ++it) {
+        const int c = static_cast<unsigned char>(*it);
+        if (!std::isspace(c)) {
+            key.push_back(char(std::tolower(c)));
+        }
+    }
+    return key;
+}
+
+
 //----------------------------------------------------------------------------
 // Registrations.
 //----------------------------------------------------------------------------
@@ -76,12 +98,16 @@ ts::TablesFactory::Register::Register(const EDID& id, DescriptorFactory factory)
 
 ts::TablesFactory::Register::Register(const std::string& node_name, TableFactory factory)
 {
-    TablesFactory::Instance()->_tableNames.insert(std::pair<std::string,TableFactory>(node_name, factory));
+    TablesFactory* const fact = TablesFactory::Instance();
+    fact->_tableNames.insert(std::pair<std::string,TableFactory>(node_name, factory));
+    fact->_tableKeys.insert(std::pair<std::string,TableFactory>(NormalizedName(node_name), factory));
 }
 
 ts::TablesFactory::Register::Register(const std::string& node_name, DescriptorFactory factory)
 {
-    TablesFactory::Instance()->_descriptorNames.insert(std::pair<std::string,DescriptorFactory>(node_name, factory));
+    TablesFactory* const fact = TablesFactory::Instance();
+    fact->_descriptorNames.insert(std::pair<std::string,DescriptorFactory>(node_name, factory));
+    fact->_descriptorKeys.insert(std::pair<std::string,DescriptorFactory>(NormalizedName(node_name), factory));
 }
 
 ts::TablesFactory::Register::Register(TID id, DisplaySectionFunction func)
@@ -120,14 +146,14 @@ ts::TablesFactory::DescriptorFactory ts::TablesFactory::getDescriptorFactory(con
 
 ts::TablesFactory::TableFactory ts::TablesFactory::getTableFactory(const std::string& node_name) const
 {
-    std::map<std::string,TableFactory>::const_iterator it = FindSimilar(_tableNames, node_name);
-    return it != _tableNames.end() ? it->second : 0;
+    std::map<std::string,TableFactory>::const_iterator it = _tableKeys.find(NormalizedName(node_name));
+    return it != _tableKeys.end() ? it->second : 0;
 }
 
 ts::TablesFactory::DescriptorFactory ts::TablesFactory::getDescriptorFactory(const std::string& node_name) const
 {
-    std::map<std::string,DescriptorFactory>::const_iterator it = FindSimilar(_descriptorNames, node_name);
-    return it != _descriptorNames.end() ? it->second : 0;
+    std::map<std::string,DescriptorFactory>::const_iterator it = _descriptorKeys.find(NormalizedName(node_name));
+    return it != _descriptorKeys.end() ? it->second : 0;
 }
 
 ts::TablesFactory::DisplaySectionFunction ts::TablesFactory::getSectionDisplay(TID id) const
@@ -256,6 +256,11 @@ namespace ts {
         std::map<std::string, DescriptorFactory>  _descriptorNames;
         std::map<TID, DisplaySectionFunction>     _sectionDisplays;
         std::map<EDID, DisplayDescriptorFunction> _descriptorDisplays;
+        std::map<std::string, TableFactory>       _tableKeys;       // Same as _tableNames, indexed by normalized name.
+        std::map<std::string, DescriptorFactory>  _descriptorKeys;  // Same as _descriptorNames, indexed by normalized name.
+
+        // Normalize a node name for indexed lookup: lowercase, without blanks.
+        static std::string NormalizedName(const std::string& name);
     };
 }
 
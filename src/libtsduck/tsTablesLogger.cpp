@@ -42,32 +42,51 @@
 TSDUCK_SOURCE;
 
 
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+const size_t ts::TablesLogger::WORKER_BATCH_SIZE;
+const size_t ts::TablesLogger::WORKER_QUEUE_SIZE;
+const size_t ts::TablesLogger::WORKER_FLUSH_INTERVAL;
+const size_t ts::TablesLogger::OUTPUT_QUEUE_SIZE;
+#endif
+
+
 //----------------------------------------------------------------------------
 // Constructor
 //----------------------------------------------------------------------------
 
 ts::TablesLogger::TablesLogger(const TablesLoggerArgs& opt, TablesDisplay& display, ReportInterface& report) :
-    TableHandlerInterface(),
-    SectionHandlerInterface(),
     _opt(opt),
     _display(display),
     _report(report),
     _abort(false),
     _exit(false),
+    _closed(false),
+    _text_started(false),
     _table_count(0),
     _packet_count(0),
-    _demux(0, 0, opt.pid),
     _cas_mapper(report),
     _outfile(),
     _sock(false, report),
-    _shortSections()
+    _mutex(),
+    _workers(),
+    _pid_filter(opt.pid),
+    _added_pids(),
+    _pids_changed(false),
+    _flush_countdown(WORKER_FLUSH_INTERVAL),
+    _output_queue(OUTPUT_QUEUE_SIZE),
+    _output_thread(0)
 {
-    // Set either a table or section handler, depending on --all-sections
-    if (_opt.all_sections) {
-        _demux.setSectionHandler(this);
+    // Create one single demux in the caller's thread or several worker threads.
+    if (_opt.threads == 0) {
+        _workers.push_back(new Worker(*this, false));
     }
     else {
-        _demux.setTableHandler(this);
+        _output_thread = new OutputThread(*this);
+        _output_thread->start();
+        for (size_t i = 0; i < _opt.threads; ++i) {
+            _workers.push_back(new Worker(*this, true));
+            _workers.back()->start();
+        }
     }
 
     // Open/create the destination
@@ -122,56 +141,366 @@ ts::TablesLogger::TablesLogger(const TablesLoggerArgs& opt, TablesDisplay& displ
 
 ts::TablesLogger::~TablesLogger()
 {
+    close();
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        delete _workers[i];
+    }
+    delete _output_thread;
     // Files and sockets are automatically closed by their destructors.
 }
 
 
+//----------------------------------------------------------------------------
+// Process all pending packets and stop the worker threads.
+//----------------------------------------------------------------------------
+
+void ts::TablesLogger::close()
+{
+    if (!_closed) {
+        _closed = true;
+        if (threaded()) {
+            // Pass the last packets to the workers and wait for them.
+            for (size_t i = 0; i < _workers.size(); ++i) {
+                _workers[i]->flushBatch();
+                _workers[i]->terminate();
+            }
+            for (size_t i = 0; i < _workers.size(); ++i) {
+                _workers[i]->waitForTermination();
+            }
+            // Then wait for all output to be written.
+            _output_queue.forceEnqueue(OutputQueue::MessagePtr());
+            _output_thread->waitForTermination();
+        }
+        // Report the usage of the display caches of all workers.
+        if (_display.options().cache_size > 0) {
+            TablesDisplayCache::Statistics stats;
+            for (size_t i = 0; i < _workers.size(); ++i) {
+                stats += _workers[i]->cacheStatistics();
+            }
+            _report.verbose("display cache: %s", stats.toString().c_str());
+        }
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // The following method feeds the logger with a TS packet.
 //----------------------------------------------------------------------------
 
 void ts::TablesLogger::feedPacket(const TSPacket& pkt)
 {
-    _demux.feedPacket(pkt);
+    if (!threaded()) {
+        _workers[0]->_demux.feedPacket(pkt);
+    }
+    else if (!_closed) {
+        const PID pid = pkt.getPID();
+
+        // Get the PID's which were added by the workers.
+        if (_pids_changed) {
+            Guard lock(_mutex);
+            _pid_filter |= _added_pids;
+            _pids_changed = false;
+        }
+
+        // Pass the packet to the worker thread of its PID. All packets from the same
+        // PID are processed by the same worker, preserving the order of sections.
+        // The CAS family is evaluated here since the CAS mapper is not thread-safe.
+        if (_pid_filter.test(pid)) {
+            _workers[pid % _workers.size()]->addPacket(pkt, _packet_count, _cas_mapper.casFamily(pid));
+        }
+
+        // Periodically pass incomplete batches to avoid delaying low-bitrate PID's.
+        if (--_flush_countdown == 0) {
+            _flush_countdown = WORKER_FLUSH_INTERVAL;
+            for (size_t i = 0; i < _workers.size(); ++i) {
+                _workers[i]->flushBatch();
+            }
+        }
+    }
     _cas_mapper.feedPacket(pkt);
     _packet_count++;
 }
 
 
+//----------------------------------------------------------------------------
+// Count a new table to log. Return false if the logging is completed.
+//----------------------------------------------------------------------------
+
+bool ts::TablesLogger::countTable()
+{
+    Guard lock(_mutex);
+    if (completed()) {
+        return false;
+    }
+    // Check max table count (actually count sections with --all-sections)
+    _table_count++;
+    if (_opt.max_tables > 0 && _table_count >= _opt.max_tables) {
+        _exit = true;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Add a PID to filter (option --psi-si).
+//----------------------------------------------------------------------------
+
+void ts::TablesLogger::addPID(PID pid)
+{
+    if (!threaded()) {
+        _workers[0]->_demux.addPID(pid);
+    }
+    else {
+        // The worker demuxes accept all PID's, the filtering is done in feedPacket().
+        Guard lock(_mutex);
+        _added_pids.set(pid);
+        _pids_changed = true;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Write output data, immediately or in the output thread.
+//----------------------------------------------------------------------------
+
+void ts::TablesLogger::output(const OutputQueue::MessagePtr& data)
+{
+    if (threaded()) {
+        _output_queue.enqueue(data);
+    }
+    else {
+        writeOutput(*data);
+    }
+}
+
+void ts::TablesLogger::writeOutput(const OutputData& data)
+{
+    switch (_opt.mode) {
+
+        case TablesLoggerArgs::TEXT: {
+            std::ostream& strm(_display.out());
+            startText(strm);
+            strm << data.text;
+            if (_opt.flush) {
+                _display.flush();
+            }
+            break;
+        }
+
+        case TablesLoggerArgs::BINARY: {
+            // Create individual file for this section if required.
+            if (_opt.multi_files) {
+                _report.verbose("creating " + data.file_name);
+                _outfile.open(data.file_name.c_str(), std::ios::out | std::ios::binary);
+                if (!_outfile) {
+                    _report.error("error creating " + data.file_name);
+                    _abort = true;
+                    return;
+                }
+            }
+            // Write the sections to the file
+            _outfile.write(reinterpret_cast<const char*>(data.data.data()), std::streamsize(data.data.size()));
+            if (!_outfile) {
+                _report.error("error writing section into binary stream");
+                _abort = true;
+            }
+            // Close individual files
+            if (_opt.multi_files) {
+                _outfile.close();
+            }
+            break;
+        }
+
+        case TablesLoggerArgs::UDP: {
+            // Send TLV message or raw sections over UDP
+            _sock.send(data.data.data(), data.data.size(), _report);
+            break;
+        }
+
+        default: {
+            // Should never get there
+            assert(false);
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Initial spacing, before the first text output.
+//----------------------------------------------------------------------------
+
+void ts::TablesLogger::startText(std::ostream& strm)
+{
+    if (!_text_started) {
+        _text_started = true;
+        if (!_opt.logger) {
+            strm << std::endl;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Build the binary output data for a section.
+//----------------------------------------------------------------------------
+
+void ts::TablesLogger::binarySection(OutputData& out, const Section& sect) const
+{
+    // Build a unique file name for this section if required.
+    if (_opt.multi_files) {
+        out.file_name = PathPrefix(_opt.destination);
+        out.file_name += Format("_p%04X_t%02X", int(sect.sourcePID()), int(sect.tableId()));
+        if (sect.isLongSection()) {
+            out.file_name += Format("_e%04X_v%02X_s%02X", int(sect.tableIdExtension()), int(sect.version()), int(sect.sectionNumber()));
+        }
+        out.file_name += PathSuffix(_opt.destination);
+    }
+    if (sect.isValid()) {
+        out.data.append(sect.content(), sect.size());
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Demux worker constructor and destructor.
+//----------------------------------------------------------------------------
+
+ts::TablesLogger::Worker::Worker(TablesLogger& logger, bool threaded) :
+    Thread(),
+    TableHandlerInterface(),
+    SectionHandlerInterface(),
+    _demux(0, 0, threaded ? AllPIDs : logger._opt.pid),
+    _logger(logger),
+    _threaded(threaded),
+    _cas(CAS_OTHER),
+    _own_display(logger._display.options(), logger._report),
+    _display(threaded ? _own_display : logger._display),
+    _text(),
+    _shortSections(),
+    _queue(WORKER_QUEUE_SIZE),
+    _batch()
+{
+    // Set either a table or section handler, depending on --all-sections
+    if (_logger._opt.all_sections) {
+        _demux.setSectionHandler(this);
+    }
+    else {
+        _demux.setTableHandler(this);
+    }
+
+    // With a worker thread, format text in memory. It is written by the output thread.
+    if (_threaded) {
+        _own_display.redirect(_text);
+    }
+}
+
+ts::TablesLogger::Worker::~Worker()
+{
+    waitForTermination();
+}
+
+
+//----------------------------------------------------------------------------
+// Pass packets to a worker thread, in batches.
+//----------------------------------------------------------------------------
+
+void ts::TablesLogger::Worker::addPacket(const TSPacket& pkt, PacketCounter index, CASFamily cas)
+{
+    if (_batch.isNull()) {
+        _batch = new WorkerPacketVector;
+        _batch->reserve(WORKER_BATCH_SIZE);
+    }
+    _batch->resize(_batch->size() + 1);
+    WorkerPacket& wp(_batch->back());
+    wp.packet = pkt;
+    wp.index = index;
+    wp.cas = cas;
+    if (_batch->size() >= WORKER_BATCH_SIZE) {
+        flushBatch();
+    }
+}
+
+void ts::TablesLogger::Worker::flushBatch()
+{
+    if (!_batch.isNull() && !_batch->empty()) {
+        // Wait when the queue is full, no packet is lost.
+        _queue.enqueue(_batch);
+        _batch.clear();
+    }
+}
+
+void ts::TablesLogger::Worker::terminate()
+{
+    // A null batch is the end of processing.
+    _queue.forceEnqueue(WorkerQueue::MessagePtr());
+}
+
+
+//----------------------------------------------------------------------------
+// Worker thread main code.
+//----------------------------------------------------------------------------
+
+void ts::TablesLogger::Worker::main()
+{
+    WorkerQueue::MessagePtr batch;
+    while (_queue.dequeue(batch) && !batch.isNull()) {
+        for (WorkerPacketVector::const_iterator it = batch->begin(); it != batch->end(); ++it) {
+            // Keep the packet index of sections relative to the complete stream.
+            _cas = it->cas;
+            _demux.setPacketIndex(it->index);
+            _demux.feedPacket(it->packet);
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// CAS family of a PID, for the section being processed.
+//----------------------------------------------------------------------------
+
+ts::CASFamily ts::TablesLogger::Worker::casFamily(PID pid) const
+{
+    return _threaded ? _cas : _logger._cas_mapper.casFamily(pid);
+}
+
+
 //----------------------------------------------------------------------------
 // This hook is invoked when a complete table is available.
 //----------------------------------------------------------------------------
 
-void ts::TablesLogger::handleTable(SectionDemux&, const BinaryTable& table)
+void ts::TablesLogger::Worker::handleTable(SectionDemux&, const BinaryTable& table)
 {
+    const TablesLoggerArgs& opt(_logger._opt);
+
     // Give up if completed.
-    if (completed()) {
+    if (_logger.completed()) {
         return;
     }
 
     assert(table.sectionCount() > 0);
     const PID pid = table.sourcePID();
+    const CASFamily cas = casFamily(pid);
 
     // Add PMT PID's when necessary
-    if (_opt.add_pmt_pids && table.tableId() == TID_PAT) {
+    if (opt.add_pmt_pids && table.tableId() == TID_PAT) {
         PAT pat(table);
         if (pat.isValid()) {
             if (pat.nit_pid != PID_NULL) {
-                _demux.addPID(pat.nit_pid);
+                _logger.addPID(pat.nit_pid);
             }
             for (PAT::ServiceMap::const_iterator it = pat.pmts.begin(); it != pat.pmts.end(); ++it) {
-                _demux.addPID(it->second);
+                _logger.addPID(it->second);
             }
         }
     }
 
     // Ignore table if not to be filtered
-    if (!isFiltered(*table.sectionAt(0), _cas_mapper.casFamily(table.sourcePID()))) {
+    if (!_logger.isFiltered(*table.sectionAt(0), cas)) {
         return;
     }
 
     // Ignore duplicate tables with a short section.
-    if (_opt.no_duplicate && table.isShortSection()) {
+    if (opt.no_duplicate && table.isShortSection()) {
         if (_shortSections[pid].isNull() || *_shortSections[pid] != *table.sectionAt(0)) {
             // Not the same section, keep it for next time.
             _shortSections[pid] = new Section(*table.sectionAt(0), COPY);
@@ -182,35 +511,47 @@ void ts::TablesLogger::handleTable(SectionDemux&, const BinaryTable& table)
         }
     }
 
-    switch (_opt.mode) {
+    // Check max table count.
+    if (!_logger.countTable()) {
+        return;
+    }
+
+    switch (opt.mode) {
 
         case TablesLoggerArgs::TEXT: {
             preDisplay(table.getFirstTSPacketIndex(), table.getLastTSPacketIndex());
-            if (_opt.logger) {
+            if (opt.logger) {
                 // Short log message
-                logSection(*table.sectionAt(0));
+                _logger.logSection(_display, *table.sectionAt(0), cas);
             }
             else {
                 // Full table formatting
-                _display.displayTable(table, 0, _cas_mapper.casFamily(pid)) << std::endl;
+                _display.displayTable(table, 0, cas) << std::endl;
             }
             postDisplay();
             break;
         }
 
         case TablesLoggerArgs::BINARY: {
-            // Save each section in binary format
+            // Save each section in binary format, one output per file.
+            OutputQueue::MessagePtr out(new OutputData);
             for (size_t i = 0; i < table.sectionCount(); ++i) {
-                saveSection(*table.sectionAt(i));
+                if (opt.multi_files && i > 0) {
+                    _logger.output(out);
+                    out = new OutputData;
+                }
+                _logger.binarySection(*out, *table.sectionAt(i));
             }
+            _logger.output(out);
             break;
         }
 
         case TablesLoggerArgs::UDP: {
-            ByteBlock bb;
+            OutputQueue::MessagePtr out(new OutputData);
+            ByteBlock& bb(out->data);
             // Minimize allocation by reserving over size
             bb.reserve(table.totalSize() + 32 + 4 * table.sectionCount());
-            if (_opt.udp_raw) {
+            if (opt.udp_raw) {
                 // Add raw content of each section the message
                 for (size_t i = 0; i < table.sectionCount(); ++i) {
                     const Section& sect(*table.sectionAt(i));
@@ -219,13 +560,13 @@ void ts::TablesLogger::handleTable(SectionDemux&, const BinaryTable& table)
             }
             else {
                 // Build a TLV message. Each section is a separate PRM_SECTION parameter.
-                startMessage(bb, tlv::MSG_LOG_TABLE, pid);
+                _logger.startMessage(bb, tlv::MSG_LOG_TABLE, pid);
                 for (size_t i = 0; i < table.sectionCount(); ++i) {
-                    addSection(bb, *table.sectionAt(i));
+                    _logger.addSection(bb, *table.sectionAt(i));
                 }
             }
             // Send TLV message over UDP
-            _sock.send(bb.data(), bb.size(), _report);
+            _logger.output(out);
             break;
         }
 
@@ -234,12 +575,6 @@ void ts::TablesLogger::handleTable(SectionDemux&, const BinaryTable& table)
             assert(false);
         }
     }
-
-    // Check max table count
-    _table_count++;
-    if (_opt.max_tables > 0 && _table_count >= _opt.max_tables) {
-        _exit = true;
-    }
 }
 
 
@@ -248,29 +583,28 @@ void ts::TablesLogger::handleTable(SectionDemux&, const BinaryTable& table)
 // Only used with option --all-sections
 //----------------------------------------------------------------------------
 
-void ts::TablesLogger::handleSection(SectionDemux&, const Section& sect)
+void ts::TablesLogger::Worker::handleSection(SectionDemux&, const Section& sect)
 {
-    // Give up if completed.
-    if (completed()) {
-        return;
-    }
+    const TablesLoggerArgs& opt(_logger._opt);
+    const CASFamily cas = casFamily(sect.sourcePID());
 
-    // Ignore section if not to be filtered
-    if (!isFiltered(sect, _cas_mapper.casFamily(sect.sourcePID()))) {
+    // Give up if completed. Ignore section if not to be filtered.
+    // Check max table count (actually count sections with --all-sections).
+    if (_logger.completed() || !_logger.isFiltered(sect, cas) || !_logger.countTable()) {
         return;
     }
 
-    switch (_opt.mode) {
+    switch (opt.mode) {
 
         case TablesLoggerArgs::TEXT: {
             preDisplay(sect.getFirstTSPacketIndex(), sect.getLastTSPacketIndex());
-            if (_opt.logger) {
+            if (opt.logger) {
                 // Short log message
-                logSection(sect);
+                _logger.logSection(_display, sect, cas);
             }
             else {
                 // Full section formatting.
-                _display.displaySection(sect, 0, _cas_mapper.casFamily(sect.sourcePID())) << std::endl;
+                _display.displaySection(sect, 0, cas) << std::endl;
             }
             postDisplay();
             break;
@@ -278,25 +612,28 @@ void ts::TablesLogger::handleSection(SectionDemux&, const Section& sect)
 
         case TablesLoggerArgs::BINARY: {
             // Save section in binary format
-            saveSection(sect);
+            OutputQueue::MessagePtr out(new OutputData);
+            _logger.binarySection(*out, sect);
+            _logger.output(out);
             break;
         }
 
         case TablesLoggerArgs::UDP: {
-            if (_opt.udp_raw) {
+            OutputQueue::MessagePtr out(new OutputData);
+            ByteBlock& bb(out->data);
+            if (opt.udp_raw) {
                 // Send raw content of section as one single UDP message
-                _sock.send(sect.content(), sect.size(), _report);
+                bb.copy(sect.content(), sect.size());
             }
             else {
-                ByteBlock bb;
                 // Minimize allocation by reserving over size
                 bb.reserve(sect.size() + 32);
                 // Build a TLV message with one PRM_SECTION parameter.
-                startMessage(bb, tlv::MSG_LOG_SECTION, sect.sourcePID());
-                addSection(bb, sect);
-                // Send TLV message over UDP
-                _sock.send(bb.data(), bb.size(), _report);
+                _logger.startMessage(bb, tlv::MSG_LOG_SECTION, sect.sourcePID());
+                _logger.addSection(bb, sect);
             }
+            // Send TLV message over UDP
+            _logger.output(out);
             break;
         }
 
@@ -305,48 +642,81 @@ void ts::TablesLogger::handleSection(SectionDemux&, const Section& sect)
             assert(false);
         }
     }
-
-    // Check max table count (actually count sections with --all-sections)
-    _table_count++;
-    if (_opt.max_tables > 0 && _table_count >= _opt.max_tables) {
-        _exit = true;
-    }
 }
 
 
 //----------------------------------------------------------------------------
-//  Save a section in a binary file
+//  Display header information, before a table
 //----------------------------------------------------------------------------
 
-void ts::TablesLogger::saveSection(const Section& sect)
+void ts::TablesLogger::Worker::preDisplay(PacketCounter first, PacketCounter last)
 {
-    // Create individual file for this section if required.
-    if (_opt.multi_files) {
-        // Build a unique file name for this section
-        std::string outname(PathPrefix(_opt.destination));
-        outname += Format("_p%04X_t%02X", int(sect.sourcePID()), int(sect.tableId()));
-        if (sect.isLongSection()) {
-            outname += Format("_e%04X_v%02X_s%02X", int(sect.tableIdExtension()), int(sect.version()), int(sect.sectionNumber()));
+    const TablesLoggerArgs& opt(_logger._opt);
+    std::ostream& strm(_display.out());
+
+    // Initial spacing. With worker threads, this is done by the output thread.
+    if (!_threaded) {
+        _logger.startText(strm);
+    }
+
+    // Display time stamp if required
+    if ((opt.time_stamp || opt.packet_index) && !opt.logger) {
+        strm << "* ";
+        if (opt.time_stamp) {
+            strm << "At " << Time::CurrentLocalTime();
         }
-        outname += PathSuffix(_opt.destination);
-        // Create the output file
-        _report.verbose("creating " + outname);
-        _outfile.open(outname.c_str(), std::ios::out | std::ios::binary);
-        if (!_outfile) {
-            _report.error("error creating " + outname);
-            _abort = true;
-            return;
+        if (opt.packet_index && opt.time_stamp) {
+            strm << ", ";
+        }
+        if (opt.packet_index) {
+            strm << "First TS packet: " << Decimal(first) << ", last: " << Decimal(last);
         }
+        strm << std::endl;
     }
+}
+
+
+//----------------------------------------------------------------------------
+//  Post-display action
+//----------------------------------------------------------------------------
 
-    // Write the section to the file
-    if (!sect.write(_outfile, _report)) {
-        _abort = true;
+void ts::TablesLogger::Worker::postDisplay()
+{
+    if (_threaded) {
+        // Pass the formatted text to the output thread.
+        OutputQueue::MessagePtr out(new OutputData);
+        out->text = _text.str();
+        _text.str(std::string());
+        _logger.output(out);
     }
+    else if (_logger._opt.flush) {
+        // Flush output file if required
+        _display.flush();
+    }
+}
 
-    // Close individual files
-    if (_opt.multi_files) {
-        _outfile.close();
+
+//----------------------------------------------------------------------------
+// Output thread.
+//----------------------------------------------------------------------------
+
+ts::TablesLogger::OutputThread::OutputThread(TablesLogger& logger) :
+    Thread(),
+    _logger(logger)
+{
+}
+
+ts::TablesLogger::OutputThread::~OutputThread()
+{
+    waitForTermination();
+}
+
+void ts::TablesLogger::OutputThread::main()
+{
+    // A null message is the end of processing.
+    OutputQueue::MessagePtr data;
+    while (_logger._output_queue.dequeue(data) && !data.isNull()) {
+        _logger.writeOutput(*data);
     }
 }
 
@@ -355,7 +725,7 @@ void ts::TablesLogger::saveSection(const Section& sect)
 //  Log a table (option --log)
 //----------------------------------------------------------------------------
 
-void ts::TablesLogger::logSection(const Section& sect)
+void ts::TablesLogger::logSection(TablesDisplay& display, const Section& sect, CASFamily cas)
 {
     std::string header;
 
@@ -382,7 +752,7 @@ void ts::TablesLogger::logSection(const Section& sect)
     header += ": ";
 
     // Output the line through the display object.
-    _display.logSectionData(sect, header, _opt.log_size, _cas_mapper.casFamily(sect.sourcePID()));
+    display.logSectionData(sect, header, _opt.log_size, cas);
 }
 
 
@@ -405,49 +775,6 @@ bool ts::TablesLogger::isFiltered(const Section& sect, CASFamily cas) const
 }
 
 
-//----------------------------------------------------------------------------
-//  Display header information, before a table
-//----------------------------------------------------------------------------
-
-void ts::TablesLogger::preDisplay(PacketCounter first, PacketCounter last)
-{
-    std::ostream& strm(_display.out());
-
-    // Initial spacing
-    if (_table_count == 0 && !_opt.logger) {
-        strm << std::endl;
-    }
-
-    // Display time stamp if required
-    if ((_opt.time_stamp || _opt.packet_index) && !_opt.logger) {
-        strm << "* ";
-        if (_opt.time_stamp) {
-            strm << "At " << Time::CurrentLocalTime();
-        }
-        if (_opt.packet_index && _opt.time_stamp) {
-            strm << ", ";
-        }
-        if (_opt.packet_index) {
-            strm << "First TS packet: " << Decimal(first) << ", last: " << Decimal(last);
-        }
-        strm << std::endl;
-    }
-}
-
-
-//----------------------------------------------------------------------------
-//  Post-display action
-//----------------------------------------------------------------------------
-
-void ts::TablesLogger::postDisplay()
-{
-    // Flush output file if required
-    if (_opt.flush) {
-        _display.flush();
-    }
-}
-
-
 //----------------------------------------------------------------------------
 //  Build header of a TLV message
 //----------------------------------------------------------------------------
@@ -495,8 +822,18 @@ void ts::TablesLogger::addSection(ByteBlock& bb, const Section& sect)
 
 void ts::TablesLogger::reportDemuxErrors(std::ostream& strm)
 {
-    if (_demux.hasErrors()) {
-        SectionDemux::Status status(_demux);
+    // Accumulate the errors of all demuxes.
+    SectionDemux::Status status;
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        const SectionDemux::Status st(_workers[i]->_demux);
+        status.invalid_ts += st.invalid_ts;
+        status.discontinuities += st.discontinuities;
+        status.scrambled += st.scrambled;
+        status.inv_sect_length += st.inv_sect_length;
+        status.inv_sect_index += st.inv_sect_index;
+        status.wrong_crc += st.wrong_crc;
+    }
+    if (status.hasErrors()) {
         strm << "* PSI/SI analysis errors:" << std::endl;
         status.display(strm, 4, true);
     }
@@ -40,14 +40,24 @@
 #include "tsSocketAddress.h"
 #include "tsUDPSocket.h"
 #include "tsCASMapper.h"
+#include "tsMessageQueue.h"
+#include "tsThread.h"
+#include "tsMutex.h"
+#include <sstream>
 
 namespace ts {
     //!
     //! This class logs sections and tables.
     //!
-    class TSDUCKDLL TablesLogger : 
-        protected TableHandlerInterface,
-        protected SectionHandlerInterface
+    //! By default, all PID's are demultiplexed and all tables are formatted and
+    //! written in the caller's thread, from feedPacket(). When the option @c threads
+    //! is not zero, the PID's are sharded across this number of worker threads,
+    //! each one with its own demux, and the output (text, binary or UDP) is written
+    //! in a separate thread. All queues between threads are bounded. The sections
+    //! from a given PID are always processed in the order of the stream but the
+    //! relative order of sections from distinct PID's may change.
+    //!
+    class TSDUCKDLL TablesLogger
     {
     public:
         //!
@@ -69,6 +79,13 @@ namespace ts {
         //!
         void feedPacket(const TSPacket& pkt);
 
+        //!
+        //! Process all pending packets and stop the worker threads, if any.
+        //! After this call, no more packet shall be fed into the logger.
+        //! Automatically invoked by the destructor.
+        //!
+        void close();
+
         //!
         //! Check if an error was found.
         //! @return True when an error was found.
@@ -89,23 +106,23 @@ namespace ts {
 
         //!
         //! Report the demux errors (if any).
+        //! With worker threads, invoke close() first.
         //! @param [in,out] strm Output text stream.
         //!
         void reportDemuxErrors(std::ostream& strm);
 
     protected:
-        // Implementation of interfaces.
-        virtual void handleTable(SectionDemux&, const BinaryTable&);
-        virtual void handleSection(SectionDemux&, const Section&);
-
         //!
         //! Log a section (option @c --log).
+        //! @param [in,out] display Object to display the section.
         //! @param [in] section The section to log.
+        //! @param [in] cas The CAS family for this section.
         //!
-        virtual void logSection(const Section& section);
+        virtual void logSection(TablesDisplay& display, const Section& section, CASFamily cas);
 
         //!
         //! Check if a specific section must be filtered and displayed.
+        //! This method may be invoked from several worker threads.
         //! @param [in] section The section to check.
         //! @param [in] cas The CAS family for this section.
         //! @return True if the section is filtered and must be displayed.
@@ -114,25 +131,151 @@ namespace ts {
         virtual bool isFiltered(const Section& section, CASFamily cas) const;
 
     private:
+        // Number of packets in a batch which is passed to a worker thread.
+        static const size_t WORKER_BATCH_SIZE = 128;
+
+        // Maximum number of batches in the queue of a worker thread.
+        static const size_t WORKER_QUEUE_SIZE = 64;
+
+        // Number of packets after which incomplete batches are passed to the workers.
+        static const size_t WORKER_FLUSH_INTERVAL = 4096;
+
+        // Maximum number of pending messages for the output thread.
+        static const size_t OUTPUT_QUEUE_SIZE = 1024;
+
+        // A TS packet which is passed to a worker thread.
+        struct WorkerPacket
+        {
+            TSPacket      packet;  // The TS packet.
+            PacketCounter index;   // Index of the packet in the complete stream.
+            CASFamily     cas;     // CAS family of the packet's PID at this point.
+        };
+        typedef std::vector<WorkerPacket> WorkerPacketVector;
+        typedef MessageQueue<WorkerPacketVector, Mutex> WorkerQueue;
+
+        // Data to write on the output, binary sections or UDP message.
+        struct OutputData
+        {
+            std::string text;       // Formatted text (TEXT mode).
+            std::string file_name;  // Binary output file name (BINARY mode with multiple files).
+            ByteBlock   data;       // Binary sections (BINARY mode) or UDP message (UDP mode).
+            OutputData() : text(), file_name(), data() {}
+        };
+        typedef MessageQueue<OutputData, Mutex> OutputQueue;
+
+        // A demux and its context. Without worker thread, one single instance
+        // is used in the caller's thread. Otherwise, each instance is a thread.
+        class Worker: public Thread, private TableHandlerInterface, private SectionHandlerInterface
+        {
+        public:
+            // Constructor and destructor.
+            Worker(TablesLogger& logger, bool threaded);
+            virtual ~Worker();
+
+            // Add a packet in the current batch, pass the batch to the thread when full.
+            void addPacket(const TSPacket& pkt, PacketCounter index, CASFamily cas);
+
+            // Pass the current batch to the thread, if not empty.
+            void flushBatch();
+
+            // Terminate the thread after processing all pending batches.
+            void terminate();
+
+            // Usage statistics of the display cache.
+            const TablesDisplayCache::Statistics& cacheStatistics() const
+            {
+                return _display.cacheStatistics();
+            }
+
+            SectionDemux _demux;   // The demux. Public for the logger.
+
+        private:
+            TablesLogger&       _logger;
+            const bool          _threaded;
+            CASFamily           _cas;            // CAS family of the current packet.
+            TablesDisplay       _own_display;    // Formatting into _text, with worker thread.
+            TablesDisplay&      _display;        // Actual display to use.
+            std::ostringstream  _text;           // Formatted text, with worker thread.
+            std::map<PID,SectionPtr> _shortSections;   // Tracking duplicate short sections by PID.
+            WorkerQueue         _queue;          // Queue of batches to process.
+            WorkerQueue::MessagePtr _batch;      // Current batch, being filled by the caller.
+
+            // CAS family of a PID, for the section being processed.
+            CASFamily casFamily(PID pid) const;
+
+            // Implementation of interfaces.
+            virtual void main() override;
+            virtual void handleTable(SectionDemux&, const BinaryTable&) override;
+            virtual void handleSection(SectionDemux&, const Section&) override;
+
+            // Pre/post-display of a table or section.
+            void preDisplay(PacketCounter first, PacketCounter last);
+            void postDisplay();
+
+            // Inaccessible operations.
+            Worker() = delete;
+            Worker(const Worker&) = delete;
+            Worker& operator=(const Worker&) = delete;
+        };
+
+        // The thread which writes all output, with worker threads.
+        class OutputThread: public Thread
+        {
+        public:
+            OutputThread(TablesLogger& logger);
+            virtual ~OutputThread();
+        private:
+            TablesLogger& _logger;
+            virtual void main() override;
+
+            // Inaccessible operations.
+            OutputThread() = delete;
+            OutputThread(const OutputThread&) = delete;
+            OutputThread& operator=(const OutputThread&) = delete;
+        };
+
         const TablesLoggerArgs& _opt;
         TablesDisplay&   _display;
         ReportInterface& _report;
-        bool             _abort;
-        bool             _exit;
+        volatile bool    _abort;
+        volatile bool    _exit;
+        bool             _closed;
+        bool             _text_started;    // Some text was already written.
         uint32_t         _table_count;
         PacketCounter    _packet_count;
-        SectionDemux     _demux;
         CASMapper        _cas_mapper;
-        std::ofstream    _outfile;  // Binary output file.
-        UDPSocket        _sock;     // Output socket.
-        std::map<PID,SectionPtr> _shortSections;   // Tracking duplicate short sections by PID.
+        std::ofstream    _outfile;         // Binary output file.
+        UDPSocket        _sock;            // Output socket.
+        Mutex            _mutex;           // Protect shared data between worker threads.
+        std::vector<Worker*> _workers;     // Worker threads, or one single demux.
+        PIDSet           _pid_filter;      // Packets to pass to the worker threads.
+        PIDSet           _added_pids;      // PID's added by worker threads, protected by _mutex.
+        volatile bool    _pids_changed;    // _added_pids was modified.
+        size_t           _flush_countdown; // Packets until next flush of incomplete batches.
+        OutputQueue      _output_queue;    // Queue of output messages.
+        OutputThread*    _output_thread;   // Writes the output, with worker threads.
+
+        // Check if worker threads are used.
+        bool threaded() const
+        {
+            return _output_thread != 0;
+        }
 
-        // Save a section in a binary file
-        void saveSection(const Section&);
+        // Count a new table to log. Return false if the logging is completed.
+        bool countTable();
 
-        // Pre/post-display of a table or section
-        void preDisplay(PacketCounter first, PacketCounter last);
-        void postDisplay();
+        // Add a PID to filter (option --psi-si).
+        void addPID(PID pid);
+
+        // Write output data, immediately or in the output thread.
+        void output(const OutputQueue::MessagePtr& data);
+        void writeOutput(const OutputData& data);
+
+        // Initial spacing, before the first text output.
+        void startText(std::ostream& strm);
+
+        // Build the output data for a section.
+        void binarySection(OutputData& out, const Section& section) const;
 
         // Build header of a TLV message
         void startMessage(ByteBlock&, uint16_t message_type, PID pid);
@@ -140,7 +283,6 @@ namespace ts {
         // Add a section into a TLV message
         void addSection(ByteBlock&, const Section&);
 
-    private:
         // Inaccessible operations.
         TablesLogger() = delete;
         TablesLogger(const TablesLogger&) = delete;
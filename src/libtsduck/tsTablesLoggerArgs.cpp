@@ -65,6 +65,7 @@ ts::TablesLoggerArgs::TablesLoggerArgs() :
     pid(),
     add_pmt_pids(false),
     no_duplicate(false),
+    threads(0),
     tid(),
     tidext()
 {
@@ -189,6 +190,14 @@ void ts::TablesLoggerArgs::addHelp(Args& args) const
         "      and BAT. Note that EIT, TDT and TOT are not included. Use --pid 18\n"
         "      to get EIT and --pid 20 to get TDT and TOT.\n"
         "\n"
+        "  --threads value\n"
+        "      Use the specified number of worker threads. The PID's are shared among\n"
+        "      the threads, each one with its own demux, and the output is written in\n"
+        "      a separate thread. The sections from a PID are always processed in order\n"
+        "      but sections from distinct PID's may be reordered. Useful when logging\n"
+        "      many PID's with costly formatting, EIT's for instance. By default, all\n"
+        "      tables are processed and written synchronously.\n"
+        "\n"
         "  -t value\n"
         "  --tid value\n"
         "      TID filter: select sections with this TID (table id) value.\n"
@@ -247,6 +256,7 @@ void ts::TablesLoggerArgs::defineOptions(Args& args) const
     args.option("packet-index",         0);
     args.option("pid",                 'p', Args::PIDVAL, 0, Args::UNLIMITED_COUNT);
     args.option("psi-si",               0);
+    args.option("threads",              0,  Args::UNSIGNED);
     args.option("tid",                 't', Args::UINT8,  0, Args::UNLIMITED_COUNT);
     args.option("tid-ext",             'e', Args::UINT16, 0, Args::UNLIMITED_COUNT);
     args.option("time-stamp",           0);
@@ -276,6 +286,7 @@ void ts::TablesLoggerArgs::load(Args& args)
     negate_tid = args.present("negate-tid");
     negate_tidext = args.present("negate-tid-ext");
     no_duplicate = args.present("no-duplicate");
+    threads = args.intValue<size_t>("threads", 0);
 
     if (args.present("verbose")) {
         args.setDebugLevel(Severity::Verbose);
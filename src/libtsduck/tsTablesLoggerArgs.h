@@ -82,6 +82,7 @@ namespace ts {
         PIDSet       pid;             //!< PID values to filter.
         bool         add_pmt_pids;    //!< Add PMT PID's when one is found.
         bool         no_duplicate;    //!< Exclude duplicated short sections on a PID.
+        size_t       threads;         //!< Number of demux worker threads, zero means none.
         std::set<uint8_t>  tid;       //!< TID values to filter.
         std::set<uint16_t> tidext;    //!< TID-ext values to filter.
 
@@ -171,6 +171,12 @@ bool ts::Thread::start()
         return false;
     }
 
+    // Set the CPU affinity.
+    if (!_attributes._cpus.empty() && ::SetThreadAffinityMask(_handle, Win32AffinityMask(_attributes._cpus)) == 0) {
+        ::CloseHandle(_handle);
+        return false;
+    }
+
     // Release the thread
     if (::ResumeThread(_handle) == ::DWORD(-1)) {
         ::CloseHandle(_handle);
@@ -201,7 +207,7 @@ bool ts::Thread::start()
     // But pthread_attr_setschedpolicy second argument is signed:
     //   int pthread_attr_setschedpolicy(pthread_attr_t *attr, int policy);
     // coverity[NEGATIVE_RETURNS]
-    if (::pthread_attr_setschedpolicy(&attr, ThreadAttributes::PthreadSchedulingPolicy()) != 0) {
+    if (::pthread_attr_setschedpolicy(&attr, ThreadAttributes::PthreadSchedulingPolicy(_attributes._policy)) != 0) {
         ::pthread_attr_destroy(&attr);
         return false;
     }
@@ -217,6 +223,16 @@ bool ts::Thread::start()
         ::pthread_attr_destroy(&attr);
         return false;
     }
+#if defined(__linux)
+    // Set the CPU affinity. Ignored on MacOS which has no such feature.
+    if (!_attributes._cpus.empty()) {
+        ::cpu_set_t cpus;
+        if (!PthreadCPUSet(cpus, _attributes._cpus) || ::pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus) != 0) {
+            ::pthread_attr_destroy(&attr);
+            return false;
+        }
+    }
+#endif
     // Create the thread
     if (::pthread_create(&_pthread, &attr, Thread::ThreadProc, this) != 0) {
         ::pthread_attr_destroy(&attr);
@@ -234,6 +250,90 @@ bool ts::Thread::start()
 }
 
 
+//----------------------------------------------------------------------------
+// Conversions between CPU sets and system-specific representations.
+//----------------------------------------------------------------------------
+
+#if defined(__windows)
+
+::DWORD_PTR ts::Thread::Win32AffinityMask(const ThreadAttributes::CPUSet& cpus)
+{
+    // Only the CPU's in the first processor group can be used.
+    ::DWORD_PTR mask = 0;
+    for (ThreadAttributes::CPUSet::const_iterator it = cpus.begin(); it != cpus.end(); ++it) {
+        if (*it < 8 * sizeof(::DWORD_PTR)) {
+            mask |= ::DWORD_PTR(1) << *it;
+        }
+    }
+    return mask;
+}
+
+#elif defined(__linux)
+
+bool ts::Thread::PthreadCPUSet(::cpu_set_t& sys_cpus, const ThreadAttributes::CPUSet& cpus)
+{
+    CPU_ZERO(&sys_cpus);
+    for (ThreadAttributes::CPUSet::const_iterator it = cpus.begin(); it != cpus.end(); ++it) {
+        if (*it >= CPU_SETSIZE) {
+            return false;
+        }
+        CPU_SET(*it, &sys_cpus);
+    }
+    return true;
+}
+
+#endif
+
+
+//----------------------------------------------------------------------------
+// Get / set the CPU affinity of the calling thread.
+//----------------------------------------------------------------------------
+
+bool ts::Thread::GetCurrentThreadAffinity(ThreadAttributes::CPUSet& cpus)
+{
+    cpus.clear();
+#if defined(__linux)
+    ::cpu_set_t sys_cpus;
+    if (::pthread_getaffinity_np(::pthread_self(), sizeof(sys_cpus), &sys_cpus) != 0) {
+        return false;
+    }
+    for (size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &sys_cpus)) {
+            cpus.insert(cpu);
+        }
+    }
+    return true;
+#elif defined(__windows)
+    // There is no GetThreadAffinityMask, use the process affinity.
+    ::DWORD_PTR process_mask = 0;
+    ::DWORD_PTR system_mask = 0;
+    if (::GetProcessAffinityMask(::GetCurrentProcess(), &process_mask, &system_mask) == 0) {
+        return false;
+    }
+    for (size_t cpu = 0; cpu < 8 * sizeof(::DWORD_PTR); ++cpu) {
+        if ((process_mask & (::DWORD_PTR(1) << cpu)) != 0) {
+            cpus.insert(cpu);
+        }
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool ts::Thread::SetCurrentThreadAffinity(const ThreadAttributes::CPUSet& cpus)
+{
+#if defined(__linux)
+    ::cpu_set_t sys_cpus;
+    return !cpus.empty() && PthreadCPUSet(sys_cpus, cpus) && ::pthread_setaffinity_np(::pthread_self(), sizeof(sys_cpus), &sys_cpus) == 0;
+#elif defined(__windows)
+    return !cpus.empty() && ::SetThreadAffinityMask(::GetCurrentThread(), Win32AffinityMask(cpus)) != 0;
+#else
+    return false;
+#endif
+}
+
+
 //----------------------------------------------------------------------------
 // Wait for thread termination.
 //----------------------------------------------------------------------------
@@ -180,6 +180,24 @@ namespace ts {
         //!
         bool isCurrentThread() const;
 
+        //!
+        //! Get the CPU affinity of the calling thread.
+        //! On Windows, this is the CPU affinity of the process.
+        //! On MacOS, CPU affinity is not supported and this method always fails.
+        //! @param [out] cpus The set of CPU's where the calling thread may run.
+        //! @return True on success, false on error.
+        //!
+        static bool GetCurrentThreadAffinity(ThreadAttributes::CPUSet& cpus);
+
+        //!
+        //! Set the CPU affinity of the calling thread.
+        //! This is typically used by the main thread of an application, which is not a Thread object.
+        //! On MacOS, CPU affinity is not supported and this method always fails.
+        //! @param [in] cpus The set of CPU's where the calling thread may run. Must not be empty.
+        //! @return True on success, false on error.
+        //!
+        static bool SetCurrentThreadAffinity(const ThreadAttributes::CPUSet& cpus);
+
         //!
         //! This hook is invoked in the context of the thread.
         //!
@@ -208,10 +226,16 @@ namespace ts {
         ::DWORD _thread_id;
         // Actual starting point of thread. Parameter is "this".
         static ::DWORD WINAPI ThreadProc(::LPVOID parameter);
+        // Build an affinity mask from a set of CPU's.
+        static ::DWORD_PTR Win32AffinityMask(const ThreadAttributes::CPUSet& cpus);
 #else
         pthread_t _pthread;
         // Actual starting point of thread. Parameter is "this".
         static void* ThreadProc(void* parameter);
+#if defined(__linux)
+        // Build a system CPU set from a set of CPU's. Return false if a CPU number is too large.
+        static bool PthreadCPUSet(::cpu_set_t& sys_cpus, const ThreadAttributes::CPUSet& cpus);
+#endif
 #endif
     };
 }
@@ -28,6 +28,9 @@
 //----------------------------------------------------------------------------
 
 #include "tsThreadAttributes.h"
+#include "tsStringUtils.h"
+#include "tsToInteger.h"
+#include "tsFormat.h"
 TSDUCK_SOURCE;
 
 
@@ -111,7 +114,145 @@ int ts::ThreadAttributes::PthreadSchedulingPolicy()
     return ::sched_getscheduler(0);
 #endif
 }
+
+int ts::ThreadAttributes::PthreadSchedulingPolicy(SchedulingPolicy policy)
+{
+#if defined(__linux)
+    switch (policy) {
+        case FIFO_SCHEDULING:
+            return SCHED_FIFO;
+        case ROUND_ROBIN_SCHEDULING:
+            return SCHED_RR;
+        case DEFAULT_SCHEDULING:
+        default:
+            return PthreadSchedulingPolicy();
+    }
+#else
+    // Real-time policies are ignored on other systems.
+    return PthreadSchedulingPolicy();
+#endif
+}
+#endif
+
+
+//----------------------------------------------------------------------------
+// Get the priority range of a scheduling policy.
+//----------------------------------------------------------------------------
+
+int ts::ThreadAttributes::GetMinimumPriority(SchedulingPolicy policy)
+{
+#if defined(__linux)
+    if (policy != DEFAULT_SCHEDULING) {
+        const int prio = ::sched_get_priority_min(PthreadSchedulingPolicy(policy));
+        return prio >= 0 ? prio : 0;
+    }
+#endif
+    return GetMinimumPriority();
+}
+
+int ts::ThreadAttributes::GetMaximumPriority(SchedulingPolicy policy)
+{
+#if defined(__linux)
+    if (policy != DEFAULT_SCHEDULING) {
+        const int prio = ::sched_get_priority_max(PthreadSchedulingPolicy(policy));
+        return std::max(prio, GetMinimumPriority(policy));
+    }
 #endif
+    return GetMaximumPriority();
+}
+
+
+//----------------------------------------------------------------------------
+// Get the number of CPU's in the system.
+//----------------------------------------------------------------------------
+
+size_t ts::ThreadAttributes::GetCPUCount()
+{
+#if defined(__windows)
+    ::SYSTEM_INFO info;
+    ::GetSystemInfo(&info);
+    return size_t(info.dwNumberOfProcessors);
+#else
+    const long count = ::sysconf(_SC_NPROCESSORS_CONF);
+    return count > 0 ? size_t(count) : 1;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Get the set of CPU's of a NUMA node.
+//----------------------------------------------------------------------------
+
+bool ts::ThreadAttributes::GetNUMANodeCPUs(size_t node, CPUSet& cpus)
+{
+    cpus.clear();
+#if defined(__linux)
+    // The list of CPU's of each node is available in sysfs.
+    std::ifstream file(Format("/sys/devices/system/node/node%" FMT_SIZE_T "u/cpulist", node).c_str());
+    std::string line;
+    return file && std::getline(file, line) && CPUSetFromString(cpus, line) && !cpus.empty();
+#else
+    return false;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Decode a list of CPU's from a string.
+//----------------------------------------------------------------------------
+
+bool ts::ThreadAttributes::CPUSetFromString(CPUSet& cpus, const std::string& list)
+{
+    cpus.clear();
+
+    StringVector fields;
+    SplitString(fields, list, ',', true);
+    for (StringVector::const_iterator it = fields.begin(); it != fields.end(); ++it) {
+        if (it->empty()) {
+            continue;
+        }
+        const std::string::size_type dash = it->find('-');
+        size_t first = 0;
+        size_t last = 0;
+        if (dash == std::string::npos) {
+            if (!ToInteger(first, *it)) {
+                return false;
+            }
+            last = first;
+        }
+        else if (!ToInteger(first, it->substr(0, dash)) || !ToInteger(last, it->substr(dash + 1)) || last < first) {
+            return false;
+        }
+        for (size_t cpu = first; cpu <= last; ++cpu) {
+            cpus.insert(cpu);
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Format a set of CPU's as a string.
+//----------------------------------------------------------------------------
+
+std::string ts::ThreadAttributes::CPUSetToString(const CPUSet& cpus)
+{
+    std::string list;
+    CPUSet::const_iterator it = cpus.begin();
+    while (it != cpus.end()) {
+        // Locate a range of contiguous CPU numbers.
+        const size_t first = *it;
+        size_t last = first;
+        while (++it != cpus.end() && *it == last + 1) {
+            last = *it;
+        }
+        if (!list.empty()) {
+            list.append(",");
+        }
+        list.append(last == first ? Format("%" FMT_SIZE_T "u", first) : Format("%" FMT_SIZE_T "u-%" FMT_SIZE_T "u", first, last));
+    }
+    return list;
+}
 
 
 //----------------------------------------------------------------------------
@@ -152,7 +293,9 @@ int ts::ThreadAttributes::Win32Priority(int priority)
 ts::ThreadAttributes::ThreadAttributes() :
     _stackSize(0),
     _deleteWhenTerminated(false),
-    _priority(0)
+    _priority(0),
+    _policy(DEFAULT_SCHEDULING),
+    _cpus()
 {
     if (!_priorityInitialized) {
         InitializePriorities();
@@ -169,6 +312,23 @@ ts::ThreadAttributes& ts::ThreadAttributes::setPriority(int priority)
 {
     // Force within allowed range. Note that the static values where already
     // initialized, no later than the constructor.
-    _priority = std::max(_minimumPriority, std::min(_maximumPriority, priority));
+    if (_policy == DEFAULT_SCHEDULING) {
+        _priority = std::max(_minimumPriority, std::min(_maximumPriority, priority));
+    }
+    else {
+        _priority = std::max(GetMinimumPriority(_policy), std::min(GetMaximumPriority(_policy), priority));
+    }
     return *this;
 }
+
+
+//----------------------------------------------------------------------------
+// Set the scheduling policy for the thread.
+//----------------------------------------------------------------------------
+
+ts::ThreadAttributes& ts::ThreadAttributes::setSchedulingPolicy(SchedulingPolicy policy)
+{
+    // Force the current priority within the range of the new policy.
+    _policy = policy;
+    return setPriority(_priority);
+}
@@ -43,6 +43,20 @@ namespace ts {
     class TSDUCKDLL ThreadAttributes
     {
     public:
+        //!
+        //! A set of CPU numbers, starting at zero.
+        //!
+        typedef std::set<size_t> CPUSet;
+
+        //!
+        //! Scheduling policy of a thread.
+        //!
+        enum SchedulingPolicy {
+            DEFAULT_SCHEDULING,      //!< Same scheduling policy as the current process.
+            FIFO_SCHEDULING,         //!< Real-time first-in first-out policy (SCHED_FIFO on Linux).
+            ROUND_ROBIN_SCHEDULING,  //!< Real-time round-robin policy (SCHED_RR on Linux).
+        };
+
         //!
         //! Default constructor (all attributes have their default values).
         //!
@@ -184,6 +198,105 @@ namespace ts {
             return _priority;
         }
 
+        //!
+        //! Set the scheduling policy for the thread.
+        //! By default, a thread uses the same scheduling policy as the current process.
+        //! Real-time policies usually require privileges (running as root or with
+        //! capability @c CAP_SYS_NICE on Linux). When the privileges are insufficient,
+        //! Thread::start() fails. On Windows and MacOS, the scheduling policy is ignored.
+        //!
+        //! The range of priorities depends on the scheduling policy. The current priority
+        //! is forced within the range of the new policy. Thus, setSchedulingPolicy() should
+        //! be called before setPriority().
+        //! @param [in] policy The scheduling policy for the thread.
+        //! @return A reference to this object.
+        //! @see GetMinimumPriority(SchedulingPolicy)
+        //! @see GetMaximumPriority(SchedulingPolicy)
+        //!
+        ThreadAttributes& setSchedulingPolicy(SchedulingPolicy policy);
+
+        //!
+        //! Get the scheduling policy for the thread.
+        //! @return The scheduling policy for the thread.
+        //! @see setSchedulingPolicy()
+        //!
+        SchedulingPolicy getSchedulingPolicy() const
+        {
+            return _policy;
+        }
+
+        //!
+        //! Set the CPU affinity of the thread.
+        //! The thread will run only on the specified CPU's.
+        //! On MacOS, the CPU affinity is ignored.
+        //! @param [in] cpus The set of CPU's where the thread may run. When empty, the
+        //! thread may run on any CPU (this is the default).
+        //! @return A reference to this object.
+        //!
+        ThreadAttributes& setCPUAffinity(const CPUSet& cpus)
+        {
+            _cpus = cpus;
+            return *this;
+        }
+
+        //!
+        //! Get the CPU affinity of the thread.
+        //! @return A constant reference to the set of CPU's where the thread may run.
+        //! When empty, the thread may run on any CPU.
+        //!
+        const CPUSet& getCPUAffinity() const
+        {
+            return _cpus;
+        }
+
+        //!
+        //! Get the minimum priority for a thread in a given scheduling policy.
+        //! @param [in] policy Scheduling policy.
+        //! @return The minimum priority for a thread using @a policy.
+        //!
+        static int GetMinimumPriority(SchedulingPolicy policy);
+
+        //!
+        //! Get the maximum priority for a thread in a given scheduling policy.
+        //! @param [in] policy Scheduling policy.
+        //! @return The maximum priority for a thread using @a policy.
+        //!
+        static int GetMaximumPriority(SchedulingPolicy policy);
+
+        //!
+        //! Get the number of CPU's in the system.
+        //! @return The number of configured CPU's.
+        //!
+        static size_t GetCPUCount();
+
+        //!
+        //! Get the set of CPU's of a NUMA node.
+        //! This is currently implemented on Linux only.
+        //! @param [in] node NUMA node number.
+        //! @param [out] cpus The set of CPU's of the NUMA node.
+        //! @return True on success, false if the node does not exist or NUMA is not supported.
+        //!
+        static bool GetNUMANodeCPUs(size_t node, CPUSet& cpus);
+
+        //!
+        //! Decode a list of CPU's from a string.
+        //! The string is a comma-separated list of CPU numbers or ranges,
+        //! for instance "0-3,8,10-11". This is the same format as the Linux
+        //! @c taskset command or the @c cpulist files in @c /sys.
+        //! @param [out] cpus Decoded set of CPU's.
+        //! @param [in] list List of CPU's.
+        //! @return True on success, false if @a list is invalid.
+        //!
+        static bool CPUSetFromString(CPUSet& cpus, const std::string& list);
+
+        //!
+        //! Format a set of CPU's as a string.
+        //! @param [in] cpus Set of CPU's.
+        //! @return A comma-separated list of CPU numbers or ranges.
+        //! @see CPUSetFromString()
+        //!
+        static std::string CPUSetToString(const CPUSet& cpus);
+
         //!
         //! Get the minimum priority for a thread in this context of the operating system.
         //! @return The minimum priority for a thread.
@@ -241,6 +354,8 @@ namespace ts {
         size_t _stackSize;
         bool _deleteWhenTerminated;
         int _priority;
+        SchedulingPolicy _policy;
+        CPUSet _cpus;
 
         //
         // These fields describe the operating system priority range.
@@ -283,6 +398,8 @@ namespace ts {
         // This static method is used by the implementation of ts::Thread on Unix
         // to obtain the scheduling policy to use for this process.
         static int PthreadSchedulingPolicy();
+        // Same thing for a given policy.
+        static int PthreadSchedulingPolicy(SchedulingPolicy policy);
 #endif
     };
 }
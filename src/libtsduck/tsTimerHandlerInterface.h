@@ -0,0 +1,70 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Timer handler interface.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+
+namespace ts {
+
+    class TimerWheel;
+
+    //!
+    //! Identifier of a timer in a TimerWheel. Zero is never a valid timer identifier.
+    //!
+    typedef uint64_t TimerId;
+
+    //!
+    //! Timer handler interface.
+    //!
+    //! This abstract interface must be implemented by classes which need to be
+    //! notified of expired timers using a TimerWheel.
+    //!
+    class TSDUCKDLL TimerHandlerInterface
+    {
+    public:
+        //!
+        //! This hook is invoked when a timer expires.
+        //! The handler may schedule or cancel timers in the same wheel,
+        //! including the timer which is being notified.
+        //! @param [in,out] wheel A reference to the timer wheel.
+        //! @param [in] id The identifier of the expired timer, as returned by TimerWheel::schedule().
+        //!
+        virtual void handleTimer(TimerWheel& wheel, TimerId id) = 0;
+
+        //!
+        //! Virtual destructor.
+        //!
+        virtual ~TimerHandlerInterface() {}
+    };
+}
@@ -0,0 +1,328 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Hierarchical timer wheel.
+//
+//----------------------------------------------------------------------------
+
+#include "tsTimerWheel.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+const size_t ts::TimerWheel::LEVELS;
+const size_t ts::TimerWheel::LEVEL_BITS;
+const size_t ts::TimerWheel::LEVEL_SLOTS;
+const size_t ts::TimerWheel::NO_TIMER;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::TimerWheel::TimerWheel() :
+    _started(false),
+    _current(0),
+    _target(0),
+    _active_count(0),
+    _timers(),
+    _free(NO_TIMER),
+    _pending(NO_TIMER),
+    _overflow(NO_TIMER)
+{
+    clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Cancel all timers.
+//----------------------------------------------------------------------------
+
+void ts::TimerWheel::clear()
+{
+    // Release all entries but keep the generation counts to invalidate previous timer ids.
+    _free = NO_TIMER;
+    for (size_t i = 0; i < _timers.size(); ++i) {
+        _timers[i].active = false;
+        release(i);
+    }
+    _active_count = 0;
+    _pending = NO_TIMER;
+    _overflow = NO_TIMER;
+    for (size_t level = 0; level < LEVELS; ++level) {
+        for (size_t slot = 0; slot < LEVEL_SLOTS; ++slot) {
+            _slots[level][slot] = NO_TIMER;
+        }
+    }
+    for (size_t level = 0; level <= LEVELS; ++level) {
+        _level_count[level] = 0;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Schedule a timer.
+//----------------------------------------------------------------------------
+
+ts::TimerId ts::TimerWheel::schedule(TimerHandlerInterface* handler, MilliSecond delay, MilliSecond period)
+{
+    // Allocate an entry.
+    size_t index = _free;
+    if (index != NO_TIMER) {
+        _free = _timers[index].next;
+    }
+    else {
+        index = _timers.size();
+        _timers.resize(index + 1);
+        _timers[index].generation = 0;
+    }
+
+    Timer& timer(_timers[index]);
+    timer.handler = handler;
+    timer.period = std::max<MilliSecond>(period, 0);
+    timer.active = true;
+    _active_count++;
+
+    if (_started) {
+        timer.deadline = _current + std::max<MilliSecond>(delay, 1);
+        insert(index);
+    }
+    else {
+        // The time reference is not yet known, keep the delay for now.
+        timer.deadline = std::max<MilliSecond>(delay, 1);
+        timer.next = _pending;
+        _pending = index;
+    }
+    return makeId(index);
+}
+
+
+//----------------------------------------------------------------------------
+// Cancel a timer. The entry will be released when its list is processed.
+//----------------------------------------------------------------------------
+
+bool ts::TimerWheel::cancel(TimerId id)
+{
+    const size_t index = size_t(id & 0xFFFFFFFF) - 1;
+    if (id == 0 || index >= _timers.size() || makeId(index) != id || !_timers[index].active) {
+        return false;
+    }
+    _timers[index].active = false;
+    _active_count--;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Release a timer entry.
+//----------------------------------------------------------------------------
+
+void ts::TimerWheel::release(size_t index)
+{
+    Timer& timer(_timers[index]);
+    timer.generation++;
+    timer.handler = 0;
+    timer.next = _free;
+    _free = index;
+}
+
+
+//----------------------------------------------------------------------------
+// Insert an active timer into the wheel, according to its deadline.
+//----------------------------------------------------------------------------
+
+void ts::TimerWheel::insert(size_t index)
+{
+    Timer& timer(_timers[index]);
+
+    // Late timers are notified at the next tick. Timers which expire right now
+    // (when cascading from upper levels) go into the current slot of level zero.
+    if (timer.deadline < _current) {
+        timer.deadline = _current + 1;
+    }
+
+    // The timer goes in the lowest level where the deadline and the current
+    // time differ only by the bits of this level and the lower levels.
+    size_t* list = &_overflow;
+    size_t level = 0;
+    while (level < LEVELS) {
+        const size_t shift = LEVEL_BITS * (level + 1);
+        if ((timer.deadline >> shift) == (_current >> shift)) {
+            list = &_slots[level][(timer.deadline >> (LEVEL_BITS * level)) & (LEVEL_SLOTS - 1)];
+            break;
+        }
+        level++;
+    }
+
+    timer.next = *list;
+    *list = index;
+    _level_count[level]++;
+}
+
+
+//----------------------------------------------------------------------------
+// Redistribute the timers of the current slot of a level.
+//----------------------------------------------------------------------------
+
+void ts::TimerWheel::cascade(size_t level)
+{
+    size_t* const list = level < LEVELS ? &_slots[level][(_current >> (LEVEL_BITS * level)) & (LEVEL_SLOTS - 1)] : &_overflow;
+    size_t index = *list;
+    *list = NO_TIMER;
+
+    while (index != NO_TIMER) {
+        const size_t next = _timers[index].next;
+        _level_count[level]--;
+        if (_timers[index].active) {
+            insert(index);
+        }
+        else {
+            release(index);
+        }
+        index = next;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Notify all timers in the current slot of level zero.
+//----------------------------------------------------------------------------
+
+void ts::TimerWheel::expire()
+{
+    size_t* const list = &_slots[0][_current & (LEVEL_SLOTS - 1)];
+    size_t index = *list;
+    *list = NO_TIMER;
+
+    while (index != NO_TIMER) {
+        const size_t next = _timers[index].next;
+        _level_count[0]--;
+
+        if (_timers[index].active) {
+            // One-shot timers are no longer active during the notification.
+            const bool periodic = _timers[index].period > 0;
+            if (!periodic) {
+                _timers[index].active = false;
+                _active_count--;
+            }
+
+            // The handler may schedule new timers, do not keep references in the vector.
+            _timers[index].handler->handleTimer(*this, makeId(index));
+
+            Timer& timer(_timers[index]);
+            if (periodic && timer.active) {
+                // Reschedule the periodic timer, skip the periods which are missed
+                // up to the target time of the current advance().
+                timer.deadline += timer.period;
+                if (timer.deadline <= _target) {
+                    timer.deadline += ((_target - timer.deadline) / timer.period + 1) * timer.period;
+                }
+                insert(index);
+            }
+            else {
+                release(index);
+            }
+        }
+        else {
+            release(index);
+        }
+        index = next;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Advance the time of the wheel and notify all expired timers.
+//----------------------------------------------------------------------------
+
+void ts::TimerWheel::advance(MilliSecond now)
+{
+    // The first call sets the time reference.
+    if (!_started) {
+        _started = true;
+        _current = _target = now;
+        size_t index = _pending;
+        _pending = NO_TIMER;
+        while (index != NO_TIMER) {
+            const size_t next = _timers[index].next;
+            if (_timers[index].active) {
+                _timers[index].deadline += _current;
+                insert(index);
+            }
+            else {
+                release(index);
+            }
+            index = next;
+        }
+        return;
+    }
+
+    _target = std::max(_target, now);
+
+    while (_current < now) {
+
+        // Find the lowest level with timers.
+        size_t level = 0;
+        while (level <= LEVELS && _level_count[level] == 0) {
+            level++;
+        }
+        if (level > LEVELS) {
+            // No timer at all.
+            _current = now;
+            break;
+        }
+
+        // Without timer in the lower levels, jump to the next slot of the lowest non-empty level.
+        if (level == 0) {
+            _current++;
+        }
+        else {
+            const size_t shift = LEVEL_BITS * level;
+            const MilliSecond next = ((_current >> shift) + 1) << shift;
+            if (next > now) {
+                _current = now;
+                break;
+            }
+            _current = next;
+        }
+
+        // On a slot boundary of upper levels, redistribute the timers in lower levels,
+        // starting with the highest level.
+        size_t top = 0;
+        while (top < LEVELS && (_current & ((MilliSecond(1) << (LEVEL_BITS * (top + 1))) - 1)) == 0) {
+            top++;
+        }
+        for (size_t lev = top; lev > 0; --lev) {
+            cascade(lev);
+        }
+
+        // Notify the expired timers.
+        expire();
+    }
+}
@@ -0,0 +1,172 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Hierarchical timer wheel.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTimerHandlerInterface.h"
+
+namespace ts {
+    //!
+    //! Hierarchical timer wheel.
+    //!
+    //! A timer wheel manages a large number of timers with a constant cost per
+    //! operation. The time is not read by the wheel itself. The application reads
+    //! its clock once in a while, typically once per batch of packets, and calls
+    //! advance(). All expired timers are notified from advance(), in the calling
+    //! thread. Thus, the accuracy of the timers depends on the frequency of the calls
+    //! to advance() and there is no need to read the clock for each packet.
+    //!
+    //! The time unit is the millisecond, on any monotonic clock chosen by the application.
+    //! The wheel has 4 levels of 256 slots each. Timers which expire in more than 2^32
+    //! milliseconds (about 49 days) are kept in an overflow list.
+    //!
+    //! This class is not thread-safe. The timers must be scheduled and canceled
+    //! in the thread which calls advance().
+    //!
+    class TSDUCKDLL TimerWheel
+    {
+    public:
+        //!
+        //! Constructor.
+        //! The time reference is set by the first call to advance().
+        //!
+        TimerWheel();
+
+        //!
+        //! Schedule a timer.
+        //! @param [in] handler The handler to notify when the timer expires.
+        //! @param [in] delay Delay in milliseconds before the expiration of the timer,
+        //! from the time of the last call to advance(). When scheduled before the first
+        //! call to advance(), the delay starts at the first call to advance().
+        //! The minimum delay is one millisecond.
+        //! @param [in] period If non-zero, the timer is periodic and is automatically
+        //! rescheduled every @a period milliseconds after the first expiration.
+        //! When late, the missed expirations are skipped.
+        //! @return The timer identifier.
+        //!
+        TimerId schedule(TimerHandlerInterface* handler, MilliSecond delay, MilliSecond period = 0);
+
+        //!
+        //! Cancel a timer.
+        //! @param [in] id The timer identifier, as returned by schedule().
+        //! @return True if the timer was canceled, false if the timer was not
+        //! active (unknown, already canceled or one-shot timer already expired).
+        //!
+        bool cancel(TimerId id);
+
+        //!
+        //! Cancel all timers.
+        //! Must not be invoked from a timer handler.
+        //!
+        void clear();
+
+        //!
+        //! Advance the time of the wheel and notify all expired timers.
+        //! @param [in] now Current time in milliseconds. Ignored if earlier than the
+        //! time of the previous call.
+        //!
+        void advance(MilliSecond now);
+
+        //!
+        //! Get the time of the last call to advance().
+        //! This can be used as a cached clock value, valid at the start of the current batch.
+        //! @return The time of the last call to advance(), zero if never called.
+        //!
+        MilliSecond now() const
+        {
+            return _current;
+        }
+
+        //!
+        //! Get the number of active timers.
+        //! @return The number of active timers.
+        //!
+        size_t count() const
+        {
+            return _active_count;
+        }
+
+    private:
+        // Wheel geometry.
+        static const size_t LEVELS = 4;
+        static const size_t LEVEL_BITS = 8;
+        static const size_t LEVEL_SLOTS = 1 << LEVEL_BITS;
+        static const size_t NO_TIMER = ~size_t(0);  // End of list.
+
+        // Description of a timer. The timers are allocated in a vector and linked
+        // into lists using their indexes. Canceled timers remain in their list
+        // until the list is processed.
+        struct Timer
+        {
+            TimerHandlerInterface* handler;
+            MilliSecond deadline;    // Expiration time.
+            MilliSecond period;      // Period for periodic timers, zero otherwise.
+            uint32_t    generation;  // Incremented each time the entry is released.
+            bool        active;      // Not canceled, not expired.
+            size_t      next;        // Next timer in the same list.
+        };
+
+        bool               _started;       // advance() was called at least once.
+        MilliSecond        _current;       // Current time.
+        MilliSecond        _target;        // Target time of the current advance().
+        size_t             _active_count;  // Number of active timers.
+        std::vector<Timer> _timers;        // All timer entries.
+        size_t             _free;          // List of free entries.
+        size_t             _pending;       // Timers scheduled before the first advance(), deadline is the delay.
+        size_t             _overflow;      // Timers beyond the last level.
+        size_t             _level_count[LEVELS + 1];      // Number of entries per level, including overflow.
+        size_t             _slots[LEVELS][LEVEL_SLOTS];  // Lists of timers per level and slot.
+
+        // Build a timer id from an entry index.
+        TimerId makeId(size_t index) const
+        {
+            return (TimerId(_timers[index].generation) << 32) | TimerId(index + 1);
+        }
+
+        // Insert an active timer into the wheel, according to its deadline.
+        void insert(size_t index);
+
+        // Release a timer entry.
+        void release(size_t index);
+
+        // Redistribute the timers of the current slot of a level (LEVELS for the overflow list).
+        void cascade(size_t level);
+
+        // Notify all timers in the current slot of level zero.
+        void expire();
+
+        // Inaccessible operations.
+        TimerWheel(const TimerWheel&) = delete;
+        TimerWheel& operator=(const TimerWheel&) = delete;
+    };
+}
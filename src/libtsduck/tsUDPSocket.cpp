@@ -42,7 +42,8 @@ TSDUCK_SOURCE;
 ts::UDPSocket::UDPSocket(bool auto_open, ReportInterface& report) :
     _sock(TS_SOCKET_T_INVALID),
     _default_destination(),
-    _mcast()
+    _mcast(),
+    _timed_out(false)
 {
     if (auto_open) {
         // Returned value ignored on purpose, the socket is marked as closed in the object on error.
@@ -138,6 +139,30 @@ bool ts::UDPSocket::setReceiveBufferSize (size_t buffer_size, ReportInterface& r
 }
 
 
+//----------------------------------------------------------------------------
+// Set a timeout on the reception of messages. Zero means infinite.
+// Return true on success, false on error.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::setReceiveTimeout(MilliSecond timeout, ReportInterface& report)
+{
+#if defined(__windows)
+    // On Windows, the socket option is a DWORD in milliseconds.
+    ::DWORD param = ::DWORD(timeout);
+#else
+    ::timeval param;
+    param.tv_sec = time_t(timeout / MilliSecPerSec);
+    param.tv_usec = suseconds_t((timeout % MilliSecPerSec) * 1000);
+#endif
+
+    if (::setsockopt(_sock, SOL_SOCKET, SO_RCVTIMEO, TS_SOCKOPT_T(&param), sizeof(param)) != 0) {
+        report.error("error setting socket receive timeout: " + SocketErrorCodeMessage());
+        return false;
+    }
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Set the "reuse port" option.
 // Return true on success, false on error.
@@ -368,6 +393,7 @@ bool ts::UDPSocket::receive (void* data,
     // Clear returned values
     ret_size = 0;
     sender.clear();
+    _timed_out = false;
 
     // Loop on unsollicited interrupts
     for (;;) {
@@ -386,6 +412,15 @@ bool ts::UDPSocket::receive (void* data,
             // User-interrupt, end of processing but no error message
             return false;
         }
+#if defined (__windows)
+        else if (LastSocketErrorCode() == WSAETIMEDOUT) {
+#else
+        else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+#endif
+            // Reception timeout, no error message
+            _timed_out = true;
+            return false;
+        }
 #if !defined (__windows)
         else if (errno == EINTR) {
             // Got a signal, not a user interrupt, will ignore it
@@ -100,6 +100,16 @@ namespace ts {
         //!
         bool reusePort(bool reuse_port, ReportInterface& report = CERR);
 
+        //!
+        //! Set a timeout on the reception of messages.
+        //! When no message is received within the timeout, receive() fails without
+        //! error message and timedOut() returns true.
+        //! @param [in] timeout Maximum time to wait for a message. Zero means infinite (the default).
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool setReceiveTimeout(MilliSecond timeout, ReportInterface& report = CERR);
+
         //!
         //! Bind to a local address and port.
         //!
@@ -286,7 +296,8 @@ namespace ts {
         //! @param [in] abort If non-zero, invoked when I/O is interrupted
         //! (in case of user-interrupt, return, otherwise retry).
         //! @param [in,out] report Where to report error.
-        //! @return True on success, false on error.
+        //! @return True on success, false on error or timeout.
+        //! @see setReceiveTimeout()
         //!
         bool receive(void* data,
                      size_t max_size,
@@ -295,6 +306,15 @@ namespace ts {
                      const AbortInterface* abort = 0,
                      ReportInterface& report = CERR);
 
+        //!
+        //! Check if the last receive() failed because of the reception timeout.
+        //! @return True if the last receive() failed on timeout.
+        //!
+        bool timedOut() const
+        {
+            return _timed_out;
+        }
+
         //!
         //! Get the underlying socket device handle (use with care).
         //!
@@ -341,6 +361,7 @@ namespace ts {
         TS_SOCKET_T   _sock;
         SocketAddress _default_destination;
         MReqSet       _mcast; // Current list of multicast memberships
+        bool          _timed_out; // Last receive failed on timeout
 
         // Unreachable operations
         UDPSocket(const UDPSocket&) = delete;
@@ -35,12 +35,68 @@
 #include "tsByteBlock.h"
 #include "tsDVBCharsetSingleByte.h"
 #include "tsDVBCharsetUTF8.h"
+#if defined(__x86_64)
+#include <emmintrin.h>
+#endif
 TSDUCK_SOURCE;
 
 // The UTF-8 Byte Order Mark
 const char* const ts::UString::UTF8_BOM = "\0xEF\0xBB\0xBF";
 
 
+//----------------------------------------------------------------------------
+// Fast conversion of runs of ASCII characters.
+// Text in signalization and XML files is mostly ASCII. On x86_64, SSE2 is
+// always available and 16 characters are checked and converted at a time.
+// Stop at the first non-ASCII character or when the remaining input or
+// output space is too short.
+//----------------------------------------------------------------------------
+
+namespace {
+    inline void NarrowASCII(const ts::UChar*& in, const ts::UChar* inEnd, char*& out, char* outEnd)
+    {
+#if defined(__x86_64)
+        const __m128i nonASCII = _mm_set1_epi16(short(0xFF80));
+        const __m128i zero = _mm_setzero_si128();
+        while (inEnd - in >= 16 && outEnd - out >= 16) {
+            const __m128i chars0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+            const __m128i chars1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 8));
+            const __m128i high = _mm_and_si128(_mm_or_si128(chars0, chars1), nonASCII);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) != 0xFFFF) {
+                break;
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(chars0, chars1));
+            in += 16;
+            out += 16;
+        }
+#endif
+        while (in < inEnd && out < outEnd && *in < 0x80) {
+            *out++ = char(*in++);
+        }
+    }
+
+    inline void WidenASCII(const char*& in, const char* inEnd, ts::UChar*& out, ts::UChar* outEnd)
+    {
+#if defined(__x86_64)
+        const __m128i zero = _mm_setzero_si128();
+        while (inEnd - in >= 16 && outEnd - out >= 16) {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+            if (_mm_movemask_epi8(bytes) != 0) {
+                break;
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(bytes, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpackhi_epi8(bytes, zero));
+            in += 16;
+            out += 16;
+        }
+#endif
+        while (in < inEnd && out < outEnd && (*in & 0x80) == 0) {
+            *out++ = ts::UChar(*in++);
+        }
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // General routine to convert from UTF-16 to UTF-8.
 //----------------------------------------------------------------------------
@@ -99,7 +155,9 @@ void ts::UString::ConvertUTF16ToUTF8(const UChar*& inStart, const UChar* inEnd,
             // The 16-bit value is the code point.
             if (code < 0x0080) {
                 // ASCII compatible value, one byte encoding.
+                // Then convert the rest of the ASCII run, if any, at once.
                 *outStart++ = char(code);
+                NarrowASCII(inStart, inEnd, outStart, outEnd);
             }
             else if (code < 0x800 && outStart + 1 < outEnd) {
                 // 2 bytes encoding.
@@ -146,7 +204,9 @@ void ts::UString::ConvertUTF8ToUTF16(const char*& inStart, const char* inEnd, UC
 
         if (code < 0x80) {
             // ASCII compatible value, one byte encoding.
+            // Then convert the rest of the ASCII run, if any, at once.
             *outStart++ = uint16_t(code);
+            WidenASCII(inStart, inEnd, outStart, outEnd);
         }
         else if ((code & 0xE0) == 0xC0) {
             // 2 byte encoding.
@@ -238,8 +298,9 @@ ts::UString& ts::UString::assignFromUTF8(const char* utf8, size_type count)
 
 std::string ts::UString::toUTF8() const
 {
-    // The maximum number of UTF-8 bytes is 1.5 times the number of UTF-16 codes.
-    std::string utf8(2 * size(), '\0');
+    // The maximum number of UTF-8 bytes is 3 times the number of UTF-16 codes
+    // (3 bytes for one 16-bit code point, 4 bytes for a surrogate pair).
+    std::string utf8(3 * size(), '\0');
     const UChar* inStart = data();
     char* outStart = const_cast<char*>(utf8.data());
     ConvertUTF16ToUTF8(inStart, inStart + size(), outStart, outStart + utf8.size());
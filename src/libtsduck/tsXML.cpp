@@ -43,8 +43,28 @@ TSDUCK_SOURCE;
 // Example: <_any in="_descriptors"/>
 // means: accept all children of <_descriptors> in root of document.
 namespace {
-    const ts::UString TSXML_REF_NODE(u"_any");
-    const ts::UString TSXML_REF_ATTR(u"in");
+    const char* const TSXML_REF_NODE = "_any";
+    const char* const TSXML_REF_ATTR = "in";
+
+    // Check if two XML names are similar, case-insensitive.
+    // Plain ASCII names, by far the most common case, are compared without allocating strings.
+    bool SimilarNames(const char* name1, const char* name2)
+    {
+        for (const char *p1 = name1, *p2 = name2; ; ++p1, ++p2) {
+            const int c1 = static_cast<unsigned char>(*p1);
+            const int c2 = static_cast<unsigned char>(*p2);
+            if (c1 >= 0x80 || c2 >= 0x80 || std::isspace(c1) || std::isspace(c2)) {
+                // Not a plain ASCII name, use the full Unicode comparison.
+                return ts::UString::FromUTF8(name1).similar(ts::UString::FromUTF8(name2));
+            }
+            else if (std::tolower(c1) != std::tolower(c2)) {
+                return false;
+            }
+            else if (c1 == 0) {
+                return true;
+            }
+        }
+    }
 }
 
 
@@ -138,7 +158,7 @@ int ts::XML::NodeDepth(const Node* e)
 
 bool ts::XML::HaveSameName(const Element* e1, const Element* e2)
 {
-    return UString::FromUTF8(ElementName(e1)).similar(UString::FromUTF8(ElementName(e2)));
+    return SimilarNames(ElementName(e1), ElementName(e2));
 }
 
 
@@ -206,34 +226,33 @@ ts::UString ts::XML::toString(const Document& doc, int indent)
 // Find an attribute, case-insensitive, in an XML element.
 //----------------------------------------------------------------------------
 
-const ts::XML::Attribute* ts::XML::findAttribute(const Element* elem, const char* name, bool silent)
+const ts::XML::Attribute* ts::XML::findAttribute(const Element* elem, const std::string& name, bool silent)
 {
-    return findAttribute(elem, UString::FromUTF8(name), silent);
+    return findAttribute(elem, name.c_str(), silent);
 }
 
-const ts::XML::Attribute* ts::XML::findAttribute(const Element* elem, const std::string& name, bool silent)
+const ts::XML::Attribute* ts::XML::findAttribute(const Element* elem, const UString& name, bool silent)
 {
-    return findAttribute(elem, UString::FromUTF8(name), silent);
+    return findAttribute(elem, name.toUTF8().c_str(), silent);
 }
 
-const ts::XML::Attribute* ts::XML::findAttribute(const Element* elem, const UString& name, bool silent)
+const ts::XML::Attribute* ts::XML::findAttribute(const Element* elem, const char* name, bool silent)
 {
     // Filter invalid parameters.
-    if (elem == 0 || name.empty()) {
+    if (elem == 0 || name == 0 || name[0] == '\0') {
         return 0;
     }
 
     // Loop on all attributes.
     for (const Attribute* attr = elem->FirstAttribute(); attr != 0; attr = attr->Next()) {
-        if (name.similar(UString::FromUTF8(attr->Name()))) {
+        if (SimilarNames(name, attr->Name())) {
             return attr;
         }
     }
 
     // Attribute not found.
     if (!silent) {
-        const std::string utf8Name(name.toUTF8());
-        reportError(Format("Attribute '%s' not found in <%s>, line %d", utf8Name.c_str(), ElementName(elem), elem->GetLineNum()));
+        reportError(Format("Attribute '%s' not found in <%s>, line %d", name, ElementName(elem), elem->GetLineNum()));
     }
     return 0;
 }
@@ -243,34 +262,33 @@ const ts::XML::Attribute* ts::XML::findAttribute(const Element* elem, const UStr
 // Find the first child element in an XML element by name, case-insensitive.
 //----------------------------------------------------------------------------
 
-const ts::XML::Element* ts::XML::findFirstChild(const Element* elem, const char* name, bool silent)
+const ts::XML::Element* ts::XML::findFirstChild(const Element* elem, const std::string& name, bool silent)
 {
-    return findFirstChild(elem, UString::FromUTF8(name), silent);
+    return findFirstChild(elem, name.c_str(), silent);
 }
 
-const ts::XML::Element* ts::XML::findFirstChild(const Element* elem, const std::string& name, bool silent)
+const ts::XML::Element* ts::XML::findFirstChild(const Element* elem, const UString& name, bool silent)
 {
-    return findFirstChild(elem, UString::FromUTF8(name), silent);
+    return findFirstChild(elem, name.toUTF8().c_str(), silent);
 }
 
-const ts::XML::Element* ts::XML::findFirstChild(const Element* elem, const UString& name, bool silent)
+const ts::XML::Element* ts::XML::findFirstChild(const Element* elem, const char* name, bool silent)
 {
     // Filter invalid parameters.
-    if (elem == 0 || name.empty()) {
+    if (elem == 0 || name == 0 || name[0] == '\0') {
         return 0;
     }
 
     // Loop on all children.
     for (const Element* child = elem->FirstChildElement(); child != 0; child = child->NextSiblingElement()) {
-        if (name.similar(UString::FromUTF8(child->Name()))) {
+        if (SimilarNames(name, child->Name())) {
             return child;
         }
     }
 
     // Child node not found.
     if (!silent) {
-        const std::string utf8Name(name.toUTF8());
-        reportError(Format("Child node <%s> not found in <%s>, line %d", utf8Name.c_str(), ElementName(elem), elem->GetLineNum()));
+        reportError(Format("Child node <%s> not found in <%s>, line %d", name, ElementName(elem), elem->GetLineNum()));
     }
     return 0;
 }
@@ -288,10 +306,24 @@ bool ts::XML::getAttribute(std::string& value,
                            size_t minSize,
                            size_t maxSize)
 {
-    UString val;
-    const bool result = getAttribute(val, elem, UString::FromUTF8(name), required, UString::FromUTF8(defValue), minSize, maxSize);
-    value.assign(val.toUTF8());
-    return result;
+    const Attribute* attr = findAttribute(elem, name.c_str(), !required);
+    if (attr == 0) {
+        // Attribute not present.
+        value = defValue;
+        return !required;
+    }
+    else if (minSize == 0 && maxSize == UNLIMITED) {
+        // Attribute found, no size constraint, use the UTF-8 value as is.
+        value.assign(attr->Value());
+        return true;
+    }
+    else {
+        // Size constraints are expressed in characters, not UTF-8 bytes.
+        UString val;
+        const bool result = getAttribute(val, elem, UString::FromUTF8(name), required, UString::FromUTF8(defValue), minSize, maxSize);
+        value.assign(val.toUTF8());
+        return result;
+    }
 }
 
 bool ts::XML::getAttribute(UString& value,
@@ -337,11 +369,14 @@ bool ts::XML::getAttribute(UString& value,
 
 bool ts::XML::getBoolAttribute(bool& value, const Element* elem, const std::string& name, bool required, bool defValue)
 {
-    std::string str;
-    if (!getAttribute(str, elem, name, required, TrueFalse(defValue))) {
-        return false;
+    const Attribute* attr = findAttribute(elem, name.c_str(), !required);
+    if (attr == 0) {
+        value = defValue;
+        return !required;
     }
-    else if (SimilarStrings(str, "true") || SimilarStrings(str, "yes") || SimilarStrings(str, "1")) {
+
+    const std::string str(attr->Value());
+    if (SimilarStrings(str, "true") || SimilarStrings(str, "yes") || SimilarStrings(str, "1")) {
         value = true;
         return true;
     }
@@ -363,10 +398,13 @@ bool ts::XML::getBoolAttribute(bool& value, const Element* elem, const std::stri
 
 bool ts::XML::getEnumAttribute(int& value, const Enumeration& definition, const Element* elem, const std::string& name, bool required, int defValue)
 {
-    std::string str;
-    if (!getAttribute(str, elem, name, required, Decimal(defValue))) {
-        return false;
+    const Attribute* attr = findAttribute(elem, name.c_str(), !required);
+    if (attr == 0) {
+        value = defValue;
+        return !required;
     }
+
+    const std::string str(attr->Value());
     const int val = definition.value(str, false);
     if (val == Enumeration::UNKNOWN) {
         reportError(Format("'%s' is not a valid value for attribute '%s' in <%s>, line %d",
@@ -386,10 +424,12 @@ bool ts::XML::getEnumAttribute(int& value, const Enumeration& definition, const
 
 bool ts::XML::getDateTimeAttribute(Time& value, const Element* elem, const std::string& name, bool required, const Time& defValue)
 {
-    std::string str;
-    if (!getAttribute(str, elem, name, required, DateTimeToString(defValue))) {
-        return false;
+    const Attribute* attr = findAttribute(elem, name.c_str(), !required);
+    if (attr == 0) {
+        value = defValue;
+        return !required;
     }
+    const std::string str(attr->Value());
 
     // Analyze the time string.
     const bool ok = DateTimeFromString(value, str);
@@ -407,10 +447,12 @@ bool ts::XML::getDateTimeAttribute(Time& value, const Element* elem, const std::
 
 bool ts::XML::getTimeAttribute(Second& value, const Element* elem, const std::string& name, bool required, Second defValue)
 {
-    std::string str;
-    if (!getAttribute(str, elem, name, required, TimeToString(defValue))) {
-        return false;
+    const Attribute* attr = findAttribute(elem, name.c_str(), !required);
+    if (attr == 0) {
+        value = defValue;
+        return !required;
     }
+    const std::string str(attr->Value());
 
     // Analyze the time string.
     const bool ok = TimeFromString(value, str);
@@ -426,28 +468,28 @@ bool ts::XML::getTimeAttribute(Second& value, const Element* elem, const std::st
 // Find all children elements in an XML element by name, case-insensitive.
 //----------------------------------------------------------------------------
 
-bool ts::XML::getChildren(ElementVector& children, const Element* elem, const char* name, size_t minCount, size_t maxCount)
+bool ts::XML::getChildren(ElementVector& children, const Element* elem, const std::string& name, size_t minCount, size_t maxCount)
 {
-    return getChildren(children, elem, UString::FromUTF8(name), minCount, maxCount);
+    return getChildren(children, elem, name.c_str(), minCount, maxCount);
 }
 
-bool ts::XML::getChildren(ElementVector& children, const Element* elem, const std::string& name, size_t minCount, size_t maxCount)
+bool ts::XML::getChildren(ElementVector& children, const Element* elem, const UString& name, size_t minCount, size_t maxCount)
 {
-    return getChildren(children, elem, UString::FromUTF8(name), minCount, maxCount);
+    return getChildren(children, elem, name.toUTF8().c_str(), minCount, maxCount);
 }
 
-bool ts::XML::getChildren(ElementVector& children, const Element* elem, const UString& name, size_t minCount, size_t maxCount)
+bool ts::XML::getChildren(ElementVector& children, const Element* elem, const char* name, size_t minCount, size_t maxCount)
 {
     children.clear();
 
     // Filter invalid parameters.
-    if (elem == 0 || name.empty()) {
+    if (elem == 0 || name == 0 || name[0] == '\0') {
         return 0;
     }
 
     // Loop on all children.
     for (const Element* child = elem->FirstChildElement(); child != 0; child = child->NextSiblingElement()) {
-        if (name.similar(UString::FromUTF8(child->Name()))) {
+        if (SimilarNames(name, child->Name())) {
             children.push_back(child);
         }
     }
@@ -457,15 +499,13 @@ bool ts::XML::getChildren(ElementVector& children, const Element* elem, const US
         return true;
     }
     else if (maxCount == UNLIMITED) {
-        const std::string utf8Name(name.toUTF8());
         reportError(Format("<%s>, line %d, contains %" FMT_SIZE_T "d <%s>, at least %" FMT_SIZE_T "d required",
-                           ElementName(elem), elem->GetLineNum(), children.size(), utf8Name.c_str(), minCount));
+                           ElementName(elem), elem->GetLineNum(), children.size(), name, minCount));
         return false;
     }
     else {
-        const std::string utf8Name(name.toUTF8());
         reportError(Format("<%s>, line %d, contains %" FMT_SIZE_T "d <%s>, allowed %" FMT_SIZE_T "d to %" FMT_SIZE_T "d",
-                           ElementName(elem), elem->GetLineNum(), children.size(), utf8Name.c_str(), minCount, maxCount));
+                           ElementName(elem), elem->GetLineNum(), children.size(), name, minCount, maxCount));
         return false;
     }
 }
@@ -923,14 +963,13 @@ const ts::XML::Element* ts::XML::findModelElement(const Element* elem, const cha
     }
 
     // Loop on all children.
-    const UString uName(name);
     for (const Element* child = elem->FirstChildElement(); child != 0; child = child->NextSiblingElement()) {
-        const UString childName(child->Name());
-        if (childName.similar(uName)) {
+        const char* childName = ElementName(child);
+        if (SimilarNames(childName, name)) {
             // Found the child.
             return child;
         }
-        else if (childName.similar(TSXML_REF_NODE)) {
+        else if (SimilarNames(childName, TSXML_REF_NODE)) {
             // The model contains a reference to a child of the root of the document.
             // Example: <_any in="_descriptors"/> => child is the <_any> node.
             // Find the reference name, "_descriptors" in the example.
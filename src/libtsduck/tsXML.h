@@ -78,6 +78,15 @@ namespace ts {
         //!
         explicit XML(ReportInterface& report = NULLREP);
 
+        //!
+        //! Get the report interface which is used by this object.
+        //! @return A reference to the report interface.
+        //!
+        ReportInterface& report() const
+        {
+            return _report;
+        }
+
         typedef tinyxml2::XMLAttribute      Attribute;     //!< Shortcut for TinyXML-2 attribute.
         typedef tinyxml2::XMLComment        Comment;       //!< Shortcut for TinyXML-2 comment.
         typedef tinyxml2::XMLDeclaration    Declaration;   //!< Shortcut for TinyXML-2 declaration.
@@ -304,17 +313,20 @@ namespace ts {
                              INT minValue = std::numeric_limits<INT>::min(),
                              INT maxValue = std::numeric_limits<INT>::max())
         {
-            INT val;
-            std::string str;
-            if (!getAttribute(str, elem, name, required, Decimal(defValue))) {
-                return false;
+            const Attribute* attr = findAttribute(elem, name.c_str(), !required);
+            if (attr == 0) {
+                value = defValue;
+                return !required;
             }
-            else if (!ToInteger(val, str, ",")) {
+
+            INT val;
+            const std::string str(attr->Value());
+            if (!ToInteger(val, str, ",")) {
                 reportError(Format("'%s' is not a valid integer value for attribute '%s' in <%s>, line %d",
                                    str.c_str(), name.c_str(), ElementName(elem), elem->GetLineNum()));
                 return false;
             }
-            else if (value < minValue || value > maxValue) {
+            else if (val < minValue || val > maxValue) {
                 const std::string min(Decimal(minValue));
                 const std::string max(Decimal(maxValue));
                 reportError(Format("'%s' must be in range %s to %s for attribute '%s' in <%s>, line %d",
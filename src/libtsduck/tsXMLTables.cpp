@@ -39,6 +39,9 @@
 #include "tsTablesFactory.h"
 #include "tsStringUtils.h"
 #include "tsFormat.h"
+#include "tsThread.h"
+#include "tsMutex.h"
+#include "tsGuard.h"
 TSDUCK_SOURCE;
 
 #define XML_GENERIC_DESCRIPTOR   "generic_descriptor"
@@ -51,7 +54,8 @@ TSDUCK_SOURCE;
 //----------------------------------------------------------------------------
 
 ts::XMLTables::XMLTables() :
-    _tables()
+    _tables(),
+    _max_threads(1)
 {
 }
 
@@ -113,41 +117,205 @@ bool ts::XMLTables::parseDocument(XML& xml, const XML::Document& doc, const DVBC
 
     // Get the root in the document. Should be ok since we validated the document.
     const XML::Element* root = doc.RootElement();
-    bool success = true;
 
-    // Analyze all tables in the document.
+    // Collect all tables in the document.
+    XML::ElementVector nodes;
     for (const XML::Element* node = root == 0 ? 0 : root->FirstChildElement(); node != 0; node = node->NextSiblingElement()) {
+        nodes.push_back(node);
+    }
 
-        BinaryTablePtr bin;
-        const std::string name(XML::ElementName(node));
+    // Compile all tables, either here or in parallel.
+    return _max_threads > 1 && nodes.size() > 1 ?
+        parseTablesParallel(xml, nodes, charset) :
+        parseTables(xml, nodes, charset);
+}
+
+
+//----------------------------------------------------------------------------
+// Compile one XML table into a binary table.
+//----------------------------------------------------------------------------
+
+namespace {
+    ts::BinaryTablePtr CompileTable(ts::XML& xml, const ts::XML::Element* node, const ts::DVBCharset* charset)
+    {
+        ts::BinaryTablePtr bin;
 
         // Get the table factory for that kind of XML tag.
-        const TablesFactory::TableFactory fac = TablesFactory::Instance()->getTableFactory(name);
+        const ts::TablesFactory::TableFactory fac = ts::TablesFactory::Instance()->getTableFactory(ts::XML::ElementName(node));
         if (fac != 0) {
             // Create a table instance of the right type.
-            AbstractTablePtr table = fac();
+            ts::AbstractTablePtr table = fac();
             if (!table.isNull()) {
                 table->fromXML(xml, node);
             }
             if (!table.isNull() && table->isValid()) {
                 // Serialize the table.
-                bin = new BinaryTable;
+                bin = new ts::BinaryTable;
                 table->serialize(*bin, charset);
             }
         }
         else {
             // No known factory, add a generic table.
-            bin = FromGenericTableXML(xml, node);
+            bin = ts::XMLTables::FromGenericTableXML(xml, node);
         }
+        return bin;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Insert a compiled table or report its error.
+//----------------------------------------------------------------------------
 
-        // Insert created table or report error.
-        if (!bin.isNull() && bin->isValid()) {
-            _tables.push_back(bin);
+bool ts::XMLTables::addCompiledTable(XML& xml, const XML::Element* node, const BinaryTablePtr& bin)
+{
+    if (!bin.isNull() && bin->isValid()) {
+        _tables.push_back(bin);
+        return true;
+    }
+    else {
+        xml.reportError(Format("Error in table <%s> at line %d", XML::ElementName(node), node->GetLineNum()));
+        return false;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Compile all tables in the calling thread.
+//----------------------------------------------------------------------------
+
+bool ts::XMLTables::parseTables(XML& xml, const XML::ElementVector& nodes, const DVBCharset* charset)
+{
+    bool success = true;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        success = addCompiledTable(xml, nodes[i], CompileTable(xml, nodes[i], charset)) && success;
+    }
+    return success;
+}
+
+
+//----------------------------------------------------------------------------
+// Compile all tables in parallel.
+//
+// Each XML table is an independent subtree of the document. A thread only
+// accesses the subtrees of the tables it compiles, so the document can be
+// shared without synchronization. The messages of each table are recorded
+// and replayed in the original report, in document order, with the tables.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    // A report which records messages with their severity.
+    class RecordingReport: public ts::ReportInterface
+    {
+    public:
+        typedef std::pair<int, std::string> Message;
+        typedef std::list<Message> MessageList;
+
+        RecordingReport(int max_severity) : ts::ReportInterface(false, max_severity), messages() {}
+        MessageList messages;
+
+    protected:
+        virtual void writeLog(int severity, const std::string& msg)
+        {
+            messages.push_back(Message(severity, msg));
         }
-        else {
-            xml.reportError(Format("Error in table <%s> at line %d", name.c_str(), node->GetLineNum()));
-            success = false;
+    };
+
+    // Result of the compilation of one table.
+    struct CompiledTable
+    {
+        CompiledTable() : bin(), messages() {}
+        ts::BinaryTablePtr           bin;
+        RecordingReport::MessageList messages;
+    };
+
+    // Compilation context, shared by all threads.
+    class CompileContext
+    {
+    public:
+        CompileContext(const ts::XML::ElementVector& nodes_, const ts::DVBCharset* charset_, int max_severity_) :
+            nodes(nodes_),
+            charset(charset_),
+            max_severity(max_severity_),
+            results(nodes_.size()),
+            _mutex(),
+            _next(0)
+        {
+        }
+
+        const ts::XML::ElementVector& nodes;
+        const ts::DVBCharset* const charset;
+        const int max_severity;
+        std::vector<CompiledTable> results;
+
+        // Get the index of the next table to compile, nodes.size() at end.
+        size_t next()
+        {
+            ts::Guard lock(_mutex);
+            return _next < nodes.size() ? _next++ : nodes.size();
+        }
+
+    private:
+        ts::Mutex _mutex;
+        size_t    _next;
+
+        // Inaccessible operations.
+        CompileContext(const CompileContext&) = delete;
+        CompileContext& operator=(const CompileContext&) = delete;
+    };
+
+    // A compilation thread, compiles tables until there is none left.
+    class CompileThread: public ts::Thread
+    {
+    public:
+        CompileThread(CompileContext& context) : ts::Thread(), _context(context) {}
+
+    private:
+        CompileContext& _context;
+
+        virtual void main()
+        {
+            for (size_t i = _context.next(); i < _context.nodes.size(); i = _context.next()) {
+                RecordingReport report(_context.max_severity);
+                ts::XML xml(report);
+                CompiledTable& result(_context.results[i]);
+                result.bin = CompileTable(xml, _context.nodes[i], _context.charset);
+                result.messages.swap(report.messages);
+            }
+        }
+
+        // Inaccessible operations.
+        CompileThread(const CompileThread&) = delete;
+        CompileThread& operator=(const CompileThread&) = delete;
+    };
+}
+
+bool ts::XMLTables::parseTablesParallel(XML& xml, const XML::ElementVector& nodes, const DVBCharset* charset)
+{
+    // Make sure that all tables and descriptors are registered before starting the threads.
+    TablesFactory::Instance();
+
+    // Start the compilation threads.
+    CompileContext context(nodes, charset, xml.report().debugLevel());
+    std::vector<CompileThread*> threads;
+    for (size_t i = 0; i < std::min(_max_threads, nodes.size()); ++i) {
+        threads.push_back(new CompileThread(context));
+        threads.back()->start();
+    }
+    for (size_t i = 0; i < threads.size(); ++i) {
+        threads[i]->waitForTermination();
+        delete threads[i];
+    }
+
+    // Collect results and messages in document order.
+    bool success = true;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const RecordingReport::MessageList& msgs(context.results[i].messages);
+        for (RecordingReport::MessageList::const_iterator it = msgs.begin(); it != msgs.end(); ++it) {
+            xml.report().log(it->first, it->second);
         }
+        success = addCompiledTable(xml, nodes[i], context.results[i].bin) && success;
     }
     return success;
 }
@@ -96,6 +96,29 @@ namespace ts {
         //!
         UString toText(ReportInterface& report, const DVBCharset* charset = 0) const;
 
+        //!
+        //! Set the maximum number of threads which are used to compile tables.
+        //! When loading or parsing a large XML file with many independent tables
+        //! (a large EPG for instance), the tables are converted and serialized
+        //! in parallel. The resulting list of tables and all error messages are
+        //! always produced in the order of the XML document.
+        //! @param [in] count Maximum number of threads. The default is 1,
+        //! meaning that all tables are compiled in the calling thread.
+        //!
+        void setMaxThreads(size_t count)
+        {
+            _max_threads = std::max<size_t>(1, count);
+        }
+
+        //!
+        //! Get the maximum number of threads which are used to compile tables.
+        //! @return The maximum number of threads.
+        //!
+        size_t maxThreads() const
+        {
+            return _max_threads;
+        }
+
         //!
         //! Fast access to the list of loaded tables.
         //! @return A constant reference to the internal list of loaded tables.
@@ -266,7 +289,8 @@ namespace ts {
         static DescriptorPtr FromGenericDescriptorXML(XML& xml, const XML::Element* elem);
 
     private:
-        BinaryTablePtrVector _tables;   //!< Loaded tables.
+        BinaryTablePtrVector _tables;       //!< Loaded tables.
+        size_t               _max_threads;  //!< Maximum number of compilation threads.
 
         //!
         //! Parse an XML document.
@@ -277,6 +301,33 @@ namespace ts {
         //!
         bool parseDocument(XML& xml, const XML::Document& doc, const DVBCharset* charset);
 
+        //!
+        //! Compile a list of XML tables in the calling thread.
+        //! @param [in,out] xml XML handling.
+        //! @param [in] nodes XML elements of the tables.
+        //! @param [in] charset If not zero, default character set to encode strings.
+        //! @return True on success, false on error.
+        //!
+        bool parseTables(XML& xml, const XML::ElementVector& nodes, const DVBCharset* charset);
+
+        //!
+        //! Compile a list of XML tables using several threads.
+        //! @param [in,out] xml XML handling.
+        //! @param [in] nodes XML elements of the tables.
+        //! @param [in] charset If not zero, default character set to encode strings.
+        //! @return True on success, false on error.
+        //!
+        bool parseTablesParallel(XML& xml, const XML::ElementVector& nodes, const DVBCharset* charset);
+
+        //!
+        //! Add a compiled table or report an error if the compilation failed.
+        //! @param [in,out] xml XML handling.
+        //! @param [in] node XML element of the table.
+        //! @param [in] bin The compiled table.
+        //! @return True on success, false on error.
+        //!
+        bool addCompiledTable(XML& xml, const XML::Element* node, const BinaryTablePtr& bin);
+
         //!
         //! Generate an XML document.
         //! @param [in,out] xml XML handling.
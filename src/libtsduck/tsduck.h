@@ -52,6 +52,7 @@
 #include "tsAbstractLongTable.h"
 #include "tsAbstractSignalization.h"
 #include "tsAbstractTable.h"
+#include "tsAbstractTableView.h"
 #include "tsAbstractTransportListTable.h"
 #include "tsAlgorithm.h"
 #include "tsApplicationSharedLibrary.h"
@@ -65,6 +66,7 @@
 #include "tsBinaryTable.h"
 #include "tsBitStream.h"
 #include "tsBlockCipher.h"
+#include "tsBoundedMessageQueue.h"
 #include "tsBouquetNameDescriptor.h"
 #include "tsByteBlock.h"
 #include "tsCADescriptor.h"
@@ -104,13 +106,17 @@
 #include "tsDektecUtils.h"
 #include "tsDescriptor.h"
 #include "tsDescriptorList.h"
+#include "tsDescriptorLoopView.h"
 #include "tsDoubleCheckLock.h"
 #include "tsECB.h"
 #include "tsECMGClient.h"
 #include "tsECMGClientHandlerInterface.h"
+#include "tsECMGMultiClient.h"
 #include "tsECMGSCS.h"
 #include "tsEDID.h"
 #include "tsEIT.h"
+#include "tsEITDatabase.h"
+#include "tsEITView.h"
 #include "tsEMMGMUX.h"
 #include "tsETID.h"
 #include "tsEacemPreferredNameIdentifierDescriptor.h"
@@ -144,6 +150,7 @@
 #include "tsMJD.h"
 #include "tsMPEG.h"
 #include "tsMediaGuardDate.h"
+#include "tsMemoryMappedFile.h"
 #include "tsMemoryUtils.h"
 #include "tsMessageDescriptor.h"
 #include "tsMessageQueue.h"
@@ -152,6 +159,7 @@
 #include "tsMutex.h"
 #include "tsMutexInterface.h"
 #include "tsNIT.h"
+#include "tsNITView.h"
 #include "tsNames.h"
 #include "tsNetworkNameDescriptor.h"
 #include "tsNullMutex.h"
@@ -160,6 +168,7 @@
 #include "tsOneShotPacketizer.h"
 #include "tsOutputRedirector.h"
 #include "tsPAT.h"
+#include "tsPATView.h"
 #include "tsPCR.h"
 #include "tsPCRAnalyzer.h"
 #include "tsPCSC.h"
@@ -168,6 +177,7 @@
 #include "tsPESPacket.h"
 #include "tsPIDOperator.h"
 #include "tsPMT.h"
+#include "tsPMTView.h"
 #include "tsPSILogger.h"
 #include "tsPSILoggerArgs.h"
 #include "tsPacketizer.h"
@@ -188,6 +198,7 @@
 #include "tsRingNode.h"
 #include "tsS2SatelliteDeliverySystemDescriptor.h"
 #include "tsSDT.h"
+#include "tsSDTView.h"
 #include "tsSHA1.h"
 #include "tsSHA256.h"
 #include "tsSHA512.h"
@@ -225,6 +236,8 @@
 #include "tsT2MIHandlerInterface.h"
 #include "tsT2MIPacket.h"
 #include "tsTCPConnection.h"
+#include "tsTCPReactor.h"
+#include "tsTCPReactorHandlerInterface.h"
 #include "tsTCPServer.h"
 #include "tsTCPSocket.h"
 #include "tsTDES.h"
@@ -241,10 +254,12 @@
 #include "tsTSFileOutputResync.h"
 #include "tsTSPacket.h"
 #include "tsTSScanner.h"
+#include "tsTSSynchronizer.h"
 #include "tsTableHandlerInterface.h"
 #include "tsTables.h"
 #include "tsTablesDisplay.h"
 #include "tsTablesDisplayArgs.h"
+#include "tsTablesDisplayCache.h"
 #include "tsTablesFactory.h"
 #include "tsTablesLogger.h"
 #include "tsTablesLoggerArgs.h"
@@ -255,6 +270,8 @@
 #include "tsThread.h"
 #include "tsThreadAttributes.h"
 #include "tsTime.h"
+#include "tsTimerHandlerInterface.h"
+#include "tsTimerWheel.h"
 #include "tsToInteger.h"
 #include "tsTransportStreamId.h"
 #include "tsTuner.h"
@@ -286,6 +303,7 @@
 #include "tstlvMessage.h"
 #include "tstlvMessageFactory.h"
 #include "tstlvProtocol.h"
+#include "tstlvReactorHandler.h"
 #include "tstlvSerializer.h"
 #include "tstlvStreamMessage.h"
 
@@ -37,6 +37,7 @@
 #include "tstlvProtocol.h"
 #include "tsMutex.h"
 #include "tstlvMessage.h"
+#include "tstlvMessageFactory.h"
 
 namespace ts {
     namespace tlv {
@@ -78,6 +79,16 @@ namespace ts {
             //!
             bool send(const Message& msg, ReportInterface& report);
 
+            //!
+            //! Send TLV messages which were already serialized.
+            //! Useful to send several messages in one operation.
+            //! @param [in] data Address of the serialized messages.
+            //! @param [in] size Size in bytes of the serialized messages.
+            //! @param [in,out] report Where to report errors.
+            //! @return True on success, false on error.
+            //!
+            bool sendSerialized(const void* data, size_t size, ReportInterface& report);
+
             //!
             //! Receive a TLV message.
             //! Wait for the message, deserialize it and validate it.
@@ -132,6 +143,9 @@ namespace ts {
             size_t          _invalid_msg_count;
             MUTEX           _send_mutex;
             MUTEX           _receive_mutex;
+            ByteBlockPtr    _send_buffer;     // Reused for all messages, protected by _send_mutex.
+            ByteBlock       _receive_buffer;  // Reused for all messages, protected by _receive_mutex.
+            MessageFactory  _receive_factory; // Reused for all messages, protected by _receive_mutex.
 
             Connection(const Connection&) = delete;
             Connection& operator=(const Connection&) = delete;
@@ -46,7 +46,10 @@ ts::tlv::Connection<MUTEX>::Connection (const Protocol* protocol, bool auto_erro
     _max_invalid_msg (max_invalid_msg),
     _invalid_msg_count (0),
     _send_mutex (),
-    _receive_mutex ()
+    _receive_mutex (),
+    _send_buffer (new ByteBlock),
+    _receive_buffer (),
+    _receive_factory (protocol)
 {
 }
 
@@ -85,12 +88,26 @@ bool ts::tlv::Connection<MUTEX>::send (const Message& msg, ReportInterface& repo
         report.debug ("sending message to " + peerName() + "\n" + msg.dump (4));
     }
 
-    ByteBlockPtr bbp (new ByteBlock);
-    Serializer serial (bbp);
-    msg.serialize (serial);
+    // Serialize in the same buffer for all messages, avoiding reallocations.
+    Guard lock (_send_mutex);
+    _send_buffer->clear ();
+    {
+        Serializer serial (_send_buffer);
+        msg.serialize (serial);
+    }
+    return SuperClass::send (_send_buffer->data(), _send_buffer->size(), report);
+}
+
 
+//----------------------------------------------------------------------------
+// Send TLV messages which were already serialized.
+//----------------------------------------------------------------------------
+
+template <class MUTEX>
+bool ts::tlv::Connection<MUTEX>::sendSerialized (const void* data, size_t size, ReportInterface& report)
+{
     Guard lock (_send_mutex);
-    return SuperClass::send (bbp->data(), bbp->size(), report);
+    return SuperClass::send (data, size, report);
 }
 
 
@@ -107,30 +124,40 @@ bool ts::tlv::Connection<MUTEX>::receive (MessagePtr& msg, const AbortInterface*
 
     // Loop until a valid message is received
     for (;;) {
-        ByteBlock bb (header_size);
+        MessagePtr resp;
+        bool valid = false;
 
-        // Receive complete message
+        // Receive and analyze complete message.
+        // The receive buffer and the factory are reused for all messages.
         {
             Guard lock (_receive_mutex);
 
             // Read message header
-            if (!SuperClass::receive (bb.data(), header_size, abort, report)) {
+            _receive_buffer.resize (header_size);
+            if (!SuperClass::receive (_receive_buffer.data(), header_size, abort, report)) {
                 return false;
             }
 
             // Get message length and read message payload
-            const size_t length (GetUInt16 (bb.data() + length_offset));
-            bb.resize (header_size + length);
-            if (!SuperClass::receive (bb.data() + header_size, length, abort, report)) {
+            const size_t length (GetUInt16 (_receive_buffer.data() + length_offset));
+            _receive_buffer.resize (header_size + length);
+            if (!SuperClass::receive (_receive_buffer.data() + header_size, length, abort, report)) {
                 return false;
             }
+
+            // Analyze the message
+            valid = _receive_factory.analyze (_receive_buffer.data(), _receive_buffer.size());
+            if (valid) {
+                _invalid_msg_count = 0;
+                _receive_factory.factory (msg);
+            }
+            else if (_auto_error_response) {
+                _receive_factory.buildErrorResponse (resp);
+            }
         }
 
-        // Analyze the message
-        MessageFactory mf (bb.data(), bb.size(), _protocol);
-        if (mf.errorStatus() == tlv::OK) {
-            _invalid_msg_count = 0;
-            mf.factory (msg);
+        // Valid message received
+        if (valid) {
             if (report.debug() && !msg.isNull()) {
                 report.debug ("received message from " + peerName() + "\n" + msg->dump (4));
             }
@@ -141,12 +168,8 @@ bool ts::tlv::Connection<MUTEX>::receive (MessagePtr& msg, const AbortInterface*
         _invalid_msg_count++;
 
         // Send back an error message if necessary
-        if (_auto_error_response) {
-            MessagePtr resp;
-            mf.buildErrorResponse (resp);
-            if (!send (*resp, report)) {
-                return false;
-            }
+        if (!resp.isNull() && !send (*resp, report)) {
+            return false;
         }
 
         // If invalid message max has been reached, break the connection
@@ -50,7 +50,9 @@ ts::tlv::MessageFactory::MessageFactory(const void* addr, size_t size, const Pro
     _error_info_is_offset(false),
     _protocol_version(0),
     _command_tag(0),
-    _params()
+    _params(),
+    _compounds(),
+    _compound_count(0)
 {
     analyzeMessage();
 }
@@ -64,11 +66,48 @@ ts::tlv::MessageFactory::MessageFactory(const ByteBlock &bb, const Protocol* pro
     _error_info_is_offset(false),
     _protocol_version(0),
     _command_tag(0),
-    _params()
+    _params(),
+    _compounds(),
+    _compound_count(0)
 {
     analyzeMessage();
 }
 
+ts::tlv::MessageFactory::MessageFactory(const Protocol* protocol) :
+    _msg_base(0),
+    _msg_length(0),
+    _protocol(protocol),
+    _error_status(InvalidMessage),
+    _error_info(0),
+    _error_info_is_offset(true),
+    _protocol_version(0),
+    _command_tag(0),
+    _params(),
+    _compounds(),
+    _compound_count(0)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Analyze a new TLV message in memory, reusing the factory.
+//----------------------------------------------------------------------------
+
+bool ts::tlv::MessageFactory::analyze(const void* addr, size_t size)
+{
+    _msg_base = reinterpret_cast<const uint8_t*>(addr);
+    _msg_length = size;
+    _error_status = OK;
+    _error_info = 0;
+    _error_info_is_offset = false;
+    _protocol_version = 0;
+    _command_tag = 0;
+    _params.clear(); // keep capacity
+    _compound_count = 0; // keep compound analyzers for reuse
+    analyzeMessage();
+    return _error_status == OK;
+}
+
 
 //----------------------------------------------------------------------------
 // Analyze the TLV message in memory.
@@ -144,22 +183,39 @@ void ts::tlv::MessageFactory::analyzeMessage()
             return;
         }
 
-        // Store the parameter into the message factory
+        // Store the parameter into the message factory.
+        // Parameters are kept sorted by tag. Inserting after all parameters
+        // with the same tag preserves the order of occurences. Since parameters
+        // usually come in increasing tag order, this is most often an append.
         if (parm_it->second.compound != 0) {
 
             // The parameter is a compound TLV, analyze it.
-            // Store the parameter value in the multimap for this command.
-            // Analyze the compound parameter.
-
-            ParameterMultimap::iterator it =
-                _params.insert (ParameterMultimap::value_type (parm_tag,
-                    ExtParameter (tlv_addr, tlv_size, value_addr, value_length,
-                                  new MessageFactory (tlv_addr, tlv_size, parm_it->second.compound))));
+            // Store the parameter value in the vector for this command.
+            // Analyze the compound parameter, reusing a previous analyzer for the
+            // same protocol when there is one.
+
+            MessageFactory* compound = 0;
+            if (_compound_count < _compounds.size() && _compounds[_compound_count]->_protocol == parm_it->second.compound) {
+                compound = _compounds[_compound_count].pointer();
+                compound->analyze (tlv_addr, tlv_size);
+            }
+            else {
+                compound = new MessageFactory (tlv_addr, tlv_size, parm_it->second.compound);
+                if (_compound_count < _compounds.size()) {
+                    _compounds[_compound_count] = MessageFactoryPtr (compound);
+                }
+                else {
+                    _compounds.push_back (MessageFactoryPtr (compound));
+                }
+            }
+            _compound_count++;
+            const ExtParameter param (parm_tag, tlv_addr, tlv_size, value_addr, value_length, compound);
+            _params.insert (std::upper_bound (_params.begin (), _params.end (), param), param);
 
             // Check if the analysis is successful
-            if ((_error_status = it->second.compound->_error_status) != OK) {
-                _error_info = it->second.compound->_error_info;
-                _error_info_is_offset = it->second.compound->_error_info_is_offset;
+            if ((_error_status = param.compound->_error_status) != OK) {
+                _error_info = param.compound->_error_info;
+                _error_info_is_offset = param.compound->_error_info_is_offset;
                 if (_error_info_is_offset) {
                     _error_info += uint16_t ((uint8_t*)(tlv_addr) - _msg_base); // offset
                 }
@@ -178,10 +234,10 @@ void ts::tlv::MessageFactory::analyzeMessage()
         else {
 
             // The parameter is not a compound TLV and its length is fine.
-            // Store the parameter value in the multimap for this command
+            // Store the parameter value in the vector for this command
 
-            _params.insert (ParameterMultimap::value_type (parm_tag,
-                ExtParameter (tlv_addr, tlv_size, value_addr, value_length)));
+            const ExtParameter param (parm_tag, tlv_addr, tlv_size, value_addr, value_length);
+            _params.insert (std::upper_bound (_params.begin (), _params.end (), param), param);
         }
 
         // Advance to next parameter
@@ -210,7 +266,7 @@ void ts::tlv::MessageFactory::analyzeMessage()
         // Protocol-defined parameter properties:
         const Protocol::Parameter& desc = parm_it->second;
         // Number of actual occurences in current command:
-        size_t count = _params.count (tag);
+        size_t count = this->count (tag);
 
         if (count < desc.min_count || count > desc.max_count) {
             if (count == 0 && desc.min_count > 0) {
@@ -227,19 +283,27 @@ void ts::tlv::MessageFactory::analyzeMessage()
 }
 
 
+//----------------------------------------------------------------------------
+// Get the first occurence of a parameter, throw an exception if not found.
+//----------------------------------------------------------------------------
+
+const ts::tlv::MessageFactory::ExtParameter& ts::tlv::MessageFactory::findFirst (TAG tag) const
+{
+    const ParameterVector::const_iterator it = std::lower_bound (_params.begin (), _params.end (), tag, TagCompare ());
+    if (it == _params.end () || it->tag != tag) {
+        throw DeserializationInternalError (Format ("No parameter 0x%04X in message", int (tag)));
+    }
+    return *it;
+}
+
+
 //----------------------------------------------------------------------------
 // Get location of the first occurence of a parameter:
 //----------------------------------------------------------------------------
 
 void ts::tlv::MessageFactory::get (TAG tag, Parameter& param) const
 {
-    ParameterMultimap::const_iterator it = _params.find (tag);
-    if (it == _params.end ()) {
-        throw DeserializationInternalError (Format ("No parameter 0x%04X in message", tag));
-    }
-    else {
-        param = it->second;
-    }
+    param = findFirst (tag);
 }
 
 
@@ -250,13 +314,12 @@ void ts::tlv::MessageFactory::get (TAG tag, Parameter& param) const
 void ts::tlv::MessageFactory::get (TAG tag, std::vector<Parameter>& param) const
 {
     // Reinitialize result vector
+    const ParameterRange range (findAll (tag));
     param.clear ();
-    param.reserve (_params.count (tag));
+    param.reserve (range.second - range.first);
     // Fill vector with parameter values
-    ParameterMultimap::const_iterator it = _params.lower_bound (tag);
-    ParameterMultimap::const_iterator last = _params.upper_bound (tag);
-    for (; it != last; ++it) {
-        param.push_back (it->second);
+    for (ParameterVector::const_iterator it = range.first; it != range.second; ++it) {
+        param.push_back (*it);
     }
 }
 
@@ -268,14 +331,13 @@ void ts::tlv::MessageFactory::get (TAG tag, std::vector<Parameter>& param) const
 void ts::tlv::MessageFactory::get (TAG tag, std::vector<bool>& param) const
 {
     // Reinitialize result vector
+    const ParameterRange range (findAll (tag));
     param.clear ();
-    param.reserve (_params.count (tag));
+    param.reserve (range.second - range.first);
     // Fill vector with parameter values
-    ParameterMultimap::const_iterator it = _params.lower_bound (tag);
-    ParameterMultimap::const_iterator last = _params.upper_bound (tag);
-    for (; it != last; ++it) {
-        checkParamSize<uint8_t> (tag, it);
-        param.push_back (GetUInt8 (it->second.addr) != 0);
+    for (ParameterVector::const_iterator it = range.first; it != range.second; ++it) {
+        checkParamSize<uint8_t> (tag, *it);
+        param.push_back (GetUInt8 (it->addr) != 0);
     }
 }
 
@@ -287,13 +349,13 @@ void ts::tlv::MessageFactory::get (TAG tag, std::vector<bool>& param) const
 void ts::tlv::MessageFactory::get (TAG tag, std::vector<std::string>& param) const
 {
     // Reinitialize result vector
+    const ParameterRange range (findAll (tag));
     param.clear ();
-    param.resize (_params.count (tag));
+    param.resize (range.second - range.first);
     // Fill vector with parameter values
-    ParameterMultimap::const_iterator it = _params.lower_bound (tag);
-    ParameterMultimap::const_iterator last = _params.upper_bound (tag);
-    for (int i = 0; it != last; ++it, ++i) {
-        param[i].assign (static_cast<const char*> (it->second.addr), it->second.length);
+    ParameterVector::const_iterator it = range.first;
+    for (int i = 0; it != range.second; ++it, ++i) {
+        param[i].assign (static_cast<const char*> (it->addr), it->length);
     }
 }
 
@@ -304,15 +366,12 @@ void ts::tlv::MessageFactory::get (TAG tag, std::vector<std::string>& param) con
 
 void ts::tlv::MessageFactory::getCompound (TAG tag, MessagePtr& param) const
 {
-    ParameterMultimap::const_iterator it = _params.find (tag);
-    if (it == _params.end ()) {
-        throw DeserializationInternalError (Format ("No parameter 0x%04X in message", tag));
-    }
-    else if (it->second.compound.isNull ()) {
+    const ExtParameter& ext (findFirst (tag));
+    if (ext.compound == 0) {
         throw DeserializationInternalError (Format ("Parameter 0x%04X is not a compound TLV", tag));
     }
     else {
-        it->second.compound->factory (param);
+        ext.compound->factory (param);
     }
 }
 
@@ -324,17 +383,17 @@ void ts::tlv::MessageFactory::getCompound (TAG tag, MessagePtr& param) const
 void ts::tlv::MessageFactory::getCompound (TAG tag, std::vector<MessagePtr>& param) const
 {
     // Reinitialize result vector
+    const ParameterRange range (findAll (tag));
     param.clear ();
-    param.resize (_params.count (tag));
+    param.resize (range.second - range.first);
     // Fill vector with parameter values
-    ParameterMultimap::const_iterator it = _params.lower_bound (tag);
-    ParameterMultimap::const_iterator last = _params.upper_bound (tag);
-    for (int i = 0; it != last; ++it, ++i) {
-        if (it->second.compound.isNull ()) {
+    ParameterVector::const_iterator it = range.first;
+    for (int i = 0; it != range.second; ++it, ++i) {
+        if (it->compound == 0) {
             throw DeserializationInternalError (Format ("Occurence %d of parameter 0x%04X not a compound TLV", i, tag));
         }
         else {
-            it->second.compound->factory (param[i]);
+            it->compound->factory (param[i]);
         }
     }
 }
@@ -100,6 +100,27 @@ namespace ts {
             //!
             MessageFactory(const ByteBlock &bb, const Protocol* protocol);
 
+            //!
+            //! Constructor: Prepare a reusable factory for a protocol.
+            //! There is initially no valid message. Use analyze() to analyze
+            //! successive messages. The internal resources of the factory are
+            //! reused from one message to another, avoiding memory allocations.
+            //! @param [in] protocol The messages are validated according to this protocol.
+            //!
+            explicit MessageFactory(const Protocol* protocol);
+
+            //!
+            //! Analyze a new TLV message in memory.
+            //! The previous message is forgotten. The factory keeps pointers into
+            //! the new message, which must remain valid while the factory is used.
+            //! The analyzers of compound TLV parameters are reused from one message
+            //! to another.
+            //! @param [in] addr Address of a binary TLV message.
+            //! @param [in] size Size in bytes of the message.
+            //! @return True if the message is valid, same as errorStatus() == OK.
+            //!
+            bool analyze(const void* addr, size_t size);
+
             //!
             //! Get the "error status" resulting from the analysis of the message.
             //! @return The error status. If not OK, there is no valid message.
@@ -193,7 +214,8 @@ namespace ts {
             //!
             size_t count(TAG tag) const
             {
-                return _params.count(tag);
+                const ParameterRange range(findAll(tag));
+                return range.second - range.first;
             }
 
             //!
@@ -316,18 +338,34 @@ namespace ts {
             struct ExtParameter : public Parameter
             {
                 // Public fields:
-                MessageFactoryPtr compound; // for compound TLV parameter
+                TAG             tag;      // parameter tag
+                MessageFactory* compound; // for compound TLV parameter, owned by _compounds
 
                 // Constructor:
-                ExtParameter(const void*     tlv_addr_     = 0,
-                              size_t          tlv_size_     = 0,
-                              const void*     addr_         = 0,
-                              LENGTH          length_       = 0,
-                              MessageFactory* compound_     = 0) :
+                ExtParameter(TAG             tag_          = 0,
+                             const void*     tlv_addr_     = 0,
+                             size_t          tlv_size_     = 0,
+                             const void*     addr_         = 0,
+                             LENGTH          length_       = 0,
+                             MessageFactory* compound_     = 0) :
                     Parameter(tlv_addr_, tlv_size_, addr_, length_),
+                    tag(tag_),
                     compound(compound_)
                 {
                 }
+
+                // Order by tag only, to search all occurences of a tag.
+                bool operator<(const ExtParameter& other) const
+                {
+                    return tag < other.tag;
+                }
+            };
+
+            // Comparison of parameters and tags, for binary searches by tag.
+            struct TagCompare
+            {
+                bool operator()(const ExtParameter& param, TAG tag) const {return param.tag < tag;}
+                bool operator()(TAG tag, const ExtParameter& param) const {return tag < param.tag;}
             };
 
             // MessageFactory private members:
@@ -341,12 +379,33 @@ namespace ts {
             TAG             _command_tag;
 
             // Location of actual parameters. Point into the message block.
-            typedef std::multimap <TAG, ExtParameter> ParameterMultimap;
-            ParameterMultimap _params;
+            // Sorted by tag, keeping the order of occurences of each tag.
+            // A sorted vector is used instead of a multimap: messages have
+            // a few parameters and the vector is reused from one message to
+            // another without memory allocation.
+            typedef std::vector<ExtParameter> ParameterVector;
+            typedef std::pair<ParameterVector::const_iterator, ParameterVector::const_iterator> ParameterRange;
+            ParameterVector _params;
+
+            // Analyzers of compound TLV parameters. Kept apart from the parameters
+            // because a safe pointer allocates memory, even when null. Only the
+            // first _compound_count are used by the current message, the others
+            // are kept to be reused by the next messages.
+            std::vector<MessageFactoryPtr> _compounds;
+            size_t _compound_count;
 
             // Analyze the TLV message, called by constructors.
             void analyzeMessage();
 
+            // Get the range of all occurences of a parameter.
+            ParameterRange findAll(TAG tag) const
+            {
+                return std::equal_range(_params.begin(), _params.end(), tag, TagCompare());
+            }
+
+            // Get the first occurence of a parameter, throw an exception if not found.
+            const ExtParameter& findFirst(TAG tag) const;
+
             // Expected size of a type: default is sizeof().
             // Specializations can be provided.
             template <typename T> size_t dataSize() const {return sizeof(T);}
@@ -355,7 +414,7 @@ namespace ts {
             // Should never throw an exception, except bug in the
             // constructor of the Message subclasses.
             template <typename T>
-            void checkParamSize(TAG, const ParameterMultimap::const_iterator&) const;
+            void checkParamSize(TAG, const ExtParameter&) const;
         };
 
         // Template specializations for performance.
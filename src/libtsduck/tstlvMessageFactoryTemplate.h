@@ -42,13 +42,13 @@
 //----------------------------------------------------------------------------
 
 template <typename T>
-void ts::tlv::MessageFactory::checkParamSize (TAG tag, const ParameterMultimap::const_iterator& it) const
+void ts::tlv::MessageFactory::checkParamSize (TAG tag, const ExtParameter& param) const
 {
     const size_t expected = dataSize<T>();
-    if (it->second.length != expected) {
+    if (param.length != expected) {
         throw DeserializationInternalError (Format ("Bad size for parameter 0x%04X in message, "
                                                     "expected %" FMT_SIZE_T "d bytes, found %d",
-                                                    int (tag), expected, int (it->second.length)));
+                                                    int (tag), expected, int (param.length)));
     }
 }
 
@@ -60,14 +60,9 @@ void ts::tlv::MessageFactory::checkParamSize (TAG tag, const ParameterMultimap::
 template <typename INT>
 INT ts::tlv::MessageFactory::get (TAG tag) const
 {
-    ParameterMultimap::const_iterator it = _params.find (tag);
-    if (it == _params.end ()) {
-        throw DeserializationInternalError (Format ("No parameter 0x%04X in message", int (tag)));
-    }
-    else {
-        checkParamSize<INT> (tag, it);
-        return GetInt<INT> (it->second.addr);
-    }
+    const ExtParameter& param (findFirst (tag));
+    checkParamSize<INT> (tag, param);
+    return GetInt<INT> (param.addr);
 }
 
 
@@ -79,14 +74,13 @@ template <typename INT>
 void ts::tlv::MessageFactory::get (TAG tag, std::vector<INT>& param) const
 {
     // Reinitialize result vector
+    const ParameterRange range (findAll (tag));
     param.clear ();
-    param.reserve (_params.count (tag));
+    param.reserve (range.second - range.first);
     // Fill vector with parameter values
-    ParameterMultimap::const_iterator it = _params.lower_bound (tag);
-    ParameterMultimap::const_iterator last = _params.upper_bound (tag);
-    for (; it != last; ++it) {
-        checkParamSize<INT> (tag, it);
-        param.push_back (GetInt<INT> (it->second.addr));
+    for (ParameterVector::const_iterator it = range.first; it != range.second; ++it) {
+        checkParamSize<INT> (tag, *it);
+        param.push_back (GetInt<INT> (it->addr));
     }
 }
 
@@ -121,15 +115,15 @@ void ts::tlv::MessageFactory::getCompound (TAG tag, std::vector<MSG>& param) con
     // Reinitialize result vector
     param.clear ();
     // Fill vector with parameter values
-    ParameterMultimap::const_iterator it = _params.lower_bound (tag);
-    ParameterMultimap::const_iterator last = _params.upper_bound (tag);
-    for (int i = 0; it != last; ++it, ++i) {
-        if (it->second.compound.isNull()) {
+    const ParameterRange range (findAll (tag));
+    int i = 0;
+    for (ParameterVector::const_iterator it = range.first; it != range.second; ++it, ++i) {
+        if (it->compound == 0) {
             throw DeserializationInternalError (Format ("Occurence %d of parameter 0x%04X not a compound TLV", i, tag));
         }
         else {
             MessagePtr gen;
-            it->second.compound->factory (gen);
+            it->compound->factory (gen);
             MSG* msg = dynamic_cast<MSG*> (gen.pointer());
             if (msg == 0) {
                 throw DeserializationInternalError (Format ("Wrong compound TLV type for occurence %d of parameter 0x%04X", i, tag));
@@ -0,0 +1,114 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TCP reactor handler for connections using TLV messages.
+//
+//----------------------------------------------------------------------------
+
+#include "tstlvReactorHandler.h"
+#include "tstlvSerializer.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::tlv::ReactorHandler::ReactorHandler(const Protocol* protocol, bool auto_error_response) :
+    _protocol(protocol),
+    _auto_error_response(auto_error_response),
+    _header_size(protocol->hasVersion() ? 5 : 4),
+    _length_offset(protocol->hasVersion() ? 3 : 2),
+    _send_buffer(new ByteBlock),
+    _factory(protocol)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Default connection and disconnection hooks: do nothing.
+//----------------------------------------------------------------------------
+
+void ts::tlv::ReactorHandler::handleConnected(TCPReactor& reactor, TCPConnection& connection)
+{
+}
+
+void ts::tlv::ReactorHandler::handleDisconnected(TCPReactor& reactor, TCPConnection& connection)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Serialize and send a TLV message.
+//----------------------------------------------------------------------------
+
+bool ts::tlv::ReactorHandler::send(TCPReactor& reactor, TCPConnection& connection, const Message& msg, ReportInterface& report)
+{
+    // Serialize in the same buffer for all messages, avoiding reallocations.
+    _send_buffer->clear();
+    {
+        Serializer serial(_send_buffer);
+        msg.serialize(serial);
+    }
+    return reactor.send(connection, _send_buffer->data(), _send_buffer->size(), report);
+}
+
+
+//----------------------------------------------------------------------------
+// Extract one complete TLV message from received data.
+//----------------------------------------------------------------------------
+
+size_t ts::tlv::ReactorHandler::handleReceived(TCPReactor& reactor, TCPConnection& connection, const uint8_t* data, size_t size)
+{
+    // Wait for a complete message.
+    if (size < _header_size) {
+        return 0;
+    }
+    const size_t msg_size = _header_size + GetUInt16(data + _length_offset);
+    if (size < msg_size) {
+        return 0;
+    }
+
+    // Analyze the message. The factory is reused for all messages.
+    if (_factory.analyze(data, msg_size)) {
+        MessagePtr msg;
+        _factory.factory(msg);
+        if (!msg.isNull()) {
+            handleMessage(reactor, connection, msg);
+        }
+    }
+    else if (_auto_error_response) {
+        MessagePtr resp;
+        _factory.buildErrorResponse(resp);
+        if (!resp.isNull()) {
+            send(reactor, connection, *resp, NULLREP);
+        }
+    }
+    return msg_size;
+}
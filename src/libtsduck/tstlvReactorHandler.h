@@ -0,0 +1,105 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  TCP reactor handler for connections using TLV messages.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTCPReactor.h"
+#include "tstlvProtocol.h"
+#include "tstlvMessage.h"
+#include "tstlvMessageFactory.h"
+
+namespace ts {
+    namespace tlv {
+        //!
+        //! TCP reactor handler for connections using TLV messages.
+        //!
+        //! This handler extracts complete TLV messages from the data which are
+        //! received on the connections of a TCPReactor, deserializes and validates
+        //! them. Valid messages are passed to handleMessage(), which must be
+        //! implemented by subclasses. This is the event-driven equivalent of
+        //! tlv::Connection, typically used to implement servers with many clients
+        //! such as ECMG or EMMG.
+        //!
+        //! The same handler can be used by all connections of one reactor. It is
+        //! not thread-safe and shall not be shared by several reactors.
+        //!
+        class TSDUCKDLL ReactorHandler: public TCPReactorHandlerInterface
+        {
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] protocol The incoming messages are interpreted according to this protocol.
+            //! The reference is kept in this object.
+            //! @param [in] auto_error_response When an invalid message is received, the
+            //! corresponding error message is automatically sent back to the sender.
+            //!
+            explicit ReactorHandler(const Protocol* protocol, bool auto_error_response = true);
+
+            //!
+            //! Serialize and send a TLV message on a connection of the reactor.
+            //! @param [in,out] reactor The reactor which manages the connection.
+            //! @param [in,out] connection The connection.
+            //! @param [in] msg The message to send.
+            //! @param [in,out] report Where to report errors.
+            //! @return True on success, false on error.
+            //!
+            bool send(TCPReactor& reactor, TCPConnection& connection, const Message& msg, ReportInterface& report = CERR);
+
+            //!
+            //! This hook is invoked when a valid message is received on a connection.
+            //! @param [in,out] reactor The reactor which manages the connection.
+            //! @param [in,out] connection The connection.
+            //! @param [in] msg The received message.
+            //!
+            virtual void handleMessage(TCPReactor& reactor, TCPConnection& connection, const MessagePtr& msg) = 0;
+
+            // Implementation of TCPReactorHandlerInterface.
+            virtual void handleConnected(TCPReactor& reactor, TCPConnection& connection) override;
+            virtual size_t handleReceived(TCPReactor& reactor, TCPConnection& connection, const uint8_t* data, size_t size) override;
+            virtual void handleDisconnected(TCPReactor& reactor, TCPConnection& connection) override;
+
+        private:
+            const Protocol* _protocol;
+            bool            _auto_error_response;
+            size_t          _header_size;
+            size_t          _length_offset;
+            ByteBlockPtr    _send_buffer;
+            MessageFactory  _factory;
+
+            // Unreachable operations
+            ReactorHandler() = delete;
+            ReactorHandler(const ReactorHandler&) = delete;
+            ReactorHandler& operator=(const ReactorHandler&) = delete;
+        };
+    }
+}
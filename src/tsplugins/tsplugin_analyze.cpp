@@ -43,7 +43,7 @@ TSDUCK_SOURCE;
 //----------------------------------------------------------------------------
 
 namespace ts {
-    class AnalyzePlugin: public ProcessorPlugin
+    class AnalyzePlugin: public ProcessorPlugin, private TimerHandlerInterface
     {
     public:
         // Implementation of plugin API
@@ -60,15 +60,17 @@ namespace ts {
         MilliSecond       _output_interval;
         bool              _multiple_output;
         PacketCounter     _current_packet;
-        Time              _next_report_time;
-        PacketCounter     _next_report_packet;
+        TimerId           _timer;          // Periodic timer, with --interval
+        bool              _report_due;     // Time to produce a report, set by the timer
         TSAnalyzerReport  _analyzer;
         TSAnalyzerOptions _analyzer_options;
 
         bool openOutput();
         void closeOutput();
         bool produceReport();
-        void computeNextReportTime (const Time& current_utc, MilliSecond interval);
+
+        // Invoked by the timer wheel at each interval.
+        virtual void handleTimer (TimerWheel&, TimerId);
 
         // Inaccessible operations
         AnalyzePlugin() = delete;
@@ -93,8 +95,8 @@ ts::AnalyzePlugin::AnalyzePlugin(TSP* tsp_) :
     _output_interval(0),
     _multiple_output(false),
     _current_packet(0),
-    _next_report_time(Time::Epoch),
-    _next_report_packet(0),
+    _timer(0),
+    _report_due(false),
     _analyzer(),
     _analyzer_options()
 {
@@ -147,6 +149,9 @@ bool ts::AnalyzePlugin::start()
     _analyzer_options.getOptions (*this);
     _analyzer.setAnalysisOptions (_analyzer_options);
     _current_packet = 0;
+    _report_due = false;
+    tsp->timers().cancel (_timer);
+    _timer = 0;
 
     // Create the output file. Note that this file is used only in the stop
     // method and could be created there. However, if the file cannot be
@@ -239,23 +244,13 @@ bool ts::AnalyzePlugin::stop()
 
 
 //----------------------------------------------------------------------------
-// Compute next time to produce a report
+// Invoked by the timer wheel at each interval.
 //----------------------------------------------------------------------------
 
-void ts::AnalyzePlugin::computeNextReportTime (const Time& current_utc, MilliSecond interval)
+void ts::AnalyzePlugin::handleTimer (TimerWheel& wheel, TimerId id)
 {
-    // Compute next report time
-    _next_report_time = current_utc + interval;
-
-    // To avoid getting system time every packet, try to guess the packet index for next report time
-    const BitRate bitrate = tsp->bitrate();
-    if (bitrate == 0) {
-        // Unknown bitrate, we have to check current time every packet
-        _next_report_packet = 0;
-    }
-    else {
-        _next_report_packet = _current_packet + PacketDistance (bitrate, interval);
-    }
+    // The report is produced in processPacket(), where errors can be reported.
+    _report_due = true;
 }
 
 
@@ -271,28 +266,20 @@ ts::ProcessorPlugin::Status ts::AnalyzePlugin::processPacket (TSPacket& pkt, boo
     // Feed the analyzer with one packet
     _analyzer.feedPacket (pkt);
 
-    // With --interval, check if it is time to produce a report
+    // With --interval, the timer tells when it is time to produce a report
     if (_output_interval > 0) {
         if (_current_packet == 1) {
             // Initialize the repetition when the first packet arrives
-            computeNextReportTime (Time::CurrentUTC(), _output_interval);
+            _timer = tsp->timers().schedule (this, _output_interval, _output_interval);
         }
-        else if (_next_report_packet == 0 || (_next_report_packet > 0 && _current_packet >= _next_report_packet)) {
-            // Check current time to see if this is time to produce a report
-            const Time current_utc (Time::CurrentUTC());
-            if (current_utc < _next_report_time) {
-                // False alarm, we have to wait some more
-                computeNextReportTime (current_utc, _next_report_time - current_utc);
-            }
-            else {
-                // Time to produce a report
-                if (!produceReport()) {
-                    return TSP_END;
-                }
-                // Reset analysis context
-                _analyzer.reset();
-                computeNextReportTime (current_utc, _output_interval);
+        else if (_report_due) {
+            // Time to produce a report
+            _report_due = false;
+            if (!produceReport()) {
+                return TSP_END;
             }
+            // Reset analysis context
+            _analyzer.reset();
         }
     }
 
@@ -41,7 +41,7 @@ TSDUCK_SOURCE;
 //----------------------------------------------------------------------------
 
 namespace ts {
-    class BitrateMonitorPlugin: public ProcessorPlugin
+    class BitrateMonitorPlugin: public ProcessorPlugin, private TimerHandlerInterface
     {
     public:
         // Implementation of plugin API
@@ -66,7 +66,7 @@ namespace ts {
         uint32_t    _max_bitrate;          // Maximum allowed bitrate
         RangeStatus _last_bitrate_status;  // Status of the last bitrate, regarding allowed range
         std::string _alarm_command;        // Alarm command name
-        time_t      _last_second;          // Last second number
+        TimerId     _timer;                // One-second periodic timer
         uint16_t    _window_size;          // Size (in seconds) of the time window
                                            // used to compute bitrate.
         uint16_t*   _pkt_count;            // Array with the number of packets received during the last time window.
@@ -84,6 +84,9 @@ namespace ts {
         // Compute bitrate. Report any alarm.
         void computeBitrate();
 
+        // Invoked by the timer wheel every second.
+        virtual void handleTimer(TimerWheel&, TimerId);
+
         // To uncomment if using method 2 for bitrate computation
         //void computeBitrate(time_t time_interval);
 
@@ -109,7 +112,7 @@ ts::BitrateMonitorPlugin::BitrateMonitorPlugin (TSP* tsp_) :
     _max_bitrate(0),
     _last_bitrate_status(LOWER),
     _alarm_command(),
-    _last_second(0),
+    _timer(0),
     _window_size(0),
     _pkt_count(0),
     _pkt_count_index(0),
@@ -187,9 +190,12 @@ bool ts::BitrateMonitorPlugin::start()
     }
 
     _last_bitrate_status = IN_RANGE;
-    _last_second = time (NULL);
     _startup = true;
 
+    // The packet counters are shifted every second by a periodic timer.
+    tsp->timers().cancel(_timer);
+    _timer = tsp->timers().schedule(this, MilliSecPerSec, MilliSecPerSec);
+
     return true;
 }
 
@@ -329,37 +335,40 @@ void ts::BitrateMonitorPlugin::computeBitrate()
 
 
 //----------------------------------------------------------------------------
-// Packet processing method
+// Invoked by the timer wheel every second.
 //----------------------------------------------------------------------------
 
-ts::ProcessorPlugin::Status ts::BitrateMonitorPlugin::processPacket (TSPacket& pkt, bool& flush, bool& bitrate_changed)
+void ts::BitrateMonitorPlugin::handleTimer(TimerWheel& wheel, TimerId id)
 {
-    time_t now = time(NULL);
-
     // NOTE : the computation method used here is meaningful only if at least
-    // one packet is received per second (whatever its PID).
+    // one packet is received per second (whatever its PID). The timers are
+    // checked by tsp only when packets are received.
 
     // New second : compute the bitrate for the last time window
-    if (now > _last_second) {
 
-        // Bitrate computation is done only when the packet counter
-        // array if fully filled (to avoid bad values at startup).
-        if (!_startup) {
-            computeBitrate();
-        }
-
-        // update index, and reset packet count.
-        _pkt_count_index = (_pkt_count_index + 1) % _window_size;
-        _pkt_count[_pkt_count_index] = 0;
+    // Bitrate computation is done only when the packet counter
+    // array if fully filled (to avoid bad values at startup).
+    if (!_startup) {
+        computeBitrate();
+    }
 
-        // We are no more at startup if the index cycles.
-        if (_startup) {
-            _startup = !(_pkt_count_index == 0);
-        }
+    // update index, and reset packet count.
+    _pkt_count_index = (_pkt_count_index + 1) % _window_size;
+    _pkt_count[_pkt_count_index] = 0;
 
-        _last_second = now;
+    // We are no more at startup if the index cycles.
+    if (_startup) {
+        _startup = !(_pkt_count_index == 0);
     }
+}
+
+
+//----------------------------------------------------------------------------
+// Packet processing method
+//----------------------------------------------------------------------------
 
+ts::ProcessorPlugin::Status ts::BitrateMonitorPlugin::processPacket (TSPacket& pkt, bool& flush, bool& bitrate_changed)
+{
     // If packet's PID matches, increment the number of packets
     // received during the current second.
     if (pkt.getPID() == _pid) {
@@ -49,7 +49,7 @@ TSDUCK_SOURCE;
 //----------------------------------------------------------------------------
 
 namespace ts {
-    class InjectPlugin: public ProcessorPlugin
+    class InjectPlugin: public ProcessorPlugin, private TimerHandlerInterface
     {
     public:
         // Implementation of plugin API
@@ -67,7 +67,8 @@ namespace ts {
         bool               _replace;           // Replace existing PID content
         bool               _poll_files;        // Poll the presence of input files at regular intervals
         MilliSecond        _poll_files_ms;     // Interval in milliseconds between two file polling
-        Time               _poll_file_next;    // Next UTC time of poll file
+        TimerId            _poll_timer;        // Periodic timer for file polling
+        bool               _poll_due;          // Time to poll files, set by the timer
         bool               _terminate;         // Terminate processing when insertion is complete
         bool               _completed;         // Last cycle terminated
         size_t             _repeat_count;      // Repeat cycle, zero means infinite
@@ -88,6 +89,9 @@ namespace ts {
         // Replace current packet with one from the packetizer.
         void replacePacket(TSPacket& pkt);
 
+        // Invoked by the timer wheel at each file polling interval.
+        virtual void handleTimer(TimerWheel&, TimerId);
+
         // Inaccessible operations
         InjectPlugin() = delete;
         InjectPlugin(const InjectPlugin&) = delete;
@@ -112,7 +116,8 @@ ts::InjectPlugin::InjectPlugin (TSP* tsp_) :
     _replace(false),
     _poll_files(false),
     _poll_files_ms(DEF_POLL_FILE_MS),
-    _poll_file_next(),
+    _poll_timer(0),
+    _poll_due(false),
     _terminate(false),
     _completed(false),
     _repeat_count(0),
@@ -276,9 +281,9 @@ bool ts::InjectPlugin::start()
     }
 
     // Initiate file polling.
-    if (_poll_files) {
-        _poll_file_next = Time::CurrentUTC() + _poll_files_ms;
-    }
+    _poll_due = false;
+    tsp->timers().cancel(_poll_timer);
+    _poll_timer = _poll_files ? tsp->timers().schedule(this, _poll_files_ms, _poll_files_ms) : 0;
 
     _completed = false;
     _packet_count = 0;
@@ -331,6 +336,17 @@ bool ts::InjectPlugin::reloadFiles()
 }
 
 
+//----------------------------------------------------------------------------
+// Invoked by the timer wheel at each file polling interval.
+//----------------------------------------------------------------------------
+
+void ts::InjectPlugin::handleTimer(TimerWheel& wheel, TimerId id)
+{
+    // Files are polled in processPacket(), at the next section boundary.
+    _poll_due = true;
+}
+
+
 //----------------------------------------------------------------------------
 // Replace current packet with one from the packetizer.
 //----------------------------------------------------------------------------
@@ -411,13 +427,12 @@ ts::ProcessorPlugin::Status ts::InjectPlugin::processPacket(TSPacket& pkt, bool&
 
     // Poll files when necessary.
     // Do that only at section boundary in the output PID to avoid truncated sections.
-    if (_poll_files && _pzer.atSectionBoundary() && Time::CurrentUTC() >= _poll_file_next) {
+    if (_poll_files && _poll_due && _pzer.atSectionBoundary()) {
+        _poll_due = false;
         if (_infiles.scanFiles(FILE_RETRY, *tsp) > 0) {
             // Some files have changed. Reset packetizer and reload files.
             reloadFiles();
         }
-        // Plan next file polling.
-        _poll_file_next = Time::CurrentUTC() + _poll_files_ms;
     }
 
     // Now really process the current packet.
@@ -36,7 +36,15 @@
 #include "tsIPUtils.h"
 #include "tsUDPSocket.h"
 #include "tsSysUtils.h"
+#include "tsThread.h"
+#include "tsMutex.h"
+#include "tsCondition.h"
+#include "tsGuard.h"
+#include "tsGuardCondition.h"
+#include "tsMonotonic.h"
+#include "tsCRC32.h"
 #include "tsDecimal.h"
+#include "tsFormat.h"
 #include "tsTime.h"
 TSDUCK_SOURCE;
 
@@ -46,6 +54,13 @@ TSDUCK_SOURCE;
 #define MAX_PACKET_BURST   128  // ~ 48 kB
 #define MAX_IP_SIZE      65536
 
+// Redundant reception from a main and a backup source
+
+#define DEF_DEDUP_WINDOW     200  // ms, window to detect duplicate datagrams
+#define DEF_STALL_TIMEOUT   1000  // ms, a source without packet is reported as stalled
+#define SOURCE_POLL_TIME     100  // ms, reception timeout in source threads
+#define MAX_QUEUED_PACKETS 16384  // TS packets from both sources, waiting for tsp
+
 
 //----------------------------------------------------------------------------
 // Plugin definition
@@ -53,6 +68,8 @@ TSDUCK_SOURCE;
 
 namespace ts {
 
+    class IPSource;
+
     // Input plugin
     class IPInput: public InputPlugin
     {
@@ -66,7 +83,26 @@ namespace ts {
         virtual size_t receive(TSPacket*, size_t);
 
     private:
+        friend class IPSource;
+
+        // A datagram which was received from one source and not yet from the other one.
+        struct Datagram
+        {
+            NanoSecond time;    // Reception time, see currentTime().
+            size_t     source;  // Index of the source.
+        };
+        typedef std::multimap<uint64_t,Datagram> DatagramMap;  // Indexed by RTP sequence number or CRC32 of the TS packets.
+
+        // Description of a datagram in the queue of packets.
+        struct QueuedDatagram
+        {
+            bool     rtp;    // The datagram has an RTP sequence number and can be reordered.
+            uint16_t seq;    // RTP sequence number.
+            size_t   count;  // Number of TS packets in the queue.
+        };
+
         UDPSocket     _sock;               // Incoming socket
+        MilliSecond   _receive_timeout;    // Max time without packet, zero means infinite
         MilliSecond   _eval_time;          // Bitrate evaluation interval in milli-seconds
         MilliSecond   _display_time;       // Bitrate display interval in milli-seconds
         Time          _next_display;       // Next bitrate display time
@@ -80,12 +116,87 @@ namespace ts {
         size_t        _inbuf_next;         // Index in inbuf of next TS packet to return
         uint8_t       _inbuf[MAX_IP_SIZE]; // Input buffer
 
+        // Redundant reception (--backup). The following data are accessed
+        // by the source threads under the protection of the mutex.
+        IPSource*     _sources[2];         // Main and backup sources, zero if not redundant
+        NanoSecond    _dedup_window;       // Window to detect duplicate datagrams
+        NanoSecond    _stall_timeout;      // Max time without packet before reporting a stalled source
+        Mutex         _mutex;              // Protect data from the source threads
+        Condition     _got_packets;        // Signaled when packets are queued
+        std::vector<TSPacket> _queue;      // Circular queue of packets from both sources
+        size_t        _queue_first;        // Index of first packet in the queue
+        size_t        _queue_count;        // Number of packets in the queue
+        std::deque<QueuedDatagram> _queued; // Datagrams in the queue
+        Monotonic     _origin;             // Origin of the reception times
+        NanoSecond    _last_packet;        // Last reception of a new datagram from any source
+        DatagramMap   _dedup_map;          // Recent datagrams, not yet received from the other source
+        std::deque<DatagramMap::iterator> _dedup_list;  // Same in reception order, for expiration
+        size_t        _last_source;        // Index of the source of the last new datagram
+        size_t        _switches;           // Number of switch-overs between sources
+        PacketCounter _dropped;            // Dropped packets, queue full
+
+        // Current time in nanoseconds, relative to _origin.
+        NanoSecond currentTime() const;
+
+        // Open a UDP socket to receive from a destination address.
+        bool openSocket(UDPSocket& sock, const std::string& destination, const std::string& local, size_t recv_bufsize, bool reuse_port);
+
+        // Locate the TS packets inside a UDP message.
+        bool locatePackets(const uint8_t* data, size_t size, size_t& first, size_t& count) const;
+
+        // Process the real-time evaluation of the bitrate after receiving packets.
+        void countPackets(size_t count);
+
+        // Receive packets from the queue of the redundant sources.
+        size_t receiveRedundant(TSPacket* buffer, size_t max_packets);
+
+        // Invoked by the source threads.
+        void sourceDatagram(size_t index, const uint8_t* data, size_t first, size_t count);
+        void sourceTimeout(size_t index);
+
         // Inaccessible operations
         IPInput() = delete;
         IPInput(const IPInput&) = delete;
         IPInput& operator=(const IPInput&) = delete;
     };
 
+    // Reception thread for one source of the input plugin, in redundant mode.
+    class IPSource: public Thread
+    {
+    public:
+        IPSource(IPInput& input, size_t index, const std::string& name);
+        virtual ~IPSource();
+
+        // Open the socket, terminate the thread and close the socket.
+        bool open(const std::string& local, size_t recv_bufsize, bool reuse_port);
+        void terminate();
+
+        // Statistics and state, protected by the mutex of the input plugin.
+        const std::string name;       // Source address, for messages.
+        PacketCounter datagrams;      // Received datagrams with TS packets.
+        PacketCounter firsts;         // Datagrams which were received first from this source.
+        PacketCounter duplicates;     // Datagrams which were already received from the other source.
+        NanoSecond    delay_total;    // Total delay of the duplicates after the other source.
+        NanoSecond    delay_max;      // Maximum delay of the duplicates after the other source.
+        size_t        stalls;         // Number of stalls.
+        bool          stalled;        // Currently stalled.
+        NanoSecond    last_time;      // Time of last received datagram, see IPInput::currentTime().
+
+    private:
+        IPInput&      _input;
+        const size_t  _index;
+        UDPSocket     _sock;
+        volatile bool _terminate;
+        uint8_t       _buffer[MAX_IP_SIZE];
+
+        virtual void main() override;
+
+        // Inaccessible operations
+        IPSource() = delete;
+        IPSource(const IPSource&) = delete;
+        IPSource& operator=(const IPSource&) = delete;
+    };
+
     // Output plugin
     class IPOutput: public OutputPlugin
     {
@@ -121,6 +232,7 @@ TSPLUGIN_DECLARE_OUTPUT(ts::IPOutput)
 ts::IPInput::IPInput (TSP* tsp_) :
     InputPlugin(tsp_, "Receive TS packets from UDP/IP, multicast or unicast.", "[options] [address:]port"),
     _sock(false, *tsp_),
+    _receive_timeout(0),
     _eval_time(0),
     _display_time(0),
     _next_display(Time::Epoch),
@@ -132,13 +244,33 @@ ts::IPInput::IPInput (TSP* tsp_) :
     _packets_1(0),
     _inbuf_count(0),
     _inbuf_next(0),
-    _inbuf()
+    _inbuf(),
+    _sources(),
+    _dedup_window(0),
+    _stall_timeout(0),
+    _mutex(),
+    _got_packets(),
+    _queue(),
+    _queue_first(0),
+    _queue_count(0),
+    _queued(),
+    _origin(),
+    _last_packet(0),
+    _dedup_map(),
+    _dedup_list(),
+    _last_source(0),
+    _switches(0),
+    _dropped(0)
 {
     option ("",                     0,  STRING, 1, 1);
+    option ("backup",               0,  STRING);
+    option ("backup-local-address", 0,  STRING);
     option ("buffer-size",         'b', UNSIGNED);
+    option ("dedup-window",         0,  POSITIVE);
     option ("display-interval",    'd', POSITIVE);
     option ("evaluation-interval", 'e', POSITIVE);
     option ("local-address",       'l', STRING);
+    option ("receive-timeout",      0,  POSITIVE);
     option ("reuse-port",          'r');
 
     setHelp ("Parameter:\n"
@@ -150,10 +282,29 @@ ts::IPInput::IPInput (TSP* tsp_) :
              "\n"
              "Options:\n"
              "\n"
+             "  --backup [address:]port\n"
+             "      Receive the same stream from a second source, in addition to the main\n"
+             "      one, on a separate socket (seamless protection switching, in the style\n"
+             "      of SMPTE 2022-7). Each source is received in its own thread. A datagram\n"
+             "      is passed to tsp from the first source which delivers it. The duplicates\n"
+             "      are identified by their RTP sequence number or, without RTP, by a hash\n"
+             "      of their TS packets. A stalled source never blocks the other one.\n"
+             "\n"
+             "  --backup-local-address address\n"
+             "      With --backup, specify the IP address of the local interface on which\n"
+             "      to listen for the backup source. By default, use the same interface as\n"
+             "      the main source (see --local-address).\n"
+             "\n"
              "  -b value\n"
              "  --buffer-size value\n"
              "      Specify the UDP socket receive buffer size (socket option).\n"
              "\n"
+             "  --dedup-window milliseconds\n"
+             "      With --backup, specify the time window during which a datagram which\n"
+             "      is received from the other source is considered as a duplicate. It must\n"
+             "      be larger than the difference of delay between the two sources. The\n"
+             "      default is " TS_STRINGIFY(DEF_DEDUP_WINDOW) " milliseconds.\n"
+             "\n"
              "  -d value\n"
              "  --display-interval value\n"
              "      Specify the interval in seconds between two displays of the evaluated\n"
@@ -176,6 +327,12 @@ ts::IPInput::IPInput (TSP* tsp_) :
              "      It can be also a host name that translates to a local address.\n"
              "      By default, listen on all local interfaces.\n"
              "\n"
+             "  --receive-timeout milliseconds\n"
+             "      Specify the maximum time without packet. When no packet is received\n"
+             "      during this time, the input terminates. With --backup, this applies when\n"
+             "      both sources are silent and a source is reported as stalled after this\n"
+             "      time (default: " TS_STRINGIFY(DEF_STALL_TIMEOUT) " milliseconds). By default, wait forever.\n"
+             "\n"
              "  -r\n"
              "  --reuse-port\n"
              "      Set the reuse port socket option.\n"
@@ -235,19 +392,11 @@ ts::IPOutput::IPOutput (TSP* tsp_) :
 
 
 //----------------------------------------------------------------------------
-// Input start method
+// Open a UDP socket to receive from a destination address.
 //----------------------------------------------------------------------------
 
-bool ts::IPInput::start()
+bool ts::IPInput::openSocket(UDPSocket& sock, const std::string& destination, const std::string& local, size_t recv_bufsize, bool reuse_port)
 {
-    // Get command line arguments
-    _eval_time = MilliSecPerSec * intValue<MilliSecond> ("evaluation-interval", 0);
-    _display_time = MilliSecPerSec * intValue<MilliSecond> ("display-interval", 0);
-    std::string destination (value (""));
-    std::string local (value ("local-address"));
-    size_t recv_bufsize = intValue<size_t> ("buffer-size", 0);
-    bool reuse_port = present ("reuse-port");
-
     // Resolve specified destination address:port
     SocketAddress dest_addr;
     if (!dest_addr.resolve (destination, *tsp)) {
@@ -276,29 +425,75 @@ bool ts::IPInput::start()
     SocketAddress local_addr (local_ip, dest_addr.port());
 
     // Create UDP socket
-    if (!_sock.open (*tsp)) {
+    if (!sock.open (*tsp)) {
         return false;
     }
 
     // Initialize socket.
     // Note: On Windows, bind must be done *before* joining multicast groups.
     bool ok =
-        (!reuse_port || _sock.reusePort (true, *tsp)) &&
-        (recv_bufsize <= 0 ||_sock.setReceiveBufferSize (recv_bufsize, *tsp)) &&
-        _sock.bind (local_addr, *tsp) &&
-        (!dest_addr.hasAddress() || _sock.addMembership (dest_addr, local_ip, *tsp));
+        (!reuse_port || sock.reusePort (true, *tsp)) &&
+        (recv_bufsize <= 0 || sock.setReceiveBufferSize (recv_bufsize, *tsp)) &&
+        sock.bind (local_addr, *tsp) &&
+        (!dest_addr.hasAddress() || sock.addMembership (dest_addr, local_ip, *tsp));
 
     if (!ok) {
-        _sock.close();
-        return false;
+        sock.close();
     }
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Input start method
+//----------------------------------------------------------------------------
+
+bool ts::IPInput::start()
+{
+    // Get command line arguments
+    _eval_time = MilliSecPerSec * intValue<MilliSecond> ("evaluation-interval", 0);
+    _display_time = MilliSecPerSec * intValue<MilliSecond> ("display-interval", 0);
+    _receive_timeout = intValue<MilliSecond> ("receive-timeout", 0);
+    _dedup_window = intValue<MilliSecond> ("dedup-window", DEF_DEDUP_WINDOW) * NanoSecPerMilliSec;
+    _stall_timeout = (_receive_timeout > 0 ? _receive_timeout : DEF_STALL_TIMEOUT) * NanoSecPerMilliSec;
+    std::string destination (value (""));
+    std::string backup (value ("backup"));
+    std::string local (value ("local-address"));
+    std::string backup_local (value ("backup-local-address", local.c_str()));
+    size_t recv_bufsize = intValue<size_t> ("buffer-size", 0);
+    bool reuse_port = present ("reuse-port");
 
-    // Socket now ready.
     // Initialize working data.
     _inbuf_count = _inbuf_next = 0;
     _start = _start_0 = _start_1 = _next_display = Time::Epoch;
     _packets = _packets_0 = _packets_1 = 0;
 
+    // Without backup source, receive from the socket in the tsp input thread.
+    if (backup.empty()) {
+        return openSocket (_sock, destination, local, recv_bufsize, reuse_port) &&
+            (_receive_timeout <= 0 || _sock.setReceiveTimeout (_receive_timeout, *tsp));
+    }
+
+    // With a backup source, each source is received in its own thread.
+    _queue.resize (MAX_QUEUED_PACKETS);
+    _queue_first = _queue_count = 0;
+    _queued.clear();
+    _dedup_map.clear();
+    _dedup_list.clear();
+    _last_source = 0;
+    _switches = 0;
+    _dropped = 0;
+    _origin.getSystemTime();
+    _last_packet = 0;
+
+    _sources[0] = new IPSource (*this, 0, destination);
+    _sources[1] = new IPSource (*this, 1, backup);
+    if (!_sources[0]->open (local, recv_bufsize, reuse_port) || !_sources[1]->open (backup_local, recv_bufsize, reuse_port)) {
+        stop();
+        return false;
+    }
+    _sources[0]->start();
+    _sources[1]->start();
     return true;
 }
 
@@ -310,6 +505,30 @@ bool ts::IPInput::start()
 bool ts::IPInput::stop()
 {
     _sock.close();
+
+    if (_sources[0] != 0) {
+        // Terminate the source threads first, the statistics are no longer modified.
+        _sources[0]->terminate();
+        _sources[1]->terminate();
+
+        for (size_t i = 0; i < 2; ++i) {
+            const IPSource& src (*_sources[i]);
+            const NanoSecond delay_avg = src.duplicates == 0 ? 0 : src.delay_total / NanoSecond (src.duplicates);
+            tsp->verbose (std::string (i == 0 ? "main" : "backup") + " source " + src.name + ": " +
+                          Decimal (src.datagrams) + " datagrams, " +
+                          Decimal (src.firsts) + " first, " +
+                          Decimal (src.duplicates) + " duplicates, delay after other source: " +
+                          Decimal (delay_avg / NanoSecPerMicroSec) + " us average, " +
+                          Decimal (src.delay_max / NanoSecPerMicroSec) + " us max, " +
+                          Decimal (src.stalls) + " stalls");
+        }
+        tsp->verbose (Decimal (_switches) + " switch-overs between sources, " + Decimal (_dropped) + " dropped packets");
+
+        delete _sources[0];
+        delete _sources[1];
+        _sources[0] = _sources[1] = 0;
+    }
+
     return true;
 }
 
@@ -320,7 +539,7 @@ bool ts::IPInput::stop()
 
 ts::IPInput::~IPInput()
 {
-    _sock.close();
+    stop();
 }
 
 
@@ -343,14 +562,118 @@ ts::BitRate ts::IPInput::getBitrate()
 }
 
 
+//----------------------------------------------------------------------------
+// Locate the TS packets inside a UDP message.
+//----------------------------------------------------------------------------
+
+bool ts::IPInput::locatePackets(const uint8_t* data, size_t size, size_t& first, size_t& count) const
+{
+    // Basically, we expect the message to contain only TS packets. However, we
+    // will face the following situations:
+    // - Presence of a header preceeding the first TS packet (typically
+    //   when the TS packets are encapsulated in RTP).
+    // - Presence of a truncated packet at the end of message.
+
+    // To face the first situation, we look backward from the end of
+    // the message, looking for a 0x47 sync byte every 188 bytes, going
+    // backward.
+
+    const uint8_t* p;
+    for (p = data + size; p >= data + PKT_SIZE && p[-int(PKT_SIZE)] == SYNC_BYTE; p -= PKT_SIZE) {}
+
+    if (p < data + size) {
+        // Some packets were found
+        first = p - data;
+        count = (data + size - p) / PKT_SIZE;
+        return true;
+    }
+
+    // If no TS packet is found using the first method, we restart from
+    // the beginning of the message, looking for a 0x47 sync byte every
+    // 188 bytes, going forward. If we find this pattern, followed by
+    // less than 188 bytes, then we have found a sequence of TS packets.
+
+    const uint8_t* max = data + size - PKT_SIZE; // max address for a TS packet
+
+    for (p = data; p <= max; p++) {
+        if (*p == SYNC_BYTE) {
+            // Verify that we get a 0x47 sync byte every 188 bytes up
+            // to the end of message (not leaving more than one truncated
+            // TS packet at the end of the message).
+            const uint8_t* end;
+            for (end = p; end <= max && *end == SYNC_BYTE; end += PKT_SIZE) {}
+            if (end > max) {
+                // Less than 188 bytes after last packet. Consider we are OK
+                first = p - data;
+                count = (end - p) / PKT_SIZE;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+
+//----------------------------------------------------------------------------
+// Process the real-time evaluation of the bitrate after receiving packets.
+//----------------------------------------------------------------------------
+
+void ts::IPInput::countPackets(size_t count)
+{
+    if (_eval_time <= 0) {
+        return;
+    }
+
+    const Time now (Time::CurrentUTC());
+
+    // Detect start time
+    if (_packets == 0) {
+        _start = _start_0 = _start_1 = now;
+        if (_display_time > 0) {
+            _next_display = now + _display_time;
+        }
+    }
+
+    // Count packets
+    _packets += count;
+    _packets_0 += count;
+    _packets_1 += count;
+
+    // Detect new evaluation period
+    if (now >= _start_1 + _eval_time) {
+        _start_0 = _start_1;
+        _packets_0 = _packets_1;
+        _start_1 = now;
+        _packets_1 = 0;
+
+    }
+
+    // Check if evaluated bitrate should be displayed
+    if (_display_time > 0 && now >= _next_display) {
+        _next_display += _display_time;
+        const MilliSecond ms_current = Time::CurrentUTC() - _start_0;
+        const MilliSecond ms_total = Time::CurrentUTC() - _start;
+        const BitRate br_current = ms_current == 0 ? 0 : BitRate ((_packets_0 * PKT_SIZE * 8 * MilliSecPerSec) / ms_current);
+        const BitRate br_average = ms_total == 0 ? 0 : BitRate ((_packets * PKT_SIZE * 8 * MilliSecPerSec) / ms_total);
+        tsp->info ("IP input bitrate: " +
+                   (br_current == 0 ? "undefined" : Decimal (br_current) + " b/s") +
+                   ", average: " +
+                   (br_average == 0 ? "undefined" : Decimal (br_average) + " b/s"));
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Input method
 //----------------------------------------------------------------------------
 
 size_t ts::IPInput::receive (TSPacket* buffer, size_t max_packets)
 {
-    // Check if we receive new packets or process remain of previous buffer.
-    bool new_packets = false;
+    // With a backup source, get the packets from the source threads.
+    if (_sources[0] != 0) {
+        return receiveRedundant (buffer, max_packets);
+    }
 
     // If there is no remaining packet in the input buffer, wait for a UDP
     // message. Loop until we get some TS packets.
@@ -360,114 +683,308 @@ size_t ts::IPInput::receive (TSPacket* buffer, size_t max_packets)
         SocketAddress sender;
         size_t insize;
         if (!_sock.receive (_inbuf, sizeof(_inbuf), insize, sender, tsp, *tsp)) {
+            if (_sock.timedOut()) {
+                tsp->error ("no packet received for " + Decimal (_receive_timeout) + " ms");
+            }
             return 0;
         }
 
-        // Locate the TS packets inside the UDP message. Basically, we
-        // expect the message to contain only TS packets. However, we
-        // will face the following situations:
-        // - Presence of a header preceeding the first TS packet (typically
-        //   when the TS packets are encapsulated in RTP).
-        // - Presence of a truncated packet at the end of message.
-
-        // To face the first situation, we look backward from the end of
-        // the message, looking for a 0x47 sync byte every 188 bytes, going
-        // backward.
-
-        const uint8_t* p;
-        for (p = _inbuf + insize; p >= _inbuf + PKT_SIZE && p[-int(PKT_SIZE)] == SYNC_BYTE; p -= PKT_SIZE) {}
-
-        if (p < _inbuf + insize) {
-            // Some packets were found
-            _inbuf_next = p - _inbuf;
-            _inbuf_count = (_inbuf + insize - p) / PKT_SIZE;
-            new_packets = true;
+        // Locate the TS packets inside the UDP message.
+        if (locatePackets (_inbuf, insize, _inbuf_next, _inbuf_count)) {
+            // New packets were received, we may need to re-evaluate the real-time input bitrate.
+            countPackets (_inbuf_count);
             break; // exit receive loop
         }
 
-        // If no TS packet is found using the first method, we restart from
-        // the beginning of the message, looking for a 0x47 sync byte every
-        // 188 bytes, going forward. If we find this pattern, followed by
-        // less than 188 bytes, then we have found a sequence of TS packets.
-
-        const uint8_t* max = _inbuf + insize - PKT_SIZE; // max address for a TS packet
+        // No TS packet found in UDP message, wait for another one.
         _inbuf_count = 0;
+        tsp->debug ("no TS packet in message from " +
+                    std::string (SocketAddress (sender)) + ", " +
+                    Decimal (insize) + " bytes");
+    }
+
+    // Return packets from the input buffer
+    size_t pkt_cnt = std::min (_inbuf_count, max_packets);
+    ::memcpy (buffer, _inbuf + _inbuf_next, pkt_cnt * PKT_SIZE);
+    _inbuf_count -= pkt_cnt;
+    _inbuf_next += pkt_cnt * PKT_SIZE;
+
+    return pkt_cnt;
+}
 
-        for (p = _inbuf; p <= max; p++) {
-            if (*p == SYNC_BYTE) {
-                // Verify that we get a 0x47 sync byte every 188 bytes up
-                // to the end of message (not leaving more than one truncated
-                // TS packet at the end of the message).
-                const uint8_t* end;
-                for (end = p; end <= max && *end == SYNC_BYTE; end += PKT_SIZE) {}
-                if (end > max) {
-                    // Less than 188 bytes after last packet. Consider we are OK
-                    _inbuf_next = p - _inbuf;
-                    _inbuf_count = (end - p) / PKT_SIZE;
-                    new_packets = true;
-                    break; // exit packet search loop
-                }
+
+//----------------------------------------------------------------------------
+// Receive packets from the queue of the redundant sources.
+//----------------------------------------------------------------------------
+
+size_t ts::IPInput::receiveRedundant (TSPacket* buffer, size_t max_packets)
+{
+    GuardCondition lock (_mutex, _got_packets);
+
+    // Wait for packets from any source, checking interruptions and timeout from time to time.
+    while (_queue_count == 0) {
+        if (tsp->aborting()) {
+            return 0;
+        }
+        if (_receive_timeout > 0) {
+            if (currentTime() - _last_packet >= _receive_timeout * NanoSecPerMilliSec) {
+                tsp->error ("no packet received from both sources for " + Decimal (_receive_timeout) + " ms");
+                return 0;
             }
         }
+        lock.waitCondition (SOURCE_POLL_TIME);
+    }
 
-        if (new_packets) {
-            break; // exit receive loop
+    // Return packets from the queue.
+    size_t count = 0;
+    while (count < max_packets && _queue_count > 0) {
+        const size_t n = std::min (std::min (max_packets - count, _queue_count), _queue.size() - _queue_first);
+        std::copy (&_queue[_queue_first], &_queue[_queue_first] + n, buffer + count);
+        count += n;
+        _queue_count -= n;
+        _queue_first = (_queue_first + n) % _queue.size();
+    }
+
+    // Remove the returned datagrams. A partially returned datagram can no longer be reordered.
+    for (size_t n = count; n > 0; ) {
+        if (_queued.front().count <= n) {
+            n -= _queued.front().count;
+            _queued.pop_front();
+        }
+        else {
+            _queued.front().count -= n;
+            _queued.front().rtp = false;
+            n = 0;
         }
+    }
 
-        // No TS packet found in UDP message, wait for another one.
-        tsp->debug ("no TS packet in message from " +
-                    std::string (SocketAddress (sender)) + ", " +
-                    Decimal (insize) + " bytes");
+    countPackets (count);
+    return count;
+}
+
+
+//----------------------------------------------------------------------------
+// Current time in nanoseconds, relative to the start of the redundant reception.
+//----------------------------------------------------------------------------
+
+ts::NanoSecond ts::IPInput::currentTime() const
+{
+    Monotonic now;
+    now.getSystemTime();
+    return now - _origin;
+}
+
+
+//----------------------------------------------------------------------------
+// Invoked by a source thread when a datagram is received.
+//----------------------------------------------------------------------------
+
+void ts::IPInput::sourceDatagram (size_t index, const uint8_t* data, size_t first, size_t count)
+{
+    const NanoSecond now = currentTime();
+
+    // With RTP (version 2 header before the TS packets), use the sequence number.
+    // Otherwise, use a hash of the TS packets.
+    const bool rtp = first >= 12 && (data[0] & 0xC0) == 0x80;
+    const uint16_t seq = rtp ? GetUInt16 (data + 2) : 0;
+    const uint64_t key = rtp ? (TS_UCONST64 (0x100000000) | seq) : uint64_t (CRC32 (data + first, count * PKT_SIZE).value());
+
+    GuardCondition lock (_mutex, _got_packets);
+    IPSource& src (*_sources[index]);
+
+    src.datagrams++;
+    src.last_time = now;
+    if (src.stalled) {
+        src.stalled = false;
+        tsp->info ("source " + src.name + " resumed");
+    }
+
+    // Forget the datagrams which are out of the duplicate detection window.
+    // Entries which were already matched by the other source are marked with an invalid source.
+    while (!_dedup_list.empty() && (_dedup_list.front()->second.source > 1 || now - _dedup_list.front()->second.time > _dedup_window)) {
+        _dedup_map.erase (_dedup_list.front());
+        _dedup_list.pop_front();
     }
 
-    // If new packets were received, we may need to re-evaluate the real-time input bitrate.
-    if (new_packets && _eval_time > 0) {
+    // Drop the datagram if already received from the other source. Each source sends one copy
+    // of each datagram: the oldest unmatched copy from the other source is the duplicate. Thus,
+    // identical datagrams from one source, such as null packets, are never considered as duplicates.
+    for (DatagramMap::iterator it = _dedup_map.lower_bound (key); it != _dedup_map.end() && it->first == key; ++it) {
+        if (it->second.source == 1 - index) {
+            const NanoSecond delay = now - it->second.time;
+            src.duplicates++;
+            src.delay_total += delay;
+            src.delay_max = std::max (src.delay_max, delay);
+            it->second.source = 2; // matched, will be removed
+            return;
+        }
+    }
 
-        const Time now (Time::CurrentUTC());
+    // First reception of this datagram.
+    Datagram dg;
+    dg.time = now;
+    dg.source = index;
+    _dedup_list.push_back (_dedup_map.insert (std::make_pair (key, dg)));
+    _last_packet = now;
+    src.firsts++;
+    if (index != _last_source) {
+        _switches++;
+        _last_source = index;
+        tsp->debug ("switching to source " + src.name);
+    }
 
-        // Detect start time
-        if (_packets == 0) {
-            _start = _start_0 = _start_1 = now;
-            if (_display_time > 0) {
-                _next_display = now + _display_time;
+    // Enqueue the packets, drop the excess ones if the queue is full.
+    if (count > _queue.size() - _queue_count) {
+        _dropped += count - (_queue.size() - _queue_count);
+        count = _queue.size() - _queue_count;
+    }
+    if (count == 0) {
+        return;
+    }
+
+    // With RTP, a datagram which was lost by one source and is received later from the other
+    // source is inserted before the queued datagrams with higher sequence numbers, if any.
+    size_t pos = _queued.size();
+    size_t shift = 0;
+    while (rtp && pos > 0 && _queued[pos - 1].rtp && int16_t (_queued[pos - 1].seq - seq) > 0) {
+        shift += _queued[--pos].count;
+    }
+
+    if (shift == 0) {
+        for (size_t done = 0; done < count; ) {
+            const size_t last = (_queue_first + _queue_count) % _queue.size();
+            const size_t n = std::min (count - done, _queue.size() - last);
+            for (size_t i = 0; i < n; ++i) {
+                ::memcpy (_queue[last + i].b, data + first + (done + i) * PKT_SIZE, PKT_SIZE);
             }
+            _queue_count += n;
+            done += n;
+        }
+    }
+    else {
+        // Move the packets of the following datagrams after the new ones.
+        const size_t start = _queue_first + _queue_count - shift;
+        std::vector<TSPacket> moved (shift);
+        for (size_t i = 0; i < shift; ++i) {
+            moved[i] = _queue[(start + i) % _queue.size()];
+        }
+        for (size_t i = 0; i < count; ++i) {
+            ::memcpy (_queue[(start + i) % _queue.size()].b, data + first + i * PKT_SIZE, PKT_SIZE);
         }
+        for (size_t i = 0; i < shift; ++i) {
+            _queue[(start + count + i) % _queue.size()] = moved[i];
+        }
+        _queue_count += count;
+    }
+
+    QueuedDatagram qd;
+    qd.rtp = rtp;
+    qd.seq = seq;
+    qd.count = count;
+    _queued.insert (_queued.begin() + pos, qd);
+    lock.signal();
+}
 
-        // Count packets
-        _packets += _inbuf_count;
-        _packets_0 += _inbuf_count;
-        _packets_1 += _inbuf_count;
 
-        // Detect new evaluation period
-        if (now >= _start_1 + _eval_time) {
-            _start_0 = _start_1;
-            _packets_0 = _packets_1;
-            _start_1 = now;
-            _packets_1 = 0;
+//----------------------------------------------------------------------------
+// Invoked by a source thread when no datagram was received for a while.
+//----------------------------------------------------------------------------
 
-        }
+void ts::IPInput::sourceTimeout (size_t index)
+{
+    const NanoSecond now = currentTime();
 
-        // Check if evaluated bitrate should be displayed
-        if (_display_time > 0 && now >= _next_display) {
-            _next_display += _display_time;
-            const MilliSecond ms_current = Time::CurrentUTC() - _start_0;
-            const MilliSecond ms_total = Time::CurrentUTC() - _start;
-            const BitRate br_current = ms_current == 0 ? 0 : BitRate ((_packets_0 * PKT_SIZE * 8 * MilliSecPerSec) / ms_current);
-            const BitRate br_average = ms_total == 0 ? 0 : BitRate ((_packets * PKT_SIZE * 8 * MilliSecPerSec) / ms_total);
-            tsp->info ("IP input bitrate: " +
-                       (br_current == 0 ? "undefined" : Decimal (br_current) + " b/s") +
-                       ", average: " +
-                       (br_average == 0 ? "undefined" : Decimal (br_average) + " b/s"));
-        }
+    Guard lock (_mutex);
+    IPSource& src (*_sources[index]);
+
+    if (!src.stalled && now - src.last_time >= _stall_timeout) {
+        src.stalled = true;
+        src.stalls++;
+        tsp->warning ("source " + src.name + " stalled, no packet for " + Decimal ((now - src.last_time) / NanoSecPerMilliSec) + " ms");
     }
+}
 
-    // Return packets from the input buffer
-    size_t pkt_cnt = std::min (_inbuf_count, max_packets);
-    ::memcpy (buffer, _inbuf + _inbuf_next, pkt_cnt * PKT_SIZE);
-    _inbuf_count -= pkt_cnt;
-    _inbuf_next += pkt_cnt * PKT_SIZE;
 
-    return pkt_cnt;
+//----------------------------------------------------------------------------
+// Source thread constructor and destructor.
+//----------------------------------------------------------------------------
+
+ts::IPSource::IPSource (IPInput& input, size_t index, const std::string& name_) :
+    Thread (),
+    name (name_),
+    datagrams (0),
+    firsts (0),
+    duplicates (0),
+    delay_total (0),
+    delay_max (0),
+    stalls (0),
+    stalled (false),
+    last_time (0),
+    _input (input),
+    _index (index),
+    _sock (false, *input.tsp),
+    _terminate (false),
+    _buffer ()
+{
+}
+
+ts::IPSource::~IPSource()
+{
+    terminate();
+}
+
+
+//----------------------------------------------------------------------------
+// Open the socket of a source.
+//----------------------------------------------------------------------------
+
+bool ts::IPSource::open (const std::string& local, size_t recv_bufsize, bool reuse_port)
+{
+    // The reception timeout lets the thread check its termination and the stalls.
+    return _input.openSocket (_sock, name, local, recv_bufsize, reuse_port) &&
+        _sock.setReceiveTimeout (SOURCE_POLL_TIME, *_input.tsp);
+}
+
+
+//----------------------------------------------------------------------------
+// Terminate the thread and close the socket.
+//----------------------------------------------------------------------------
+
+void ts::IPSource::terminate()
+{
+    _terminate = true;
+    waitForTermination();
+    _sock.close();
+}
+
+
+//----------------------------------------------------------------------------
+// Source thread.
+//----------------------------------------------------------------------------
+
+void ts::IPSource::main()
+{
+    _input.tsp->debug ("source " + name + " thread started");
+
+    while (!_terminate) {
+        SocketAddress sender;
+        size_t insize = 0;
+        size_t first = 0;
+        size_t count = 0;
+        if (_sock.receive (_buffer, sizeof(_buffer), insize, sender, 0, *_input.tsp)) {
+            if (_input.locatePackets (_buffer, insize, first, count)) {
+                _input.sourceDatagram (_index, _buffer, first, count);
+            }
+        }
+        else if (_sock.timedOut()) {
+            _input.sourceTimeout (_index);
+        }
+        else {
+            break;
+        }
+    }
+
+    _input.tsp->debug ("source " + name + " thread terminated");
 }
 
 
@@ -46,7 +46,7 @@ TSDUCK_SOURCE;
 //----------------------------------------------------------------------------
 
 namespace ts {
-    class TimePlugin: public ProcessorPlugin, private TableHandlerInterface
+    class TimePlugin: public ProcessorPlugin, private TableHandlerInterface, private TimerHandlerInterface
     {
     public:
         // Implementation of plugin API
@@ -82,10 +82,21 @@ namespace ts {
         SectionDemux      _demux;        // Section filter
         TimeEventVector   _events;       // Sorted list of time events to apply
         size_t            _next_index;   // Index of next TimeEvent to apply
+        bool              _started;      // First packet received
+        TimerId           _timer;        // Timer for the next TimeEvent, without --tdt
 
         // Invoked by the demux when a complete table is available.
         virtual void handleTable (SectionDemux&, const BinaryTable&);
 
+        // Invoked by the timer wheel when the next TimeEvent is due (without --tdt).
+        virtual void handleTimer (TimerWheel&, TimerId);
+
+        // Apply all TimeEvent up to _last_time.
+        void applyEvents();
+
+        // Apply all TimeEvent up to the system clock and schedule a timer for the next one.
+        void checkSystemTime();
+
         // Add time events in the list fro one option. Return false if a time string is invalid
         bool addEvents (const char* option, Status status);
 
@@ -114,7 +125,9 @@ ts::TimePlugin::TimePlugin (TSP* tsp_) :
     _status_names("pass", TSP_OK, "stop", TSP_END, "drop", TSP_DROP, "null", TSP_NULL, TS_NULL),
     _demux(this),
     _events(),
-    _next_index(0)
+    _next_index(0),
+    _started(false),
+    _timer(0)
 {
     option ("drop",     'd', STRING, 0, UNLIMITED_COUNT);
     option ("null",     'n', STRING, 0, UNLIMITED_COUNT);
@@ -223,6 +236,13 @@ bool ts::TimePlugin::start()
 
     _last_time = Time::Epoch;
     _next_index = 0;
+    _started = false;
+
+    // Without TDT, the system clock is not read for each packet.
+    // A timer is scheduled for each event in sequence, starting at the
+    // first packet: the timers do not run before the first packet.
+    tsp->timers().cancel (_timer);
+    _timer = 0;
 
     return true;
 }
@@ -293,21 +313,40 @@ void ts::TimePlugin::handleTable (SectionDemux& demux, const BinaryTable& table)
 
 
 //----------------------------------------------------------------------------
-// Packet processing method
+// Apply all TimeEvent up to the system clock and schedule a timer for the
+// next one. The delay is always recomputed from the system clock, so that
+// the timers neither drift nor accumulate the latency of their notification.
 //----------------------------------------------------------------------------
 
-ts::ProcessorPlugin::Status ts::TimePlugin::processPacket (TSPacket& pkt, bool& flush, bool& bitrate_changed)
+void ts::TimePlugin::checkSystemTime()
 {
-    // Filter sections
-    _demux.feedPacket (pkt);
-
-    // Get current system time (unless TDT is used as reference)
-    if (!_use_tdt) {
-        _last_time = _use_utc ? Time::CurrentUTC() : Time::CurrentLocalTime();
+    _last_time = _use_utc ? Time::CurrentUTC() : Time::CurrentLocalTime();
+    applyEvents();
+    if (_next_index < _events.size()) {
+        _timer = tsp->timers().schedule (this, _events[_next_index].time - _last_time);
     }
+}
+
+
+//----------------------------------------------------------------------------
+// Invoked by the timer wheel when the next TimeEvent is due.
+//----------------------------------------------------------------------------
+
+void ts::TimePlugin::handleTimer (TimerWheel& wheel, TimerId id)
+{
+    // The monotonic clock of the timers and the system clock may differ and the
+    // notification may be late. If the event is not yet due, the timer is
+    // rescheduled for the remaining delay.
+    checkSystemTime();
+}
+
 
-    // Is it time to change the action?
+//----------------------------------------------------------------------------
+// Apply all TimeEvent up to _last_time.
+//----------------------------------------------------------------------------
 
+void ts::TimePlugin::applyEvents()
+{
     while (_next_index < _events.size() && _events[_next_index].time <= _last_time) {
         // Yes, we just passed a schedule
         _status = _events[_next_index].status;
@@ -318,6 +357,27 @@ ts::ProcessorPlugin::Status ts::TimePlugin::processPacket (TSPacket& pkt, bool&
                       ": new packet processing: " + _status_names.name (_status));
         }
     }
+}
+
+
+//----------------------------------------------------------------------------
+// Packet processing method
+//----------------------------------------------------------------------------
+
+ts::ProcessorPlugin::Status ts::TimePlugin::processPacket (TSPacket& pkt, bool& flush, bool& bitrate_changed)
+{
+    // With --tdt, filter sections and check if it is time to change the action.
+    // Otherwise, the action is changed by the timer, see handleTimer().
+    // The first timer is scheduled at the first packet, when the timers start.
+
+    if (_use_tdt) {
+        _demux.feedPacket (pkt);
+        applyEvents();
+    }
+    else if (!_started) {
+        _started = true;
+        checkSystemTime();
+    }
 
     return _status;
 }
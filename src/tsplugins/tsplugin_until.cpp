@@ -33,7 +33,6 @@
 //----------------------------------------------------------------------------
 
 #include "tsPlugin.h"
-#include "tsTime.h"
 TSDUCK_SOURCE;
 
 
@@ -42,7 +41,7 @@ TSDUCK_SOURCE;
 //----------------------------------------------------------------------------
 
 namespace ts {
-    class UntilPlugin: public ProcessorPlugin
+    class UntilPlugin: public ProcessorPlugin, private TimerHandlerInterface
     {
     public:
         // Implementation of plugin API
@@ -61,12 +60,16 @@ namespace ts {
         PacketCounter  _null_seq_max;     // Stop at Nth sequence of null packets
         PacketCounter  _null_seq_cnt;     // Sequence of null packets counter
         MilliSecond    _msec_max;         // Stop after N milli-seconds
-        Time           _start_time;       // Time of first packet reception
+        TimerId        _timer;            // One-shot timer for --milli-seconds
+        bool           _time_elapsed;     // The --milli-seconds timer has expired
         PID            _previous_pid;     // PID of previous packet
         bool           _started;          // First packet was received
         bool           _terminated;       // Final condition is met
         bool           _transparent;      // Pass all packets, no longer check conditions
 
+        // Invoked by the timer wheel when --milli-seconds has elapsed.
+        virtual void handleTimer (TimerWheel&, TimerId);
+
         // Inaccessible operations
         UntilPlugin() = delete;
         UntilPlugin(const UntilPlugin&) = delete;
@@ -92,7 +95,8 @@ ts::UntilPlugin::UntilPlugin (TSP* tsp_) :
     _null_seq_max(0),
     _null_seq_cnt(0),
     _msec_max(0),
-    _start_time(Time::Epoch),
+    _timer(0),
+    _time_elapsed(false),
     _previous_pid(PID_NULL),
     _started(false),
     _terminated(false),
@@ -174,11 +178,24 @@ bool ts::UntilPlugin::start()
     _started = false;
     _terminated = false;
     _transparent = false;
+    _time_elapsed = false;
+    tsp->timers().cancel (_timer);
+    _timer = 0;
 
     return true;
 }
 
 
+//----------------------------------------------------------------------------
+// Invoked by the timer wheel when --milli-seconds has elapsed.
+//----------------------------------------------------------------------------
+
+void ts::UntilPlugin::handleTimer (TimerWheel& wheel, TimerId id)
+{
+    _time_elapsed = true;
+}
+
+
 //----------------------------------------------------------------------------
 // Packet processing method
 //----------------------------------------------------------------------------
@@ -202,10 +219,12 @@ ts::ProcessorPlugin::Status ts::UntilPlugin::processPacket (TSPacket& pkt, bool&
         }
     }
 
-    // Record time of first packet
+    // Start the timer on first packet
     if (!_started) {
         _started = true;
-        _start_time = Time::CurrentUTC();
+        if (_msec_max > 0) {
+            _timer = tsp->timers().schedule (this, _msec_max);
+        }
     }
 
     // Update context information
@@ -224,7 +243,7 @@ ts::ProcessorPlugin::Status ts::UntilPlugin::processPacket (TSPacket& pkt, bool&
         (_pack_max > 0 && _pack_cnt >= _pack_max) ||
         (_null_seq_max > 0 && _null_seq_cnt >= _null_seq_max) ||
         (_unit_start_max > 0 && _unit_start_cnt >= _unit_start_max) ||
-        (_msec_max && Time::CurrentUTC() - _start_time >= _msec_max);
+        _time_elapsed;
 
     // Update context information for next packet
     _previous_pid = pkt.getPID();
@@ -37,10 +37,14 @@
 #include "tsHexa.h"
 #include "tsPCRAnalyzer.h"
 #include "tsFormat.h"
+#include "tsMemoryMappedFile.h"
+#include "tsThread.h"
 TSDUCK_SOURCE;
 
 using namespace ts;
 
+#define READ_PACKETS 4096   // Packets per read operation when the whole file is analyzed
+
 
 //----------------------------------------------------------------------------
 //  Command line options
@@ -57,6 +61,7 @@ struct Options: public Args
     bool        all;         // All packets analysis
     bool        full;        // Full analysis
     bool        value_only;  // Output value only
+    size_t      threads;     // Number of analysis threads
     std::string infile;      // Input file name
 };
 
@@ -69,6 +74,7 @@ Options::Options (int argc, char *argv[]) :
     all(false),
     full(false),
     value_only(false),
+    threads(0),
     infile()
 {
     option ("",            0, Args::STRING, 0, 1);
@@ -77,6 +83,7 @@ Options::Options (int argc, char *argv[]) :
     option ("full",       'f');
     option ("min-pcr",     0, Args::POSITIVE);
     option ("min-pid",     0, Args::INTEGER, 0, 1, 1, PID_MAX);
+    option ("threads",     0, Args::INTEGER, 0, 1, 1, 256);
     option ("value-only", 'v');
 
     setHelp ("Input file:\n"
@@ -110,6 +117,13 @@ Options::Options (int argc, char *argv[]) :
              "  --min-pid value\n"
              "      Minimum number of PID to get PCR from (default: 1).\n"
              "\n"
+             "  --threads value\n"
+             "      With --all or --full, the input file is mapped in memory and split in\n"
+             "      chunks which are analyzed in parallel by the specified number of threads.\n"
+             "      The input file must be a regular file. The PCR intervals which span two\n"
+             "      chunks are ignored, the result may slightly differ from the sequential\n"
+             "      analysis. By default, the file is sequentially analyzed.\n"
+             "\n"
              "  -v\n"
              "  --value-only\n"
              "      Display only the bitrate value, in bits/seconds, based on\n"
@@ -127,10 +141,162 @@ Options::Options (int argc, char *argv[]) :
     min_pcr = intValue<uint32_t> ("min-pcr", 64);
     min_pid = intValue<uint16_t> ("min-pid", 1);
     use_dts = present ("dts");
+    threads = all ? intValue<size_t> ("threads", 0) : 0;
+
+    if (threads > 0 && infile.empty()) {
+        error ("--threads requires an input file");
+    }
+    exitOnError ();
     pcr_name = use_dts ? "DTS" : "PCR";
 }
 
 
+//----------------------------------------------------------------------------
+//  Analyze all packets from standard input, by large groups of packets.
+//----------------------------------------------------------------------------
+
+namespace {
+    std::string AfterPackets(PacketCounter count)
+    {
+        return count > 0 ? " after " + Decimal(count) + " TS packets" : "";
+    }
+}
+
+void AnalyzeStream(Options& opt, PCRAnalyzer& zer)
+{
+    std::vector<TSPacket> buffer(READ_PACKETS);
+    char* const data = reinterpret_cast<char*>(&buffer[0]);
+    PacketCounter total = 0;
+
+    for (;;) {
+        std::cin.read(data, std::streamsize(buffer.size() * PKT_SIZE));
+        const size_t insize = size_t(std::cin.gcount());
+        size_t count = insize / PKT_SIZE;
+
+        // Stop at the first packet with an invalid sync byte.
+        bool sync_lost = false;
+        for (size_t i = 0; !sync_lost && i < count; ++i) {
+            if (!buffer[i].hasValidSync()) {
+                opt.error("synchronization lost" + AfterPackets(total + i) +
+                          Format(", got 0x%02X instead of 0x%02X at start of TS packet", int(buffer[i].b[0]), int(SYNC_BYTE)));
+                sync_lost = true;
+                count = i;
+            }
+        }
+
+        zer.feedPackets(&buffer[0], count);
+        total += count;
+
+        if (sync_lost) {
+            break;
+        }
+        else if (std::cin.bad() || (!std::cin && !std::cin.eof())) {
+            opt.error("I/O error while reading TS packet" + AfterPackets(total));
+            break;
+        }
+        else if (!std::cin) {
+            if (insize % PKT_SIZE != 0) {
+                opt.error("truncated TS packet (" + Decimal(insize % PKT_SIZE) + " bytes)" + AfterPackets(total));
+            }
+            break;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+//  Analyze a memory-mapped file in parallel, one chunk per thread.
+//----------------------------------------------------------------------------
+
+class ChunkAnalyzer: public Thread
+{
+public:
+    // Constructor, the thread is not started.
+    ChunkAnalyzer(const Options& opt, const TSPacket* packets, size_t count) :
+        Thread(),
+        analyzer(opt.min_pid, opt.min_pcr),
+        sync_lost(false),
+        _packets(packets),
+        _count(count)
+    {
+        if (opt.use_dts) {
+            analyzer.resetAndUseDTS(opt.min_pid, opt.min_pcr);
+        }
+    }
+
+    PCRAnalyzer analyzer;   // Analysis of the chunk
+    bool        sync_lost;  // The chunk is truncated at an invalid packet, _count is updated.
+
+    // Get the number of analyzed packets in the chunk.
+    size_t count() const {return _count;}
+
+    // Get the first packet of the chunk.
+    const TSPacket* packets() const {return _packets;}
+
+private:
+    const TSPacket* _packets;
+    size_t          _count;
+
+    // Thread main code.
+    virtual void main()
+    {
+        // Stop the analysis at the first packet with an invalid sync byte.
+        for (size_t i = 0; !sync_lost && i < _count; ++i) {
+            if (!_packets[i].hasValidSync()) {
+                sync_lost = true;
+                _count = i;
+            }
+        }
+        analyzer.feedPackets(_packets, _count);
+    }
+
+    // Inaccessible operations
+    ChunkAnalyzer(const ChunkAnalyzer&) = delete;
+    ChunkAnalyzer& operator=(const ChunkAnalyzer&) = delete;
+};
+
+void AnalyzeMappedFile(Options& opt, PCRAnalyzer& zer)
+{
+    MemoryMappedFile file;
+    if (!file.open(opt.infile, 0, false, opt)) {
+        return;
+    }
+    file.adviseSequential();
+
+    const TSPacket* const packets = reinterpret_cast<const TSPacket*>(file.data());
+    const size_t total = file.size() / PKT_SIZE;
+    const size_t chunk_size = (total + opt.threads - 1) / opt.threads;
+
+    // Start one analysis thread per chunk.
+    std::vector<ChunkAnalyzer*> chunks;
+    for (size_t first = 0; first < total; first += chunk_size) {
+        chunks.push_back(new ChunkAnalyzer(opt, packets + first, std::min(chunk_size, total - first)));
+        chunks.back()->start();
+    }
+
+    // Merge the analysis of all chunks, in order, up to the first invalid packet.
+    bool sync_lost = false;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        chunks[i]->waitForTermination();
+        if (!sync_lost) {
+            zer.merge(chunks[i]->analyzer);
+            if (chunks[i]->sync_lost) {
+                sync_lost = true;
+                const TSPacket& pkt(chunks[i]->packets()[chunks[i]->count()]);
+                opt.error("synchronization lost" + AfterPackets(&pkt - packets) +
+                          Format(", got 0x%02X instead of 0x%02X at start of TS packet", int(pkt.b[0]), int(SYNC_BYTE)));
+            }
+        }
+        delete chunks[i];
+    }
+
+    if (!sync_lost && file.size() % PKT_SIZE != 0) {
+        opt.error("truncated TS packet (" + Decimal(file.size() % PKT_SIZE) + " bytes)" + AfterPackets(total));
+    }
+    file.close(opt);
+}
+
+
 //----------------------------------------------------------------------------
 //  Program entry point
 //----------------------------------------------------------------------------
@@ -139,7 +305,7 @@ int main (int argc, char *argv[])
 {
     Options opt (argc, argv);
     PCRAnalyzer zer (opt.min_pid, opt.min_pcr);
-    InputRedirector input (opt.infile, opt);
+    InputRedirector input (opt.threads > 0 ? std::string() : opt.infile, opt);
     TSPacket pkt;
 
     // Reset analyzer for DTS with --dts
@@ -148,7 +314,15 @@ int main (int argc, char *argv[])
     }
 
     // Read all packets in the file and pass them to the PCR analyzer.
-    while (pkt.read (std::cin, true, opt) && (!zer.feedPacket (pkt) || opt.all)) {}
+    if (opt.threads > 0) {
+        AnalyzeMappedFile (opt, zer);
+    }
+    else if (opt.all) {
+        AnalyzeStream (opt, zer);
+    }
+    else {
+        while (pkt.read (std::cin, true, opt) && !zer.feedPacket (pkt)) {}
+    }
 
     // Display results.
     PCRAnalyzer::Status status;
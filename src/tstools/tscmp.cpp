@@ -36,7 +36,12 @@
 #include "tsDecimal.h"
 #include "tsFormat.h"
 #include "tsMemoryUtils.h"
+#include "tsMemoryMappedFile.h"
 #include "tsTSFileInputBuffered.h"
+#include "tsThread.h"
+#include "tsGuard.h"
+#include "tsGuardCondition.h"
+#include "tsSafePtr.h"
 #include "tsBinaryTable.h"
 #include "tsSection.h"
 #include "tsPMT.h"
@@ -46,6 +51,8 @@ TSDUCK_SOURCE;
 using namespace ts;
 
 #define DEFAULT_BUFFERED_PACKETS 10000
+#define DEFAULT_THREADS           4
+#define FAST_BLOCK_PACKETS        16384   // Packets per block in fast mode (about 3 MB)
 
 
 //----------------------------------------------------------------------------
@@ -72,6 +79,8 @@ struct Options: public Args
     bool        pid_ignore;
     bool        cc_ignore;
     bool        continue_all;
+    bool        fast;
+    size_t      threads;
 };
 
 Options::Options (int argc, char *argv[]) :
@@ -91,7 +100,9 @@ Options::Options (int argc, char *argv[]) :
     pcr_ignore(false),
     pid_ignore(false),
     cc_ignore(false),
-    continue_all(false)
+    continue_all(false),
+    fast(false),
+    threads(0)
 {
     option ("",                 0,  Args::STRING, 2, 2);
     option ("buffered-packets", 0,  UNSIGNED);
@@ -99,12 +110,14 @@ Options::Options (int argc, char *argv[]) :
     option ("cc-ignore",        0);
     option ("continue",        'c');
     option ("dump",            'd');
+    option ("fast",            'f');
     option ("normalized",      'n');
     option ("packet-offset",   'p', UNSIGNED);
     option ("payload-only",     0);
     option ("pcr-ignore",       0);
     option ("pid-ignore",       0);
     option ("subset",          's');
+    option ("threads",          0,  INTEGER, 0, 1, 1, 256);
     option ("threshold-diff",  't', INTEGER, 0, 1, 0, PKT_SIZE);
     option ("quiet",           'q');
     option ("verbose",         'v');
@@ -136,6 +149,16 @@ Options::Options (int argc, char *argv[]) :
              "  --dump\n"
              "      Dump the content of all differing packets.\n"
              "\n"
+             "  -f\n"
+             "  --fast\n"
+             "      Fast comparison mode. Both files are mapped in memory and compared by\n"
+             "      large blocks, using several threads. Only the blocks which differ are\n"
+             "      compared packet by packet, according to the other options. With --subset,\n"
+             "      at the first missing packet, the hashes of the remaining packets in the\n"
+             "      first file are computed in order to quickly find the next matching packet.\n"
+             "      The results are identical to the default mode. Both files must be regular\n"
+             "      files. See also --threads.\n"
+             "\n"
              "  --help\n"
              "      Display this help text.\n"
              "\n"
@@ -180,6 +203,10 @@ Options::Options (int argc, char *argv[]) :
              "      different and the first file is read ahead. The default is zero, which\n"
              "      means that two packets must be strictly identical to declare them equal.\n"
              "\n"
+             "  --threads value\n"
+             "      With --fast, specifies the number of comparison threads. The default is\n"
+             "      " + Decimal (DEFAULT_THREADS) + " threads.\n"
+             "\n"
              "  -v\n"
              "  --verbose\n"
              "      Produce verbose messages.\n"
@@ -205,6 +232,8 @@ Options::Options (int argc, char *argv[]) :
     normalized = !quiet && present ("normalized");
     verbose = !quiet && present ("verbose");
     dump = !quiet && present ("dump");
+    fast = present ("fast");
+    threads = intValue<size_t> ("threads", DEFAULT_THREADS);
 
     dump_flags =
         TSPacket::DUMP_TS_HEADER |    // Format TS headers
@@ -329,91 +358,194 @@ bool Comparator::compare(const TSPacket& pkt1, const TSPacket& pkt2, Options& op
     }
 }
 
-
 //----------------------------------------------------------------------------
-//  Program entry point
+//  Accumulation and report of differences, common to all comparison modes.
 //----------------------------------------------------------------------------
 
-int main (int argc, char *argv[])
+class Differences
 {
-    Options opt (argc, argv);
-    TSFileInputBuffered file1 (opt.buffered_packets);
-    TSFileInputBuffered file2 (opt.buffered_packets);
+public:
+    // Count packets in PIDs in each file
+    PacketCounter count1[PID_MAX];
+    PacketCounter count2[PID_MAX];
 
-    // Open files
-    file1.open (opt.filename1, 1, opt.byte_offset, opt);
-    file2.open (opt.filename2, 1, opt.byte_offset, opt);
-    opt.exitOnError();
+    // Currently skipped packets in file1 when --subset
+    PacketCounter subset_skipped;
+    PacketCounter total_subset_skipped;
+    PacketCounter subset_skipped_chunks;
 
-    // Display headers
-    if (opt.normalized) {
-        std::cout << "file:file=1:filename=" << file1.getFileName() << ":" << std::endl
-                  << "file:file=2:filename=" << file2.getFileName() << ":" << std::endl;
+    // Number of differences in file
+    PacketCounter diff_count;
 
-    }
-    else if (opt.verbose) {
-        std::cout << "* Comparing " << file1.getFileName() << " and " << file2.getFileName() << std::endl;
-    }
+    // Constructor
+    Differences(Options& opt, const std::string& name1, const std::string& name2);
 
-    // Count packets in PIDs in each file
-    PacketCounter count1[PID_MAX];
-    PacketCounter count2[PID_MAX];
+    // Report the truncation of a file. Index is 1 or 2, count is the number of packets in that file.
+    void truncated(int index, PacketCounter count);
+
+    // Report resynchronization after missing packets. Index1 is the index of the current packet in file1.
+    void resync(PacketCounter index1);
+
+    // Report a difference. Index1 is the index of the packet in file1. Return false to stop the comparison.
+    bool report(PacketCounter index1, const TSPacket& pkt1, const TSPacket& pkt2, const Comparator& comp);
+
+    // Final report. Total is the number of read packets in file1.
+    void final(PacketCounter total);
+
+private:
+    Options&    _opt;
+    std::string _name1;
+    std::string _name2;
+};
+
+Differences::Differences(Options& opt, const std::string& name1, const std::string& name2) :
+    subset_skipped(0),
+    total_subset_skipped(0),
+    subset_skipped_chunks(0),
+    diff_count(0),
+    _opt(opt),
+    _name1(name1),
+    _name2(name2)
+{
     TS_ZERO (count1);
     TS_ZERO (count2);
+}
 
-    // Currently skipped packets in file1 when --subset
-    PacketCounter subset_skipped = 0;
-    PacketCounter total_subset_skipped = 0;
-    PacketCounter subset_skipped_chunks = 0;
+void Differences::truncated(int index, PacketCounter count)
+{
+    const std::string& name(index == 1 ? _name1 : _name2);
+    if (_opt.normalized) {
+        std::cout << "truncated:file=" << index << ":packet=" << count << ":filename=" << name << ":" << std::endl;
+    }
+    else if (!_opt.quiet) {
+        std::cout << "* Packet " << Decimal (count) << ": file " << name << " is truncated" << std::endl;
+    }
+}
 
-    // Number of differences in file
-    PacketCounter diff_count = 0;
+void Differences::resync(PacketCounter index1)
+{
+    if (_opt.normalized) {
+        std::cout << "skip:packet=" << (index1 - subset_skipped)
+                  << ":skipped=" << Decimal (subset_skipped)
+                  << ":" << std::endl;
+    }
+    else {
+        std::cout << "* Packet " << Decimal (index1 - subset_skipped)
+                  << ", missing " << Decimal (subset_skipped)
+                  << " packets in " << _name2 << std::endl;
+    }
+    total_subset_skipped += subset_skipped;
+    subset_skipped_chunks++;
+    subset_skipped = 0;
+}
 
-    // Read and compare all packets in the files
+bool Differences::report(PacketCounter index1, const TSPacket& pkt1, const TSPacket& pkt2, const Comparator& comp)
+{
+    const PID pid1 = pkt1.getPID();
+    const PID pid2 = pkt2.getPID();
+
+    diff_count++;
+    if (_opt.normalized) {
+        std::cout << "diff:packet=" << index1
+                  << (_opt.payload_only ? ":payload" : "")
+                  << ":offset=" << comp.first_diff
+                  << ":endoffset=" << comp.end_diff
+                  << ":diffbytes= " << comp.diff_count
+                  << ":compsize=" << comp.compared_size
+                  << ":pid1=" << pid1
+                  << ":pid2=" << pid2
+                  << (pid1 == pid2 ? ":samepid" : "")
+                  << ":pid1index=" << (count1[pid1] - 1)
+                  << ":pid2index=" << (count2[pid2] - 1)
+                  << (count2[pid2] == count1[pid1] ? ":sameindex" : "")
+                  << ":" << std::endl;
+    }
+    else if (!_opt.quiet) {
+        std::cout << "* Packet " << Decimal (index1) << " differ at offset " << comp.first_diff;
+        if (_opt.payload_only) {
+            std::cout << " in payload";
+        }
+        std::cout << ", " << comp.diff_count;
+        if (comp.diff_count != comp.end_diff - comp.first_diff) {
+            std::cout << "/" << (comp.end_diff - comp.first_diff);
+        }
+        std::cout << " bytes differ, PID " << pid1;
+        if (pid2 != pid1) {
+            std::cout << "/" << pid2;
+        }
+        std::cout << ", packet " << Decimal (count1[pid1] - 1);
+        if (pid2 != pid1 || count2[pid2] != count1[pid1]) {
+            std::cout << "/" << Decimal (count2[pid2] - 1);
+        }
+        std::cout << " in PID" << std::endl;
+        if (_opt.dump) {
+            std::cout << "  Packet from " << _name1 << ":" << std::endl;
+            pkt1.display (std::cout, _opt.dump_flags, 6);
+            std::cout << "  Packet from " << _name2 << ":" << std::endl;
+            pkt2.display (std::cout, _opt.dump_flags, 6);
+            std::cout << "  Differing area from " << _name1 << ":" << std::endl
+                      << Hexa (pkt1.b + (_opt.payload_only ? pkt1.getHeaderSize() : 0) + comp.first_diff,
+                               comp.end_diff - comp.first_diff, _opt.dump_flags, 6)
+                      << "  Differing area from " << _name2 << ":" << std::endl
+                      << Hexa (pkt2.b + (_opt.payload_only ? pkt2.getHeaderSize() : 0) + comp.first_diff,
+                               comp.end_diff - comp.first_diff, _opt.dump_flags, 6);
+        }
+    }
+    return !_opt.quiet && _opt.continue_all;
+}
+
+void Differences::final(PacketCounter total)
+{
+    if (_opt.normalized) {
+        std::cout << "total:packets=" << total
+                  << ":diff=" << diff_count
+                  << ":missing=" << total_subset_skipped
+                  << ":holes=" << subset_skipped_chunks
+                  << ":" << std::endl;
+    }
+    else if (_opt.verbose) {
+        std::cout << "* Read " << Decimal (total)
+                  << " packets, found " << Decimal (diff_count) << " differences";
+        if (subset_skipped_chunks > 0) {
+            std::cout << ", missing " << Decimal (total_subset_skipped)
+                      << " packets in " << Decimal (subset_skipped_chunks) << " holes";
+        }
+        std::cout << std::endl;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+//  Default comparison mode, reading the files packet by packet.
+//----------------------------------------------------------------------------
+
+static void CompareStreams(Options& opt, Differences& diffs, TSFileInputBuffered& file1, TSFileInputBuffered& file2)
+{
     TSPacket pkt1, pkt2;
     size_t read2 = 0;
-    ts::PID pid2 = PID_NULL;
 
     for (;;) {
 
         // Read one packet in file1
         size_t read1 = file1.read (&pkt1, 1, opt);
-        ts::PID pid1 = pkt1.getPID();
-        count1[pid1]++;
+        diffs.count1[pkt1.getPID()]++;
 
         // If currently not skipping packets, read one packet in file2
-        if (subset_skipped == 0) {
+        if (diffs.subset_skipped == 0) {
             read2 = file2.read (&pkt2, 1, opt);
-            pid2 = pkt2.getPID();
-            count2[pid2]++;
+            diffs.count2[pkt2.getPID()]++;
         }
 
         // Exit if at least one file is terminated
         if (read1 == 0 || read2 == 0) {
             if (read1 != 0 || read2 != 0) {
-                diff_count++;
+                diffs.diff_count++;
             }
             if (read1 != 0) {
-                // File 2 is truncated
-                if (opt.normalized) {
-                    std::cout << "truncated:file=2:packet=" << file2.getPacketCount()
-                              << ":filename=" << file2.getFileName() << ":" << std::endl;
-                }
-                else if (!opt.quiet) {
-                    std::cout << "* Packet " << Decimal (file2.getPacketCount())
-                              << ": file " << file2.getFileName() << " is truncated" << std::endl;
-                }
+                diffs.truncated (2, file2.getPacketCount());
             }
             if (read2 != 0) {
-                // File 1 is truncated
-                if (opt.normalized) {
-                    std::cout << "truncated:file=1:packet=" << file1.getPacketCount()
-                              << ":filename=" << file1.getFileName() << ":" << std::endl;
-                }
-                else if (!opt.quiet) {
-                    std::cout << "* Packet " << Decimal (file1.getPacketCount())
-                              << ": file " << file1.getFileName() << " is truncated" << std::endl;
-                }
+                diffs.truncated (1, file1.getPacketCount());
             }
             break;
         }
@@ -423,102 +555,490 @@ int main (int argc, char *argv[])
 
         // If file2 is a subset of file1 and an inacceptable difference has been found, read ahead file1.
         if (opt.subset && !comp.equal && comp.diff_count > opt.threshold_diff) {
-            subset_skipped++;
+            diffs.subset_skipped++;
             continue;
         }
 
         // Report resynchronization after missing packets
-        if (subset_skipped > 0) {
-            if (opt.normalized) {
-                std::cout << "skip:packet=" << (file1.getPacketCount() - 1 - subset_skipped)
-                          << ":skipped=" << Decimal (subset_skipped)
-                          << ":" << std::endl;
+        if (diffs.subset_skipped > 0) {
+            diffs.resync (file1.getPacketCount() - 1);
+        }
+
+        // Report a difference
+        if (!comp.equal && !diffs.report (file1.getPacketCount() - 1, pkt1, pkt2, comp)) {
+            break;
+        }
+    }
+
+    diffs.final (file1.getPacketCount());
+}
+
+
+//----------------------------------------------------------------------------
+//  Fast mode: memory-mapped files, scanned by a pool of threads.
+//----------------------------------------------------------------------------
+
+class BlockScanner
+{
+public:
+    // Block status, as computed by the threads.
+    enum {PENDING, IDENTICAL, DIFFERENT};
+
+    // Constructor: prepare a scan of "count" items, by blocks of "block_size" items.
+    BlockScanner(size_t count, size_t block_size);
+    virtual ~BlockScanner() {}
+
+    // Run the scan using the specified number of threads.
+    // When "wait" is true, wait for the completion of all blocks.
+    void start(size_t threads);
+    void wait();
+
+    // Get the number of blocks.
+    size_t blockCount() const { return _status.size(); }
+
+    // Wait for the processing of a block by the threads and return its status.
+    int waitBlock(size_t block);
+
+    // Abort the scan: the threads no longer start the processing of new blocks.
+    void abort();
+
+protected:
+    const size_t _count;
+    const size_t _block_size;
+
+    // Process a block of items [first, first+size). Executed in the context of a thread.
+    virtual bool processBlock(size_t first, size_t size) = 0;
+
+private:
+    Mutex               _mutex;
+    Condition           _completed;
+    std::vector<int>    _status;
+    size_t              _next_block;
+    std::vector<Thread*> _threads;
+
+    // Scanning thread.
+    class ScanThread: public Thread
+    {
+    public:
+        explicit ScanThread(BlockScanner& scanner) : Thread(), _scanner(scanner) {}
+        virtual void main();
+    private:
+        BlockScanner& _scanner;
+    };
+
+    // Inaccessible operations
+    BlockScanner(const BlockScanner&) = delete;
+    BlockScanner& operator=(const BlockScanner&) = delete;
+};
+
+BlockScanner::BlockScanner(size_t count, size_t block_size) :
+    _count(count),
+    _block_size(block_size),
+    _mutex(),
+    _completed(),
+    _status((count + block_size - 1) / block_size, PENDING),
+    _next_block(0),
+    _threads()
+{
+}
+
+void BlockScanner::start(size_t threads)
+{
+    for (size_t i = 0; i < threads; ++i) {
+        _threads.push_back(new ScanThread(*this));
+        _threads.back()->start();
+    }
+}
+
+void BlockScanner::wait()
+{
+    for (std::vector<Thread*>::iterator it = _threads.begin(); it != _threads.end(); ++it) {
+        (*it)->waitForTermination();
+        delete *it;
+    }
+    _threads.clear();
+}
+
+int BlockScanner::waitBlock(size_t block)
+{
+    GuardCondition lock(_mutex, _completed);
+    while (_status[block] == PENDING) {
+        lock.waitCondition();
+    }
+    return _status[block];
+}
+
+void BlockScanner::abort()
+{
+    Guard lock(_mutex);
+    _next_block = _status.size();
+}
+
+void BlockScanner::ScanThread::main()
+{
+    for (;;) {
+        // Get next block to process.
+        size_t block = 0;
+        {
+            Guard lock(_scanner._mutex);
+            if (_scanner._next_block >= _scanner._status.size()) {
+                break;
+            }
+            block = _scanner._next_block++;
+        }
+
+        // Process the block outside the mutex.
+        const size_t first = block * _scanner._block_size;
+        const bool identical = _scanner.processBlock(first, std::min(_scanner._block_size, _scanner._count - first));
+
+        // Notify the completion of the block.
+        GuardCondition lock(_scanner._mutex, _scanner._completed);
+        _scanner._status[block] = identical ? IDENTICAL : DIFFERENT;
+        lock.signal();
+    }
+}
+
+// Compare the common part of two memory-mapped files by blocks of packets.
+class PacketBlockComparator: public BlockScanner
+{
+public:
+    PacketBlockComparator(const uint8_t* data1, const uint8_t* data2, size_t count) :
+        BlockScanner(count, FAST_BLOCK_PACKETS),
+        _data1(data1),
+        _data2(data2)
+    {
+    }
+protected:
+    virtual bool processBlock(size_t first, size_t size)
+    {
+        return ::memcmp(_data1 + first * PKT_SIZE, _data2 + first * PKT_SIZE, size * PKT_SIZE) == 0;
+    }
+private:
+    const uint8_t* _data1;
+    const uint8_t* _data2;
+
+    // Inaccessible operations
+    PacketBlockComparator(const PacketBlockComparator&) = delete;
+    PacketBlockComparator& operator=(const PacketBlockComparator&) = delete;
+};
+
+// Hash values of the packets of a memory-mapped file, from a given position.
+// Two packets which are equal in the sense of Comparator (with no threshold) have the same hash.
+// The hash values are computed in parallel, by blocks of packets.
+class PacketHashes: public BlockScanner
+{
+public:
+    PacketHashes(const uint8_t* data, size_t first, size_t end, const Options& opt) :
+        BlockScanner(end - first, FAST_BLOCK_PACKETS),
+        _first(first),
+        _hashes(end - first, 0),
+        _data(data),
+        _opt(opt)
+    {
+    }
+
+    // Get the hash value of a packet, by index in file.
+    uint32_t hash(size_t index) const { return _hashes[index - _first]; }
+
+    // Compute the hash value of a packet.
+    static uint32_t Hash(const TSPacket& pkt, const Options& opt);
+
+protected:
+    virtual bool processBlock(size_t first, size_t size)
+    {
+        TSPacket pkt;
+        for (size_t i = first; i < first + size; ++i) {
+            ::memcpy(pkt.b, _data + (_first + i) * PKT_SIZE, PKT_SIZE);
+            _hashes[i] = Hash(pkt, _opt);
+        }
+        return true;
+    }
+private:
+    const size_t          _first;
+    std::vector<uint32_t> _hashes;
+    const uint8_t*        _data;
+    const Options&        _opt;
+
+    // Inaccessible operations
+    PacketHashes(const PacketHashes&) = delete;
+    PacketHashes& operator=(const PacketHashes&) = delete;
+};
+
+uint32_t PacketHashes::Hash(const TSPacket& pkt, const Options& opt)
+{
+    // All null packets are equal.
+    if (pkt.getPID() == PID_NULL) {
+        return 0;
+    }
+
+    // Reset ignored fields, the same way as Comparator.
+    TSPacket p;
+    p = pkt;
+    if (opt.pcr_ignore) {
+        if (p.hasPCR()) {
+            p.setPCR (0);
+        }
+        if (p.hasOPCR()) {
+            p.setOPCR (0);
+        }
+    }
+    if (opt.pid_ignore) {
+        p.setPID (PID_NULL);
+    }
+    if (opt.cc_ignore) {
+        p.setCC (0);
+    }
+
+    // FNV-1a hash, by 32-bit words.
+    uint32_t hash = 0x811C9DC5;
+    for (size_t i = 0; i < PKT_SIZE; i += 4) {
+        hash = (hash ^ GetUInt32 (p.b + i)) * 0x01000193;
+    }
+    return hash;
+}
+
+// Count PID's of packets in a memory area into one or two sets of counters.
+static void CountPIDs(PacketCounter* count1, PacketCounter* count2, const uint8_t* data, size_t first, size_t end)
+{
+    for (size_t i = first; i < end; ++i) {
+        const PID pid = GetUInt16 (data + i * PKT_SIZE + 1) & 0x1FFF;
+        count1[pid]++;
+        if (count2 != 0) {
+            count2[pid]++;
+        }
+    }
+}
+
+// Fast comparison of two complete files.
+static void CompareMappedFiles(Options& opt, Differences& diffs, const MemoryMappedFile& file1, const MemoryMappedFile& file2)
+{
+    const uint8_t* const data1 = file1.data();
+    const uint8_t* const data2 = file2.data();
+    const size_t count1 = file1.size() / PKT_SIZE;
+    const size_t count2 = file2.size() / PKT_SIZE;
+
+    // Compare the common part of the two files by blocks, in parallel.
+    PacketBlockComparator scanner(data1, data2, std::min(count1, count2));
+    scanner.start(opt.threads);
+
+    // Process the blocks in order. Only the differing blocks are compared packet by packet.
+    size_t counted = 0;  // PID's are counted up to this packet.
+    bool stop = false;
+    PacketCounter total = 0;
+    TSPacket pkt1, pkt2;
+
+    for (size_t block = 0; !stop && block < scanner.blockCount(); ++block) {
+        if (scanner.waitBlock(block) == BlockScanner::IDENTICAL) {
+            continue;
+        }
+
+        // Account packets in previous identical blocks.
+        const size_t first = block * FAST_BLOCK_PACKETS;
+        const size_t end = std::min(first + FAST_BLOCK_PACKETS, std::min(count1, count2));
+        CountPIDs(diffs.count1, diffs.count2, data1, counted, first);
+        counted = end;
+
+        for (size_t i = first; !stop && i < end; ++i) {
+            ::memcpy(pkt1.b, data1 + i * PKT_SIZE, PKT_SIZE);
+            ::memcpy(pkt2.b, data2 + i * PKT_SIZE, PKT_SIZE);
+            diffs.count1[pkt1.getPID()]++;
+            diffs.count2[pkt2.getPID()]++;
+            const Comparator comp (pkt1, pkt2, opt);
+            if (!comp.equal && !diffs.report (i, pkt1, pkt2, comp)) {
+                // Early exit, the remaining blocks are useless.
+                stop = true;
+                total = i + 1;
+                scanner.abort();
             }
-            else {
-                std::cout << "* Packet " << Decimal (file1.getPacketCount() - 1 - subset_skipped)
-                          << ", missing " << Decimal (subset_skipped)
-                          << " packets in " << file2.getFileName() << std::endl;
+        }
+    }
+    scanner.wait();
+
+    // Report truncated files, the same way as the default mode.
+    if (!stop) {
+        total = std::min(count1, count2);
+        if (count1 != count2) {
+            diffs.diff_count++;
+        }
+        if (count1 > count2) {
+            diffs.truncated (2, count2);
+            total++;
+        }
+        else if (count2 > count1) {
+            diffs.truncated (1, count1);
+        }
+    }
+
+    diffs.final (total);
+}
+
+// Fast comparison when file2 is a subset of file1.
+static void CompareMappedSubset(Options& opt, Differences& diffs, const MemoryMappedFile& file1, const MemoryMappedFile& file2)
+{
+    const uint8_t* const data1 = file1.data();
+    const uint8_t* const data2 = file2.data();
+    const size_t count1 = file1.size() / PKT_SIZE;
+    const size_t count2 = file2.size() / PKT_SIZE;
+
+    // The packet hashes are usable only when equal packets have strictly identical
+    // (normalized) content, ie. when packets are compared without threshold.
+    // With --payload-only, two payloads of distinct sizes may have no differing byte.
+    // They are computed at the first missing packet, from this packet to the end of file1.
+    const bool use_hashes = opt.threshold_diff == 0 && !opt.payload_only;
+    SafePtr<PacketHashes> hashes;
+
+    size_t i1 = 0;            // Index of next packet in file1.
+    size_t i2 = 0;            // Index of next packet in file2.
+    size_t slow_end = 0;      // Compare packet by packet up to this index in file1.
+    uint32_t hash2 = 0;       // Hash of current packet in file2, when skipping.
+    TSPacket pkt1, pkt2;
+
+    for (;;) {
+
+        // When not skipping and not in a differing area, try to skip a block of identical packets.
+        if (diffs.subset_skipped == 0 && i1 >= slow_end && i1 < count1 && i2 < count2) {
+            const size_t size = std::min(size_t(FAST_BLOCK_PACKETS), std::min(count1 - i1, count2 - i2));
+            if (::memcmp(data1 + i1 * PKT_SIZE, data2 + i2 * PKT_SIZE, size * PKT_SIZE) == 0) {
+                CountPIDs(diffs.count1, diffs.count2, data1, i1, i1 + size);
+                i1 += size;
+                i2 += size;
+                continue;
             }
-            total_subset_skipped += subset_skipped;
-            subset_skipped_chunks++;
-            subset_skipped = 0;
+            slow_end = i1 + size;
         }
 
-        // Report a difference
-        if (!comp.equal) {
-            diff_count++;
-            if (opt.normalized) {
-                std::cout << "diff:packet=" << (file1.getPacketCount() - 1)
-                          << (opt.payload_only ? ":payload" : "")
-                          << ":offset=" << comp.first_diff
-                          << ":endoffset=" << comp.end_diff
-                          << ":diffbytes= " << comp.diff_count
-                          << ":compsize=" << comp.compared_size
-                          << ":pid1=" << pid1
-                          << ":pid2=" << pid2
-                          << (pid1 == pid2 ? ":samepid" : "")
-                          << ":pid1index=" << (count1[pid1] - 1)
-                          << ":pid2index=" << (count2[pid2] - 1)
-                          << (count2[pid2] == count1[pid1] ? ":sameindex" : "")
-                          << ":" << std::endl;
+        // Same processing as the default mode on one packet.
+        const bool read1 = i1 < count1;
+        if (read1) {
+            ::memcpy(pkt1.b, data1 + i1 * PKT_SIZE, PKT_SIZE);
+            diffs.count1[pkt1.getPID()]++;
+            i1++;
+        }
+        bool read2 = true;
+        if (diffs.subset_skipped == 0) {
+            read2 = i2 < count2;
+            if (read2) {
+                ::memcpy(pkt2.b, data2 + i2 * PKT_SIZE, PKT_SIZE);
+                diffs.count2[pkt2.getPID()]++;
+                i2++;
             }
-            else if (!opt.quiet) {
-                std::cout << "* Packet " << Decimal (file1.getPacketCount() - 1) << " differ at offset " << comp.first_diff;
-                if (opt.payload_only) {
-                    std::cout << " in payload";
-                }
-                std::cout << ", " << comp.diff_count;
-                if (comp.diff_count != comp.end_diff - comp.first_diff) {
-                    std::cout << "/" << (comp.end_diff - comp.first_diff);
-                }
-                std::cout << " bytes differ, PID " << pid1;
-                if (pid2 != pid1) {
-                    std::cout << "/" << pid2;
+        }
+
+        // Exit if at least one file is terminated
+        if (!read1 || !read2) {
+            if (read1 || read2) {
+                diffs.diff_count++;
+            }
+            if (read1) {
+                diffs.truncated (2, i2);
+            }
+            if (read2) {
+                diffs.truncated (1, i1);
+            }
+            break;
+        }
+
+        // Compare one packet
+        const Comparator comp (pkt1, pkt2, opt);
+
+        // If an inacceptable difference has been found, read ahead file1.
+        if (!comp.equal && comp.diff_count > opt.threshold_diff) {
+            diffs.subset_skipped++;
+            if (use_hashes) {
+                // Directly move to the next packet in file1 with the same hash.
+                // Since i1 never moves backward, the hashes are scanned only once.
+                if (diffs.subset_skipped == 1) {
+                    hash2 = PacketHashes::Hash(pkt2, opt);
                 }
-                std::cout << ", packet " << Decimal (count1[pid1] - 1);
-                if (pid2 != pid1 || count2[pid2] != count1[pid1]) {
-                    std::cout << "/" << Decimal (count2[pid2] - 1);
+                if (hashes.isNull()) {
+                    hashes = new PacketHashes(data1, i1, count1, opt);
+                    hashes->start(opt.threads);
+                    hashes->wait();
                 }
-                std::cout << " in PID" << std::endl;
-                if (opt.dump) {
-                    std::cout << "  Packet from " << file1.getFileName() << ":" << std::endl;
-                    pkt1.display (std::cout, opt.dump_flags, 6);
-                    std::cout << "  Packet from " << file2.getFileName() << ":" << std::endl;
-                    pkt2.display (std::cout, opt.dump_flags, 6);
-                    std::cout << "  Differing area from " << file1.getFileName() << ":" << std::endl
-                              << Hexa (pkt1.b + (opt.payload_only ? pkt1.getHeaderSize() : 0) + comp.first_diff,
-                                       comp.end_diff - comp.first_diff, opt.dump_flags, 6)
-                              << "  Differing area from " << file2.getFileName() << ":" << std::endl
-                              << Hexa (pkt2.b + (opt.payload_only ? pkt2.getHeaderSize() : 0) + comp.first_diff,
-                                       comp.end_diff - comp.first_diff, opt.dump_flags, 6);
+                size_t next = i1;
+                while (next < count1 && hashes->hash(next) != hash2) {
+                    next++;
                 }
+                CountPIDs(diffs.count1, 0, data1, i1, next);
+                diffs.subset_skipped += next - i1;
+                i1 = next;
             }
-            if (opt.quiet || !opt.continue_all) {
-                break;
-            }
+            continue;
+        }
+
+        // Report resynchronization after missing packets
+        if (diffs.subset_skipped > 0) {
+            diffs.resync (i1 - 1);
+        }
+
+        // Report a difference
+        if (!comp.equal && !diffs.report (i1 - 1, pkt1, pkt2, comp)) {
+            break;
         }
     }
 
-    // Final report
+    diffs.final (i1);
+}
+
+
+//----------------------------------------------------------------------------
+//  Program entry point
+//----------------------------------------------------------------------------
+
+int main (int argc, char *argv[])
+{
+    Options opt (argc, argv);
+    TSFileInputBuffered file1 (opt.buffered_packets);
+    TSFileInputBuffered file2 (opt.buffered_packets);
+    MemoryMappedFile map1;
+    MemoryMappedFile map2;
+
+    // Open files
+    if (opt.fast) {
+        map1.open (opt.filename1, opt.byte_offset, false, opt);
+        map2.open (opt.filename2, opt.byte_offset, false, opt);
+        map1.adviseSequential();
+        map2.adviseSequential();
+    }
+    else {
+        file1.open (opt.filename1, 1, opt.byte_offset, opt);
+        file2.open (opt.filename2, 1, opt.byte_offset, opt);
+    }
+    opt.exitOnError();
+
+    const std::string name1 (opt.fast ? map1.getFileName() : file1.getFileName());
+    const std::string name2 (opt.fast ? map2.getFileName() : file2.getFileName());
+
+    // Display headers
     if (opt.normalized) {
-        std::cout << "total:packets=" << file1.getPacketCount()
-                  << ":diff=" << diff_count
-                  << ":missing=" << total_subset_skipped
-                  << ":holes=" << subset_skipped_chunks
-                  << ":" << std::endl;
+        std::cout << "file:file=1:filename=" << name1 << ":" << std::endl
+                  << "file:file=2:filename=" << name2 << ":" << std::endl;
+
     }
     else if (opt.verbose) {
-        std::cout << "* Read " << Decimal (file1.getPacketCount())
-                  << " packets, found " << Decimal (diff_count) << " differences";
-        if (subset_skipped_chunks > 0) {
-            std::cout << ", missing " << Decimal (total_subset_skipped)
-                      << " packets in " << Decimal (subset_skipped_chunks) << " holes";
-        }
-        std::cout << std::endl;
+        std::cout << "* Comparing " << name1 << " and " << name2 << std::endl;
+    }
+
+    // Read and compare all packets in the files
+    Differences diffs (opt, name1, name2);
+    if (!opt.fast) {
+        CompareStreams (opt, diffs, file1, file2);
+    }
+    else if (opt.subset) {
+        CompareMappedSubset (opt, diffs, map1, map2);
+    }
+    else {
+        CompareMappedFiles (opt, diffs, map1, map2);
     }
 
     // End of processing, close file
-    file1.close (opt);
-    file2.close (opt);
-    return diff_count == 0 && opt.valid() ? EXIT_SUCCESS : EXIT_FAILURE;
+    if (opt.fast) {
+        map1.close (opt);
+        map2.close (opt);
+    }
+    else {
+        file1.close (opt);
+        file2.close (opt);
+    }
+    return diffs.diff_count == 0 && opt.valid() ? EXIT_SUCCESS : EXIT_FAILURE;
 }
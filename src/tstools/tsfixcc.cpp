@@ -35,8 +35,13 @@
 #include "tsTSPacket.h"
 #include "tsFormat.h"
 #include "tsDecimal.h"
+#include "tsMemoryMappedFile.h"
+#include "tsThread.h"
+#include "tsGuardCondition.h"
 TSDUCK_SOURCE;
 
+#define FAST_CHUNK_PACKETS 65536   // Packets per chunk in fast mode (about 12 MB)
+
 
 //----------------------------------------------------------------------------
 //  Command line options
@@ -50,6 +55,8 @@ public:
     bool         verbose;   // Verbose mode
     bool         test;      // Test mode
     bool         circular;  // Add empty packets to enforce circular continuity
+    bool         fast;      // Fast mode, using a memory-mapped file
+    size_t       threads;   // Number of pre-scan threads in fast mode
     std::string  filename;  // File name
     std::fstream file;      // File buffer
 
@@ -63,12 +70,16 @@ Options::Options(int argc, char *argv[]) :
     verbose(false),
     test(false),
     circular(false),
+    fast(false),
+    threads(0),
     filename(),
     file()
 {
     option("",          0,  Args::STRING, 1, 1);
     option("circular", 'c');
+    option("fast",     'f');
     option("noaction", 'n');
+    option("threads",   0,  Args::INTEGER, 0, 1, 1, 256);
     option("verbose",  'v');
 
     setHelp("File:\n"
@@ -83,6 +94,12 @@ Options::Options(int argc, char *argv[]) :
             "      Add empty packets, if necessary, on each PID so that the\n"
             "      continuity is preserved between end and beginning of file.\n"
             "\n"
+            "  -f\n"
+            "  --fast\n"
+            "      Fast mode. The file is mapped in memory and the continuity counters are\n"
+            "      directly updated in the mapped area. The modifications are progressively\n"
+            "      flushed to disk. The file must be a regular file. See also --threads.\n"
+            "\n"
             "  --help\n"
             "      Display this help text.\n"
             "\n"
@@ -90,6 +107,11 @@ Options::Options(int argc, char *argv[]) :
             "  --noaction\n"
             "      Display what should be performed but do not modify the file.\n"
             "\n"
+            "  --threads value\n"
+            "      With --fast, pre-scan the file in parallel using the specified number of\n"
+            "      threads. The chunks of the file without discontinuity are then skipped.\n"
+            "      By default, there is no pre-scan.\n"
+            "\n"
             "  -v\n"
             "  --verbose\n"
             "      Produce verbose messages.\n"
@@ -101,6 +123,8 @@ Options::Options(int argc, char *argv[]) :
 
     filename = value("");
     circular = present("circular");
+    fast = present("fast");
+    threads = intValue<size_t>("threads", 0);
     test = present("noaction");
     verbose = test || present("verbose");
 }
@@ -150,33 +174,285 @@ public:
 
 
 //----------------------------------------------------------------------------
-//  Program entry point
+//  Summary of the PID's in a chunk of packets (fast mode pre-scan).
 //----------------------------------------------------------------------------
 
-int main(int argc, char *argv[])
+class PIDSummary
 {
-    Options opt(argc, argv);
+public:
+    uint8_t first_cc;       // CC of first packet in chunk
+    bool    first_payload;  // First packet in chunk has a payload
+    uint8_t last_cc;        // CC of last packet in chunk
 
-    // Open file in read/write mode (CC are overwritten)
+    // Constructor
+    PIDSummary(uint8_t cc = 0, bool payload = false) :
+        first_cc(cc),
+        first_payload(payload),
+        last_cc(cc)
+    {
+    }
+};
 
-    std::ios::openmode mode = std::ios::in | std::ios::binary;
-    if (!opt.test) {
-        mode |= std::ios::out;
+typedef std::map<ts::PID, PIDSummary> PIDSummaryMap;
+
+
+//----------------------------------------------------------------------------
+//  Continuity counters analysis, common to all modes.
+//----------------------------------------------------------------------------
+
+class CCFixer
+{
+public:
+    // Constructor
+    CCFixer(Options& opt);
+
+    PIDState          pids[ts::PID_MAX];
+    ts::PacketCounter packet_count;
+    ts::PacketCounter error_count;
+    ts::PacketCounter rewrite_count;
+
+    // Process the next packet in the file. Update its CC if necessary.
+    // Return true if the packet was modified and must be rewritten.
+    bool fixPacket(ts::TSPacket& pkt);
+
+    // Skip a chunk of packets which was found without discontinuity during a pre-scan.
+    // Return false if the chunk cannot be skipped and must be processed packet by packet.
+    bool skipChunk(const PIDSummaryMap& summary, size_t packets);
+
+private:
+    Options& _opt;
+};
+
+CCFixer::CCFixer(Options& opt) :
+    pids(),
+    packet_count(0),
+    error_count(0),
+    rewrite_count(0),
+    _opt(opt)
+{
+}
+
+bool CCFixer::fixPacket(ts::TSPacket& pkt)
+{
+    const ts::PID pid = pkt.getPID();
+    const uint8_t cc = pkt.getCC();
+    uint8_t good_cc = cc;
+
+    if (pids[pid].first_cc > 0x0F) {
+        // First packet on this PID
+        pids[pid].first_cc = cc;
+        pids[pid].sync = true;
+    }
+    else {
+        // Compute expected CC for this packet
+        good_cc = pkt.hasPayload() ? ((pids[pid].last_cc + 1) & 0x0F) : pids[pid].last_cc;
+        if (pids[pid].sync && cc != good_cc) {
+            // PID was correctly synchronized, but the current CC is wrong.
+            // We now loose the synchronization on this PID.
+            pids[pid].sync = false;
+            error_count++;
+            if (_opt.verbose) {
+                std::cerr << "TS packet: " << ts::Decimal(packet_count)
+                          << ts::Format(", PID: 0x%04X, missing: %2d packets", pid, MissingPackets(pids[pid].last_cc, cc))
+                          << std::endl;
+            }
+        }
+    }
+
+    // Update CC in packet with expected value if no longer synchronized
+    const bool rewrite = !pids[pid].sync && !_opt.test;
+    if (rewrite) {
+        pkt.setCC(good_cc);
     }
 
-    opt.file.open(opt.filename.c_str(), mode);
+    pids[pid].last_cc = good_cc;
+    packet_count++;
+    return rewrite;
+}
+
+bool CCFixer::skipChunk(const PIDSummaryMap& summary, size_t packets)
+{
+    // All PID's in the chunk must be synchronized and continue the previous chunk.
+    for (PIDSummaryMap::const_iterator it = summary.begin(); it != summary.end(); ++it) {
+        const PIDState& state(pids[it->first]);
+        if (state.first_cc <= 0x0F) {
+            const uint8_t good_cc = it->second.first_payload ? ((state.last_cc + 1) & 0x0F) : state.last_cc;
+            if (!state.sync || it->second.first_cc != good_cc) {
+                return false;
+            }
+        }
+    }
+
+    // Now skip the chunk.
+    for (PIDSummaryMap::const_iterator it = summary.begin(); it != summary.end(); ++it) {
+        PIDState& state(pids[it->first]);
+        if (state.first_cc > 0x0F) {
+            state.first_cc = it->second.first_cc;
+            state.sync = true;
+        }
+        state.last_cc = it->second.last_cc;
+    }
+    packet_count += packets;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+//  Fast mode pre-scan: a pool of threads checks the continuity inside each
+//  chunk of the memory-mapped file and builds a summary of the chunk.
+//----------------------------------------------------------------------------
+
+class ChunkPreScanner
+{
+public:
+    // Constructor: start the pre-scan using the specified number of threads (can be zero).
+    ChunkPreScanner(const uint8_t* data, size_t packet_count, size_t threads);
+
+    // Destructor: abort the pre-scan.
+    ~ChunkPreScanner();
+
+    // Wait for the pre-scan of a chunk. Return true if the chunk has no discontinuity.
+    // In that case, "summary" points to the summary of all PID's in the chunk.
+    bool waitChunk(size_t chunk, const PIDSummaryMap*& summary);
+
+private:
+    // Pre-scan result of a chunk.
+    struct Chunk
+    {
+        bool          done;   // Pre-scan completed
+        bool          clean;  // No discontinuity in chunk
+        PIDSummaryMap pids;   // Summary of PID's in chunk
+        Chunk() : done(false), clean(false), pids() {}
+    };
+
+    // Pre-scan thread.
+    class ScanThread: public ts::Thread
+    {
+    public:
+        explicit ScanThread(ChunkPreScanner& scanner) : Thread(), _scanner(scanner) {}
+        virtual void main();
+    private:
+        ChunkPreScanner& _scanner;
+        ScanThread(const ScanThread&) = delete;
+        ScanThread& operator=(const ScanThread&) = delete;
+    };
+
+    const uint8_t* const  _data;
+    const size_t          _packet_count;
+    ts::Mutex             _mutex;
+    ts::Condition         _completed;
+    std::vector<Chunk>    _chunks;
+    size_t                _next_chunk;
+    std::vector<ts::Thread*> _threads;
+
+    // Pre-scan one chunk. Executed in the context of a thread.
+    void scanChunk(size_t chunk, Chunk& result);
+
+    // Inaccessible operations
+    ChunkPreScanner(const ChunkPreScanner&) = delete;
+    ChunkPreScanner& operator=(const ChunkPreScanner&) = delete;
+};
+
+ChunkPreScanner::ChunkPreScanner(const uint8_t* data, size_t packet_count, size_t threads) :
+    _data(data),
+    _packet_count(packet_count),
+    _mutex(),
+    _completed(),
+    _chunks(threads == 0 ? 0 : (packet_count + FAST_CHUNK_PACKETS - 1) / FAST_CHUNK_PACKETS),
+    _next_chunk(0),
+    _threads()
+{
+    for (size_t i = 0; i < threads; ++i) {
+        _threads.push_back(new ScanThread(*this));
+        _threads.back()->start();
+    }
+}
+
+ChunkPreScanner::~ChunkPreScanner()
+{
+    {
+        ts::Guard lock(_mutex);
+        _next_chunk = _chunks.size();
+    }
+    for (std::vector<ts::Thread*>::iterator it = _threads.begin(); it != _threads.end(); ++it) {
+        (*it)->waitForTermination();
+        delete *it;
+    }
+}
+
+bool ChunkPreScanner::waitChunk(size_t chunk, const PIDSummaryMap*& summary)
+{
+    if (chunk >= _chunks.size()) {
+        return false; // no pre-scan
+    }
+    ts::GuardCondition lock(_mutex, _completed);
+    while (!_chunks[chunk].done) {
+        lock.waitCondition();
+    }
+    summary = &_chunks[chunk].pids;
+    return _chunks[chunk].clean;
+}
+
+void ChunkPreScanner::ScanThread::main()
+{
+    for (;;) {
+        // Get next chunk to process.
+        size_t chunk = 0;
+        {
+            ts::Guard lock(_scanner._mutex);
+            if (_scanner._next_chunk >= _scanner._chunks.size()) {
+                break;
+            }
+            chunk = _scanner._next_chunk++;
+        }
 
-    if (!opt.file) {
-        opt.error("cannot open file " + opt.filename);
-        return EXIT_FAILURE;
+        // Process the chunk outside the mutex.
+        Chunk result;
+        _scanner.scanChunk(chunk, result);
+
+        // Notify the completion of the chunk.
+        ts::GuardCondition lock(_scanner._mutex, _scanner._completed);
+        _scanner._chunks[chunk].pids.swap(result.pids);
+        _scanner._chunks[chunk].clean = result.clean;
+        _scanner._chunks[chunk].done = true;
+        lock.signal();
+    }
+}
+
+void ChunkPreScanner::scanChunk(size_t chunk, Chunk& result)
+{
+    const size_t first = chunk * FAST_CHUNK_PACKETS;
+    const size_t count = std::min<size_t>(FAST_CHUNK_PACKETS, _packet_count - first);
+    const ts::TSPacket* pkt = reinterpret_cast<const ts::TSPacket*>(_data + first * ts::PKT_SIZE);
+
+    result.clean = false;
+    for (size_t i = 0; i < count; ++i, ++pkt) {
+        if (!pkt->hasValidSync()) {
+            return;
+        }
+        const uint8_t cc = pkt->getCC();
+        const bool payload = pkt->hasPayload();
+        PIDSummaryMap::iterator it = result.pids.find(pkt->getPID());
+        if (it == result.pids.end()) {
+            result.pids.insert(std::make_pair(pkt->getPID(), PIDSummary(cc, payload)));
+        }
+        else if (cc != (payload ? ((it->second.last_cc + 1) & 0x0F) : it->second.last_cc)) {
+            return; // discontinuity
+        }
+        else {
+            it->second.last_cc = cc;
+        }
     }
+    result.clean = true;
+}
 
-    // Process all packets in the file
 
-    PIDState pids[ts::PID_MAX];
-    ts::PacketCounter packet_count = 0;
-    ts::PacketCounter error_count = 0;
-    ts::PacketCounter rewrite_count = 0;
+//----------------------------------------------------------------------------
+//  Process a file using standard I/O, rewriting modified packets one by one.
+//----------------------------------------------------------------------------
+
+void FixStream(Options& opt, CCFixer& fixer)
+{
     ts::TSPacket pkt;
 
     for (;;) {
@@ -194,38 +470,9 @@ int main(int argc, char *argv[])
             break; // end of file
         }
 
-        // Process packet
+        // Process packet, rewrite it if no longer synchronized
 
-        const ts::PID pid = pkt.getPID();
-        const uint8_t cc = pkt.getCC();
-        uint8_t good_cc = cc;
-
-        if (pids[pid].first_cc > 0x0F) {
-            // First packet on this PID
-            pids[pid].first_cc = cc;
-            pids[pid].sync = true;
-        }
-        else {
-            // Compute expected CC for this packet
-            good_cc = pkt.hasPayload() ? ((pids[pid].last_cc + 1) & 0x0F) : pids[pid].last_cc;
-            if (pids[pid].sync && cc != good_cc) {
-                // PID was correctly synchronized, but the current CC is wrong.
-                // We now loose the synchronization on this PID.
-                pids[pid].sync = false;
-                error_count++;
-                if (opt.verbose) {
-                    std::cerr << "TS packet: " << ts::Decimal(packet_count)
-                              << ts::Format(", PID: 0x%04X, missing: %2d packets", pid, MissingPackets(pids[pid].last_cc, cc))
-                              << std::endl;
-                }
-            }
-        }
-
-        // Rewrite packet if no longer synchronized
-
-        if (!pids[pid].sync && !opt.test) {
-            // Update CC in packet with expected value
-            pkt.setCC(good_cc);
+        if (fixer.fixPacket(pkt)) {
             // Rewind to beginning of current packet
             opt.file.seekp(pos);
             if (opt.fileError("error setting file position")) {
@@ -241,17 +488,115 @@ int main(int argc, char *argv[])
             if (opt.fileError("error setting file position")) {
                 break;
             }
-            rewrite_count++;
+            fixer.rewrite_count++;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+//  Process a memory-mapped file, updating the packets in place.
+//----------------------------------------------------------------------------
+
+void FixMappedFile(Options& opt, CCFixer& fixer, ts::MemoryMappedFile& file)
+{
+    const size_t count = file.size() / ts::PKT_SIZE;
+    uint8_t* const data = file.data();
+    file.adviseSequential();
+
+    // Optional parallel pre-scan, always running ahead of the sequential processing.
+    ChunkPreScanner prescan(data, count, opt.threads);
+
+    bool sync_lost = false;
+    for (size_t chunk = 0, first = 0; !sync_lost && first < count; ++chunk, first += FAST_CHUNK_PACKETS) {
+        const size_t size = std::min<size_t>(FAST_CHUNK_PACKETS, count - first);
+
+        // Skip chunks without discontinuity, as long as the previous chunks were also synchronized.
+        const PIDSummaryMap* summary = 0;
+        if (prescan.waitChunk(chunk, summary) && fixer.skipChunk(*summary, size)) {
+            continue;
+        }
+
+        // Process all packets in the chunk.
+        bool modified = false;
+        ts::TSPacket* pkt = reinterpret_cast<ts::TSPacket*>(data + first * ts::PKT_SIZE);
+        for (size_t i = 0; i < size; ++i, ++pkt) {
+            if (!pkt->hasValidSync()) {
+                const size_t index = first + i;
+                opt.error("synchronization lost" + (index > 0 ? " after " + ts::Decimal(index) + " TS packets" : std::string()) +
+                          ts::Format(", got 0x%02X instead of 0x%02X at start of TS packet", int(pkt->b[0]), int(ts::SYNC_BYTE)));
+                sync_lost = true;
+                break;
+            }
+            if (fixer.fixPacket(*pkt)) {
+                modified = true;
+                fixer.rewrite_count++;
+            }
+        }
+
+        // Progressively flush the modified chunks to disk.
+        if (modified && !file.sync(first * ts::PKT_SIZE, size * ts::PKT_SIZE, opt)) {
+            break;
+        }
+    }
+
+    const size_t trailing = file.size() % ts::PKT_SIZE;
+    if (!sync_lost && trailing > 0) {
+        opt.error("truncated TS packet (" + ts::Decimal(trailing) + " bytes)" + (count > 0 ? " after " + ts::Decimal(count) + " TS packets" : std::string()));
+    }
+}
+
+
+//----------------------------------------------------------------------------
+//  Program entry point
+//----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    Options opt(argc, argv);
+    CCFixer fixer(opt);
+    PIDState* const pids = fixer.pids;
+
+    // Open file in read/write mode (CC are overwritten)
+
+    std::ios::openmode mode = std::ios::in | std::ios::binary;
+    if (!opt.test) {
+        mode |= std::ios::out;
+    }
+
+    if (opt.fast) {
+        // Process all packets in the memory-mapped file
+        ts::MemoryMappedFile map;
+        if (!map.open(opt.filename, 0, !opt.test, opt)) {
+            return EXIT_FAILURE;
+        }
+        FixMappedFile(opt, fixer, map);
+        map.close(opt);
+
+        // Reopen the file in the standard way if packets must be appended
+        if (opt.circular && opt.valid() && !opt.test) {
+            opt.file.open(opt.filename.c_str(), mode);
+            if (!opt.file) {
+                opt.error("cannot open file " + opt.filename);
+            }
+        }
+    }
+    else {
+        opt.file.open(opt.filename.c_str(), mode);
+
+        if (!opt.file) {
+            opt.error("cannot open file " + opt.filename);
+            return EXIT_FAILURE;
         }
 
-        pids[pid].last_cc = good_cc;
-        packet_count++;
+        // Process all packets in the file
+        FixStream(opt, fixer);
     }
 
     if (opt.verbose) {
-        std::cerr << ts::Decimal(packet_count) << " packets read, "
-                  << ts::Decimal(error_count) << " discontinuities, "
-                  << ts::Decimal(rewrite_count) << " packets updated"
+        std::cerr << ts::Decimal(fixer.packet_count) << " packets read, "
+                  << ts::Decimal(fixer.error_count) << " discontinuities, "
+                  << ts::Decimal(fixer.rewrite_count) << " packets updated"
                   << std::endl;
     }
 
@@ -261,6 +606,7 @@ int main(int argc, char *argv[])
 
         // Create an empty packet (no payload, 184-byte adaptation field)
 
+        ts::TSPacket pkt;
         pkt = ts::NullPacket;
         pkt.b[3] = 0x20;    // adaptation field, no payload
         pkt.b[4] = 183;     // adaptation field length
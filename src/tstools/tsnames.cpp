@@ -0,0 +1,136 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Names configuration files compiler
+//
+//----------------------------------------------------------------------------
+
+#include "tsArgs.h"
+#include "tsNames.h"
+#include "tsSysUtils.h"
+TSDUCK_SOURCE;
+
+using namespace ts;
+
+
+//----------------------------------------------------------------------------
+//  Command line options
+//----------------------------------------------------------------------------
+
+struct Options: public Args
+{
+    Options(int argc, char *argv[]);
+
+    StringVector files;       // Input file names.
+    std::string  output_dir;  // Output directory.
+    bool         verbose;     // Verbose mode.
+};
+
+Options::Options(int argc, char *argv[]) :
+    Args("TSDuck names configuration files compiler.", "[options] filename ..."),
+    files(),
+    output_dir(),
+    verbose(false)
+{
+    option("",                  0,  Args::STRING, 1, Args::UNLIMITED_COUNT);
+    option("output-directory", 'o', Args::STRING);
+    option("verbose",          'v');
+
+    setHelp("Files:\n"
+            "\n"
+            "  Names configuration files (tsduck.*.names) to compile. Each file is\n"
+            "  compiled into a binary file with the same name and an additional \".bin\"\n"
+            "  suffix. At run time, when a compiled file is found and is not older than\n"
+            "  the corresponding text file, it is directly mapped in memory and the text\n"
+            "  file is not parsed.\n"
+            "\n"
+            "Options:\n"
+            "\n"
+            "  --help\n"
+            "      Display this help text.\n"
+            "\n"
+            "  -o path\n"
+            "  --output-directory path\n"
+            "      Directory of the compiled files. By default, each compiled file is\n"
+            "      created in the same directory as its text file.\n"
+            "\n"
+            "  -v\n"
+            "  --verbose\n"
+            "      Produce verbose messages.\n"
+            "\n"
+            "  --version\n"
+            "      Display the version number.\n");
+
+    analyze(argc, argv);
+
+    getValues(files);
+    output_dir = value("output-directory");
+    verbose = present("verbose");
+
+    if (!output_dir.empty() && !IsDirectory(output_dir)) {
+        error("directory not found: " + output_dir);
+    }
+
+    exitOnError();
+}
+
+
+//----------------------------------------------------------------------------
+//  Program entry point
+//----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    Options opt(argc, argv);
+    bool success = true;
+
+    for (StringVector::const_iterator file = opt.files.begin(); file != opt.files.end(); ++file) {
+
+        // Load and compile the text file. Errors are reported on stderr.
+        const Names names(*file);
+        if (names.configurationFile().empty() || names.errorCount() > 0) {
+            opt.error("error loading " + *file);
+            success = false;
+            continue;
+        }
+
+        // Save the compiled image.
+        const std::string output((opt.output_dir.empty() ? *file : opt.output_dir + PathSeparator + BaseName(*file)) + Names::COMPILED_SUFFIX);
+        if (names.saveCompiledFile(output, opt)) {
+            if (opt.verbose) {
+                std::cout << "tsnames: " << *file << " compiled into " << output << std::endl;
+            }
+        }
+        else {
+            success = false;
+        }
+    }
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -34,8 +34,13 @@
 #include "tspOptions.h"
 #include "tspListProcessors.h"
 #include "tspInputExecutor.h"
+#include "tspInputMerger.h"
+#include "tspLatencyMeter.h"
 #include "tspOutputExecutor.h"
 #include "tspProcessorExecutor.h"
+#include "tspMetricsMonitor.h"
+#include "tspBranchExecutor.h"
+#include "tspFanOut.h"
 #include "tsAsyncReport.h"
 #include "tsSystemMonitor.h"
 #include "tsMonotonic.h"
@@ -138,6 +143,26 @@ int main (int argc, char *argv[])
         p->ringInsertBefore(output);
     }
 
+    // Load the additional input plugins which are merged with the main input.
+
+    ts::tsp::InputMerger merger(&opt, input, global_mutex);
+    if (merger.active()) {
+        input->setMerger(&merger);
+    }
+
+    // Load the plugins of all branches. The fan-out receives the packets from
+    // the output plugin and passes them to the input when all branches are done.
+
+    ts::tsp::FanOut fanout(input);
+    std::vector<ts::tsp::BranchExecutor*> branches;
+    for (size_t i = 0; i < opt.branches.size(); ++i) {
+        branches.push_back(new ts::tsp::BranchExecutor(&opt, &opt.branches[i], i + 1, fanout, global_mutex));
+        fanout.addBranch(branches.back());
+    }
+    if (!branches.empty()) {
+        output->setFanOut(&fanout);
+    }
+
     // Exit on error when initializing the plugins
 
     opt.exitOnError();
@@ -146,25 +171,96 @@ int main (int argc, char *argv[])
     // context. Set this logger as report method for all executors.
 
     ts::AsyncReport report(opt.verbose, opt.debug, opt.timed_log);
+    report.setRateLimit(opt.log_rate_limit);
 
     ts::tsp::PluginExecutor* proc = input;
     do {
         proc->setReport(&report);
         proc->setDebugLevel(report.debugLevel());
     } while ((proc = proc->ringNext<ts::tsp::PluginExecutor>()) != input);
+    merger.setReport(&report, report.debugLevel());
+    for (size_t i = 0; i < branches.size(); ++i) {
+        branches[i]->setReport(&report, report.debugLevel());
+    }
+
+    // Apply the CPU affinity and real-time scheduling options to all plugin threads.
+    // With --pin-plugins, each thread gets one CPU, in sequence from input to output.
+    // With a real-time policy, the input and output keep their higher priorities.
+
+    ts::ThreadAttributes::CPUSet pin_cpus(opt.cpus);
+    if (pin_cpus.empty()) {
+        for (size_t cpu = 0; cpu < ts::ThreadAttributes::GetCPUCount(); ++cpu) {
+            pin_cpus.insert(cpu);
+        }
+    }
+    ts::ThreadAttributes::CPUSet::const_iterator next_cpu = pin_cpus.begin();
+    proc = input;
+    do {
+        ts::ThreadAttributes attr;
+        proc->getAttributes(attr);
+        if (opt.pin_plugins) {
+            ts::ThreadAttributes::CPUSet cpu;
+            cpu.insert(*next_cpu);
+            attr.setCPUAffinity(cpu);
+            if (++next_cpu == pin_cpus.end()) {
+                next_cpu = pin_cpus.begin();
+            }
+        }
+        else {
+            attr.setCPUAffinity(opt.cpus);
+        }
+        if (opt.rt_policy != ts::ThreadAttributes::DEFAULT_SCHEDULING) {
+            attr.setSchedulingPolicy(opt.rt_policy);
+            attr.setPriority(opt.rt_priority + (proc == input ? 2 : (proc == output ? 1 : 0)));
+        }
+        proc->setAttributes(attr);
+        if (!attr.getCPUAffinity().empty()) {
+            proc->debug("CPU affinity: " + ts::ThreadAttributes::CPUSetToString(attr.getCPUAffinity()));
+        }
+    } while ((proc = proc->ringNext<ts::tsp::PluginExecutor>()) != input);
 
-    // Allocate a memory-resident buffer of TS packets
+    // Branch threads are not pinned, they run on all allowed CPU's.
 
-    ts::ResidentBuffer<ts::TSPacket> packet_buffer(opt.bufsize / ts::PKT_SIZE);
+    for (size_t i = 0; i < branches.size(); ++i) {
+        ts::ThreadAttributes attr;
+        branches[i]->getAttributes(attr);
+        attr.setCPUAffinity(opt.cpus);
+        branches[i]->setAttributes(attr);
+    }
+
+    // Allocate a memory-resident buffer of TS packets.
+    // With a NUMA node, allocate it from a CPU of this node. The memory pages
+    // are physically allocated on the node of the CPU which touches them first.
+
+    ts::ThreadAttributes::CPUSet main_cpus;
+    const bool numa_alloc = opt.numa_node >= 0 && ts::Thread::GetCurrentThreadAffinity(main_cpus) && ts::Thread::SetCurrentThreadAffinity(opt.cpus);
+    if (opt.numa_node >= 0 && !numa_alloc) {
+        report.warning(ts::Format("tsp: cannot allocate the buffer on NUMA node %d", opt.numa_node));
+    }
+
+    // All pages are pre-faulted, even if locking fails, to avoid page faults when the stream starts.
+
+    ts::ResidentBuffer<ts::TSPacket> packet_buffer(opt.bufsize / ts::PKT_SIZE, opt.page_mode, true);
+
+    if (numa_alloc) {
+        // Restore the affinity of the main thread.
+        ts::Thread::SetCurrentThreadAffinity(main_cpus);
+        report.debug(ts::Format("tsp: buffer allocated on NUMA node %d", opt.numa_node));
+    }
 
     if (!packet_buffer.isLocked()) {
         report.verbose(ts::Format("tsp: buffer failed to lock into physical memory (%d: ", packet_buffer.lockErrorCode()) +
                        ts::ErrorCodeMessage(packet_buffer.lockErrorCode()) +
                        "), risk of real-time issue");
     }
-    report.debug("tsp: buffer size: " +
-                 ts::Decimal(packet_buffer.count()) + " TS packets, " +
-                 ts::Decimal(packet_buffer.count() * ts::PKT_SIZE) + " bytes");
+    report.verbose("tsp: buffer size: " +
+                   ts::Decimal(packet_buffer.count()) + " TS packets, " +
+                   ts::Decimal(packet_buffer.count() * ts::PKT_SIZE) + " bytes, " +
+                   ts::ResidentBuffer<ts::TSPacket>::PageModeName(packet_buffer.pageMode()) +
+                   (packet_buffer.isPrefaulted() ? ", pre-faulted" : ""));
+    if (packet_buffer.pageMode() != opt.page_mode) {
+        report.verbose("tsp: " + ts::ResidentBuffer<ts::TSPacket>::PageModeName(opt.page_mode) + " not available");
+    }
 
     // Start all processors, except output, in reverse order (input last).
     // Exit application in case of error.
@@ -175,6 +271,22 @@ int main (int argc, char *argv[])
         }
     }
 
+    // Start the merged input plugins and their reader threads, after the main input.
+    // Exit application in case of error.
+
+    if (!merger.start()) {
+        return EXIT_FAILURE;
+    }
+
+    // Timestamp the packets at input and output to measure the latency.
+
+    ts::tsp::LatencyMeter latency;
+    if (opt.measure_latency) {
+        latency.init(packet_buffer.count());
+        input->setLatencyMeter(&latency);
+        output->setLatencyMeter(&latency);
+    }
+
     // Initialize packet buffer in the ring of executors.
     // Exit application in case of error.
 
@@ -182,6 +294,10 @@ int main (int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
+    // The output area, and consequently the fan-out area, starts at the beginning of the buffer.
+
+    fanout.initBuffer(&packet_buffer, 0);
+
     // Start the output device (we now have an idea of the bitrate).
     // Exit application in case of error.
 
@@ -189,6 +305,14 @@ int main (int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
+    // Start the plugins in all branches.
+
+    for (size_t i = 0; i < branches.size(); ++i) {
+        if (!branches[i]->startPlugins()) {
+            return EXIT_FAILURE;
+        }
+    }
+
     // Use a Ctrl+C interrupt handler
 
     ts::tsp::TSPInterruptHandler interrupt_handler(&report, input);
@@ -201,13 +325,39 @@ int main (int argc, char *argv[])
         monitor.start();
     }
 
+    // Create a plugin metrics thread if required.
+
+    ts::tsp::MetricsMonitor metrics(opt, input, packet_buffer.count(), report);
+    if (!opt.metrics_file.empty() || !opt.metrics_udp.empty()) {
+        if (!metrics.open()) {
+            return EXIT_FAILURE;
+        }
+        metrics.start();
+    }
+
     // Create all plugin executors threads.
 
     proc = input;
     do {
-        proc->start();
+        if (!proc->start() && opt.rt_policy != ts::ThreadAttributes::DEFAULT_SCHEDULING) {
+            // Real-time scheduling usually requires privileges, fallback to the default policy.
+            proc->warning("cannot start thread with real-time scheduling, using default policy");
+            ts::ThreadAttributes attr;
+            proc->getAttributes(attr);
+            attr.setSchedulingPolicy(ts::ThreadAttributes::DEFAULT_SCHEDULING);
+            attr.setPriority(proc == input ? ts::ThreadAttributes::GetMaximumPriority() :
+                             (proc == output ? ts::ThreadAttributes::GetHighPriority() : ts::ThreadAttributes::GetNormalPriority()));
+            proc->setAttributes(attr);
+            proc->start();
+        }
     } while ((proc = proc->ringNext<ts::tsp::PluginExecutor>()) != input);
 
+    // Create all branch threads.
+
+    for (size_t i = 0; i < branches.size(); ++i) {
+        branches[i]->start();
+    }
+
     // Wait for threads to terminate
 
     proc = input;
@@ -215,6 +365,21 @@ int main (int argc, char *argv[])
         proc->waitForTermination();
     } while ((proc = proc->ringNext<ts::tsp::PluginExecutor>()) != input);
 
+    // Wait for branches to terminate and deallocate them.
+
+    for (size_t i = 0; i < branches.size(); ++i) {
+        delete branches[i];
+    }
+    branches.clear();
+
+    // Write the last plugin metrics, before deleting the plugin executors.
+
+    metrics.stop();
+
+    if (opt.measure_latency) {
+        latency.report(report);
+    }
+
     // Deallocate all plugins and plugin executor
 
     bool last;
@@ -0,0 +1,318 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Transport stream processor: Execution context of a branch
+//
+//----------------------------------------------------------------------------
+
+#include "tspBranchExecutor.h"
+#include "tsGuardCondition.h"
+#include "tsGuard.h"
+#include "tsDecimal.h"
+#include "tsFormat.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+const size_t ts::tsp::BranchExecutor::MAX_BATCH_PACKETS;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructor and destructor
+//----------------------------------------------------------------------------
+
+ts::tsp::BranchExecutor::BranchExecutor(Options* options,
+                                        const Options::BranchOptions* br_options,
+                                        size_t index,
+                                        FanOut& fanout,
+                                        Mutex& global_mutex) :
+    Thread(),
+    _fanout(fanout),
+    _global_mutex(global_mutex),
+    _to_do(),
+    _index(index),
+    _max_lag(br_options->max_lag),
+    _processors(),
+    _output(0),
+    _batch(),
+    _position(0),
+    _attached(true)
+{
+    // Load all plugins of the branch. Their threads are never started.
+    for (Options::PluginOptionsVector::const_iterator it = br_options->plugins.begin(); it != br_options->plugins.end(); ++it) {
+        _processors.push_back(new ProcessorExecutor(options, &*it, ThreadAttributes(), global_mutex));
+    }
+    _output = new OutputExecutor(options, &br_options->output, ThreadAttributes(), global_mutex);
+
+    if (!_processors.empty()) {
+        _batch.reserve(MAX_BATCH_PACKETS);
+    }
+
+    // The branch thread needs the largest stack of all plugins.
+    ThreadAttributes attr;
+    ThreadAttributes plugin_attr;
+    _output->getAttributes(plugin_attr);
+    size_t stack_size = plugin_attr.getStackSize();
+    for (ProcessorVector::const_iterator it = _processors.begin(); it != _processors.end(); ++it) {
+        (*it)->getAttributes(plugin_attr);
+        stack_size = std::max(stack_size, plugin_attr.getStackSize());
+    }
+    getAttributes(attr);
+    attr.setStackSize(stack_size);
+    setAttributes(attr);
+}
+
+ts::tsp::BranchExecutor::~BranchExecutor()
+{
+    waitForTermination();
+
+    for (ProcessorVector::const_iterator it = _processors.begin(); it != _processors.end(); ++it) {
+        delete *it;
+    }
+    _processors.clear();
+    delete _output;
+    _output = 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Initialization, before starting the thread.
+//----------------------------------------------------------------------------
+
+void ts::tsp::BranchExecutor::setReport(ReportInterface* rep, int debug_level)
+{
+    for (ProcessorVector::const_iterator it = _processors.begin(); it != _processors.end(); ++it) {
+        (*it)->setReport(rep);
+        (*it)->setDebugLevel(debug_level);
+    }
+    _output->setReport(rep);
+    _output->setDebugLevel(debug_level);
+}
+
+bool ts::tsp::BranchExecutor::startPlugins()
+{
+    for (ProcessorVector::const_iterator it = _processors.begin(); it != _processors.end(); ++it) {
+        if (!(*it)->plugin()->start()) {
+            return false;
+        }
+    }
+    return _output->plugin()->start();
+}
+
+
+//----------------------------------------------------------------------------
+// Branch thread
+//----------------------------------------------------------------------------
+
+void ts::tsp::BranchExecutor::main()
+{
+    _output->debug(Format("branch %" FMT_SIZE_T "u thread started", _index));
+
+    PacketCounter processed_packets = 0;
+    PacketCounter skipped_packets = 0;
+    bool aborted = false;
+
+    while (!aborted) {
+
+        const TSPacket* pkt = 0;
+        size_t count = 0;
+        BitRate bitrate = 0;
+
+        // Wait for packets to process.
+        {
+            GuardCondition lock(_global_mutex, _to_do);
+
+            while (_position == _fanout.received() && !_fanout.inputEnd()) {
+                lock.waitCondition();
+            }
+
+            // Exit thread if no more packet to process or main output aborted.
+            aborted = _fanout.aborted();
+            if (aborted || _position == _fanout.received()) {
+                break;
+            }
+
+            // When this branch lags too much, skip the oldest packets.
+            const PacketCounter lag = _fanout.received() - _position;
+            if (_max_lag > 0 && lag > _max_lag) {
+                skipped_packets += lag - _max_lag;
+                _position += lag - _max_lag;
+                _fanout.releasePackets();
+            }
+
+            // Process a contiguous range of packets. With a maximum lag, do not
+            // hold more than this number of packets during the processing.
+            const size_t first = _fanout.bufferIndex(_position);
+            count = size_t(std::min<PacketCounter>(_fanout.received() - _position, _fanout.buffer()->count() - first));
+            if (_max_lag > 0) {
+                count = std::min(count, _max_lag);
+            }
+            pkt = _fanout.buffer()->base() + first;
+            bitrate = _fanout.bitrate();
+        }
+
+        // Process the packets without holding the mutex.
+        aborted = !processPackets(pkt, count, bitrate);
+        processed_packets += count;
+
+        // Release the packets.
+        {
+            Guard lock(_global_mutex);
+            _position += count;
+            _fanout.releasePackets();
+        }
+    }
+
+    // The fan-out no longer waits for this branch.
+    {
+        Guard lock(_global_mutex);
+        _attached = false;
+        _fanout.releasePackets();
+    }
+
+    // Close all plugins of the branch.
+    for (ProcessorVector::const_iterator it = _processors.begin(); it != _processors.end(); ++it) {
+        (*it)->_tsp_aborting = aborted;
+        (*it)->plugin()->stop();
+    }
+    _output->_tsp_aborting = aborted;
+    _output->plugin()->stop();
+
+    _output->debug(Format("branch %" FMT_SIZE_T "u thread %s after ", _index, aborted ? "aborted" : "terminated") +
+                   Decimal(processed_packets) + " packets, " + Decimal(skipped_packets) + " skipped");
+    if (skipped_packets > 0) {
+        _output->verbose(Format("branch %" FMT_SIZE_T "u was too slow, skipped ", _index) + Decimal(skipped_packets) + " packets");
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Process packets from the global buffer.
+//----------------------------------------------------------------------------
+
+bool ts::tsp::BranchExecutor::processPackets(const TSPacket* pkt, size_t count, BitRate bitrate)
+{
+    // Notify the expired timers of all plugins in the branch, one clock read per batch.
+    const MilliSecond now = PluginExecutor::MetricsClock() / NanoSecPerMilliSec;
+    for (ProcessorVector::const_iterator it = _processors.begin(); it != _processors.end(); ++it) {
+        (*it)->_tsp_timers.advance(now);
+    }
+    _output->_tsp_timers.advance(now);
+
+    // Without packet processor, send the packets from the global buffer.
+    if (_processors.empty()) {
+        _output->_tsp_bitrate = bitrate;
+        return sendPackets(pkt, count);
+    }
+
+    // The packet processors may modify the packets, work on a private copy.
+    while (count > 0) {
+
+        const size_t batch_count = std::min(count, MAX_BATCH_PACKETS);
+        size_t end = batch_count;  // number of packets before a TSP_END
+        bool terminate = false;
+
+        _batch.assign(pkt, pkt + batch_count);
+
+        for (ProcessorVector::const_iterator it = _processors.begin(); it != _processors.end(); ++it) {
+            ProcessorPlugin* const proc = (*it)->plugin();
+            (*it)->_tsp_bitrate = bitrate;
+
+            for (size_t i = 0; i < end; ++i) {
+                // Skip packets which were dropped by a previous packet processor.
+                if (_batch[i].b[0] == 0) {
+                    continue;
+                }
+                bool flush = false;
+                bool bitrate_changed = false;
+                switch (proc->processPacket(_batch[i], flush, bitrate_changed)) {
+                    case ProcessorPlugin::TSP_OK:
+                        break;
+                    case ProcessorPlugin::TSP_NULL:
+                        _batch[i] = NullPacket;
+                        break;
+                    case ProcessorPlugin::TSP_DROP:
+                        _batch[i].b[0] = 0;
+                        break;
+                    case ProcessorPlugin::TSP_END:
+                        // This packet and all subsequent ones are not passed.
+                        end = i;
+                        terminate = true;
+                        break;
+                    default:
+                        (*it)->error("invalid packet processing status");
+                        break;
+                }
+                if (bitrate_changed && proc->getBitrate() != 0) {
+                    bitrate = proc->getBitrate();
+                }
+            }
+        }
+
+        _output->_tsp_bitrate = bitrate;
+        if (!sendPackets(&_batch[0], end) || terminate) {
+            return false;
+        }
+
+        pkt += batch_count;
+        count -= batch_count;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Send non-dropped packets to the output plugin.
+//----------------------------------------------------------------------------
+
+bool ts::tsp::BranchExecutor::sendPackets(const TSPacket* pkt, size_t count)
+{
+    while (count > 0) {
+
+        // Skip dropped packets
+        size_t drop_cnt;
+        for (drop_cnt = 0; drop_cnt < count && pkt[drop_cnt].b[0] == 0; drop_cnt++) {}
+        pkt += drop_cnt;
+        count -= drop_cnt;
+
+        // Find last non-dropped packet
+        size_t out_cnt;
+        for (out_cnt = 0; out_cnt < count && pkt[out_cnt].b[0] != 0; out_cnt++) {}
+
+        // Output a contiguous range of non-dropped packets.
+        if (out_cnt > 0) {
+            if (!_output->plugin()->send(pkt, out_cnt)) {
+                return false;
+            }
+            pkt += out_cnt;
+            count -= out_cnt;
+        }
+    }
+    return true;
+}
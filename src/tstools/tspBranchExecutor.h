@@ -0,0 +1,156 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Transport stream processor: Execution context of a branch
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tspFanOut.h"
+#include "tspProcessorExecutor.h"
+#include "tspOutputExecutor.h"
+
+namespace ts {
+    namespace tsp {
+        //!
+        //! Execution context of a tsp branch.
+        //!
+        //! A branch is a sequence of packet processor plugins, ending with an output plugin.
+        //! All plugins of a branch are executed in one single thread, the branch thread.
+        //! The plugin executors of the branch are used as execution contexts for the
+        //! plugins but their threads are never started.
+        //!
+        //! The branch reads the packets from the fan-out area of the global packet buffer.
+        //! When the branch has no packet processor, the packets are directly sent from the
+        //! global buffer. Otherwise, the packets are first copied into a private buffer
+        //! since the processors may modify them.
+        //!
+        class BranchExecutor: public Thread
+        {
+        public:
+            //!
+            //! Constructor.
+            //! @param [in,out] options Command line options for tsp.
+            //! @param [in] br_options Command line options for this branch.
+            //! @param [in] index Index of this branch, for messages.
+            //! @param [in,out] fanout Fan-out from where the packets are read.
+            //! @param [in,out] global_mutex Global mutex to synchronize access to the packet buffer.
+            //!
+            BranchExecutor(Options* options,
+                           const Options::BranchOptions* br_options,
+                           size_t index,
+                           FanOut& fanout,
+                           Mutex& global_mutex);
+
+            //!
+            //! Destructor.
+            //! Wait for the termination of the thread and deallocate all plugins.
+            //!
+            virtual ~BranchExecutor();
+
+            //!
+            //! Change the report method of all plugins in the branch.
+            //! @param [in] rep Address of new report instance.
+            //! @param [in] debug_level Debug level of the plugins.
+            //!
+            void setReport(ReportInterface* rep, int debug_level);
+
+            //!
+            //! Start all plugins of the branch.
+            //! Must be executed in synchronous environment, before starting the thread.
+            //! @return True on success, false on error.
+            //!
+            bool startPlugins();
+
+            //!
+            //! Get the position of the next packet to process.
+            //! Must be called under the protection of the global mutex.
+            //! @return The absolute position of the next packet to process in the stream.
+            //!
+            PacketCounter position() const
+            {
+                return _position;
+            }
+
+            //!
+            //! Check if the branch still processes packets.
+            //! Must be called under the protection of the global mutex.
+            //! @return True if the branch still processes packets.
+            //!
+            bool attached() const
+            {
+                return _attached;
+            }
+
+            //!
+            //! Notify the branch thread that something changed in the fan-out.
+            //! Must be called under the protection of the global mutex.
+            //!
+            void wakeUp()
+            {
+                _to_do.signal();
+            }
+
+        private:
+            // Maximum number of packets in the private buffer.
+            static const size_t MAX_BATCH_PACKETS = 1024;
+
+            typedef std::vector<ProcessorExecutor*> ProcessorVector;
+
+            FanOut&         _fanout;
+            Mutex&          _global_mutex;
+            Condition       _to_do;        // Notify the branch that something changed in the fan-out.
+            const size_t    _index;        // Branch index.
+            const size_t    _max_lag;      // Maximum lag in packets before skipping packets.
+            ProcessorVector _processors;   // Packet processors.
+            OutputExecutor* _output;       // Output plugin.
+            std::vector<TSPacket> _batch;  // Private copy of packets for the processors.
+
+            // The following private data must be accessed exclusively under the
+            // protection of the global mutex.
+            PacketCounter   _position;     // Position of next packet to process.
+            bool            _attached;     // The branch still processes packets.
+
+            // Process packets from the global buffer. Return false on error or end of branch.
+            bool processPackets(const TSPacket* pkt, size_t count, BitRate bitrate);
+
+            // Send non-dropped packets to the output plugin. Return false on error.
+            bool sendPackets(const TSPacket* pkt, size_t count);
+
+            // Inherited from Thread
+            virtual void main() override;
+
+            // Inaccessible operations
+            BranchExecutor() = delete;
+            BranchExecutor(const BranchExecutor&) = delete;
+            BranchExecutor& operator=(const BranchExecutor&) = delete;
+        };
+    }
+}
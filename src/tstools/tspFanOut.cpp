@@ -0,0 +1,126 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Transport stream processor: Fan-out of the output packets to branches
+//
+//----------------------------------------------------------------------------
+
+#include "tspFanOut.h"
+#include "tspBranchExecutor.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------
+
+ts::tsp::FanOut::FanOut(PluginExecutor* input) :
+    _input(input),
+    _buffer(0),
+    _branches(),
+    _pkt_first(0),
+    _received(0),
+    _released(0),
+    _bitrate(0),
+    _input_end(false),
+    _aborted(false)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Initialization, before starting the threads.
+//----------------------------------------------------------------------------
+
+void ts::tsp::FanOut::addBranch(BranchExecutor* branch)
+{
+    _branches.push_back(branch);
+}
+
+void ts::tsp::FanOut::initBuffer(PluginExecutor::PacketBuffer* buffer, size_t pkt_first)
+{
+    _buffer = buffer;
+    _pkt_first = pkt_first;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the index of a packet in the buffer.
+//----------------------------------------------------------------------------
+
+size_t ts::tsp::FanOut::bufferIndex(PacketCounter position) const
+{
+    assert(position >= _released);
+    assert(position <= _received);
+    return size_t((_pkt_first + (position - _released)) % _buffer->count());
+}
+
+
+//----------------------------------------------------------------------------
+// Receive packets from the output executor.
+//----------------------------------------------------------------------------
+
+void ts::tsp::FanOut::receivePackets(size_t count, BitRate bitrate, bool input_end, bool aborted)
+{
+    _received += count;
+    _bitrate = bitrate;
+    _input_end = _input_end || input_end || aborted;
+    _aborted = _aborted || aborted;
+
+    // Wake up all branches.
+    for (size_t i = 0; i < _branches.size(); ++i) {
+        _branches[i]->wakeUp();
+    }
+
+    // Without active branch, the packets are immediately released.
+    releasePackets();
+}
+
+
+//----------------------------------------------------------------------------
+// Pass to the input executor all packets which are no longer used.
+//----------------------------------------------------------------------------
+
+void ts::tsp::FanOut::releasePackets()
+{
+    // Find the oldest packet which is still used by a branch.
+    PacketCounter oldest = _received;
+    for (size_t i = 0; i < _branches.size(); ++i) {
+        if (_branches[i]->attached()) {
+            oldest = std::min(oldest, _branches[i]->position());
+        }
+    }
+
+    if (oldest > _released) {
+        const size_t count = size_t(oldest - _released);
+        _released = oldest;
+        _pkt_first = (_pkt_first + count) % _buffer->count();
+        _input->receivePackets(count, 0, false);
+    }
+}
@@ -0,0 +1,175 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Transport stream processor: Fan-out of the output packets to branches
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tspPluginExecutor.h"
+
+namespace ts {
+    namespace tsp {
+
+        class BranchExecutor;
+
+        //!
+        //! Fan-out of the packets from the main output plugin to several branches.
+        //!
+        //! The fan-out owns the area of the packet buffer between the output executor
+        //! and the input executor. It receives the packets which were processed by the
+        //! output plugin. All branches read these packets in parallel, directly from the
+        //! packet buffer, each one with its own position. The packets are passed to the
+        //! input executor, for reuse, when all branches have processed them. Branches
+        //! with a maximum lag skip packets instead of holding the buffer too long.
+        //!
+        //! Positions are absolute packet counters, from the beginning of the stream,
+        //! to avoid ambiguities between empty and full areas in the circular buffer.
+        //!
+        //! Unless specified otherwise, all methods must be called under the protection
+        //! of the global mutex.
+        //!
+        class FanOut
+        {
+        public:
+            //!
+            //! Constructor.
+            //! @param [in,out] input The input executor which receives the released packets.
+            //!
+            FanOut(PluginExecutor* input);
+
+            //!
+            //! Add a branch.
+            //! Must be executed in synchronous environment, before starting all executor threads.
+            //! @param [in] branch The branch to add.
+            //!
+            void addBranch(BranchExecutor* branch);
+
+            //!
+            //! Set the initial state of the buffer.
+            //! Must be executed in synchronous environment, before starting all executor threads.
+            //! @param [in] buffer Address of the packet buffer.
+            //! @param [in] pkt_first Index of the first packet which will be received.
+            //!
+            void initBuffer(PluginExecutor::PacketBuffer* buffer, size_t pkt_first);
+
+            //!
+            //! Receive packets from the output executor.
+            //! @param [in] count Number of packets, following the previous ones in the buffer.
+            //! @param [in] bitrate Current bitrate of the stream.
+            //! @param [in] input_end If true, no more packet will be received.
+            //! @param [in] aborted If true, the main output has aborted, the branches shall stop immediately.
+            //!
+            void receivePackets(size_t count, BitRate bitrate, bool input_end, bool aborted);
+
+            //!
+            //! Pass to the input executor all packets which are no longer used by any branch.
+            //!
+            void releasePackets();
+
+            //!
+            //! Get the total number of received packets.
+            //! @return The total number of received packets, ie. the position after the last one.
+            //!
+            PacketCounter received() const
+            {
+                return _received;
+            }
+
+            //!
+            //! Get the total number of released packets.
+            //! @return The total number of released packets, ie. the position of the oldest unreleased one.
+            //!
+            PacketCounter released() const
+            {
+                return _released;
+            }
+
+            //!
+            //! Get the index of a packet in the buffer.
+            //! @param [in] position Position of a packet which is not yet released.
+            //! @return Index of the packet in the buffer.
+            //!
+            size_t bufferIndex(PacketCounter position) const;
+
+            //!
+            //! Get the packet buffer.
+            //! @return Address of the packet buffer.
+            //!
+            PluginExecutor::PacketBuffer* buffer() const
+            {
+                return _buffer;
+            }
+
+            //!
+            //! Get the current bitrate.
+            //! @return The current bitrate of the stream.
+            //!
+            BitRate bitrate() const
+            {
+                return _bitrate;
+            }
+
+            //!
+            //! Check if no more packet will be received.
+            //! @return True if no more packet will be received.
+            //!
+            bool inputEnd() const
+            {
+                return _input_end;
+            }
+
+            //!
+            //! Check if the main output has aborted.
+            //! @return True if the main output has aborted.
+            //!
+            bool aborted() const
+            {
+                return _aborted;
+            }
+
+        private:
+            PluginExecutor*               _input;      // Receives the released packets.
+            PluginExecutor::PacketBuffer* _buffer;     // Packet buffer.
+            std::vector<BranchExecutor*>  _branches;   // All branches.
+            size_t                        _pkt_first;  // Index of oldest unreleased packet.
+            PacketCounter                 _received;   // Total received packets.
+            PacketCounter                 _released;   // Total released packets.
+            BitRate                       _bitrate;    // Current bitrate.
+            bool                          _input_end;  // No more packet to receive.
+            bool                          _aborted;    // Main output aborted.
+
+            // Inaccessible operations.
+            FanOut() = delete;
+            FanOut(const FanOut&) = delete;
+            FanOut& operator=(const FanOut&) = delete;
+        };
+    }
+}
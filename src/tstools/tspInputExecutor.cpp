@@ -32,6 +32,8 @@
 //----------------------------------------------------------------------------
 
 #include "tspInputExecutor.h"
+#include "tspInputMerger.h"
+#include "tspLatencyMeter.h"
 #include "tsPCRAnalyzer.h"
 #include "tsDecimal.h"
 #include "tsHexa.h"
@@ -51,6 +53,7 @@ ts::tsp::InputExecutor::InputExecutor(Options* options,
 
     PluginExecutor(options, pl_options, attributes, global_mutex),
     _input(dynamic_cast<InputPlugin*>(_shlib)),
+    _merger(0),
     _instuff_nullpkt(options->instuff_nullpkt),
     _instuff_inpkt(options->instuff_inpkt),
     _input_bitrate(options->bitrate),
@@ -85,6 +88,10 @@ bool ts::tsp::InputExecutor::initAllBuffers(PacketBuffer* buffer)
 
     debug("initial buffer load: " + Decimal(pkt_read) + " packets, " + Decimal(pkt_read * PKT_SIZE) + " bytes");
 
+    if (_latency != 0) {
+        _latency->receivedPackets(0, pkt_read, MetricsClock());
+    }
+
     // Try to evaluate the initial input bitrate.
     // First, ask the plugin to evaluate its bitrate.
     BitRate init_bitrate = getBitrate();
@@ -104,9 +111,7 @@ bool ts::tsp::InputExecutor::initAllBuffers(PacketBuffer* buffer)
         // buffer, do not stop when bitrate is supposedly known.
         PCRAnalyzer zer;
         zer.resetAndUseDTS(1, 32); // 1 PID, 32 DTS
-        for (size_t p = 0; p < pkt_read; p++) {
-            zer.feedPacket(buffer->base()[p]);
-        }
+        zer.feedPackets(buffer->base(), pkt_read);
         if (zer.bitrateIsValid()) {
             init_bitrate = zer.bitrate188();
         }
@@ -121,6 +126,7 @@ bool ts::tsp::InputExecutor::initAllBuffers(PacketBuffer* buffer)
     // Indicate that the loaded packets are now available to the next packet processor.
     PluginExecutor* next = ringNext<PluginExecutor>();
     next->initBuffer(buffer, 0, pkt_read, pkt_read == 0, pkt_read == 0, init_bitrate);
+    addInitialPackets(pkt_read);
 
     // The rest of the buffer belongs to this input processor for reading
     // additional packets. All other processors have an implicit empty buffer
@@ -143,8 +149,8 @@ bool ts::tsp::InputExecutor::initAllBuffers(PacketBuffer* buffer)
 
 ts::BitRate ts::tsp::InputExecutor::getBitrate()
 {
-    // Get bitrate from plugin
-    BitRate bitrate = _input_bitrate > 0 ? _input_bitrate : _input->getBitrate();
+    // Get bitrate from plugin or from all merged plugins
+    BitRate bitrate = _input_bitrate > 0 ? _input_bitrate : (_merger != 0 ? _merger->getBitrate() : _input->getBitrate());
 
     // Adjust to input stuffing
     if (bitrate == 0 || _instuff_inpkt == 0) {
@@ -168,8 +174,8 @@ size_t ts::tsp::InputExecutor::receiveAndValidate(TSPacket* buffer, size_t max_p
         return 0;
     }
 
-    // Invoke the plugin receive method
-    size_t count = _input->receive(buffer, max_packets);
+    // Invoke the plugin receive method, or get the merged packets from all plugins
+    size_t count = _merger != 0 ? _merger->receive(buffer, max_packets) : _input->receive(buffer, max_packets);
 
     // Validate sync byte (0x47) at beginning of each packet
     for (size_t n = 0; n < count; ++n) {
@@ -306,10 +312,22 @@ void ts::tsp::InputExecutor::main()
             pkt_max = _max_input_pkt;
         }
 
+        // In low-latency mode, read smaller batches when the input is not loaded.
+
+        pkt_max = batchSize(pkt_max);
+
         // Now read at most the specified number of packets
 
         size_t pkt_read = receiveAndStuff(_buffer->base() + pkt_first, pkt_max);
 
+        // A full batch means that the input plugin has more packets immediately available.
+
+        adaptBatchSize(pkt_read >= pkt_max);
+
+        if (_latency != 0 && pkt_read > 0) {
+            _latency->receivedPackets(pkt_first, pkt_read, MetricsClock());
+        }
+
         if (pkt_read == 0) {
             input_end = true;
         }
@@ -337,9 +355,14 @@ void ts::tsp::InputExecutor::main()
 
     } while (!input_end);
 
-    // Close the input processor
+    // Close the input processor, or all merged input processors
 
-    _input->stop();
+    if (_merger != 0) {
+        _merger->stop();
+    }
+    else {
+        _input->stop();
+    }
 
     std::string status(aborted ? "aborted" : "terminated");
     debug("input thread " + status + " after " + Decimal(totalPackets()) + " packets");
@@ -37,6 +37,9 @@
 
 namespace ts {
     namespace tsp {
+
+        class InputMerger;
+
         //!
         //! Execution context of a tsp input plugin.
         //!
@@ -69,8 +72,20 @@ namespace ts {
             //!
             bool initAllBuffers(PacketBuffer* buffer);
 
+            //!
+            //! Set a merger of several input plugins.
+            //! When set, the packets are received from the merger instead of the input plugin.
+            //! Must be executed before initAllBuffers().
+            //! @param [in] merger Merger of the input plugins. Zero means none.
+            //!
+            void setMerger(InputMerger* merger)
+            {
+                _merger = merger;
+            }
+
         private:
             InputPlugin*      _input;             // Plugin API
+            InputMerger*      _merger;            // Merger of several input plugins, if any
             const size_t      _instuff_nullpkt;   // Add input stuffing: add nullpkt null...
             const size_t      _instuff_inpkt;     // ... packets every inpkt input packets
             const BitRate     _input_bitrate;     // User-specified fixed input bitrate
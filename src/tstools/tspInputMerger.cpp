@@ -0,0 +1,462 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Transport stream processor: Merging of several input plugins
+//
+//----------------------------------------------------------------------------
+
+#include "tspInputMerger.h"
+#include "tsGuardCondition.h"
+#include "tsGuard.h"
+#include "tsDecimal.h"
+#include "tsFormat.h"
+#include "tsTime.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+const size_t ts::tsp::InputMerger::READ_PACKETS;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructor and destructor
+//----------------------------------------------------------------------------
+
+ts::tsp::InputMerger::InputMerger(Options* options, InputExecutor* main_input, Mutex& global_mutex) :
+    _main(main_input),
+    _policy(options->merge_policy),
+    _timeout(options->merge_timeout * NanoSecPerMilliSec),
+    _bitrate_adj(options->bitrate_adj),
+    _inputs(),
+    _readers(),
+    _mutex(),
+    _data(),
+    _started(false),
+    _terminate(false),
+    _current(0),
+    _switches(0),
+    _pid_inputs(_policy == Options::MERGE_INTERLEAVE ? PID_MAX : 0, 0),
+    _pid_conflicts()
+{
+    // Load all additional input plugins. Their executor threads are never started.
+    for (Options::PluginOptionsVector::const_iterator it = options->merged_inputs.begin(); it != options->merged_inputs.end(); ++it) {
+        _inputs.push_back(new InputExecutor(options, &*it, ThreadAttributes(), global_mutex));
+    }
+
+    // Create one reader thread per input, including the main input, when there is something to merge.
+    // The readers have the same priority as the input thread, to avoid missing packets.
+    if (!_inputs.empty()) {
+        _readers.push_back(new Reader(*this, _main, 1));
+        for (size_t i = 0; i < _inputs.size(); ++i) {
+            _readers.push_back(new Reader(*this, _inputs[i], i + 2));
+        }
+        for (ReaderVector::const_iterator it = _readers.begin(); it != _readers.end(); ++it) {
+            ThreadAttributes attr;
+            (*it)->_executor->getAttributes(attr);
+            attr.setPriority(ThreadAttributes::GetMaximumPriority());
+            attr.setCPUAffinity(options->cpus);
+            (*it)->setAttributes(attr);
+            (*it)->_queue.resize(std::max<size_t>(options->merge_queue_size, READ_PACKETS));
+        }
+    }
+}
+
+ts::tsp::InputMerger::~InputMerger()
+{
+    stop();
+
+    for (ReaderVector::const_iterator it = _readers.begin(); it != _readers.end(); ++it) {
+        delete *it;
+    }
+    _readers.clear();
+    for (std::vector<InputExecutor*>::const_iterator it = _inputs.begin(); it != _inputs.end(); ++it) {
+        delete *it;
+    }
+    _inputs.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Initialization, before starting the executor threads.
+//----------------------------------------------------------------------------
+
+void ts::tsp::InputMerger::setReport(ReportInterface* rep, int debug_level)
+{
+    for (std::vector<InputExecutor*>::const_iterator it = _inputs.begin(); it != _inputs.end(); ++it) {
+        (*it)->setReport(rep);
+        (*it)->setDebugLevel(debug_level);
+    }
+}
+
+bool ts::tsp::InputMerger::start()
+{
+    for (std::vector<InputExecutor*>::const_iterator it = _inputs.begin(); it != _inputs.end(); ++it) {
+        if (!(*it)->plugin()->start()) {
+            return false;
+        }
+    }
+
+    // All inputs are initially considered as active.
+    const NanoSecond now = PluginExecutor::MetricsClock();
+    for (ReaderVector::const_iterator it = _readers.begin(); it != _readers.end(); ++it) {
+        (*it)->_last_time = now;
+    }
+    if (!_readers.empty()) {
+        _readers[0]->_selections = 1;
+    }
+
+    for (ReaderVector::const_iterator it = _readers.begin(); it != _readers.end(); ++it) {
+        if (!(*it)->start()) {
+            _main->error("cannot start input reader thread");
+            stop();
+            return false;
+        }
+        _started = true;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Stop all reader threads and report the statistics.
+//----------------------------------------------------------------------------
+
+void ts::tsp::InputMerger::stop()
+{
+    if (!_started) {
+        return;
+    }
+
+    // Wake up all readers which wait for free space in their queue.
+    // A reader which is blocked in its input plugin terminates after the next receive.
+    {
+        Guard lock(_mutex);
+        _terminate = true;
+        for (ReaderVector::const_iterator it = _readers.begin(); it != _readers.end(); ++it) {
+            (*it)->_space.signal();
+        }
+    }
+    for (ReaderVector::const_iterator it = _readers.begin(); it != _readers.end(); ++it) {
+        (*it)->waitForTermination();
+    }
+    _started = false;
+
+    for (ReaderVector::const_iterator it = _readers.begin(); it != _readers.end(); ++it) {
+        const Reader* r = *it;
+        _main->verbose(Format("input %" FMT_SIZE_T "u (%s): ", r->_index, r->_executor->pluginName().c_str()) +
+                       Decimal(r->_received) + " received, " +
+                       Decimal(r->_merged) + " merged, " +
+                       Decimal(r->_discarded) + " discarded packets" +
+                       (_policy == Options::MERGE_FAILOVER ? Format(", selected %" FMT_SIZE_T "u times", r->_selections) : std::string()));
+    }
+    if (_policy == Options::MERGE_FAILOVER) {
+        _main->verbose(Format("%" FMT_SIZE_T "u input switches", _switches));
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Check if a reader is currently merged, under the protection of the mutex.
+//----------------------------------------------------------------------------
+
+bool ts::tsp::InputMerger::isMerged(const Reader* reader) const
+{
+    return _policy == Options::MERGE_INTERLEAVE || _readers[_current] == reader;
+}
+
+
+//----------------------------------------------------------------------------
+// Report PID's which are found in several inputs (interleave).
+//----------------------------------------------------------------------------
+
+void ts::tsp::InputMerger::checkPIDs(const Reader* reader, const TSPacket* packets, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        const PID pid = packets[i].getPID();
+        if (pid == PID_NULL) {
+            // Stuffing is never a conflict.
+            continue;
+        }
+        const size_t first = _pid_inputs[pid];
+        if (first == 0) {
+            _pid_inputs[pid] = reader->_index;
+        }
+        else if (first != reader->_index && !_pid_conflicts.test(pid)) {
+            _pid_conflicts.set(pid);
+            _main->warning(Format("PID 0x%04X (%d) found in inputs %" FMT_SIZE_T "u and %" FMT_SIZE_T "u, PID's are not remapped, the output stream is probably invalid",
+                                  int(pid), int(pid), first, reader->_index));
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Select the input to use with the failover policy.
+//----------------------------------------------------------------------------
+
+void ts::tsp::InputMerger::selectInput()
+{
+    Reader* current = _readers[_current];
+
+    // Keep the current input as long as it has packets or is not timed out.
+    if (current->_count > 0) {
+        return;
+    }
+    const NanoSecond now = PluginExecutor::MetricsClock();
+    if (!current->_ended && now - current->_last_time < _timeout) {
+        return;
+    }
+
+    // Switch to the next input with packets, without reverting to the previous one.
+    for (size_t i = 1; i < _readers.size(); ++i) {
+        const size_t index = (_current + i) % _readers.size();
+        Reader* next = _readers[index];
+        if (next->_count > 0) {
+            if (current->_ended) {
+                _main->info(Format("input %" FMT_SIZE_T "u terminated, switching to input %" FMT_SIZE_T "u", current->_index, next->_index));
+            }
+            else {
+                _main->info(Format("no packet from input %" FMT_SIZE_T "u for ", current->_index) +
+                            Decimal((now - current->_last_time) / NanoSecPerMilliSec) +
+                            Format(" ms, switching to input %" FMT_SIZE_T "u", next->_index));
+            }
+            _current = index;
+            _switches++;
+            next->_selections++;
+            // Wake up the previous input if it waits for space, its queue is no longer read.
+            current->_space.signal();
+            next->_space.signal();
+            return;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Receive merged packets.
+//----------------------------------------------------------------------------
+
+size_t ts::tsp::InputMerger::receive(TSPacket* buffer, size_t max_packets)
+{
+    GuardCondition lock(_mutex, _data);
+
+    for (;;) {
+        size_t count = 0;
+
+        if (_policy == Options::MERGE_FAILOVER) {
+            selectInput();
+            count = _readers[_current]->extract(buffer, max_packets);
+        }
+        else {
+            // Take an equal share from each input, starting at the next one in turn.
+            // Then complete with the remaining packets of any input.
+            const size_t share = std::max<size_t>(1, max_packets / _readers.size());
+            for (size_t i = 0; i < _readers.size() && count < max_packets; ++i) {
+                count += _readers[(_current + i) % _readers.size()]->extract(buffer + count, std::min(share, max_packets - count));
+            }
+            for (size_t i = 0; i < _readers.size() && count < max_packets; ++i) {
+                count += _readers[(_current + i) % _readers.size()]->extract(buffer + count, max_packets - count);
+            }
+            _current = (_current + 1) % _readers.size();
+        }
+
+        if (count > 0) {
+            return count;
+        }
+
+        // Nothing to return, end of input when all inputs are terminated and empty.
+        bool all_ended = true;
+        for (ReaderVector::const_iterator it = _readers.begin(); all_ended && it != _readers.end(); ++it) {
+            all_ended = (*it)->_ended && (*it)->_count == 0;
+        }
+        if (all_ended || _terminate) {
+            return 0;
+        }
+
+        // Wait for packets. With failover, check the timeout of the current input from time to time.
+        lock.waitCondition(_policy == Options::MERGE_FAILOVER ? std::max<MilliSecond>(1, _timeout / NanoSecPerMilliSec / 4) : Infinite);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get the current input bitrate.
+//----------------------------------------------------------------------------
+
+ts::BitRate ts::tsp::InputMerger::getBitrate()
+{
+    Guard lock(_mutex);
+
+    if (_policy == Options::MERGE_FAILOVER) {
+        return _readers[_current]->_bitrate;
+    }
+    else {
+        BitRate bitrate = 0;
+        for (ReaderVector::const_iterator it = _readers.begin(); it != _readers.end(); ++it) {
+            if ((*it)->_ended) {
+                continue;
+            }
+            else if ((*it)->_bitrate == 0) {
+                return 0; // unknown bitrate on one active input
+            }
+            bitrate += (*it)->_bitrate;
+        }
+        return bitrate;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Reader thread constructor and destructor.
+//----------------------------------------------------------------------------
+
+ts::tsp::InputMerger::Reader::Reader(InputMerger& merger, InputExecutor* executor, size_t index) :
+    Thread(),
+    _executor(executor),
+    _index(index),
+    _space(),
+    _queue(),
+    _first(0),
+    _count(0),
+    _ended(false),
+    _last_time(0),
+    _bitrate(0),
+    _received(0),
+    _merged(0),
+    _discarded(0),
+    _selections(0),
+    _merger(merger)
+{
+}
+
+ts::tsp::InputMerger::Reader::~Reader()
+{
+    waitForTermination();
+}
+
+
+//----------------------------------------------------------------------------
+// Extract packets from the queue of a reader, under the protection of the mutex.
+//----------------------------------------------------------------------------
+
+size_t ts::tsp::InputMerger::Reader::extract(TSPacket* buffer, size_t max_packets)
+{
+    size_t count = 0;
+    while (count < max_packets && _count > 0) {
+        const size_t n = std::min(std::min(max_packets - count, _count), _queue.size() - _first);
+        std::copy(&_queue[_first], &_queue[_first] + n, buffer + count);
+        count += n;
+        _count -= n;
+        _first = (_first + n) % _queue.size();
+    }
+    if (count > 0) {
+        _merged += count;
+        _space.signal();
+    }
+    return count;
+}
+
+
+//----------------------------------------------------------------------------
+// Reader thread: receive packets from one input plugin.
+//----------------------------------------------------------------------------
+
+void ts::tsp::InputMerger::Reader::main()
+{
+    _executor->debug(Format("input %" FMT_SIZE_T "u reader thread started", _index));
+
+    InputPlugin* const plugin = dynamic_cast<InputPlugin*>(_executor->plugin());
+    assert(plugin != 0);
+
+    std::vector<TSPacket> batch(READ_PACKETS);
+    Time bitrate_due_time(Time::CurrentUTC() + _merger._bitrate_adj);
+    BitRate bitrate = plugin->getBitrate();
+    bool end = false;
+
+    while (!end) {
+
+        // Receive packets outside the protection of the mutex.
+        const size_t count = plugin->receive(&batch[0], batch.size());
+
+        // Keep only valid packets, stop this input on synchronization loss.
+        size_t valid = 0;
+        while (valid < count && batch[valid].hasValidSync()) {
+            valid++;
+        }
+        if (valid < count) {
+            _executor->error(Format("input %" FMT_SIZE_T "u: synchronization lost after ", _index) + Decimal(_received + valid) +
+                             Format(" packets, got 0x%02X instead of 0x%02X", int(batch[valid].b[0]), int(SYNC_BYTE)));
+        }
+        end = valid < count || count == 0;
+
+        // Periodic bitrate evaluation.
+        const Time current_time(Time::CurrentUTC());
+        if (current_time > bitrate_due_time) {
+            bitrate_due_time = current_time + _merger._bitrate_adj;
+            bitrate = plugin->getBitrate();
+        }
+
+        // Copy the packets into the queue.
+        GuardCondition lock(_merger._mutex, _space);
+        if (valid > 0) {
+            _last_time = PluginExecutor::MetricsClock();
+            _received += valid;
+            if (_merger._policy == Options::MERGE_INTERLEAVE) {
+                _merger.checkPIDs(this, &batch[0], valid);
+            }
+        }
+        _bitrate = bitrate;
+        size_t done = 0;
+        while (done < valid && !_merger._terminate) {
+            if (_count == _queue.size()) {
+                if (_merger.isMerged(this)) {
+                    // Wait for the merger to extract packets.
+                    lock.waitCondition();
+                    continue;
+                }
+                // Not currently merged (backup input), drop the oldest packets.
+                const size_t n = std::min(valid - done, _count);
+                _first = (_first + n) % _queue.size();
+                _count -= n;
+                _discarded += n;
+            }
+            const size_t last = (_first + _count) % _queue.size();
+            const size_t n = std::min(std::min(valid - done, _queue.size() - _count), _queue.size() - last);
+            std::copy(&batch[done], &batch[done] + n, &_queue[last]);
+            _count += n;
+            done += n;
+        }
+        end = end || _merger._terminate;
+        _ended = end;
+        _merger._data.signal();
+    }
+
+    plugin->stop();
+    _executor->debug(Format("input %" FMT_SIZE_T "u reader thread terminated after ", _index) + Decimal(_received) + " packets");
+}
@@ -0,0 +1,190 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Transport stream processor: Merging of several input plugins
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tspInputExecutor.h"
+
+namespace ts {
+    namespace tsp {
+        //!
+        //! Merging of several input plugins in the transport stream processor.
+        //!
+        //! Each input plugin is executed in its own reader thread which fills a private
+        //! queue of packets. The input executor reads the packets from the queues,
+        //! according to the merge policy, instead of calling its plugin.
+        //!
+        //! With the interleave policy, the PID's are neither remapped nor merged.
+        //! A PID which is found in several inputs is reported once.
+        //!
+        //! The main input plugin is executed in the context of the input executor.
+        //! The additional input plugins are executed in the context of input executors
+        //! which are not part of the ring of executors and whose threads are never started.
+        //!
+        class InputMerger
+        {
+        public:
+            //!
+            //! Constructor.
+            //! @param [in,out] options Command line options for tsp.
+            //! @param [in,out] main_input The main input executor, using this merger.
+            //! @param [in,out] global_mutex Global mutex of the executors.
+            //!
+            InputMerger(Options* options, InputExecutor* main_input, Mutex& global_mutex);
+
+            //!
+            //! Destructor.
+            //! Stop the reader threads and deallocate the additional input plugins.
+            //!
+            ~InputMerger();
+
+            //!
+            //! Change the report method of the additional input plugins.
+            //! @param [in] rep Address of new report instance.
+            //! @param [in] debug_level Debug level of the plugins.
+            //!
+            void setReport(ReportInterface* rep, int debug_level);
+
+            //!
+            //! Check if there are additional input plugins to merge.
+            //! @return True if there are additional input plugins.
+            //!
+            bool active() const
+            {
+                return !_inputs.empty();
+            }
+
+            //!
+            //! Start the additional input plugins and all reader threads.
+            //! The main input plugin must have been started first.
+            //! @return True on success, false on error.
+            //!
+            bool start();
+
+            //!
+            //! Stop all reader threads and report the statistics of all inputs.
+            //! Invoked in the thread of the main input executor.
+            //!
+            void stop();
+
+            //!
+            //! Receive merged packets.
+            //! Invoked in the thread of the main input executor.
+            //! @param [out] buffer Address of the buffer for incoming packets.
+            //! @param [in] max_packets Size of @a buffer in number of packets.
+            //! @return The number of actually received packets in @a buffer.
+            //! Returning zero means end of input, on all input plugins.
+            //!
+            size_t receive(TSPacket* buffer, size_t max_packets);
+
+            //!
+            //! Get the current input bitrate.
+            //! With the failover policy, this is the bitrate of the current input. With the
+            //! interleave policy, this is the sum of the bitrates of all active inputs.
+            //! @return Input bitrate in bits/second, zero if unknown.
+            //!
+            BitRate getBitrate();
+
+        private:
+            // Maximum number of packets per receive operation in a reader.
+            static const size_t READ_PACKETS = 1024;
+
+            // Reader thread for one input plugin.
+            class Reader: public Thread
+            {
+            public:
+                Reader(InputMerger& merger, InputExecutor* executor, size_t index);
+                virtual ~Reader();
+
+                InputExecutor* const  _executor;  // Execution context of the plugin.
+                const size_t          _index;     // Input index, for messages.
+                Condition             _space;     // Signaled when there is free space in the queue.
+
+                // The following data are accessed under the protection of the merger mutex.
+                std::vector<TSPacket> _queue;       // Circular queue of packets.
+                size_t                _first;       // Index of first packet in the queue.
+                size_t                _count;       // Number of packets in the queue.
+                bool                  _ended;       // End of input.
+                NanoSecond            _last_time;   // Time of last received packets (metrics clock).
+                BitRate               _bitrate;     // Last evaluated bitrate.
+                PacketCounter         _received;    // Total received packets.
+                PacketCounter         _merged;      // Total packets which were merged.
+                PacketCounter         _discarded;   // Total packets which were discarded from the queue.
+                size_t                _selections;  // Number of times this input was selected (failover).
+
+                // Extract packets from the queue.
+                size_t extract(TSPacket* buffer, size_t max_packets);
+
+            private:
+                InputMerger& _merger;
+                virtual void main() override;
+
+                // Inaccessible operations.
+                Reader() = delete;
+                Reader(const Reader&) = delete;
+                Reader& operator=(const Reader&) = delete;
+            };
+
+            typedef std::vector<Reader*> ReaderVector;
+
+            InputExecutor* const  _main;          // Main input executor.
+            const Options::MergePolicy _policy;
+            const NanoSecond      _timeout;       // Failover timeout.
+            const MilliSecond     _bitrate_adj;   // Bitrate evaluation interval.
+            std::vector<InputExecutor*> _inputs;  // Additional input executors.
+            ReaderVector          _readers;       // All reader threads, including main input.
+            Mutex                 _mutex;         // Protect all queues.
+            Condition             _data;          // Signaled when packets are available or an input ended.
+            bool                  _started;       // Reader threads were started and not yet stopped.
+            bool                  _terminate;     // Reader threads must terminate.
+            size_t                _current;       // Index of current reader (failover) or next reader (interleave).
+            size_t                _switches;      // Number of input switches (failover).
+            std::vector<size_t>   _pid_inputs;    // Index of first input per PID, zero if not found (interleave).
+            PIDSet                _pid_conflicts; // PID's which were found in several inputs (interleave).
+
+            // Select the input to use with the failover policy, under the protection of the mutex.
+            void selectInput();
+
+            // Check if a reader is currently merged, under the protection of the mutex.
+            bool isMerged(const Reader* reader) const;
+
+            // Report PID's which are found in several inputs (interleave), under the protection of the mutex.
+            void checkPIDs(const Reader* reader, const TSPacket* packets, size_t count);
+
+            // Inaccessible operations.
+            InputMerger() = delete;
+            InputMerger(const InputMerger&) = delete;
+            InputMerger& operator=(const InputMerger&) = delete;
+        };
+    }
+}
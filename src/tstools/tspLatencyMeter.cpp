@@ -0,0 +1,132 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Transport stream processor: Measurement of the packet latency
+//
+//----------------------------------------------------------------------------
+
+#include "tspLatencyMeter.h"
+#include "tsDecimal.h"
+#include "tsFormat.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+const size_t ts::tsp::LatencyMeter::BUCKET_COUNT;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------
+
+ts::tsp::LatencyMeter::LatencyMeter() :
+    _stamps(),
+    _count(0),
+    _total(0),
+    _min(0),
+    _max(0),
+    _buckets()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Start the measurement.
+//----------------------------------------------------------------------------
+
+void ts::tsp::LatencyMeter::init(size_t buffer_count)
+{
+    _stamps.assign(buffer_count, 0);
+    _count = 0;
+    _total = _min = _max = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        _buckets[i] = 0;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Timestamp packets which were received by the input plugin.
+//----------------------------------------------------------------------------
+
+void ts::tsp::LatencyMeter::receivedPackets(size_t first, size_t count, NanoSecond time)
+{
+    assert(first + count <= _stamps.size());
+    std::fill(_stamps.begin() + first, _stamps.begin() + first + count, time);
+}
+
+
+//----------------------------------------------------------------------------
+// Account the latency of packets which are sent by the output plugin.
+//----------------------------------------------------------------------------
+
+void ts::tsp::LatencyMeter::sentPackets(const TSPacket* base, size_t first, size_t count, NanoSecond time)
+{
+    assert(first + count <= _stamps.size());
+
+    for (size_t i = first; i < first + count; ++i) {
+        if (base[i].b[0] != 0) {
+            const NanoSecond latency = time - _stamps[i];
+            _min = _count == 0 ? latency : std::min(_min, latency);
+            _max = std::max(_max, latency);
+            _total += latency;
+            _count++;
+            size_t bucket = 0;
+            for (NanoSecond limit = 10 * NanoSecPerMicroSec; bucket < BUCKET_COUNT - 1 && latency >= limit; limit *= 10) {
+                bucket++;
+            }
+            _buckets[bucket]++;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Report the latency statistics.
+//----------------------------------------------------------------------------
+
+void ts::tsp::LatencyMeter::report(ReportInterface& report) const
+{
+    if (_count == 0) {
+        report.info("tsp: latency: no packet");
+        return;
+    }
+
+    report.info("tsp: latency: " + Decimal(_count) + " packets, average " +
+                Decimal(_total / NanoSecond(_count) / NanoSecPerMicroSec) + " us, min " +
+                Decimal(_min / NanoSecPerMicroSec) + " us, max " +
+                Decimal(_max / NanoSecPerMicroSec) + " us");
+
+    static const char* const names[BUCKET_COUNT] = {"< 10 us", "< 100 us", "< 1 ms", "< 10 ms", "< 100 ms", ">= 100 ms"};
+    std::string line("tsp: latency distribution:");
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        line += Format(" %s: %.2f%%%s", names[i], (100.0 * double(_buckets[i])) / double(_count), i + 1 < BUCKET_COUNT ? "," : "");
+    }
+    report.info(line);
+}
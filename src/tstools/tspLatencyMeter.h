@@ -0,0 +1,104 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Transport stream processor: Measurement of the packet latency
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTSPacket.h"
+#include "tsReportInterface.h"
+
+namespace ts {
+    namespace tsp {
+        //!
+        //! Measurement of the latency of packets between the input and output plugins.
+        //!
+        //! The input executor timestamps the slots of the packet buffer when it
+        //! receives packets. The output executor computes the latency of the packets
+        //! when it sends them. There is no need for synchronization: a slot is written
+        //! by the input and read by the output under the rules of the packet buffer.
+        //!
+        class LatencyMeter
+        {
+        public:
+            //!
+            //! Constructor.
+            //!
+            LatencyMeter();
+
+            //!
+            //! Start the measurement.
+            //! Must be executed in synchronous environment, before starting all executor threads.
+            //! @param [in] buffer_count Number of packets in the packet buffer.
+            //!
+            void init(size_t buffer_count);
+
+            //!
+            //! Timestamp packets which were received by the input plugin.
+            //! @param [in] first Index of the first packet in the buffer.
+            //! @param [in] count Number of packets.
+            //! @param [in] time Reception time, in the clock of PluginExecutor::MetricsClock().
+            //!
+            void receivedPackets(size_t first, size_t count, NanoSecond time);
+
+            //!
+            //! Account the latency of packets which are sent by the output plugin.
+            //! The dropped packets are ignored.
+            //! @param [in] base Base address of the packet buffer.
+            //! @param [in] first Index of the first packet in the buffer.
+            //! @param [in] count Number of packets.
+            //! @param [in] time Transmission time, in the clock of PluginExecutor::MetricsClock().
+            //!
+            void sentPackets(const TSPacket* base, size_t first, size_t count, NanoSecond time);
+
+            //!
+            //! Report the latency statistics.
+            //! @param [in,out] report Where to report the statistics.
+            //!
+            void report(ReportInterface& report) const;
+
+        private:
+            // Distribution of latencies, by power of 10 microseconds: <10 us, <100 us, <1 ms, <10 ms, <100 ms, more.
+            static const size_t BUCKET_COUNT = 6;
+
+            std::vector<NanoSecond> _stamps;     // Reception time of each slot in the buffer.
+            PacketCounter           _count;      // Number of measured packets.
+            NanoSecond              _total;      // Sum of latencies.
+            NanoSecond              _min;        // Minimum latency.
+            NanoSecond              _max;        // Maximum latency.
+            PacketCounter           _buckets[BUCKET_COUNT];  // Distribution of latencies.
+
+            // Inaccessible operations.
+            LatencyMeter(const LatencyMeter&) = delete;
+            LatencyMeter& operator=(const LatencyMeter&) = delete;
+        };
+    }
+}
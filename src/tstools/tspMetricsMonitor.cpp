@@ -0,0 +1,188 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Transport stream processor: Periodic output of plugin execution metrics
+//
+//----------------------------------------------------------------------------
+
+#include "tspMetricsMonitor.h"
+#include "tsGuardCondition.h"
+#include "tsTime.h"
+#include "tsFormat.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructor and destructor
+//----------------------------------------------------------------------------
+
+ts::tsp::MetricsMonitor::MetricsMonitor(const Options& options, PluginExecutor* first_plugin, size_t buffer_packets, ReportInterface& report) :
+    Thread(ThreadAttributes().setPriority(ThreadAttributes::GetMinimumPriority())),
+    _options(options),
+    _first_plugin(first_plugin),
+    _buffer_packets(buffer_packets),
+    _report(report),
+    _file(),
+    _sock(),
+    _mutex(),
+    _wake_up(),
+    _terminate(false)
+{
+}
+
+ts::tsp::MetricsMonitor::~MetricsMonitor()
+{
+    stop();
+    if (_file.is_open()) {
+        _file.close();
+    }
+    if (_sock.isOpen()) {
+        _sock.close();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Stop the thread.
+//----------------------------------------------------------------------------
+
+void ts::tsp::MetricsMonitor::stop()
+{
+    // Signal that the thread shall terminate
+    {
+        GuardCondition lock(_mutex, _wake_up);
+        _terminate = true;
+        lock.signal();
+    }
+    waitForTermination();
+}
+
+
+//----------------------------------------------------------------------------
+// Open the output file and socket.
+//----------------------------------------------------------------------------
+
+bool ts::tsp::MetricsMonitor::open()
+{
+    if (!_options.metrics_file.empty()) {
+        _file.open(_options.metrics_file.c_str(), std::ios::out | std::ios::app);
+        if (!_file) {
+            _report.error("tsp: cannot create " + _options.metrics_file);
+            return false;
+        }
+    }
+    if (!_options.metrics_udp.empty() && (!_sock.open(_report) || !_sock.setDefaultDestination(_options.metrics_udp, _report))) {
+        _sock.close();
+        return false;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Build one sample in JSON format.
+//----------------------------------------------------------------------------
+
+std::string ts::tsp::MetricsMonitor::sample(MetricsVector& previous, NanoSecond interval)
+{
+    const double seconds = double(std::max<NanoSecond>(interval, 1)) / double(NanoSecPerSec);
+    std::string line(Format("{\"time\": \"%s\", \"interval_ms\": %" FMT_INT64 "d, \"buffer_packets\": %" FMT_SIZE_T "u, \"plugins\": [",
+                            Time::CurrentUTC().format(Time::DATE | Time::TIME).c_str(),
+                            interval / NanoSecPerMilliSec,
+                            _buffer_packets));
+
+    size_t index = 0;
+    PluginExecutor* proc = _first_plugin;
+    do {
+        PluginExecutor::Metrics current;
+        proc->getMetrics(current, true);
+        if (index >= previous.size()) {
+            previous.resize(index + 1);
+        }
+        const PluginExecutor::Metrics& last(previous[index]);
+        const PacketCounter packets = current.packets - last.packets;
+        const NanoSecond busy = current.busy - last.busy;
+        const NanoSecond wait = current.wait - last.wait;
+
+        line += Format("%s{\"name\": \"%s\", \"type\": \"%s\", \"packets\": %" FMT_INT64 "u, \"packets_per_second\": %.1f, "
+                       "\"busy_percent\": %.2f, \"wait_percent\": %.2f, \"busy_ns_per_packet\": %" FMT_INT64 "d, "
+                       "\"occupancy\": %" FMT_SIZE_T "u, \"high_water\": %" FMT_SIZE_T "u}",
+                       index == 0 ? "" : ", ",
+                       proc->pluginName().c_str(),
+                       Options::PluginTypeName(proc->pluginType()).c_str(),
+                       current.packets,
+                       double(packets) / seconds,
+                       (100.0 * double(busy)) / double(std::max<NanoSecond>(interval, 1)),
+                       (100.0 * double(wait)) / double(std::max<NanoSecond>(interval, 1)),
+                       packets == 0 ? NanoSecond(0) : NanoSecond(busy / NanoSecond(packets)),
+                       current.occupancy,
+                       current.high_water);
+
+        previous[index++] = current;
+    } while ((proc = proc->ringNext<PluginExecutor>()) != _first_plugin);
+
+    line += "]}";
+    return line;
+}
+
+
+//----------------------------------------------------------------------------
+// Thread main code. Inherited from Thread
+//----------------------------------------------------------------------------
+
+void ts::tsp::MetricsMonitor::main()
+{
+    MetricsVector previous;
+    NanoSecond last_time = PluginExecutor::MetricsClock();
+    bool terminate = false;
+
+    while (!terminate) {
+
+        // Wait until due time or termination request.
+        {
+            GuardCondition lock(_mutex, _wake_up);
+            if (!_terminate) {
+                lock.waitCondition(_options.metrics_interval);
+            }
+            terminate = _terminate;
+        }
+
+        // Build one sample. A last sample is produced on termination.
+        const NanoSecond now = PluginExecutor::MetricsClock();
+        const std::string line(sample(previous, now - last_time));
+        last_time = now;
+
+        if (_file.is_open()) {
+            _file << line << std::endl;
+        }
+        if (_sock.isOpen()) {
+            _sock.send(line.data(), line.size(), _report);
+        }
+    }
+}
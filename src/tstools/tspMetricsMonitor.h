@@ -0,0 +1,109 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Transport stream processor: Periodic output of plugin execution metrics
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tspOptions.h"
+#include "tspPluginExecutor.h"
+#include "tsThread.h"
+#include "tsMutex.h"
+#include "tsCondition.h"
+#include "tsUDPSocket.h"
+
+namespace ts {
+    namespace tsp {
+        //!
+        //! Monitoring thread for the execution metrics of all plugins.
+        //!
+        //! This thread periodically collects the metrics of all plugin executors
+        //! and writes one line in JSON format per sample into a file and/or sends
+        //! it in a UDP datagram. The format is designed to be processed by external
+        //! monitoring tools, not by humans.
+        //!
+        class MetricsMonitor: public Thread
+        {
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] options Transport stream processor command options.
+            //! @param [in] first_plugin First plugin executor (input) in the ring of plugins.
+            //! @param [in] buffer_packets Size in packets of the global packet buffer.
+            //! @param [in,out] report Where to report errors.
+            //!
+            MetricsMonitor(const Options& options, PluginExecutor* first_plugin, size_t buffer_packets, ReportInterface& report);
+
+            //!
+            //! Destructor.
+            //! Stop the thread if still running.
+            //!
+            virtual ~MetricsMonitor();
+
+            //!
+            //! Stop the thread, after writing a last sample.
+            //! Must be called before deleting the plugin executors.
+            //!
+            void stop();
+
+            //!
+            //! Open the output file and socket.
+            //! @return True on success, false on error.
+            //!
+            bool open();
+
+        private:
+            const Options&   _options;
+            PluginExecutor*  _first_plugin;
+            const size_t     _buffer_packets;
+            ReportInterface& _report;
+            std::ofstream    _file;
+            UDPSocket        _sock;
+            Mutex            _mutex;
+            Condition        _wake_up;    // accessed under mutex
+            bool             _terminate;  // accessed under mutex
+
+            // Metrics of all plugins, in ring order.
+            typedef std::vector<PluginExecutor::Metrics> MetricsVector;
+
+            // Build one sample in JSON format.
+            std::string sample(MetricsVector& previous, NanoSecond interval);
+
+            // Inherited from Thread
+            virtual void main() override;
+
+            // Inaccessible operations.
+            MetricsMonitor() = delete;
+            MetricsMonitor(const MetricsMonitor&) = delete;
+            MetricsMonitor& operator=(const MetricsMonitor&) = delete;
+        };
+    }
+}
@@ -40,6 +40,9 @@ TSDUCK_SOURCE;
 #define DEF_BUFSIZE_MB           16  // mega-bytes
 #define DEF_BITRATE_INTERVAL      5  // seconds
 #define DEF_MAX_FLUSH_PKT     10000  // packets
+#define DEF_METRICS_INTERVAL   1000  // milliseconds
+#define DEF_MERGE_TIMEOUT      1000  // milliseconds
+#define DEF_MERGE_QUEUE_SIZE  16384  // packets
 
 
 //----------------------------------------------------------------------------
@@ -50,31 +53,70 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
     verbose(false),
     debug(0),
     timed_log(false),
+    log_rate_limit(0),
     list_proc(false),
     monitor(false),
     ignore_jt(false),
     bufsize(0),
+    page_mode(ResidentBuffer<TSPacket>::STANDARD_PAGES),
     max_flush_pkt(0),
     max_input_pkt(0),
+    low_latency(false),
+    measure_latency(false),
     instuff_nullpkt(0),
     instuff_inpkt(0),
     bitrate(0),
     bitrate_adj(0),
+    cpus(),
+    pin_plugins(false),
+    numa_node(-1),
+    rt_policy(ThreadAttributes::DEFAULT_SCHEDULING),
+    rt_priority(0),
+    metrics_file(),
+    metrics_udp(),
+    metrics_interval(0),
     input(),
+    merged_inputs(),
+    merge_policy(MERGE_FAILOVER),
+    merge_timeout(0),
+    merge_queue_size(0),
     output(),
-    plugins()
+    plugins(),
+    branches()
 {
     option("add-input-stuffing",       'a', Args::STRING);
     option("bitrate",                  'b', Args::POSITIVE);
     option("bitrate-adjust-interval",   0,  Args::POSITIVE);
     option("buffer-size-mb",            0,  Args::POSITIVE);
+    option("cpu-affinity",              0,  Args::STRING);
     option("debug",                    'd', Args::POSITIVE, 0, 1, 0, 0, true);
+    option("huge-pages",                0,  Enumeration("transparent", ResidentBuffer<TSPacket>::TRANSPARENT_HUGE_PAGES,
+                                                        "2mb",         ResidentBuffer<TSPacket>::HUGE_PAGES_2MB,
+                                                        "1gb",         ResidentBuffer<TSPacket>::HUGE_PAGES_1GB,
+                                                        TS_NULL));
     option("ignore-joint-termination", 'i');
     option("list-processors",          'l');
+    option("log-rate-limit",            0,  Args::UNSIGNED);
+    option("low-latency",               0);
     option("max-flushed-packets",       0,  Args::POSITIVE);
     option("max-input-packets",         0,  Args::POSITIVE);
+    option("measure-latency",           0);
     option("no-realtime-clock",         0); // was a temporary workaround, now ignored
+    option("merge-policy",              0,  Enumeration("failover",   MERGE_FAILOVER,
+                                                        "interleave", MERGE_INTERLEAVE,
+                                                        TS_NULL));
+    option("merge-queue-size",          0,  Args::POSITIVE);
+    option("merge-timeout",             0,  Args::POSITIVE);
+    option("metrics-file",              0,  Args::STRING);
+    option("metrics-interval",          0,  Args::POSITIVE);
+    option("metrics-udp",               0,  Args::STRING);
     option("monitor",                  'm');
+    option("numa-node",                 0,  Args::UNSIGNED);
+    option("pin-plugins",               0);
+    option("realtime-policy",           0,  Enumeration("fifo", ThreadAttributes::FIFO_SCHEDULING,
+                                                        "rr",   ThreadAttributes::ROUND_ROBIN_SCHEDULING,
+                                                        TS_NULL));
+    option("realtime-priority",         0,  Args::UNSIGNED);
     option("timed-log",                't');
     option("verbose",                  'v');
 
@@ -100,7 +142,9 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
     setSyntax(" [tsp-options] \\\n"
               "    [-I input-name [input-options]] \\\n"
               "    [-P processor-name [processor-options]] ... \\\n"
-              "    [-O output-name [output-options]]");
+              "    [-O output-name [output-options]] \\\n"
+              "    [-B [branch-options] [-P processor-name [processor-options]] ... \\\n"
+              "        -O output-name [output-options]] ...");
 
     setHelp("All tsp-options must be placed on the command line before the input,\n"
             "processors and output specifications. The tsp-options are:\n"
@@ -133,6 +177,11 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
             "      the buffer between the input and output devices. The default\n"
             "      is " TS_STRINGIFY(DEF_BUFSIZE_MB) " MB.\n"
             "\n"
+            "  --cpu-affinity list\n"
+            "      Run all tsp threads on the specified CPU's only. The list is a comma-\n"
+            "      separated list of CPU numbers or ranges, for instance \"0-3,8\".\n"
+            "      CPU affinity is not supported on MacOS.\n"
+            "\n"
             "  -d[N]\n"
             "  --debug[=N]\n"
             "      Produce debug output. Specify an optional debug level N.\n"
@@ -140,6 +189,13 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
             "  --help\n"
             "      Display this help text.\n"
             "\n"
+            "  --huge-pages name\n"
+            "      Allocate the packet buffer in huge memory pages to reduce the TLB misses\n"
+            "      with large buffers. The name is one of \"transparent\" (advice to use\n"
+            "      transparent huge pages), \"2mb\" or \"1gb\" (explicit huge pages, must\n"
+            "      be reserved in the system). When the allocation fails, the next smaller\n"
+            "      page size is used. Huge pages are supported on Linux only.\n"
+            "\n"
             "  -i\n"
             "  --ignore-joint-termination\n"
             "      Ignore all --joint-termination options in plugins.\n"
@@ -155,6 +211,20 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
             "  --list-processors\n"
             "      List all available processors.\n"
             "\n"
+            "  --log-rate-limit value\n"
+            "      Specify the maximum number of similar log messages per second. Messages\n"
+            "      are similar when they have the same severity and differ only by their\n"
+            "      numerical values. Excess messages are dropped and their number is\n"
+            "      periodically reported. Debug messages are never dropped. By default,\n"
+            "      there is no limit.\n"
+            "\n"
+            "  --low-latency\n"
+            "      Adapt the size of the packet batches to the load. When few packets are\n"
+            "      available, the batches shrink and the packets are passed earlier to the\n"
+            "      next plugin. When more packets are available, the batches grow up to the\n"
+            "      values of --max-flushed-packets and --max-input-packets. This reduces the\n"
+            "      latency at low bitrates without losing throughput at high bitrates.\n"
+            "\n"
             "  --max-flushed-packets value\n"
             "      Specify the maximum number of packets to be processed before flushing\n"
             "      them to the next processor or the output. When the processing time\n"
@@ -166,12 +236,81 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
             "      the input plug-in. By default, tsp reads as many packets as it can,\n"
             "      depending on the free space in the buffer.\n"
             "\n"
+            "  --measure-latency\n"
+            "      Measure the latency of each packet between its reception by the input\n"
+            "      plugin and its transmission by the output plugin. The average, minimum\n"
+            "      and maximum latencies and their distribution are reported at the end.\n"
+            "\n"
+            "  --merge-policy name\n"
+            "      Specify how several input plug-in's are merged. With \"failover\" (the\n"
+            "      default), the packets are read from one input at a time, starting with\n"
+            "      the first one. When the current input fails (end of input or no packet\n"
+            "      during --merge-timeout), tsp switches to the first other input which has\n"
+            "      packets. With \"interleave\", the packets from all inputs are interleaved\n"
+            "      in their order of arrival, approximately. The packets from each input\n"
+            "      remain in their original order. The PID's are not remapped and the PSI\n"
+            "      are not merged. Thus, the PID's from all inputs must be distinct, including\n"
+            "      the PAT on PID 0. Interleaving several complete transport streams (for\n"
+            "      instance several SPTS) produces an invalid stream. A warning is reported\n"
+            "      for each PID which is found in several inputs.\n"
+            "\n"
+            "  --merge-queue-size value\n"
+            "      With several input plug-in's, specify the size in packets of the queue\n"
+            "      of each input. The default is " TS_STRINGIFY(DEF_MERGE_QUEUE_SIZE) " packets. With --merge-policy failover,\n"
+            "      the queues of the inputs which are not currently used keep the most\n"
+            "      recent packets only.\n"
+            "\n"
+            "  --merge-timeout milliseconds\n"
+            "      With --merge-policy failover, an input is considered as failed when no\n"
+            "      packet is received during this time. The default is " TS_STRINGIFY(DEF_MERGE_TIMEOUT) " milliseconds.\n"
+            "\n"
+            "  --metrics-file filename\n"
+            "      Periodically append execution metrics of all plugins to the specified\n"
+            "      file. Each sample is one line in JSON format, containing for each\n"
+            "      plugin the number of passed packets, the packet rate, the percentage of\n"
+            "      time spent processing packets and waiting for packets, the number of\n"
+            "      packets in the buffer area of the plugin and its high-water mark since\n"
+            "      the previous sample.\n"
+            "\n"
+            "  --metrics-interval milliseconds\n"
+            "      Interval between two samples of --metrics-file or --metrics-udp. The\n"
+            "      default is " TS_STRINGIFY(DEF_METRICS_INTERVAL) " milliseconds.\n"
+            "\n"
+            "  --metrics-udp address:port\n"
+            "      Periodically send execution metrics of all plugins in UDP datagrams to\n"
+            "      the specified address and port, typically on the local host. Each\n"
+            "      datagram contains one JSON sample, as described in --metrics-file.\n"
+            "\n"
             "  -m\n"
             "  --monitor\n"
             "      Continuously monitor the system resources which are used by tsp.\n"
             "      This includes CPU load, virtual memory usage. Useful to verify the\n"
             "      stability of the application.\n"
             "\n"
+            "  --numa-node value\n"
+            "      Run all tsp threads on the CPU's of the specified NUMA node and allocate\n"
+            "      the packet buffer in the memory of this node. When --cpu-affinity is also\n"
+            "      specified, only the CPU's of the list which are in the NUMA node are used.\n"
+            "      This option is supported on Linux only.\n"
+            "\n"
+            "  --pin-plugins\n"
+            "      Pin each plugin thread on one CPU. The CPU's are taken in sequence, from\n"
+            "      the input plugin to the output plugin, in the list of --cpu-affinity or\n"
+            "      in the NUMA node of --numa-node, or in all CPU's of the system. If there\n"
+            "      are more plugins than CPU's, several plugins are pinned on the same CPU.\n"
+            "\n"
+            "  --realtime-policy name\n"
+            "      Run all plugin threads with the specified real-time scheduling policy,\n"
+            "      either \"fifo\" or \"rr\" (round-robin). This usually requires root\n"
+            "      privileges. When the threads cannot be started with this policy, tsp\n"
+            "      reports a warning and uses the default policy. Real-time policies are\n"
+            "      supported on Linux only.\n"
+            "\n"
+            "  --realtime-priority value\n"
+            "      With --realtime-policy, specify the priority of the packet processor\n"
+            "      threads. The output thread uses the next priority and the input thread\n"
+            "      the one after. The default is the middle of the range of the policy.\n"
+            "\n"
             "  -t\n"
             "  --timed-log\n"
             "      Each logged message contains a time stamp.\n"
@@ -188,7 +327,9 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
             "  -I name\n"
             "  --input name\n"
             "      Designate the " HELP_SHLIB " plug-in for packet input.\n"
-            "      By default, read packets from standard input.\n"
+            "      By default, read packets from standard input. Several input plug-in's\n"
+            "      can be specified. Each of them is then executed in its own thread and\n"
+            "      the packets are merged according to --merge-policy.\n"
             "\n"
             "  -O name\n"
             "  --output name\n"
@@ -203,6 +344,25 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
             "      is no processor and the packets are directly passed from the input to\n"
             "      the output.\n"
             "\n"
+            "  -B [branch-options]\n"
+            "  --branch [branch-options]\n"
+            "      Start a branch. All packets which are passed to the main output plug-in\n"
+            "      are also passed to each branch, in parallel. Each branch is a sequence\n"
+            "      of zero or more packet processors, ending with one output plug-in. All\n"
+            "      branches must be specified after the main input, processors and output.\n"
+            "      The packets are read by all branches from the same tsp buffer, without\n"
+            "      copy. They are copied only in branches with packet processors since\n"
+            "      these processors may modify the packets. Each branch is executed in its\n"
+            "      own thread. By default, the buffer space is reused by the input plug-in\n"
+            "      only after all branches processed the packets: a slow branch slows down\n"
+            "      the complete tsp. The branch-options are:\n"
+            "\n"
+            "      --max-lag value\n"
+            "          When this branch lags more than the specified number of packets\n"
+            "          behind the main output, skip the oldest packets instead of slowing\n"
+            "          down the other branches. The branch then processes a sample of the\n"
+            "          stream only. This value should be much lower than the buffer size.\n"
+            "\n"
             "The specified <name> is used to locate a " HELP_SHLIB ". It can be designated\n"
             "in a number of ways, in the following order:\n"
             "\n"
@@ -237,11 +397,50 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
     list_proc = present("list-processors");
     monitor = present("monitor");
     bufsize = 1024 * 1024 * intValue<size_t>("buffer-size-mb", DEF_BUFSIZE_MB);
+    page_mode = ResidentBuffer<TSPacket>::PageMode(intValue<int>("huge-pages", ResidentBuffer<TSPacket>::STANDARD_PAGES));
     bitrate = intValue<BitRate>("bitrate", 0);
     bitrate_adj = MilliSecPerSec * intValue("bitrate-adjust-interval", DEF_BITRATE_INTERVAL);
     max_flush_pkt = intValue<size_t>("max-flushed-packets", DEF_MAX_FLUSH_PKT);
     max_input_pkt = intValue<size_t>("max-input-packets", 0);
+    log_rate_limit = intValue<size_t>("log-rate-limit", 0);
+    low_latency = present("low-latency");
+    measure_latency = present("measure-latency");
     ignore_jt = present("ignore-joint-termination");
+    pin_plugins = present("pin-plugins");
+    numa_node = intValue<int>("numa-node", -1);
+    rt_policy = ThreadAttributes::SchedulingPolicy(intValue<int>("realtime-policy", ThreadAttributes::DEFAULT_SCHEDULING));
+    merge_policy = MergePolicy(intValue<int>("merge-policy", MERGE_FAILOVER));
+    merge_timeout = intValue<MilliSecond>("merge-timeout", DEF_MERGE_TIMEOUT);
+    merge_queue_size = intValue<size_t>("merge-queue-size", DEF_MERGE_QUEUE_SIZE);
+    metrics_file = value("metrics-file");
+    metrics_udp = value("metrics-udp");
+    metrics_interval = intValue<MilliSecond>("metrics-interval", DEF_METRICS_INTERVAL);
+    rt_priority = intValue<int>("realtime-priority", (ThreadAttributes::GetMinimumPriority(rt_policy) + ThreadAttributes::GetMaximumPriority(rt_policy)) / 2);
+
+    if (present("cpu-affinity") && (!ThreadAttributes::CPUSetFromString(cpus, value("cpu-affinity")) || cpus.empty())) {
+        error("invalid CPU list for --cpu-affinity");
+    }
+    if (!cpus.empty() && *cpus.rbegin() >= ThreadAttributes::GetCPUCount()) {
+        error(Format("invalid CPU %" FMT_SIZE_T "u, there are %" FMT_SIZE_T "u CPU's", *cpus.rbegin(), ThreadAttributes::GetCPUCount()));
+    }
+    if (numa_node >= 0) {
+        ThreadAttributes::CPUSet node_cpus;
+        if (!ThreadAttributes::GetNUMANodeCPUs(size_t(numa_node), node_cpus)) {
+            error(Format("NUMA node %d not found", numa_node));
+        }
+        else if (cpus.empty()) {
+            cpus = node_cpus;
+        }
+        else {
+            // Keep only the CPU's of the list which are in the node.
+            ThreadAttributes::CPUSet both;
+            std::set_intersection(cpus.begin(), cpus.end(), node_cpus.begin(), node_cpus.end(), std::inserter(both, both.begin()));
+            if (both.empty()) {
+                error(Format("no CPU from --cpu-affinity in NUMA node %d", numa_node));
+            }
+            cpus = both;
+        }
+    }
 
     if (present("add-input-stuffing")) {
         std::string stuff(value("add-input-stuffing"));
@@ -270,6 +469,8 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
     // Locate all plugins
 
     plugins.reserve(argc);
+    branches.reserve(argc);
+    BranchOptions* branch = 0;
     bool got_input = false;
     bool got_output = false;
 
@@ -282,6 +483,22 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
         plugin_index = nextProcOpt(argc, argv, plugin_index, plugin_type);
         PluginOptions* opt = 0;
 
+        // A branch has its own options before its first plugin.
+
+        if (type == BRANCH) {
+            branches.resize(branches.size() + 1);
+            branch = &branches[branches.size() - 1];
+            for (int i = start + 1; i < plugin_index; ++i) {
+                if (std::string(argv[i]) == "--max-lag" && i + 1 < plugin_index && ToInteger(branch->max_lag, argv[i+1])) {
+                    i++;
+                }
+                else {
+                    error(Format("invalid branch option %s", argv[i]));
+                }
+            }
+            continue;
+        }
+
         if (start >= argc - 1) {
             error(Format("missing plugin name for option %s", argv[start]));
             break;
@@ -289,22 +506,43 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
 
         switch (type) {
             case PROCESSOR:
-                plugins.resize(plugins.size() + 1);
-                opt = &plugins[plugins.size() - 1];
+                if (branch != 0) {
+                    branch->plugins.resize(branch->plugins.size() + 1);
+                    opt = &branch->plugins[branch->plugins.size() - 1];
+                }
+                else {
+                    plugins.resize(plugins.size() + 1);
+                    opt = &plugins[plugins.size() - 1];
+                }
                 break;
             case INPUT:
-                if (got_input) {
-                    error("do not specify more than one input plugin");
+                if (branch != 0) {
+                    error("no input plugin in a branch");
+                    opt = &input;
+                }
+                else if (got_input) {
+                    merged_inputs.resize(merged_inputs.size() + 1);
+                    opt = &merged_inputs[merged_inputs.size() - 1];
+                }
+                else {
+                    opt = &input;
                 }
                 got_input = true;
-                opt = &input;
                 break;
             case OUTPUT:
-                if (got_output) {
-                    error("do not specify more than one output plugin");
+                if (branch != 0) {
+                    if (!branch->output.name.empty()) {
+                        error("do not specify more than one output plugin per branch");
+                    }
+                    opt = &branch->output;
+                }
+                else {
+                    if (got_output) {
+                        error("do not specify more than one output plugin");
+                    }
+                    got_output = true;
+                    opt = &output;
                 }
-                got_output = true;
-                opt = &output;
                 break;
             default:
                 // Should not get there
@@ -316,6 +554,14 @@ ts::tsp::Options::Options(int argc, char *argv[]) :
         AssignContainer(opt->args, plugin_index - start - 2, argv + start + 2);
     }
 
+    // Each branch ends with an output plugin.
+
+    for (size_t i = 0; i < branches.size(); ++i) {
+        if (branches[i].output.name.empty()) {
+            error(Format("missing output plugin in branch %" FMT_SIZE_T "u", i + 1));
+        }
+    }
+
     // Debug display
 
     if (debug >= 2) {
@@ -348,6 +594,10 @@ int ts::tsp::Options::nextProcOpt(int argc, char *argv[], int index, PluginType&
             type = PROCESSOR;
             return index;
         }
+        if (arg == "-B" || arg == "--branch") {
+            type = BRANCH;
+            return index;
+        }
     }
     return std::min(argc, index);
 }
@@ -367,21 +617,72 @@ std::ostream& ts::tsp::Options::display(std::ostream& strm, int indent) const
          << margin << "  --bitrate: " << Decimal(bitrate) << " b/s" << std::endl
          << margin << "  --bitrate-adjust-interval: " << Decimal(bitrate_adj) << " milliseconds" << std::endl
          << margin << "  --buffer-size-mb: " << Decimal(bufsize) << " bytes" << std::endl
+         << margin << "  --cpu-affinity: " << ThreadAttributes::CPUSetToString(cpus) << std::endl
          << margin << "  --debug: " << debug << std::endl
+         << margin << "  --huge-pages: " << ResidentBuffer<TSPacket>::PageModeName(page_mode) << std::endl
          << margin << "  --list-processors: " << list_proc << std::endl
+         << margin << "  --log-rate-limit: " << Decimal(log_rate_limit) << std::endl
+         << margin << "  --low-latency: " << low_latency << std::endl
          << margin << "  --max-flushed-packets: " << Decimal(max_flush_pkt) << std::endl
          << margin << "  --max-input-packets: " << Decimal(max_input_pkt) << std::endl
+         << margin << "  --measure-latency: " << measure_latency << std::endl
+         << margin << "  --merge-policy: " << int(merge_policy) << std::endl
+         << margin << "  --merge-queue-size: " << Decimal(merge_queue_size) << " packets" << std::endl
+         << margin << "  --merge-timeout: " << Decimal(merge_timeout) << " milliseconds" << std::endl
+         << margin << "  --metrics-file: " << metrics_file << std::endl
+         << margin << "  --metrics-interval: " << Decimal(metrics_interval) << " milliseconds" << std::endl
+         << margin << "  --metrics-udp: " << metrics_udp << std::endl
          << margin << "  --monitor: " << monitor << std::endl
+         << margin << "  --numa-node: " << numa_node << std::endl
+         << margin << "  --pin-plugins: " << pin_plugins << std::endl
+         << margin << "  --realtime-policy: " << int(rt_policy) << std::endl
+         << margin << "  --realtime-priority: " << rt_priority << std::endl
          << margin << "  --verbose: " << verbose << std::endl
          << margin << "  Number of packet processors: " << plugins.size() << std::endl
          << margin << "  Input plugin:" << std::endl;
     input.display(strm, indent + 4);
+    for (size_t i = 0; i < merged_inputs.size(); ++i) {
+        strm << margin << "  Merged input plugin " << (i+2) << ":" << std::endl;
+        merged_inputs[i].display(strm, indent + 4);
+    }
     for (size_t i = 0; i < plugins.size(); ++i) {
         strm << margin << "  Packet processor plugin " << (i+1) << ":" << std::endl;
         plugins[i].display(strm, indent + 4);
     }
     strm << margin << "  Output plugin:" << std::endl;
     output.display(strm, indent + 4);
+    for (size_t i = 0; i < branches.size(); ++i) {
+        strm << margin << "  Branch " << (i+1) << ":" << std::endl;
+        branches[i].display(strm, indent + 4);
+    }
+
+    return strm;
+}
+
+
+//----------------------------------------------------------------------------
+// Branch options.
+//----------------------------------------------------------------------------
+
+ts::tsp::Options::BranchOptions::BranchOptions() :
+    max_lag(0),
+    plugins(),
+    output()
+{
+    output.type = OUTPUT;
+}
+
+std::ostream& ts::tsp::Options::BranchOptions::display(std::ostream& strm, int indent) const
+{
+    const std::string margin(indent, ' ');
+
+    strm << margin << "--max-lag: " << Decimal(max_lag) << " packets" << std::endl;
+    for (size_t i = 0; i < plugins.size(); ++i) {
+        strm << margin << "Packet processor plugin " << (i+1) << ":" << std::endl;
+        plugins[i].display(strm, indent + 2);
+    }
+    strm << margin << "Output plugin:" << std::endl;
+    output.display(strm, indent + 2);
 
     return strm;
 }
@@ -427,6 +728,7 @@ std::string ts::tsp::Options::PluginTypeName(PluginType type)
         case INPUT:     return "input";
         case OUTPUT:    return "output";
         case PROCESSOR: return "packet processor";
+        case BRANCH:    return "branch";
         default:        return Format("%d (invalid)", int(type));
     }
 }
@@ -34,6 +34,9 @@
 
 #pragma once
 #include "tsArgs.h"
+#include "tsThreadAttributes.h"
+#include "tsResidentBuffer.h"
+#include "tsTSPacket.h"
 
 namespace ts {
     //!
@@ -59,7 +62,8 @@ namespace ts {
             enum PluginType {
                 INPUT,     //!< Input plugin.
                 OUTPUT,    //!< Output plugin.
-                PROCESSOR  //!< Packet processor plugin.
+                PROCESSOR, //!< Packet processor plugin.
+                BRANCH     //!< Not a plugin, start of a branch (option -B).
             };
 
             //!
@@ -97,23 +101,78 @@ namespace ts {
             //!
             typedef std::vector<PluginOptions> PluginOptionsVector;
 
+            //!
+            //! Policy to merge several input plugins.
+            //!
+            enum MergePolicy {
+                MERGE_FAILOVER,    //!< Use one input at a time, switch to another one when it fails.
+                MERGE_INTERLEAVE   //!< Interleave the packets from all inputs.
+            };
+
+            //!
+            //! Class containing the options for one branch.
+            //! A branch is a sequence of packet processors, ending with an output plugin,
+            //! which receives the same packets as the main output plugin.
+            //!
+            struct BranchOptions
+            {
+                size_t              max_lag;  //!< Maximum lag in packets before skipping packets, zero means never skip.
+                PluginOptionsVector plugins;  //!< List of packet processor plugins in the branch.
+                PluginOptions       output;   //!< Output plugin of the branch.
+
+                //!
+                //! Default constructor.
+                //!
+                BranchOptions();
+
+                //!
+                //! Display the content of this object to a stream.
+                //! @param [in,out] strm Where to output the content.
+                //! @param [in] indent Margin size, default: none.
+                //! @return A reference to @a strm.
+                //!
+                std::ostream& display(std::ostream& strm, int indent = 0) const;
+            };
+
+            //!
+            //! A vector of branch options.
+            //!
+            typedef std::vector<BranchOptions> BranchOptionsVector;
+
             // Option values
             bool          verbose;         //!< Verbose output.
             int           debug;           //!< Debug level.
             bool          timed_log;       //!< Add time stamps in log messages.
+            size_t        log_rate_limit;  //!< Max similar log messages per second, zero if unlimited.
             bool          list_proc;       //!< List processors.
             bool          monitor;         //!< Run a resource monitoring thread.
             bool          ignore_jt;       //!< Ignore "joint termination" options in plugins.
             size_t        bufsize;         //!< Buffer size.
+            ResidentBuffer<TSPacket>::PageMode page_mode; //!< Preferred type of memory pages for the buffer.
             size_t        max_flush_pkt;   //!< Max processed packets before flush.
             size_t        max_input_pkt;   //!< Max packets per input operation.
+            bool          low_latency;     //!< Adapt the batch sizes to the load, to reduce the latency.
+            bool          measure_latency; //!< Measure the latency of packets between input and output.
             size_t        instuff_nullpkt; //!< Add input stuffing: add @a nullpkt null packets every @a inpkt input packets.
             size_t        instuff_inpkt;   //!< Add input stuffing: add @a nullpkt null packets every @a inpkt input packets.
             BitRate       bitrate;         //!< Fixed input bitrate.
             MilliSecond   bitrate_adj;     //!< Bitrate adjust interval.
+            ThreadAttributes::CPUSet cpus; //!< CPU's where all threads may run (empty means all CPU's).
+            bool          pin_plugins;     //!< Pin each plugin thread on one CPU.
+            int           numa_node;       //!< NUMA node of the threads and packet buffer (negative means unspecified).
+            ThreadAttributes::SchedulingPolicy rt_policy;  //!< Scheduling policy of plugin threads.
+            int           rt_priority;     //!< Base real-time priority of plugin threads.
+            std::string   metrics_file;    //!< Output file for plugin execution metrics.
+            std::string   metrics_udp;     //!< UDP destination "address:port" for plugin execution metrics.
+            MilliSecond   metrics_interval; //!< Interval between two plugin execution metrics.
             PluginOptions input;           //!< Input plugin.
+            PluginOptionsVector merged_inputs; //!< Additional input plugins, merged with the main input.
+            MergePolicy   merge_policy;    //!< Policy to merge several input plugins.
+            MilliSecond   merge_timeout;   //!< Failover timeout of an input plugin.
+            size_t        merge_queue_size; //!< Size in packets of the queue of each merged input.
             PluginOptions output;          //!< Output plugin.
             PluginOptionsVector plugins;   //!< List of packet processor plugins.
+            BranchOptionsVector branches;  //!< List of branches after the output plugin.
 
             //!
             //! Display the content of this object to a stream.
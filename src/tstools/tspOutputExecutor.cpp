@@ -32,6 +32,7 @@
 //----------------------------------------------------------------------------
 
 #include "tspOutputExecutor.h"
+#include "tspLatencyMeter.h"
 #include "tsDecimal.h"
 TSDUCK_SOURCE;
 
@@ -119,6 +120,12 @@ void ts::tsp::OutputExecutor::main()
             }
         }
 
+        // Account the latency of the output packets.
+
+        if (_latency != 0) {
+            _latency->sentPackets(_buffer->base(), pkt_first, pkt_cnt, MetricsClock());
+        }
+
         // Pass free buffers to input processor.
         // Do not transmit bitrate to next (since next is input processor).
 
@@ -126,6 +133,12 @@ void ts::tsp::OutputExecutor::main()
 
     } while (!aborted);
 
+    // Notify the branches, if any, that no more packet will be passed.
+
+    if (_fanout != 0) {
+        passPackets(0, 0, true, aborted);
+    }
+
     // Close the output processor
 
     _output->stop();
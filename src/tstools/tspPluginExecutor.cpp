@@ -32,11 +32,17 @@
 //----------------------------------------------------------------------------
 
 #include "tspPluginExecutor.h"
+#include "tspFanOut.h"
 #include "tsGuardCondition.h"
 #include "tsGuard.h"
 #include "tsDecimal.h"
+#include "tsTime.h"
 TSDUCK_SOURCE;
 
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+const size_t ts::tsp::PluginExecutor::MIN_BATCH_SIZE;
+#endif
+
 
 //----------------------------------------------------------------------------
 // Constructor
@@ -51,14 +57,22 @@ ts::tsp::PluginExecutor::PluginExecutor(Options* options,
     Thread(attributes),
     PluginSharedLibrary(pl_options->name, *options),
     _name(pl_options->name),
+    _type(pl_options->type),
+    _fanout(0),
+    _latency(0),
     _shlib(0),
     _buffer(0),
     _report(options),
     _to_do(),
+    _busy_start(0),
+    _low_latency(options->low_latency),
+    _batch_size(MIN_BATCH_SIZE),
     _pkt_first(0),
     _pkt_cnt(0),
     _input_end(false),
-    _bitrate(0)
+    _waiting(false),
+    _bitrate(0),
+    _metrics()
 {
     const char* shell = 0;
 
@@ -149,6 +163,49 @@ void ts::tsp::PluginExecutor::initBuffer (PacketBuffer* buffer,
     _tsp_aborting = aborted;
     _bitrate = bitrate;
     _tsp_bitrate = bitrate;
+    _busy_start = MetricsClock();
+    _metrics.high_water = pkt_cnt;
+}
+
+
+//----------------------------------------------------------------------------
+// Execution metrics.
+//----------------------------------------------------------------------------
+
+ts::tsp::PluginExecutor::Metrics::Metrics() :
+    packets(0),
+    busy(0),
+    wait(0),
+    occupancy(0),
+    high_water(0)
+{
+}
+
+void ts::tsp::PluginExecutor::getMetrics(Metrics& metrics, bool reset_high_water)
+{
+    Guard lock(_global_mutex);
+    metrics = _metrics;
+    metrics.occupancy = _pkt_cnt;
+    if (reset_high_water) {
+        _metrics.high_water = _pkt_cnt;
+    }
+}
+
+ts::NanoSecond ts::tsp::PluginExecutor::MetricsClock()
+{
+    // This clock is read twice per packet batch. On Linux, clock_gettime()
+    // is implemented in user space (vDSO) and reads the CPU time stamp counter.
+#if defined(__windows)
+    static ::LARGE_INTEGER frequency = {0};
+    ::LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) {
+        ::QueryPerformanceFrequency(&frequency);
+    }
+    ::QueryPerformanceCounter(&counter);
+    return NanoSecond((counter.QuadPart / frequency.QuadPart) * NanoSecPerSec + ((counter.QuadPart % frequency.QuadPart) * NanoSecPerSec) / frequency.QuadPart);
+#else
+    return Time::UnixClockNanoSeconds(CLOCK_MONOTONIC);
+#endif
 }
 
 
@@ -188,26 +245,31 @@ void ts::tsp::PluginExecutor::passPackets (size_t count,     // of packets to pa
 
     log (10, "passPackets (count = %" FMT_SIZE_T "u, bitrate = %d, input_end = %d, aborted = %d)", count, int (bitrate), int (input_end), int (aborted));
 
+    // Account the processing time since the last waitWork() or passPackets().
+
+    const NanoSecond now = MetricsClock();
+
     // We access data under the protection of the global mutex.
 
     Guard lock (_global_mutex);
 
+    _metrics.busy += now - _busy_start;
+    _metrics.packets += count;
+    _busy_start = now;
+
     // Update our buffer
 
     _pkt_first = (_pkt_first + count) % _buffer->count();
     _pkt_cnt -= count;
 
-    // Update next processor's buffer.
-
-    PluginExecutor* next = ringNext<PluginExecutor>();
-    next->_pkt_cnt += count;
-    next->_input_end = next->_input_end || input_end;
-    next->_bitrate = bitrate;
-
-    // Wake the next processor when there is some data
+    // Update next processor's buffer. With branches, the fan-out will
+    // pass the packets to the next processor later.
 
-    if (count > 0 || input_end) {
-        next->_to_do.signal();
+    if (_fanout != 0) {
+        _fanout->receivePackets(count, _tsp_bitrate, input_end, aborted);
+    }
+    else {
+        ringNext<PluginExecutor>()->receivePackets(count, bitrate, input_end);
     }
 
     // Wake the previous processor when we abort
@@ -219,6 +281,39 @@ void ts::tsp::PluginExecutor::passPackets (size_t count,     // of packets to pa
 }
 
 
+//----------------------------------------------------------------------------
+// Adapt the batch size in low-latency mode.
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginExecutor::adaptBatchSize(bool loaded)
+{
+    if (_low_latency) {
+        _batch_size = loaded ? std::min(_buffer->count(), _batch_size * 2) : std::max(MIN_BATCH_SIZE, _batch_size / 2);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Receive packets from the previous executor.
+// Must be called under the protection of the global mutex.
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginExecutor::receivePackets(size_t count, BitRate bitrate, bool input_end)
+{
+    _pkt_cnt += count;
+    _input_end = _input_end || input_end;
+    _bitrate = bitrate;
+    _metrics.high_water = std::max(_metrics.high_water, _pkt_cnt);
+
+    // Wake this processor when there is some data. Do not signal the condition
+    // when the processor is not waiting: it will see the packets before waiting.
+
+    if (_waiting && (count > 0 || input_end)) {
+        _to_do.signal();
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // This method sets the current processor in an abort state.
 //----------------------------------------------------------------------------
@@ -248,25 +343,40 @@ void ts::tsp::PluginExecutor::waitWork (size_t& pkt_first,
 {
     log (10, "waitWork (...)");
 
+    // The waiting time includes the acquisition of the global mutex.
+
+    const NanoSecond wait_start = MetricsClock();
+
     // We access data under the protection of the global mutex.
+    {
+        GuardCondition lock (_global_mutex, _to_do);
 
-    GuardCondition lock (_global_mutex, _to_do);
+        while (_pkt_cnt == 0 && !_input_end && !ringNext<PluginExecutor>()->_tsp_aborting) {
 
-    while (_pkt_cnt == 0 && !_input_end && !ringNext<PluginExecutor>()->_tsp_aborting) {
+            // If packet area for this processor is empty, wait for some packet.
+            // The mutex is implicitely released, we wait for the condition
+            // '_to_do' and, once we get it, implicitely relock the mutex.
+            // We loop on this until packets are actually available.
 
-        // If packet area for this processor is empty, wait for some packet.
-        // The mutex is implicitely released, we wait for the condition
-        // '_to_do' and, once we get it, implicitely relock the mutex.
-        // We loop on this until packets are actually available.
+            _waiting = true;
+            lock.waitCondition();
+            _waiting = false;
+        }
 
-        lock.waitCondition();
+        pkt_first = _pkt_first;
+        pkt_cnt = std::min (_pkt_cnt, _buffer->count() - _pkt_first);
+        bitrate = _bitrate;
+        input_end = _input_end && pkt_cnt == _pkt_cnt;
+        aborted = ringNext<PluginExecutor>()->_tsp_aborting;
+
+        _busy_start = MetricsClock();
+        _metrics.wait += _busy_start - wait_start;
     }
 
-    pkt_first = _pkt_first;
-    pkt_cnt = std::min (_pkt_cnt, _buffer->count() - _pkt_first);
-    bitrate = _bitrate;
-    input_end = _input_end && pkt_cnt == _pkt_cnt;
-    aborted = ringNext<PluginExecutor>()->_tsp_aborting;
+    // Notify the expired timers of the plugin, outside the global mutex.
+    // The clock of the execution metrics is reused, no additional clock read.
+
+    _tsp_timers.advance (_busy_start / NanoSecPerMilliSec);
 
     log (10, "waitWork (pkt_first = %" FMT_SIZE_T "u, pkt_cnt = %" FMT_SIZE_T "u, bitrate = %d, input_end = %d, aborted = %d)",
          pkt_first, pkt_cnt, int (bitrate), int (input_end), int (aborted));
@@ -46,6 +46,10 @@
 
 namespace ts {
     namespace tsp {
+
+        class FanOut;
+        class LatencyMeter;
+
         //!
         //!  Execution context of a tsp plugin.
         //!
@@ -178,6 +182,80 @@ namespace ts {
             //!
             void setAbort();
 
+            //!
+            //! Pass the packets to a fan-out of branches instead of the next executor.
+            //! The fan-out passes the packets to the next executor when all branches
+            //! are done with them. Used on the output executor only.
+            //! Must be executed in synchronous environment, before starting all executor threads.
+            //! @param [in] fanout Fan-out of branches, null if there is no branch.
+            //!
+            void setFanOut(FanOut* fanout)
+            {
+                _fanout = fanout;
+            }
+
+            //!
+            //! Set the latency meter of the packets. Used on the input and output executors only.
+            //! Must be executed in synchronous environment, before starting all executor threads.
+            //! @param [in] latency Latency meter, null if the latency is not measured.
+            //!
+            void setLatencyMeter(LatencyMeter* latency)
+            {
+                _latency = latency;
+            }
+
+            //!
+            //! Execution metrics of a plugin executor.
+            //! The time counters are measured once per packet batch, not per packet.
+            //! The "busy" time is spent between the end of waitWork() and the next
+            //! passPackets(), typically in the plugin receive(), processPacket() or send().
+            //!
+            struct Metrics
+            {
+                PacketCounter packets;     //!< Total number of packets passed to the next plugin.
+                NanoSecond    busy;        //!< Total time spent processing packets.
+                NanoSecond    wait;        //!< Total time blocked in waitWork().
+                size_t        occupancy;   //!< Current number of packets in the buffer area of this plugin.
+                size_t        high_water;  //!< Maximum number of packets in the area since the last reset.
+
+                //!
+                //! Default constructor.
+                //!
+                Metrics();
+            };
+
+            //!
+            //! Get the execution metrics of this plugin.
+            //! Can be called from any thread.
+            //! @param [out] metrics Returned metrics.
+            //! @param [in] reset_high_water If true, reset the high-water mark to the current occupancy.
+            //!
+            void getMetrics(Metrics& metrics, bool reset_high_water = false);
+
+            //!
+            //! Get the monotonic clock which is used in execution metrics.
+            //! @return The current value of the clock in nanoseconds, from an unspecified origin.
+            //!
+            static NanoSecond MetricsClock();
+
+            //!
+            //! Get the plugin name.
+            //! @return A constant reference to the plugin name.
+            //!
+            const std::string& pluginName() const
+            {
+                return _name;
+            }
+
+            //!
+            //! Get the plugin type.
+            //! @return The plugin type.
+            //!
+            Options::PluginType pluginType() const
+            {
+                return _type;
+            }
+
             //!
             //! Plugin stack size overhead.
             //! Each plugin defines its own usage of the stack. The PluginExector
@@ -196,9 +274,44 @@ namespace ts {
 
         protected:
             std::string   _name;   //!< Plugin name.
+            Options::PluginType _type;  //!< Plugin type.
+            FanOut*       _fanout; //!< Fan-out of branches after this executor, null if none.
+            LatencyMeter* _latency; //!< Latency meter of the packets, null if none.
             Plugin*       _shlib;  //!< Shared library API.
             PacketBuffer* _buffer; //!< Description of shared packet buffer.
 
+            //!
+            //! Account for packets which were passed to the next processor before
+            //! starting the executor threads, in the execution metrics.
+            //! @param [in] count Number of packets.
+            //!
+            void addInitialPackets(size_t count)
+            {
+                _metrics.packets += count;
+            }
+
+            //!
+            //! Get the preferred number of packets in the next batch.
+            //! Without low-latency mode, there is no limit.
+            //! @param [in] max_size Maximum size of the batch.
+            //! @return The preferred batch size, not larger than @a max_size.
+            //! @see adaptBatchSize()
+            //!
+            size_t batchSize(size_t max_size) const
+            {
+                return _low_latency ? std::min(_batch_size, max_size) : max_size;
+            }
+
+            //!
+            //! Adapt the preferred batch size to the load, in low-latency mode.
+            //! The size doubles when the executor is loaded (more packets are immediately
+            //! available than the current batch size) and halves otherwise. Small batches
+            //! reduce the latency at low bitrates, large batches keep the throughput
+            //! at high bitrates.
+            //! @param [in] loaded True when more packets than the batch size are available.
+            //!
+            void adaptBatchSize(bool loaded);
+
             //!
             //! Pass processed packets to the next packet processor.
             //! This method is invoked by a subclass to indicate that some packets
@@ -241,13 +354,28 @@ namespace ts {
         private:
             ReportInterface* _report;   // Common report interface for all plugins
             Condition        _to_do;    // Notify processor to do something
+            NanoSecond       _busy_start;  // Start of current processing, accessed by the executor thread only
+            const bool       _low_latency; // Adapt the batch sizes to the load
+            size_t           _batch_size;  // Current batch size in low-latency mode, accessed by the executor thread only
+
+            // Minimum batch size in low-latency mode: the content of one UDP datagram.
+            static const size_t MIN_BATCH_SIZE = 7;
 
             // The following private data must be accessed exclusively under the
             // protection of the global mutex.
             size_t  _pkt_first;  // Starting index of packets area
             size_t  _pkt_cnt;    // Size of packets area
             bool    _input_end;  // No more packet after current ones
+            bool    _waiting;    // The executor thread is waiting for work, must be signaled
             BitRate _bitrate;    // Input bitrate (set by previous plugin)
+            Metrics _metrics;    // Execution metrics (occupancy is not maintained)
+
+            // Receive packets from the previous executor, under the protection of the global mutex.
+            void receivePackets(size_t count, BitRate bitrate, bool input_end);
+
+            // Branches drive their plugins outside the ring of executors.
+            friend class FanOut;
+            friend class BranchExecutor;
 
             // Inaccessible operations.
             PluginExecutor() = delete;
@@ -100,9 +100,11 @@ void ts::tsp::ProcessorExecutor::main()
         }
 
         // Now process the packets.
+        // In low-latency mode, the flush interval is adapted after each flush.
 
         size_t pkt_done = 0;
         size_t pkt_flush = 0;
+        size_t max_flush = batchSize(_max_flush_pkt);
 
         while (pkt_done < pkt_cnt) {
 
@@ -166,9 +168,11 @@ void ts::tsp::ProcessorExecutor::main()
             // the next processor. Perform periodic flush to avoid waiting
             // too long before two output operations.
 
-            if (flush_request || pkt_done == pkt_cnt || pkt_flush % _max_flush_pkt == 0) {
+            if (flush_request || pkt_done == pkt_cnt || pkt_flush >= max_flush) {
                 passPackets (pkt_flush, output_bitrate, pkt_done == pkt_cnt && input_end, aborted);
                 pkt_flush = 0;
+                adaptBatchSize(pkt_cnt - pkt_done > max_flush);
+                max_flush = batchSize(_max_flush_pkt);
             }
         }
 
@@ -39,6 +39,9 @@
 #include "tsFormat.h"
 #include "tsFatal.h"
 #include "tsMPEG.h"
+#include "tsTSSynchronizer.h"
+#include "tsThread.h"
+#include "tsGuardCondition.h"
 TSDUCK_SOURCE;
 
 #define MIN_SYNC_SIZE       (1024)              // 1 kB
@@ -49,6 +52,9 @@ TSDUCK_SOURCE;
 #define MAX_CONTIG_SIZE     (8 * 1024 * 1024)   // 8 MB
 #define DEFAULT_CONTIG_SIZE (512 * 1024)        // 512 kB
 
+#define INPUT_BUFFER_SIZE   (4 * 1024 * 1024)   // 4 MB, size of each input buffer
+#define OUTPUT_BUFFER_SIZE  (1024 * 1024)       // 1 MB
+
 
 //----------------------------------------------------------------------------
 //  Command line options
@@ -166,6 +172,163 @@ Options::Options(int argc, char *argv[]) :
 }
 
 
+//----------------------------------------------------------------------------
+// Input file, read by a separate thread using two alternate buffers.
+//----------------------------------------------------------------------------
+
+class AsyncInput: private ts::Thread
+{
+public:
+    // Constructor, start reading.
+    AsyncInput(size_t buffer_size);
+
+    // Destructor, stop reading.
+    virtual ~AsyncInput();
+
+    // Get the address and size of the next contiguous input data. Size is zero at end of file.
+    const uint8_t* peek(size_t& size);
+
+    // Consume input data after peek().
+    void consume(size_t size);
+
+    // Read and consume input data, return read size.
+    size_t read(uint8_t* buf, size_t size);
+
+private:
+    // Description of one input buffer.
+    struct Buffer
+    {
+        ts::ByteBlock data;  // Buffer content
+        size_t size;         // Size of valid data
+        size_t pos;          // Position of next byte to consume
+        bool   full;         // Buffer filled, ready to consume
+        bool   eof;          // End of file after this buffer
+        Buffer(size_t s) : data(s), size(0), pos(0), full(false), eof(false) {}
+    };
+
+    ts::Mutex     _mutex;
+    ts::Condition _filled;     // Signaled by the reader thread when a buffer is filled.
+    ts::Condition _emptied;    // Signaled by the main thread when a buffer is consumed.
+    Buffer        _buffers[2];
+    size_t        _current;    // Index of buffer being consumed.
+    bool          _terminate;  // Request the reader thread to terminate.
+
+    // Reader thread.
+    virtual void main();
+
+    // Inaccessible operations
+    AsyncInput(const AsyncInput&) = delete;
+    AsyncInput& operator=(const AsyncInput&) = delete;
+};
+
+AsyncInput::AsyncInput(size_t buffer_size) :
+    Thread(),
+    _mutex(),
+    _filled(),
+    _emptied(),
+    _buffers{Buffer(buffer_size), Buffer(buffer_size)},
+    _current(0),
+    _terminate(false)
+{
+    // By default, std::cin is tied to std::cout, meaning that reading std::cin
+    // flushes std::cout. Since the output is written by another thread, untie them.
+    std::cin.tie(0);
+    start();
+}
+
+AsyncInput::~AsyncInput()
+{
+    {
+        ts::GuardCondition lock(_mutex, _emptied);
+        _terminate = true;
+        lock.signal();
+    }
+    waitForTermination();
+}
+
+void AsyncInput::main()
+{
+    for (size_t index = 0; ; index ^= 1) {
+        Buffer& buf(_buffers[index]);
+
+        // Wait for the buffer to be free.
+        {
+            ts::GuardCondition lock(_mutex, _emptied);
+            while (buf.full && !_terminate) {
+                lock.waitCondition();
+            }
+            if (_terminate) {
+                break;
+            }
+        }
+
+        // Fill the buffer, outside the mutex.
+        size_t got = 0;
+        while (got < buf.data.size() && std::cin.read(reinterpret_cast<char*>(buf.data.data() + got), std::streamsize(buf.data.size() - got))) {
+            got += size_t(std::cin.gcount());
+        }
+        if (got < buf.data.size()) {
+            // Partial last read at end of file.
+            got += size_t(std::cin.gcount());
+        }
+
+        // Pass the buffer to the main thread.
+        ts::GuardCondition lock(_mutex, _filled);
+        buf.size = got;
+        buf.pos = 0;
+        buf.eof = got < buf.data.size();
+        buf.full = true;
+        lock.signal();
+        if (buf.eof) {
+            break;
+        }
+    }
+}
+
+const uint8_t* AsyncInput::peek(size_t& size)
+{
+    ts::GuardCondition lock(_mutex, _filled);
+    for (;;) {
+        Buffer& buf(_buffers[_current]);
+        while (!buf.full) {
+            lock.waitCondition();
+        }
+        if (buf.pos < buf.size || buf.eof) {
+            size = buf.size - buf.pos;
+            return buf.data.data() + buf.pos;
+        }
+        // Buffer completely consumed, release it to the reader thread.
+        buf.full = false;
+        _emptied.signal();
+        _current ^= 1;
+    }
+}
+
+void AsyncInput::consume(size_t size)
+{
+    ts::Guard lock(_mutex);
+    Buffer& buf(_buffers[_current]);
+    buf.pos += std::min(size, buf.size - buf.pos);
+}
+
+size_t AsyncInput::read(uint8_t* data, size_t size)
+{
+    size_t got = 0;
+    while (got < size) {
+        size_t avail = 0;
+        const uint8_t* const buf = peek(avail);
+        if (avail == 0) {
+            break; // end of file
+        }
+        avail = std::min(avail, size - got);
+        ::memcpy(data + got, buf, avail);
+        consume(avail);
+        got += avail;
+    }
+    return got;
+}
+
+
 //----------------------------------------------------------------------------
 // Resynchronization class
 //----------------------------------------------------------------------------
@@ -184,12 +347,12 @@ public:
         _in_header_size = 0;
     }
 
-    // Look for MPEG packets in a buffer, according to an assumed packet size.
-    // If the complete buffer matches the packet size, set input and output packet
-    // sizes and return true. Return false otherwise.
-    bool checkSync(const uint8_t* buf, size_t buf_size, size_t pkt_size, size_t header_size);
+    // Look for MPEG packets in a buffer, according to the allowed packet sizes.
+    // If found, set input and output packet sizes and return the position
+    // of the first packet. Return false if not found.
+    bool findSync(const uint8_t* buf, size_t buf_size, size_t& start);
 
-    // Get packet sizes, as determined by checkSync(). Size is zero if no valid packet size found.
+    // Get packet sizes, as determined by findSync(). Size is zero if no valid packet size found.
     size_t inputPacketSize() const {return _in_pkt_size;}
     size_t inputHeaderSize() const {return _in_header_size;}
     size_t outputPacketSize() const {return _out_pkt_size;}
@@ -206,19 +369,29 @@ public:
     // Read input data, return read size (zero on end of file or error)
     size_t readData(uint8_t* buf, size_t size);
 
-    // Write one output packet from input packet.
-    bool writePacket(const uint8_t* input_packet);
+    // Get the next contiguous input data, without consuming them.
+    const uint8_t* peekData(size_t& size) {return _input.peek(size);}
+    void consumeData(size_t size) {_input.consume(size);}
+
+    // Write output packets from contiguous input packets.
+    bool writePackets(const uint8_t* input_packets, size_t count);
 
     // Constructor
-    Resynchronizer(bool keep_packet_size) :
+    Resynchronizer(const Options& opt) :
         _status(RS_OK),
-        _keep_packet_size(keep_packet_size),
+        _keep_packet_size(opt.keep),
         _out_size(0),
         _in_pkt_size(0),
         _in_header_size(0),
         _out_pkt_size(0),
-        _out_header_size(0)
+        _out_header_size(0),
+        _sync(opt.contig_size),
+        _input(INPUT_BUFFER_SIZE),
+        _out_buffer(OUTPUT_BUFFER_SIZE)
     {
+        if (opt.packet_size > 0) {
+            _sync.setPacketFormat(opt.packet_size, opt.header_size);
+        }
     }
 
 private:
@@ -229,6 +402,12 @@ private:
     size_t   _in_header_size;    // Header size before TS packet in input stream (0, 4)
     size_t   _out_pkt_size;      // TS packet size in output stream
     size_t   _out_header_size;   // Header size before TS packet in output stream
+    ts::TSSynchronizer _sync;    // Packet synchronization search
+    AsyncInput    _input;        // Input file
+    ts::ByteBlock _out_buffer;   // Output buffer when packets must be reduced
+
+    // Write output data.
+    bool writeData(const uint8_t* data, size_t size);
 };
 
 
@@ -238,34 +417,22 @@ private:
 
 size_t Resynchronizer::readData(uint8_t* buf, size_t size)
 {
-    std::streamsize got = 0;
-    std::streamsize remain = std::streamsize(size);
-    while (remain > 0) {
-        if (std::cin.read(reinterpret_cast <char*> (buf + got), remain)) {
-            const std::streamsize count = std::cin.gcount();
-            got += count;
-            remain -= count;
-        }
-        else {
-            if (got == 0) {
-                _status = RS_EOF;
-            }
-            break;
-        }
+    const size_t got = _input.read(buf, size);
+    if (got == 0 && size > 0) {
+        _status = RS_EOF;
     }
-    return size_t(got);
+    return got;
 }
 
 
 //----------------------------------------------------------------------------
-// Write one output packet from input packet.
+// Write output packets from contiguous input packets.
 //----------------------------------------------------------------------------
 
-bool Resynchronizer::writePacket(const uint8_t* input_packet)
+bool Resynchronizer::writeData(const uint8_t* data, size_t size)
 {
-    const char* out_pkt = reinterpret_cast<const char*>(input_packet + _in_header_size - _out_header_size);
-    if (std::cout.write(out_pkt, std::streamsize(_out_pkt_size))) {
-        _out_size += _out_pkt_size;
+    if (std::cout.write(reinterpret_cast<const char*>(data), std::streamsize(size))) {
+        _out_size += size;
         return true;
     }
     else {
@@ -275,29 +442,46 @@ bool Resynchronizer::writePacket(const uint8_t* input_packet)
     }
 }
 
+bool Resynchronizer::writePackets(const uint8_t* input_packets, size_t count)
+{
+    if (_out_pkt_size == _in_pkt_size) {
+        // Same packet format, write all packets at once.
+        return writeData(input_packets, count * _in_pkt_size);
+    }
+
+    // Reduce packets in the output buffer.
+    const size_t max_count = _out_buffer.size() / _out_pkt_size;
+    const uint8_t* in = input_packets + _in_header_size - _out_header_size;
+    while (count > 0) {
+        const size_t chunk = std::min(count, max_count);
+        uint8_t* out = _out_buffer.data();
+        for (size_t i = 0; i < chunk; ++i) {
+            ::memcpy(out, in, _out_pkt_size);
+            out += _out_pkt_size;
+            in += _in_pkt_size;
+        }
+        if (!writeData(_out_buffer.data(), chunk * _out_pkt_size)) {
+            return false;
+        }
+        count -= chunk;
+    }
+    return true;
+}
+
 
 //----------------------------------------------------------------------------
-//  Look for MPEG packets in a buffer, according to an assumed packet size.
+//  Look for MPEG packets in a buffer, according to the allowed packet sizes.
 //----------------------------------------------------------------------------
 
-bool Resynchronizer::checkSync(const uint8_t* buf, size_t buf_size, size_t pkt_size, size_t header_size)
+bool Resynchronizer::findSync(const uint8_t* buf, size_t buf_size, size_t& start)
 {
-    assert(pkt_size >= header_size + ts::PKT_SIZE);
-    const uint8_t* end = buf + buf_size - pkt_size + 1;
-
-    // Check if the buffer contains packets with the appropriate size
-    while (buf < end) {
-        if (buf[header_size] != ts::SYNC_BYTE) {
-            return false; // not found
-        }
-        buf += pkt_size;
+    if (!_sync.findSync(buf, buf_size, start)) {
+        return false;
     }
-
-    // Packets found all along the buffer
-    _in_pkt_size = pkt_size;
-    _in_header_size = header_size;
-    _out_pkt_size = _keep_packet_size ? pkt_size : ts::PKT_SIZE;
-    _out_header_size = _keep_packet_size ? header_size : 0;
+    _in_pkt_size = _sync.packetSize();
+    _in_header_size = _sync.headerSize();
+    _out_pkt_size = _keep_packet_size ? _in_pkt_size : ts::PKT_SIZE;
+    _out_header_size = _keep_packet_size ? _in_header_size : 0;
     return true;
 }
 
@@ -311,7 +495,7 @@ int main(int argc, char *argv[])
     Options opt(argc, argv);
     ts::InputRedirector input(opt.infile, opt);
     ts::OutputRedirector output(opt.outfile, opt);
-    Resynchronizer resync(opt.keep);
+    Resynchronizer resync(opt);
 
     // Synchronization buffer
     ts::ByteBlock sync_buf_bb(opt.sync_size + opt.contig_size);
@@ -337,37 +521,17 @@ int main(int argc, char *argv[])
             prefix_fn = "next";
         }
 
-        // Look for a range of packets for at least --min-contiguous bytes
+        // Look for a range of packets for at least --min-contiguous bytes.
+        // Try all expected packet sizes.
         size_t const search_size = std::min(opt.contig_size, sync_size);
-        uint8_t* const end_search = sync_end - search_size + 1;
-
-        // Search a range of valid packets. Try all expected packet sizes.
-        const uint8_t* start;
-        for (start = sync_buf; start < end_search; start++) {
-            if (opt.packet_size > 0) {
-                if (resync.checkSync(start, search_size, opt.packet_size, opt.header_size)) {
-                    // Found user-specified encapsulation of TS packets
-                    break;
-                }
-            }
-            else {
-                if (resync.checkSync(start, search_size, ts::PKT_SIZE, 0)) {
-                    // Found standard TS packets
-                    break;
-                }
-                if (resync.checkSync(start, search_size, ts::PKT_RS_SIZE, 0)) {
-                    // Found TS packets with trailing Reed-Solomon outer FEC
-                    break;
-                }
-                if (resync.checkSync(start, search_size, ts::PKT_M2TS_SIZE, ts::M2TS_HEADER_SIZE)) {
-                    // Found TS packets with leading 4-byte timestamp (M2TS format, blu-ray discs)
-                    break;
-                }
-            }
-        }
+        size_t start_offset = 0;
+        resync.findSync(sync_buf, sync_size, start_offset);
+        const uint8_t* start = sync_buf + start_offset;
+
         if (resync.inputPacketSize() == 0) {
             std::cerr << "* Cannot find MPEG TS packets after " << ts::Decimal(search_size) << " bytes" << std::endl;
-            resync.setStatus (RS_ERROR);
+            // Trailing garbage at end of file is dropped, this is not an error when packets were found before.
+            resync.setStatus(read_size < sync_buf_size - sync_pre_size && resync.outputFileBytes() > 0 ? RS_EOF : RS_ERROR);
             break;
         }
         if (opt.verbose) {
@@ -380,13 +544,13 @@ int main(int argc, char *argv[])
         }
 
         // Output initial sync buffer, starting at first valid packet, writing all valid packets
-        while (start <= sync_end - resync.inputPacketSize() && start[resync.inputHeaderSize()] == ts::SYNC_BYTE) {
-            if (!resync.writePacket(start)) {
-                break;
-            }
-            start += resync.inputPacketSize();
+        const size_t pkt_size = resync.inputPacketSize();
+        const size_t header_size = resync.inputHeaderSize();
+        const uint8_t* first = start;
+        while (start <= sync_end - pkt_size && start[header_size] == ts::SYNC_BYTE) {
+            start += pkt_size;
         }
-        if (resync.status() != RS_OK) {
+        if (!resync.writePackets(first, (start - first) / pkt_size)) {
             break;
         }
 
@@ -400,30 +564,63 @@ int main(int argc, char *argv[])
         }
 
         // If more than one packet left, out of sync
-        if (sync_pre_size >= resync.inputPacketSize()) {
+        if (sync_pre_size >= pkt_size) {
             resync.setStatus(RS_SYNC_LOST);
         }
 
         // Read the rest of the input file
         while (resync.status() == RS_OK) {
-            assert(sync_pre_size < resync.inputPacketSize());
-            // Read the next packet
-            const size_t remain_size = resync.inputPacketSize() - sync_pre_size;
-            if (resync.readData(sync_buf + sync_pre_size, remain_size) != remain_size) {
-                resync.setStatus(RS_EOF);
+            assert(sync_pre_size < pkt_size);
+
+            if (sync_pre_size > 0) {
+                // Complete a partial packet in the sync buffer.
+                const size_t remain_size = pkt_size - sync_pre_size;
+                if (resync.readData(sync_buf + sync_pre_size, remain_size) != remain_size) {
+                    resync.setStatus(RS_EOF);
+                }
+                else if (sync_buf[header_size] == ts::SYNC_BYTE) {
+                    resync.writePackets(sync_buf, 1);
+                    sync_pre_size = 0;
+                }
+                else {
+                    // Will resynchronize with sync buffer pre-loaded
+                    sync_pre_size = pkt_size;
+                }
             }
-            else if (sync_buf[resync.inputHeaderSize()] != ts::SYNC_BYTE) {
+            else {
+                // Process all complete packets in the next contiguous input data.
+                size_t data_size = 0;
+                const uint8_t* const data = resync.peekData(data_size);
+                if (data_size == 0) {
+                    resync.setStatus(RS_EOF);
+                    break;
+                }
+                const uint8_t* const data_end = data + data_size - data_size % pkt_size;
+                const uint8_t* next = data;
+                while (next < data_end && next[header_size] == ts::SYNC_BYTE) {
+                    next += pkt_size;
+                }
+                const size_t count = (next - data) / pkt_size;
+                if (count > 0 && !resync.writePackets(data, count)) {
+                    break;
+                }
+                resync.consumeData(count * pkt_size);
+                if (next < data_end) {
+                    // Will resynchronize with sync buffer pre-loaded
+                    sync_pre_size = resync.readData(sync_buf, pkt_size);
+                }
+                else {
+                    // Keep partial packet at end of data
+                    sync_pre_size = resync.readData(sync_buf, data_size % pkt_size);
+                }
+            }
+
+            if (sync_pre_size == pkt_size) {
                 std::cerr << "*** Synchronization lost after "
                           << ts::Decimal(resync.outputFilePackets()) << " TS packets" << std::endl
-                          << ts::Format("*** Got 0x%02X instead of 0x%02X at start of TS packet", int(sync_buf[resync.inputHeaderSize()]), ts::SYNC_BYTE)
+                          << ts::Format("*** Got 0x%02X instead of 0x%02X at start of TS packet", int(sync_buf[header_size]), ts::SYNC_BYTE)
                           << std::endl;
                 resync.setStatus(RS_SYNC_LOST);
-                // Will resynchronize with sync buffer pre-loaded
-                sync_pre_size = resync.inputPacketSize();
-            }
-            else {
-                resync.writePacket(sync_buf);
-                sync_pre_size = 0;
             }
         }
 
@@ -34,6 +34,9 @@
 #include "tsArgs.h"
 #include "tsTSFileInputBuffered.h"
 #include "tsTSFileOutput.h"
+#include "tsThread.h"
+#include "tsGuard.h"
+#include "tsGuardCondition.h"
 #include "tsVariable.h"
 #include "tsDecimal.h"
 #include "tsFormat.h"
@@ -63,6 +66,7 @@ namespace {
         PacketCounter final_inter_packet;
         PacketCounter initial_inter_packet;
         bool          dts_based;
+        bool          restamp_pcr;
         bool          dyn_final_inter_packet;
         bool          dyn_initial_inter_packet;
         std::string   input_file;
@@ -80,6 +84,7 @@ namespace {
         final_inter_packet(0),
         initial_inter_packet(0),
         dts_based(false),
+        restamp_pcr(false),
         dyn_final_inter_packet(false),
         dyn_initial_inter_packet(false),
         input_file(),
@@ -95,6 +100,7 @@ namespace {
         option ("leading-packets",      'l', Args::UNSIGNED);
         option ("output-file",          'o', Args::STRING);
         option ("reference-pid",        'r', Args::PIDVAL);
+        option ("restamp-pcr",           0);
         option ("trailing-packets",     't', Args::UNSIGNED);
         option ("verbose",              'v');
 
@@ -151,6 +157,12 @@ namespace {
                  "      for the insertion of stuffing packets. By default, use the first PID\n"
                  "      containing the specified type of time stamps (PCR or DTS).\n"
                  "\n"
+                 "  --restamp-pcr\n"
+                 "      Restamp all PCR's in the output file according to their position in\n"
+                 "      the output constant bitrate. In each PID, the first PCR is unmodified\n"
+                 "      and is used as base for the subsequent ones. By default, the PCR's are\n"
+                 "      left unmodified.\n"
+                 "\n"
                  "  -t value\n"
                  "  --trailing-packets value\n"
                  "      Number of consecutive stuffing packets to add at the end of the\n"
@@ -180,6 +192,7 @@ namespace {
 
         buffer_size = intValue<size_t> ("buffer-size", DEFAULT_TS_BUFFER_SIZE);
         dts_based = present ("dts-based");
+        restamp_pcr = present ("restamp-pcr");
         reference_pid = intValue<ts::PID> ("reference-pid", PID_NULL);
         final_inter_packet = intValue<PacketCounter> ("final-inter-packet", 0);
         initial_inter_packet = intValue<PacketCounter> ("initial-inter-packet", 0);
@@ -207,7 +220,219 @@ namespace {
 
 
     //-------------------------------------------------------------------------
-    // This class processes the input file
+    // A chunk of packets, transferred between the processing threads.
+    //-------------------------------------------------------------------------
+
+    static const size_t READ_CHUNK_PACKETS  = 8192;  // Packets per input chunk (1.5 MB)
+    static const size_t WRITE_CHUNK_PACKETS = 8192;  // Packets per output chunk (1.5 MB)
+    static const size_t WRITE_CHUNK_COUNT   = 4;     // Number of output chunks
+
+    struct Chunk
+    {
+        TSPacketVector packets;  // Packet buffer
+        size_t         count;    // Number of valid packets in buffer
+        bool           eof;      // No more packets after this chunk
+
+        // Constructor
+        Chunk (size_t size = 0) : packets (size), count (0), eof (false) {}
+    };
+
+
+    //-------------------------------------------------------------------------
+    // A pool of chunks, passed from a producer thread to a consumer thread.
+    // Free chunks are obtained by the producer, filled and queued for the
+    // consumer which releases them after use. Aborting the pool makes all
+    // subsequent or pending waits return a null pointer.
+    //-------------------------------------------------------------------------
+
+    class ChunkPool
+    {
+    public:
+        // Constructor
+        ChunkPool (size_t chunk_count, size_t chunk_packets);
+
+        // Producer side: get a free chunk (wait if necessary), then queue it when filled.
+        Chunk* getFree();
+        void putFilled (Chunk*);
+
+        // Consumer side: get the next filled chunk (wait if necessary), then release it.
+        Chunk* getFilled();
+        void release (Chunk*);
+
+        // Abort all operations.
+        void abort();
+
+    private:
+        Mutex              _mutex;
+        Condition          _free_available;    // Signaled when a chunk is released.
+        Condition          _filled_available;  // Signaled when a chunk is filled.
+        std::vector<Chunk> _chunks;
+        std::deque<Chunk*> _free;
+        std::deque<Chunk*> _filled;
+        bool               _aborted;
+
+        // Inaccessible operations
+        ChunkPool (const ChunkPool&) = delete;
+        ChunkPool& operator= (const ChunkPool&) = delete;
+    };
+
+    ChunkPool::ChunkPool (size_t chunk_count, size_t chunk_packets) :
+        _mutex (),
+        _free_available (),
+        _filled_available (),
+        _chunks (chunk_count, Chunk (chunk_packets)),
+        _free (),
+        _filled (),
+        _aborted (false)
+    {
+        for (size_t i = 0; i < _chunks.size(); ++i) {
+            _free.push_back (&_chunks[i]);
+        }
+    }
+
+    Chunk* ChunkPool::getFree()
+    {
+        GuardCondition lock (_mutex, _free_available);
+        while (_free.empty() && !_aborted) {
+            lock.waitCondition();
+        }
+        if (_aborted) {
+            return 0;
+        }
+        Chunk* const chunk = _free.front();
+        _free.pop_front();
+        chunk->count = 0;
+        chunk->eof = false;
+        return chunk;
+    }
+
+    void ChunkPool::putFilled (Chunk* chunk)
+    {
+        GuardCondition lock (_mutex, _filled_available);
+        _filled.push_back (chunk);
+        lock.signal();
+    }
+
+    Chunk* ChunkPool::getFilled()
+    {
+        GuardCondition lock (_mutex, _filled_available);
+        while (_filled.empty() && !_aborted) {
+            lock.waitCondition();
+        }
+        if (_aborted) {
+            return 0;
+        }
+        Chunk* const chunk = _filled.front();
+        _filled.pop_front();
+        return chunk;
+    }
+
+    void ChunkPool::release (Chunk* chunk)
+    {
+        GuardCondition lock (_mutex, _free_available);
+        _free.push_back (chunk);
+        lock.signal();
+    }
+
+    void ChunkPool::abort()
+    {
+        Guard lock (_mutex);
+        _aborted = true;
+        _free_available.signal();
+        _filled_available.signal();
+    }
+
+
+    //-------------------------------------------------------------------------
+    // Reader thread: fill input chunks from the input file.
+    //-------------------------------------------------------------------------
+
+    class Reader: public Thread
+    {
+    public:
+        // Constructor, the thread is not started.
+        Reader (Options& opt, TSFileInput& input, ChunkPool& pool) :
+            Thread (),
+            _opt (opt),
+            _input (input),
+            _pool (pool)
+        {
+        }
+
+    private:
+        Options&     _opt;
+        TSFileInput& _input;
+        ChunkPool&   _pool;
+
+        // Thread main code. TSFileInput::read() returns less than requested
+        // at end of file or on error only, both cases terminate the input.
+        virtual void main()
+        {
+            Chunk* chunk = 0;
+            do {
+                if ((chunk = _pool.getFree()) == 0) {
+                    break;
+                }
+                chunk->count = _input.read (&chunk->packets[0], chunk->packets.size(), _opt);
+                chunk->eof = chunk->count < chunk->packets.size();
+                _pool.putFilled (chunk);
+            } while (!chunk->eof);
+        }
+
+        // Inaccessible operations
+        Reader (const Reader&) = delete;
+        Reader& operator= (const Reader&) = delete;
+    };
+
+
+    //-------------------------------------------------------------------------
+    // Writer thread: write output chunks into the output file.
+    //-------------------------------------------------------------------------
+
+    class Writer: public Thread
+    {
+    public:
+        // Constructor, the thread is not started.
+        Writer (Options& opt, TSFileOutput& output, ChunkPool& pool) :
+            Thread (),
+            _opt (opt),
+            _output (output),
+            _pool (pool)
+        {
+        }
+
+    private:
+        Options&      _opt;
+        TSFileOutput& _output;
+        ChunkPool&    _pool;
+
+        // Thread main code. On write error, abort the pool to notify the main thread.
+        virtual void main()
+        {
+            Chunk* chunk = 0;
+            bool eof = false;
+            while (!eof && (chunk = _pool.getFilled()) != 0) {
+                eof = chunk->eof;
+                if (chunk->count > 0 && !_output.write (&chunk->packets[0], chunk->count, _opt)) {
+                    _pool.abort();
+                    break;
+                }
+                _pool.release (chunk);
+            }
+        }
+
+        // Inaccessible operations
+        Writer (const Writer&) = delete;
+        Writer& operator= (const Writer&) = delete;
+    };
+
+
+    //-------------------------------------------------------------------------
+    // This class processes the input file.
+    // The input file is read by a reader thread and the output file is written
+    // by a writer thread, using large chunks of packets. The main thread keeps
+    // a window of input chunks from the current position, looks ahead for the
+    // next time stamp in this window and assembles output chunks.
     //-------------------------------------------------------------------------
 
     class Stuffer
@@ -221,10 +446,32 @@ namespace {
         void stuff();
 
     private:
+        // First PCR in a PID, base for restamping.
+        struct PCRBase
+        {
+            uint64_t      pcr;     // PCR value
+            PacketCounter packet;  // Packet index in output file
+            PCRBase (uint64_t c = 0, PacketCounter p = 0) : pcr (c), packet (p) {}
+        };
+        typedef std::map<PID, PCRBase> PCRBaseMap;
+
         // Private members
         Options&            _opt;
-        TSFileInputBuffered _input;
+        TSFileInput         _input;
         TSFileOutput        _output;
+        const size_t        _window_size;       // Max lookahead in input packets
+        ChunkPool           _in_pool;
+        ChunkPool           _out_pool;
+        Reader              _reader;
+        Writer              _writer;
+        std::deque<Chunk*>  _in_chunks;         // Input window
+        PacketCounter       _in_first;          // Index of first packet in input window
+        PacketCounter       _in_end;            // Index after last packet in input window
+        bool                _in_eof;            // Last input chunk in window
+        PacketCounter       _position;          // Index of next input packet to write
+        Chunk*              _out_chunk;         // Output chunk being filled
+        PacketCounter       _out_count;         // Number of output packets
+        PCRBaseMap          _pcr_bases;         // Per-PID base for PCR restamping
         PacketCounter       _current_inter_packet;
         PacketCounter       _remaining_stuff_count;
         PacketCounter       _additional_bits;
@@ -240,9 +487,22 @@ namespace {
         // Check if a packet contains a time stamp.
         bool getTimeStamp (const TSPacket& pkt, uint64_t& tstamp) const;
 
+        // Get an input packet by index, load input chunks when necessary.
+        // Return zero after end of input.
+        const TSPacket* inputPacket (PacketCounter index);
+
+        // Release input chunks before current position.
+        void releaseInput();
+
         // Evaluate stuffing need in next segment, between two time stamps.
         void evaluateNextStuffing();
 
+        // Make sure the current output chunk has free space.
+        void nextOutputChunk();
+
+        // Write the next input packet.
+        void writeInputPacket (const TSPacket& pkt);
+
         // Write the specified number of stuffing packets
         void writeStuffing (PacketCounter stuffing_packet_count);
 
@@ -257,8 +517,21 @@ namespace {
 
     Stuffer::Stuffer(Options& opt) :
         _opt(opt),
-        _input(opt.buffer_size / PKT_SIZE),
+        _input(),
         _output(),
+        _window_size(std::max<size_t>(opt.buffer_size / PKT_SIZE, TSFileInputBuffered::MIN_BUFFER_SIZE)),
+        _in_pool(_window_size / READ_CHUNK_PACKETS + 4, READ_CHUNK_PACKETS),
+        _out_pool(WRITE_CHUNK_COUNT, WRITE_CHUNK_PACKETS),
+        _reader(opt, _input, _in_pool),
+        _writer(opt, _output, _out_pool),
+        _in_chunks(),
+        _in_first(0),
+        _in_end(0),
+        _in_eof(false),
+        _position(0),
+        _out_chunk(0),
+        _out_count(0),
+        _pcr_bases(),
         _current_inter_packet(0),
         _remaining_stuff_count(0),
         _additional_bits(0),
@@ -301,6 +574,95 @@ namespace {
     }
 
 
+    //-------------------------------------------------------------------------
+    // Get an input packet by index, load input chunks when necessary.
+    //-------------------------------------------------------------------------
+
+    const TSPacket* Stuffer::inputPacket (PacketCounter index)
+    {
+        assert (index >= _in_first);
+
+        // Get input chunks from the reader thread until the packet is in the window.
+        while (index >= _in_end && !_in_eof) {
+            Chunk* const chunk = _in_pool.getFilled();
+            assert (chunk != 0);
+            _in_chunks.push_back (chunk);
+            _in_end += chunk->count;
+            _in_eof = chunk->eof;
+        }
+        if (index >= _in_end) {
+            return 0;
+        }
+
+        // All chunks but the last one are full.
+        const PacketCounter rel = index - _in_first;
+        return &_in_chunks[size_t (rel / READ_CHUNK_PACKETS)]->packets[size_t (rel % READ_CHUNK_PACKETS)];
+    }
+
+
+    //-------------------------------------------------------------------------
+    // Release input chunks before current position.
+    //-------------------------------------------------------------------------
+
+    void Stuffer::releaseInput()
+    {
+        while (!_in_chunks.empty() && !_in_chunks.front()->eof && _in_first + READ_CHUNK_PACKETS <= _position) {
+            _in_pool.release (_in_chunks.front());
+            _in_chunks.pop_front();
+            _in_first += READ_CHUNK_PACKETS;
+        }
+    }
+
+
+    //-------------------------------------------------------------------------
+    // Make sure the current output chunk has free space.
+    //-------------------------------------------------------------------------
+
+    void Stuffer::nextOutputChunk()
+    {
+        if (_out_chunk != 0 && _out_chunk->count >= _out_chunk->packets.size()) {
+            _out_pool.putFilled (_out_chunk);
+            _out_chunk = 0;
+        }
+        // A null chunk means that the pool was aborted on write error.
+        if (_out_chunk == 0 && (_out_chunk = _out_pool.getFree()) == 0) {
+            fatalError();
+        }
+    }
+
+
+    //-------------------------------------------------------------------------
+    // Write the next input packet.
+    //-------------------------------------------------------------------------
+
+    void Stuffer::writeInputPacket (const TSPacket& pkt)
+    {
+        nextOutputChunk();
+        TSPacket& out (_out_chunk->packets[_out_chunk->count++]);
+        out = pkt;
+
+        // Restamp PCR according to the position in the output constant bitrate.
+        if (_opt.restamp_pcr && out.hasPCR()) {
+            const PID pid = out.getPID();
+            const PCRBaseMap::const_iterator it = _pcr_bases.find (pid);
+            if (it == _pcr_bases.end()) {
+                // First PCR in this PID, keep it as base.
+                _pcr_bases[pid] = PCRBase (out.getPCR(), _out_count);
+            }
+            else {
+                // Distance from the first PCR in the PID, computed in two steps to avoid overflow.
+                const uint64_t bits = (_out_count - it->second.packet) * PKT_SIZE * 8;
+                const uint64_t delta = (bits / _opt.target_bitrate) * SYSTEM_CLOCK_FREQ +
+                    ((bits % _opt.target_bitrate) * SYSTEM_CLOCK_FREQ) / _opt.target_bitrate;
+                out.setPCR ((it->second.pcr + delta) % (PTS_DTS_SCALE * SYSTEM_CLOCK_SUBFACTOR));
+            }
+        }
+
+        _out_count++;
+        _position++;
+    }
+
+
     //-------------------------------------------------------------------------
     // Write the specified number of stuffing packets
     //-------------------------------------------------------------------------
@@ -308,10 +670,12 @@ namespace {
     void Stuffer::writeStuffing (PacketCounter count)
     {
         while (count > 0) {
-            if (!_output.write (&NullPacket, 1, _opt)) {
-                fatalError();
-            }
-            count--;
+            nextOutputChunk();
+            const size_t n = size_t (std::min<PacketCounter> (count, _out_chunk->packets.size() - _out_chunk->count));
+            std::fill_n (_out_chunk->packets.begin() + _out_chunk->count, n, NullPacket);
+            _out_chunk->count += n;
+            _out_count += n;
+            count -= n;
         }
     }
 
@@ -322,14 +686,13 @@ namespace {
 
     void Stuffer::simpleInterPacketStuffing (PacketCounter inter_packet, PacketCounter end_packet)
     {
-        assert (_input.getPacketCount() < end_packet);
+        assert (_position < end_packet);
 
-        TSPacket pkt;
-        while (_input.getPacketCount() < end_packet && _input.read (&pkt, 1, _opt) == 1) {
-            if (!_output.write (&pkt, 1, _opt)) {
-                fatalError();
-            }
+        const TSPacket* pkt = 0;
+        while (_position < end_packet && (pkt = inputPacket (_position)) != 0) {
+            writeInputPacket (*pkt);
             writeStuffing (inter_packet);
+            releaseInput();
         }
     }
 
@@ -340,29 +703,34 @@ namespace {
 
     void Stuffer::evaluateNextStuffing()
     {
-        // Save initial position in the file
-        const PacketCounter initial_position = _input.getPacketCount();
+        // Initial position in the file
+        const PacketCounter initial_position = _position;
         _opt.debug ("evaluateNextStuffing: initial_position = " + Decimal (initial_position));
 
         // Initialize new search. Note that _tstamp1 and _tstamp2 may be unset.
         _tstamp1 = _tstamp2;
         _tstamp2.reset();
 
-        // Read packets until both _tstamp1 and _tstamp2 are set (or end of file)
+        // Look ahead until both _tstamp1 and _tstamp2 are set (or end of file).
+        // The lookahead is limited to the buffer size, plus one packet, as with
+        // the former seekable input buffer.
+        const PacketCounter max_position = initial_position + _window_size;
+        PacketCounter position = initial_position;
+        const TSPacket* pkt = 0;
         uint64_t tstamp;
-        TSPacket pkt;
-        while (!_tstamp2.set() && _input.canSeek (initial_position) && _input.read (&pkt, 1, _opt) == 1) {
-            if (getTimeStamp (pkt, tstamp)) {
+        while (!_tstamp2.set() && position <= max_position && (pkt = inputPacket (position)) != 0) {
+            position++;
+            if (getTimeStamp (*pkt, tstamp)) {
                 if (_opt.reference_pid == PID_NULL) {
                     // Found the first time stamp, use this PID as reference
-                    _opt.reference_pid = pkt.getPID();
+                    _opt.reference_pid = pkt->getPID();
                     _opt.verbose ("using PID %d (0x%04X) as reference", int (_opt.reference_pid), int (_opt.reference_pid));
                 }
-                else if (_opt.reference_pid != pkt.getPID()) {
+                else if (_opt.reference_pid != pkt->getPID()) {
                     // Not the reference PID, skip;
                     continue;
                 }
-                const TimeStamp time_stamp (tstamp, _input.getPacketCount());
+                const TimeStamp time_stamp (tstamp, position);
                 if (!_tstamp1.set() || tstamp <= _tstamp1.value().tstamp) {
                     // 1) Found the first time stamp in the file.
                     // 2) Or found a time stamp lower than tstamp1, may be because of a
@@ -378,8 +746,8 @@ namespace {
             }
         }
 
-        // If _tstamp2 not set in first segment or after buffer full, we cannot perform bitrate evaluation
-        if (!_tstamp2.set() && (initial_position == 0 || !_input.canSeek (initial_position))) {
+        // If _tstamp2 not set in first segment or beyond buffer size, we cannot perform bitrate evaluation
+        if ((!_tstamp2.set() && initial_position == 0) || position > max_position) {
             std::string msg ("no " + getTimeStampType() + " found");
             if (initial_position > 0) {
                 msg += " after packet ";
@@ -394,11 +762,6 @@ namespace {
             _opt.fatal (msg);
         }
 
-        // Restore initial position in the file
-        if (!_input.seekBackward (size_t (_input.getPacketCount() - initial_position), _opt)) {
-            fatalError();
-        }
-
         // If _tstamp2 is not set, we reached the end of file, keep previous settings.
         // Otherwise, compute new settings.
         if (_tstamp2.set()) {
@@ -438,12 +801,13 @@ namespace {
 
     void Stuffer::stuff()
     {
-        // Open input file
+        // Open input file and start reading
         if (!_input.open (_opt.input_file, 1, 0, _opt)) {
             fatalError();
         }
+        _reader.start();
 
-        _opt.debug ("input file buffer size: " + Decimal (_input.getBufferSize()) + " packets");
+        _opt.debug ("input file buffer size: " + Decimal (_window_size) + " packets");
 
         // Remaining number of bits to stuff representing less than one packet
         _additional_bits = 0;
@@ -455,10 +819,11 @@ namespace {
         assert (_tstamp1.set());
         assert (_tstamp2.set());
 
-        // Create output file
+        // Create output file and start writing
         if (!_output.open (_opt.output_file, false, false, _opt)) {
             fatalError();
         }
+        _writer.start();
 
         // Write leading stuffing packets
         writeStuffing (_opt.leading_packets);
@@ -469,20 +834,18 @@ namespace {
 
         // Perform stuffing, segment after segment
         while (_tstamp2.set()) {
-            assert (_input.getPacketCount() < _tstamp2.value().packet);
+            assert (_position < _tstamp2.value().packet);
 
-            // Perform stuffing on current segment.
-            TSPacket pkt;
-            while (_input.getPacketCount() < _tstamp2.value().packet && _input.read (&pkt, 1, _opt) == 1) {
-                if (!_output.write (&pkt, 1, _opt)) {
-                    fatalError();
-                }
+            // Perform stuffing on current segment. All packets are in the input window.
+            while (_position < _tstamp2.value().packet) {
+                writeInputPacket (*inputPacket (_position));
                 const PacketCounter count = std::min (_current_inter_packet, _remaining_stuff_count);
                 writeStuffing (count);
                 _remaining_stuff_count -= count;
             }
             writeStuffing (_remaining_stuff_count);
             _remaining_stuff_count = 0;
+            releaseInput();
 
             // Evaluate stuffing need for next segment
             evaluateNextStuffing();
@@ -493,9 +856,22 @@ namespace {
                                    std::numeric_limits<PacketCounter>::max());
 
         // Write trailing stuffing packets
-        writeStuffing (_opt.leading_packets);
+        writeStuffing (_opt.trailing_packets);
+
+        // Flush last output chunk and wait for the threads to complete.
+        nextOutputChunk();
+        _out_chunk->eof = true;
+        _out_pool.putFilled (_out_chunk);
+        _out_chunk = 0;
+        _writer.waitForTermination();
+        _reader.waitForTermination();
+
+        // Check that the last output chunk was written.
+        if (_out_pool.getFree() == 0) {
+            fatalError();
+        }
 
-        _opt.verbose ("stuffing completed, read " + Decimal (_input.getPacketCount()) +
+        _opt.verbose ("stuffing completed, read " + Decimal (_in_end) +
                       " packet, written " + Decimal (_output.getPacketCount()) + " packets");
 
         // Close files
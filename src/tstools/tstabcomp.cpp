@@ -57,6 +57,7 @@ struct Options: public ts::Args
     bool                  compile;         // Explicit compilation.
     bool                  decompile;       // Explicit decompilation.
     bool                  xmlModel;        // Display XML model instead of compilation.
+    size_t                threads;         // Number of compilation threads.
     const ts::DVBCharset* defaultCharset;  // Default DVB character set to interpret strings.
 
 private:
@@ -73,6 +74,7 @@ Options::Options(int argc, char *argv[]) :
     compile(false),
     decompile(false),
     xmlModel(false),
+    threads(1),
     defaultCharset(0)
 {
     option("",                0,  ts::Args::STRING);
@@ -80,6 +82,7 @@ Options::Options(int argc, char *argv[]) :
     option("decompile",      'd');
     option("default-charset", 0, Args::STRING);
     option("output",         'o', ts::Args::STRING);
+    option("threads",        't', ts::Args::INTEGER, 0, 1, 1, 256);
     option("verbose",        'v');
     option("xml-model",      'x');
 
@@ -127,6 +130,14 @@ Options::Options(int argc, char *argv[]) :
             "      directory and default file name. If more than one input file is specified,\n"
             "      the output path, if present, must be a directory name.\n"
             "\n"
+            "  -t value\n"
+            "  --threads value\n"
+            "      With --compile, use the specified number of threads to convert the XML\n"
+            "      tables into binary tables. This speeds up the compilation of large files\n"
+            "      with many tables, such as EPG files. The binary tables and the error\n"
+            "      messages are always produced in the order of the XML file. The default\n"
+            "      is one thread.\n"
+            "\n"
             "  -v\n"
             "  --verbose\n"
             "      Produce verbose output.\n"
@@ -148,6 +159,7 @@ Options::Options(int argc, char *argv[]) :
     compile = present("compile");
     decompile = present("decompile");
     xmlModel = present("xml-model");
+    threads = intValue<size_t>("threads", 1);
     outdir = !outfile.empty() && ts::IsDirectory(outfile);
 
     if (present("verbose")) {
@@ -220,6 +232,7 @@ bool CompileXML(Options& opt, const std::string& infile, const std::string& outf
 
     // Load XML file, convert tables to binary and save binary file.
     ts::XMLTables xml;
+    xml.setMaxThreads(opt.threads);
     return xml.loadXML(infile, report, opt.defaultCharset) && ts::BinaryTable::SaveFile(xml.tables(), outfile, report);
 }
 
@@ -97,6 +97,9 @@ int main(int argc, char *argv[])
         logger.feedPacket(pkt);
     }
 
+    // Wait for all tables to be processed.
+    logger.close();
+
     // Report errors
     if (opt.verbose() && !logger.hasErrors()) {
         logger.reportDemuxErrors(std::cerr);
@@ -0,0 +1,177 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Benchmark: contention on ts::BoundedMessageQueue compared with
+//  ts::MessageQueue, with several producer threads and one consumer.
+//
+//----------------------------------------------------------------------------
+
+#include "tsArgs.h"
+#include "tsBoundedMessageQueue.h"
+#include "tsMessageQueue.h"
+#include "tsThread.h"
+#include "benchUtils.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+//  Command line options
+//----------------------------------------------------------------------------
+
+struct Options: public ts::Args
+{
+    Options(int argc, char *argv[]);
+
+    int                 total;      // Total number of messages per run
+    size_t              capacity;   // Maximum number of messages in the queues
+    std::vector<size_t> producers;  // Numbers of producer threads, one run each
+};
+
+Options::Options(int argc, char *argv[]) :
+    ts::Args("Benchmark the contention on message queues.", "[options]"),
+    total(0),
+    capacity(0),
+    producers()
+{
+    option("capacity",  'c', Args::POSITIVE);
+    option("messages",  'm', Args::INTEGER, 0, 1, 1, 0x7FFFFFFF);
+    option("producers", 'p', Args::INTEGER, 0, Args::UNLIMITED_COUNT, 1, 0xFFFF);
+
+    setHelp("Options:\n"
+            "\n"
+            "  -c value\n"
+            "  --capacity value\n"
+            "      Maximum number of messages in the queues. The default is 256.\n"
+            "\n"
+            "  --help\n"
+            "      Display this help text.\n"
+            "\n"
+            "  -m value\n"
+            "  --messages value\n"
+            "      Total number of messages in each run, shared by all producers.\n"
+            "      The default is 256000.\n"
+            "\n"
+            "  -p value\n"
+            "  --producers value\n"
+            "      Number of producer threads. Several options can be specified, one run\n"
+            "      is performed for each of them. The default is 1, 4 and 16.\n"
+            "\n"
+            "  --version\n"
+            "      Display the version number.\n");
+
+    analyze(argc, argv);
+
+    total = intValue<int>("messages", 256000);
+    capacity = intValue<size_t>("capacity", 256);
+    getIntValues(producers, "producers");
+    if (producers.empty()) {
+        producers.push_back(1);
+        producers.push_back(4);
+        producers.push_back(16);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+//  Producer thread and one run of producers and one consumer.
+//----------------------------------------------------------------------------
+
+namespace {
+    template <class QUEUE>
+    class ProducerThread: public ts::Thread
+    {
+    private:
+        QUEUE& _queue;
+        int    _count;
+    public:
+        ProducerThread(QUEUE& queue, int count) :
+            Thread(),
+            _queue(queue),
+            _count(count)
+        {
+        }
+
+        virtual ~ProducerThread()
+        {
+            waitForTermination();
+        }
+
+        virtual void main()
+        {
+            for (int i = 0; i < _count; ++i) {
+                _queue.enqueue(new int(i));
+            }
+        }
+    };
+
+    // Return the duration of the run in nanoseconds.
+    template <class QUEUE>
+    ts::NanoSecond RunProducers(size_t capacity, size_t producers, int count)
+    {
+        QUEUE queue(capacity);
+        std::vector<ProducerThread<QUEUE>*> threads;
+        bench::Chrono chrono;
+        for (size_t p = 0; p < producers; ++p) {
+            threads.push_back(new ProducerThread<QUEUE>(queue, count));
+            threads.back()->start();
+        }
+        typename QUEUE::MessagePtr message;
+        for (size_t i = 0; i < producers * size_t(count); ++i) {
+            queue.dequeue(message);
+        }
+        const ts::NanoSecond duration = chrono.elapsed();
+        for (size_t p = 0; p < threads.size(); ++p) {
+            delete threads[p];
+        }
+        return duration;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+//  Program entry point
+//----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    Options opt(argc, argv);
+
+    for (size_t i = 0; i < opt.producers.size(); ++i) {
+        const size_t producers = opt.producers[i];
+        const int count = opt.total / int(producers);
+        const uint64_t messages = uint64_t(count) * producers;
+        const ts::NanoSecond list_time = RunProducers<ts::MessageQueue<int>>(opt.capacity, producers, count);
+        const ts::NanoSecond bounded_time = RunProducers<ts::BoundedMessageQueue<int>>(opt.capacity, producers, count);
+        std::cout << producers << " producers, " << messages << " messages, capacity " << opt.capacity << std::endl
+                  << "  MessageQueue:        " << bench::Rate(messages, list_time, "msg") << std::endl
+                  << "  BoundedMessageQueue: " << bench::Rate(messages, bounded_time, "msg") << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
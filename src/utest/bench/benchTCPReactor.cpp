@@ -0,0 +1,253 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Benchmark: connections and messages per second on a TCP reactor, over
+//  the loopback interface.
+//
+//----------------------------------------------------------------------------
+
+#include "tsArgs.h"
+#include "tsTCPReactor.h"
+#include "tsThread.h"
+#include "tsNullReport.h"
+#include "tsCerrReport.h"
+#include "benchUtils.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+//  Command line options
+//----------------------------------------------------------------------------
+
+struct Options: public ts::Args
+{
+    Options(int argc, char *argv[]);
+
+    uint16_t port;         // TCP port of the reactor server
+    size_t   connections;  // Number of successive connections
+    size_t   messages;     // Number of messages on one connection
+    size_t   size;         // Message size in bytes
+    size_t   window;       // Number of messages in flight
+};
+
+Options::Options(int argc, char *argv[]) :
+    ts::Args("Benchmark a TCP reactor over the loopback interface.", "[options]"),
+    port(0),
+    connections(0),
+    messages(0),
+    size(0),
+    window(0)
+{
+    option("connections", 'c', Args::POSITIVE);
+    option("messages",    'm', Args::POSITIVE);
+    option("port",        'p', Args::UINT16);
+    option("size",        's', Args::INTEGER, 0, 1, 1, 65536);
+    option("window",      'w', Args::POSITIVE);
+
+    setHelp("Options:\n"
+            "\n"
+            "  -c value\n"
+            "  --connections value\n"
+            "      Number of successive connections, each one with one round trip.\n"
+            "      The default is 1000.\n"
+            "\n"
+            "  --help\n"
+            "      Display this help text.\n"
+            "\n"
+            "  -m value\n"
+            "  --messages value\n"
+            "      Number of messages which are echoed on one connection. The default\n"
+            "      is 100000.\n"
+            "\n"
+            "  -p value\n"
+            "  --port value\n"
+            "      TCP port of the reactor server on the loopback interface. The default\n"
+            "      is 12360.\n"
+            "\n"
+            "  -s value\n"
+            "  --size value\n"
+            "      Size in bytes of each message. The default is 64.\n"
+            "\n"
+            "  --version\n"
+            "      Display the version number.\n"
+            "\n"
+            "  -w value\n"
+            "  --window value\n"
+            "      Number of messages in flight on the connection. The default is 100.\n");
+
+    analyze(argc, argv);
+
+    port = intValue<uint16_t>("port", 12360);
+    connections = intValue<size_t>("connections", 1000);
+    messages = intValue<size_t>("messages", 100000);
+    size = intValue<size_t>("size", 64);
+    window = intValue<size_t>("window", 100);
+}
+
+
+//----------------------------------------------------------------------------
+//  A thread running a reactor with one echo server.
+//----------------------------------------------------------------------------
+
+namespace {
+    class EchoServer: public ts::Thread, private ts::TCPReactorHandlerInterface
+    {
+    public:
+        EchoServer() : _server(), _reactor() {}
+
+        ~EchoServer()
+        {
+            _reactor.stop();
+            waitForTermination();
+            _reactor.close(NULLREP);
+            _server.close(NULLREP);
+        }
+
+        bool open(uint16_t port, ts::ReportInterface& report)
+        {
+            const ts::SocketAddress address(ts::IPAddress::LocalHost, port);
+            return _server.open(report) &&
+                _server.reusePort(true, report) &&
+                _server.bind(address, report) &&
+                _server.listen(50, report) &&
+                _reactor.open(report) &&
+                _reactor.addServer(_server, this, report);
+        }
+
+    private:
+        ts::TCPServer  _server;
+        ts::TCPReactor _reactor;
+
+        virtual void main() override
+        {
+            _reactor.run(CERR);
+        }
+        virtual void handleConnected(ts::TCPReactor& reactor, ts::TCPConnection& connection) override
+        {
+        }
+        virtual size_t handleReceived(ts::TCPReactor& reactor, ts::TCPConnection& connection, const uint8_t* data, size_t size) override
+        {
+            reactor.send(connection, data, size, CERR);
+            return size;
+        }
+        virtual void handleDisconnected(ts::TCPReactor& reactor, ts::TCPConnection& connection) override
+        {
+        }
+    };
+
+    // Connect a client to the local server.
+    bool Connect(ts::TCPConnection& client, uint16_t port, ts::ReportInterface& report)
+    {
+        return client.open(report) &&
+            client.bind(ts::SocketAddress(ts::IPAddress::LocalHost, ts::SocketAddress::AnyPort), report) &&
+            client.connect(ts::SocketAddress(ts::IPAddress::LocalHost, port), report);
+    }
+
+    // Disconnect a client.
+    void Disconnect(ts::TCPConnection& client)
+    {
+        client.disconnect(NULLREP);
+        client.close(NULLREP);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+//  Program entry point
+//----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    Options opt(argc, argv);
+
+#if defined(__windows)
+
+    opt.error("TCP reactors are not supported on Windows");
+    return EXIT_FAILURE;
+
+#else
+
+    EchoServer server;
+    if (!server.open(opt.port, opt) || !server.start()) {
+        return EXIT_FAILURE;
+    }
+
+    ts::ByteBlock out(opt.size, 0x47);
+    ts::ByteBlock in(opt.size);
+
+    // Connection rate: connect, one round trip, disconnect.
+    bench::Chrono chrono;
+    for (size_t i = 0; i < opt.connections; ++i) {
+        ts::TCPConnection client;
+        if (!Connect(client, opt.port, opt) ||
+            !client.send(out.data(), out.size(), opt) ||
+            !client.receive(in.data(), in.size(), 0, opt))
+        {
+            return EXIT_FAILURE;
+        }
+        Disconnect(client);
+    }
+    const ts::NanoSecond time1 = chrono.elapsed();
+
+    // Message rate: pipelined messages on one connection, a window of messages in flight.
+    ts::TCPConnection client;
+    if (!Connect(client, opt.port, opt)) {
+        return EXIT_FAILURE;
+    }
+    chrono.restart();
+    for (size_t i = 0; i < opt.messages; i += opt.window) {
+        const size_t count = std::min(opt.window, opt.messages - i);
+        for (size_t j = 0; j < count; ++j) {
+            if (!client.send(out.data(), out.size(), opt)) {
+                return EXIT_FAILURE;
+            }
+        }
+        for (size_t j = 0; j < count; ++j) {
+            if (!client.receive(in.data(), in.size(), 0, opt)) {
+                return EXIT_FAILURE;
+            }
+        }
+    }
+    const ts::NanoSecond time2 = chrono.elapsed();
+    Disconnect(client);
+
+    if (in != out) {
+        opt.error("invalid echoed data");
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "connections: " << opt.connections << ", one round trip of " << opt.size << " bytes each: "
+              << bench::Rate(opt.connections, time1, "connection") << std::endl
+              << "messages: " << opt.messages << " of " << opt.size << " bytes, " << opt.window << " in flight: "
+              << bench::Rate(opt.messages, time2, "msg") << std::endl;
+
+    return EXIT_SUCCESS;
+
+#endif
+}
@@ -0,0 +1,179 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Benchmark: TLV message analysis, new factory per message compared with
+//  a reused factory.
+//
+//----------------------------------------------------------------------------
+
+#include "tsArgs.h"
+#include "tstlvSerializer.h"
+#include "tstlvMessageFactory.h"
+#include "tsECMGSCS.h"
+#include "tsEMMGMUX.h"
+#include "benchUtils.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+//  Command line options
+//----------------------------------------------------------------------------
+
+struct Options: public ts::Args
+{
+    Options(int argc, char *argv[]);
+
+    size_t loops;  // Number of ECM_response + data_provision pairs
+};
+
+Options::Options(int argc, char *argv[]) :
+    ts::Args("Benchmark the analysis of ECMG <=> SCS and EMMG <=> MUX messages.", "[options]"),
+    loops(0)
+{
+    option("loops", 'l', Args::POSITIVE);
+
+    setHelp("Options:\n"
+            "\n"
+            "  --help\n"
+            "      Display this help text.\n"
+            "\n"
+            "  -l value\n"
+            "  --loops value\n"
+            "      Number of message pairs (ECM_response + data_provision) to serialize and\n"
+            "      analyze. The default is 100000.\n"
+            "\n"
+            "  --version\n"
+            "      Display the version number.\n");
+
+    analyze(argc, argv);
+
+    loops = intValue<size_t>("loops", 100000);
+}
+
+
+//----------------------------------------------------------------------------
+//  Program entry point
+//----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    Options opt(argc, argv);
+
+    const ts::tlv::Protocol* const ecmg = ts::ecmgscs::Protocol::Instance();
+    const ts::tlv::Protocol* const emmg = ts::emmgmux::Protocol::Instance();
+
+    // Typical messages: ECM_response with a 4-packet ECM, data_provision with 4 EMM packets.
+    ts::ecmgscs::ECMResponse ecm_msg;
+    ecm_msg.channel_id = 1;
+    ecm_msg.stream_id = 2;
+    ecm_msg.CP_number = 3;
+    ecm_msg.ECM_datagram.resize(4 * 188);
+    for (size_t i = 0; i < ecm_msg.ECM_datagram.size(); ++i) {
+        ecm_msg.ECM_datagram[i] = uint8_t(i);
+    }
+    ts::emmgmux::DataProvision emm_msg;
+    emm_msg.channel_id = 1;
+    emm_msg.stream_id = 2;
+    emm_msg.client_id = 3;
+    emm_msg.data_id = 4;
+    for (uint8_t i = 0; i < 4; ++i) {
+        emm_msg.datagram.push_back(new ts::ByteBlock(188, i));
+    }
+
+    // Allocating path: new serialization buffer, new factory and new message object per message.
+    size_t check1 = 0;
+    bench::Chrono chrono;
+    for (size_t loop = 0; loop < opt.loops; ++loop) {
+        ts::tlv::MessagePtr gen;
+        {
+            ts::ByteBlockPtr bb(new ts::ByteBlock);
+            ts::tlv::Serializer zer(bb);
+            ecm_msg.serialize(zer);
+            ts::tlv::MessageFactory mf(*bb, ecmg);
+            mf.factory(gen);
+            check1 += dynamic_cast<ts::ecmgscs::ECMResponse*>(gen.pointer())->ECM_datagram.size();
+        }
+        {
+            ts::ByteBlockPtr bb(new ts::ByteBlock);
+            ts::tlv::Serializer zer(bb);
+            emm_msg.serialize(zer);
+            ts::tlv::MessageFactory mf(*bb, emmg);
+            mf.factory(gen);
+            check1 += dynamic_cast<ts::emmgmux::DataProvision*>(gen.pointer())->datagram.size();
+        }
+    }
+    const ts::NanoSecond time1 = chrono.elapsed();
+
+    // Reusing path: same buffers and factories, decoding into caller-owned fields.
+    size_t check2 = 0;
+    ts::ByteBlockPtr ecm_bb(new ts::ByteBlock);
+    ts::ByteBlockPtr emm_bb(new ts::ByteBlock);
+    ts::tlv::MessageFactory ecm_mf(ecmg);
+    ts::tlv::MessageFactory emm_mf(emmg);
+    ts::ByteBlock ecm;
+    std::vector<ts::tlv::MessageFactory::Parameter> emm;
+    chrono.restart();
+    for (size_t loop = 0; loop < opt.loops; ++loop) {
+        ecm_bb->clear();
+        {
+            ts::tlv::Serializer zer(ecm_bb);
+            ecm_msg.serialize(zer);
+        }
+        if (!ecm_mf.analyze(ecm_bb->data(), ecm_bb->size())) {
+            opt.error("invalid ECM_response");
+            return EXIT_FAILURE;
+        }
+        ecm_mf.get(ts::ecmgscs::Tags::ECM_datagram, ecm);
+        check2 += ecm.size();
+        emm_bb->clear();
+        {
+            ts::tlv::Serializer zer(emm_bb);
+            emm_msg.serialize(zer);
+        }
+        if (!emm_mf.analyze(emm_bb->data(), emm_bb->size())) {
+            opt.error("invalid data_provision");
+            return EXIT_FAILURE;
+        }
+        emm_mf.get(ts::emmgmux::Tags::datagram, emm);
+        check2 += emm.size();
+    }
+    const ts::NanoSecond time2 = chrono.elapsed();
+
+    if (check1 != check2) {
+        opt.error("different decoded data sizes, allocating: %" FMT_SIZE_T "u, reusing: %" FMT_SIZE_T "u", check1, check2);
+        return EXIT_FAILURE;
+    }
+
+    const uint64_t messages = 2 * uint64_t(opt.loops);
+    std::cout << messages << " messages (ECM_response + data_provision), serialize and analyze" << std::endl
+              << "allocating: " << bench::Rate(messages, time1, "msg") << std::endl
+              << "reusing:    " << bench::Rate(messages, time2, "msg") << std::endl;
+
+    return EXIT_SUCCESS;
+}
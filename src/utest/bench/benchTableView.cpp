@@ -0,0 +1,185 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Benchmark: deserialization of an EIT schedule compared with ts::EITView.
+//
+//----------------------------------------------------------------------------
+
+#include "tsArgs.h"
+#include "tsEIT.h"
+#include "tsEITView.h"
+#include "tsShortEventDescriptor.h"
+#include "tsBinaryTable.h"
+#include "tsTime.h"
+#include "benchUtils.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+//  Command line options
+//----------------------------------------------------------------------------
+
+struct Options: public ts::Args
+{
+    Options(int argc, char *argv[]);
+
+    size_t tables;  // Number of EIT in the schedule
+    size_t events;  // Number of events per EIT
+    size_t loops;   // Number of passes over the schedule
+};
+
+Options::Options(int argc, char *argv[]) :
+    ts::Args("Benchmark EIT schedule deserialization against EIT views.", "[options]"),
+    tables(0),
+    events(0),
+    loops(0)
+{
+    option("events", 'e', Args::POSITIVE);
+    option("loops",  'l', Args::POSITIVE);
+    option("tables", 't', Args::INTEGER, 0, 1, 1, 16);
+
+    setHelp("Options:\n"
+            "\n"
+            "  -e value\n"
+            "  --events value\n"
+            "      Number of events per EIT. The default is 256.\n"
+            "\n"
+            "  --help\n"
+            "      Display this help text.\n"
+            "\n"
+            "  -l value\n"
+            "  --loops value\n"
+            "      Number of passes over the complete schedule. The default is 100.\n"
+            "\n"
+            "  -t value\n"
+            "  --tables value\n"
+            "      Number of EIT schedule tables, from 1 to 16. The default is 16.\n"
+            "\n"
+            "  --version\n"
+            "      Display the version number.\n");
+
+    analyze(argc, argv);
+
+    events = intValue<size_t>("events", 256);
+    loops = intValue<size_t>("loops", 100);
+    tables = intValue<size_t>("tables", 16);
+}
+
+
+//----------------------------------------------------------------------------
+//  Build a full EIT schedule for one service, one event every 15 minutes.
+//----------------------------------------------------------------------------
+
+namespace {
+    bool BuildSchedule(ts::BinaryTablePtrVector& tables, size_t table_count, size_t events_per_table)
+    {
+        const ts::Time base(2017, 10, 1, 0, 0, 0);
+        uint16_t event_id = 0;
+
+        tables.clear();
+        for (size_t ti = 0; ti < table_count; ++ti) {
+            ts::EIT eit(true, false, uint8_t(ti), 0, true, 0x1234, 0x0001, 0x0002);
+            for (size_t ei = 0; ei < events_per_table; ++ei) {
+                ts::EIT::Event& ev(eit.events[++event_id]);
+                ev.start_time = base + ts::MilliSecond(event_id) * 15 * ts::MilliSecPerMin;
+                ev.duration = 15 * 60;
+                ev.running_status = 1;
+                ev.descs.add(ts::ShortEventDescriptor("fre", ts::UString(ts::Format("Event %d", int(event_id))), "Short description of the event, not too short, not too long."));
+            }
+            tables.push_back(new ts::BinaryTable);
+            eit.serialize(*tables.back());
+            if (!tables.back()->isValid()) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+//  Program entry point
+//----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    Options opt(argc, argv);
+
+    ts::BinaryTablePtrVector tables;
+    if (!BuildSchedule(tables, opt.tables, opt.events)) {
+        opt.error("error serializing the EIT schedule");
+        return EXIT_FAILURE;
+    }
+
+    size_t sections = 0;
+    size_t bytes = 0;
+    for (size_t i = 0; i < tables.size(); ++i) {
+        sections += tables[i]->sectionCount();
+        bytes += tables[i]->totalSize();
+    }
+    const uint64_t count = uint64_t(opt.loops) * tables.size();
+
+    // Deserialize all tables, collect the total duration of events.
+    ts::Second total1 = 0;
+    bench::Chrono chrono;
+    for (size_t loop = 0; loop < opt.loops; ++loop) {
+        for (size_t i = 0; i < tables.size(); ++i) {
+            const ts::EIT eit(*tables[i]);
+            for (ts::EIT::EventMap::const_iterator it = eit.events.begin(); it != eit.events.end(); ++it) {
+                total1 += it->second.duration;
+            }
+        }
+    }
+    const ts::NanoSecond time1 = chrono.elapsed();
+
+    // Same with views.
+    ts::Second total2 = 0;
+    chrono.restart();
+    for (size_t loop = 0; loop < opt.loops; ++loop) {
+        for (size_t i = 0; i < tables.size(); ++i) {
+            const ts::EITView eit(*tables[i]);
+            for (ts::EITView::const_iterator it = eit.begin(); it != eit.end(); ++it) {
+                total2 += (*it).duration();
+            }
+        }
+    }
+    const ts::NanoSecond time2 = chrono.elapsed();
+
+    if (total1 != total2) {
+        opt.error("different total event durations, deserialized: %" FMT_INT64 "d, view: %" FMT_INT64 "d", total1, total2);
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "EIT schedule: " << tables.size() << " tables, " << sections << " sections, "
+              << bytes << " bytes, " << opt.events << " events per table, " << opt.loops << " loops" << std::endl
+              << "deserialize: " << bench::Rate(count, time1, "table") << std::endl
+              << "view:        " << bench::Rate(count, time2, "table") << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,90 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  To be included by the standalone benchmarks.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsMonotonic.h"
+#include "tsFormat.h"
+
+//!
+//! Standalone benchmarks namespace
+//!
+namespace bench {
+
+    //!
+    //! A simple chronometer, based on the monotonic clock.
+    //!
+    class Chrono
+    {
+    public:
+        //!
+        //! Constructor, the chronometer is started.
+        //!
+        Chrono() : _start() {restart();}
+
+        //!
+        //! Restart the chronometer.
+        //!
+        void restart() {_start.getSystemTime();}
+
+        //!
+        //! Get the elapsed time since the chronometer was started.
+        //! @return The elapsed time in nanoseconds.
+        //!
+        ts::NanoSecond elapsed() const
+        {
+            ts::Monotonic now;
+            now.getSystemTime();
+            return now - _start;
+        }
+
+    private:
+        ts::Monotonic _start;
+    };
+
+    //!
+    //! Format a duration and the corresponding rate of operations.
+    //! @param [in] count Number of operations.
+    //! @param [in] duration Duration of all operations in nanoseconds.
+    //! @param [in] unit Name of the operations in the rate, eg "msg".
+    //! @return A string such as "123.456 ms (45678 msg/s)".
+    //!
+    inline std::string Rate(uint64_t count, ts::NanoSecond duration, const char* unit)
+    {
+        return ts::Format("%" FMT_INT64 "d.%03d ms (%" FMT_INT64 "d %s/s)",
+                          duration / ts::NanoSecPerMilliSec,
+                          int(duration / ts::NanoSecPerMicroSec % 1000),
+                          duration <= 0 ? ts::NanoSecond(0) : ts::NanoSecond(count * ts::NanoSecPerSec / duration),
+                          unit);
+    }
+}
@@ -0,0 +1,186 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Benchmark: compilation of a large synthetic EPG XML file.
+//
+//----------------------------------------------------------------------------
+
+#include "tsArgs.h"
+#include "tsXMLTables.h"
+#include "tsBinaryTable.h"
+#include "tsTime.h"
+#include "benchUtils.h"
+#include <sstream>
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+//  Command line options
+//----------------------------------------------------------------------------
+
+struct Options: public ts::Args
+{
+    Options(int argc, char *argv[]);
+
+    size_t services;  // Number of services in the EPG
+    size_t events;    // Number of events per service
+    size_t threads;   // Number of compilation threads to compare with one thread
+};
+
+Options::Options(int argc, char *argv[]) :
+    ts::Args("Benchmark the compilation of a large synthetic EPG XML file.", "[options]"),
+    services(0),
+    events(0),
+    threads(0)
+{
+    option("events",   'e', Args::POSITIVE);
+    option("services", 's', Args::INTEGER, 0, 1, 1, 1000);
+    option("threads",  't', Args::INTEGER, 0, 1, 1, 256);
+
+    setHelp("Options:\n"
+            "\n"
+            "  -e value\n"
+            "  --events value\n"
+            "      Number of events per service, one every 30 minutes. The default is\n"
+            "      336 (one week).\n"
+            "\n"
+            "  --help\n"
+            "      Display this help text.\n"
+            "\n"
+            "  -s value\n"
+            "  --services value\n"
+            "      Number of services in the EPG. The default is 10.\n"
+            "\n"
+            "  -t value\n"
+            "  --threads value\n"
+            "      Number of compilation threads, compared with one thread. The default\n"
+            "      is 4.\n"
+            "\n"
+            "  --version\n"
+            "      Display the version number.\n");
+
+    analyze(argc, argv);
+
+    events = intValue<size_t>("events", 336);
+    services = intValue<size_t>("services", 10);
+    threads = intValue<size_t>("threads", 4);
+}
+
+
+//----------------------------------------------------------------------------
+//  Build a synthetic EPG, one EIT schedule table per 32 events.
+//----------------------------------------------------------------------------
+
+namespace {
+    std::string BuildEPG(size_t services, size_t events)
+    {
+        std::string text("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<tsduck>\n");
+        const ts::Time base(2017, 10, 1, 0, 0);
+        for (size_t srv = 0; srv < services; ++srv) {
+            for (size_t first = 0; first < events; first += 32) {
+                text += ts::Format("  <EIT type=\"%d\" version=\"1\" actual=\"true\" service_id=\"%d\" transport_stream_id=\"1\" "
+                                   "original_network_id=\"2\" segment_last_section_number=\"0\" last_table_id=\"80\">\n",
+                                   int(first / 32 % 16), int(100 + srv));
+                for (size_t ev = first; ev < events && ev < first + 32; ++ev) {
+                    const ts::Time::Fields start(base + ts::MilliSecond(ev) * 30 * ts::MilliSecPerMin);
+                    text += ts::Format("    <event event_id=\"%d\" start_time=\"%04d-%02d-%02d %02d:%02d:00\" duration=\"00:30:00\" running_status=\"running\">\n"
+                                       "      <short_event_descriptor language_code=\"eng\">\n"
+                                       "        <event_name>Programme %d on service %d</event_name>\n"
+                                       "        <text>Synthetic description of event %d.</text>\n"
+                                       "      </short_event_descriptor>\n"
+                                       "      <content_descriptor>\n"
+                                       "        <content content_nibble_level_1=\"2\" content_nibble_level_2=\"3\" user_byte=\"0x00\"/>\n"
+                                       "      </content_descriptor>\n"
+                                       "    </event>\n",
+                                       int(ev), start.year, start.month, start.day, start.hour, start.minute,
+                                       int(ev), int(srv), int(ev));
+                }
+                text += "  </EIT>\n";
+            }
+        }
+        text += "</tsduck>\n";
+        return text;
+    }
+
+    // Compile XML text with a given number of threads, return the serialized sections.
+    bool Compile(std::string& sections, size_t& tables, const std::string& text, size_t threads, ts::ReportInterface& report)
+    {
+        ts::XMLTables xml;
+        xml.setMaxThreads(threads);
+        if (!xml.parseXML(text, report)) {
+            return false;
+        }
+        std::ostringstream strm;
+        if (!ts::BinaryTable::SaveFile(xml.tables(), strm, report)) {
+            return false;
+        }
+        sections = strm.str();
+        tables = xml.tables().size();
+        return true;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+//  Program entry point
+//----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    Options opt(argc, argv);
+
+    const std::string epg(BuildEPG(opt.services, opt.events));
+    std::string sec1;
+    std::string secn;
+    size_t tables = 0;
+
+    bench::Chrono chrono;
+    if (!Compile(sec1, tables, epg, 1, opt)) {
+        return EXIT_FAILURE;
+    }
+    const ts::NanoSecond time1 = chrono.elapsed();
+
+    chrono.restart();
+    if (!Compile(secn, tables, epg, opt.threads, opt)) {
+        return EXIT_FAILURE;
+    }
+    const ts::NanoSecond timen = chrono.elapsed();
+
+    if (sec1 != secn) {
+        opt.error("different binary tables with 1 and %d threads", int(opt.threads));
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "EPG: " << opt.services << " services, " << opt.events << " events per service, "
+              << epg.size() << " XML bytes, " << tables << " tables, " << sec1.size() << " binary bytes" << std::endl
+              << "compile, 1 thread:  " << bench::Rate(tables, time1, "table") << std::endl
+              << "compile, " << opt.threads << " threads: " << bench::Rate(tables, timen, "table") << std::endl;
+
+    return EXIT_SUCCESS;
+}
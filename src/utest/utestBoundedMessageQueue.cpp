@@ -0,0 +1,259 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  CppUnit test suite for class ts::BoundedMessageQueue
+//
+//----------------------------------------------------------------------------
+
+#include "tsBoundedMessageQueue.h"
+#include "tsThread.h"
+#include "tsSysUtils.h"
+#include "utestCppUnitTest.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class BoundedMessageQueueTest: public CppUnit::TestFixture
+{
+public:
+    void setUp();
+    void tearDown();
+    void testConstructor();
+    void testTimeout();
+    void testQueue();
+    void testProducers();
+
+    CPPUNIT_TEST_SUITE(BoundedMessageQueueTest);
+    CPPUNIT_TEST(testConstructor);
+    CPPUNIT_TEST(testTimeout);
+    CPPUNIT_TEST(testQueue);
+    CPPUNIT_TEST(testProducers);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(BoundedMessageQueueTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void BoundedMessageQueueTest::setUp()
+{
+}
+
+// Test suite cleanup method.
+void BoundedMessageQueueTest::tearDown()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+typedef ts::BoundedMessageQueue<int> TestQueue;
+
+// Test case: Constructor
+void BoundedMessageQueueTest::testConstructor()
+{
+    TestQueue queue1(1);
+    TestQueue queue2(10);
+    TestQueue queue3(64);
+
+    CPPUNIT_ASSERT_EQUAL(size_t(1), queue1.getMaxMessages());
+    CPPUNIT_ASSERT_EQUAL(size_t(16), queue2.getMaxMessages());
+    CPPUNIT_ASSERT_EQUAL(size_t(64), queue3.getMaxMessages());
+}
+
+// Test case: Timeouts on empty and full queue
+void BoundedMessageQueueTest::testTimeout()
+{
+    TestQueue queue(2);
+    TestQueue::MessagePtr message;
+
+    CPPUNIT_ASSERT(!queue.dequeue(message, 0));
+
+    ts::Time start(ts::Time::CurrentUTC());
+    CPPUNIT_ASSERT(!queue.dequeue(message, 100));
+    CPPUNIT_ASSERT(ts::Time::CurrentUTC() - start >= 100);
+
+    CPPUNIT_ASSERT(queue.enqueue(new int(1), 0));
+    CPPUNIT_ASSERT(queue.enqueue(new int(2), 0));
+    CPPUNIT_ASSERT(!queue.enqueue(new int(3), 0));
+
+    start = ts::Time::CurrentUTC();
+    CPPUNIT_ASSERT(!queue.enqueue(new int(3), 100));
+    CPPUNIT_ASSERT(ts::Time::CurrentUTC() - start >= 100);
+
+    CPPUNIT_ASSERT(queue.dequeue(message, 0));
+    CPPUNIT_ASSERT_EQUAL(1, *message);
+    CPPUNIT_ASSERT(queue.dequeue(message, 0));
+    CPPUNIT_ASSERT_EQUAL(2, *message);
+    CPPUNIT_ASSERT(!queue.dequeue(message, 0));
+}
+
+// Thread for testQueue()
+namespace {
+    class BoundedMessageQueueTestThread: public ts::Thread
+    {
+    private:
+        TestQueue& _queue;
+    public:
+        explicit BoundedMessageQueueTestThread(TestQueue& queue) :
+            Thread(),
+            _queue(queue)
+        {
+        }
+
+        virtual void main()
+        {
+            utest::Out() << "BoundedMessageQueueTest: starting thread" << std::endl;
+
+            // Initial suspend of 500 ms
+            ts::SleepThread(500);
+
+            // Read messages. Expect consecutive values until negative value.
+            int expected = 0;
+            TestQueue::MessagePtr message;
+            do {
+                CPPUNIT_ASSERT(_queue.dequeue(message, 10000));
+                CPPUNIT_ASSERT(!message.isNull());
+                utest::Out() << "BoundedMessageQueueTest: thread received " << *message << std::endl;
+                if (*message >= 0) {
+                    CPPUNIT_ASSERT(*message == expected);
+                    expected++;
+                }
+            } while (*message >= 0);
+
+            utest::Out() << "BoundedMessageQueueTest: end of thread" << std::endl;
+        }
+    };
+}
+
+// Test case: Blocking producer
+void BoundedMessageQueueTest::testQueue()
+{
+    TestQueue queue(8);
+    BoundedMessageQueueTestThread thread(queue);
+    int message = 0;
+
+    utest::Out() << "BoundedMessageQueueTest: starting test" << std::endl;
+
+    // Enqueue 8 message, should not fail.
+    while (message < 8) {
+        CPPUNIT_ASSERT(queue.enqueue(new int(message++), 100));
+    }
+
+    // Start the thread
+    const ts::Time start(ts::Time::CurrentUTC());
+    CPPUNIT_ASSERT(thread.start());
+
+    // Enqueue 9th message with 50 ms timeout, should fail
+    CPPUNIT_ASSERT(!queue.enqueue(new int(message), 50));
+
+    // Enqueue message, should take at least 500 ms
+    CPPUNIT_ASSERT(queue.enqueue(new int(message++), 10000));
+    CPPUNIT_ASSERT(ts::Time::CurrentUTC() - start >= 500);
+
+    // Enqueue exit request
+    CPPUNIT_ASSERT(queue.enqueue(new int(-1)));
+    thread.waitForTermination();
+
+    utest::Out() << "BoundedMessageQueueTest: end of test" << std::endl;
+}
+
+// Producer thread for testProducers().
+// Each message contains the producer index in the upper 16 bits and a sequence number.
+namespace {
+    class ProducerThread: public ts::Thread
+    {
+    private:
+        TestQueue& _queue;
+        int        _index;
+        int        _count;
+    public:
+        ProducerThread(TestQueue& queue, int index, int count) :
+            Thread(),
+            _queue(queue),
+            _index(index),
+            _count(count)
+        {
+        }
+
+        virtual ~ProducerThread()
+        {
+            waitForTermination();
+        }
+
+        virtual void main()
+        {
+            for (int i = 0; i < _count; ++i) {
+                CPPUNIT_ASSERT(_queue.enqueue(new int((_index << 16) | i)));
+            }
+        }
+    };
+
+    // Run producers and one consumer.
+    void RunProducers(TestQueue& queue, int producers, int count)
+    {
+        std::vector<ProducerThread*> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.push_back(new ProducerThread(queue, p, count));
+            CPPUNIT_ASSERT(threads.back()->start());
+        }
+
+        // The order of messages must be preserved for each producer.
+        std::vector<int> next(producers, 0);
+        TestQueue::MessagePtr message;
+        for (int i = 0; i < producers * count; ++i) {
+            CPPUNIT_ASSERT(queue.dequeue(message, 10000));
+            const int p = *message >> 16;
+            CPPUNIT_ASSERT(p >= 0 && p < producers);
+            CPPUNIT_ASSERT_EQUAL(next[p], *message & 0xFFFF);
+            next[p]++;
+        }
+        CPPUNIT_ASSERT(!queue.dequeue(message, 0));
+
+        for (size_t p = 0; p < threads.size(); ++p) {
+            delete threads[p];
+        }
+    }
+}
+
+// Test case: Multiple producers
+void BoundedMessageQueueTest::testProducers()
+{
+    TestQueue queue(16);
+    RunProducers(queue, 4, 10000);
+}
@@ -32,6 +32,10 @@
 //----------------------------------------------------------------------------
 
 #include "tsDVBCharset.h"
+#include "tsDVBCharsetSingleByte.h"
+#include "tsDVBCharsetUTF8.h"
+#include "tsDVBCharsetUTF16.h"
+#include "tsByteBlock.h"
 #include "utestCppUnitTest.h"
 TSDUCK_SOURCE;
 
@@ -45,10 +49,23 @@ public:
     void setUp();
     void tearDown();
     void testRepository();
+    void testSingleByte();
+    void testUTF8();
+    void testUTF16();
 
     CPPUNIT_TEST_SUITE(DVBCharsetTest);
     CPPUNIT_TEST(testRepository);
+    CPPUNIT_TEST(testSingleByte);
+    CPPUNIT_TEST(testUTF8);
+    CPPUNIT_TEST(testUTF16);
     CPPUNIT_TEST_SUITE_END();
+
+private:
+    // Build a text with long ASCII runs, as in EIT, and a few other characters.
+    static ts::UString BuildText(size_t size, const ts::UString& others);
+
+    // Encode a complete string in a byte block.
+    static ts::ByteBlock Encode(const ts::DVBCharset& charset, const ts::UString& str, size_t start = 0, size_t count = ts::UString::NPOS);
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(DVBCharsetTest);
@@ -78,3 +95,153 @@ void DVBCharsetTest::testRepository()
     utest::Out() << "DVBCharsetTest::testRepository: charsets: " << ts::UString::Join(ts::DVBCharset::GetAllNames()) << std::endl;
     CPPUNIT_ASSERT_EQUAL(size_t(17), ts::DVBCharset::GetAllNames().size());
 }
+
+ts::UString DVBCharsetTest::BuildText(size_t size, const ts::UString& others)
+{
+    static const char ascii[] = "The quick brown fox jumps over the lazy dog, 0123456789 times! ";
+    ts::UString str;
+    for (size_t i = 0, j = 0; str.size() < size; ++i) {
+        // ASCII runs of varying lengths (1 to 40 characters), separated by other characters.
+        str.append(ts::UString::FromUTF8(ascii + i % 23, 1 + (i * 7) % 40));
+        // Keep surrogate pairs together.
+        const size_t len = (others[j] & 0xFC00) == 0xD800 ? 2 : 1;
+        str.append(others, j, len);
+        j = (j + len) % others.size();
+    }
+    str.resize(size);
+    if ((str[size - 1] & 0xFC00) == 0xD800) {
+        str[size - 1] = ts::SPACE;
+    }
+    return str;
+}
+
+ts::ByteBlock DVBCharsetTest::Encode(const ts::DVBCharset& charset, const ts::UString& str, size_t start, size_t count)
+{
+    ts::ByteBlock bb(4 * str.size() + 16);
+    uint8_t* buffer = bb.data();
+    size_t size = bb.size();
+    charset.encode(buffer, size, str, start, count);
+    bb.resize(bb.size() - size);
+    return bb;
+}
+
+void DVBCharsetTest::testSingleByte()
+{
+    const ts::DVBCharsetSingleByte& cs(ts::DVBCharsetSingleByte::ISO_8859_1);
+
+    // Reference decoding of all byte values, byte by byte.
+    ts::ByteBlock all;
+    ts::UString allRef;
+    for (int loop = 0; loop < 3; ++loop) {
+        for (int b = 0; b < 256; ++b) {
+            all.push_back(uint8_t(b));
+            if (b >= 0x20 && b <= 0x7E) {
+                allRef.push_back(ts::UChar(b));
+            }
+            else if (b >= 0xA0) {
+                allRef.push_back(ts::UChar(b));
+            }
+            else if (b == 0x8A) {
+                allRef.push_back(ts::LINE_FEED);
+            }
+        }
+    }
+    ts::UString str;
+    CPPUNIT_ASSERT(!cs.decode(str, all.data(), all.size()));
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(allRef, str);
+
+    // Round trip on long texts, at all alignments.
+    const ts::UString text(BuildText(2000, u"\u00E9\u00E0\n\u00E7\u00FF"));
+    for (size_t start = 0; start < 17; ++start) {
+        const ts::ByteBlock bb(Encode(cs, text, start));
+        CPPUNIT_ASSERT_EQUAL(text.size() - start, bb.size());
+        CPPUNIT_ASSERT(cs.decode(str, bb.data(), bb.size()));
+        CPPUNIT_ASSERT_USTRINGS_EQUAL(text.substr(start), str);
+    }
+
+    // Unmappable characters and carriage returns are skipped.
+    ts::UString text2(text);
+    text2.insert(100, u"\u20AC\r");
+    CPPUNIT_ASSERT(!cs.canEncode(text2));
+    CPPUNIT_ASSERT(cs.canEncode(text2, 0, 100));
+    CPPUNIT_ASSERT(cs.canEncode(text2, 101));
+    CPPUNIT_ASSERT(Encode(cs, text2) == Encode(cs, text));
+
+    // Output buffer too short.
+    uint8_t buf[50];
+    uint8_t* buffer = buf;
+    size_t size = sizeof(buf);
+    CPPUNIT_ASSERT_EQUAL(size_t(50), cs.encode(buffer, size, text));
+    CPPUNIT_ASSERT_EQUAL(size_t(0), size);
+    CPPUNIT_ASSERT(cs.decode(str, buf, sizeof(buf)));
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(text.substr(0, 50), str);
+}
+
+void DVBCharsetTest::testUTF8()
+{
+    const ts::DVBCharsetUTF8& cs(ts::DVBCharsetUTF8::UTF_8);
+    const ts::UString text(BuildText(2000, u"\u00E9\u20AC\n\u0416\U0001F600"));
+
+    // Reference encoding, character by character.
+    std::string ref;
+    for (size_t i = 0; i < text.size(); ++i) {
+        const size_t len = (text[i] & 0xFC00) == 0xD800 ? 2 : 1;
+        ref.append(text.substr(i, len).toUTF8());
+        i += len - 1;
+    }
+    CPPUNIT_ASSERT(ref == text.toUTF8());
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(text, ts::UString::FromUTF8(ref));
+
+    for (size_t start = 0; start < 17; ++start) {
+        const ts::ByteBlock bb(Encode(cs, text, start));
+        const ts::UString sub(text.substr(start));
+        CPPUNIT_ASSERT(std::string(reinterpret_cast<const char*>(bb.data()), bb.size()) == sub.toUTF8());
+        ts::UString str;
+        CPPUNIT_ASSERT(cs.decode(str, bb.data(), bb.size()));
+        // Starting in the middle of a surrogate pair drops the trailing half.
+        if ((text[start] & 0xFC00) != 0xDC00) {
+            CPPUNIT_ASSERT_USTRINGS_EQUAL(sub, str);
+        }
+    }
+
+    // Carriage returns are skipped but do not stop the encoding.
+    ts::UString text2(text);
+    text2.insert(100, u"\r");
+    text2.append(u"\r");
+    CPPUNIT_ASSERT(Encode(cs, text2) == Encode(cs, text));
+
+    // Characters are never split at end of buffer.
+    uint8_t buf[19];
+    uint8_t* buffer = buf;
+    size_t size = sizeof(buf);
+    const ts::UString euros(u"abcdefghijklmnopq\u20AC\u20AC");
+    CPPUNIT_ASSERT_EQUAL(size_t(17), cs.encode(buffer, size, euros));
+    CPPUNIT_ASSERT_EQUAL(size_t(2), size);
+}
+
+void DVBCharsetTest::testUTF16()
+{
+    const ts::DVBCharsetUTF16& cs(ts::DVBCharsetUTF16::UNICODE);
+    const ts::UString text(BuildText(2000, u"\u00E9\u20AC\n\u0416"));
+
+    for (size_t start = 0; start < 17; ++start) {
+        const ts::ByteBlock bb(Encode(cs, text, start));
+        CPPUNIT_ASSERT_EQUAL(2 * (text.size() - start), bb.size());
+        for (size_t i = start; i < text.size(); ++i) {
+            const uint16_t ref = text[i] == ts::LINE_FEED ? ts::DVBCharset::DVB_CODEPOINT_CRLF : uint16_t(text[i]);
+            CPPUNIT_ASSERT_EQUAL(ref, ts::GetUInt16(bb.data() + 2 * (i - start)));
+        }
+        ts::UString str;
+        CPPUNIT_ASSERT(cs.decode(str, bb.data(), bb.size()));
+        CPPUNIT_ASSERT_USTRINGS_EQUAL(text.substr(start), str);
+    }
+
+    ts::UString text2(text);
+    text2.insert(100, u"\r");
+    CPPUNIT_ASSERT(Encode(cs, text2) == Encode(cs, text));
+
+    const ts::ByteBlock odd(Encode(cs, text));
+    ts::UString str;
+    CPPUNIT_ASSERT(!cs.decode(str, odd.data(), odd.size() - 1));
+    CPPUNIT_ASSERT_USTRINGS_EQUAL(text.substr(0, text.size() - 1), str);
+}
@@ -0,0 +1,416 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  CppUnit test suite for the multiplexed ECMG client.
+//
+//----------------------------------------------------------------------------
+
+#include "tsECMGMultiClient.h"
+#include "tsTCPServer.h"
+#include "tsThread.h"
+#include "tsCerrReport.h"
+#include "utestCppUnitTest.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class ECMGMultiClientTest: public CppUnit::TestFixture
+{
+public:
+    ECMGMultiClientTest();
+    void setUp();
+    void tearDown();
+    void testNotConnected();
+    void testLoopback();
+    void testStreamError();
+
+    CPPUNIT_TEST_SUITE(ECMGMultiClientTest);
+    CPPUNIT_TEST(testNotConnected);
+    CPPUNIT_TEST(testLoopback);
+    CPPUNIT_TEST(testStreamError);
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    int _previousSeverity;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ECMGMultiClientTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Constructor.
+ECMGMultiClientTest::ECMGMultiClientTest() :
+    _previousSeverity(0)
+{
+}
+
+// Test suite initialization method.
+void ECMGMultiClientTest::setUp()
+{
+    _previousSeverity = CERR.debugLevel();
+    if (utest::DebugMode()) {
+        CERR.setDebugLevel(ts::Severity::Debug);
+    }
+}
+
+// Test suite cleanup method.
+void ECMGMultiClientTest::tearDown()
+{
+    CERR.setDebugLevel(_previousSeverity);
+}
+
+
+//----------------------------------------------------------------------------
+// A loopback ECMG stand-in, built from the TLV classes.
+// The ECM is the concatenation of the two control words.
+// An access criteria starting with 0xEE triggers a stream_error.
+// An access criteria starting with 0xDD delays the request until the next
+// stream_close_request. The oldest delayed request then gets a stream_error
+// which identifies the CW_provision and the stream_close_request gets a
+// stream_error without error_information.
+// The responses to the first CW_provision messages are held until a given
+// number of requests are received and then sent in reverse order.
+//----------------------------------------------------------------------------
+
+namespace {
+    class ECMGStub: public ts::Thread
+    {
+    private:
+        ts::TCPServer _server;
+        size_t        _hold_count;
+    public:
+        // Constructor: open the server socket.
+        ECMGStub(uint16_t port_number, size_t hold_count) :
+            _server(),
+            _hold_count(hold_count)
+        {
+            const ts::SocketAddress address(ts::IPAddress::LocalHost, port_number);
+            CPPUNIT_ASSERT(_server.open(CERR));
+            CPPUNIT_ASSERT(_server.reusePort(true, CERR));
+            CPPUNIT_ASSERT(_server.bind(address, CERR));
+            CPPUNIT_ASSERT(_server.listen(5, CERR));
+        }
+
+        // Destructor
+        ~ECMGStub()
+        {
+            waitForTermination();
+            _server.close(CERR);
+        }
+
+        // Thread execution
+        virtual void main()
+        {
+            ts::tlv::Connection<ts::Mutex> conn(ts::ecmgscs::Protocol::Instance(), true, 3);
+            ts::SocketAddress client;
+            CPPUNIT_ASSERT(_server.accept(conn, client, CERR));
+
+            std::vector<ts::tlv::MessagePtr> held;
+            size_t delayed = 0;
+            ts::tlv::MessagePtr msg;
+            bool active = true;
+
+            while (active && conn.receive(msg, 0, CERR)) {
+                CERR.debug("ECMGStub: received " + msg->dump(4));
+                switch (msg->tag()) {
+                    case ts::ecmgscs::Tags::channel_setup: {
+                        const ts::ecmgscs::ChannelSetup* const req = dynamic_cast<ts::ecmgscs::ChannelSetup*>(msg.pointer());
+                        ts::ecmgscs::ChannelStatus resp;
+                        resp.channel_id = req->channel_id;
+                        resp.section_TSpkt_flag = true;
+                        resp.ECM_rep_period = 100;
+                        resp.max_streams = 100;
+                        resp.min_CP_duration = 10;
+                        resp.lead_CW = 1;
+                        resp.CW_per_msg = 2;
+                        resp.max_comp_time = 100;
+                        CPPUNIT_ASSERT(conn.send(resp, CERR));
+                        break;
+                    }
+                    case ts::ecmgscs::Tags::stream_setup: {
+                        const ts::ecmgscs::StreamSetup* const req = dynamic_cast<ts::ecmgscs::StreamSetup*>(msg.pointer());
+                        ts::ecmgscs::StreamStatus resp;
+                        resp.channel_id = req->channel_id;
+                        resp.stream_id = req->stream_id;
+                        resp.ECM_id = req->ECM_id;
+                        resp.access_criteria_transfer_mode = true;
+                        CPPUNIT_ASSERT(conn.send(resp, CERR));
+                        break;
+                    }
+                    case ts::ecmgscs::Tags::CW_provision: {
+                        const ts::ecmgscs::CWProvision* const req = dynamic_cast<ts::ecmgscs::CWProvision*>(msg.pointer());
+                        ts::tlv::MessagePtr resp;
+                        if (req->has_access_criteria && !req->access_criteria.empty() && req->access_criteria[0] == 0xDD) {
+                            delayed++;
+                            break;
+                        }
+                        if (req->has_access_criteria && !req->access_criteria.empty() && req->access_criteria[0] == 0xEE) {
+                            ts::ecmgscs::StreamError* const err = new ts::ecmgscs::StreamError;
+                            err->channel_id = req->channel_id;
+                            err->stream_id = req->stream_id;
+                            err->error_status.push_back(ts::ecmgscs::Errors::inv_param_value);
+                            resp = err;
+                        }
+                        else {
+                            ts::ecmgscs::ECMResponse* const ecm = new ts::ecmgscs::ECMResponse;
+                            ecm->channel_id = req->channel_id;
+                            ecm->stream_id = req->stream_id;
+                            ecm->CP_number = req->CP_number;
+                            for (size_t i = 0; i < req->CP_CW_combination.size(); ++i) {
+                                ecm->ECM_datagram.append(req->CP_CW_combination[i].CW);
+                            }
+                            resp = ecm;
+                        }
+                        if (_hold_count == 0) {
+                            CPPUNIT_ASSERT(conn.send(*resp, CERR));
+                        }
+                        else {
+                            held.push_back(resp);
+                            if (held.size() == _hold_count) {
+                                // All requests were received before any response: send responses in reverse order.
+                                for (size_t i = held.size(); i > 0; --i) {
+                                    CPPUNIT_ASSERT(conn.send(*held[i-1], CERR));
+                                }
+                                held.clear();
+                                _hold_count = 0;
+                            }
+                        }
+                        break;
+                    }
+                    case ts::ecmgscs::Tags::stream_close_request: {
+                        const ts::ecmgscs::StreamCloseRequest* const req = dynamic_cast<ts::ecmgscs::StreamCloseRequest*>(msg.pointer());
+                        if (delayed > 0) {
+                            ts::ecmgscs::StreamError err;
+                            err.channel_id = req->channel_id;
+                            err.stream_id = req->stream_id;
+                            err.error_status.push_back(ts::ecmgscs::Errors::out_of_compute);
+                            err.error_information.push_back(ts::ecmgscs::Tags::CW_provision);
+                            CPPUNIT_ASSERT(conn.send(err, CERR));
+                            err.error_status[0] = ts::ecmgscs::Errors::unknown_error;
+                            err.error_information.clear();
+                            CPPUNIT_ASSERT(conn.send(err, CERR));
+                            delayed = 0;
+                            break;
+                        }
+                        ts::ecmgscs::StreamCloseResponse resp;
+                        resp.channel_id = req->channel_id;
+                        resp.stream_id = req->stream_id;
+                        CPPUNIT_ASSERT(conn.send(resp, CERR));
+                        break;
+                    }
+                    case ts::ecmgscs::Tags::channel_close: {
+                        active = false;
+                        break;
+                    }
+                    default: {
+                        break;
+                    }
+                }
+            }
+
+            conn.disconnect(NULLREP);
+            conn.close(NULLREP);
+            CERR.debug("ECMGStub: terminated");
+        }
+    };
+
+    // Control word of a stream and crypto-period.
+    ts::ByteBlock CW(uint16_t stream_id, uint16_t cp_number)
+    {
+        ts::ByteBlock cw(ts::CW_BYTES, uint8_t(cp_number));
+        cw[0] = uint8_t(stream_id);
+        return cw;
+    }
+
+    // Expected ECM for a stream and crypto-period.
+    ts::ByteBlock ECM(uint16_t stream_id, uint16_t cp_number)
+    {
+        ts::ByteBlock ecm(CW(stream_id, cp_number));
+        ecm.append(CW(stream_id, cp_number + 1));
+        return ecm;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void ECMGMultiClientTest::testNotConnected()
+{
+    ts::ECMGMultiClient client;
+    const ts::ByteBlock cw(ts::CW_BYTES, 0);
+    ts::ecmgscs::StreamStatus stream_status;
+
+    CPPUNIT_ASSERT(!client.isConnected());
+    CPPUNIT_ASSERT(!client.openStream(1, 1, 100, stream_status));
+    CPPUNIT_ASSERT(!client.submitECM(1, 0, cw.data(), cw.data(), 0, 0, 0));
+    CPPUNIT_ASSERT(client.flush());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), client.pendingCount());
+
+    ts::ECMGMultiClient::CompletionPtr completion;
+    CPPUNIT_ASSERT(!client.getCompletion(completion, 0));
+}
+
+void ECMGMultiClientTest::testLoopback()
+{
+    const uint16_t port_number = 12346;
+    const uint16_t stream_count = 3;
+    const uint16_t cp_count = 10;
+
+    // The ECMG stand-in holds all responses to the first batch of requests.
+    ECMGStub ecmg(port_number, stream_count * cp_count);
+    ecmg.start();
+
+    ts::ECMGMultiClient client;
+    ts::ecmgscs::ChannelStatus channel_status;
+    CPPUNIT_ASSERT(client.connect(ts::SocketAddress(ts::IPAddress::LocalHost, port_number), 0x12345678, 7, channel_status, 0, &CERR));
+    CPPUNIT_ASSERT(client.isConnected());
+    CPPUNIT_ASSERT_EQUAL(uint16_t(7), channel_status.channel_id);
+    CPPUNIT_ASSERT_EQUAL(uint8_t(2), channel_status.CW_per_msg);
+
+    // Open all streams on the same channel.
+    for (uint16_t stream = 1; stream <= stream_count; ++stream) {
+        ts::ecmgscs::StreamStatus stream_status;
+        CPPUNIT_ASSERT(client.openStream(stream, stream + 100, 100, stream_status));
+        CPPUNIT_ASSERT_EQUAL(uint16_t(7), stream_status.channel_id);
+        CPPUNIT_ASSERT_EQUAL(stream, stream_status.stream_id);
+        CPPUNIT_ASSERT_EQUAL(uint16_t(stream + 100), stream_status.ECM_id);
+    }
+
+    // Cannot open the same stream twice, cannot use an unknown stream.
+    ts::ecmgscs::StreamStatus dummy_status;
+    const ts::ByteBlock dummy_cw(ts::CW_BYTES, 0);
+    CPPUNIT_ASSERT(!client.openStream(1, 101, 100, dummy_status));
+    CPPUNIT_ASSERT(!client.submitECM(stream_count + 1, 0, dummy_cw.data(), dummy_cw.data(), 0, 0, 0));
+
+    // Pipeline all requests. Since the ECMG holds its responses until all requests are
+    // received, this would block forever if the client waited for each response.
+    for (uint16_t cp = 0; cp < cp_count; ++cp) {
+        for (uint16_t stream = 1; stream <= stream_count; ++stream) {
+            const ts::ByteBlock cw1(CW(stream, cp));
+            const ts::ByteBlock cw2(CW(stream, cp + 1));
+            // Group the requests for all streams at each crypto-period.
+            CPPUNIT_ASSERT(client.submitECM(stream, cp, cw1.data(), cw2.data(), 0, 0, 100, stream == stream_count));
+        }
+    }
+
+    // Get all completions.
+    std::set<uint32_t> received;
+    for (size_t i = 0; i < size_t(stream_count * cp_count); ++i) {
+        ts::ECMGMultiClient::CompletionPtr completion;
+        CPPUNIT_ASSERT(client.getCompletion(completion, 5000));
+        CPPUNIT_ASSERT(completion->success);
+        CPPUNIT_ASSERT(completion->stream_id >= 1 && completion->stream_id <= stream_count);
+        CPPUNIT_ASSERT(completion->cp_number < cp_count);
+        CPPUNIT_ASSERT(completion->ECM_datagram == ECM(completion->stream_id, completion->cp_number));
+        CPPUNIT_ASSERT(received.insert((uint32_t(completion->stream_id) << 16) | completion->cp_number).second);
+    }
+    CPPUNIT_ASSERT_EQUAL(size_t(0), client.pendingCount());
+
+    // Request rejected by the ECMG.
+    const uint8_t bad_ac[] = {0xEE, 0x01};
+    CPPUNIT_ASSERT(client.submitECM(2, 50, dummy_cw.data(), dummy_cw.data(), bad_ac, sizeof(bad_ac), 0));
+    ts::ECMGMultiClient::CompletionPtr completion;
+    CPPUNIT_ASSERT(client.getCompletion(completion, 5000));
+    CPPUNIT_ASSERT(!completion->success);
+    CPPUNIT_ASSERT_EQUAL(uint16_t(2), completion->stream_id);
+    CPPUNIT_ASSERT_EQUAL(uint16_t(50), completion->cp_number);
+    CPPUNIT_ASSERT_EQUAL(uint16_t(ts::ecmgscs::Errors::inv_param_value), completion->error_status);
+
+    // A closed stream can no longer be used, the others are still usable.
+    CPPUNIT_ASSERT(client.closeStream(1));
+    CPPUNIT_ASSERT(!client.submitECM(1, 51, dummy_cw.data(), dummy_cw.data(), 0, 0, 0));
+    CPPUNIT_ASSERT(client.submitECM(3, 51, dummy_cw.data(), dummy_cw.data(), 0, 0, 0));
+    CPPUNIT_ASSERT(client.getCompletion(completion, 5000));
+    CPPUNIT_ASSERT(completion->success);
+    CPPUNIT_ASSERT_EQUAL(uint16_t(3), completion->stream_id);
+    CPPUNIT_ASSERT_EQUAL(uint16_t(51), completion->cp_number);
+
+    // Close remaining streams and channel.
+    CPPUNIT_ASSERT(client.disconnect());
+    CPPUNIT_ASSERT(!client.isConnected());
+}
+
+void ECMGMultiClientTest::testStreamError()
+{
+    const uint16_t port_number = 12352;
+
+    ECMGStub ecmg(port_number, 0);
+    ecmg.start();
+
+    ts::ECMGMultiClient client;
+    ts::ecmgscs::ChannelStatus channel_status;
+    ts::ecmgscs::StreamStatus stream_status;
+    CPPUNIT_ASSERT(client.connect(ts::SocketAddress(ts::IPAddress::LocalHost, port_number), 0x12345678, 7, channel_status, 0, &CERR));
+    CPPUNIT_ASSERT(client.openStream(1, 101, 100, stream_status));
+    CPPUNIT_ASSERT(client.openStream(2, 102, 100, stream_status));
+
+    // Two requests are delayed by the ECMG until the stream is closed.
+    const ts::ByteBlock cw(ts::CW_BYTES, 0);
+    const uint8_t delay_ac[] = {0xDD, 0x01};
+    CPPUNIT_ASSERT(client.submitECM(1, 60, cw.data(), cw.data(), delay_ac, sizeof(delay_ac), 0));
+    CPPUNIT_ASSERT(client.submitECM(1, 61, cw.data(), cw.data(), delay_ac, sizeof(delay_ac), 0));
+    CPPUNIT_ASSERT_EQUAL(size_t(2), client.pendingCount());
+
+    // The close is rejected by a stream_error without error_information.
+    // It fails the close operation, not the second pending request.
+    CPPUNIT_ASSERT(!client.closeStream(1));
+
+    // The error identifying a CW_provision failed the first request.
+    ts::ECMGMultiClient::CompletionPtr completion;
+    CPPUNIT_ASSERT(client.getCompletion(completion, 5000));
+    CPPUNIT_ASSERT(!completion->success);
+    CPPUNIT_ASSERT_EQUAL(uint16_t(1), completion->stream_id);
+    CPPUNIT_ASSERT_EQUAL(uint16_t(60), completion->cp_number);
+    CPPUNIT_ASSERT_EQUAL(uint16_t(ts::ecmgscs::Errors::out_of_compute), completion->error_status);
+
+    // The second request was aborted when the stream was forgotten.
+    CPPUNIT_ASSERT(client.getCompletion(completion, 5000));
+    CPPUNIT_ASSERT(!completion->success);
+    CPPUNIT_ASSERT_EQUAL(uint16_t(1), completion->stream_id);
+    CPPUNIT_ASSERT_EQUAL(uint16_t(61), completion->cp_number);
+    CPPUNIT_ASSERT_EQUAL(uint16_t(0), completion->error_status);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), client.pendingCount());
+
+    // The other stream is still usable.
+    CPPUNIT_ASSERT(client.submitECM(2, 62, cw.data(), cw.data(), 0, 0, 0));
+    CPPUNIT_ASSERT(client.getCompletion(completion, 5000));
+    CPPUNIT_ASSERT(completion->success);
+    CPPUNIT_ASSERT_EQUAL(uint16_t(2), completion->stream_id);
+    CPPUNIT_ASSERT_EQUAL(uint16_t(62), completion->cp_number);
+
+    CPPUNIT_ASSERT(client.disconnect());
+}
@@ -0,0 +1,280 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  CppUnit test suite for class ts::EITDatabase
+//
+//----------------------------------------------------------------------------
+
+#include "tsEITDatabase.h"
+#include "tsEIT.h"
+#include "tsShortEventDescriptor.h"
+#include "tsBinaryTable.h"
+#include "tsFormat.h"
+#include "utestCppUnitTest.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class EITDatabaseTest: public CppUnit::TestFixture
+{
+public:
+    void setUp();
+    void tearDown();
+    void testSchedule();
+    void testRepetition();
+    void testVersion();
+    void testPresentFollowing();
+
+    CPPUNIT_TEST_SUITE(EITDatabaseTest);
+    CPPUNIT_TEST(testSchedule);
+    CPPUNIT_TEST(testRepetition);
+    CPPUNIT_TEST(testVersion);
+    CPPUNIT_TEST(testPresentFollowing);
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    // Reference time of all events.
+    static const ts::Time Base;
+
+    // Build an EIT schedule with consecutive events of 15 minutes.
+    static void BuildSchedule(ts::BinaryTable& table, uint8_t index, uint8_t version, uint16_t first_event, size_t event_count);
+
+    // Add all sections of a table in the database, return the number of changed sections.
+    static size_t AddTable(ts::EITDatabase& db, const ts::BinaryTable& table);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(EITDatabaseTest);
+
+const ts::Time EITDatabaseTest::Base(2017, 10, 1, 0, 0, 0);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void EITDatabaseTest::setUp()
+{
+}
+
+// Test suite cleanup method.
+void EITDatabaseTest::tearDown()
+{
+}
+
+void EITDatabaseTest::BuildSchedule(ts::BinaryTable& table, uint8_t index, uint8_t version, uint16_t first_event, size_t event_count)
+{
+    ts::EIT eit(true, false, index, version, true, 0x1234, 0x0001, 0x0002);
+    for (uint16_t event_id = first_event; event_id < first_event + event_count; ++event_id) {
+        ts::EIT::Event& ev(eit.events[event_id]);
+        ev.start_time = Base + ts::MilliSecond(event_id) * 15 * ts::MilliSecPerMin;
+        ev.duration = 15 * 60;
+        ev.running_status = 1;
+        ev.descs.add(ts::ShortEventDescriptor("fre", ts::UString(ts::Format("Event %d v%d", int(event_id), int(version))), "Some description."));
+    }
+    eit.serialize(table);
+    CPPUNIT_ASSERT(table.isValid());
+}
+
+size_t EITDatabaseTest::AddTable(ts::EITDatabase& db, const ts::BinaryTable& table)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < table.sectionCount(); ++i) {
+        if (db.addSection(*table.sectionAt(i))) {
+            count++;
+        }
+    }
+    return count;
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void EITDatabaseTest::testSchedule()
+{
+    ts::BinaryTable table0;
+    ts::BinaryTable table1;
+    BuildSchedule(table0, 0, 0, 0, 100);
+    BuildSchedule(table1, 1, 0, 100, 100);
+    CPPUNIT_ASSERT(table0.sectionCount() > 1);
+
+    // Load the second table first, events must be sorted anyway.
+    ts::EITDatabase db;
+    CPPUNIT_ASSERT_EQUAL(table1.sectionCount(), AddTable(db, table1));
+    CPPUNIT_ASSERT_EQUAL(table0.sectionCount(), AddTable(db, table0));
+
+    const ts::EITDatabase::ServiceKey key(0x0002, 0x0001, 0x1234);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), db.serviceCount());
+    CPPUNIT_ASSERT_EQUAL(size_t(200), db.eventCount(key));
+    CPPUNIT_ASSERT_EQUAL(size_t(0), db.eventCount(ts::EITDatabase::ServiceKey(0x0002, 0x0001, 0x1235)));
+
+    std::vector<ts::EITDatabase::ServiceKey> services;
+    db.getServices(services);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), services.size());
+    CPPUNIT_ASSERT(services[0] == key);
+
+    ts::EITDatabase::SegmentSet segments;
+    db.takeChangedSegments(segments);
+    CPPUNIT_ASSERT(!segments.empty());
+    CPPUNIT_ASSERT(segments.begin()->service == key);
+    CPPUNIT_ASSERT_EQUAL(ts::TID(ts::TID_EIT_S_ACT_MIN), segments.begin()->table_id);
+    CPPUNIT_ASSERT_EQUAL(ts::TID(ts::TID_EIT_S_ACT_MIN + 1), segments.rbegin()->table_id);
+    db.takeChangedSegments(segments);
+    CPPUNIT_ASSERT(segments.empty());
+
+    // Present and following at a given time.
+    ts::EITDatabase::Event present;
+    ts::EITDatabase::Event following;
+    CPPUNIT_ASSERT(db.getPresentFollowing(key, Base + 130 * ts::MilliSecPerMin, present, following));
+    CPPUNIT_ASSERT_EQUAL(uint16_t(8), present.eventId());
+    CPPUNIT_ASSERT_EQUAL(uint16_t(9), following.eventId());
+    CPPUNIT_ASSERT(present.startTime() == Base + 120 * ts::MilliSecPerMin);
+    CPPUNIT_ASSERT(present.endTime() == Base + 135 * ts::MilliSecPerMin);
+    CPPUNIT_ASSERT_EQUAL(ts::Second(15 * 60), present.duration());
+    CPPUNIT_ASSERT_EQUAL(uint8_t(1), present.runningStatus());
+    CPPUNIT_ASSERT(!present.CAControlled());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), present.descriptors().count());
+    CPPUNIT_ASSERT_EQUAL(ts::DID(ts::DID_SHORT_EVENT), (*present.descriptors().begin()).tag());
+
+    // Exactly at the start of an event.
+    CPPUNIT_ASSERT(db.getPresentFollowing(key, Base + 150 * ts::MilliSecPerMin, present, following));
+    CPPUNIT_ASSERT_EQUAL(uint16_t(10), present.eventId());
+    CPPUNIT_ASSERT_EQUAL(uint16_t(11), following.eventId());
+
+    // Before the first event and after the last one.
+    CPPUNIT_ASSERT(!db.getPresentFollowing(key, Base - ts::MilliSecPerMin, present, following));
+    CPPUNIT_ASSERT(!present.isValid());
+    CPPUNIT_ASSERT_EQUAL(uint16_t(0), following.eventId());
+    CPPUNIT_ASSERT(following.isValid());
+    CPPUNIT_ASSERT(!db.getPresentFollowing(key, Base + 200 * 15 * ts::MilliSecPerMin, present, following));
+    CPPUNIT_ASSERT(!present.isValid());
+    CPPUNIT_ASSERT(!following.isValid());
+
+    // Time range, the first event overlaps the start time.
+    ts::EITDatabase::EventVector events;
+    CPPUNIT_ASSERT_EQUAL(size_t(4), db.getEvents(key, Base + 20 * ts::MilliSecPerMin, Base + 70 * ts::MilliSecPerMin, events));
+    CPPUNIT_ASSERT_EQUAL(uint16_t(1), events[0].eventId());
+    CPPUNIT_ASSERT_EQUAL(uint16_t(4), events[3].eventId());
+    CPPUNIT_ASSERT_EQUAL(size_t(200), db.getEvents(key, Base, Base + 1000 * 15 * ts::MilliSecPerMin, events));
+    for (size_t i = 0; i < events.size(); ++i) {
+        CPPUNIT_ASSERT_EQUAL(uint16_t(i), events[i].eventId());
+    }
+    CPPUNIT_ASSERT_EQUAL(size_t(0), db.getEvents(key, Base, Base, events));
+
+    db.clear();
+    CPPUNIT_ASSERT_EQUAL(size_t(0), db.serviceCount());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), db.eventCount(key));
+}
+
+void EITDatabaseTest::testRepetition()
+{
+    ts::BinaryTable table;
+    BuildSchedule(table, 0, 3, 0, 50);
+
+    ts::EITDatabase db;
+    CPPUNIT_ASSERT_EQUAL(table.sectionCount(), AddTable(db, table));
+    ts::EITDatabase::SegmentSet segments;
+    db.takeChangedSegments(segments);
+    CPPUNIT_ASSERT(!segments.empty());
+
+    // Repeated sections are ignored.
+    for (int i = 0; i < 10; ++i) {
+        CPPUNIT_ASSERT_EQUAL(size_t(0), AddTable(db, table));
+    }
+    db.takeChangedSegments(segments);
+    CPPUNIT_ASSERT(segments.empty());
+    CPPUNIT_ASSERT_EQUAL(size_t(50), db.eventCount(ts::EITDatabase::ServiceKey(0x0002, 0x0001, 0x1234)));
+}
+
+void EITDatabaseTest::testVersion()
+{
+    const ts::EITDatabase::ServiceKey key(0x0002, 0x0001, 0x1234);
+    ts::BinaryTable table;
+    BuildSchedule(table, 0, 0, 0, 100);
+
+    ts::EITDatabase db;
+    AddTable(db, table);
+    CPPUNIT_ASSERT_EQUAL(size_t(100), db.eventCount(key));
+
+    // New version with less events: obsolete sections are removed when the first section is received.
+    BuildSchedule(table, 0, 1, 10, 5);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), table.sectionCount());
+    ts::EITDatabase::SegmentSet segments;
+    db.takeChangedSegments(segments);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), AddTable(db, table));
+    CPPUNIT_ASSERT_EQUAL(size_t(5), db.eventCount(key));
+    db.takeChangedSegments(segments);
+    CPPUNIT_ASSERT(!segments.empty());
+
+    ts::EITDatabase::EventVector events;
+    CPPUNIT_ASSERT_EQUAL(size_t(5), db.getEvents(key, Base, Base + 1000 * 15 * ts::MilliSecPerMin, events));
+    CPPUNIT_ASSERT_EQUAL(uint16_t(10), events[0].eventId());
+    CPPUNIT_ASSERT_EQUAL(uint16_t(14), events[4].eventId());
+}
+
+void EITDatabaseTest::testPresentFollowing()
+{
+    const ts::EITDatabase::ServiceKey key(0x0002, 0x0001, 0x1234);
+
+    // Build an EIT p/f, one event per section.
+    ts::EITDatabase db;
+    for (uint8_t num = 0; num < 2; ++num) {
+        ts::EIT eit(true, true, 0, 0, true, 0x1234, 0x0001, 0x0002);
+        ts::EIT::Event& ev(eit.events[100 + num]);
+        ev.start_time = Base + 30 * num * ts::MilliSecPerMin;
+        ev.duration = (num + 1) * 30 * 60;
+        ev.running_status = num == 0 ? 4 : 1;
+        ts::BinaryTable table;
+        eit.serialize(table);
+        CPPUNIT_ASSERT_EQUAL(size_t(1), table.sectionCount());
+        const ts::Section& sect(*table.sectionAt(0));
+        CPPUNIT_ASSERT(db.addSection(ts::Section(sect.tableId(), true, sect.tableIdExtension(), 0, true, num, 1, sect.payload(), sect.payloadSize())));
+    }
+    CPPUNIT_ASSERT_EQUAL(size_t(0), db.eventCount(key));
+
+    ts::EITDatabase::Event present;
+    ts::EITDatabase::Event following;
+    CPPUNIT_ASSERT(db.getSignalledPresentFollowing(key, present, following));
+    CPPUNIT_ASSERT_EQUAL(uint16_t(100), present.eventId());
+    CPPUNIT_ASSERT_EQUAL(uint8_t(4), present.runningStatus());
+    CPPUNIT_ASSERT_EQUAL(uint16_t(101), following.eventId());
+    CPPUNIT_ASSERT_EQUAL(ts::Second(3600), following.duration());
+    CPPUNIT_ASSERT(following.startTime() == Base + 30 * ts::MilliSecPerMin);
+
+    ts::EITDatabase::SegmentSet segments;
+    db.takeChangedSegments(segments);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), segments.size());
+    CPPUNIT_ASSERT_EQUAL(ts::TID(ts::TID_EIT_PF_ACT), segments.begin()->table_id);
+    CPPUNIT_ASSERT_EQUAL(uint8_t(0), segments.begin()->segment);
+}
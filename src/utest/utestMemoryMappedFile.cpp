@@ -0,0 +1,176 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  CppUnit test suite for class ts::MemoryMappedFile
+//
+//----------------------------------------------------------------------------
+
+#include "tsMemoryMappedFile.h"
+#include "tsSysUtils.h"
+#include "tsCerrReport.h"
+#include "tsNullReport.h"
+#include "utestCppUnitTest.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class MemoryMappedFileTest: public CppUnit::TestFixture
+{
+public:
+    MemoryMappedFileTest();
+    void setUp();
+    void tearDown();
+    void testRead();
+    void testWrite();
+    void testEmpty();
+
+    CPPUNIT_TEST_SUITE(MemoryMappedFileTest);
+    CPPUNIT_TEST(testRead);
+    CPPUNIT_TEST(testWrite);
+    CPPUNIT_TEST(testEmpty);
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    std::string _fileName;
+
+    // Create the test file with the specified number of bytes.
+    void createFile(size_t size);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MemoryMappedFileTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Constructor.
+MemoryMappedFileTest::MemoryMappedFileTest() :
+    _fileName()
+{
+}
+
+// Test suite initialization method.
+void MemoryMappedFileTest::setUp()
+{
+    _fileName = ts::TempFile();
+}
+
+// Test suite cleanup method.
+void MemoryMappedFileTest::tearDown()
+{
+    // Returned value ignored on purpose, end of test, temporary file may not even exists.
+    // coverity[CHECKED_RETURN]
+    ts::DeleteFile(_fileName);
+}
+
+// Create the test file: byte at offset N has value N modulo 256.
+void MemoryMappedFileTest::createFile(size_t size)
+{
+    std::ofstream out(_fileName.c_str(), std::ios::binary);
+    for (size_t i = 0; i < size; ++i) {
+        out.put(char(i & 0xFF));
+    }
+    out.close();
+    CPPUNIT_ASSERT(ts::GetFileSize(_fileName) == int64_t(size));
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+// Test case: read-only mapping with start offset.
+void MemoryMappedFileTest::testRead()
+{
+    createFile(10000);
+
+    ts::MemoryMappedFile file;
+    CPPUNIT_ASSERT(!file.isOpen());
+    CPPUNIT_ASSERT(file.open(_fileName, 1000, false, CERR));
+    CPPUNIT_ASSERT(file.isOpen());
+    CPPUNIT_ASSERT(file.getFileName() == _fileName);
+    CPPUNIT_ASSERT(file.data() != 0);
+    CPPUNIT_ASSERT_EQUAL(size_t(9000), file.size());
+    file.adviseSequential();
+
+    bool same = true;
+    for (size_t i = 0; i < file.size(); ++i) {
+        same = same && file.data()[i] == uint8_t((i + 1000) & 0xFF);
+    }
+    CPPUNIT_ASSERT(same);
+
+    CPPUNIT_ASSERT(file.close(CERR));
+    CPPUNIT_ASSERT(!file.isOpen());
+    CPPUNIT_ASSERT(file.data() == 0);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), file.size());
+}
+
+// Test case: modify a file through a read-write mapping.
+void MemoryMappedFileTest::testWrite()
+{
+    createFile(50000);
+
+    ts::MemoryMappedFile file;
+    CPPUNIT_ASSERT(file.open(_fileName, 0, true, CERR));
+    CPPUNIT_ASSERT_EQUAL(size_t(50000), file.size());
+    file.data()[10] = 0xAA;
+    file.data()[45000] = 0xBB;
+    CPPUNIT_ASSERT(file.sync(44990, 100, CERR));
+    CPPUNIT_ASSERT(file.close(CERR));
+
+    std::ifstream in(_fileName.c_str(), std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    CPPUNIT_ASSERT_EQUAL(size_t(50000), content.size());
+    CPPUNIT_ASSERT_EQUAL(uint8_t(0xAA), uint8_t(content[10]));
+    CPPUNIT_ASSERT_EQUAL(uint8_t(0xBB), uint8_t(content[45000]));
+    CPPUNIT_ASSERT_EQUAL(uint8_t(11), uint8_t(content[11]));
+}
+
+// Test case: empty files and offsets beyond end of file.
+void MemoryMappedFileTest::testEmpty()
+{
+    createFile(0);
+
+    ts::MemoryMappedFile file;
+    CPPUNIT_ASSERT(file.open(_fileName, 0, false, CERR));
+    CPPUNIT_ASSERT_EQUAL(size_t(0), file.size());
+    CPPUNIT_ASSERT(file.close(CERR));
+
+    createFile(100);
+    CPPUNIT_ASSERT(file.open(_fileName, 200, false, CERR));
+    CPPUNIT_ASSERT_EQUAL(size_t(0), file.size());
+    CPPUNIT_ASSERT(file.close(CERR));
+
+    CPPUNIT_ASSERT(!file.open(_fileName + ".nonexistent", 0, false, NULLREP));
+    CPPUNIT_ASSERT(!file.isOpen());
+}
@@ -34,6 +34,7 @@
 #include "tsNames.h"
 #include "tsMPEG.h"
 #include "tsSysUtils.h"
+#include "tsCerrReport.h"
 #include "utestCppUnitTest.h"
 TSDUCK_SOURCE;
 
@@ -81,6 +82,7 @@ public:
     void testRunningStatus();
     void testAudioType();
     void testT2MIPacketType();
+    void testCompiledFile();
 
     CPPUNIT_TEST_SUITE(NamesTest);
     CPPUNIT_TEST(testConfigFile);
@@ -117,6 +119,7 @@ public:
     CPPUNIT_TEST(testRunningStatus);
     CPPUNIT_TEST(testAudioType);
     CPPUNIT_TEST(testT2MIPacketType);
+    CPPUNIT_TEST(testCompiledFile);
     CPPUNIT_TEST_SUITE_END();
 };
 
@@ -365,3 +368,62 @@ void NamesTest::testT2MIPacketType()
 {
     CPPUNIT_ASSERT_USTRINGS_EQUAL(u"Individual addressing", ts::names::T2MIPacketType(0x21));
 }
+
+void NamesTest::testCompiledFile()
+{
+    const std::string textFile(ts::TempFile(".names"));
+    const std::string compiledFile(textFile + ts::Names::COMPILED_SUFFIX);
+
+    std::ofstream strm(textFile.c_str());
+    strm << "# Test file" << std::endl
+         << "[Section1]" << std::endl
+         << "Bits = 16" << std::endl
+         << "0x0010 = Sixteen" << std::endl
+         << "0x0020-0x002F = Thirty-something" << std::endl
+         << "0x0100 = Two hundred fifty-six" << std::endl
+         << "[section2]" << std::endl
+         << "1 = Un" << std::endl
+         << "2 = Deux" << std::endl
+         << "[Section1]" << std::endl
+         << "0x0000 = Zero" << std::endl;
+    strm.close();
+
+    for (int pass = 0; pass < 2; ++pass) {
+        const ts::Names names(textFile);
+        CPPUNIT_ASSERT_EQUAL(size_t(0), names.errorCount());
+        CPPUNIT_ASSERT_EQUAL(pass == 1, names.isCompiledFile());
+        CPPUNIT_ASSERT_EQUAL(pass == 0 ? textFile : compiledFile, names.configurationFile());
+
+        CPPUNIT_ASSERT_USTRINGS_EQUAL(u"Zero", names.nameFromSection(u"section1", 0));
+        CPPUNIT_ASSERT_USTRINGS_EQUAL(u"Sixteen", names.nameFromSection(u" SECTION1 ", 0x10));
+        CPPUNIT_ASSERT_USTRINGS_EQUAL(u"Thirty-something", names.nameFromSection(u"Section1", 0x20));
+        CPPUNIT_ASSERT_USTRINGS_EQUAL(u"Thirty-something", names.nameFromSection(u"Section1", 0x2A));
+        CPPUNIT_ASSERT_USTRINGS_EQUAL(u"Thirty-something", names.nameFromSection(u"Section1", 0x2F));
+        CPPUNIT_ASSERT_USTRINGS_EQUAL(u"unknown (0x0030)", names.nameFromSection(u"Section1", 0x30));
+        CPPUNIT_ASSERT_USTRINGS_EQUAL(u"unknown (0x0011)", names.nameFromSection(u"Section1", 0x11));
+        CPPUNIT_ASSERT_USTRINGS_EQUAL(u"Two hundred fifty-six (0x0100)", names.nameFromSection(u"Section1", 0x100, ts::names::VALUE));
+        CPPUNIT_ASSERT_USTRINGS_EQUAL(u"unknown (0x1000)", names.nameFromSection(u"Section1", 0x1000));
+        CPPUNIT_ASSERT_USTRINGS_EQUAL(u"Deux", names.nameFromSection(u"Section2", 2));
+        CPPUNIT_ASSERT_USTRINGS_EQUAL(u"Un", names.nameFromSectionWithFallback(u"Section2", 0x101, 1));
+        CPPUNIT_ASSERT_USTRINGS_EQUAL(u"unknown (0x03)", names.nameFromSection(u"Section3", 3, ts::names::NAME, 8));
+
+        if (pass == 0) {
+            CPPUNIT_ASSERT(names.saveCompiledFile(compiledFile, CERR));
+        }
+    }
+
+    // The compiled form of the DVB names shall be identical.
+    const ts::Names& dvb(ts::NamesDVB::Instance());
+    CPPUNIT_ASSERT(dvb.saveCompiledFile(compiledFile, CERR));
+    const ts::Names compiled(compiledFile);
+    CPPUNIT_ASSERT(compiled.isCompiledFile());
+    const ts::UChar* const sections[] = {u"TableId", u"DescriptorId", u"StreamType", u"CASystemId", u"ServiceType", u"ComponentType"};
+    for (size_t si = 0; si < sizeof(sections) / sizeof(sections[0]); ++si) {
+        for (ts::Names::Value value = 0; value < 0x1000; ++value) {
+            CPPUNIT_ASSERT_USTRINGS_EQUAL(dvb.nameFromSection(sections[si], value, ts::names::VALUE), compiled.nameFromSection(sections[si], value, ts::names::VALUE));
+        }
+    }
+
+    CPPUNIT_ASSERT_EQUAL(ts::SYS_SUCCESS, ts::DeleteFile(textFile));
+    CPPUNIT_ASSERT_EQUAL(ts::SYS_SUCCESS, ts::DeleteFile(compiledFile));
+}
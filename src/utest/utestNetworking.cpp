@@ -60,6 +60,7 @@ public:
     void testSocketAddress();
     void testTCPSocket();
     void testUDPSocket();
+    void testUDPReceiveTimeout();
 
     CPPUNIT_TEST_SUITE(NetworkingTest);
     CPPUNIT_TEST(testIPAddressConstructors);
@@ -69,6 +70,7 @@ public:
     CPPUNIT_TEST(testSocketAddress);
     CPPUNIT_TEST(testTCPSocket);
     CPPUNIT_TEST(testUDPSocket);
+    CPPUNIT_TEST(testUDPReceiveTimeout);
     CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -566,3 +568,20 @@ void NetworkingTest::testUDPSocket()
     CPPUNIT_ASSERT(sock.send(buffer, size, sender, CERR));
     CERR.debug("UDPSocketTest: main thread: reply sent");
 }
+
+void NetworkingTest::testUDPReceiveTimeout()
+{
+    // Nobody sends to this socket, the reception must fail on timeout, without error.
+    ts::UDPSocket sock;
+    CPPUNIT_ASSERT(sock.open(CERR));
+    CPPUNIT_ASSERT(sock.bind(ts::SocketAddress(ts::IPAddress::LocalHost, ts::SocketAddress::AnyPort), CERR));
+    CPPUNIT_ASSERT(sock.setReceiveTimeout(50, CERR));
+    CPPUNIT_ASSERT(!sock.timedOut());
+
+    ts::SocketAddress sender;
+    char buffer [1024];
+    size_t size = 1;
+    CPPUNIT_ASSERT(!sock.receive(buffer, sizeof(buffer), size, sender, 0, CERR));
+    CPPUNIT_ASSERT(sock.timedOut());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), size);
+}
@@ -0,0 +1,258 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  CppUnit test suite for class ts::PCRAnalyzer
+//
+//----------------------------------------------------------------------------
+
+#include "tsPCRAnalyzer.h"
+#include "utestCppUnitTest.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class PCRAnalyzerTest: public CppUnit::TestFixture
+{
+public:
+    void setUp();
+    void tearDown();
+    void testBitrate();
+    void testFeedPackets();
+    void testFeedPacketsDTS();
+    void testMerge();
+
+    CPPUNIT_TEST_SUITE(PCRAnalyzerTest);
+    CPPUNIT_TEST(testBitrate);
+    CPPUNIT_TEST(testFeedPackets);
+    CPPUNIT_TEST(testFeedPacketsDTS);
+    CPPUNIT_TEST(testMerge);
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    // Build a test stream: a PCR PID (one PCR every 40 packets) and a video PID.
+    // The video PID has a continuity error at packet index "error_index", if not zero.
+    static void BuildStream(ts::TSPacketVector& packets, size_t error_index);
+
+    // Build a test stream with one video PID. A PES packet with PTS and DTS starts every 40 packets.
+    static void BuildStreamDTS(ts::TSPacketVector& packets, size_t error_index);
+
+    // Serialize a PTS or DTS in a PES header, with the specified 4-bit prefix.
+    static void PutTimeStamp(uint8_t* data, uint8_t prefix, uint64_t value);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PCRAnalyzerTest);
+
+namespace {
+    // Number of packets in the test stream.
+    const size_t PACKET_COUNT = 10000;
+
+    // Bitrate of the test stream. One packet every 2700 ticks of the 27 MHz clock.
+    const ts::BitRate BITRATE = 15040000;
+}
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void PCRAnalyzerTest::setUp()
+{
+}
+
+// Test suite cleanup method.
+void PCRAnalyzerTest::tearDown()
+{
+}
+
+void PCRAnalyzerTest::BuildStream(ts::TSPacketVector& packets, size_t error_index)
+{
+    packets.resize(PACKET_COUNT);
+    uint8_t cc_pcr = 0;
+    uint8_t cc_video = 0;
+    for (size_t i = 0; i < PACKET_COUNT; ++i) {
+        ts::TSPacket& pkt(packets[i]);
+        pkt = ts::NullPacket;
+        if (i % 40 == 0) {
+            pkt.b[3] = 0x30;  // adaptation field and payload
+            pkt.b[4] = 7;     // adaptation field length
+            pkt.b[5] = 0x10;  // PCR flag
+            pkt.setPID(100);
+            pkt.setCC(cc_pcr++ & 0x0F);
+            pkt.setPCR(1000000 + uint64_t(i) * 2700);
+        }
+        else {
+            pkt.setPID(200);
+            pkt.setCC(cc_video++ & 0x0F);
+            if (error_index != 0 && i == error_index) {
+                cc_video += 5;
+            }
+        }
+    }
+}
+
+void PCRAnalyzerTest::PutTimeStamp(uint8_t* data, uint8_t prefix, uint64_t value)
+{
+    data[0] = uint8_t(prefix << 4) | uint8_t((value >> 29) & 0x0E) | 0x01;
+    data[1] = uint8_t(value >> 22);
+    data[2] = uint8_t((value >> 14) & 0xFE) | 0x01;
+    data[3] = uint8_t(value >> 7);
+    data[4] = uint8_t((value << 1) & 0xFE) | 0x01;
+}
+
+void PCRAnalyzerTest::BuildStreamDTS(ts::TSPacketVector& packets, size_t error_index)
+{
+    packets.resize(PACKET_COUNT);
+    uint8_t cc = 0;
+    for (size_t i = 0; i < PACKET_COUNT; ++i) {
+        ts::TSPacket& pkt(packets[i]);
+        pkt = ts::NullPacket;
+        pkt.setPID(200);
+        pkt.setCC(cc++ & 0x0F);
+        if (error_index != 0 && i == error_index) {
+            cc += 5;
+        }
+        if (i % 40 == 0) {
+            // PES header with PTS and DTS. One packet every 9 ticks of the 90 kHz clock.
+            static const uint8_t header[] = {0x00, 0x00, 0x01, 0xE0, 0x00, 0x00, 0x80, 0xC0, 0x0A};
+            const uint64_t dts = 100000 + uint64_t(i) * 9;
+            pkt.setPUSI();
+            ::memcpy(pkt.b + 4, header, sizeof(header));
+            PutTimeStamp(pkt.b + 13, 0x03, dts + 3000);
+            PutTimeStamp(pkt.b + 18, 0x01, dts);
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void PCRAnalyzerTest::testBitrate()
+{
+    ts::TSPacketVector packets;
+    BuildStream(packets, 0);
+
+    ts::PCRAnalyzer zer(1, 64);
+    size_t count = 0;
+    while (count < packets.size() && !zer.feedPacket(packets[count++])) {}
+
+    CPPUNIT_ASSERT(zer.bitrateIsValid());
+    CPPUNIT_ASSERT_EQUAL(size_t(64 * 40 + 1), count);
+    CPPUNIT_ASSERT_EQUAL(BITRATE, zer.bitrate188());
+    CPPUNIT_ASSERT_EQUAL(BITRATE / 188 * 204, zer.bitrate204());
+}
+
+void PCRAnalyzerTest::testFeedPackets()
+{
+    ts::TSPacketVector packets;
+    BuildStream(packets, 5001);
+
+    ts::PCRAnalyzer zer1(1, 64);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        zer1.feedPacket(packets[i]);
+    }
+
+    ts::PCRAnalyzer zer2(1, 64);
+    CPPUNIT_ASSERT(zer2.feedPackets(&packets[0], 3333));
+    CPPUNIT_ASSERT(zer2.feedPackets(&packets[3333], packets.size() - 3333));
+
+    const ts::PCRAnalyzer::Status status1(zer1);
+    const ts::PCRAnalyzer::Status status2(zer2);
+    CPPUNIT_ASSERT(status1.bitrate_valid);
+    CPPUNIT_ASSERT(status2.bitrate_valid);
+    CPPUNIT_ASSERT_EQUAL(status1.bitrate_188, status2.bitrate_188);
+    CPPUNIT_ASSERT_EQUAL(status1.bitrate_204, status2.bitrate_204);
+    CPPUNIT_ASSERT_EQUAL(status1.packet_count, status2.packet_count);
+    CPPUNIT_ASSERT_EQUAL(status1.pcr_count, status2.pcr_count);
+    CPPUNIT_ASSERT_EQUAL(status1.pcr_pids, status2.pcr_pids);
+    CPPUNIT_ASSERT_EQUAL(zer1.packetCount(200), zer2.packetCount(200));
+
+    // The continuity error drops one PCR interval.
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(PACKET_COUNT / 40 - 2), status2.pcr_count);
+}
+
+void PCRAnalyzerTest::testFeedPacketsDTS()
+{
+    ts::TSPacketVector packets;
+    BuildStreamDTS(packets, 5001);
+    CPPUNIT_ASSERT(packets[0].hasDTS());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(100000), packets[0].getDTS());
+
+    ts::PCRAnalyzer zer1;
+    zer1.resetAndUseDTS(1, 32);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        zer1.feedPacket(packets[i]);
+    }
+
+    ts::PCRAnalyzer zer2;
+    zer2.resetAndUseDTS(1, 32);
+    zer2.feedPackets(&packets[0], 4321);
+    zer2.feedPackets(&packets[4321], packets.size() - 4321);
+
+    const ts::PCRAnalyzer::Status status1(zer1);
+    const ts::PCRAnalyzer::Status status2(zer2);
+    CPPUNIT_ASSERT(status1.bitrate_valid);
+    CPPUNIT_ASSERT(status2.bitrate_valid);
+    CPPUNIT_ASSERT_EQUAL(BITRATE, status2.bitrate_188);
+    CPPUNIT_ASSERT_EQUAL(status1.bitrate_188, status2.bitrate_188);
+    CPPUNIT_ASSERT_EQUAL(status1.bitrate_204, status2.bitrate_204);
+    CPPUNIT_ASSERT_EQUAL(status1.packet_count, status2.packet_count);
+    CPPUNIT_ASSERT_EQUAL(status1.pcr_count, status2.pcr_count);
+    CPPUNIT_ASSERT_EQUAL(zer1.packetCount(200), zer2.packetCount(200));
+
+    // The continuity error drops one DTS interval.
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(PACKET_COUNT / 40 - 2), status2.pcr_count);
+}
+
+void PCRAnalyzerTest::testMerge()
+{
+    ts::TSPacketVector packets;
+    BuildStream(packets, 0);
+
+    ts::PCRAnalyzer zer1(1, 64);
+    ts::PCRAnalyzer zer2(1, 64);
+    zer1.feedPackets(&packets[0], 2000);
+    zer2.feedPackets(&packets[2000], packets.size() - 2000);
+    CPPUNIT_ASSERT(!zer1.bitrateIsValid());
+    CPPUNIT_ASSERT(zer2.bitrateIsValid());
+
+    zer1.merge(zer2);
+    CPPUNIT_ASSERT(zer1.bitrateIsValid());
+    CPPUNIT_ASSERT_EQUAL(BITRATE, zer1.bitrate188());
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(PACKET_COUNT), ts::PCRAnalyzer::Status(zer1).packet_count);
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(PACKET_COUNT - PACKET_COUNT / 40), zer1.packetCount(200));
+
+    // One PCR interval is lost between the two parts.
+    CPPUNIT_ASSERT_EQUAL(ts::PacketCounter(PACKET_COUNT / 40 - 2), ts::PCRAnalyzer::Status(zer1).pcr_count);
+}
@@ -31,9 +31,12 @@
 //
 //----------------------------------------------------------------------------
 
+#include "tsAsyncReport.h"
 #include "tsReportBuffer.h"
 #include "tsReportFile.h"
 #include "tsSysUtils.h"
+#include "tsGuard.h"
+#include "tsDecimal.h"
 #include "utestCppUnitTest.h"
 TSDUCK_SOURCE;
 
@@ -53,6 +56,9 @@ public:
     void testPrintf();
     void testByName();
     void testByStream();
+    void testAsync();
+    void testAsyncRateLimit();
+    void testAsyncOverflow();
 
     CPPUNIT_TEST_SUITE(ReportTest);
     CPPUNIT_TEST(testSeverity);
@@ -60,6 +66,9 @@ public:
     CPPUNIT_TEST(testPrintf);
     CPPUNIT_TEST(testByName);
     CPPUNIT_TEST(testByStream);
+    CPPUNIT_TEST(testAsync);
+    CPPUNIT_TEST(testAsyncRateLimit);
+    CPPUNIT_TEST(testAsyncOverflow);
     CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -323,3 +332,91 @@ void ReportTest::testByStream()
     ts::LoadStrings(value, _fileName);
     CPPUNIT_ASSERT(value == ref);
 }
+
+// A report handler which collects asynchronous messages.
+namespace {
+    class AsyncCollector: public ts::ReportHandler
+    {
+    public:
+        AsyncCollector() : gate(), messages(), warnings() {}
+        ts::Mutex gate;             // Held by the test to block the logging thread.
+        ts::StringVector messages;  // Logged messages, except warnings.
+        ts::StringVector warnings;  // Reports of dropped messages.
+        virtual void handleMessage(int severity, const std::string& msg)
+        {
+            ts::Guard lock(gate);
+            (severity == ts::Severity::Warning ? warnings : messages).push_back(msg);
+        }
+    };
+}
+
+// Test case: asynchronous log
+void ReportTest::testAsync()
+{
+    AsyncCollector handler;
+    ts::StringVector ref;
+    {
+        ts::AsyncReport log;
+        log.setMessageHandler(&handler);
+        for (int i = 0; i < 100; ++i) {
+            const std::string msg("message " + ts::Decimal(i));
+            log.info(msg);
+            ref.push_back(msg);
+        }
+        log.debug("not logged");
+        log.terminate();
+        CPPUNIT_ASSERT_EQUAL(uint64_t(0), log.droppedMessages());
+        CPPUNIT_ASSERT_EQUAL(uint64_t(0), log.limitedMessages());
+    }
+    CPPUNIT_ASSERT(handler.messages == ref);
+    CPPUNIT_ASSERT(handler.warnings.empty());
+}
+
+// Test case: asynchronous log with rate limit
+void ReportTest::testAsyncRateLimit()
+{
+    AsyncCollector handler;
+    ts::AsyncReport log(false, ts::Severity::Debug);
+    log.setMessageHandler(&handler);
+    log.setRateLimit(5);
+    CPPUNIT_ASSERT_EQUAL(size_t(5), log.getRateLimit());
+
+    // Similar messages, at most two one-second periods.
+    for (int i = 0; i < 100; ++i) {
+        log.info("packet %d", i);
+    }
+    // Distinct sites and debug messages are not limited.
+    log.info("other message");
+    for (int i = 0; i < 20; ++i) {
+        log.debug("debug %d", i);
+    }
+    log.terminate();
+
+    utest::Out() << "ReportTest::testAsyncRateLimit: " << log.limitedMessages() << " limited messages" << std::endl;
+    CPPUNIT_ASSERT(log.limitedMessages() >= 90);
+    CPPUNIT_ASSERT_EQUAL(size_t(100 + 1 + 20 + 1), size_t(handler.messages.size() + log.limitedMessages()));
+    CPPUNIT_ASSERT_EQUAL(std::string("packet 0"), handler.messages[0]);
+    CPPUNIT_ASSERT(!handler.warnings.empty());
+}
+
+// Test case: asynchronous log with queue overflow
+void ReportTest::testAsyncOverflow()
+{
+    AsyncCollector handler;
+    ts::AsyncReport log;
+    log.setMessageHandler(&handler);
+
+    // Block the logging thread and overflow the queue.
+    handler.gate.acquire();
+    for (int i = 0; i < 2000; ++i) {
+        log.info("message %d", i);
+    }
+    handler.gate.release();
+    log.terminate();
+
+    utest::Out() << "ReportTest::testAsyncOverflow: " << log.droppedMessages() << " dropped messages" << std::endl;
+    CPPUNIT_ASSERT(log.droppedMessages() >= 2000 - 512 - 1);
+    CPPUNIT_ASSERT_EQUAL(size_t(2000), size_t(handler.messages.size() + log.droppedMessages()));
+    CPPUNIT_ASSERT_EQUAL(std::string("message 0"), handler.messages[0]);
+    CPPUNIT_ASSERT(!handler.warnings.empty());
+}
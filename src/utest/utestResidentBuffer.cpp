@@ -32,6 +32,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsResidentBuffer.h"
+#include "tsSysUtils.h"
 #include "utestCppUnitTest.h"
 TSDUCK_SOURCE;
 
@@ -46,9 +47,11 @@ public:
     void setUp();
     void tearDown();
     void testResidentBuffer();
+    void testPageModes();
 
     CPPUNIT_TEST_SUITE(ResidentBufferTest);
     CPPUNIT_TEST(testResidentBuffer);
+    CPPUNIT_TEST(testPageModes);
     CPPUNIT_TEST_SUITE_END();
 };
 
@@ -86,3 +89,33 @@ void ResidentBufferTest::testResidentBuffer()
     CPPUNIT_ASSERT(buf.isLocked());
     CPPUNIT_ASSERT(buf.count() >= buf_size);
 }
+
+void ResidentBufferTest::testPageModes()
+{
+    typedef ts::ResidentBuffer<uint32_t> Buffer;
+    const size_t buf_size = 1000000;
+    const Buffer::PageMode modes[] = {Buffer::STANDARD_PAGES, Buffer::TRANSPARENT_HUGE_PAGES, Buffer::HUGE_PAGES_2MB, Buffer::HUGE_PAGES_1GB};
+
+    for (size_t i = 0; i < sizeof(modes) / sizeof(modes[0]); ++i) {
+
+        Buffer buf(buf_size, modes[i], true);
+
+        utest::Out() << "ResidentBufferTest: requested " << Buffer::PageModeName(modes[i])
+                     << ", got " << Buffer::PageModeName(buf.pageMode())
+                     << ", isLocked() = " << buf.isLocked() << std::endl;
+
+        // Fallback is always to smaller pages.
+        CPPUNIT_ASSERT(buf.pageMode() <= modes[i]);
+        CPPUNIT_ASSERT(buf.isPrefaulted());
+        CPPUNIT_ASSERT_EQUAL(buf_size, buf.count());
+        CPPUNIT_ASSERT(buf.base() != 0);
+        CPPUNIT_ASSERT_EQUAL(uint64_t(0), uint64_t(buf.base()) % ts::MemoryPageSize());
+
+        for (size_t n = 0; n < buf_size; ++n) {
+            buf.base()[n] = uint32_t(n);
+        }
+        for (size_t n = 0; n < buf_size; n += 997) {
+            CPPUNIT_ASSERT_EQUAL(uint32_t(n), buf.base()[n]);
+        }
+    }
+}
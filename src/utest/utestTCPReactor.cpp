@@ -0,0 +1,448 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  CppUnit test suite for the event-driven TCP reactor.
+//
+//----------------------------------------------------------------------------
+
+#include "tsTCPReactor.h"
+#include "tstlvReactorHandler.h"
+#include "tstlvConnection.h"
+#include "tsECMGSCS.h"
+#include "tsThread.h"
+#include "tsSysUtils.h"
+#include "tsCerrReport.h"
+#include "utestCppUnitTest.h"
+#if defined(__linux)
+#include <sys/resource.h>
+#endif
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TCPReactorTest: public CppUnit::TestFixture
+{
+public:
+    TCPReactorTest();
+    void setUp();
+    void tearDown();
+    void testEcho();
+    void testTLV();
+    void testPeerClose();
+    void testOverflow();
+    void testAcceptError();
+
+    CPPUNIT_TEST_SUITE(TCPReactorTest);
+    CPPUNIT_TEST(testEcho);
+    CPPUNIT_TEST(testTLV);
+    CPPUNIT_TEST(testPeerClose);
+    CPPUNIT_TEST(testOverflow);
+    CPPUNIT_TEST(testAcceptError);
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    int _previousSeverity;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TCPReactorTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Constructor.
+TCPReactorTest::TCPReactorTest() :
+    _previousSeverity(0)
+{
+}
+
+// Test suite initialization method.
+void TCPReactorTest::setUp()
+{
+    _previousSeverity = CERR.debugLevel();
+    if (utest::DebugMode()) {
+        CERR.setDebugLevel(ts::Severity::Debug);
+    }
+}
+
+// Test suite cleanup method.
+void TCPReactorTest::tearDown()
+{
+    CERR.setDebugLevel(_previousSeverity);
+}
+
+
+//----------------------------------------------------------------------------
+// Test utilities.
+//----------------------------------------------------------------------------
+
+namespace {
+    // A handler which echoes all received data.
+    class EchoHandler: public ts::TCPReactorHandlerInterface
+    {
+    public:
+        size_t connected;
+        size_t disconnected;
+        EchoHandler() : connected(0), disconnected(0) {}
+        virtual void handleConnected(ts::TCPReactor& reactor, ts::TCPConnection& connection) override
+        {
+            connected++;
+        }
+        virtual size_t handleReceived(ts::TCPReactor& reactor, ts::TCPConnection& connection, const uint8_t* data, size_t size) override
+        {
+            reactor.send(connection, data, size, CERR);
+            return size;
+        }
+        virtual void handleDisconnected(ts::TCPReactor& reactor, ts::TCPConnection& connection) override
+        {
+            disconnected++;
+        }
+    };
+
+    // A handler which records all received data, or never consumes them.
+    class RecordHandler: public ts::TCPReactorHandlerInterface
+    {
+    public:
+        const bool      consume;
+        ts::ByteBlock   received;
+        volatile size_t connected;
+        volatile size_t disconnected;
+        RecordHandler(bool cons) : consume(cons), received(), connected(0), disconnected(0) {}
+        virtual void handleConnected(ts::TCPReactor& reactor, ts::TCPConnection& connection) override
+        {
+            connected++;
+        }
+        virtual size_t handleReceived(ts::TCPReactor& reactor, ts::TCPConnection& connection, const uint8_t* data, size_t size) override
+        {
+            if (!consume) {
+                return 0;
+            }
+            received.append(data, size);
+            return size;
+        }
+        virtual void handleDisconnected(ts::TCPReactor& reactor, ts::TCPConnection& connection) override
+        {
+            disconnected++;
+        }
+    };
+
+    // Wait until a handler is notified of a disconnection, at most 5 seconds.
+    bool WaitDisconnected(const RecordHandler& handler)
+    {
+        for (int i = 0; i < 500 && handler.disconnected == 0; ++i) {
+            ts::SleepThread(10);
+        }
+        return handler.disconnected > 0;
+    }
+
+    // An ECMG stand-in which only answers channel_setup with channel_status.
+    class ChannelHandler: public ts::tlv::ReactorHandler
+    {
+    public:
+        size_t messages;
+        ChannelHandler() : ts::tlv::ReactorHandler(ts::ecmgscs::Protocol::Instance()), messages(0) {}
+        virtual void handleMessage(ts::TCPReactor& reactor, ts::TCPConnection& connection, const ts::tlv::MessagePtr& msg) override
+        {
+            messages++;
+            const ts::ecmgscs::ChannelSetup* const req = dynamic_cast<ts::ecmgscs::ChannelSetup*>(msg.pointer());
+            if (req != 0) {
+                ts::ecmgscs::ChannelStatus resp;
+                resp.channel_id = req->channel_id;
+                resp.section_TSpkt_flag = true;
+                resp.ECM_rep_period = 100;
+                resp.max_streams = 100;
+                resp.min_CP_duration = 10;
+                resp.lead_CW = 1;
+                resp.CW_per_msg = 2;
+                resp.max_comp_time = 100;
+                CPPUNIT_ASSERT(send(reactor, connection, resp, CERR));
+            }
+        }
+    };
+
+    // A thread running a reactor with one server.
+    class ReactorThread: public ts::Thread
+    {
+    private:
+        ts::TCPServer  _server;
+        ts::TCPReactor _reactor;
+    public:
+        // Constructor: open the server socket and the reactor.
+        ReactorThread(uint16_t port_number, ts::TCPReactorHandlerInterface* handler) :
+            _server(),
+            _reactor()
+        {
+            const ts::SocketAddress address(ts::IPAddress::LocalHost, port_number);
+            CPPUNIT_ASSERT(_server.open(CERR));
+            CPPUNIT_ASSERT(_server.reusePort(true, CERR));
+            CPPUNIT_ASSERT(_server.bind(address, CERR));
+            CPPUNIT_ASSERT(_server.listen(50, CERR));
+            CPPUNIT_ASSERT(_reactor.open(CERR));
+            CPPUNIT_ASSERT(_reactor.addServer(_server, handler, CERR));
+        }
+
+        // Destructor: stop the reactor.
+        ~ReactorThread()
+        {
+            _reactor.stop();
+            waitForTermination();
+            CPPUNIT_ASSERT(_reactor.close(CERR));
+            _server.close(CERR);
+        }
+
+        // Thread execution
+        virtual void main()
+        {
+            CPPUNIT_ASSERT(_reactor.run(CERR));
+        }
+    };
+
+    // Connect a client to the local server.
+    void Connect(ts::TCPConnection& client, uint16_t port_number)
+    {
+        CPPUNIT_ASSERT(client.open(CERR));
+        CPPUNIT_ASSERT(client.bind(ts::SocketAddress(ts::IPAddress::LocalHost, ts::SocketAddress::AnyPort), CERR));
+        CPPUNIT_ASSERT(client.connect(ts::SocketAddress(ts::IPAddress::LocalHost, port_number), CERR));
+    }
+
+    // Disconnect a client.
+    void Disconnect(ts::TCPConnection& client)
+    {
+        client.disconnect(NULLREP);
+        client.close(NULLREP);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void TCPReactorTest::testEcho()
+{
+#if !defined(__windows)
+    const uint16_t port_number = 12347;
+    const size_t client_count = 5;
+
+    EchoHandler handler;
+    {
+        ReactorThread server(port_number, &handler);
+        server.start();
+
+        ts::TCPConnection clients[client_count];
+        for (size_t i = 0; i < client_count; ++i) {
+            Connect(clients[i], port_number);
+        }
+
+        // Small messages, interleaved on all clients.
+        for (size_t i = 0; i < client_count; ++i) {
+            const ts::ByteBlock data(10 + i, uint8_t(i));
+            CPPUNIT_ASSERT(clients[i].send(data.data(), data.size(), CERR));
+        }
+        for (size_t i = 0; i < client_count; ++i) {
+            ts::ByteBlock data(10 + i, 0xFF);
+            CPPUNIT_ASSERT(clients[i].receive(data.data(), data.size(), 0, CERR));
+            CPPUNIT_ASSERT(data == ts::ByteBlock(10 + i, uint8_t(i)));
+        }
+
+        // A large block, larger than the socket buffers, forces the reactor
+        // to buffer its output. Send it in chunks while reading the echo.
+        ts::ByteBlock large(4 * 1024 * 1024);
+        for (size_t i = 0; i < large.size(); ++i) {
+            large[i] = uint8_t(i * 7);
+        }
+        ts::ByteBlock echo(large.size());
+        const size_t chunk = 64 * 1024;
+        for (size_t i = 0; i < large.size(); i += chunk) {
+            CPPUNIT_ASSERT(clients[0].send(&large[i], chunk, CERR));
+            CPPUNIT_ASSERT(clients[0].receive(&echo[i], chunk, 0, CERR));
+        }
+        CPPUNIT_ASSERT(echo == large);
+
+        for (size_t i = 0; i < client_count; ++i) {
+            Disconnect(clients[i]);
+        }
+    }
+    CPPUNIT_ASSERT_EQUAL(client_count, handler.connected);
+    CPPUNIT_ASSERT_EQUAL(client_count, handler.disconnected);
+#endif
+}
+
+void TCPReactorTest::testTLV()
+{
+#if !defined(__windows)
+    const uint16_t port_number = 12348;
+    const size_t client_count = 4;
+
+    ChannelHandler handler;
+    ReactorThread server(port_number, &handler);
+    server.start();
+
+    typedef ts::SafePtr<ts::tlv::Connection<ts::Mutex>, ts::NullMutex> ConnectionPtr;
+    std::vector<ConnectionPtr> clients;
+    for (size_t i = 0; i < client_count; ++i) {
+        clients.push_back(new ts::tlv::Connection<ts::Mutex>(ts::ecmgscs::Protocol::Instance(), true, 3));
+        Connect(*clients[i], port_number);
+    }
+
+    // Send all requests before reading any response.
+    for (size_t i = 0; i < client_count; ++i) {
+        ts::ecmgscs::ChannelSetup req;
+        req.channel_id = uint16_t(i + 10);
+        req.Super_CAS_id = 0x12345678;
+        CPPUNIT_ASSERT(clients[i]->send(req, CERR));
+    }
+    for (size_t i = 0; i < client_count; ++i) {
+        ts::tlv::MessagePtr msg;
+        CPPUNIT_ASSERT(clients[i]->receive(msg, 0, CERR));
+        CPPUNIT_ASSERT_EQUAL(ts::tlv::TAG(ts::ecmgscs::Tags::channel_status), msg->tag());
+        const ts::ecmgscs::ChannelStatus* const resp = dynamic_cast<ts::ecmgscs::ChannelStatus*>(msg.pointer());
+        CPPUNIT_ASSERT(resp != 0);
+        CPPUNIT_ASSERT_EQUAL(uint16_t(i + 10), resp->channel_id);
+    }
+
+    // An invalid message (unknown tag) gets an automatic channel_error.
+    const uint8_t invalid[] = {0x03, 0x7E, 0x7E, 0x00, 0x00};
+    CPPUNIT_ASSERT(clients[0]->sendSerialized(invalid, sizeof(invalid), CERR));
+    ts::tlv::MessagePtr msg;
+    CPPUNIT_ASSERT(clients[0]->receive(msg, 0, CERR));
+    CPPUNIT_ASSERT_EQUAL(ts::tlv::TAG(ts::ecmgscs::Tags::channel_error), msg->tag());
+
+    for (size_t i = 0; i < client_count; ++i) {
+        Disconnect(*clients[i]);
+    }
+#endif
+}
+
+void TCPReactorTest::testPeerClose()
+{
+#if !defined(__windows)
+    const uint16_t port_number = 12349;
+
+    // Data which are sent just before closing the connection are all delivered
+    // to the handler, even when they are larger than one read on the socket.
+    ts::ByteBlock data(1024 * 1024);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = uint8_t(i * 3);
+    }
+
+    RecordHandler handler(true);
+    {
+        ReactorThread server(port_number, &handler);
+        server.start();
+
+        ts::TCPConnection client;
+        Connect(client, port_number);
+        CPPUNIT_ASSERT(client.send(data.data(), data.size(), CERR));
+        Disconnect(client);
+        CPPUNIT_ASSERT(WaitDisconnected(handler));
+    }
+    CPPUNIT_ASSERT_EQUAL(size_t(1), size_t(handler.disconnected));
+    CPPUNIT_ASSERT_EQUAL(data.size(), handler.received.size());
+    CPPUNIT_ASSERT(handler.received == data);
+#endif
+}
+
+void TCPReactorTest::testOverflow()
+{
+#if !defined(__windows)
+    const uint16_t port_number = 12350;
+
+    // A handler which never consumes its input is disconnected when the input buffer is full.
+    RecordHandler handler(false);
+    {
+        ReactorThread server(port_number, &handler);
+        server.start();
+
+        ts::TCPConnection client;
+        Connect(client, port_number);
+        const ts::ByteBlock data(64 * 1024, 0x47);
+        for (size_t size = 0; size <= ts::TCPReactor::MAX_INPUT_SIZE && handler.disconnected == 0; size += data.size()) {
+            // The send fails if the reactor has already disconnected.
+            client.send(data.data(), data.size(), NULLREP);
+        }
+        CPPUNIT_ASSERT(WaitDisconnected(handler));
+        Disconnect(client);
+    }
+    CPPUNIT_ASSERT_EQUAL(size_t(1), size_t(handler.disconnected));
+    CPPUNIT_ASSERT(handler.received.empty());
+#endif
+}
+
+void TCPReactorTest::testAcceptError()
+{
+#if defined(__linux)
+    const uint16_t port_number = 12351;
+    const size_t client_count = 5;
+
+    // When the server cannot accept clients because there is no more file descriptor,
+    // the pending clients are accepted later, without new incoming connection.
+    RecordHandler handler(true);
+    {
+        ReactorThread server(port_number, &handler);
+        server.start();
+
+        // Open the client sockets first, then forbid any new file descriptor.
+        ts::TCPConnection clients[client_count];
+        for (size_t i = 0; i < client_count; ++i) {
+            CPPUNIT_ASSERT(clients[i].open(CERR));
+        }
+        const int next_fd = ::dup(0);
+        CPPUNIT_ASSERT(next_fd >= 0);
+        ::close(next_fd);
+        ::rlimit saved;
+        CPPUNIT_ASSERT(::getrlimit(RLIMIT_NOFILE, &saved) == 0);
+        ::rlimit limited(saved);
+        limited.rlim_cur = ::rlim_t(next_fd);
+        CPPUNIT_ASSERT(::setrlimit(RLIMIT_NOFILE, &limited) == 0);
+
+        // The connections are completed in the backlog of the server, the reactor fails to accept them.
+        for (size_t i = 0; i < client_count; ++i) {
+            CPPUNIT_ASSERT(clients[i].connect(ts::SocketAddress(ts::IPAddress::LocalHost, port_number), CERR));
+        }
+        ts::SleepThread(3 * ts::TCPReactor::ACCEPT_RETRY_DELAY);
+        CPPUNIT_ASSERT_EQUAL(size_t(0), size_t(handler.connected));
+
+        // Without new incoming connection, all pending clients are accepted after the retry delay.
+        CPPUNIT_ASSERT(::setrlimit(RLIMIT_NOFILE, &saved) == 0);
+        for (int i = 0; i < 500 && handler.connected < client_count; ++i) {
+            ts::SleepThread(10);
+        }
+        CPPUNIT_ASSERT_EQUAL(client_count, size_t(handler.connected));
+
+        for (size_t i = 0; i < client_count; ++i) {
+            Disconnect(clients[i]);
+        }
+    }
+#endif
+}
@@ -0,0 +1,370 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  CppUnit test suite for TLV messages (ECMG <=> SCS, EMMG/PDG <=> MUX).
+//
+//----------------------------------------------------------------------------
+
+#include "tstlvSerializer.h"
+#include "tstlvMessageFactory.h"
+#include "tsECMGSCS.h"
+#include "tsEMMGMUX.h"
+#include "utestCppUnitTest.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TLVTest: public CppUnit::TestFixture
+{
+public:
+    void setUp();
+    void tearDown();
+    void testSerializer();
+    void testCWProvision();
+    void testDataProvision();
+    void testReuseFactory();
+    void testReuseCompound();
+    void testInvalid();
+
+    CPPUNIT_TEST_SUITE(TLVTest);
+    CPPUNIT_TEST(testSerializer);
+    CPPUNIT_TEST(testCWProvision);
+    CPPUNIT_TEST(testDataProvision);
+    CPPUNIT_TEST(testReuseFactory);
+    CPPUNIT_TEST(testReuseCompound);
+    CPPUNIT_TEST(testInvalid);
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    // Serialize a message in a byte block, replacing previous content.
+    static void Serialize(ts::ByteBlockPtr& bb, const ts::tlv::Message& msg);
+
+    // Build a typical ECM_response message.
+    static void BuildECMResponse(ts::ecmgscs::ECMResponse& msg, uint16_t stream_id, uint16_t cp_number);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TLVTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void TLVTest::setUp()
+{
+}
+
+// Test suite cleanup method.
+void TLVTest::tearDown()
+{
+}
+
+void TLVTest::Serialize(ts::ByteBlockPtr& bb, const ts::tlv::Message& msg)
+{
+    if (bb.isNull()) {
+        bb = new ts::ByteBlock;
+    }
+    bb->clear();
+    ts::tlv::Serializer zer(bb);
+    msg.serialize(zer);
+}
+
+void TLVTest::BuildECMResponse(ts::ecmgscs::ECMResponse& msg, uint16_t stream_id, uint16_t cp_number)
+{
+    msg.channel_id = 0x0001;
+    msg.stream_id = stream_id;
+    msg.CP_number = cp_number;
+    // An ECM section of 4 TS packets.
+    msg.ECM_datagram.resize(4 * 188);
+    for (size_t i = 0; i < msg.ECM_datagram.size(); ++i) {
+        msg.ECM_datagram[i] = uint8_t(i + cp_number);
+    }
+}
+
+namespace {
+    // A protocol syntax without message classes.
+    class SyntaxProtocol: public ts::tlv::Protocol
+    {
+    public:
+        virtual void factory(const ts::tlv::MessageFactory& mf, ts::tlv::MessagePtr& msg) const override
+        {
+            msg.clear();
+        }
+        virtual void buildErrorResponse(const ts::tlv::MessageFactory& mf, ts::tlv::MessagePtr& msg) const override
+        {
+            msg.clear();
+        }
+    };
+
+    // Serialize a command 0x0100 with a number of compound parameters.
+    // If invalid is true, the last compound parameter has an invalid size.
+    void SerializeCompounds(ts::ByteBlockPtr& bb, uint16_t count, bool invalid)
+    {
+        bb->clear();
+        ts::tlv::Serializer zer(bb);
+        zer.openTLV(0x0100);
+        zer.putUInt16(0x0002, count);
+        for (uint16_t i = 0; i < count; ++i) {
+            // The serializer does not nest TLV, build the content of the compound TLV apart.
+            ts::ByteBlockPtr value(new ts::ByteBlock);
+            ts::tlv::Serializer vzer(value);
+            if (invalid && i + 1 == count) {
+                vzer.putUInt8(0x0001, uint8_t(i));
+            }
+            else {
+                vzer.putUInt16(0x0001, i);
+            }
+            zer.put(0x0010, *value);
+        }
+        zer.closeTLV();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------------
+
+void TLVTest::testSerializer()
+{
+    ts::ByteBlockPtr bb(new ts::ByteBlock);
+    {
+        ts::tlv::Serializer zer(bb);
+        zer.putUInt8(0x1234, 0x56);
+        zer.putUInt16(0x1235, 0x789A);
+        zer.putInt32(0x1236, -2);
+        zer.put(0x1237, std::string("AB"));
+        zer.put(0x1238, ts::ByteBlock());
+        zer.openTLV(0x1239);
+        zer.put(uint16_t(0xBCDE));
+        zer.closeTLV();
+    }
+
+    static const uint8_t expected[] = {
+        0x12, 0x34, 0x00, 0x01, 0x56,
+        0x12, 0x35, 0x00, 0x02, 0x78, 0x9A,
+        0x12, 0x36, 0x00, 0x04, 0xFF, 0xFF, 0xFF, 0xFE,
+        0x12, 0x37, 0x00, 0x02, 'A', 'B',
+        0x12, 0x38, 0x00, 0x00,
+        0x12, 0x39, 0x00, 0x02, 0xBC, 0xDE,
+    };
+    CPPUNIT_ASSERT(*bb == ts::ByteBlock(expected, sizeof(expected)));
+}
+
+void TLVTest::testCWProvision()
+{
+    ts::ecmgscs::CWProvision msg;
+    msg.channel_id = 0x0012;
+    msg.stream_id = 0x0034;
+    msg.CP_number = 27;
+    msg.has_CP_duration = true;
+    msg.CP_duration = 100;
+    msg.has_access_criteria = true;
+    msg.access_criteria = ts::ByteBlock(5, 0xAC);
+    msg.CP_CW_combination.push_back(ts::ecmgscs::CPCWCombination(27, ts::ByteBlock(8, 0x27)));
+    msg.CP_CW_combination.push_back(ts::ecmgscs::CPCWCombination(28, ts::ByteBlock(8, 0x28)));
+
+    ts::ByteBlockPtr bb;
+    Serialize(bb, msg);
+
+    ts::tlv::MessageFactory mf(*bb, ts::ecmgscs::Protocol::Instance());
+    CPPUNIT_ASSERT_EQUAL(ts::tlv::OK, mf.errorStatus());
+    CPPUNIT_ASSERT_EQUAL(ts::tlv::TAG(ts::ecmgscs::Tags::CW_provision), mf.commandTag());
+    CPPUNIT_ASSERT_EQUAL(size_t(2), mf.count(ts::ecmgscs::Tags::CP_CW_combination));
+    CPPUNIT_ASSERT_EQUAL(size_t(0), mf.count(ts::ecmgscs::Tags::CW_encryption));
+
+    ts::tlv::MessagePtr gen;
+    mf.factory(gen);
+    ts::ecmgscs::CWProvision* res = dynamic_cast<ts::ecmgscs::CWProvision*>(gen.pointer());
+    CPPUNIT_ASSERT(res != 0);
+    CPPUNIT_ASSERT_EQUAL(uint16_t(0x0012), res->channel_id);
+    CPPUNIT_ASSERT_EQUAL(uint16_t(0x0034), res->stream_id);
+    CPPUNIT_ASSERT_EQUAL(uint16_t(27), res->CP_number);
+    CPPUNIT_ASSERT(res->has_CP_duration);
+    CPPUNIT_ASSERT_EQUAL(uint16_t(100), res->CP_duration);
+    CPPUNIT_ASSERT(res->has_access_criteria);
+    CPPUNIT_ASSERT(res->access_criteria == msg.access_criteria);
+    CPPUNIT_ASSERT(!res->has_CW_encryption);
+
+    // The order of occurences of a parameter is preserved.
+    CPPUNIT_ASSERT_EQUAL(size_t(2), res->CP_CW_combination.size());
+    CPPUNIT_ASSERT_EQUAL(uint16_t(27), res->CP_CW_combination[0].CP);
+    CPPUNIT_ASSERT(res->CP_CW_combination[0].CW == ts::ByteBlock(8, 0x27));
+    CPPUNIT_ASSERT_EQUAL(uint16_t(28), res->CP_CW_combination[1].CP);
+    CPPUNIT_ASSERT(res->CP_CW_combination[1].CW == ts::ByteBlock(8, 0x28));
+
+    // Serializing the result gives the same binary message.
+    ts::ByteBlockPtr bb2;
+    Serialize(bb2, *res);
+    CPPUNIT_ASSERT(*bb == *bb2);
+}
+
+void TLVTest::testDataProvision()
+{
+    ts::emmgmux::DataProvision msg;
+    msg.channel_id = 0x0005;
+    msg.stream_id = 0x0006;
+    msg.client_id = 0x12345678;
+    msg.data_id = 0x0007;
+    for (uint8_t i = 0; i < 5; ++i) {
+        msg.datagram.push_back(new ts::ByteBlock(188, i));
+    }
+
+    ts::ByteBlockPtr bb;
+    Serialize(bb, msg);
+
+    ts::tlv::MessageFactory mf(bb->data(), bb->size(), ts::emmgmux::Protocol::Instance());
+    CPPUNIT_ASSERT_EQUAL(ts::tlv::OK, mf.errorStatus());
+
+    ts::tlv::MessagePtr gen;
+    mf.factory(gen);
+    ts::emmgmux::DataProvision* res = dynamic_cast<ts::emmgmux::DataProvision*>(gen.pointer());
+    CPPUNIT_ASSERT(res != 0);
+    CPPUNIT_ASSERT_EQUAL(uint16_t(0x0005), res->channel_id);
+    CPPUNIT_ASSERT_EQUAL(uint16_t(0x0006), res->stream_id);
+    CPPUNIT_ASSERT_EQUAL(uint32_t(0x12345678), res->client_id);
+    CPPUNIT_ASSERT_EQUAL(uint16_t(0x0007), res->data_id);
+    CPPUNIT_ASSERT_EQUAL(size_t(5), res->datagram.size());
+    for (size_t i = 0; i < res->datagram.size(); ++i) {
+        CPPUNIT_ASSERT(*res->datagram[i] == ts::ByteBlock(188, uint8_t(i)));
+    }
+}
+
+void TLVTest::testReuseFactory()
+{
+    ts::tlv::MessageFactory mf(ts::ecmgscs::Protocol::Instance());
+    CPPUNIT_ASSERT(mf.errorStatus() != ts::tlv::OK);
+
+    ts::ByteBlockPtr bb;
+    ts::ecmgscs::ECMResponse msg;
+    ts::ByteBlock ecm;
+
+    for (uint16_t cp = 0; cp < 10; ++cp) {
+        BuildECMResponse(msg, cp + 100, cp);
+        Serialize(bb, msg);
+
+        // Decode directly into caller-owned fields.
+        CPPUNIT_ASSERT(mf.analyze(bb->data(), bb->size()));
+        CPPUNIT_ASSERT_EQUAL(ts::tlv::TAG(ts::ecmgscs::Tags::ECM_response), mf.commandTag());
+        CPPUNIT_ASSERT_EQUAL(uint16_t(cp + 100), mf.get<uint16_t>(ts::ecmgscs::Tags::ECM_stream_id));
+        CPPUNIT_ASSERT_EQUAL(cp, mf.get<uint16_t>(ts::ecmgscs::Tags::CP_number));
+        mf.get(ts::ecmgscs::Tags::ECM_datagram, ecm);
+        CPPUNIT_ASSERT(ecm == msg.ECM_datagram);
+
+        // An invalid message in the middle does not disturb the next ones.
+        CPPUNIT_ASSERT(!mf.analyze(bb->data(), bb->size() - 1));
+        CPPUNIT_ASSERT_EQUAL(ts::tlv::InvalidMessage, mf.errorStatus());
+        CPPUNIT_ASSERT_EQUAL(size_t(0), mf.count(ts::ecmgscs::Tags::CP_number));
+    }
+}
+
+void TLVTest::testReuseCompound()
+{
+    // Command 0x0100 has one uint16 parameter 0x0002 and up to 10 compound
+    // parameters 0x0010. The compound TLV 0x0010 contains one uint16 parameter 0x0001.
+    SyntaxProtocol inner;
+    inner.add(0x0010, 0x0001, 2, 2, 1, 1);
+    SyntaxProtocol protocol;
+    protocol.add(0x0100, 0x0002, 2, 2, 1, 1);
+    protocol.add(0x0100, 0x0010, &inner, 0, 10);
+
+    ts::tlv::MessageFactory mf(&protocol);
+    ts::ByteBlockPtr bb(new ts::ByteBlock);
+    std::vector<ts::tlv::MessageFactory::Parameter> params;
+
+    // Variable number of compound parameters, their analyzers are reused.
+    const uint16_t counts[] = {3, 1, 0, 5, 2, 5};
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i) {
+        SerializeCompounds(bb, counts[i], false);
+        CPPUNIT_ASSERT(mf.analyze(bb->data(), bb->size()));
+        CPPUNIT_ASSERT_EQUAL(counts[i], mf.get<uint16_t>(0x0002));
+        CPPUNIT_ASSERT_EQUAL(size_t(counts[i]), mf.count(0x0010));
+        mf.get(0x0010, params);
+        CPPUNIT_ASSERT_EQUAL(size_t(counts[i]), params.size());
+        for (size_t j = 0; j < params.size(); ++j) {
+            // Each compound TLV is 10 bytes: tag, length, inner parameter of 6 bytes.
+            CPPUNIT_ASSERT_EQUAL(size_t(10), params[j].tlv_size);
+            CPPUNIT_ASSERT(params[j].tlv_addr == bb->data() + 10 + 10 * j);
+        }
+
+        // An invalid compound parameter is reported, even in a reused analyzer.
+        if (counts[i] > 0) {
+            SerializeCompounds(bb, counts[i], true);
+            CPPUNIT_ASSERT(!mf.analyze(bb->data(), bb->size()));
+            CPPUNIT_ASSERT_EQUAL(ts::tlv::InvalidParameterLength, mf.errorStatus());
+            CPPUNIT_ASSERT_EQUAL(uint16_t(10 + 10 * (counts[i] - 1) + 4), mf.errorInformation());
+        }
+    }
+}
+
+void TLVTest::testInvalid()
+{
+    const ts::tlv::Protocol* const protocol = ts::ecmgscs::Protocol::Instance();
+    ts::ByteBlockPtr bb(new ts::ByteBlock);
+
+    // ECM_response with missing parameters.
+    {
+        ts::tlv::Serializer zer(bb);
+        zer.putUInt8(protocol->version());
+        zer.openTLV(ts::ecmgscs::Tags::ECM_response);
+        zer.putUInt16(ts::ecmgscs::Tags::ECM_channel_id, 1);
+        zer.putUInt16(ts::ecmgscs::Tags::ECM_stream_id, 2);
+        zer.putUInt16(ts::ecmgscs::Tags::CP_number, 3);
+        zer.closeTLV();
+    }
+    ts::tlv::MessageFactory mf1(*bb, protocol);
+    CPPUNIT_ASSERT_EQUAL(ts::tlv::MissingParameter, mf1.errorStatus());
+    CPPUNIT_ASSERT_EQUAL(uint16_t(ts::ecmgscs::Tags::ECM_datagram), mf1.errorInformation());
+
+    // Invalid parameter length.
+    bb->clear();
+    {
+        ts::tlv::Serializer zer(bb);
+        zer.putUInt8(protocol->version());
+        zer.openTLV(ts::ecmgscs::Tags::ECM_response);
+        zer.putUInt16(ts::ecmgscs::Tags::ECM_channel_id, 1);
+        zer.putUInt8(ts::ecmgscs::Tags::ECM_stream_id, 2);
+        zer.closeTLV();
+    }
+    ts::tlv::MessageFactory mf2(*bb, protocol);
+    CPPUNIT_ASSERT_EQUAL(ts::tlv::InvalidParameterLength, mf2.errorStatus());
+    CPPUNIT_ASSERT_EQUAL(uint16_t(11), mf2.errorInformation());
+
+    // Unsupported version.
+    ts::ecmgscs::ECMResponse msg;
+    BuildECMResponse(msg, 1, 1);
+    Serialize(bb, msg);
+    (*bb)[0]++;
+    ts::tlv::MessageFactory mf3(*bb, protocol);
+    CPPUNIT_ASSERT_EQUAL(ts::tlv::UnsupportedVersion, mf3.errorStatus());
+}
@@ -0,0 +1,189 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  CppUnit test suite for class ts::TSSynchronizer
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSSynchronizer.h"
+#include "utestCppUnitTest.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TSSynchronizerTest: public CppUnit::TestFixture
+{
+public:
+    void setUp();
+    void tearDown();
+    void testFindSync();
+    void testFormats();
+    void testStreaming();
+
+    CPPUNIT_TEST_SUITE(TSSynchronizerTest);
+    CPPUNIT_TEST(testFindSync);
+    CPPUNIT_TEST(testFormats);
+    CPPUNIT_TEST(testStreaming);
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    // Append garbage bytes which never contain a sync byte.
+    static void AddGarbage(ts::ByteBlock& data, size_t size);
+
+    // Append packets with a given encapsulation. The packet index is stored after the TS header.
+    static void AddPackets(ts::ByteBlock& data, size_t count, uint32_t first_index, size_t packet_size = ts::PKT_SIZE, size_t header_size = 0);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TSSynchronizerTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void TSSynchronizerTest::setUp()
+{
+}
+
+// Test suite cleanup method.
+void TSSynchronizerTest::tearDown()
+{
+}
+
+void TSSynchronizerTest::AddGarbage(ts::ByteBlock& data, size_t size)
+{
+    for (size_t i = 0; i < size; ++i) {
+        data.appendUInt8(uint8_t(0x10 + i % 0x30));
+    }
+}
+
+void TSSynchronizerTest::AddPackets(ts::ByteBlock& data, size_t count, uint32_t first_index, size_t packet_size, size_t header_size)
+{
+    for (size_t i = 0; i < count; ++i) {
+        data.append(uint8_t(0xFF), header_size);
+        data.appendUInt8(ts::SYNC_BYTE);
+        data.appendUInt8(0x01);
+        data.appendUInt8(0x00);
+        data.appendUInt8(0x10);
+        data.appendUInt32(first_index + uint32_t(i));
+        data.append(uint8_t(0xFF), packet_size - header_size - 8);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void TSSynchronizerTest::testFindSync()
+{
+    ts::ByteBlock data;
+    AddGarbage(data, 1000);
+    AddPackets(data, 20, 0);
+
+    ts::TSSynchronizer sync(10 * ts::PKT_SIZE);
+    size_t start = 0;
+    CPPUNIT_ASSERT(sync.findSync(data.data(), data.size(), start));
+    CPPUNIT_ASSERT_EQUAL(size_t(1000), start);
+    CPPUNIT_ASSERT_EQUAL(ts::PKT_SIZE, sync.packetSize());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), sync.headerSize());
+
+    // A single sync byte in the garbage is not a synchronization.
+    data[500] = ts::SYNC_BYTE;
+    CPPUNIT_ASSERT(sync.findSync(data.data(), data.size(), start));
+    CPPUNIT_ASSERT_EQUAL(size_t(1000), start);
+
+    // Not enough contiguous packets.
+    sync.setMinContiguous(30 * ts::PKT_SIZE);
+    CPPUNIT_ASSERT(!sync.findSync(data.data(), data.size(), start));
+}
+
+void TSSynchronizerTest::testFormats()
+{
+    ts::TSSynchronizer sync(5 * ts::PKT_RS_SIZE);
+    size_t start = 0;
+
+    ts::ByteBlock rs;
+    AddGarbage(rs, 77);
+    AddPackets(rs, 10, 0, ts::PKT_RS_SIZE);
+    CPPUNIT_ASSERT(sync.findSync(rs.data(), rs.size(), start));
+    CPPUNIT_ASSERT_EQUAL(size_t(77), start);
+    CPPUNIT_ASSERT_EQUAL(ts::PKT_RS_SIZE, sync.packetSize());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), sync.headerSize());
+
+    ts::ByteBlock m2ts;
+    AddGarbage(m2ts, 33);
+    AddPackets(m2ts, 10, 0, ts::PKT_M2TS_SIZE, ts::M2TS_HEADER_SIZE);
+    CPPUNIT_ASSERT(sync.findSync(m2ts.data(), m2ts.size(), start));
+    CPPUNIT_ASSERT_EQUAL(size_t(33), start);
+    CPPUNIT_ASSERT_EQUAL(ts::PKT_M2TS_SIZE, sync.packetSize());
+    CPPUNIT_ASSERT_EQUAL(ts::M2TS_HEADER_SIZE, sync.headerSize());
+
+    // Restrict to one specific format.
+    CPPUNIT_ASSERT(!sync.setPacketFormat(100, 0));
+    CPPUNIT_ASSERT(sync.setPacketFormat(ts::PKT_SIZE, 0));
+    CPPUNIT_ASSERT(!sync.findSync(m2ts.data(), m2ts.size(), start));
+    sync.setStandardPacketFormats();
+    CPPUNIT_ASSERT(sync.findSync(m2ts.data(), m2ts.size(), start));
+}
+
+void TSSynchronizerTest::testStreaming()
+{
+    ts::ByteBlock data;
+    AddGarbage(data, 555);
+    AddPackets(data, 100, 0, ts::PKT_M2TS_SIZE, ts::M2TS_HEADER_SIZE);
+    AddGarbage(data, 99);
+    AddPackets(data, 100, 100, ts::PKT_M2TS_SIZE, ts::M2TS_HEADER_SIZE);
+
+    ts::TSSynchronizer sync(8 * ts::PKT_M2TS_SIZE);
+    ts::TSPacket packets[300];
+    size_t count = 0;
+
+    // Feed the stream in small odd-size chunks.
+    for (size_t pos = 0; pos < data.size(); pos += 101) {
+        sync.feed(data.data() + pos, std::min<size_t>(101, data.size() - pos));
+        count += sync.getPackets(packets + count, 300 - count);
+    }
+
+    CPPUNIT_ASSERT(sync.isSynchronized());
+    CPPUNIT_ASSERT_EQUAL(size_t(200), count);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(555 + 99), sync.droppedBytes());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1), sync.syncLossCount());
+    for (size_t i = 0; i < count; ++i) {
+        CPPUNIT_ASSERT(packets[i].hasValidSync());
+        CPPUNIT_ASSERT_EQUAL(uint32_t(i), ts::GetUInt32(packets[i].b + 4));
+    }
+
+    sync.reset();
+    CPPUNIT_ASSERT(!sync.isSynchronized());
+}
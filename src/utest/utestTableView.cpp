@@ -0,0 +1,393 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  CppUnit test suite for the read-only table views (ts::PATView, etc.)
+//
+//----------------------------------------------------------------------------
+
+#include "tsPATView.h"
+#include "tsPMTView.h"
+#include "tsSDTView.h"
+#include "tsNITView.h"
+#include "tsEITView.h"
+#include "tsPAT.h"
+#include "tsPMT.h"
+#include "tsSDT.h"
+#include "tsNIT.h"
+#include "tsEIT.h"
+#include "tsShortEventDescriptor.h"
+#include "tsServiceDescriptor.h"
+#include "tsBinaryTable.h"
+#include "tsTime.h"
+#include "tsFormat.h"
+#include "utestCppUnitTest.h"
+TSDUCK_SOURCE;
+
+#include "tables/psi_pat_r4_sections.h"
+#include "tables/psi_pmt_planete_sections.h"
+#include "tables/psi_sdt_r3_sections.h"
+#include "tables/psi_nit_tntv23_sections.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TableViewTest: public CppUnit::TestFixture
+{
+public:
+    void setUp();
+    void tearDown();
+    void testDescriptorLoop();
+    void testPAT();
+    void testPMT();
+    void testSDT();
+    void testNIT();
+    void testEIT();
+    void testInvalid();
+    void testSchedule();
+
+    CPPUNIT_TEST_SUITE(TableViewTest);
+    CPPUNIT_TEST(testDescriptorLoop);
+    CPPUNIT_TEST(testPAT);
+    CPPUNIT_TEST(testPMT);
+    CPPUNIT_TEST(testSDT);
+    CPPUNIT_TEST(testNIT);
+    CPPUNIT_TEST(testEIT);
+    CPPUNIT_TEST(testInvalid);
+    CPPUNIT_TEST(testSchedule);
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    // Build a binary table from a sequence of sections.
+    static void LoadTable(ts::BinaryTable& table, const uint8_t* data, size_t size);
+
+    // Build a full EIT schedule (several tables) for one service.
+    static void BuildSchedule(ts::BinaryTablePtrVector& tables, size_t table_count, size_t events_per_table);
+
+    // Check that a descriptor loop view and a descriptor list are identical.
+    static void CheckDescriptors(const ts::DescriptorLoopView& view, const ts::DescriptorList& list);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TableViewTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void TableViewTest::setUp()
+{
+}
+
+// Test suite cleanup method.
+void TableViewTest::tearDown()
+{
+}
+
+void TableViewTest::LoadTable(ts::BinaryTable& table, const uint8_t* data, size_t size)
+{
+    table.clear();
+    while (size >= 3) {
+        const size_t length = std::min<size_t>(size, 3 + (ts::GetUInt16(data + 1) & 0x0FFF));
+        CPPUNIT_ASSERT(table.addSection(new ts::Section(data, length, ts::PID_NULL, ts::CRC32::CHECK)));
+        data += length;
+        size -= length;
+    }
+    CPPUNIT_ASSERT(table.isValid());
+}
+
+void TableViewTest::BuildSchedule(ts::BinaryTablePtrVector& tables, size_t table_count, size_t events_per_table)
+{
+    const ts::Time base(2017, 10, 1, 0, 0, 0);
+    uint16_t event_id = 0;
+
+    tables.clear();
+    for (size_t ti = 0; ti < table_count; ++ti) {
+        ts::EIT eit(true, false, uint8_t(ti), 0, true, 0x1234, 0x0001, 0x0002);
+        for (size_t ei = 0; ei < events_per_table; ++ei) {
+            ts::EIT::Event& ev(eit.events[++event_id]);
+            ev.start_time = base + ts::MilliSecond(event_id) * 15 * ts::MilliSecPerMin;
+            ev.duration = 15 * 60;
+            ev.running_status = 1;
+            ev.descs.add(ts::ShortEventDescriptor("fre", ts::UString(ts::Format("Event %d", int(event_id))), "Short description of the event, not too short, not too long."));
+        }
+        tables.push_back(new ts::BinaryTable);
+        eit.serialize(*tables.back());
+        CPPUNIT_ASSERT(tables.back()->isValid());
+    }
+}
+
+void TableViewTest::CheckDescriptors(const ts::DescriptorLoopView& view, const ts::DescriptorList& list)
+{
+    CPPUNIT_ASSERT_EQUAL(list.count(), view.count());
+    size_t index = 0;
+    for (ts::DescriptorLoopView::const_iterator it = view.begin(); it != view.end(); ++it, ++index) {
+        const ts::DescriptorLoopView::Entry entry(*it);
+        CPPUNIT_ASSERT(entry.isValid());
+        CPPUNIT_ASSERT_EQUAL(list[index]->tag(), entry.tag());
+        CPPUNIT_ASSERT_EQUAL(list[index]->size(), entry.size());
+        CPPUNIT_ASSERT(*list[index] == *entry.toDescriptor());
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void TableViewTest::testDescriptorLoop()
+{
+    // Three descriptors, the last one is truncated.
+    static const uint8_t data[] = {0x48, 0x02, 0x01, 0x02, 0x40, 0x00, 0x4A, 0x05, 0x01};
+
+    ts::DescriptorLoopView view(data, sizeof(data));
+    CPPUNIT_ASSERT(!view.empty());
+    CPPUNIT_ASSERT_EQUAL(size_t(2), view.count());
+
+    ts::DescriptorLoopView::const_iterator it(view.begin());
+    CPPUNIT_ASSERT_EQUAL(ts::DID(0x48), (*it).tag());
+    CPPUNIT_ASSERT_EQUAL(size_t(4), (*it).size());
+    CPPUNIT_ASSERT_EQUAL(size_t(2), (*it).payloadSize());
+    CPPUNIT_ASSERT(data + 2 == (*it).payload());
+    ++it;
+    CPPUNIT_ASSERT_EQUAL(ts::DID(0x40), (*it).tag());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), (*it).payloadSize());
+    ++it;
+    CPPUNIT_ASSERT(it == view.end());
+
+    CPPUNIT_ASSERT(view.search(0x40).isValid());
+    CPPUNIT_ASSERT(data + 4 == view.search(0x40).content());
+    CPPUNIT_ASSERT(!view.search(0x4A).isValid());
+    CPPUNIT_ASSERT(view.search(0x4A).toDescriptor().isNull());
+
+    ts::DescriptorList list;
+    view.toDescriptorList(list);
+    CheckDescriptors(view, list);
+
+    CPPUNIT_ASSERT(ts::DescriptorLoopView().empty());
+    CPPUNIT_ASSERT(ts::DescriptorLoopView(data + 6, 3).empty());
+}
+
+void TableViewTest::testPAT()
+{
+    ts::BinaryTable table;
+    LoadTable(table, psi_pat_r4_sections, sizeof(psi_pat_r4_sections));
+    const ts::PAT pat(table);
+    const ts::PATView view(table);
+    CPPUNIT_ASSERT(pat.isValid());
+    CPPUNIT_ASSERT(view.isValid());
+
+    CPPUNIT_ASSERT_EQUAL(pat.ts_id, view.tsId());
+    CPPUNIT_ASSERT_EQUAL(pat.nit_pid, view.nitPID());
+    CPPUNIT_ASSERT_EQUAL(pat.pmts.size() + (pat.nit_pid == ts::PID_NULL ? 0 : 1), view.entryCount());
+
+    for (ts::PATView::const_iterator it = view.begin(); it != view.end(); ++it) {
+        const ts::PATView::Program prg(*it);
+        if (prg.programNumber() != 0) {
+            CPPUNIT_ASSERT(pat.pmts.find(prg.programNumber()) != pat.pmts.end());
+            CPPUNIT_ASSERT_EQUAL(pat.pmts.find(prg.programNumber())->second, prg.pid());
+        }
+    }
+    for (ts::PAT::ServiceMap::const_iterator it = pat.pmts.begin(); it != pat.pmts.end(); ++it) {
+        ts::PID pid = ts::PID_NULL;
+        CPPUNIT_ASSERT(view.findPMT(it->first, pid));
+        CPPUNIT_ASSERT_EQUAL(it->second, pid);
+    }
+    ts::PID pid = ts::PID_NULL;
+    CPPUNIT_ASSERT(!view.findPMT(0xFFFF, pid));
+}
+
+void TableViewTest::testPMT()
+{
+    ts::BinaryTable table;
+    LoadTable(table, psi_pmt_planete_sections, sizeof(psi_pmt_planete_sections));
+    const ts::PMT pmt(table);
+    const ts::PMTView view(table);
+    CPPUNIT_ASSERT(pmt.isValid());
+    CPPUNIT_ASSERT(view.isValid());
+
+    CPPUNIT_ASSERT_EQUAL(pmt.service_id, view.serviceId());
+    CPPUNIT_ASSERT_EQUAL(pmt.pcr_pid, view.pcrPID());
+    CheckDescriptors(view.descriptors(), pmt.descs);
+    CPPUNIT_ASSERT_EQUAL(pmt.streams.size(), view.entryCount());
+
+    for (ts::PMTView::const_iterator it = view.begin(); it != view.end(); ++it) {
+        const ts::PMTView::Stream stream(*it);
+        const ts::PMT::StreamMap::const_iterator ref(pmt.streams.find(stream.pid()));
+        CPPUNIT_ASSERT(ref != pmt.streams.end());
+        CPPUNIT_ASSERT_EQUAL(ref->second.stream_type, stream.streamType());
+        CheckDescriptors(stream.descriptors(), ref->second.descs);
+    }
+}
+
+void TableViewTest::testSDT()
+{
+    ts::BinaryTable table;
+    LoadTable(table, psi_sdt_r3_sections, sizeof(psi_sdt_r3_sections));
+    const ts::SDT sdt(table);
+    const ts::SDTView view(table);
+    CPPUNIT_ASSERT(sdt.isValid());
+    CPPUNIT_ASSERT(view.isValid());
+
+    CPPUNIT_ASSERT(view.isActual());
+    CPPUNIT_ASSERT_EQUAL(sdt.ts_id, view.tsId());
+    CPPUNIT_ASSERT_EQUAL(sdt.onetw_id, view.originalNetworkId());
+    CPPUNIT_ASSERT_EQUAL(sdt.services.size(), view.entryCount());
+
+    for (ts::SDTView::const_iterator it = view.begin(); it != view.end(); ++it) {
+        const ts::SDTView::Service srv(*it);
+        const ts::SDT::ServiceMap::const_iterator ref(sdt.services.find(srv.serviceId()));
+        CPPUNIT_ASSERT(ref != sdt.services.end());
+        CPPUNIT_ASSERT_EQUAL(ref->second.EITs_present, srv.EITsPresent());
+        CPPUNIT_ASSERT_EQUAL(ref->second.EITpf_present, srv.EITpfPresent());
+        CPPUNIT_ASSERT_EQUAL(ref->second.running_status, srv.runningStatus());
+        CPPUNIT_ASSERT_EQUAL(ref->second.CA_controlled, srv.CAControlled());
+        CPPUNIT_ASSERT_EQUAL(ref->second.serviceType(), srv.serviceType());
+        CPPUNIT_ASSERT(ref->second.serviceName() == srv.serviceName());
+        CPPUNIT_ASSERT(ref->second.providerName() == srv.providerName());
+        ts::ServiceDescriptor sd;
+        CPPUNIT_ASSERT_EQUAL(ref->second.descs.search(ts::DID_SERVICE) < ref->second.descs.count(), srv.locateServiceDescriptor(sd));
+        CPPUNIT_ASSERT_EQUAL(sd.isValid() ? sd.service_type : uint8_t(0), srv.serviceType());
+        CPPUNIT_ASSERT(!sd.isValid() || sd.service_name == srv.serviceName());
+        CheckDescriptors(srv.descriptors(), ref->second.descs);
+        utest::Out() << "TableViewTest: service " << srv.serviceId() << ": \"" << srv.serviceName() << "\"" << std::endl;
+    }
+
+    const ts::SDT::ServiceMap::const_iterator first(sdt.services.begin());
+    CPPUNIT_ASSERT(first != sdt.services.end());
+    CPPUNIT_ASSERT(view.findService(first->first).isValid());
+    CPPUNIT_ASSERT(view.findService(first->first).serviceName() == first->second.serviceName());
+    CPPUNIT_ASSERT(view.findService(769).serviceName() == ts::UString("CANAL+"));
+    CPPUNIT_ASSERT(!view.findService(0xFFFF).isValid());
+}
+
+void TableViewTest::testNIT()
+{
+    ts::BinaryTable table;
+    LoadTable(table, psi_nit_tntv23_sections, sizeof(psi_nit_tntv23_sections));
+    const ts::NIT nit(table);
+    const ts::NITView view(table);
+    CPPUNIT_ASSERT(nit.isValid());
+    CPPUNIT_ASSERT(view.isValid());
+
+    CPPUNIT_ASSERT(view.isActual());
+    CPPUNIT_ASSERT_EQUAL(nit.network_id, view.networkId());
+    CheckDescriptors(view.descriptors(), nit.descs);
+    CPPUNIT_ASSERT_EQUAL(nit.transports.size(), view.entryCount());
+
+    for (ts::NITView::const_iterator it = view.begin(); it != view.end(); ++it) {
+        const ts::NITView::Transport ts(*it);
+        const ts::NIT::TransportMap::const_iterator ref(nit.transports.find(ts::TransportStreamId(ts.tsId(), ts.originalNetworkId())));
+        CPPUNIT_ASSERT(ref != nit.transports.end());
+        CheckDescriptors(ts.descriptors(), ref->second);
+    }
+}
+
+void TableViewTest::testEIT()
+{
+    ts::BinaryTablePtrVector tables;
+    BuildSchedule(tables, 1, 200);
+    const ts::BinaryTable& table(*tables[0]);
+    CPPUNIT_ASSERT(table.sectionCount() > 1);
+
+    const ts::EIT eit(table);
+    const ts::EITView view(table);
+    CPPUNIT_ASSERT(eit.isValid());
+    CPPUNIT_ASSERT(view.isValid());
+
+    CPPUNIT_ASSERT(view.isActual());
+    CPPUNIT_ASSERT(!view.isPresentFollowing());
+    CPPUNIT_ASSERT_EQUAL(uint16_t(0x1234), view.serviceId());
+    CPPUNIT_ASSERT_EQUAL(uint16_t(0x0001), view.tsId());
+    CPPUNIT_ASSERT_EQUAL(uint16_t(0x0002), view.originalNetworkId());
+    CPPUNIT_ASSERT_EQUAL(size_t(200), view.entryCount());
+
+    for (ts::EITView::const_iterator it = view.begin(); it != view.end(); ++it) {
+        const ts::EITView::Event ev(*it);
+        const ts::EIT::EventMap::const_iterator ref(eit.events.find(ev.eventId()));
+        CPPUNIT_ASSERT(ref != eit.events.end());
+        CPPUNIT_ASSERT(ref->second.start_time == ev.startTime());
+        CPPUNIT_ASSERT_EQUAL(ref->second.duration, ev.duration());
+        CPPUNIT_ASSERT_EQUAL(ref->second.running_status, ev.runningStatus());
+        CPPUNIT_ASSERT_EQUAL(ref->second.CA_controlled, ev.CAControlled());
+        CheckDescriptors(ev.descriptors(), ref->second.descs);
+    }
+}
+
+void TableViewTest::testInvalid()
+{
+    ts::BinaryTable table;
+    LoadTable(table, psi_pat_r4_sections, sizeof(psi_pat_r4_sections));
+
+    // A PAT is not an SDT, a NIT, an EIT or a PMT.
+    const ts::SDTView sdt(table);
+    CPPUNIT_ASSERT(!sdt.isValid());
+    CPPUNIT_ASSERT(sdt.begin() == sdt.end());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), sdt.entryCount());
+    CPPUNIT_ASSERT_EQUAL(uint16_t(0), sdt.originalNetworkId());
+    CPPUNIT_ASSERT(!ts::NITView(table).isValid());
+    CPPUNIT_ASSERT(!ts::EITView(table).isValid());
+
+    const ts::PMTView pmt(table);
+    CPPUNIT_ASSERT(!pmt.isValid());
+    CPPUNIT_ASSERT_EQUAL(ts::PID(ts::PID_NULL), pmt.pcrPID());
+    CPPUNIT_ASSERT(pmt.descriptors().empty());
+
+    // Empty table.
+    const ts::BinaryTable empty;
+    CPPUNIT_ASSERT(!ts::PATView(empty).isValid());
+    CPPUNIT_ASSERT(ts::PATView(empty).begin() == ts::PATView(empty).end());
+}
+
+void TableViewTest::testSchedule()
+{
+    // A full EIT schedule for one service, 16 tables of 256 events, several sections per table.
+    ts::BinaryTablePtrVector tables;
+    BuildSchedule(tables, 16, 256);
+
+    for (size_t i = 0; i < tables.size(); ++i) {
+        CPPUNIT_ASSERT(tables[i]->sectionCount() > 1);
+        const ts::EIT eit(*tables[i]);
+        const ts::EITView view(*tables[i]);
+        CPPUNIT_ASSERT(eit.isValid());
+        CPPUNIT_ASSERT(view.isValid());
+        CPPUNIT_ASSERT_EQUAL(eit.events.size(), view.entryCount());
+
+        // All events, across all sections, are seen in the same order.
+        ts::EIT::EventMap::const_iterator ref(eit.events.begin());
+        for (ts::EITView::const_iterator it = view.begin(); it != view.end(); ++it, ++ref) {
+            CPPUNIT_ASSERT(ref != eit.events.end());
+            CPPUNIT_ASSERT_EQUAL(ref->first, (*it).eventId());
+            CPPUNIT_ASSERT_EQUAL(ref->second.duration, (*it).duration());
+        }
+        CPPUNIT_ASSERT(ref == eit.events.end());
+    }
+}
@@ -0,0 +1,241 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+//  CppUnit test suite for class ts::TablesDisplayCache
+//
+//----------------------------------------------------------------------------
+
+#include "tsTablesDisplay.h"
+#include "tsTablesDisplayCache.h"
+#include "tsCerrReport.h"
+#include "utestCppUnitTest.h"
+TSDUCK_SOURCE;
+
+#include "tables/psi_all_sections.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TablesDisplayCacheTest: public CppUnit::TestFixture
+{
+public:
+    TablesDisplayCacheTest();
+    void setUp();
+    void tearDown();
+    void testCache();
+    void testEviction();
+    void testDisplay();
+
+    CPPUNIT_TEST_SUITE(TablesDisplayCacheTest);
+    CPPUNIT_TEST(testCache);
+    CPPUNIT_TEST(testEviction);
+    CPPUNIT_TEST(testDisplay);
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    ts::SectionPtrVector _sections;
+
+    // Display all test sections and tables several times, return the output text.
+    std::string display(size_t cache_size, ts::TablesDisplayCache::Statistics& stats);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TablesDisplayCacheTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Constructor.
+TablesDisplayCacheTest::TablesDisplayCacheTest() :
+    _sections()
+{
+}
+
+// Test suite initialization method.
+void TablesDisplayCacheTest::setUp()
+{
+    _sections.clear();
+    for (size_t index = 0; index + 3 <= sizeof(psi_all_sections); ) {
+        const size_t size = 3 + (ts::GetUInt16(psi_all_sections + index + 1) & 0x0FFF);
+        _sections.push_back(new ts::Section(psi_all_sections + index, size, 100, ts::CRC32::IGNORE));
+        index += size;
+    }
+}
+
+// Test suite cleanup method.
+void TablesDisplayCacheTest::tearDown()
+{
+    _sections.clear();
+}
+
+// Display all test sections and tables several times, return the output text.
+std::string TablesDisplayCacheTest::display(size_t cache_size, ts::TablesDisplayCache::Statistics& stats)
+{
+    ts::TablesDisplayArgs options;
+    options.cache_size = cache_size;
+    ts::TablesDisplay disp(options, CERR);
+    std::ostringstream out;
+    disp.redirect(out);
+
+    for (int rep = 0; rep < 50; ++rep) {
+        for (size_t i = 0; i < _sections.size(); ++i) {
+            disp.displaySection(*_sections[i]) << std::endl;
+            ts::BinaryTable table;
+            table.addSection(_sections[i]);
+            if (table.isValid()) {
+                disp.displayTable(table, 2) << std::endl;
+            }
+        }
+    }
+
+    stats = disp.cacheStatistics();
+    return out.str();
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void TablesDisplayCacheTest::testCache()
+{
+    ts::TablesDisplayCache cache;
+    CPPUNIT_ASSERT(!cache.enabled());
+    cache.setMaxMemory(100000);
+    CPPUNIT_ASSERT(cache.enabled());
+    CPPUNIT_ASSERT_EQUAL(size_t(100000), cache.maxMemory());
+
+    // Find the first long section.
+    size_t index = 0;
+    while (index < _sections.size() && !_sections[index]->isLongSection()) {
+        ++index;
+    }
+    CPPUNIT_ASSERT(index < _sections.size());
+    const ts::Section& sect(*_sections[index]);
+
+    ts::TablesDisplayCache::Key key1;
+    ts::TablesDisplayCache::Key key2;
+    CPPUNIT_ASSERT(ts::TablesDisplayCache::MakeKey(key1, sect, 1));
+    CPPUNIT_ASSERT(ts::TablesDisplayCache::MakeKey(key2, sect, 2));
+    CPPUNIT_ASSERT_EQUAL(ts::PID(100), key1.pid);
+    CPPUNIT_ASSERT_EQUAL(sect.tableId(), key1.tid);
+    CPPUNIT_ASSERT_EQUAL(sect.tableIdExtension(), key1.tid_ext);
+    CPPUNIT_ASSERT_EQUAL(sect.version(), key1.version);
+    CPPUNIT_ASSERT_EQUAL(sect.size(), key1.size);
+    CPPUNIT_ASSERT(key1 < key2);
+    CPPUNIT_ASSERT(!(key2 < key1));
+
+    CPPUNIT_ASSERT(cache.lookup(key1) == 0);
+    cache.store(key1, "text 1");
+    const std::string* text = cache.lookup(key1);
+    CPPUNIT_ASSERT(text != 0);
+    CPPUNIT_ASSERT_EQUAL(std::string("text 1"), *text);
+    CPPUNIT_ASSERT(cache.lookup(key2) == 0);
+
+    const ts::TablesDisplayCache::Statistics& stats(cache.statistics());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1), stats.hits);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(2), stats.misses);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0), stats.evictions);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), stats.entries);
+    CPPUNIT_ASSERT_EQUAL(6 + ts::TablesDisplayCache::ENTRY_OVERHEAD, stats.memory);
+
+    // Short sections are not cached.
+    const uint8_t tdt[] = {0x70, 0x70, 0x05, 0xE1, 0x2B, 0x12, 0x34, 0x56};
+    ts::TablesDisplayCache::Key key3;
+    CPPUNIT_ASSERT(!ts::TablesDisplayCache::MakeKey(key3, ts::Section(tdt, sizeof(tdt)), 0));
+
+    cache.clear();
+    CPPUNIT_ASSERT(cache.lookup(key1) == 0);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), stats.entries);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), stats.memory);
+}
+
+void TablesDisplayCacheTest::testEviction()
+{
+    const size_t entry_size = 100 + ts::TablesDisplayCache::ENTRY_OVERHEAD;
+    ts::TablesDisplayCache cache(3 * entry_size);
+    const std::string text(100, 'x');
+
+    ts::TablesDisplayCache::Key keys[4];
+    for (size_t i = 0; i < 4; ++i) {
+        keys[i].crc32 = uint32_t(i);
+    }
+
+    // Fill the cache, make key 0 the most recently used, then add key 3.
+    cache.store(keys[0], text);
+    cache.store(keys[1], text);
+    cache.store(keys[2], text);
+    CPPUNIT_ASSERT(cache.lookup(keys[0]) != 0);
+    cache.store(keys[3], text);
+
+    // Key 1 was the least recently used.
+    CPPUNIT_ASSERT(cache.lookup(keys[0]) != 0);
+    CPPUNIT_ASSERT(cache.lookup(keys[1]) == 0);
+    CPPUNIT_ASSERT(cache.lookup(keys[2]) != 0);
+    CPPUNIT_ASSERT(cache.lookup(keys[3]) != 0);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1), cache.statistics().evictions);
+    CPPUNIT_ASSERT_EQUAL(size_t(3), cache.statistics().entries);
+    CPPUNIT_ASSERT_EQUAL(3 * entry_size, cache.statistics().memory);
+
+    // Texts larger than the cache are not stored.
+    ts::TablesDisplayCache::Key big;
+    big.crc32 = 100;
+    cache.store(big, std::string(3 * entry_size, 'x'));
+    CPPUNIT_ASSERT(cache.lookup(big) == 0);
+    CPPUNIT_ASSERT_EQUAL(size_t(3), cache.statistics().entries);
+
+    // Reducing the cache size evicts the least recently used entries.
+    cache.setMaxMemory(entry_size);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), cache.statistics().entries);
+    CPPUNIT_ASSERT(cache.lookup(keys[3]) != 0);
+}
+
+void TablesDisplayCacheTest::testDisplay()
+{
+    ts::TablesDisplayCache::Statistics stats;
+
+    const std::string ref(display(0, stats));
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0), stats.hits + stats.misses);
+
+    const std::string out(display(1024 * 1024, stats));
+
+    CPPUNIT_ASSERT(!ref.empty());
+    CPPUNIT_ASSERT(ref == out);
+    CPPUNIT_ASSERT(stats.hits > 0);
+    CPPUNIT_ASSERT(stats.misses > 0);
+    CPPUNIT_ASSERT(stats.hits > 10 * stats.misses);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0), stats.evictions);
+
+    // A tiny cache produces the same output.
+    const std::string small(display(4096, stats));
+    CPPUNIT_ASSERT(ref == small);
+    CPPUNIT_ASSERT(stats.memory <= 4096);
+}
@@ -0,0 +1,254 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  CppUnit test suite for class ts::TablesLogger
+//
+//----------------------------------------------------------------------------
+
+#include "tsTablesLogger.h"
+#include "tsOneShotPacketizer.h"
+#include "tsSysUtils.h"
+#include "tsCerrReport.h"
+#include "utestCppUnitTest.h"
+TSDUCK_SOURCE;
+
+#include "tables/psi_all_sections.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TablesLoggerTest: public CppUnit::TestFixture
+{
+public:
+    TablesLoggerTest();
+    void setUp();
+    void tearDown();
+    void testText();
+    void testBinary();
+    void testMaxTables();
+
+    CPPUNIT_TEST_SUITE(TablesLoggerTest);
+    CPPUNIT_TEST(testText);
+    CPPUNIT_TEST(testBinary);
+    CPPUNIT_TEST(testMaxTables);
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    std::string        _fileName;
+    ts::TSPacketVector _packets;
+
+    // Run a table logger on all packets and return the output file content.
+    std::string runLogger(ts::TablesLoggerArgs& options);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TablesLoggerTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+namespace {
+    // PID of a section in the test stream, from its table id.
+    ts::PID SectionPID(ts::TID tid)
+    {
+        switch (tid) {
+            case ts::TID_PAT: return ts::PID_PAT;
+            case ts::TID_CAT: return ts::PID_CAT;
+            case ts::TID_PMT: return 100;
+            case ts::TID_NIT_ACT: case ts::TID_NIT_OTH: return ts::PID_NIT;
+            case ts::TID_SDT_ACT: case ts::TID_SDT_OTH: case ts::TID_BAT: return ts::PID_SDT;
+            case ts::TID_TDT: case ts::TID_TOT: return ts::PID_TDT;
+            default: return tid >= ts::TID_EIT_PF_ACT && tid <= ts::TID_EIT_S_OTH_MAX ? ts::PID_EIT : 200;
+        }
+    }
+
+    // Extract the lines of a text which contain a given pattern.
+    std::string Grep(const std::string& text, const std::string& pattern)
+    {
+        std::istringstream in(text);
+        std::string line;
+        std::string result;
+        while (std::getline(in, line)) {
+            if (line.find(pattern) != std::string::npos) {
+                result += line + "\n";
+            }
+        }
+        return result;
+    }
+}
+
+// Constructor.
+TablesLoggerTest::TablesLoggerTest() :
+    _fileName(),
+    _packets()
+{
+}
+
+// Test suite initialization method.
+void TablesLoggerTest::setUp()
+{
+    _fileName = ts::TempFile();
+
+    // Packetize all test sections, repeated several times, in their PID's.
+    std::map<ts::PID, ts::TSPacketVector> pids;
+    for (int rep = 0; rep < 200; ++rep) {
+        std::map<ts::PID, ts::OneShotPacketizer> pzer;
+        for (size_t index = 0; index + 3 <= sizeof(psi_all_sections); ) {
+            const size_t size = 3 + (ts::GetUInt16(psi_all_sections + index + 1) & 0x0FFF);
+            const ts::PID pid = SectionPID(psi_all_sections[index]);
+            pzer[pid].setPID(pid);
+            pzer[pid].addSection(new ts::Section(psi_all_sections + index, size, pid, ts::CRC32::IGNORE));
+            index += size;
+        }
+        for (std::map<ts::PID, ts::OneShotPacketizer>::iterator it = pzer.begin(); it != pzer.end(); ++it) {
+            ts::TSPacketVector packets;
+            it->second.getPackets(packets);
+            ts::TSPacketVector& all(pids[it->first]);
+            all.insert(all.end(), packets.begin(), packets.end());
+        }
+    }
+
+    // Interleave all PID's, one packet at a time, with continuous CC per PID.
+    _packets.clear();
+    std::map<ts::PID, uint8_t> cc;
+    for (size_t i = 0; ; ++i) {
+        bool more = false;
+        for (std::map<ts::PID, ts::TSPacketVector>::iterator it = pids.begin(); it != pids.end(); ++it) {
+            if (i < it->second.size()) {
+                more = true;
+                _packets.push_back(it->second[i]);
+                _packets.back().setCC(cc[it->first]);
+                cc[it->first] = (cc[it->first] + 1) & 0x0F;
+            }
+        }
+        if (!more) {
+            break;
+        }
+    }
+}
+
+// Test suite cleanup method.
+void TablesLoggerTest::tearDown()
+{
+    // Returned value ignored on purpose, end of test, temporary file may not even exists.
+    // coverity[CHECKED_RETURN]
+    ts::DeleteFile(_fileName);
+}
+
+// Run a table logger on all packets and return the output file content.
+std::string TablesLoggerTest::runLogger(ts::TablesLoggerArgs& options)
+{
+    options.destination = _fileName;
+    options.pid.set();
+
+    ts::TablesDisplayArgs display_options;
+    ts::TablesDisplay display(display_options, CERR);
+    {
+        ts::TablesLogger logger(options, display, CERR);
+        for (size_t i = 0; i < _packets.size() && !logger.completed(); ++i) {
+            logger.feedPacket(_packets[i]);
+        }
+        logger.close();
+        CPPUNIT_ASSERT(!logger.hasErrors());
+    }
+    display.redirect();
+
+    std::ifstream in(_fileName.c_str(), std::ios::binary);
+    std::ostringstream content;
+    content << in.rdbuf();
+    return content.str();
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void TablesLoggerTest::testText()
+{
+    ts::TablesLoggerArgs options;
+    options.mode = ts::TablesLoggerArgs::TEXT;
+    options.all_sections = true;
+    options.logger = true;
+    options.packet_index = true;
+
+    options.threads = 0;
+    const std::string ref(runLogger(options));
+    options.threads = 3;
+    const std::string out(runLogger(options));
+
+    utest::Out() << "TablesLoggerTest: " << _packets.size() << " packets, " << ref.size() << " bytes of text" << std::endl;
+    CPPUNIT_ASSERT(!ref.empty());
+    CPPUNIT_ASSERT_EQUAL(ref.size(), out.size());
+
+    // Same sections in each PID, in the same order, with the same packet indexes.
+    const char* const pids[] = {"PID 0x0000", "PID 0x0001", "PID 0x0010", "PID 0x0011", "PID 0x0012", "PID 0x0014", "PID 0x0064"};
+    for (size_t i = 0; i < sizeof(pids) / sizeof(pids[0]); ++i) {
+        const std::string lines(Grep(ref, pids[i]));
+        CPPUNIT_ASSERT(!lines.empty());
+        CPPUNIT_ASSERT_EQUAL(lines, Grep(out, pids[i]));
+    }
+}
+
+void TablesLoggerTest::testBinary()
+{
+    ts::TablesLoggerArgs options;
+    options.mode = ts::TablesLoggerArgs::BINARY;
+    options.all_sections = true;
+
+    options.threads = 0;
+    const std::string ref(runLogger(options));
+    options.threads = 1;
+    const std::string out1(runLogger(options));
+    options.threads = 4;
+    const std::string out4(runLogger(options));
+
+    // With one worker thread, the order of all sections is preserved.
+    CPPUNIT_ASSERT(!ref.empty());
+    CPPUNIT_ASSERT(ref == out1);
+    CPPUNIT_ASSERT_EQUAL(ref.size(), out4.size());
+}
+
+void TablesLoggerTest::testMaxTables()
+{
+    ts::TablesLoggerArgs options;
+    options.mode = ts::TablesLoggerArgs::TEXT;
+    options.all_sections = true;
+    options.logger = true;
+    options.max_tables = 25;
+
+    for (size_t threads = 0; threads <= 2; ++threads) {
+        options.threads = threads;
+        const std::string out(runLogger(options));
+        CPPUNIT_ASSERT_EQUAL(size_t(25), size_t(std::count(out.begin(), out.end(), '\n')));
+    }
+}
@@ -63,6 +63,7 @@ public:
     void testMutexRecursion();
     void testMutexTimeout();
     void testCondition();
+    void testCPUAffinity();
 
     CPPUNIT_TEST_SUITE(ThreadTest);
     CPPUNIT_TEST(testAttributes);
@@ -71,6 +72,7 @@ public:
     CPPUNIT_TEST(testMutexRecursion);
     CPPUNIT_TEST(testMutexTimeout);
     CPPUNIT_TEST(testCondition);
+    CPPUNIT_TEST(testCPUAffinity);
     CPPUNIT_TEST_SUITE_END();
 };
 
@@ -382,3 +384,53 @@ void ThreadTest::testCondition()
         }
     }
 }
+
+//
+// Test case: CPU affinity of a thread.
+//
+namespace {
+    class ThreadAffinity: public ts::Thread
+    {
+    public:
+        ts::ThreadAttributes::CPUSet cpus;
+        explicit ThreadAffinity(const ts::ThreadAttributes& attributes) :
+            ts::Thread(attributes),
+            cpus()
+        {
+        }
+        virtual ~ThreadAffinity()
+        {
+            waitForTermination();
+        }
+        virtual void main()
+        {
+            ts::Thread::GetCurrentThreadAffinity(cpus);
+        }
+    };
+}
+
+void ThreadTest::testCPUAffinity()
+{
+#if defined(__linux)
+    ts::ThreadAttributes::CPUSet main_cpus;
+    CPPUNIT_ASSERT(ts::Thread::GetCurrentThreadAffinity(main_cpus));
+    CPPUNIT_ASSERT(!main_cpus.empty());
+
+    // Run a thread on the last CPU where the main thread may run.
+    ts::ThreadAttributes::CPUSet cpus;
+    cpus.insert(*main_cpus.rbegin());
+    ThreadAffinity thread(ts::ThreadAttributes().setCPUAffinity(cpus));
+    CPPUNIT_ASSERT(thread.start());
+    CPPUNIT_ASSERT(thread.waitForTermination());
+    CPPUNIT_ASSERT(thread.cpus == cpus);
+
+    // Setting and restoring the affinity of the main thread.
+    CPPUNIT_ASSERT(ts::Thread::SetCurrentThreadAffinity(cpus));
+    ts::ThreadAttributes::CPUSet current;
+    CPPUNIT_ASSERT(ts::Thread::GetCurrentThreadAffinity(current));
+    CPPUNIT_ASSERT(current == cpus);
+    CPPUNIT_ASSERT(ts::Thread::SetCurrentThreadAffinity(main_cpus));
+    CPPUNIT_ASSERT(ts::Thread::GetCurrentThreadAffinity(current));
+    CPPUNIT_ASSERT(current == main_cpus);
+#endif
+}
@@ -60,11 +60,15 @@ public:
     void testStackSize();
     void testDeleteWhenTerminated();
     void testPriority();
+    void testSchedulingPolicy();
+    void testCPUSet();
 
     CPPUNIT_TEST_SUITE (ThreadAttributesTest);
     CPPUNIT_TEST (testStackSize);
     CPPUNIT_TEST (testDeleteWhenTerminated);
     CPPUNIT_TEST (testPriority);
+    CPPUNIT_TEST (testSchedulingPolicy);
+    CPPUNIT_TEST (testCPUSet);
     CPPUNIT_TEST_SUITE_END ();
 };
 
@@ -133,3 +137,64 @@ void ThreadAttributesTest::testPriority()
     attr.setPriority (ts::ThreadAttributes::GetNormalPriority());
     CPPUNIT_ASSERT(attr.getPriority() == ts::ThreadAttributes::GetNormalPriority());
 }
+
+void ThreadAttributesTest::testSchedulingPolicy()
+{
+    const ts::ThreadAttributes::SchedulingPolicy fifo = ts::ThreadAttributes::FIFO_SCHEDULING;
+    utest::Out()
+        << "ThreadAttributesTest: GetMinimumPriority(FIFO) = " << ts::ThreadAttributes::GetMinimumPriority(fifo) << std::endl
+        << "ThreadAttributesTest: GetMaximumPriority(FIFO) = " << ts::ThreadAttributes::GetMaximumPriority(fifo) << std::endl;
+
+    CPPUNIT_ASSERT(ts::ThreadAttributes::GetMinimumPriority(fifo) <= ts::ThreadAttributes::GetMaximumPriority(fifo));
+    CPPUNIT_ASSERT(ts::ThreadAttributes::GetMinimumPriority(ts::ThreadAttributes::DEFAULT_SCHEDULING) == ts::ThreadAttributes::GetMinimumPriority());
+    CPPUNIT_ASSERT(ts::ThreadAttributes::GetMaximumPriority(ts::ThreadAttributes::DEFAULT_SCHEDULING) == ts::ThreadAttributes::GetMaximumPriority());
+
+    ts::ThreadAttributes attr;
+    CPPUNIT_ASSERT(attr.getSchedulingPolicy() == ts::ThreadAttributes::DEFAULT_SCHEDULING); // default value
+
+    // The priority is forced within the range of the policy.
+    attr.setSchedulingPolicy(fifo);
+    CPPUNIT_ASSERT(attr.getSchedulingPolicy() == fifo);
+    CPPUNIT_ASSERT(attr.getPriority() >= ts::ThreadAttributes::GetMinimumPriority(fifo));
+    CPPUNIT_ASSERT(attr.getPriority() <= ts::ThreadAttributes::GetMaximumPriority(fifo));
+
+    attr.setPriority(ts::ThreadAttributes::GetMaximumPriority(fifo) + 1);
+    CPPUNIT_ASSERT(attr.getPriority() == ts::ThreadAttributes::GetMaximumPriority(fifo));
+
+    attr.setSchedulingPolicy(ts::ThreadAttributes::DEFAULT_SCHEDULING);
+    CPPUNIT_ASSERT(attr.getPriority() == ts::ThreadAttributes::GetMaximumPriority());
+}
+
+void ThreadAttributesTest::testCPUSet()
+{
+    ts::ThreadAttributes::CPUSet cpus;
+    CPPUNIT_ASSERT(ts::ThreadAttributes::CPUSetFromString(cpus, "0-3,8, 10-11,2"));
+    CPPUNIT_ASSERT_EQUAL(size_t(7), cpus.size());
+    CPPUNIT_ASSERT(cpus.count(3) == 1);
+    CPPUNIT_ASSERT(cpus.count(4) == 0);
+    CPPUNIT_ASSERT(cpus.count(11) == 1);
+    CPPUNIT_ASSERT_EQUAL(std::string("0-3,8,10-11"), ts::ThreadAttributes::CPUSetToString(cpus));
+
+    CPPUNIT_ASSERT(ts::ThreadAttributes::CPUSetFromString(cpus, ""));
+    CPPUNIT_ASSERT(cpus.empty());
+    CPPUNIT_ASSERT_EQUAL(std::string(""), ts::ThreadAttributes::CPUSetToString(cpus));
+
+    CPPUNIT_ASSERT(!ts::ThreadAttributes::CPUSetFromString(cpus, "1,x"));
+    CPPUNIT_ASSERT(!ts::ThreadAttributes::CPUSetFromString(cpus, "4-2"));
+
+    ts::ThreadAttributes attr;
+    CPPUNIT_ASSERT(attr.getCPUAffinity().empty()); // default value
+    CPPUNIT_ASSERT(ts::ThreadAttributes::CPUSetFromString(cpus, "1,5"));
+    CPPUNIT_ASSERT(attr.setCPUAffinity(cpus).getCPUAffinity() == cpus);
+
+    CPPUNIT_ASSERT(ts::ThreadAttributes::GetCPUCount() >= 1);
+    utest::Out() << "ThreadAttributesTest: GetCPUCount() = " << ts::ThreadAttributes::GetCPUCount() << std::endl;
+#if defined(__linux)
+    // NUMA node 0 exists on all Linux systems with sysfs.
+    if (ts::ThreadAttributes::GetNUMANodeCPUs(0, cpus)) {
+        utest::Out() << "ThreadAttributesTest: NUMA node 0 CPU's: " << ts::ThreadAttributes::CPUSetToString(cpus) << std::endl;
+        CPPUNIT_ASSERT(!cpus.empty());
+    }
+#endif
+    CPPUNIT_ASSERT(!ts::ThreadAttributes::GetNUMANodeCPUs(100000, cpus));
+}
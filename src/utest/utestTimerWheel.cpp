@@ -0,0 +1,322 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+//  CppUnit test suite for class ts::TimerWheel
+//
+//----------------------------------------------------------------------------
+
+#include "tsTimerWheel.h"
+#include "utestCppUnitTest.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TimerWheelTest: public CppUnit::TestFixture
+{
+public:
+    void setUp();
+    void tearDown();
+    void testOneShot();
+    void testPeriodic();
+    void testCancel();
+    void testPending();
+    void testLongDelay();
+    void testHandler();
+
+    CPPUNIT_TEST_SUITE (TimerWheelTest);
+    CPPUNIT_TEST (testOneShot);
+    CPPUNIT_TEST (testPeriodic);
+    CPPUNIT_TEST (testCancel);
+    CPPUNIT_TEST (testPending);
+    CPPUNIT_TEST (testLongDelay);
+    CPPUNIT_TEST (testHandler);
+    CPPUNIT_TEST_SUITE_END ();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION (TimerWheelTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void TimerWheelTest::setUp()
+{
+}
+
+// Test suite cleanup method.
+void TimerWheelTest::tearDown()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// A timer handler which records all notifications.
+//----------------------------------------------------------------------------
+
+namespace {
+    class Recorder: public ts::TimerHandlerInterface
+    {
+    public:
+        struct Event
+        {
+            ts::TimerId id;
+            ts::MilliSecond time;
+        };
+        std::vector<Event> events;
+        ts::TimerId cancelId;      // Timer to cancel on next notification.
+        ts::MilliSecond delay;     // Delay of a new timer to schedule on next notification.
+
+        Recorder() : events(), cancelId(0), delay(0) {}
+
+        virtual void handleTimer(ts::TimerWheel& wheel, ts::TimerId id) override
+        {
+            const Event ev = {id, wheel.now()};
+            events.push_back(ev);
+            if (cancelId != 0) {
+                wheel.cancel(cancelId);
+                cancelId = 0;
+            }
+            if (delay > 0) {
+                wheel.schedule(this, delay);
+                delay = 0;
+            }
+        }
+    };
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void TimerWheelTest::testOneShot()
+{
+    ts::TimerWheel wheel;
+    Recorder rec;
+
+    wheel.advance(1000);
+    CPPUNIT_ASSERT_EQUAL(ts::MilliSecond(1000), wheel.now());
+
+    const ts::TimerId id1 = wheel.schedule(&rec, 10);
+    const ts::TimerId id2 = wheel.schedule(&rec, 300);
+    const ts::TimerId id3 = wheel.schedule(&rec, 300);
+    CPPUNIT_ASSERT(id1 != 0);
+    CPPUNIT_ASSERT(id1 != id2);
+    CPPUNIT_ASSERT(id2 != id3);
+    CPPUNIT_ASSERT_EQUAL(size_t(3), wheel.count());
+
+    wheel.advance(1009);
+    CPPUNIT_ASSERT(rec.events.empty());
+
+    wheel.advance(1010);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), rec.events.size());
+    CPPUNIT_ASSERT_EQUAL(id1, rec.events[0].id);
+    CPPUNIT_ASSERT_EQUAL(ts::MilliSecond(1010), rec.events[0].time);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), wheel.count());
+
+    // Notified late, at the time of the next advance.
+    wheel.advance(2000);
+    CPPUNIT_ASSERT_EQUAL(size_t(3), rec.events.size());
+    CPPUNIT_ASSERT(rec.events[1].id == id2 || rec.events[1].id == id3);
+    CPPUNIT_ASSERT(rec.events[2].id == id2 || rec.events[2].id == id3);
+    CPPUNIT_ASSERT(rec.events[1].id != rec.events[2].id);
+    CPPUNIT_ASSERT_EQUAL(ts::MilliSecond(1300), rec.events[1].time);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), wheel.count());
+
+    // Time never goes back.
+    wheel.advance(1500);
+    CPPUNIT_ASSERT_EQUAL(ts::MilliSecond(2000), wheel.now());
+}
+
+void TimerWheelTest::testPeriodic()
+{
+    ts::TimerWheel wheel;
+    Recorder rec;
+
+    wheel.advance(0);
+    const ts::TimerId id = wheel.schedule(&rec, 100, 100);
+
+    for (ts::MilliSecond t = 10; t <= 1000; t += 10) {
+        wheel.advance(t);
+    }
+    CPPUNIT_ASSERT_EQUAL(size_t(10), rec.events.size());
+    for (size_t i = 0; i < rec.events.size(); ++i) {
+        CPPUNIT_ASSERT_EQUAL(id, rec.events[i].id);
+        CPPUNIT_ASSERT_EQUAL(ts::MilliSecond(100 * (i + 1)), rec.events[i].time);
+    }
+    CPPUNIT_ASSERT_EQUAL(size_t(1), wheel.count());
+
+    // Missed periods are skipped.
+    rec.events.clear();
+    wheel.advance(1550);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), rec.events.size());
+    CPPUNIT_ASSERT_EQUAL(ts::MilliSecond(1100), rec.events[0].time);
+    wheel.advance(1599);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), rec.events.size());
+    wheel.advance(1600);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), rec.events.size());
+
+    CPPUNIT_ASSERT(wheel.cancel(id));
+    CPPUNIT_ASSERT_EQUAL(size_t(0), wheel.count());
+    wheel.advance(5000);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), rec.events.size());
+}
+
+void TimerWheelTest::testCancel()
+{
+    ts::TimerWheel wheel;
+    Recorder rec;
+
+    wheel.advance(50);
+    const ts::TimerId id1 = wheel.schedule(&rec, 20);
+    const ts::TimerId id2 = wheel.schedule(&rec, 30);
+
+    CPPUNIT_ASSERT(!wheel.cancel(0));
+    CPPUNIT_ASSERT(!wheel.cancel(12345));
+    CPPUNIT_ASSERT(wheel.cancel(id1));
+    CPPUNIT_ASSERT(!wheel.cancel(id1));
+    CPPUNIT_ASSERT_EQUAL(size_t(1), wheel.count());
+
+    wheel.advance(100);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), rec.events.size());
+    CPPUNIT_ASSERT_EQUAL(id2, rec.events[0].id);
+
+    // An expired one-shot timer cannot be canceled.
+    CPPUNIT_ASSERT(!wheel.cancel(id2));
+
+    // Entries are reused but old identifiers remain invalid.
+    const ts::TimerId id3 = wheel.schedule(&rec, 10);
+    CPPUNIT_ASSERT(id3 != id1);
+    CPPUNIT_ASSERT(id3 != id2);
+    CPPUNIT_ASSERT(!wheel.cancel(id1));
+    CPPUNIT_ASSERT(!wheel.cancel(id2));
+
+    wheel.schedule(&rec, 10);
+    wheel.schedule(&rec, 1000000);
+    CPPUNIT_ASSERT_EQUAL(size_t(3), wheel.count());
+    wheel.clear();
+    CPPUNIT_ASSERT_EQUAL(size_t(0), wheel.count());
+    CPPUNIT_ASSERT(!wheel.cancel(id3));
+    wheel.advance(10000000);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), rec.events.size());
+}
+
+void TimerWheelTest::testPending()
+{
+    ts::TimerWheel wheel;
+    Recorder rec;
+
+    // Delays start at the first advance.
+    const ts::TimerId id1 = wheel.schedule(&rec, 20);
+    const ts::TimerId id2 = wheel.schedule(&rec, 40);
+    wheel.schedule(&rec, 30);
+    CPPUNIT_ASSERT_EQUAL(size_t(3), wheel.count());
+    CPPUNIT_ASSERT(wheel.cancel(id2));
+
+    wheel.advance(100000);
+    CPPUNIT_ASSERT(rec.events.empty());
+    wheel.advance(100020);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), rec.events.size());
+    CPPUNIT_ASSERT_EQUAL(id1, rec.events[0].id);
+    wheel.advance(100100);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), rec.events.size());
+    CPPUNIT_ASSERT_EQUAL(ts::MilliSecond(100030), rec.events[1].time);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), wheel.count());
+}
+
+void TimerWheelTest::testLongDelay()
+{
+    ts::TimerWheel wheel;
+    Recorder rec;
+    const ts::MilliSecond start = 123456789;
+    const ts::MilliSecond delays[] = {255, 256, 65536, 100000, 16777216, 20000000, ts::MilliSecond(1) << 32, (ts::MilliSecond(1) << 32) + 70000};
+    const size_t count = sizeof(delays) / sizeof(delays[0]);
+
+    wheel.advance(start);
+    for (size_t i = 0; i < count; ++i) {
+        wheel.schedule(&rec, delays[i]);
+    }
+
+    // Advance by large steps, each timer is notified exactly at its deadline
+    // when the wheel is advanced right at this time.
+    for (size_t i = 0; i < count; ++i) {
+        wheel.advance(start + delays[i] - 1);
+        CPPUNIT_ASSERT_EQUAL(i, rec.events.size());
+        wheel.advance(start + delays[i]);
+        CPPUNIT_ASSERT_EQUAL(i + 1, rec.events.size());
+        CPPUNIT_ASSERT_EQUAL(start + delays[i], rec.events[i].time);
+    }
+    CPPUNIT_ASSERT_EQUAL(size_t(0), wheel.count());
+
+    // All timers at once, in a single advance.
+    rec.events.clear();
+    const ts::MilliSecond now = wheel.now();
+    for (size_t i = 0; i < count; ++i) {
+        wheel.schedule(&rec, delays[i]);
+    }
+    wheel.advance(now + delays[count - 1]);
+    CPPUNIT_ASSERT_EQUAL(count, rec.events.size());
+    for (size_t i = 0; i < count; ++i) {
+        CPPUNIT_ASSERT_EQUAL(now + delays[i], rec.events[i].time);
+    }
+}
+
+void TimerWheelTest::testHandler()
+{
+    ts::TimerWheel wheel;
+    Recorder rec;
+
+    wheel.advance(0);
+    const ts::TimerId id1 = wheel.schedule(&rec, 10);
+    const ts::TimerId id2 = wheel.schedule(&rec, 20, 20);
+
+    // The first notification cancels the periodic timer and schedules a new one.
+    rec.cancelId = id2;
+    rec.delay = 5;
+    wheel.advance(100);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), rec.events.size());
+    CPPUNIT_ASSERT_EQUAL(id1, rec.events[0].id);
+    CPPUNIT_ASSERT_EQUAL(ts::MilliSecond(10), rec.events[0].time);
+    CPPUNIT_ASSERT(rec.events[1].id != id1);
+    CPPUNIT_ASSERT(rec.events[1].id != id2);
+    CPPUNIT_ASSERT_EQUAL(ts::MilliSecond(15), rec.events[1].time);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), wheel.count());
+
+    // A periodic timer which cancels itself.
+    rec.events.clear();
+    const ts::TimerId id3 = wheel.schedule(&rec, 10, 10);
+    rec.cancelId = id3;
+    wheel.advance(1000);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), rec.events.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), wheel.count());
+}
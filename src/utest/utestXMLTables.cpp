@@ -37,6 +37,9 @@
 #include "tsBinaryTable.h"
 #include "tsStringUtils.h"
 #include "tsCerrReport.h"
+#include "tsReportBuffer.h"
+#include "tsTime.h"
+#include "tsFormat.h"
 #include "utestCppUnitTest.h"
 TSDUCK_SOURCE;
 
@@ -61,6 +64,7 @@ public:
     void testGenericLongTable();
     void testPAT1();
     void testAllTables();
+    void testParallel();
 
     CPPUNIT_TEST_SUITE(XMLTablesTest);
     CPPUNIT_TEST(testConfigurationFile);
@@ -69,11 +73,18 @@ public:
     CPPUNIT_TEST(testGenericLongTable);
     CPPUNIT_TEST(testPAT1);
     CPPUNIT_TEST(testAllTables);
+    CPPUNIT_TEST(testParallel);
     CPPUNIT_TEST_SUITE_END();
 
 private:
     // Unitary test for one table.
     void testTable(const char* name, const char* ref_xml, const uint8_t* ref_sections, size_t ref_sections_size);
+
+    // Build a synthetic EPG as XML text, one EIT per group of 32 events.
+    static std::string BuildEPG(size_t services, size_t events);
+
+    // Compile XML text with a given number of threads, return the serialized sections.
+    static std::string Compile(const std::string& text, size_t threads, ts::ReportInterface& report, bool expected_success = true);
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(XMLTablesTest);
@@ -330,3 +341,70 @@ void XMLTablesTest::testGenericLongTable()
     CPPUNIT_ASSERT_EQUAL(sizeof(refData1), sec->payloadSize());
     CPPUNIT_ASSERT(ts::ByteBlock(sec->payload(), sec->payloadSize()) == ts::ByteBlock(refData1, sizeof(refData1)));
 }
+
+std::string XMLTablesTest::BuildEPG(size_t services, size_t events)
+{
+    std::string text("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<tsduck>\n");
+    const ts::Time base(2017, 10, 1, 0, 0);
+    for (size_t srv = 0; srv < services; ++srv) {
+        for (size_t first = 0; first < events; first += 32) {
+            text += ts::Format("  <EIT type=\"%d\" version=\"1\" actual=\"true\" service_id=\"%d\" transport_stream_id=\"1\" "
+                               "original_network_id=\"2\" segment_last_section_number=\"0\" last_table_id=\"80\">\n",
+                               int(first / 32 % 16), int(100 + srv));
+            for (size_t ev = first; ev < events && ev < first + 32; ++ev) {
+                const ts::Time::Fields start(base + ts::MilliSecond(ev) * 30 * ts::MilliSecPerMin);
+                text += ts::Format("    <event event_id=\"%d\" start_time=\"%04d-%02d-%02d %02d:%02d:00\" duration=\"00:30:00\" running_status=\"running\">\n"
+                                   "      <short_event_descriptor language_code=\"eng\">\n"
+                                   "        <event_name>Programme %d on service %d</event_name>\n"
+                                   "        <text>Synthetic description of event %d.</text>\n"
+                                   "      </short_event_descriptor>\n"
+                                   "      <content_descriptor>\n"
+                                   "        <content content_nibble_level_1=\"2\" content_nibble_level_2=\"3\" user_byte=\"0x00\"/>\n"
+                                   "      </content_descriptor>\n"
+                                   "    </event>\n",
+                                   int(ev), start.year, start.month, start.day, start.hour, start.minute,
+                                   int(ev), int(srv), int(ev));
+            }
+            text += "  </EIT>\n";
+        }
+    }
+    text += "</tsduck>\n";
+    return text;
+}
+
+std::string XMLTablesTest::Compile(const std::string& text, size_t threads, ts::ReportInterface& report, bool expected_success)
+{
+    ts::XMLTables xml;
+    xml.setMaxThreads(threads);
+    CPPUNIT_ASSERT_EQUAL(threads, xml.maxThreads());
+    CPPUNIT_ASSERT_EQUAL(expected_success, xml.parseXML(text, report));
+
+    std::ostringstream strm;
+    CPPUNIT_ASSERT(ts::BinaryTable::SaveFile(xml.tables(), strm, report));
+    return strm.str();
+}
+
+void XMLTablesTest::testParallel()
+{
+    const std::string epg(BuildEPG(4, 200));
+    const std::string ref(Compile(epg, 1, CERR));
+    CPPUNIT_ASSERT(!ref.empty());
+    CPPUNIT_ASSERT(ref == Compile(epg, 2, CERR));
+    CPPUNIT_ASSERT(ref == Compile(epg, 7, CERR));
+
+    // Invalid tables in the middle of the document: same tables and same errors in the same order.
+    std::string invalid(epg);
+    const size_t pos = invalid.find("  <EIT", invalid.size() / 2);
+    CPPUNIT_ASSERT(pos != std::string::npos);
+    invalid.insert(pos, "  <PAT version=\"1\"/>\n  <PMT version=\"2\"/>\n");
+
+    ts::ReportBuffer<> log1;
+    ts::ReportBuffer<> log4;
+    const std::string sec1(Compile(invalid, 1, log1, false));
+    const std::string sec4(Compile(invalid, 4, log4, false));
+    utest::Out() << "XMLTablesTest::testParallel: errors: " << log1.getMessages() << std::endl;
+    CPPUNIT_ASSERT(sec1 == ref);
+    CPPUNIT_ASSERT(sec4 == ref);
+    CPPUNIT_ASSERT(!log1.getMessages().empty());
+    CPPUNIT_ASSERT_STRINGS_EQUAL(log1.getMessages(), log4.getMessages());
+}